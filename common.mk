@@ -20,6 +20,7 @@ endif
 PLATFORM?=OS_LINUX
 
 LUNA_CLIENT_DIRECTORY?=/usr/safenet/lunaclient
+LUNA_INCLUDE_DIRECTORY?=$(LUNA_CLIENT_DIRECTORY)/samples/include
 
 INPUT_DIRECTORY?=./src
 BUILD_DIRECTORY?=./build
@@ -255,7 +256,7 @@ endif
 # Definitions for dependencies
 # ############################################################################
 INCLUDES+=\
-	-I $(LUNA_CLIENT_DIRECTORY)/samples/include \
+	-I $(LUNA_INCLUDE_DIRECTORY) \
 	-I $(INPUT_DIRECTORY)
 
 # ############################################################################
@@ -263,9 +264,7 @@ INCLUDES+=\
 # ############################################################################
 LINKER?=g++
 
-LD_FLAGS+=\
-	-L $(LUNA_CLIENT_DIRECTORY)/lib
-
+# The PKCS#11 provider is loaded at run time (see the '--provider' option).
 ifeq ($(WITH_SANITIZATION), "true")
 	LD_FLAGS+=\
 		$(COMMON_SANITIZE)
@@ -273,7 +272,7 @@ endif
 
 LD_LIBS+=\
 	-lpthread \
-    -lCryptoki2_64
+	-ldl
 
 # ############################################################################
 # Artefacts inventory
@@ -351,6 +350,7 @@ endif
 	@echo "   - PLATFORM              = $(PLATFORM)"
 	@echo ""
 	@echo "   - LUNA_CLIENT_DIRECTORY = $(LUNA_CLIENT_DIRECTORY)"
+	@echo "   - LUNA_INCLUDE_DIRECTORY = $(LUNA_INCLUDE_DIRECTORY)"
 	@echo ""
 	@echo "   - INPUT_DIRECTORY       = $(INPUT_DIRECTORY)"
 	@echo "   - BUILD_DIRECTORY       = $(BUILD_DIRECTORY)"
@@ -414,4 +414,95 @@ $(OUTPUT_DIRECTORY):
 	@echo ""
 
 $(TARGET): $(OUTPUT_DIRECTORY)/$(TARGET)
-	@echo "Target built."
\ No newline at end of file
+	@echo "Target built."
+# ############################################################################
+# Mock of the Luna PKCS#11 provider (see 'mock/p11-mock.h')
+# ############################################################################
+MOCK_DIRECTORY?=./mock
+MOCK_OUTPUT_DIRECTORY=$(OUTPUT_DIRECTORY)/mock
+MOCK_LIBRARY=$(MOCK_OUTPUT_DIRECTORY)/libCryptoki2_64.so
+
+# Without the Luna SDK, the mock, the simulator and the tool built with the
+# mock use the minimal declarations of 'mock/include/cryptoki_v2.h'.
+ifeq ($(wildcard $(LUNA_INCLUDE_DIRECTORY)/cryptoki_v2.h),)
+    MOCK_LUNA_INCLUDE_DIRECTORY=$(MOCK_DIRECTORY)/include
+else
+    MOCK_LUNA_INCLUDE_DIRECTORY=$(LUNA_INCLUDE_DIRECTORY)
+endif
+
+MOCK_INCLUDES=\
+	-I $(MOCK_LUNA_INCLUDE_DIRECTORY) \
+	-I $(INPUT_DIRECTORY)
+
+# The mock reuses the software implementations of the toolkits.
+MOCK_SOURCE_FILES=\
+	$(wildcard $(MOCK_DIRECTORY)/*.c) \
+	$(addprefix $(INPUT_DIRECTORY)/toolkits/,aes-toolkit.c comp128-toolkit.c ec-toolkit.c ecies-toolkit.c kdf-toolkit.c milenage-toolkit.c sha-toolkit.c tuak-toolkit.c)
+
+MOCK_LD_LIBS=\
+	-lpthread \
+	-lm
+
+.PHONY: mock
+mock: $(MOCK_LIBRARY)
+	@echo "Mock built."
+
+# Builds the tool so that its default provider is the mock instead of the
+# Luna client library ('--provider' selects another one).
+.PHONY: with-mock
+with-mock: info clean
+	$(MAKE) mock
+	$(MAKE) $(TARGET) LUNA_INCLUDE_DIRECTORY="$(abspath $(MOCK_LUNA_INCLUDE_DIRECTORY))" LD_FLAGS="-Wl,-rpath,$(abspath $(MOCK_OUTPUT_DIRECTORY))"
+	@echo "Done."
+
+$(MOCK_LIBRARY): $(MOCK_SOURCE_FILES) $(wildcard $(MOCK_DIRECTORY)/*.h) | $(MOCK_OUTPUT_DIRECTORY)
+	@echo "- ----------------------------------------------------------------------------"
+	@echo "# Build the mock library"
+	@echo "- ----------------------------------------------------------------------------"
+	@echo ""
+	$(C_COMPILER) $(C_FLAGS) -fPIC -shared -Wl,-soname,$(notdir $@) $(MOCK_INCLUDES) $(MOCK_SOURCE_FILES) -o $@ $(MOCK_LD_LIBS)
+	@echo ""
+
+$(MOCK_OUTPUT_DIRECTORY): | $(OUTPUT_DIRECTORY)
+	mkdir -p $@
+	@echo ""
+
+# ############################################################################
+# Simulator of a Luna appliance (see 'simulator/p11-simulator.h')
+# ############################################################################
+SIMULATOR_DIRECTORY?=./simulator
+SIMULATOR_OUTPUT_DIRECTORY=$(OUTPUT_DIRECTORY)/simulator
+SIMULATOR_DAEMON=$(SIMULATOR_OUTPUT_DIRECTORY)/ha-bench-simulator
+SIMULATOR_LIBRARY=$(SIMULATOR_OUTPUT_DIRECTORY)/libCryptoki2_64.so
+
+# The daemon embeds the mock, the shim only forwards the calls.
+SIMULATOR_DAEMON_SOURCE_FILES=\
+	$(addprefix $(SIMULATOR_DIRECTORY)/,p11-simulator-codec.c p11-simulator-daemon.c) \
+	$(MOCK_SOURCE_FILES)
+
+SIMULATOR_LIBRARY_SOURCE_FILES=\
+	$(addprefix $(SIMULATOR_DIRECTORY)/,p11-simulator-codec.c p11-simulator-shim.c)
+
+.PHONY: simulator
+simulator: $(SIMULATOR_DAEMON) $(SIMULATOR_LIBRARY)
+	@echo "Simulator built."
+
+$(SIMULATOR_DAEMON): $(SIMULATOR_DAEMON_SOURCE_FILES) $(wildcard $(MOCK_DIRECTORY)/*.h) $(wildcard $(SIMULATOR_DIRECTORY)/*.h) | $(SIMULATOR_OUTPUT_DIRECTORY)
+	@echo "- ----------------------------------------------------------------------------"
+	@echo "# Build the simulator daemon"
+	@echo "- ----------------------------------------------------------------------------"
+	@echo ""
+	$(C_COMPILER) $(C_FLAGS) $(MOCK_INCLUDES) -I $(MOCK_DIRECTORY) $(SIMULATOR_DAEMON_SOURCE_FILES) -o $@ $(MOCK_LD_LIBS)
+	@echo ""
+
+$(SIMULATOR_LIBRARY): $(SIMULATOR_LIBRARY_SOURCE_FILES) $(wildcard $(SIMULATOR_DIRECTORY)/*.h) | $(SIMULATOR_OUTPUT_DIRECTORY)
+	@echo "- ----------------------------------------------------------------------------"
+	@echo "# Build the simulator library"
+	@echo "- ----------------------------------------------------------------------------"
+	@echo ""
+	$(C_COMPILER) $(C_FLAGS) -fPIC -shared -Wl,-soname,$(notdir $@) $(MOCK_INCLUDES) $(SIMULATOR_LIBRARY_SOURCE_FILES) -o $@ -lpthread
+	@echo ""
+
+$(SIMULATOR_OUTPUT_DIRECTORY): | $(OUTPUT_DIRECTORY)
+	mkdir -p $@
+	@echo ""
@@ -0,0 +1,534 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __CRYPTOKI_V2_H__
+#define __CRYPTOKI_V2_H__
+
+/*
+ * Definitions
+ *
+ * Minimal declarations of the Luna Client SDK used by ha-bench, the mock and
+ * the simulator, so that they can be built without the SDK (see the 'mock'
+ * and 'with-mock' targets, that use them only if the SDK headers are not
+ * found).
+ *
+ * Notes:
+ *   - The standard PKCS#11 values are the ones of the specification, but the
+ *     Luna extensions (e.g. CKM_MILENAGE, CKR_USER_NOT_AUTHORIZED, the CA_
+ *     function list) are only consistent between ha-bench and the mock: a
+ *     binary built with these declarations must not load the Luna client
+ *     library.
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Basic types.
+typedef unsigned char CK_BYTE;
+typedef CK_BYTE CK_CHAR;
+typedef CK_BYTE CK_UTF8CHAR;
+typedef CK_BYTE CK_BBOOL;
+typedef unsigned long CK_ULONG;
+typedef long CK_LONG;
+typedef CK_ULONG CK_FLAGS;
+
+typedef CK_BYTE *CK_BYTE_PTR;
+typedef CK_CHAR *CK_CHAR_PTR;
+typedef CK_UTF8CHAR *CK_UTF8CHAR_PTR;
+typedef CK_ULONG *CK_ULONG_PTR;
+typedef void *CK_VOID_PTR;
+typedef CK_VOID_PTR *CK_VOID_PTR_PTR;
+
+#define TRUE 1
+#define FALSE 0
+#define CK_TRUE 1
+#define CK_FALSE 0
+#define NULL_PTR 0
+
+typedef CK_ULONG CK_RV;
+typedef CK_ULONG CK_SLOT_ID;
+typedef CK_ULONG CK_SESSION_HANDLE;
+typedef CK_ULONG CK_OBJECT_HANDLE;
+typedef CK_ULONG CK_OBJECT_CLASS;
+typedef CK_ULONG CK_KEY_TYPE;
+typedef CK_ULONG CK_ATTRIBUTE_TYPE;
+typedef CK_ULONG CK_MECHANISM_TYPE;
+typedef CK_ULONG CK_USER_TYPE;
+typedef CK_ULONG CK_STATE;
+typedef CK_ULONG CK_NOTIFICATION;
+typedef CK_ULONG CK_EC_KDF_TYPE;
+
+typedef CK_SLOT_ID *CK_SLOT_ID_PTR;
+typedef CK_SESSION_HANDLE *CK_SESSION_HANDLE_PTR;
+typedef CK_OBJECT_HANDLE *CK_OBJECT_HANDLE_PTR;
+typedef CK_MECHANISM_TYPE *CK_MECHANISM_TYPE_PTR;
+
+#define CK_INVALID_HANDLE 0UL
+#define CK_UNAVAILABLE_INFORMATION (~0UL)
+
+// Structures (with the field names of the Luna SDK).
+typedef struct CK_VERSION
+{
+    CK_BYTE major;
+    CK_BYTE minor;
+} CK_VERSION;
+
+typedef CK_VERSION *CK_VERSION_PTR;
+
+typedef struct CK_INFO
+{
+    CK_VERSION cryptokiVersion;
+    CK_UTF8CHAR manufacturerID[32];
+    CK_FLAGS flags;
+    CK_UTF8CHAR libraryDescription[32];
+    CK_VERSION libraryVersion;
+} CK_INFO;
+
+typedef CK_INFO *CK_INFO_PTR;
+
+typedef struct CK_SLOT_INFO
+{
+    CK_UTF8CHAR slotDescription[64];
+    CK_UTF8CHAR manufacturerID[32];
+    CK_FLAGS flags;
+    CK_VERSION hardwareVersion;
+    CK_VERSION firmwareVersion;
+} CK_SLOT_INFO;
+
+typedef CK_SLOT_INFO *CK_SLOT_INFO_PTR;
+
+typedef struct CK_TOKEN_INFO
+{
+    CK_UTF8CHAR label[32];
+    CK_UTF8CHAR manufacturerID[32];
+    CK_UTF8CHAR model[16];
+    CK_CHAR serialNumber[16];
+    CK_FLAGS flags;
+    CK_ULONG usMaxSessionCount;
+    CK_ULONG usSessionCount;
+    CK_ULONG usMaxRwSessionCount;
+    CK_ULONG usRwSessionCount;
+    CK_ULONG usMaxPinLen;
+    CK_ULONG usMinPinLen;
+    CK_ULONG ulTotalPublicMemory;
+    CK_ULONG ulFreePublicMemory;
+    CK_ULONG ulTotalPrivateMemory;
+    CK_ULONG ulFreePrivateMemory;
+    CK_VERSION hardwareVersion;
+    CK_VERSION firmwareVersion;
+    CK_CHAR utcTime[16];
+} CK_TOKEN_INFO;
+
+typedef CK_TOKEN_INFO *CK_TOKEN_INFO_PTR;
+
+typedef struct CK_SESSION_INFO
+{
+    CK_SLOT_ID slotID;
+    CK_STATE state;
+    CK_FLAGS flags;
+    CK_ULONG usDeviceError;
+} CK_SESSION_INFO;
+
+typedef CK_SESSION_INFO *CK_SESSION_INFO_PTR;
+
+typedef struct CK_ATTRIBUTE
+{
+    CK_ATTRIBUTE_TYPE type;
+    CK_VOID_PTR pValue;
+    CK_ULONG usValueLen;
+} CK_ATTRIBUTE;
+
+typedef CK_ATTRIBUTE *CK_ATTRIBUTE_PTR;
+
+typedef struct CK_MECHANISM
+{
+    CK_MECHANISM_TYPE mechanism;
+    CK_VOID_PTR pParameter;
+    CK_ULONG ulParameterLen;
+} CK_MECHANISM;
+
+typedef CK_MECHANISM *CK_MECHANISM_PTR;
+
+typedef struct CK_MECHANISM_INFO
+{
+    CK_ULONG ulMinKeySize;
+    CK_ULONG ulMaxKeySize;
+    CK_FLAGS flags;
+} CK_MECHANISM_INFO;
+
+typedef CK_MECHANISM_INFO *CK_MECHANISM_INFO_PTR;
+
+typedef CK_RV (*CK_NOTIFY)(CK_SESSION_HANDLE hSession,
+                           CK_NOTIFICATION event,
+                           CK_VOID_PTR pApplication);
+
+typedef CK_RV (*CK_CREATEMUTEX)(CK_VOID_PTR_PTR ppMutex);
+typedef CK_RV (*CK_DESTROYMUTEX)(CK_VOID_PTR pMutex);
+typedef CK_RV (*CK_LOCKMUTEX)(CK_VOID_PTR pMutex);
+typedef CK_RV (*CK_UNLOCKMUTEX)(CK_VOID_PTR pMutex);
+
+typedef struct CK_C_INITIALIZE_ARGS
+{
+    CK_CREATEMUTEX CreateMutex;
+    CK_DESTROYMUTEX DestroyMutex;
+    CK_LOCKMUTEX LockMutex;
+    CK_UNLOCKMUTEX UnlockMutex;
+    CK_FLAGS flags;
+    CK_VOID_PTR pReserved;
+} CK_C_INITIALIZE_ARGS;
+
+typedef CK_C_INITIALIZE_ARGS *CK_C_INITIALIZE_ARGS_PTR;
+
+// Return values.
+#define CKR_OK 0x0UL
+#define CKR_HOST_MEMORY 0x2UL
+#define CKR_SLOT_ID_INVALID 0x3UL
+#define CKR_GENERAL_ERROR 0x5UL
+#define CKR_FUNCTION_FAILED 0x6UL
+#define CKR_FUNCTION_CANCELED 0x50UL
+#define CKR_ARGUMENTS_BAD 0x7UL
+#define CKR_ATTRIBUTE_SENSITIVE 0x11UL
+#define CKR_ATTRIBUTE_TYPE_INVALID 0x12UL
+#define CKR_ATTRIBUTE_VALUE_INVALID 0x13UL
+#define CKR_DATA_LEN_RANGE 0x21UL
+#define CKR_DEVICE_ERROR 0x30UL
+#define CKR_DEVICE_MEMORY 0x31UL
+#define CKR_ENCRYPTED_DATA_INVALID 0x40UL
+#define CKR_ENCRYPTED_DATA_LEN_RANGE 0x41UL
+#define CKR_FUNCTION_NOT_SUPPORTED 0x54UL
+#define CKR_KEY_HANDLE_INVALID 0x60UL
+#define CKR_KEY_SIZE_RANGE 0x62UL
+#define CKR_MECHANISM_INVALID 0x70UL
+#define CKR_MECHANISM_PARAM_INVALID 0x71UL
+#define CKR_OBJECT_HANDLE_INVALID 0x82UL
+#define CKR_OPERATION_ACTIVE 0x90UL
+#define CKR_OPERATION_NOT_INITIALIZED 0x91UL
+#define CKR_PIN_INCORRECT 0xA0UL
+#define CKR_SESSION_COUNT 0xB1UL
+#define CKR_SESSION_HANDLE_INVALID 0xB3UL
+#define CKR_SESSION_PARALLEL_NOT_SUPPORTED 0xB4UL
+#define CKR_SESSION_READ_ONLY 0xB5UL
+#define CKR_KEY_TYPE_INCONSISTENT 0x63UL
+#define CKR_KEY_FUNCTION_NOT_PERMITTED 0x68UL
+#define CKR_TEMPLATE_INCONSISTENT 0xD1UL
+#define CKR_SIGNATURE_INVALID 0xC0UL
+#define CKR_TEMPLATE_INCOMPLETE 0xD0UL
+#define CKR_TOKEN_NOT_PRESENT 0xE0UL
+#define CKR_USER_ALREADY_LOGGED_IN 0x100UL
+#define CKR_USER_NOT_LOGGED_IN 0x101UL
+#define CKR_USER_TYPE_INVALID 0x103UL
+#define CKR_WRAPPED_KEY_INVALID 0x110UL
+#define CKR_WRAPPED_KEY_LEN_RANGE 0x112UL
+#define CKR_UNWRAPPING_KEY_HANDLE_INVALID 0x113UL
+#define CKR_UNWRAPPING_KEY_TYPE_INCONSISTENT 0x115UL
+#define CKR_BUFFER_TOO_SMALL 0x150UL
+#define CKR_CRYPTOKI_NOT_INITIALIZED 0x190UL
+#define CKR_CRYPTOKI_ALREADY_INITIALIZED 0x191UL
+#define CKR_USER_NOT_AUTHORIZED 0x80000000UL
+
+// Flags.
+#define CKF_TOKEN_PRESENT 0x1UL
+#define CKF_REMOVABLE_DEVICE 0x2UL
+#define CKF_HW_SLOT 0x4UL
+#define CKF_RNG 0x1UL
+#define CKF_WRITE_PROTECTED 0x2UL
+#define CKF_LOGIN_REQUIRED 0x4UL
+#define CKF_USER_PIN_INITIALIZED 0x8UL
+#define CKF_RESTORE_KEY_NOT_NEEDED 0x20UL
+#define CKF_CLOCK_ON_TOKEN 0x40UL
+#define CKF_PROTECTED_AUTHENTICATION_PATH 0x100UL
+#define CKF_DUAL_CRYPTO_OPERATIONS 0x200UL
+#define CKF_TOKEN_INITIALIZED 0x400UL
+#define CKF_SECONDARY_AUTHENTICATION 0x800UL
+#define CKF_USER_PIN_COUNT_LOW 0x10000UL
+#define CKF_USER_PIN_FINAL_TRY 0x20000UL
+#define CKF_USER_PIN_LOCKED 0x40000UL
+#define CKF_USER_PIN_TO_BE_CHANGED 0x80000UL
+#define CKF_SO_PIN_COUNT_LOW 0x100000UL
+#define CKF_SO_PIN_FINAL_TRY 0x200000UL
+#define CKF_SO_PIN_LOCKED 0x400000UL
+#define CKF_SO_PIN_TO_BE_CHANGED 0x800000UL
+#define CKF_RW_SESSION 0x2UL
+#define CKF_SERIAL_SESSION 0x4UL
+#define CKF_OS_LOCKING_OK 0x2UL
+
+// User types.
+#define CKU_SO 0UL
+#define CKU_USER 1UL
+
+// Object classes.
+#define CKO_DATA 0UL
+#define CKO_PUBLIC_KEY 2UL
+#define CKO_PRIVATE_KEY 3UL
+#define CKO_SECRET_KEY 4UL
+
+// Key types.
+#define CKK_EC 3UL
+#define CKK_GENERIC_SECRET 0x10UL
+#define CKK_AES 0x1FUL
+#define CKK_EC_MONTGOMERY 0x41UL
+
+// Attributes.
+#define CKA_CLASS 0x0UL
+#define CKA_TOKEN 0x1UL
+#define CKA_PRIVATE 0x2UL
+#define CKA_LABEL 0x3UL
+#define CKA_VALUE 0x11UL
+#define CKA_KEY_TYPE 0x100UL
+#define CKA_SENSITIVE 0x103UL
+#define CKA_ENCRYPT 0x104UL
+#define CKA_DECRYPT 0x105UL
+#define CKA_WRAP 0x106UL
+#define CKA_UNWRAP 0x107UL
+#define CKA_SIGN 0x108UL
+#define CKA_VERIFY 0x10AUL
+#define CKA_DERIVE 0x10CUL
+#define CKA_VALUE_LEN 0x161UL
+#define CKA_EXTRACTABLE 0x162UL
+#define CKA_MODIFIABLE 0x170UL
+#define CKA_EC_PARAMS 0x180UL
+#define CKA_EC_POINT 0x181UL
+#define CKA_VENDOR_DEFINED 0x80000000UL
+#define CKA_OUID (CKA_VENDOR_DEFINED + 0x113)
+
+// Mechanisms.
+#define CKM_SHA256 0x250UL
+#define CKM_SHA256_HMAC 0x251UL
+#define CKM_SHA256_HMAC_GENERAL 0x252UL
+#define CKM_EC_KEY_PAIR_GEN 0x1040UL
+#define CKM_EC_EDWARDS_KEY_PAIR_GEN 0x1055UL
+#define CKM_EC_MONTGOMERY_KEY_PAIR_GEN 0x1056UL
+#define CKM_AES_KEY_GEN 0x1080UL
+#define CKM_GENERIC_SECRET_KEY_GEN 0x350UL
+#define CKM_VENDOR_DEFINED 0x80000000UL
+#define CKM_AES_KWP (CKM_VENDOR_DEFINED + 0x171)
+#define CKM_ECIES (CKM_VENDOR_DEFINED + 0xA00)
+#define CKM_MILENAGE (CKM_VENDOR_DEFINED + 0x14D)
+#define CKM_MILENAGE_RESYNC (CKM_VENDOR_DEFINED + 0x14E)
+#define CKM_MILENAGE_DERIVE (CKM_VENDOR_DEFINED + 0x14F)
+#define CKM_TUAK (CKM_VENDOR_DEFINED + 0x150)
+#define CKM_TUAK_RESYNC (CKM_VENDOR_DEFINED + 0x151)
+#define CKM_TUAK_DERIVE (CKM_VENDOR_DEFINED + 0x152)
+#define CKM_COMP128 (CKM_VENDOR_DEFINED + 0x153)
+
+// Parameters of the ECIES mechanism.
+#define CKD_SHA256_KDF 0x6UL
+#define CKES_AES_CTR 0x5UL
+#define CKMS_HMAC_SHA256 0x5UL
+#define CKDHP_STANDARD 0x1UL
+
+// Flags of the Milenage and TUAK mechanisms.
+#define LUNA_5G_OPC 0x1UL
+#define LUNA_5G_ENCRYPTED_OP 0x2UL
+#define LUNA_5G_OP_OBJECT 0x4UL
+#define LUNA_5G_USER_DEFINED_RC 0x8UL
+
+// Parameters of the Luna mechanisms.
+typedef CK_ULONG CK_EC_ENC_SCHEME;
+typedef CK_ULONG CK_EC_MAC_SCHEME;
+typedef CK_ULONG CK_EC_DH_PRIMITIVE;
+
+typedef struct CK_ECIES_PARAMS
+{
+    CK_EC_DH_PRIMITIVE dhPrimitive;
+    CK_EC_KDF_TYPE kdf;
+    CK_ULONG ulSharedDataLen1;
+    CK_BYTE_PTR pSharedData1;
+    CK_EC_ENC_SCHEME encScheme;
+    CK_ULONG ulEncKeyLenInBits;
+    CK_EC_MAC_SCHEME macScheme;
+    CK_ULONG ulMacKeyLenInBits;
+    CK_ULONG ulMacLenInBits;
+    CK_ULONG ulSharedDataLen2;
+    CK_BYTE_PTR pSharedData2;
+} CK_ECIES_PARAMS;
+
+typedef struct CK_MILENAGE_SIGN_PARAMS
+{
+    CK_ULONG ulMilenageFlags;
+    CK_BYTE_PTR pEncKi;
+    CK_ULONG ulEncKiLen;
+    CK_OBJECT_HANDLE hSecondaryKey;
+    CK_BYTE_PTR pEncOPc;
+    CK_ULONG ulEncOPcLen;
+    CK_OBJECT_HANDLE hRCKey;
+    CK_BYTE sqn[6];
+    CK_BYTE amf[2];
+} CK_MILENAGE_SIGN_PARAMS;
+
+typedef struct CK_TUAK_SIGN_PARAMS
+{
+    CK_ULONG ulTuakFlags;
+    CK_BYTE_PTR pEncKi;
+    CK_ULONG ulEncKiLen;
+    CK_OBJECT_HANDLE hSecondaryKey;
+    CK_BYTE_PTR pEncTOPc;
+    CK_ULONG ulEncTOPcLen;
+    CK_BYTE sqn[6];
+    CK_BYTE amf[2];
+    CK_ULONG ulIterations;
+    CK_ULONG ulResLen;
+    CK_ULONG ulMacALen;
+    CK_ULONG ulCkLen;
+    CK_ULONG ulIkLen;
+} CK_TUAK_SIGN_PARAMS;
+
+typedef struct CK_COMP128_SIGN_PARAMS
+{
+    CK_ULONG ulVersion;
+    CK_BYTE_PTR pEncKi;
+    CK_ULONG ulEncKiLen;
+} CK_COMP128_SIGN_PARAMS;
+
+// HA state (see CA_GetHAState()).
+typedef struct CK_HA_MEMBER
+{
+    CK_CHAR memberSerial[20];
+    CK_RV memberStatus;
+} CK_HA_MEMBER;
+
+typedef struct CK_HA_STATUS
+{
+    CK_CHAR groupSerial[20];
+    CK_HA_MEMBER memberList[32];
+    CK_ULONG listSize;
+} CK_HA_STATUS;
+
+typedef CK_HA_STATUS *CK_HA_STATE_PTR;
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - The standard functions are listed in the order of the PKCS#11 v2.20
+ *     function list, each one being declared along with its pointer type.
+ */
+#define CK_FUNCTIONS(X) \
+    X(C_Initialize, (CK_VOID_PTR pInitArgs)) \
+    X(C_Finalize, (CK_VOID_PTR pReserved)) \
+    X(C_GetInfo, (CK_INFO_PTR pInfo)) \
+    X(C_GetFunctionList, (CK_FUNCTION_LIST_PTR_PTR ppFunctionList)) \
+    X(C_GetSlotList, (CK_BBOOL tokenPresent, CK_SLOT_ID_PTR pSlotList, CK_ULONG_PTR pulCount)) \
+    X(C_GetSlotInfo, (CK_SLOT_ID slotID, CK_SLOT_INFO_PTR pInfo)) \
+    X(C_GetTokenInfo, (CK_SLOT_ID slotID, CK_TOKEN_INFO_PTR pInfo)) \
+    X(C_GetMechanismList, (CK_SLOT_ID slotID, CK_MECHANISM_TYPE_PTR pMechanismList, CK_ULONG_PTR pulCount)) \
+    X(C_GetMechanismInfo, (CK_SLOT_ID slotID, CK_MECHANISM_TYPE type, CK_MECHANISM_INFO_PTR pInfo)) \
+    X(C_InitToken, (CK_SLOT_ID slotID, CK_CHAR_PTR pPin, CK_ULONG usPinLen, CK_CHAR_PTR pLabel)) \
+    X(C_InitPIN, (CK_SESSION_HANDLE hSession, CK_CHAR_PTR pPin, CK_ULONG usPinLen)) \
+    X(C_SetPIN, (CK_SESSION_HANDLE hSession, CK_CHAR_PTR pOldPin, CK_ULONG usOldLen, CK_CHAR_PTR pNewPin, CK_ULONG usNewLen)) \
+    X(C_OpenSession, (CK_SLOT_ID slotID, CK_FLAGS flags, CK_VOID_PTR pApplication, CK_NOTIFY Notify, CK_SESSION_HANDLE_PTR phSession)) \
+    X(C_CloseSession, (CK_SESSION_HANDLE hSession)) \
+    X(C_CloseAllSessions, (CK_SLOT_ID slotID)) \
+    X(C_GetSessionInfo, (CK_SESSION_HANDLE hSession, CK_SESSION_INFO_PTR pInfo)) \
+    X(C_GetOperationState, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pOperationState, CK_ULONG_PTR pulOperationStateLen)) \
+    X(C_SetOperationState, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pOperationState, CK_ULONG ulOperationStateLen, CK_OBJECT_HANDLE hEncryptionKey, CK_OBJECT_HANDLE hAuthenticationKey)) \
+    X(C_Login, (CK_SESSION_HANDLE hSession, CK_USER_TYPE userType, CK_CHAR_PTR pPin, CK_ULONG usPinLen)) \
+    X(C_Logout, (CK_SESSION_HANDLE hSession)) \
+    X(C_CreateObject, (CK_SESSION_HANDLE hSession, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usCount, CK_OBJECT_HANDLE_PTR phObject)) \
+    X(C_CopyObject, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hObject, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usCount, CK_OBJECT_HANDLE_PTR phNewObject)) \
+    X(C_DestroyObject, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hObject)) \
+    X(C_GetObjectSize, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hObject, CK_ULONG_PTR pusSize)) \
+    X(C_GetAttributeValue, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hObject, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usCount)) \
+    X(C_SetAttributeValue, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hObject, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usCount)) \
+    X(C_FindObjectsInit, (CK_SESSION_HANDLE hSession, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usCount)) \
+    X(C_FindObjects, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE_PTR phObject, CK_ULONG usMaxObjectCount, CK_ULONG_PTR pusObjectCount)) \
+    X(C_FindObjectsFinal, (CK_SESSION_HANDLE hSession)) \
+    X(C_EncryptInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hKey)) \
+    X(C_Encrypt, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_ULONG usDataLen, CK_BYTE_PTR pEncryptedData, CK_ULONG_PTR pusEncryptedDataLen)) \
+    X(C_EncryptUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG usPartLen, CK_BYTE_PTR pEncryptedPart, CK_ULONG_PTR pusEncryptedPartLen)) \
+    X(C_EncryptFinal, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pLastEncryptedPart, CK_ULONG_PTR pusLastEncryptedPartLen)) \
+    X(C_DecryptInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hKey)) \
+    X(C_Decrypt, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pEncryptedData, CK_ULONG usEncryptedDataLen, CK_BYTE_PTR pData, CK_ULONG_PTR pusDataLen)) \
+    X(C_DecryptUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pEncryptedPart, CK_ULONG usEncryptedPartLen, CK_BYTE_PTR pPart, CK_ULONG_PTR pusPartLen)) \
+    X(C_DecryptFinal, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pLastPart, CK_ULONG_PTR pusLastPartLen)) \
+    X(C_DigestInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism)) \
+    X(C_Digest, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_ULONG usDataLen, CK_BYTE_PTR pDigest, CK_ULONG_PTR pusDigestLen)) \
+    X(C_DigestUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG usPartLen)) \
+    X(C_DigestKey, (CK_SESSION_HANDLE hSession, CK_OBJECT_HANDLE hKey)) \
+    X(C_DigestFinal, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pDigest, CK_ULONG_PTR pusDigestLen)) \
+    X(C_SignInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hKey)) \
+    X(C_Sign, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_ULONG usDataLen, CK_BYTE_PTR pSignature, CK_ULONG_PTR pusSignatureLen)) \
+    X(C_SignUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG usPartLen)) \
+    X(C_SignFinal, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pSignature, CK_ULONG_PTR pusSignatureLen)) \
+    X(C_SignRecoverInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hKey)) \
+    X(C_SignRecover, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_ULONG usDataLen, CK_BYTE_PTR pSignature, CK_ULONG_PTR pusSignatureLen)) \
+    X(C_VerifyInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hKey)) \
+    X(C_Verify, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pData, CK_ULONG usDataLen, CK_BYTE_PTR pSignature, CK_ULONG usSignatureLen)) \
+    X(C_VerifyUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG usPartLen)) \
+    X(C_VerifyFinal, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pSignature, CK_ULONG usSignatureLen)) \
+    X(C_VerifyRecoverInit, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hKey)) \
+    X(C_VerifyRecover, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pSignature, CK_ULONG usSignatureLen, CK_BYTE_PTR pData, CK_ULONG_PTR pusDataLen)) \
+    X(C_DigestEncryptUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG ulPartLen, CK_BYTE_PTR pEncryptedPart, CK_ULONG_PTR pulEncryptedPartLen)) \
+    X(C_DecryptDigestUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pEncryptedPart, CK_ULONG ulEncryptedPartLen, CK_BYTE_PTR pPart, CK_ULONG_PTR pulPartLen)) \
+    X(C_SignEncryptUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pPart, CK_ULONG ulPartLen, CK_BYTE_PTR pEncryptedPart, CK_ULONG_PTR pulEncryptedPartLen)) \
+    X(C_DecryptVerifyUpdate, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pEncryptedPart, CK_ULONG ulEncryptedPartLen, CK_BYTE_PTR pPart, CK_ULONG_PTR pulPartLen)) \
+    X(C_GenerateKey, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usCount, CK_OBJECT_HANDLE_PTR phKey)) \
+    X(C_GenerateKeyPair, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_ATTRIBUTE_PTR pPublicKeyTemplate, CK_ULONG usPublicKeyAttributeCount, CK_ATTRIBUTE_PTR pPrivateKeyTemplate, CK_ULONG usPrivateKeyAttributeCount, CK_OBJECT_HANDLE_PTR phPublicKey, CK_OBJECT_HANDLE_PTR phPrivateKey)) \
+    X(C_WrapKey, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hWrappingKey, CK_OBJECT_HANDLE hKey, CK_BYTE_PTR pWrappedKey, CK_ULONG_PTR pusWrappedKeyLen)) \
+    X(C_UnwrapKey, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hUnwrappingKey, CK_BYTE_PTR pWrappedKey, CK_ULONG usWrappedKeyLen, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usAttributeCount, CK_OBJECT_HANDLE_PTR phKey)) \
+    X(C_DeriveKey, (CK_SESSION_HANDLE hSession, CK_MECHANISM_PTR pMechanism, CK_OBJECT_HANDLE hBaseKey, CK_ATTRIBUTE_PTR pTemplate, CK_ULONG usAttributeCount, CK_OBJECT_HANDLE_PTR phKey)) \
+    X(C_SeedRandom, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pSeed, CK_ULONG usSeedLen)) \
+    X(C_GenerateRandom, (CK_SESSION_HANDLE hSession, CK_BYTE_PTR pRandomData, CK_ULONG usRandomLen)) \
+    X(C_GetFunctionStatus, (CK_SESSION_HANDLE hSession)) \
+    X(C_CancelFunction, (CK_SESSION_HANDLE hSession)) \
+    X(C_WaitForSlotEvent, (CK_FLAGS flags, CK_SLOT_ID_PTR pSlot, CK_VOID_PTR pRserved))
+
+typedef struct CK_FUNCTION_LIST CK_FUNCTION_LIST;
+typedef CK_FUNCTION_LIST *CK_FUNCTION_LIST_PTR;
+typedef CK_FUNCTION_LIST_PTR *CK_FUNCTION_LIST_PTR_PTR;
+
+#define CK_DECLARE_FUNCTION(name, arguments) \
+    CK_RV name arguments;                    \
+    typedef CK_RV(*CK_##name) arguments;
+
+CK_FUNCTIONS(CK_DECLARE_FUNCTION)
+
+#define CK_DECLARE_FUNCTION_POINTER(name, arguments) CK_##name name;
+
+struct CK_FUNCTION_LIST
+{
+    CK_VERSION version;
+    CK_FUNCTIONS(CK_DECLARE_FUNCTION_POINTER)
+};
+
+// Luna extensions (only the ones used).
+CK_RV CA_GetHAState(CK_SLOT_ID slotId,
+                    CK_HA_STATE_PTR pState);
+typedef CK_RV (*CK_CA_GetHAState)(CK_SLOT_ID slotId,
+                                  CK_HA_STATE_PTR pState);
+
+CK_RV CA_GetFirmwareVersion(CK_SLOT_ID slotId,
+                            CK_ULONG_PTR pulMajor,
+                            CK_ULONG_PTR pulMinor,
+                            CK_ULONG_PTR pulSubminor);
+typedef CK_RV (*CK_CA_GetFirmwareVersion)(CK_SLOT_ID slotId,
+                                          CK_ULONG_PTR pulMajor,
+                                          CK_ULONG_PTR pulMinor,
+                                          CK_ULONG_PTR pulSubminor);
+
+typedef struct CK_SFNT_CA_FUNCTION_LIST
+{
+    CK_VERSION version;
+    CK_CA_GetFirmwareVersion CA_GetFirmwareVersion;
+    CK_CA_GetHAState CA_GetHAState;
+} CK_SFNT_CA_FUNCTION_LIST;
+
+typedef CK_SFNT_CA_FUNCTION_LIST *CK_SFNT_CA_FUNCTION_LIST_PTR;
+typedef CK_SFNT_CA_FUNCTION_LIST_PTR *CK_SFNT_CA_FUNCTION_LIST_PTR_PTR;
+
+CK_RV CA_GetFunctionList(CK_SFNT_CA_FUNCTION_LIST_PTR_PTR ppSfntFunctionList);
+typedef CK_RV (*CK_CA_GetFunctionList)(CK_SFNT_CA_FUNCTION_LIST_PTR_PTR ppSfntFunctionList);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRYPTOKI_V2_H__ */
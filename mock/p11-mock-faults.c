@@ -0,0 +1,573 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "p11-mock.h"
+
+/*
+ * Notes:
+ *   - Each fault counts the calls it applies to, and the decisions of the
+ *     probability triggers (and the random error codes) are drawn from the
+ *     seed, the fault index and this count only: the n-th call a fault
+ *     applies to always gets the same fault, whatever the threads
+ *     scheduling.
+ *   - The time windows are relative to C_Initialize().
+ */
+#define P11MOCK_MAXIMUM_FAULT_FIELDS_COUNT 3
+
+static const struct
+{
+    const char *name;
+    P11MOCK_FUNCTION function;
+} P11MOCK_FUNCTIONS[] = {{"C_Decrypt", P11MOCK_FUNCTION_DECRYPT},
+                         {"C_Digest", P11MOCK_FUNCTION_DIGEST},
+                         {"C_Encrypt", P11MOCK_FUNCTION_ENCRYPT},
+                         {"C_GenerateKey", P11MOCK_FUNCTION_GENERATE_KEY},
+                         {"C_GenerateKeyPair", P11MOCK_FUNCTION_GENERATE_KEY_PAIR},
+                         {"C_Sign", P11MOCK_FUNCTION_SIGN},
+                         {"C_UnwrapKey", P11MOCK_FUNCTION_UNWRAP_KEY}};
+
+// Error codes by name; 'random' draws one of them.
+static const struct
+{
+    const char *name;
+    CK_RV rv;
+} P11MOCK_ERRORS[] = {{"CKR_DEVICE_ERROR", CKR_DEVICE_ERROR},
+                      {"CKR_SESSION_HANDLE_INVALID", CKR_SESSION_HANDLE_INVALID},
+                      {"CKR_TOKEN_NOT_PRESENT", CKR_TOKEN_NOT_PRESENT}};
+
+#define P11MOCK_ERRORS_COUNT (sizeof(P11MOCK_ERRORS) / sizeof(P11MOCK_ERRORS[0]))
+
+static unsigned long p11mockFaultCallsCounts[P11MOCK_MAXIMUM_FAULTS_COUNT];
+static struct timespec p11mockFaultsOriginTime;
+
+static uint64_t p11mock_mix(uint64_t value)
+{
+    // splitmix64 finalizer.
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+    return value ^ (value >> 31);
+}
+
+static double p11mock_getElapsedSeconds(void)
+{
+    struct timespec currentTime;
+
+    clock_gettime(CLOCK_MONOTONIC,
+                  &currentTime);
+
+    return (double)(currentTime.tv_sec - p11mockFaultsOriginTime.tv_sec) +
+           ((double)(currentTime.tv_nsec - p11mockFaultsOriginTime.tv_nsec) / 1e9);
+}
+
+// Counts the call and tells whether the fault is triggered; the returned
+// draw is used to pick a random error code.
+static bool p11mock_isFaultTriggered(const unsigned long faultIndex,
+                                     const double elapsedSeconds,
+                                     uint64_t *const pDraw)
+{
+    assert(faultIndex < p11mockConfiguration.faultsCount);
+    assert(pDraw != NULL);
+
+    const P11MOCK_FAULT *const pFault = &p11mockConfiguration.faults[faultIndex];
+    const unsigned long callIndex = __atomic_add_fetch(&p11mockFaultCallsCounts[faultIndex], 1, __ATOMIC_RELAXED);
+
+    *pDraw = p11mock_mix(p11mock_mix(p11mockConfiguration.seed ^ faultIndex) ^ callIndex);
+
+    switch (pFault->trigger)
+    {
+    case P11MOCK_FAULT_TRIGGER_PROBABILITY:
+        return ((double)(*pDraw >> 11) / 9007199254740992.0) < pFault->triggerParameters[0];
+
+    case P11MOCK_FAULT_TRIGGER_PERIOD:
+        return (callIndex % pFault->period) == 0;
+
+    case P11MOCK_FAULT_TRIGGER_WINDOW:
+        return (elapsedSeconds >= pFault->triggerParameters[0]) &&
+               (elapsedSeconds < pFault->triggerParameters[1]);
+    }
+
+    return false;
+}
+
+static CK_RV p11mock_getFaultError(const P11MOCK_FAULT *const pFault,
+                                   const uint64_t draw)
+{
+    assert(pFault != NULL);
+
+    if (pFault->rv != CKR_OK)
+    {
+        return pFault->rv;
+    }
+
+    return P11MOCK_ERRORS[p11mock_mix(draw) % P11MOCK_ERRORS_COUNT].rv;
+}
+
+// Splits the text in place; returns the fields count, or 0 if there are too
+// many fields.
+static size_t p11mock_splitFields(char *const text,
+                                  const char separator,
+                                  char **const fields,
+                                  const size_t maximumFieldsCount)
+{
+    assert(text != NULL);
+    assert(fields != NULL);
+
+    size_t fieldsCount = 0;
+    char *pField = text;
+
+    while (pField != NULL)
+    {
+        if (fieldsCount == maximumFieldsCount)
+        {
+            return 0;
+        }
+
+        fields[fieldsCount++] = pField;
+
+        pField = strchr(pField, separator);
+
+        if (pField != NULL)
+        {
+            *pField++ = '\0';
+        }
+    }
+
+    return fieldsCount;
+}
+
+static CK_RV p11mock_parseDouble(const char *const value,
+                                 double *const pResult)
+{
+    assert(value != NULL);
+    assert(pResult != NULL);
+
+    char *pEnd = NULL;
+    const double result = strtod(value, &pEnd);
+
+    if ((pEnd == value) ||
+        (*pEnd != '\0') ||
+        (!isfinite(result)) ||
+        (result < 0.0))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *pResult = result;
+
+    return CKR_OK;
+}
+
+// A name of P11MOCK_ERRORS, 'random' (CKR_OK) or a non-zero number.
+static CK_RV p11mock_parseError(const char *const value,
+                                CK_RV *const pRv)
+{
+    assert(value != NULL);
+    assert(pRv != NULL);
+
+    if (strcmp(value, "random") == 0)
+    {
+        *pRv = CKR_OK;
+
+        return CKR_OK;
+    }
+
+    for (size_t errorIndex = 0; errorIndex < P11MOCK_ERRORS_COUNT; errorIndex++)
+    {
+        if (strcmp(value, P11MOCK_ERRORS[errorIndex].name) == 0)
+        {
+            *pRv = P11MOCK_ERRORS[errorIndex].rv;
+
+            return CKR_OK;
+        }
+    }
+
+    char *pEnd = NULL;
+
+    errno = 0;
+
+    const unsigned long result = strtoul(value, &pEnd, 0);
+
+    if ((errno != 0) ||
+        (pEnd == value) ||
+        (*pEnd != '\0') ||
+        (value[0] == '-') ||
+        (result == CKR_OK))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *pRv = (CK_RV)result;
+
+    return CKR_OK;
+}
+
+static CK_RV p11mock_parseEffect(char *const value,
+                                 P11MOCK_FAULT *const pFault)
+{
+    assert(value != NULL);
+    assert(pFault != NULL);
+
+    char *fields[P11MOCK_MAXIMUM_FAULT_FIELDS_COUNT];
+    const size_t fieldsCount = p11mock_splitFields(value,
+                                                   ':',
+                                                   fields,
+                                                   P11MOCK_MAXIMUM_FAULT_FIELDS_COUNT);
+
+    if ((fieldsCount == 2) && (strcmp(fields[0], "error") == 0))
+    {
+        pFault->effect = P11MOCK_FAULT_EFFECT_ERROR;
+
+        return p11mock_parseError(fields[1],
+                                  &pFault->rv);
+    }
+
+    if ((fieldsCount == 2) &&
+        ((strcmp(fields[0], "spike") == 0) || (strcmp(fields[0], "stall") == 0)))
+    {
+        pFault->effect = (strcmp(fields[0], "spike") == 0) ? P11MOCK_FAULT_EFFECT_SPIKE : P11MOCK_FAULT_EFFECT_STALL;
+
+        return p11mock_parseDouble(fields[1],
+                                   &pFault->duration);
+    }
+
+    if (((fieldsCount == 3) && (strcmp(fields[0], "member") == 0)) ||
+        ((fieldsCount == 2) && (strcmp(fields[0], "down") == 0)))
+    {
+        unsigned long position = 0;
+
+        if ((p11mock_parseUnsignedLong(fields[1], &position) != CKR_OK) ||
+            (position < 1) ||
+            (position > p11mockConfiguration.membersCount))
+        {
+            return CKR_ARGUMENTS_BAD;
+        }
+
+        pFault->memberIndex = position - 1;
+
+        if (fieldsCount == 2)
+        {
+            pFault->effect = P11MOCK_FAULT_EFFECT_MEMBER_DOWN;
+            pFault->rv = CKR_TOKEN_NOT_PRESENT;
+
+            return CKR_OK;
+        }
+
+        pFault->effect = P11MOCK_FAULT_EFFECT_MEMBER_STATUS;
+
+        return p11mock_parseError(fields[2],
+                                  &pFault->rv);
+    }
+
+    return CKR_ARGUMENTS_BAD;
+}
+
+static CK_RV p11mock_parseTrigger(char *const value,
+                                  P11MOCK_FAULT *const pFault)
+{
+    assert(value != NULL);
+    assert(pFault != NULL);
+
+    char *fields[P11MOCK_MAXIMUM_FAULT_FIELDS_COUNT];
+    const size_t fieldsCount = p11mock_splitFields(value,
+                                                   ':',
+                                                   fields,
+                                                   P11MOCK_MAXIMUM_FAULT_FIELDS_COUNT);
+    double *const parameters = pFault->triggerParameters;
+
+    if ((fieldsCount == 2) && (strcmp(fields[0], "probability") == 0))
+    {
+        pFault->trigger = P11MOCK_FAULT_TRIGGER_PROBABILITY;
+
+        return ((p11mock_parseDouble(fields[1], &parameters[0]) == CKR_OK) &&
+                (parameters[0] <= 1.0))
+                   ? CKR_OK
+                   : CKR_ARGUMENTS_BAD;
+    }
+
+    if ((fieldsCount == 2) && (strcmp(fields[0], "every") == 0))
+    {
+        pFault->trigger = P11MOCK_FAULT_TRIGGER_PERIOD;
+
+        return ((p11mock_parseUnsignedLong(fields[1], &pFault->period) == CKR_OK) &&
+                (pFault->period > 0))
+                   ? CKR_OK
+                   : CKR_ARGUMENTS_BAD;
+    }
+
+    if ((fieldsCount == 3) && (strcmp(fields[0], "window") == 0))
+    {
+        pFault->trigger = P11MOCK_FAULT_TRIGGER_WINDOW;
+
+        return ((p11mock_parseDouble(fields[1], &parameters[0]) == CKR_OK) &&
+                (p11mock_parseDouble(fields[2], &parameters[1]) == CKR_OK) &&
+                (parameters[0] < parameters[1]))
+                   ? CKR_OK
+                   : CKR_ARGUMENTS_BAD;
+    }
+
+    return CKR_ARGUMENTS_BAD;
+}
+
+// [<function>=]<effect>@<trigger>
+static CK_RV p11mock_parseFault(char *const value,
+                                P11MOCK_FAULT *const pFault)
+{
+    assert(value != NULL);
+    assert(pFault != NULL);
+
+    char *pEffect = value;
+    char *const pFunctionSeparator = strchr(value, '=');
+
+    memset(pFault,
+           0,
+           sizeof(*pFault));
+
+    pFault->function = P11MOCK_FUNCTION_ANY;
+
+    if (pFunctionSeparator != NULL)
+    {
+        bool isFound = false;
+
+        *pFunctionSeparator = '\0';
+        pEffect = pFunctionSeparator + 1;
+
+        for (size_t functionIndex = 0;
+             (!isFound) && (functionIndex < (sizeof(P11MOCK_FUNCTIONS) / sizeof(P11MOCK_FUNCTIONS[0])));
+             functionIndex++)
+        {
+            if (strcmp(value, P11MOCK_FUNCTIONS[functionIndex].name) == 0)
+            {
+                pFault->function = P11MOCK_FUNCTIONS[functionIndex].function;
+                isFound = true;
+            }
+        }
+
+        if (!isFound)
+        {
+            return CKR_ARGUMENTS_BAD;
+        }
+    }
+
+    char *const pTriggerSeparator = strchr(pEffect, '@');
+
+    if (pTriggerSeparator == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *pTriggerSeparator = '\0';
+
+    if ((p11mock_parseEffect(pEffect, pFault) != CKR_OK) ||
+        (p11mock_parseTrigger(pTriggerSeparator + 1, pFault) != CKR_OK))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    // The members states are only reported by CA_GetHAState(), and a member
+    // is down for a period of time.
+    if (((pFault->effect == P11MOCK_FAULT_EFFECT_MEMBER_STATUS) ||
+         (pFault->effect == P11MOCK_FAULT_EFFECT_MEMBER_DOWN)) &&
+        (pFault->function != P11MOCK_FUNCTION_ANY))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if ((pFault->effect == P11MOCK_FAULT_EFFECT_MEMBER_DOWN) &&
+        (pFault->trigger != P11MOCK_FAULT_TRIGGER_WINDOW))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    return CKR_OK;
+}
+
+CK_RV p11mock_drawServiceFaults(const P11MOCK_FUNCTION function,
+                                double *const pSpikeTime,
+                                double *const pStallTime)
+{
+    assert(pSpikeTime != NULL);
+    assert(pStallTime != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    *pSpikeTime = 0.0;
+    *pStallTime = 0.0;
+
+    if (p11mockConfiguration.faultsCount == 0)
+    {
+        return CKR_OK;
+    }
+
+    const double elapsedSeconds = p11mock_getElapsedSeconds();
+
+    for (unsigned long faultIndex = 0; faultIndex < p11mockConfiguration.faultsCount; faultIndex++)
+    {
+        const P11MOCK_FAULT *const pFault = &p11mockConfiguration.faults[faultIndex];
+        uint64_t draw = 0;
+
+        if ((pFault->effect == P11MOCK_FAULT_EFFECT_MEMBER_STATUS) ||
+            (pFault->effect == P11MOCK_FAULT_EFFECT_MEMBER_DOWN) ||
+            ((pFault->function != P11MOCK_FUNCTION_ANY) && (pFault->function != function)) ||
+            (!p11mock_isFaultTriggered(faultIndex, elapsedSeconds, &draw)))
+        {
+            continue;
+        }
+
+        switch (pFault->effect)
+        {
+        case P11MOCK_FAULT_EFFECT_ERROR:
+            // The first triggered error wins.
+            if (rv == CKR_OK)
+            {
+                rv = p11mock_getFaultError(pFault,
+                                           draw);
+            }
+
+            break;
+
+        case P11MOCK_FAULT_EFFECT_SPIKE:
+            *pSpikeTime += pFault->duration;
+
+            break;
+
+        case P11MOCK_FAULT_EFFECT_STALL:
+            *pStallTime = fmax(*pStallTime,
+                               pFault->duration);
+
+            break;
+
+        case P11MOCK_FAULT_EFFECT_MEMBER_STATUS:
+        case P11MOCK_FAULT_EFFECT_MEMBER_DOWN:
+            break;
+        }
+    }
+
+    return rv;
+}
+
+void p11mock_drawHaStateFaults(CK_RV *const memberStatuses)
+{
+    assert(memberStatuses != NULL);
+
+    if (p11mockConfiguration.faultsCount == 0)
+    {
+        return;
+    }
+
+    const double elapsedSeconds = p11mock_getElapsedSeconds();
+
+    for (unsigned long faultIndex = 0; faultIndex < p11mockConfiguration.faultsCount; faultIndex++)
+    {
+        const P11MOCK_FAULT *const pFault = &p11mockConfiguration.faults[faultIndex];
+        uint64_t draw = 0;
+
+        if ((pFault->effect != P11MOCK_FAULT_EFFECT_MEMBER_STATUS) ||
+            (!p11mock_isFaultTriggered(faultIndex, elapsedSeconds, &draw)))
+        {
+            continue;
+        }
+
+        memberStatuses[pFault->memberIndex] = p11mock_getFaultError(pFault,
+                                                                    draw);
+    }
+}
+
+bool p11mock_isMemberDown(const unsigned long memberIndex)
+{
+    if (p11mockConfiguration.faultsCount == 0)
+    {
+        return false;
+    }
+
+    const double elapsedSeconds = p11mock_getElapsedSeconds();
+
+    for (unsigned long faultIndex = 0; faultIndex < p11mockConfiguration.faultsCount; faultIndex++)
+    {
+        const P11MOCK_FAULT *const pFault = &p11mockConfiguration.faults[faultIndex];
+
+        if ((pFault->effect == P11MOCK_FAULT_EFFECT_MEMBER_DOWN) &&
+            (pFault->memberIndex == memberIndex) &&
+            (elapsedSeconds >= pFault->triggerParameters[0]) &&
+            (elapsedSeconds < pFault->triggerParameters[1]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+CK_RV p11mock_parseFaults(const char *const value)
+{
+    assert(value != NULL);
+
+    CK_RV rv = CKR_OK;
+    char *faults = strdup(value);
+    char *pFault = faults;
+
+    p11mockConfiguration.faultsCount = 0;
+
+    if (faults == NULL)
+    {
+        return CKR_HOST_MEMORY;
+    }
+
+    while ((rv == CKR_OK) && (pFault != NULL))
+    {
+        char *const pSeparator = strchr(pFault, ';');
+
+        if (pSeparator != NULL)
+        {
+            *pSeparator = '\0';
+        }
+
+        if (p11mockConfiguration.faultsCount == P11MOCK_MAXIMUM_FAULTS_COUNT)
+        {
+            rv = CKR_ARGUMENTS_BAD;
+        }
+        else if (pFault[0] != '\0')
+        {
+            rv = p11mock_parseFault(pFault,
+                                    &p11mockConfiguration.faults[p11mockConfiguration.faultsCount]);
+
+            p11mockConfiguration.faultsCount++;
+        }
+
+        pFault = (pSeparator != NULL) ? (pSeparator + 1) : NULL;
+    }
+
+    if (rv != CKR_OK)
+    {
+        p11mockConfiguration.faultsCount = 0;
+    }
+
+    free(faults);
+
+    return rv;
+}
+
+void p11mock_resetFaults(void)
+{
+    memset(p11mockFaultCallsCounts,
+           0,
+           sizeof(p11mockFaultCallsCounts));
+
+    clock_gettime(CLOCK_MONOTONIC,
+                  &p11mockFaultsOriginTime);
+}
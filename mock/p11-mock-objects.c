@@ -0,0 +1,638 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "p11-mock.h"
+
+// DER-encoded OIDs, as provided in CKA_EC_PARAMS.
+static const CK_BYTE P11MOCK_P256_OID[] = {0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07};
+static const CK_BYTE P11MOCK_X25519_OID[] = {0x06, 0x0a, 0x2b, 0x06, 0x01, 0x04, 0x01, 0x97, 0x55, 0x01, 0x05, 0x01};
+
+static P11MOCK_OBJECT *p11mockObjects[P11MOCK_MAXIMUM_OBJECTS_COUNT] = {NULL};
+static size_t p11mockNextObjectIndex = 0;
+static uint64_t p11mockObjectsCreatedCount = 0;
+
+static pthread_rwlock_t p11mockObjectsLock = PTHREAD_RWLOCK_INITIALIZER;
+
+static bool p11mock_isMatchingTemplate(const P11MOCK_OBJECT *const pObject,
+                                       const CK_ATTRIBUTE *const objectTemplate,
+                                       const CK_ULONG objectTemplateSize)
+{
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        const CK_ATTRIBUTE *const pAttribute = &objectTemplate[attributeIndex];
+
+        switch (pAttribute->type)
+        {
+        case CKA_CLASS:
+            if ((pAttribute->usValueLen != sizeof(CK_OBJECT_CLASS)) ||
+                (*(CK_OBJECT_CLASS *)pAttribute->pValue != pObject->objectClass))
+            {
+                return false;
+            }
+
+            break;
+
+        case CKA_KEY_TYPE:
+            if ((pAttribute->usValueLen != sizeof(CK_KEY_TYPE)) ||
+                (*(CK_KEY_TYPE *)pAttribute->pValue != pObject->keyType))
+            {
+                return false;
+            }
+
+            break;
+
+        case CKA_TOKEN:
+            if ((pAttribute->usValueLen != sizeof(CK_BBOOL)) ||
+                ((*(CK_BBOOL *)pAttribute->pValue != CK_FALSE) != (pObject->isTokenObject != CK_FALSE)))
+            {
+                return false;
+            }
+
+            break;
+
+        case CKA_LABEL:
+            if ((pAttribute->usValueLen != pObject->labelLength) ||
+                (memcmp(pAttribute->pValue, pObject->label, pObject->labelLength) != 0))
+            {
+                return false;
+            }
+
+            break;
+
+        case CKA_OUID:
+            if ((pAttribute->usValueLen < P11MOCK_OUID_LENGTH) ||
+                (memcmp(pAttribute->pValue, pObject->ouid, P11MOCK_OUID_LENGTH) != 0))
+            {
+                return false;
+            }
+
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Copies a value into an attribute, as specified for C_GetAttributeValue.
+static CK_RV p11mock_setAttributeValue(CK_ATTRIBUTE *const pAttribute,
+                                       const void *const value,
+                                       const CK_ULONG valueLength)
+{
+    if (pAttribute->pValue == NULL)
+    {
+        pAttribute->usValueLen = valueLength;
+    }
+    else if (pAttribute->usValueLen < valueLength)
+    {
+        pAttribute->usValueLen = CK_UNAVAILABLE_INFORMATION;
+
+        return CKR_BUFFER_TOO_SMALL;
+    }
+    else
+    {
+        memcpy(pAttribute->pValue,
+               value,
+               valueLength);
+
+        pAttribute->usValueLen = valueLength;
+    }
+
+    return CKR_OK;
+}
+
+CK_RV p11mock_createObject(P11MOCK_OBJECT *const pObject,
+                           CK_OBJECT_HANDLE *const pObjectHandle)
+{
+    assert(pObject != NULL);
+    assert(pObjectHandle != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    P11MOCK_OBJECT *pNewObject = (P11MOCK_OBJECT *)malloc(sizeof(P11MOCK_OBJECT));
+
+    if (pNewObject == NULL)
+    {
+        rv = CKR_HOST_MEMORY;
+
+        goto EXIT;
+    }
+
+    pthread_rwlock_wrlock(&p11mockObjectsLock);
+
+    size_t objectIndex = p11mockNextObjectIndex;
+    size_t checkedObjectsCount = 0;
+
+    while ((p11mockObjects[objectIndex] != NULL) &&
+           (checkedObjectsCount < P11MOCK_MAXIMUM_OBJECTS_COUNT))
+    {
+        objectIndex = (objectIndex + 1) % P11MOCK_MAXIMUM_OBJECTS_COUNT;
+        checkedObjectsCount++;
+    }
+
+    if (checkedObjectsCount == P11MOCK_MAXIMUM_OBJECTS_COUNT)
+    {
+        pthread_rwlock_unlock(&p11mockObjectsLock);
+
+        free(pNewObject);
+
+        rv = CKR_DEVICE_MEMORY;
+
+        goto EXIT;
+    }
+
+    // The OUID only has to be unique for the lifetime of the library.
+    uint64_t objectNumber = ++p11mockObjectsCreatedCount;
+
+    memset(pObject->ouid,
+           0,
+           P11MOCK_OUID_LENGTH);
+
+    for (int byteIndex = P11MOCK_OUID_LENGTH - 1; byteIndex >= 0; byteIndex--)
+    {
+        pObject->ouid[byteIndex] = (CK_BYTE)(objectNumber & 0xFF);
+        objectNumber >>= 8;
+    }
+
+    memcpy(pNewObject,
+           pObject,
+           sizeof(P11MOCK_OBJECT));
+
+    p11mockObjects[objectIndex] = pNewObject;
+    p11mockNextObjectIndex = (objectIndex + 1) % P11MOCK_MAXIMUM_OBJECTS_COUNT;
+
+    pthread_rwlock_unlock(&p11mockObjectsLock);
+
+    *pObjectHandle = (CK_OBJECT_HANDLE)(objectIndex + 1);
+
+EXIT:
+    return rv;
+}
+
+CK_RV p11mock_destroyObject(const CK_OBJECT_HANDLE objectHandle)
+{
+    if ((objectHandle == CK_INVALID_HANDLE) ||
+        (objectHandle > P11MOCK_MAXIMUM_OBJECTS_COUNT))
+    {
+        return CKR_OBJECT_HANDLE_INVALID;
+    }
+
+    pthread_rwlock_wrlock(&p11mockObjectsLock);
+
+    P11MOCK_OBJECT *const pObject = p11mockObjects[objectHandle - 1];
+
+    p11mockObjects[objectHandle - 1] = NULL;
+
+    pthread_rwlock_unlock(&p11mockObjectsLock);
+
+    if (pObject == NULL)
+    {
+        return CKR_OBJECT_HANDLE_INVALID;
+    }
+
+    memset(pObject,
+           0,
+           sizeof(P11MOCK_OBJECT));
+
+    free(pObject);
+
+    return CKR_OK;
+}
+
+void p11mock_destroyAllObjects(void)
+{
+    pthread_rwlock_wrlock(&p11mockObjectsLock);
+
+    for (size_t objectIndex = 0; objectIndex < P11MOCK_MAXIMUM_OBJECTS_COUNT; objectIndex++)
+    {
+        if (p11mockObjects[objectIndex] != NULL)
+        {
+            memset(p11mockObjects[objectIndex],
+                   0,
+                   sizeof(P11MOCK_OBJECT));
+
+            free(p11mockObjects[objectIndex]);
+
+            p11mockObjects[objectIndex] = NULL;
+        }
+    }
+
+    p11mockNextObjectIndex = 0;
+
+    pthread_rwlock_unlock(&p11mockObjectsLock);
+}
+
+void p11mock_destroySessionObjects(const CK_SESSION_HANDLE sessionHandle)
+{
+    pthread_rwlock_wrlock(&p11mockObjectsLock);
+
+    for (size_t objectIndex = 0; objectIndex < P11MOCK_MAXIMUM_OBJECTS_COUNT; objectIndex++)
+    {
+        P11MOCK_OBJECT *const pObject = p11mockObjects[objectIndex];
+
+        if ((pObject != NULL) &&
+            (pObject->isTokenObject == CK_FALSE) &&
+            (pObject->ownerSessionHandle == sessionHandle))
+        {
+            memset(pObject,
+                   0,
+                   sizeof(P11MOCK_OBJECT));
+
+            free(pObject);
+
+            p11mockObjects[objectIndex] = NULL;
+        }
+    }
+
+    pthread_rwlock_unlock(&p11mockObjectsLock);
+}
+
+CK_RV p11mock_findObjects(const CK_ATTRIBUTE *const objectTemplate,
+                          const CK_ULONG objectTemplateSize,
+                          CK_OBJECT_HANDLE **const pObjectHandles,
+                          CK_ULONG *const pObjectHandlesCount)
+{
+    assert((objectTemplate != NULL) || (objectTemplateSize == 0));
+    assert(pObjectHandles != NULL);
+    assert(pObjectHandlesCount != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    *pObjectHandles = NULL;
+    *pObjectHandlesCount = 0;
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        switch (objectTemplate[attributeIndex].type)
+        {
+        case CKA_CLASS:
+        case CKA_KEY_TYPE:
+        case CKA_TOKEN:
+        case CKA_LABEL:
+        case CKA_OUID:
+            if ((objectTemplate[attributeIndex].pValue == NULL) &&
+                (objectTemplate[attributeIndex].usValueLen != 0))
+            {
+                rv = CKR_ATTRIBUTE_VALUE_INVALID;
+
+                goto EXIT;
+            }
+
+            break;
+
+        default:
+            rv = CKR_ATTRIBUTE_TYPE_INVALID;
+
+            goto EXIT;
+        }
+    }
+
+    pthread_rwlock_rdlock(&p11mockObjectsLock);
+
+    size_t objectHandlesSize = 0;
+
+    for (size_t objectIndex = 0; objectIndex < P11MOCK_MAXIMUM_OBJECTS_COUNT; objectIndex++)
+    {
+        const P11MOCK_OBJECT *const pObject = p11mockObjects[objectIndex];
+
+        if ((pObject == NULL) ||
+            (!p11mock_isMatchingTemplate(pObject,
+                                         objectTemplate,
+                                         objectTemplateSize)))
+        {
+            continue;
+        }
+
+        if (*pObjectHandlesCount == objectHandlesSize)
+        {
+            objectHandlesSize = (objectHandlesSize == 0) ? 16 : (objectHandlesSize * 2);
+
+            CK_OBJECT_HANDLE *const newObjectHandles = (CK_OBJECT_HANDLE *)realloc(*pObjectHandles,
+                                                                                   objectHandlesSize * sizeof(CK_OBJECT_HANDLE));
+
+            if (newObjectHandles == NULL)
+            {
+                pthread_rwlock_unlock(&p11mockObjectsLock);
+
+                free(*pObjectHandles);
+
+                *pObjectHandles = NULL;
+                *pObjectHandlesCount = 0;
+
+                rv = CKR_HOST_MEMORY;
+
+                goto EXIT;
+            }
+
+            *pObjectHandles = newObjectHandles;
+        }
+
+        (*pObjectHandles)[(*pObjectHandlesCount)++] = (CK_OBJECT_HANDLE)(objectIndex + 1);
+    }
+
+    pthread_rwlock_unlock(&p11mockObjectsLock);
+
+EXIT:
+    return rv;
+}
+
+CK_RV p11mock_getAttributeValues(const CK_OBJECT_HANDLE objectHandle,
+                                 CK_ATTRIBUTE *const objectTemplate,
+                                 const CK_ULONG objectTemplateSize)
+{
+    assert((objectTemplate != NULL) || (objectTemplateSize == 0));
+
+    CK_RV rv = CKR_OK;
+    P11MOCK_OBJECT object;
+
+    rv = p11mock_getObject(objectHandle,
+                           &object);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        CK_ATTRIBUTE *const pAttribute = &objectTemplate[attributeIndex];
+        CK_RV rv2 = CKR_OK;
+
+        switch (pAttribute->type)
+        {
+        case CKA_CLASS:
+            rv2 = p11mock_setAttributeValue(pAttribute,
+                                            &object.objectClass,
+                                            sizeof(object.objectClass));
+
+            break;
+
+        case CKA_KEY_TYPE:
+            rv2 = p11mock_setAttributeValue(pAttribute,
+                                            &object.keyType,
+                                            sizeof(object.keyType));
+
+            break;
+
+        case CKA_TOKEN:
+            rv2 = p11mock_setAttributeValue(pAttribute,
+                                            &object.isTokenObject,
+                                            sizeof(object.isTokenObject));
+
+            break;
+
+        case CKA_LABEL:
+            rv2 = p11mock_setAttributeValue(pAttribute,
+                                            object.label,
+                                            object.labelLength);
+
+            break;
+
+        case CKA_OUID:
+            rv2 = p11mock_setAttributeValue(pAttribute,
+                                            object.ouid,
+                                            P11MOCK_OUID_LENGTH);
+
+            break;
+
+        case CKA_VALUE_LEN:
+            if (object.objectClass != CKO_SECRET_KEY)
+            {
+                pAttribute->usValueLen = CK_UNAVAILABLE_INFORMATION;
+                rv2 = CKR_ATTRIBUTE_TYPE_INVALID;
+            }
+            else
+            {
+                rv2 = p11mock_setAttributeValue(pAttribute,
+                                                &object.valueLength,
+                                                sizeof(object.valueLength));
+            }
+
+            break;
+
+        case CKA_EC_POINT:
+            if (object.objectClass != CKO_PUBLIC_KEY)
+            {
+                pAttribute->usValueLen = CK_UNAVAILABLE_INFORMATION;
+                rv2 = CKR_ATTRIBUTE_TYPE_INVALID;
+            }
+            else
+            {
+                // DER OCTET STRING, as specified by PKCS#11.
+                CK_BYTE point[2 + P11MOCK_MAXIMUM_VALUE_LENGTH];
+
+                point[0] = 0x04;
+                point[1] = (CK_BYTE)object.valueLength;
+
+                memcpy(&point[2],
+                       object.value,
+                       object.valueLength);
+
+                rv2 = p11mock_setAttributeValue(pAttribute,
+                                                point,
+                                                object.valueLength + 2);
+            }
+
+            break;
+
+        case CKA_VALUE:
+            pAttribute->usValueLen = CK_UNAVAILABLE_INFORMATION;
+            rv2 = CKR_ATTRIBUTE_SENSITIVE;
+
+            break;
+
+        default:
+            pAttribute->usValueLen = CK_UNAVAILABLE_INFORMATION;
+            rv2 = CKR_ATTRIBUTE_TYPE_INVALID;
+
+            break;
+        }
+
+        // All the attributes are processed, the first error being reported.
+        if ((rv2 != CKR_OK) && (rv == CKR_OK))
+        {
+            rv = rv2;
+        }
+    }
+
+    memset(&object,
+           0,
+           sizeof(object));
+
+EXIT:
+    return rv;
+}
+
+CK_RV p11mock_getObject(const CK_OBJECT_HANDLE objectHandle,
+                        P11MOCK_OBJECT *const pObject)
+{
+    assert(pObject != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    if ((objectHandle == CK_INVALID_HANDLE) ||
+        (objectHandle > P11MOCK_MAXIMUM_OBJECTS_COUNT))
+    {
+        return CKR_OBJECT_HANDLE_INVALID;
+    }
+
+    pthread_rwlock_rdlock(&p11mockObjectsLock);
+
+    if (p11mockObjects[objectHandle - 1] == NULL)
+    {
+        rv = CKR_OBJECT_HANDLE_INVALID;
+    }
+    else
+    {
+        memcpy(pObject,
+               p11mockObjects[objectHandle - 1],
+               sizeof(P11MOCK_OBJECT));
+    }
+
+    pthread_rwlock_unlock(&p11mockObjectsLock);
+
+    return rv;
+}
+
+CK_RV p11mock_parseTemplate(const CK_ATTRIBUTE *const objectTemplate,
+                            const CK_ULONG objectTemplateSize,
+                            P11MOCK_OBJECT *const pObject,
+                            CK_ULONG *const pValueLength)
+{
+    assert((objectTemplate != NULL) || (objectTemplateSize == 0));
+    assert(pObject != NULL);
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        const CK_ATTRIBUTE *const pAttribute = &objectTemplate[attributeIndex];
+
+        if ((pAttribute->pValue == NULL) &&
+            (pAttribute->usValueLen != 0))
+        {
+            return CKR_ATTRIBUTE_VALUE_INVALID;
+        }
+
+        switch (pAttribute->type)
+        {
+        case CKA_CLASS:
+            if (pAttribute->usValueLen != sizeof(CK_OBJECT_CLASS))
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            pObject->objectClass = *(CK_OBJECT_CLASS *)pAttribute->pValue;
+
+            break;
+
+        case CKA_KEY_TYPE:
+            if (pAttribute->usValueLen != sizeof(CK_KEY_TYPE))
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            pObject->keyType = *(CK_KEY_TYPE *)pAttribute->pValue;
+
+            break;
+
+        case CKA_TOKEN:
+            if (pAttribute->usValueLen != sizeof(CK_BBOOL))
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            pObject->isTokenObject = *(CK_BBOOL *)pAttribute->pValue;
+
+            break;
+
+        case CKA_LABEL:
+            if (pAttribute->usValueLen > P11MOCK_MAXIMUM_LABEL_LENGTH)
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            memcpy(pObject->label,
+                   pAttribute->pValue,
+                   pAttribute->usValueLen);
+
+            pObject->labelLength = pAttribute->usValueLen;
+
+            break;
+
+        case CKA_VALUE:
+            if ((pAttribute->usValueLen == 0) ||
+                (pAttribute->usValueLen > P11MOCK_MAXIMUM_VALUE_LENGTH))
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            memcpy(pObject->value,
+                   pAttribute->pValue,
+                   pAttribute->usValueLen);
+
+            pObject->valueLength = pAttribute->usValueLen;
+
+            break;
+
+        case CKA_VALUE_LEN:
+            if ((pValueLength == NULL) ||
+                (pAttribute->usValueLen != sizeof(CK_ULONG)))
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            *pValueLength = *(CK_ULONG *)pAttribute->pValue;
+
+            break;
+
+        case CKA_EC_PARAMS:
+            if ((pAttribute->usValueLen == sizeof(P11MOCK_P256_OID)) &&
+                (memcmp(pAttribute->pValue, P11MOCK_P256_OID, sizeof(P11MOCK_P256_OID)) == 0))
+            {
+                pObject->curve = P11MOCK_CURVE_P256;
+            }
+            else if ((pAttribute->usValueLen == sizeof(P11MOCK_X25519_OID)) &&
+                     (memcmp(pAttribute->pValue, P11MOCK_X25519_OID, sizeof(P11MOCK_X25519_OID)) == 0))
+            {
+                pObject->curve = P11MOCK_CURVE_X25519;
+            }
+            else
+            {
+                return CKR_ATTRIBUTE_VALUE_INVALID;
+            }
+
+            break;
+
+        // Usage and protection attributes are accepted but not enforced.
+        case CKA_PRIVATE:
+        case CKA_MODIFIABLE:
+        case CKA_SENSITIVE:
+        case CKA_EXTRACTABLE:
+        case CKA_ENCRYPT:
+        case CKA_DECRYPT:
+        case CKA_SIGN:
+        case CKA_VERIFY:
+        case CKA_WRAP:
+        case CKA_UNWRAP:
+        case CKA_DERIVE:
+            break;
+
+        default:
+            return CKR_ATTRIBUTE_TYPE_INVALID;
+        }
+    }
+
+    return CKR_OK;
+}
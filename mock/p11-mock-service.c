@@ -0,0 +1,761 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+
+#include "p11-mock.h"
+
+P11MOCK_CONFIGURATION p11mockConfiguration;
+
+// Member of the emulated HA group. The counters are atomically updated, the
+// mutex being only taken when the concurrency is limited.
+typedef struct _P11MOCK_MEMBER
+{
+    pthread_cond_t condition;
+    unsigned long inFlightOperationsCount;
+    unsigned long queuedOperationsCount;
+    unsigned long servedOperationsCount;
+    unsigned long failedOverOperationsCount;
+} P11MOCK_MEMBER;
+
+static pthread_once_t p11mockMembersOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t p11mockServiceMutex = PTHREAD_MUTEX_INITIALIZER;
+static P11MOCK_MEMBER p11mockMembers[P11MOCK_MAXIMUM_HA_MEMBERS_COUNT];
+static unsigned long p11mockDispatchedOperationsCount = 0;
+static unsigned long p11mockSampledThreadsCount = 0;
+
+// End of the current stall, in nano-seconds of the monotonic clock.
+static uint64_t p11mockStallEndTime = 0;
+
+// Per-thread state: the serving member, the service time distribution of
+// the mechanism, the service start time, the
+// injected faults and the sampling generator.
+static __thread unsigned long p11mockServiceMemberIndex;
+static __thread const P11MOCK_SERVICE_TIME *p11mockServiceTime;
+static __thread uint64_t p11mockServiceBeginTime;
+static __thread double p11mockServiceSpikeTime;
+static __thread CK_RV p11mockServiceError;
+static __thread uint64_t p11mockSamplingState = 0;
+
+static uint64_t p11mock_getNextSample(void)
+{
+    // xorshift64*, seeded once per thread from the configured seed and the
+    // rank of the thread, so that a seed gives the same samples to the
+    // threads started in the same order.
+    if (p11mockSamplingState == 0)
+    {
+        const unsigned long threadRank = __atomic_fetch_add(&p11mockSampledThreadsCount, 1, __ATOMIC_RELAXED);
+
+        p11mockSamplingState = (p11mockConfiguration.seed ^ (threadRank * 0x9E3779B97F4A7C15ULL)) | 1;
+    }
+
+    p11mockSamplingState ^= p11mockSamplingState >> 12;
+    p11mockSamplingState ^= p11mockSamplingState << 25;
+    p11mockSamplingState ^= p11mockSamplingState >> 27;
+
+    return p11mockSamplingState * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t p11mock_getTime(void)
+{
+    struct timespec currentTime;
+
+    clock_gettime(CLOCK_MONOTONIC,
+                  &currentTime);
+
+    return ((uint64_t)currentTime.tv_sec * 1000000000ULL) + (uint64_t)currentTime.tv_nsec;
+}
+
+static void p11mock_sleepUntil(const uint64_t time)
+{
+    const struct timespec endTime = {.tv_sec = (time_t)(time / 1000000000ULL),
+                                     .tv_nsec = (long)(time % 1000000000ULL)};
+
+    while (clock_nanosleep(CLOCK_MONOTONIC,
+                           TIMER_ABSTIME,
+                           &endTime,
+                           NULL) == EINTR)
+    {
+        // Interrupted by a signal: sleep again until the deadline.
+    }
+}
+
+static void p11mock_waitForStallEnd(void)
+{
+    uint64_t stallEndTime = __atomic_load_n(&p11mockStallEndTime, __ATOMIC_ACQUIRE);
+
+    // A stall may be extended while sleeping.
+    while (p11mock_getTime() < stallEndTime)
+    {
+        p11mock_sleepUntil(stallEndTime);
+
+        stallEndTime = __atomic_load_n(&p11mockStallEndTime, __ATOMIC_ACQUIRE);
+    }
+}
+
+static void p11mock_extendStall(const uint64_t stallEndTime)
+{
+    uint64_t currentStallEndTime = __atomic_load_n(&p11mockStallEndTime, __ATOMIC_ACQUIRE);
+
+    while ((currentStallEndTime < stallEndTime) &&
+           (!__atomic_compare_exchange_n(&p11mockStallEndTime,
+                                         &currentStallEndTime,
+                                         stallEndTime,
+                                         false,
+                                         __ATOMIC_ACQ_REL,
+                                         __ATOMIC_ACQUIRE)))
+    {
+        // Updated by another thread: compare again.
+    }
+}
+
+static void p11mock_initializeMembers(void)
+{
+    for (size_t memberIndex = 0; memberIndex < P11MOCK_MAXIMUM_HA_MEMBERS_COUNT; memberIndex++)
+    {
+        pthread_cond_init(&p11mockMembers[memberIndex].condition,
+                          NULL);
+    }
+}
+
+// Returns the index of the member to send an operation to, or
+// P11MOCK_NO_MEMBER if all the members are down.
+static unsigned long p11mock_dispatchOperation(void)
+{
+    const unsigned long membersCount = p11mockConfiguration.membersCount;
+    unsigned long selectedMemberIndex = P11MOCK_NO_MEMBER;
+
+    if (p11mockConfiguration.dispatchPolicy == P11MOCK_DISPATCH_LEAST_BUSY)
+    {
+        unsigned long selectedMemberLoad = 0;
+
+        // The ties are broken in a round-robin way.
+        const unsigned long firstMemberIndex = __atomic_fetch_add(&p11mockDispatchedOperationsCount, 1, __ATOMIC_RELAXED) % membersCount;
+
+        for (unsigned long rank = 0; rank < membersCount; rank++)
+        {
+            const unsigned long memberIndex = (firstMemberIndex + rank) % membersCount;
+            const unsigned long memberLoad = __atomic_load_n(&p11mockMembers[memberIndex].inFlightOperationsCount, __ATOMIC_RELAXED) +
+                                             __atomic_load_n(&p11mockMembers[memberIndex].queuedOperationsCount, __ATOMIC_RELAXED);
+
+            if (((selectedMemberIndex == P11MOCK_NO_MEMBER) || (memberLoad < selectedMemberLoad)) &&
+                (!p11mock_isMemberDown(memberIndex)))
+            {
+                selectedMemberIndex = memberIndex;
+                selectedMemberLoad = memberLoad;
+            }
+        }
+    }
+    else
+    {
+        for (unsigned long rank = 0; (selectedMemberIndex == P11MOCK_NO_MEMBER) && (rank < membersCount); rank++)
+        {
+            const unsigned long memberIndex = __atomic_fetch_add(&p11mockDispatchedOperationsCount, 1, __ATOMIC_RELAXED) % membersCount;
+
+            if (!p11mock_isMemberDown(memberIndex))
+            {
+                selectedMemberIndex = memberIndex;
+            }
+        }
+    }
+
+    return selectedMemberIndex;
+}
+
+static void p11mock_acquireMember(const unsigned long memberIndex)
+{
+    assert(memberIndex < p11mockConfiguration.membersCount);
+
+    P11MOCK_MEMBER *const pMember = &p11mockMembers[memberIndex];
+
+    if (p11mockConfiguration.concurrency == 0)
+    {
+        __atomic_add_fetch(&pMember->inFlightOperationsCount, 1, __ATOMIC_RELAXED);
+
+        return;
+    }
+
+    pthread_mutex_lock(&p11mockServiceMutex);
+
+    __atomic_add_fetch(&pMember->queuedOperationsCount, 1, __ATOMIC_RELAXED);
+
+    while (pMember->inFlightOperationsCount >= p11mockConfiguration.concurrency)
+    {
+        pthread_cond_wait(&pMember->condition,
+                          &p11mockServiceMutex);
+    }
+
+    __atomic_sub_fetch(&pMember->queuedOperationsCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pMember->inFlightOperationsCount, 1, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&p11mockServiceMutex);
+}
+
+static void p11mock_releaseMember(const unsigned long memberIndex,
+                                  const bool isServed)
+{
+    assert(memberIndex < p11mockConfiguration.membersCount);
+
+    P11MOCK_MEMBER *const pMember = &p11mockMembers[memberIndex];
+
+    __atomic_add_fetch(isServed ? &pMember->servedOperationsCount : &pMember->failedOverOperationsCount,
+                       1,
+                       __ATOMIC_RELAXED);
+
+    if (p11mockConfiguration.concurrency == 0)
+    {
+        __atomic_sub_fetch(&pMember->inFlightOperationsCount, 1, __ATOMIC_RELAXED);
+
+        return;
+    }
+
+    pthread_mutex_lock(&p11mockServiceMutex);
+
+    __atomic_sub_fetch(&pMember->inFlightOperationsCount, 1, __ATOMIC_RELAXED);
+
+    pthread_cond_signal(&pMember->condition);
+    pthread_mutex_unlock(&p11mockServiceMutex);
+}
+
+// Uniform sample in ]0, 1[.
+static double p11mock_getUniformSample(void)
+{
+    return ((double)(p11mock_getNextSample() >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static const P11MOCK_SERVICE_TIME *p11mock_findServiceTime(const CK_MECHANISM_TYPE mechanismType)
+{
+    for (unsigned long serviceTimeIndex = 1; serviceTimeIndex < p11mockConfiguration.serviceTimesCount; serviceTimeIndex++)
+    {
+        if (p11mockConfiguration.serviceTimes[serviceTimeIndex].mechanismType == mechanismType)
+        {
+            return &p11mockConfiguration.serviceTimes[serviceTimeIndex];
+        }
+    }
+
+    return &p11mockConfiguration.serviceTimes[0];
+}
+
+static double p11mock_getServiceTime(const P11MOCK_SERVICE_TIME *const pServiceTime)
+{
+    assert(pServiceTime != NULL);
+
+    const double *const parameters = pServiceTime->parameters;
+    double serviceTime = 0.0;
+
+    switch (pServiceTime->distribution)
+    {
+    case P11MOCK_DISTRIBUTION_CONSTANT:
+        serviceTime = parameters[0];
+
+        break;
+
+    case P11MOCK_DISTRIBUTION_UNIFORM:
+        serviceTime = parameters[0] + ((parameters[1] - parameters[0]) * p11mock_getUniformSample());
+
+        break;
+
+    case P11MOCK_DISTRIBUTION_EXPONENTIAL:
+        serviceTime = -parameters[0] * log(p11mock_getUniformSample());
+
+        break;
+
+    case P11MOCK_DISTRIBUTION_NORMAL:
+        // Box-Muller transform.
+        serviceTime = parameters[0] + (parameters[1] *
+                                       sqrt(-2.0 * log(p11mock_getUniformSample())) *
+                                       cos(2.0 * M_PI * p11mock_getUniformSample()));
+
+        break;
+    }
+
+    return (serviceTime > 0.0) ? serviceTime : 0.0;
+}
+
+static CK_RV p11mock_parseDistribution(const char *const value,
+                                       P11MOCK_SERVICE_TIME *const pServiceTime)
+{
+    assert(value != NULL);
+    assert(pServiceTime != NULL);
+
+    static const struct
+    {
+        const char *name;
+        P11MOCK_DISTRIBUTION distribution;
+        int parametersCount;
+    } P11MOCK_DISTRIBUTIONS[] = {{"constant", P11MOCK_DISTRIBUTION_CONSTANT, 1},
+                                 {"uniform", P11MOCK_DISTRIBUTION_UNIFORM, 2},
+                                 {"exponential", P11MOCK_DISTRIBUTION_EXPONENTIAL, 1},
+                                 {"normal", P11MOCK_DISTRIBUTION_NORMAL, 2}};
+
+    const char *const separator = strchr(value, ':');
+
+    if (separator == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    for (size_t distributionIndex = 0;
+         distributionIndex < (sizeof(P11MOCK_DISTRIBUTIONS) / sizeof(P11MOCK_DISTRIBUTIONS[0]));
+         distributionIndex++)
+    {
+        const size_t nameLength = strlen(P11MOCK_DISTRIBUTIONS[distributionIndex].name);
+
+        if (((size_t)(separator - value) != nameLength) ||
+            (strncmp(value, P11MOCK_DISTRIBUTIONS[distributionIndex].name, nameLength) != 0))
+        {
+            continue;
+        }
+
+        double parameters[2] = {0.0, 0.0};
+        const char *pParameter = separator;
+
+        for (int parameterIndex = 0;
+             parameterIndex < P11MOCK_DISTRIBUTIONS[distributionIndex].parametersCount;
+             parameterIndex++)
+        {
+            char *pEnd = NULL;
+
+            if (*pParameter != ':')
+            {
+                return CKR_ARGUMENTS_BAD;
+            }
+
+            parameters[parameterIndex] = strtod(pParameter + 1, &pEnd);
+
+            if ((pEnd == (pParameter + 1)) ||
+                (!isfinite(parameters[parameterIndex])) ||
+                (parameters[parameterIndex] < 0.0))
+            {
+                return CKR_ARGUMENTS_BAD;
+            }
+
+            pParameter = pEnd;
+        }
+
+        if ((*pParameter != '\0') ||
+            ((P11MOCK_DISTRIBUTIONS[distributionIndex].distribution == P11MOCK_DISTRIBUTION_UNIFORM) &&
+             (parameters[1] < parameters[0])))
+        {
+            return CKR_ARGUMENTS_BAD;
+        }
+
+        pServiceTime->distribution = P11MOCK_DISTRIBUTIONS[distributionIndex].distribution;
+        pServiceTime->parameters[0] = parameters[0];
+        pServiceTime->parameters[1] = parameters[1];
+
+        return CKR_OK;
+    }
+
+    return CKR_ARGUMENTS_BAD;
+}
+
+static CK_RV p11mock_parseMechanism(const char *const name,
+                                    CK_MECHANISM_TYPE *const pMechanismType)
+{
+    assert(name != NULL);
+    assert(pMechanismType != NULL);
+
+    // The mechanisms implemented by the mock.
+    static const struct
+    {
+        const char *name;
+        CK_MECHANISM_TYPE mechanismType;
+    } P11MOCK_MECHANISMS[] = {{"CKM_AES_KEY_GEN", CKM_AES_KEY_GEN},
+                              {"CKM_AES_KWP", CKM_AES_KWP},
+                              {"CKM_COMP128", CKM_COMP128},
+                              {"CKM_EC_KEY_PAIR_GEN", CKM_EC_KEY_PAIR_GEN},
+                              {"CKM_EC_MONTGOMERY_KEY_PAIR_GEN", CKM_EC_MONTGOMERY_KEY_PAIR_GEN},
+                              {"CKM_ECIES", CKM_ECIES},
+                              {"CKM_MILENAGE", CKM_MILENAGE},
+                              {"CKM_MILENAGE_RESYNC", CKM_MILENAGE_RESYNC},
+                              {"CKM_SHA256", CKM_SHA256},
+                              {"CKM_SHA256_HMAC", CKM_SHA256_HMAC},
+                              {"CKM_TUAK", CKM_TUAK},
+                              {"CKM_TUAK_RESYNC", CKM_TUAK_RESYNC}};
+
+    for (size_t mechanismIndex = 0;
+         mechanismIndex < (sizeof(P11MOCK_MECHANISMS) / sizeof(P11MOCK_MECHANISMS[0]));
+         mechanismIndex++)
+    {
+        if (strcmp(name, P11MOCK_MECHANISMS[mechanismIndex].name) == 0)
+        {
+            *pMechanismType = P11MOCK_MECHANISMS[mechanismIndex].mechanismType;
+
+            return CKR_OK;
+        }
+    }
+
+    // A value, possibly in hexadecimal (e.g. for a vendor mechanism).
+    char *pEnd = NULL;
+
+    errno = 0;
+
+    *pMechanismType = strtoul(name, &pEnd, 0);
+
+    return ((errno != 0) || (pEnd == name) || (*pEnd != '\0') || (name[0] == '-')) ? CKR_ARGUMENTS_BAD : CKR_OK;
+}
+
+static CK_RV p11mock_parseServiceTimes(const char *const value)
+{
+    assert(value != NULL);
+
+    CK_RV rv = CKR_OK;
+    char *const entries = strdup(value);
+    char *tokenizerContext = NULL;
+
+    if (entries == NULL)
+    {
+        return CKR_HOST_MEMORY;
+    }
+
+    for (char *entry = strtok_r(entries, ";", &tokenizerContext);
+         (rv == CKR_OK) && (entry != NULL);
+         entry = strtok_r(NULL, ";", &tokenizerContext))
+    {
+        char *const separator = strchr(entry, '=');
+        P11MOCK_SERVICE_TIME *pServiceTime = &p11mockConfiguration.serviceTimes[0];
+
+        if (separator != NULL)
+        {
+            if (p11mockConfiguration.serviceTimesCount == P11MOCK_MAXIMUM_SERVICE_TIMES_COUNT)
+            {
+                rv = CKR_ARGUMENTS_BAD;
+
+                break;
+            }
+
+            *separator = '\0';
+
+            pServiceTime = &p11mockConfiguration.serviceTimes[p11mockConfiguration.serviceTimesCount++];
+
+            rv = p11mock_parseMechanism(entry,
+                                        &pServiceTime->mechanismType);
+            entry = separator + 1;
+        }
+
+        if (rv == CKR_OK)
+        {
+            rv = p11mock_parseDistribution(entry,
+                                           pServiceTime);
+        }
+    }
+
+    free(entries);
+
+    return rv;
+}
+
+void p11mock_beginService(const P11MOCK_FUNCTION function,
+                          const CK_MECHANISM_TYPE mechanismType)
+{
+    p11mockServiceTime = p11mock_findServiceTime(mechanismType);
+    p11mockServiceMemberIndex = p11mock_dispatchOperation();
+
+    if (p11mockServiceMemberIndex != P11MOCK_NO_MEMBER)
+    {
+        p11mock_acquireMember(p11mockServiceMemberIndex);
+    }
+
+    p11mock_waitForStallEnd();
+
+    double stallTime = 0.0;
+
+    p11mockServiceBeginTime = p11mock_getTime();
+    p11mockServiceError = p11mock_drawServiceFaults(function,
+                                                    &p11mockServiceSpikeTime,
+                                                    &stallTime);
+
+    if (stallTime > 0.0)
+    {
+        p11mock_extendStall(p11mockServiceBeginTime + (uint64_t)(stallTime * 1000.0));
+    }
+}
+
+CK_RV p11mock_endService(void)
+{
+    double serviceTime = p11mock_getServiceTime(p11mockServiceTime) + p11mockServiceSpikeTime;
+
+    for (unsigned long attempt = 0; p11mockServiceMemberIndex != P11MOCK_NO_MEMBER; attempt++)
+    {
+        if (serviceTime > 0.0)
+        {
+            // The service time includes the time spent in the mock itself.
+            p11mock_sleepUntil(p11mockServiceBeginTime + (uint64_t)(serviceTime * 1000.0));
+        }
+
+        // The operations in flight are frozen as well by a stall.
+        p11mock_waitForStallEnd();
+
+        if ((!p11mock_isMemberDown(p11mockServiceMemberIndex)) ||
+            (attempt == p11mockConfiguration.membersCount))
+        {
+            p11mock_releaseMember(p11mockServiceMemberIndex,
+                                  true);
+
+            return p11mockServiceError;
+        }
+
+        // The member went down while serving the operation: as the HA
+        // client does, the operation is replayed on another member.
+        p11mock_releaseMember(p11mockServiceMemberIndex,
+                              false);
+
+        p11mockServiceMemberIndex = p11mock_dispatchOperation();
+
+        if (p11mockServiceMemberIndex != P11MOCK_NO_MEMBER)
+        {
+            p11mock_acquireMember(p11mockServiceMemberIndex);
+        }
+
+        p11mockServiceBeginTime = p11mock_getTime();
+        serviceTime = p11mock_getServiceTime(p11mockServiceTime);
+    }
+
+    // No member left in the group.
+    return CKR_TOKEN_NOT_PRESENT;
+}
+
+void p11mock_generateRandom(unsigned char *const output,
+                            const size_t length)
+{
+    assert((output != NULL) || (length == 0));
+
+    size_t offset = 0;
+
+    while (offset < length)
+    {
+        const ssize_t result = getrandom(&output[offset],
+                                         length - offset,
+                                         0);
+
+        if (result > 0)
+        {
+            offset += (size_t)result;
+        }
+        else if (errno != EINTR)
+        {
+            // Cannot happen with the Linux random source once initialized.
+            abort();
+        }
+    }
+}
+
+CK_RV p11mock_loadConfiguration(void)
+{
+    CK_RV rv = CKR_OK;
+    const char *value = NULL;
+
+    pthread_once(&p11mockMembersOnce,
+                 p11mock_initializeMembers);
+
+    memset(&p11mockConfiguration,
+           0,
+           sizeof(p11mockConfiguration));
+
+    p11mockConfiguration.serviceTimes[0].mechanismType = CK_UNAVAILABLE_INFORMATION;
+    p11mockConfiguration.serviceTimes[0].distribution = P11MOCK_DISTRIBUTION_CONSTANT;
+    p11mockConfiguration.serviceTimesCount = 1;
+    p11mockConfiguration.membersCount = P11MOCK_DEFAULT_HA_MEMBERS_COUNT;
+    p11mockConfiguration.dispatchPolicy = P11MOCK_DISPATCH_ROUND_ROBIN;
+
+    value = getenv(P11MOCK_SLOT_ID_VARIABLE);
+
+    if ((value != NULL) &&
+        (p11mock_parseUnsignedLong(value,
+                                   &p11mockConfiguration.slotId) != CKR_OK))
+    {
+        fprintf(stderr,
+                "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                P11MOCK_SLOT_ID_VARIABLE,
+                value);
+
+        rv = CKR_ARGUMENTS_BAD;
+    }
+
+    value = getenv(P11MOCK_SERVICE_TIME_VARIABLE);
+
+    if ((value != NULL) &&
+        (p11mock_parseServiceTimes(value) != CKR_OK))
+    {
+        fprintf(stderr,
+                "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                P11MOCK_SERVICE_TIME_VARIABLE,
+                value);
+
+        rv = CKR_ARGUMENTS_BAD;
+    }
+
+    value = getenv(P11MOCK_CONCURRENCY_VARIABLE);
+
+    if ((value != NULL) &&
+        (p11mock_parseUnsignedLong(value,
+                                   &p11mockConfiguration.concurrency) != CKR_OK))
+    {
+        fprintf(stderr,
+                "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                P11MOCK_CONCURRENCY_VARIABLE,
+                value);
+
+        rv = CKR_ARGUMENTS_BAD;
+    }
+
+    value = getenv(P11MOCK_MEMBERS_VARIABLE);
+
+    if (value != NULL)
+    {
+        p11mockConfiguration.isMembersReportEnabled = true;
+
+        if ((p11mock_parseUnsignedLong(value,
+                                       &p11mockConfiguration.membersCount) != CKR_OK) ||
+            (p11mockConfiguration.membersCount == 0) ||
+            (p11mockConfiguration.membersCount > P11MOCK_MAXIMUM_HA_MEMBERS_COUNT))
+        {
+            fprintf(stderr,
+                    "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                    P11MOCK_MEMBERS_VARIABLE,
+                    value);
+
+            p11mockConfiguration.membersCount = P11MOCK_DEFAULT_HA_MEMBERS_COUNT;
+            rv = CKR_ARGUMENTS_BAD;
+        }
+    }
+
+    value = getenv(P11MOCK_DISPATCH_VARIABLE);
+
+    if (value != NULL)
+    {
+        if (strcmp(value, "round-robin") == 0)
+        {
+            p11mockConfiguration.dispatchPolicy = P11MOCK_DISPATCH_ROUND_ROBIN;
+        }
+        else if (strcmp(value, "least-busy") == 0)
+        {
+            p11mockConfiguration.dispatchPolicy = P11MOCK_DISPATCH_LEAST_BUSY;
+        }
+        else
+        {
+            fprintf(stderr,
+                    "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                    P11MOCK_DISPATCH_VARIABLE,
+                    value);
+
+            rv = CKR_ARGUMENTS_BAD;
+        }
+    }
+
+    value = getenv(P11MOCK_SEED_VARIABLE);
+
+    if (value == NULL)
+    {
+        p11mock_generateRandom((unsigned char *)&p11mockConfiguration.seed,
+                               sizeof(p11mockConfiguration.seed));
+    }
+    else
+    {
+        unsigned long seed = 0;
+
+        if (p11mock_parseUnsignedLong(value,
+                                      &seed) != CKR_OK)
+        {
+            fprintf(stderr,
+                    "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                    P11MOCK_SEED_VARIABLE,
+                    value);
+
+            rv = CKR_ARGUMENTS_BAD;
+        }
+
+        p11mockConfiguration.seed = (uint64_t)seed;
+    }
+
+    value = getenv(P11MOCK_FAULTS_VARIABLE);
+
+    if ((value != NULL) &&
+        (p11mock_parseFaults(value) != CKR_OK))
+    {
+        fprintf(stderr,
+                "p11mock_loadConfiguration(): invalid %s value '%s'.\n",
+                P11MOCK_FAULTS_VARIABLE,
+                value);
+
+        rv = CKR_ARGUMENTS_BAD;
+    }
+
+    if ((rv == CKR_OK) &&
+        (p11mockConfiguration.faultsCount > 0))
+    {
+        // Logged so that a run with random faults can be replayed.
+        fprintf(stderr,
+                "p11mock: %lu fault(s) injected with %s=%llu.\n",
+                p11mockConfiguration.faultsCount,
+                P11MOCK_SEED_VARIABLE,
+                (unsigned long long)p11mockConfiguration.seed);
+    }
+
+    for (size_t memberIndex = 0; memberIndex < P11MOCK_MAXIMUM_HA_MEMBERS_COUNT; memberIndex++)
+    {
+        p11mockMembers[memberIndex].servedOperationsCount = 0;
+        p11mockMembers[memberIndex].failedOverOperationsCount = 0;
+    }
+
+    p11mock_resetFaults();
+
+    return rv;
+}
+
+CK_RV p11mock_parseUnsignedLong(const char *const value,
+                                unsigned long *const pResult)
+{
+    assert(value != NULL);
+    assert(pResult != NULL);
+
+    char *pEnd = NULL;
+
+    errno = 0;
+
+    const unsigned long result = strtoul(value, &pEnd, 10);
+
+    if ((errno != 0) ||
+        (pEnd == value) ||
+        (*pEnd != '\0') ||
+        (value[0] == '-'))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *pResult = result;
+
+    return CKR_OK;
+}
+
+void p11mock_writeMembersReport(void)
+{
+    if (!p11mockConfiguration.isMembersReportEnabled)
+    {
+        return;
+    }
+
+    for (unsigned long memberIndex = 0; memberIndex < p11mockConfiguration.membersCount; memberIndex++)
+    {
+        fprintf(stderr,
+                "p11mock: HA member %lu served %lu operation(s), %lu failed over.\n",
+                memberIndex + 1,
+                __atomic_load_n(&p11mockMembers[memberIndex].servedOperationsCount, __ATOMIC_RELAXED),
+                __atomic_load_n(&p11mockMembers[memberIndex].failedOverOperationsCount, __ATOMIC_RELAXED));
+    }
+}
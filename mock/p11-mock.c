@@ -0,0 +1,2689 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <toolkits/comp128-toolkit.h>
+#include <toolkits/ecies-toolkit.h>
+#include <toolkits/milenage-toolkit.h>
+#include <toolkits/sha-toolkit.h>
+#include <toolkits/tuak-toolkit.h>
+
+#include "p11-mock.h"
+
+/*
+ * Notes:
+ *   - As with Luna, the login state is shared by all the sessions of the
+ *     application: logging in again is accepted, and logging out when not
+ *     logged in returns CKR_USER_NOT_AUTHORIZED. The state is reset when
+ *     the last session is closed. The objects are available whatever the
+ *     login state.
+ *   - ECIES, SHA-256 and HMAC-SHA-256 are computed for real, so that the
+ *     SUCI scenario checks hold. The Milenage, TUAK and COMP-128
+ *     authentication vectors are computed for real (TS 35.206, TS 35.231
+ *     and the reverse-engineered COMP-128) from a random RAND, so that they
+ *     can be verified; the resynchronization outputs are random bytes with
+ *     the expected lengths.
+ *   - AES-KWP is emulated by a key stream derived from the key value with
+ *     HMAC-SHA-256, over the RFC 5649 alternative initial value followed by
+ *     the padded data: what C_Encrypt wraps, C_UnwrapKey unwraps, but the
+ *     output is not interoperable with a real AES-KWP.
+ *   - An injected error (see HA_BENCH_MOCK_FAULTS) terminates the active
+ *     operation like any other error, but the session, the objects and the
+ *     login state are left untouched.
+ */
+#define P11MOCK_KWP_HEADER_LENGTH 8
+#define P11MOCK_KWP_BLOCK_LENGTH 8
+
+#define P11MOCK_MILENAGE_AV_LENGTH MLNTK_AV_LENGTH
+#define P11MOCK_MILENAGE_RESYNC_INPUT_LENGTH (16 + 6 + 8)
+#define P11MOCK_COMP128_OUTPUT_LENGTH COMP128TK_TRIPLET_LENGTH
+
+#define P11MOCK_MAXIMUM_KEY_GENERATION_ATTEMPTS 16
+
+typedef enum _P11MOCK_OPERATION
+{
+    P11MOCK_OPERATION_NONE = 0,
+    P11MOCK_OPERATION_DECRYPT,
+    P11MOCK_OPERATION_DIGEST,
+    P11MOCK_OPERATION_ENCRYPT,
+    P11MOCK_OPERATION_FIND,
+    P11MOCK_OPERATION_SIGN
+} P11MOCK_OPERATION;
+
+// Milenage inputs, resolved from the mechanism parameters at
+// initialization time.
+typedef struct _P11MOCK_MILENAGE_INPUTS
+{
+    CK_BYTE ki[MLNTK_KI_LENGTH];
+    CK_BYTE opc[MLNTK_OPC_LENGTH];
+    CK_BYTE rc[MLNTK_RC_LENGTH];
+    bool isUsingDefaultRc;
+    CK_BYTE sqn[MLNTK_SQN_LENGTH];
+    CK_BYTE amf[MLNTK_AMF_LENGTH];
+} P11MOCK_MILENAGE_INPUTS;
+
+// TUAK inputs, resolved from the mechanism parameters at initialization
+// time.
+typedef struct _P11MOCK_TUAK_INPUTS
+{
+    CK_BYTE k[TUAKTK_MAXIMUM_KEY_LENGTH];
+    CK_ULONG kLength;
+    CK_BYTE topc[TUAKTK_TOPC_LENGTH];
+    CK_BYTE sqn[TUAKTK_SQN_LENGTH];
+    CK_BYTE amf[TUAKTK_AMF_LENGTH];
+    CK_ULONG iterations;
+    CK_ULONG resLength;
+    CK_ULONG macLength;
+    CK_ULONG ckLength;
+    CK_ULONG ikLength;
+} P11MOCK_TUAK_INPUTS;
+
+// COMP-128 inputs, resolved from the mechanism parameters at
+// initialization time.
+typedef struct _P11MOCK_COMP128_INPUTS
+{
+    CK_BYTE ki[COMP128TK_KI_LENGTH];
+    unsigned int version;
+} P11MOCK_COMP128_INPUTS;
+
+// Session. The operation key is copied at initialization time.
+typedef struct _P11MOCK_SESSION
+{
+    bool isOpen;
+    CK_FLAGS flags;
+    P11MOCK_OPERATION operation;
+    CK_MECHANISM_TYPE mechanismType;
+    CK_ULONG outputLength;
+    CK_ULONG inputLength;
+    P11MOCK_OBJECT key;
+    P11MOCK_MILENAGE_INPUTS milenageInputs;
+    P11MOCK_TUAK_INPUTS tuakInputs;
+    P11MOCK_COMP128_INPUTS comp128Inputs;
+    CK_OBJECT_HANDLE *foundObjectHandles;
+    CK_ULONG foundObjectHandlesCount;
+    CK_ULONG foundObjectHandleIndex;
+} P11MOCK_SESSION;
+
+static const CK_BYTE P11MOCK_KWP_ALTERNATIVE_IV[] = {0xA6, 0x59, 0x59, 0xA6};
+
+static pthread_mutex_t p11mockMutex = PTHREAD_MUTEX_INITIALIZER;
+static bool p11mockIsInitialized = false;
+static bool p11mockIsLoggedIn = false;
+
+static P11MOCK_SESSION p11mockSessions[P11MOCK_MAXIMUM_SESSIONS_COUNT];
+static size_t p11mockNextSessionIndex = 0;
+static CK_ULONG p11mockSessionsCount = 0;
+
+static CK_FUNCTION_LIST p11mockFunctionList = {.version = {2, 20},
+                                               .C_Initialize = C_Initialize,
+                                               .C_Finalize = C_Finalize,
+                                               .C_GetInfo = C_GetInfo,
+                                               .C_GetFunctionList = C_GetFunctionList,
+                                               .C_GetSlotList = C_GetSlotList,
+                                               .C_GetSlotInfo = C_GetSlotInfo,
+                                               .C_GetTokenInfo = C_GetTokenInfo,
+                                               .C_OpenSession = C_OpenSession,
+                                               .C_CloseSession = C_CloseSession,
+                                               .C_Login = C_Login,
+                                               .C_Logout = C_Logout,
+                                               .C_CreateObject = C_CreateObject,
+                                               .C_DestroyObject = C_DestroyObject,
+                                               .C_GetAttributeValue = C_GetAttributeValue,
+                                               .C_FindObjectsInit = C_FindObjectsInit,
+                                               .C_FindObjects = C_FindObjects,
+                                               .C_FindObjectsFinal = C_FindObjectsFinal,
+                                               .C_EncryptInit = C_EncryptInit,
+                                               .C_Encrypt = C_Encrypt,
+                                               .C_DecryptInit = C_DecryptInit,
+                                               .C_Decrypt = C_Decrypt,
+                                               .C_DigestInit = C_DigestInit,
+                                               .C_Digest = C_Digest,
+                                               .C_SignInit = C_SignInit,
+                                               .C_Sign = C_Sign,
+                                               .C_GenerateKey = C_GenerateKey,
+                                               .C_GenerateKeyPair = C_GenerateKeyPair,
+                                               .C_UnwrapKey = C_UnwrapKey};
+
+static CK_SFNT_CA_FUNCTION_LIST p11mockCaFunctionList = {.version = {2, 20},
+                                                         .CA_GetFirmwareVersion = CA_GetFirmwareVersion,
+                                                         .CA_GetHAState = CA_GetHAState};
+
+static bool p11mock_isInitialized(void)
+{
+    return __atomic_load_n(&p11mockIsInitialized, __ATOMIC_ACQUIRE);
+}
+
+static CK_RV p11mock_checkSlotId(const CK_SLOT_ID slotId)
+{
+    if (!p11mock_isInitialized())
+    {
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    return (slotId == p11mockConfiguration.slotId) ? CKR_OK : CKR_SLOT_ID_INVALID;
+}
+
+static CK_RV p11mock_getSession(const CK_SESSION_HANDLE sessionHandle,
+                                P11MOCK_SESSION **const ppSession)
+{
+    assert(ppSession != NULL);
+
+    if (!p11mock_isInitialized())
+    {
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    if ((sessionHandle == CK_INVALID_HANDLE) ||
+        (sessionHandle > P11MOCK_MAXIMUM_SESSIONS_COUNT) ||
+        (!__atomic_load_n(&p11mockSessions[sessionHandle - 1].isOpen, __ATOMIC_ACQUIRE)))
+    {
+        return CKR_SESSION_HANDLE_INVALID;
+    }
+
+    *ppSession = &p11mockSessions[sessionHandle - 1];
+
+    return CKR_OK;
+}
+
+static void p11mock_endOperation(P11MOCK_SESSION *const pSession)
+{
+    assert(pSession != NULL);
+
+    if (pSession->foundObjectHandles != NULL)
+    {
+        free(pSession->foundObjectHandles);
+
+        pSession->foundObjectHandles = NULL;
+    }
+
+    memset(&pSession->key,
+           0,
+           sizeof(pSession->key));
+    memset(&pSession->milenageInputs,
+           0,
+           sizeof(pSession->milenageInputs));
+    memset(&pSession->tuakInputs,
+           0,
+           sizeof(pSession->tuakInputs));
+    memset(&pSession->comp128Inputs,
+           0,
+           sizeof(pSession->comp128Inputs));
+
+    pSession->operation = P11MOCK_OPERATION_NONE;
+    pSession->mechanismType = 0;
+    pSession->outputLength = 0;
+    pSession->inputLength = 0;
+    pSession->foundObjectHandlesCount = 0;
+    pSession->foundObjectHandleIndex = 0;
+}
+
+// Initializes a cryptographic operation, with a copy of its key if any.
+static CK_RV p11mock_beginOperation(const CK_SESSION_HANDLE sessionHandle,
+                                    const P11MOCK_OPERATION operation,
+                                    const CK_MECHANISM *const pMechanism,
+                                    const CK_OBJECT_HANDLE keyHandle,
+                                    P11MOCK_SESSION **const ppSession)
+{
+    assert(ppSession != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    rv = p11mock_getSession(sessionHandle,
+                            ppSession);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((*ppSession)->operation != P11MOCK_OPERATION_NONE)
+    {
+        rv = CKR_OPERATION_ACTIVE;
+
+        goto EXIT;
+    }
+
+    if (pMechanism == NULL)
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    if (keyHandle != CK_INVALID_HANDLE)
+    {
+        rv = p11mock_getObject(keyHandle,
+                               &(*ppSession)->key);
+
+        if (rv == CKR_OBJECT_HANDLE_INVALID)
+        {
+            rv = CKR_KEY_HANDLE_INVALID;
+        }
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    (*ppSession)->operation = operation;
+    (*ppSession)->mechanismType = pMechanism->mechanism;
+
+EXIT:
+    return rv;
+}
+
+// Checks the output buffer, as specified for the single-part functions. The
+// operation remains active when only the output length is returned.
+static CK_RV p11mock_checkOutput(const CK_BYTE *const output,
+                                 CK_ULONG *const pOutputLength,
+                                 const CK_ULONG requiredLength,
+                                 bool *const pIsDone)
+{
+    assert(pIsDone != NULL);
+
+    *pIsDone = true;
+
+    if (pOutputLength == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if (output == NULL)
+    {
+        *pOutputLength = requiredLength;
+
+        return CKR_OK;
+    }
+
+    if (*pOutputLength < requiredLength)
+    {
+        *pOutputLength = requiredLength;
+
+        return CKR_BUFFER_TOO_SMALL;
+    }
+
+    *pIsDone = false;
+
+    return CKR_OK;
+}
+
+static void p11mock_copyPaddedString(CK_UTF8CHAR *const destination,
+                                     const size_t destinationSize,
+                                     const char *const source)
+{
+    const size_t sourceLength = strlen(source);
+
+    memset(destination,
+           ' ',
+           destinationSize);
+
+    memcpy(destination,
+           source,
+           (sourceLength < destinationSize) ? sourceLength : destinationSize);
+}
+
+static void p11mock_applyWrappingKeyStream(const P11MOCK_OBJECT *const pKey,
+                                           CK_BYTE *const data,
+                                           const size_t length)
+{
+    assert(pKey != NULL);
+    assert(data != NULL);
+
+    unsigned char keyStream[SHATK_SHA256_DIGEST_LENGTH];
+    unsigned char counter[4];
+    uint32_t blockIndex = 0;
+
+    for (size_t offset = 0; offset < length; offset += SHATK_SHA256_DIGEST_LENGTH, blockIndex++)
+    {
+        counter[0] = (unsigned char)(blockIndex >> 24);
+        counter[1] = (unsigned char)(blockIndex >> 16);
+        counter[2] = (unsigned char)(blockIndex >> 8);
+        counter[3] = (unsigned char)blockIndex;
+
+        shatk_hmacSha256(pKey->value,
+                         pKey->valueLength,
+                         counter,
+                         sizeof(counter),
+                         keyStream);
+
+        for (size_t index = 0; (index < SHATK_SHA256_DIGEST_LENGTH) && ((offset + index) < length); index++)
+        {
+            data[offset + index] ^= keyStream[index];
+        }
+    }
+
+    memset(keyStream,
+           0,
+           sizeof(keyStream));
+}
+
+static CK_ULONG p11mock_getWrappedLength(const CK_ULONG length)
+{
+    return P11MOCK_KWP_HEADER_LENGTH + (((length + P11MOCK_KWP_BLOCK_LENGTH - 1) / P11MOCK_KWP_BLOCK_LENGTH) * P11MOCK_KWP_BLOCK_LENGTH);
+}
+
+// Unwraps data wrapped by C_Encrypt with CKM_AES_KWP. The data buffer
+// holds P11MOCK_MAXIMUM_VALUE_LENGTH bytes.
+static CK_RV p11mock_unwrapData(const P11MOCK_OBJECT *const pKey,
+                                const CK_BYTE *const wrappedData,
+                                const CK_ULONG wrappedDataLength,
+                                CK_BYTE *const data,
+                                CK_ULONG *const pDataLength)
+{
+    assert(pKey != NULL);
+    assert(data != NULL);
+    assert(pDataLength != NULL);
+
+    CK_RV rv = CKR_OK;
+    CK_BYTE unwrappedData[P11MOCK_KWP_HEADER_LENGTH + P11MOCK_MAXIMUM_VALUE_LENGTH];
+    CK_ULONG unwrappedDataLength = 0;
+
+    memset(unwrappedData,
+           0,
+           sizeof(unwrappedData));
+
+    if ((wrappedData == NULL) ||
+        (wrappedDataLength < (P11MOCK_KWP_HEADER_LENGTH + P11MOCK_KWP_BLOCK_LENGTH)) ||
+        (wrappedDataLength > sizeof(unwrappedData)) ||
+        ((wrappedDataLength % P11MOCK_KWP_BLOCK_LENGTH) != 0))
+    {
+        rv = CKR_WRAPPED_KEY_LEN_RANGE;
+
+        goto EXIT;
+    }
+
+    memcpy(unwrappedData,
+           wrappedData,
+           wrappedDataLength);
+
+    p11mock_applyWrappingKeyStream(pKey,
+                                   unwrappedData,
+                                   wrappedDataLength);
+
+    unwrappedDataLength = ((CK_ULONG)unwrappedData[4] << 24) |
+                          ((CK_ULONG)unwrappedData[5] << 16) |
+                          ((CK_ULONG)unwrappedData[6] << 8) |
+                          (CK_ULONG)unwrappedData[7];
+
+    if ((memcmp(unwrappedData, P11MOCK_KWP_ALTERNATIVE_IV, sizeof(P11MOCK_KWP_ALTERNATIVE_IV)) != 0) ||
+        (unwrappedDataLength == 0) ||
+        (p11mock_getWrappedLength(unwrappedDataLength) != wrappedDataLength))
+    {
+        rv = CKR_WRAPPED_KEY_INVALID;
+
+        goto EXIT;
+    }
+
+    for (CK_ULONG index = P11MOCK_KWP_HEADER_LENGTH + unwrappedDataLength; index < wrappedDataLength; index++)
+    {
+        if (unwrappedData[index] != 0)
+        {
+            rv = CKR_WRAPPED_KEY_INVALID;
+
+            goto EXIT;
+        }
+    }
+
+    memcpy(data,
+           &unwrappedData[P11MOCK_KWP_HEADER_LENGTH],
+           unwrappedDataLength);
+
+    *pDataLength = unwrappedDataLength;
+
+EXIT:
+    memset(unwrappedData,
+           0,
+           sizeof(unwrappedData));
+
+    return rv;
+}
+
+// Resolves Ki (wrapped by the operation key) and the version.
+static CK_RV p11mock_checkComp128Parameters(P11MOCK_SESSION *const pSession,
+                                            const CK_MECHANISM *const pMechanism)
+{
+    assert(pSession != NULL);
+    assert(pMechanism != NULL);
+
+    CK_RV rv = CKR_OK;
+    const CK_COMP128_SIGN_PARAMS *const pParameters = (const CK_COMP128_SIGN_PARAMS *)pMechanism->pParameter;
+    P11MOCK_COMP128_INPUTS *const pInputs = &pSession->comp128Inputs;
+    CK_BYTE value[P11MOCK_MAXIMUM_VALUE_LENGTH];
+    CK_ULONG valueLength = 0;
+
+    memset(value,
+           0,
+           sizeof(value));
+
+    if ((pParameters == NULL) ||
+        (pMechanism->ulParameterLen != sizeof(CK_COMP128_SIGN_PARAMS)) ||
+        (pParameters->ulVersion < 1) ||
+        (pParameters->ulVersion > 3))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    if ((p11mock_unwrapData(&pSession->key,
+                            pParameters->pEncKi,
+                            pParameters->ulEncKiLen,
+                            value,
+                            &valueLength) != CKR_OK) ||
+        (valueLength != COMP128TK_KI_LENGTH))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    memcpy(pInputs->ki,
+           value,
+           COMP128TK_KI_LENGTH);
+
+    pInputs->version = (unsigned int)pParameters->ulVersion;
+
+EXIT:
+    memset(value,
+           0,
+           sizeof(value));
+
+    return rv;
+}
+
+static CK_RV p11mock_checkEciesParameters(const CK_MECHANISM *const pMechanism)
+{
+    assert(pMechanism != NULL);
+
+    const CK_ECIES_PARAMS *const pParameters = (const CK_ECIES_PARAMS *)pMechanism->pParameter;
+
+    if ((pParameters == NULL) ||
+        (pMechanism->ulParameterLen != sizeof(CK_ECIES_PARAMS)) ||
+        (pParameters->kdf != CKD_SHA256_KDF) ||
+        (pParameters->ulSharedDataLen1 != 0) ||
+        (pParameters->encScheme != CKES_AES_CTR) ||
+        (pParameters->ulEncKeyLenInBits != (ECIESTK_ENCRYPTION_KEY_LENGTH * 8)) ||
+        (pParameters->macScheme != CKMS_HMAC_SHA256) ||
+        (pParameters->ulMacKeyLenInBits != (ECIESTK_MAC_KEY_LENGTH * 8)) ||
+        (pParameters->ulMacLenInBits != (ECIESTK_MAC_LENGTH * 8)) ||
+        (pParameters->ulSharedDataLen2 != 0))
+    {
+        return CKR_MECHANISM_PARAM_INVALID;
+    }
+
+    return CKR_OK;
+}
+
+// Resolves Ki (wrapped by the operation key), OPc (from an object, wrapped
+// or in clear, computed from OP if needed) and RC (from an object or the
+// default ones) as done by Luna.
+static CK_RV p11mock_checkMilenageParameters(P11MOCK_SESSION *const pSession,
+                                             const CK_MECHANISM *const pMechanism)
+{
+    assert(pSession != NULL);
+    assert(pMechanism != NULL);
+
+    CK_RV rv = CKR_OK;
+    const CK_MILENAGE_SIGN_PARAMS *const pParameters = (const CK_MILENAGE_SIGN_PARAMS *)pMechanism->pParameter;
+    P11MOCK_MILENAGE_INPUTS *const pInputs = &pSession->milenageInputs;
+    P11MOCK_OBJECT object;
+    CK_BYTE value[P11MOCK_MAXIMUM_VALUE_LENGTH];
+    CK_ULONG valueLength = 0;
+
+    memset(&object,
+           0,
+           sizeof(object));
+    memset(value,
+           0,
+           sizeof(value));
+
+    if ((pParameters == NULL) ||
+        (pMechanism->ulParameterLen != sizeof(CK_MILENAGE_SIGN_PARAMS)))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    // Ki.
+    if ((p11mock_unwrapData(&pSession->key,
+                            pParameters->pEncKi,
+                            pParameters->ulEncKiLen,
+                            value,
+                            &valueLength) != CKR_OK) ||
+        (valueLength != MLNTK_KI_LENGTH))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    memcpy(pInputs->ki,
+           value,
+           MLNTK_KI_LENGTH);
+
+    // OP or OPc.
+    if ((pParameters->ulMilenageFlags & LUNA_5G_OP_OBJECT) != 0)
+    {
+        rv = p11mock_getObject(pParameters->hSecondaryKey,
+                               &object);
+
+        if (rv != CKR_OK)
+        {
+            rv = CKR_KEY_HANDLE_INVALID;
+
+            goto EXIT;
+        }
+
+        memcpy(value,
+               object.value,
+               object.valueLength);
+
+        valueLength = object.valueLength;
+    }
+    else if ((pParameters->ulMilenageFlags & LUNA_5G_ENCRYPTED_OP) != 0)
+    {
+        if (p11mock_unwrapData(&pSession->key,
+                               pParameters->pEncOPc,
+                               pParameters->ulEncOPcLen,
+                               value,
+                               &valueLength) != CKR_OK)
+        {
+            rv = CKR_MECHANISM_PARAM_INVALID;
+
+            goto EXIT;
+        }
+    }
+    else if ((pParameters->pEncOPc != NULL) &&
+             (pParameters->ulEncOPcLen <= sizeof(value)))
+    {
+        memcpy(value,
+               pParameters->pEncOPc,
+               pParameters->ulEncOPcLen);
+
+        valueLength = pParameters->ulEncOPcLen;
+    }
+
+    if (valueLength != MLNTK_OPC_LENGTH)
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    if ((pParameters->ulMilenageFlags & LUNA_5G_OPC) != 0)
+    {
+        memcpy(pInputs->opc,
+               value,
+               MLNTK_OPC_LENGTH);
+    }
+    else
+    {
+        mlntk_computeOpc(pInputs->ki,
+                         value,
+                         pInputs->opc);
+    }
+
+    // RC. Note: the toolkit only supports byte-aligned rotations.
+    pInputs->isUsingDefaultRc = ((pParameters->ulMilenageFlags & LUNA_5G_USER_DEFINED_RC) == 0);
+
+    if (!pInputs->isUsingDefaultRc)
+    {
+        rv = p11mock_getObject(pParameters->hRCKey,
+                               &object);
+
+        if (rv != CKR_OK)
+        {
+            rv = CKR_KEY_HANDLE_INVALID;
+
+            goto EXIT;
+        }
+
+        if (object.valueLength != MLNTK_RC_LENGTH)
+        {
+            rv = CKR_MECHANISM_PARAM_INVALID;
+
+            goto EXIT;
+        }
+
+        memcpy(pInputs->rc,
+               object.value,
+               MLNTK_RC_LENGTH);
+
+        for (size_t index = MLNTK_RC_LENGTH - 5; index < MLNTK_RC_LENGTH; index++)
+        {
+            if ((pInputs->rc[index] % 8) != 0)
+            {
+                rv = CKR_MECHANISM_PARAM_INVALID;
+
+                goto EXIT;
+            }
+        }
+    }
+
+    memcpy(pInputs->sqn,
+           pParameters->sqn,
+           MLNTK_SQN_LENGTH);
+    memcpy(pInputs->amf,
+           pParameters->amf,
+           MLNTK_AMF_LENGTH);
+
+EXIT:
+    memset(&object,
+           0,
+           sizeof(object));
+    memset(value,
+           0,
+           sizeof(value));
+
+    return rv;
+}
+
+// Resolves K (wrapped by the operation key) and TOPc (from an object,
+// wrapped or in clear, computed from TOP if needed) as done by Luna, then
+// computes the authentication vector length and the expected
+// resynchronization input length for a TUAK mechanism (TS 35.231).
+static CK_RV p11mock_checkTuakParameters(P11MOCK_SESSION *const pSession,
+                                         const CK_MECHANISM *const pMechanism,
+                                         CK_ULONG *const pOutputLength,
+                                         CK_ULONG *const pInputLength)
+{
+    assert(pSession != NULL);
+    assert(pMechanism != NULL);
+    assert(pOutputLength != NULL);
+    assert(pInputLength != NULL);
+
+    CK_RV rv = CKR_OK;
+    const CK_TUAK_SIGN_PARAMS *const pParameters = (const CK_TUAK_SIGN_PARAMS *)pMechanism->pParameter;
+    P11MOCK_TUAK_INPUTS *const pInputs = &pSession->tuakInputs;
+    P11MOCK_OBJECT object;
+    CK_BYTE value[P11MOCK_MAXIMUM_VALUE_LENGTH];
+    CK_ULONG valueLength = 0;
+
+    memset(&object,
+           0,
+           sizeof(object));
+    memset(value,
+           0,
+           sizeof(value));
+
+    if ((pParameters == NULL) ||
+        (pMechanism->ulParameterLen != sizeof(CK_TUAK_SIGN_PARAMS)))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    pInputs->iterations = pParameters->ulIterations;
+    pInputs->resLength = pParameters->ulResLen;
+    pInputs->macLength = pParameters->ulMacALen;
+    pInputs->ckLength = pParameters->ulCkLen;
+    pInputs->ikLength = pParameters->ulIkLen;
+
+    if ((pInputs->iterations == 0) ||
+        (pInputs->iterations > UINT_MAX) ||
+        ((pInputs->resLength != 4) && (pInputs->resLength != 8) && (pInputs->resLength != 16) && (pInputs->resLength != 32)) ||
+        ((pInputs->macLength != 8) && (pInputs->macLength != 16) && (pInputs->macLength != 32)) ||
+        ((pInputs->ckLength != 16) && (pInputs->ckLength != 32)) ||
+        ((pInputs->ikLength != 16) && (pInputs->ikLength != 32)))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    // K.
+    if ((p11mock_unwrapData(&pSession->key,
+                            pParameters->pEncKi,
+                            pParameters->ulEncKiLen,
+                            value,
+                            &valueLength) != CKR_OK) ||
+        ((valueLength != 16) && (valueLength != 32)))
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    memcpy(pInputs->k,
+           value,
+           valueLength);
+
+    pInputs->kLength = valueLength;
+
+    // TOP or TOPc.
+    valueLength = 0;
+
+    if ((pParameters->ulTuakFlags & LUNA_5G_OP_OBJECT) != 0)
+    {
+        rv = p11mock_getObject(pParameters->hSecondaryKey,
+                               &object);
+
+        if (rv != CKR_OK)
+        {
+            rv = CKR_KEY_HANDLE_INVALID;
+
+            goto EXIT;
+        }
+
+        memcpy(value,
+               object.value,
+               object.valueLength);
+
+        valueLength = object.valueLength;
+    }
+    else if ((pParameters->ulTuakFlags & LUNA_5G_ENCRYPTED_OP) != 0)
+    {
+        if (p11mock_unwrapData(&pSession->key,
+                               pParameters->pEncTOPc,
+                               pParameters->ulEncTOPcLen,
+                               value,
+                               &valueLength) != CKR_OK)
+        {
+            rv = CKR_MECHANISM_PARAM_INVALID;
+
+            goto EXIT;
+        }
+    }
+    else if ((pParameters->pEncTOPc != NULL) &&
+             (pParameters->ulEncTOPcLen <= sizeof(value)))
+    {
+        memcpy(value,
+               pParameters->pEncTOPc,
+               pParameters->ulEncTOPcLen);
+
+        valueLength = pParameters->ulEncTOPcLen;
+    }
+
+    if (valueLength != TUAKTK_TOPC_LENGTH)
+    {
+        rv = CKR_MECHANISM_PARAM_INVALID;
+
+        goto EXIT;
+    }
+
+    if ((pParameters->ulTuakFlags & LUNA_5G_OPC) != 0)
+    {
+        memcpy(pInputs->topc,
+               value,
+               TUAKTK_TOPC_LENGTH);
+    }
+    else
+    {
+        tuaktk_computeTopc(pInputs->k,
+                           pInputs->kLength,
+                           value,
+                           (unsigned int)pInputs->iterations,
+                           pInputs->topc);
+    }
+
+    memcpy(pInputs->sqn,
+           pParameters->sqn,
+           TUAKTK_SQN_LENGTH);
+    memcpy(pInputs->amf,
+           pParameters->amf,
+           TUAKTK_AMF_LENGTH);
+
+    *pOutputLength = TUAKTK_AV_LENGTH(pInputs->resLength,
+                                      pInputs->macLength,
+                                      pInputs->ckLength,
+                                      pInputs->ikLength);
+    *pInputLength = TUAKTK_RAND_LENGTH + TUAKTK_SQN_LENGTH + pInputs->macLength;
+
+EXIT:
+    memset(&object,
+           0,
+           sizeof(object));
+    memset(value,
+           0,
+           sizeof(value));
+
+    return rv;
+}
+
+CK_RV C_CloseSession(CK_SESSION_HANDLE hSession)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    p11mock_endOperation(pSession);
+    p11mock_destroySessionObjects(hSession);
+
+    pthread_mutex_lock(&p11mockMutex);
+
+    __atomic_store_n(&pSession->isOpen, false, __ATOMIC_RELEASE);
+
+    p11mockSessionsCount--;
+
+    if (p11mockSessionsCount == 0)
+    {
+        p11mockIsLoggedIn = false;
+    }
+
+    pthread_mutex_unlock(&p11mockMutex);
+
+EXIT:
+    return rv;
+}
+
+CK_RV C_CreateObject(CK_SESSION_HANDLE hSession,
+                     CK_ATTRIBUTE_PTR pTemplate,
+                     CK_ULONG usCount,
+                     CK_OBJECT_HANDLE_PTR phObject)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    P11MOCK_OBJECT object;
+
+    memset(&object,
+           0,
+           sizeof(object));
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (((pTemplate == NULL) && (usCount != 0)) ||
+        (phObject == NULL))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    object.objectClass = CK_UNAVAILABLE_INFORMATION;
+    object.keyType = CK_UNAVAILABLE_INFORMATION;
+
+    rv = p11mock_parseTemplate(pTemplate,
+                               usCount,
+                               &object,
+                               NULL);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    // Only secret keys with a value can be imported.
+    if ((object.objectClass == CK_UNAVAILABLE_INFORMATION) ||
+        (object.keyType == CK_UNAVAILABLE_INFORMATION) ||
+        (object.valueLength == 0))
+    {
+        rv = CKR_TEMPLATE_INCOMPLETE;
+
+        goto EXIT;
+    }
+
+    if ((object.objectClass != CKO_SECRET_KEY) ||
+        ((object.keyType != CKK_GENERIC_SECRET) && (object.keyType != CKK_AES)))
+    {
+        rv = CKR_TEMPLATE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    object.ownerSessionHandle = hSession;
+
+    rv = p11mock_createObject(&object,
+                              phObject);
+
+EXIT:
+    memset(&object,
+           0,
+           sizeof(object));
+
+    return rv;
+}
+
+CK_RV C_Decrypt(CK_SESSION_HANDLE hSession,
+                CK_BYTE_PTR pEncryptedData,
+                CK_ULONG usEncryptedDataLen,
+                CK_BYTE_PTR pData,
+                CK_ULONG_PTR pusDataLen)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    CK_BYTE *decryptedData = NULL;
+    bool isDone = true;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_DECRYPT)
+    {
+        return CKR_OPERATION_NOT_INITIALIZED;
+    }
+
+    if ((pEncryptedData == NULL) || (usEncryptedDataLen == 0))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    CK_ULONG headerLength = ECTK_X25519_KEY_LENGTH;
+
+    if (pSession->key.curve == P11MOCK_CURVE_P256)
+    {
+        headerLength = (pEncryptedData[0] == 0x04) ? ECTK_P256_PUBLIC_KEY_LENGTH : ECTK_P256_COMPRESSED_POINT_LENGTH;
+    }
+
+    if (usEncryptedDataLen < (headerLength + ECIESTK_MAC_LENGTH))
+    {
+        rv = CKR_ENCRYPTED_DATA_LEN_RANGE;
+
+        goto EXIT;
+    }
+
+    rv = p11mock_checkOutput(pData,
+                             pusDataLen,
+                             usEncryptedDataLen - headerLength - ECIESTK_MAC_LENGTH,
+                             &isDone);
+
+    if (isDone)
+    {
+        goto EXIT;
+    }
+
+    // The toolkit needs an output buffer as large as its input.
+    decryptedData = (CK_BYTE *)malloc(usEncryptedDataLen);
+
+    if (decryptedData == NULL)
+    {
+        rv = CKR_HOST_MEMORY;
+        isDone = true;
+
+        goto EXIT;
+    }
+
+    p11mock_beginService(P11MOCK_FUNCTION_DECRYPT,
+                         pSession->mechanismType);
+
+    size_t decryptedDataLength = 0;
+    bool isDecrypted = false;
+
+    if (pSession->key.curve == P11MOCK_CURVE_P256)
+    {
+        isDecrypted = eciestk_decryptWithP256(pSession->key.value,
+                                              pEncryptedData,
+                                              usEncryptedDataLen,
+                                              decryptedData,
+                                              &decryptedDataLength);
+    }
+    else
+    {
+        isDecrypted = eciestk_decryptWithX25519(pSession->key.value,
+                                                pEncryptedData,
+                                                usEncryptedDataLen,
+                                                decryptedData,
+                                                &decryptedDataLength);
+    }
+
+    rv = p11mock_endService();
+
+    isDone = true;
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (!isDecrypted)
+    {
+        rv = CKR_ENCRYPTED_DATA_INVALID;
+
+        goto EXIT;
+    }
+
+    memcpy(pData,
+           decryptedData,
+           decryptedDataLength);
+
+    *pusDataLen = (CK_ULONG)decryptedDataLength;
+
+EXIT:
+    if (decryptedData != NULL)
+    {
+        memset(decryptedData,
+               0,
+               usEncryptedDataLen);
+
+        free(decryptedData);
+    }
+
+    if (isDone)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_DecryptInit(CK_SESSION_HANDLE hSession,
+                    CK_MECHANISM_PTR pMechanism,
+                    CK_OBJECT_HANDLE hKey)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_beginOperation(hSession,
+                                P11MOCK_OPERATION_DECRYPT,
+                                pMechanism,
+                                hKey,
+                                &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pMechanism->mechanism != CKM_ECIES)
+    {
+        rv = CKR_MECHANISM_INVALID;
+    }
+    else if ((pSession->key.objectClass != CKO_PRIVATE_KEY) ||
+             (pSession->key.curve == P11MOCK_CURVE_NONE))
+    {
+        rv = CKR_KEY_TYPE_INCONSISTENT;
+    }
+    else
+    {
+        rv = p11mock_checkEciesParameters(pMechanism);
+    }
+
+    if (rv != CKR_OK)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_DestroyObject(CK_SESSION_HANDLE hSession,
+                      CK_OBJECT_HANDLE hObject)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    return p11mock_destroyObject(hObject);
+}
+
+CK_RV C_Digest(CK_SESSION_HANDLE hSession,
+               CK_BYTE_PTR pData,
+               CK_ULONG usDataLen,
+               CK_BYTE_PTR pDigest,
+               CK_ULONG_PTR pusDigestLen)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    bool isDone = true;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_DIGEST)
+    {
+        return CKR_OPERATION_NOT_INITIALIZED;
+    }
+
+    if ((pData == NULL) && (usDataLen != 0))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    rv = p11mock_checkOutput(pDigest,
+                             pusDigestLen,
+                             SHATK_SHA256_DIGEST_LENGTH,
+                             &isDone);
+
+    if (isDone)
+    {
+        goto EXIT;
+    }
+
+    p11mock_beginService(P11MOCK_FUNCTION_DIGEST,
+                         pSession->mechanismType);
+
+    shatk_sha256(pData,
+                 usDataLen,
+                 pDigest);
+
+    rv = p11mock_endService();
+
+    isDone = true;
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    *pusDigestLen = SHATK_SHA256_DIGEST_LENGTH;
+
+EXIT:
+    if (isDone)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_DigestInit(CK_SESSION_HANDLE hSession,
+                   CK_MECHANISM_PTR pMechanism)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_beginOperation(hSession,
+                                P11MOCK_OPERATION_DIGEST,
+                                pMechanism,
+                                CK_INVALID_HANDLE,
+                                &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pMechanism->mechanism != CKM_SHA256)
+    {
+        p11mock_endOperation(pSession);
+
+        rv = CKR_MECHANISM_INVALID;
+    }
+
+    return rv;
+}
+
+CK_RV C_Encrypt(CK_SESSION_HANDLE hSession,
+                CK_BYTE_PTR pData,
+                CK_ULONG usDataLen,
+                CK_BYTE_PTR pEncryptedData,
+                CK_ULONG_PTR pusEncryptedDataLen)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    bool isDone = true;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_ENCRYPT)
+    {
+        return CKR_OPERATION_NOT_INITIALIZED;
+    }
+
+    if ((pData == NULL) || (usDataLen == 0))
+    {
+        rv = (pData == NULL) ? CKR_ARGUMENTS_BAD : CKR_DATA_LEN_RANGE;
+
+        goto EXIT;
+    }
+
+    CK_ULONG encryptedDataLength = 0;
+
+    if (pSession->mechanismType == CKM_AES_KWP)
+    {
+        encryptedDataLength = p11mock_getWrappedLength(usDataLen);
+    }
+    else if (pSession->key.curve == P11MOCK_CURVE_P256)
+    {
+        encryptedDataLength = ECIESTK_P256_OUTPUT_LENGTH(usDataLen, false);
+    }
+    else
+    {
+        encryptedDataLength = ECIESTK_X25519_OUTPUT_LENGTH(usDataLen);
+    }
+
+    rv = p11mock_checkOutput(pEncryptedData,
+                             pusEncryptedDataLen,
+                             encryptedDataLength,
+                             &isDone);
+
+    if (isDone)
+    {
+        goto EXIT;
+    }
+
+    isDone = true;
+
+    p11mock_beginService(P11MOCK_FUNCTION_ENCRYPT,
+                         pSession->mechanismType);
+
+    if (pSession->mechanismType == CKM_AES_KWP)
+    {
+        memset(pEncryptedData,
+               0,
+               encryptedDataLength);
+
+        memcpy(pEncryptedData,
+               P11MOCK_KWP_ALTERNATIVE_IV,
+               sizeof(P11MOCK_KWP_ALTERNATIVE_IV));
+
+        pEncryptedData[4] = (CK_BYTE)(usDataLen >> 24);
+        pEncryptedData[5] = (CK_BYTE)(usDataLen >> 16);
+        pEncryptedData[6] = (CK_BYTE)(usDataLen >> 8);
+        pEncryptedData[7] = (CK_BYTE)usDataLen;
+
+        memcpy(&pEncryptedData[P11MOCK_KWP_HEADER_LENGTH],
+               pData,
+               usDataLen);
+
+        p11mock_applyWrappingKeyStream(&pSession->key,
+                                       pEncryptedData,
+                                       encryptedDataLength);
+    }
+    else
+    {
+        unsigned char ephemeralPrivateKey[ECTK_P256_SCALAR_LENGTH];
+        bool isEncrypted = false;
+
+        for (int attempt = 0;
+             (!isEncrypted) && (attempt < P11MOCK_MAXIMUM_KEY_GENERATION_ATTEMPTS);
+             attempt++)
+        {
+            p11mock_generateRandom(ephemeralPrivateKey,
+                                   sizeof(ephemeralPrivateKey));
+
+            if (pSession->key.curve == P11MOCK_CURVE_P256)
+            {
+                isEncrypted = eciestk_encryptWithP256(pSession->key.value,
+                                                      ephemeralPrivateKey,
+                                                      false,
+                                                      pData,
+                                                      usDataLen,
+                                                      pEncryptedData);
+            }
+            else
+            {
+                eciestk_encryptWithX25519(pSession->key.value,
+                                          ephemeralPrivateKey,
+                                          pData,
+                                          usDataLen,
+                                          pEncryptedData);
+
+                isEncrypted = true;
+            }
+        }
+
+        memset(ephemeralPrivateKey,
+               0,
+               sizeof(ephemeralPrivateKey));
+
+        if (!isEncrypted)
+        {
+            rv = CKR_FUNCTION_FAILED;
+        }
+    }
+
+    const CK_RV serviceRv = p11mock_endService();
+
+    if (rv == CKR_OK)
+    {
+        rv = serviceRv;
+    }
+
+    if (rv == CKR_OK)
+    {
+        *pusEncryptedDataLen = encryptedDataLength;
+    }
+
+EXIT:
+    if (isDone)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_EncryptInit(CK_SESSION_HANDLE hSession,
+                    CK_MECHANISM_PTR pMechanism,
+                    CK_OBJECT_HANDLE hKey)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_beginOperation(hSession,
+                                P11MOCK_OPERATION_ENCRYPT,
+                                pMechanism,
+                                hKey,
+                                &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    switch (pMechanism->mechanism)
+    {
+    case CKM_AES_KWP:
+        if ((pSession->key.objectClass != CKO_SECRET_KEY) ||
+            (pSession->key.keyType != CKK_AES))
+        {
+            rv = CKR_KEY_TYPE_INCONSISTENT;
+        }
+
+        break;
+
+    case CKM_ECIES:
+        if ((pSession->key.objectClass != CKO_PUBLIC_KEY) ||
+            (pSession->key.curve == P11MOCK_CURVE_NONE))
+        {
+            rv = CKR_KEY_TYPE_INCONSISTENT;
+        }
+        else
+        {
+            rv = p11mock_checkEciesParameters(pMechanism);
+        }
+
+        break;
+
+    default:
+        rv = CKR_MECHANISM_INVALID;
+
+        break;
+    }
+
+    if (rv != CKR_OK)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_Finalize(CK_VOID_PTR pReserved)
+{
+    if (pReserved != NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    pthread_mutex_lock(&p11mockMutex);
+
+    if (!p11mockIsInitialized)
+    {
+        pthread_mutex_unlock(&p11mockMutex);
+
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    __atomic_store_n(&p11mockIsInitialized, false, __ATOMIC_RELEASE);
+
+    for (size_t sessionIndex = 0; sessionIndex < P11MOCK_MAXIMUM_SESSIONS_COUNT; sessionIndex++)
+    {
+        if (p11mockSessions[sessionIndex].isOpen)
+        {
+            p11mock_endOperation(&p11mockSessions[sessionIndex]);
+
+            p11mockSessions[sessionIndex].isOpen = false;
+        }
+    }
+
+    p11mockSessionsCount = 0;
+    p11mockIsLoggedIn = false;
+    p11mockNextSessionIndex = 0;
+
+    // The token objects are not persistent.
+    p11mock_destroyAllObjects();
+
+    p11mock_writeMembersReport();
+
+    pthread_mutex_unlock(&p11mockMutex);
+
+    return CKR_OK;
+}
+
+CK_RV C_FindObjects(CK_SESSION_HANDLE hSession,
+                    CK_OBJECT_HANDLE_PTR phObject,
+                    CK_ULONG usMaxObjectCount,
+                    CK_ULONG_PTR pusObjectCount)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_FIND)
+    {
+        return CKR_OPERATION_NOT_INITIALIZED;
+    }
+
+    if (((phObject == NULL) && (usMaxObjectCount != 0)) ||
+        (pusObjectCount == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *pusObjectCount = 0;
+
+    while ((*pusObjectCount < usMaxObjectCount) &&
+           (pSession->foundObjectHandleIndex < pSession->foundObjectHandlesCount))
+    {
+        phObject[(*pusObjectCount)++] = pSession->foundObjectHandles[pSession->foundObjectHandleIndex++];
+    }
+
+    return CKR_OK;
+}
+
+CK_RV C_FindObjectsFinal(CK_SESSION_HANDLE hSession)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_FIND)
+    {
+        return CKR_OPERATION_NOT_INITIALIZED;
+    }
+
+    p11mock_endOperation(pSession);
+
+    return CKR_OK;
+}
+
+CK_RV C_FindObjectsInit(CK_SESSION_HANDLE hSession,
+                        CK_ATTRIBUTE_PTR pTemplate,
+                        CK_ULONG usCount)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_NONE)
+    {
+        return CKR_OPERATION_ACTIVE;
+    }
+
+    if ((pTemplate == NULL) && (usCount != 0))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    rv = p11mock_findObjects(pTemplate,
+                             usCount,
+                             &pSession->foundObjectHandles,
+                             &pSession->foundObjectHandlesCount);
+
+    if (rv == CKR_OK)
+    {
+        pSession->operation = P11MOCK_OPERATION_FIND;
+        pSession->foundObjectHandleIndex = 0;
+    }
+
+    return rv;
+}
+
+CK_RV C_GenerateKey(CK_SESSION_HANDLE hSession,
+                    CK_MECHANISM_PTR pMechanism,
+                    CK_ATTRIBUTE_PTR pTemplate,
+                    CK_ULONG usCount,
+                    CK_OBJECT_HANDLE_PTR phKey)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    P11MOCK_OBJECT key;
+    CK_ULONG keyLength = 0;
+
+    memset(&key,
+           0,
+           sizeof(key));
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((pMechanism == NULL) ||
+        ((pTemplate == NULL) && (usCount != 0)) ||
+        (phKey == NULL))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    if (pMechanism->mechanism != CKM_AES_KEY_GEN)
+    {
+        rv = CKR_MECHANISM_INVALID;
+
+        goto EXIT;
+    }
+
+    key.objectClass = CKO_SECRET_KEY;
+    key.keyType = CKK_AES;
+
+    rv = p11mock_parseTemplate(pTemplate,
+                               usCount,
+                               &key,
+                               &keyLength);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((key.objectClass != CKO_SECRET_KEY) ||
+        (key.keyType != CKK_AES) ||
+        (key.valueLength != 0))
+    {
+        rv = CKR_TEMPLATE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    if ((keyLength != 16) && (keyLength != 24) && (keyLength != 32))
+    {
+        rv = (keyLength == 0) ? CKR_TEMPLATE_INCOMPLETE : CKR_KEY_SIZE_RANGE;
+
+        goto EXIT;
+    }
+
+    p11mock_beginService(P11MOCK_FUNCTION_GENERATE_KEY,
+                         pMechanism->mechanism);
+
+    p11mock_generateRandom(key.value,
+                           keyLength);
+
+    rv = p11mock_endService();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    key.valueLength = keyLength;
+    key.ownerSessionHandle = hSession;
+
+    rv = p11mock_createObject(&key,
+                              phKey);
+
+EXIT:
+    memset(&key,
+           0,
+           sizeof(key));
+
+    return rv;
+}
+
+CK_RV C_GenerateKeyPair(CK_SESSION_HANDLE hSession,
+                        CK_MECHANISM_PTR pMechanism,
+                        CK_ATTRIBUTE_PTR pPublicKeyTemplate,
+                        CK_ULONG usPublicKeyAttributeCount,
+                        CK_ATTRIBUTE_PTR pPrivateKeyTemplate,
+                        CK_ULONG usPrivateKeyAttributeCount,
+                        CK_OBJECT_HANDLE_PTR phPublicKey,
+                        CK_OBJECT_HANDLE_PTR phPrivateKey)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    P11MOCK_OBJECT publicKey;
+    P11MOCK_OBJECT privateKey;
+
+    memset(&publicKey,
+           0,
+           sizeof(publicKey));
+    memset(&privateKey,
+           0,
+           sizeof(privateKey));
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((pMechanism == NULL) ||
+        ((pPublicKeyTemplate == NULL) && (usPublicKeyAttributeCount != 0)) ||
+        ((pPrivateKeyTemplate == NULL) && (usPrivateKeyAttributeCount != 0)) ||
+        (phPublicKey == NULL) ||
+        (phPrivateKey == NULL))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    P11MOCK_CURVE expectedCurve = P11MOCK_CURVE_NONE;
+
+    switch (pMechanism->mechanism)
+    {
+    case CKM_EC_KEY_PAIR_GEN:
+        expectedCurve = P11MOCK_CURVE_P256;
+        publicKey.keyType = CKK_EC;
+
+        break;
+
+    case CKM_EC_MONTGOMERY_KEY_PAIR_GEN:
+        expectedCurve = P11MOCK_CURVE_X25519;
+        publicKey.keyType = CKK_EC_MONTGOMERY;
+
+        break;
+
+    default:
+        rv = CKR_MECHANISM_INVALID;
+
+        goto EXIT;
+    }
+
+    publicKey.objectClass = CKO_PUBLIC_KEY;
+    privateKey.objectClass = CKO_PRIVATE_KEY;
+    privateKey.keyType = publicKey.keyType;
+
+    rv = p11mock_parseTemplate(pPublicKeyTemplate,
+                               usPublicKeyAttributeCount,
+                               &publicKey,
+                               NULL);
+
+    if (rv == CKR_OK)
+    {
+        rv = p11mock_parseTemplate(pPrivateKeyTemplate,
+                                   usPrivateKeyAttributeCount,
+                                   &privateKey,
+                                   NULL);
+    }
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (publicKey.curve == P11MOCK_CURVE_NONE)
+    {
+        rv = CKR_TEMPLATE_INCOMPLETE;
+
+        goto EXIT;
+    }
+
+    if ((publicKey.curve != expectedCurve) ||
+        (publicKey.objectClass != CKO_PUBLIC_KEY) ||
+        (privateKey.objectClass != CKO_PRIVATE_KEY) ||
+        (publicKey.valueLength != 0) ||
+        (privateKey.valueLength != 0))
+    {
+        rv = CKR_TEMPLATE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    privateKey.curve = publicKey.curve;
+
+    p11mock_beginService(P11MOCK_FUNCTION_GENERATE_KEY_PAIR,
+                         pMechanism->mechanism);
+
+    if (publicKey.curve == P11MOCK_CURVE_P256)
+    {
+        bool isGenerated = false;
+
+        for (int attempt = 0;
+             (!isGenerated) && (attempt < P11MOCK_MAXIMUM_KEY_GENERATION_ATTEMPTS);
+             attempt++)
+        {
+            p11mock_generateRandom(privateKey.value,
+                                   ECTK_P256_SCALAR_LENGTH);
+
+            isGenerated = ectk_p256ComputePublicKey(privateKey.value,
+                                                    publicKey.value);
+        }
+
+        if (!isGenerated)
+        {
+            rv = CKR_FUNCTION_FAILED;
+        }
+
+        privateKey.valueLength = ECTK_P256_SCALAR_LENGTH;
+        publicKey.valueLength = ECTK_P256_PUBLIC_KEY_LENGTH;
+    }
+    else
+    {
+        p11mock_generateRandom(privateKey.value,
+                               ECTK_X25519_KEY_LENGTH);
+
+        ectk_x25519ComputePublicKey(privateKey.value,
+                                    publicKey.value);
+
+        privateKey.valueLength = ECTK_X25519_KEY_LENGTH;
+        publicKey.valueLength = ECTK_X25519_KEY_LENGTH;
+    }
+
+    const CK_RV serviceRv = p11mock_endService();
+
+    if (rv == CKR_OK)
+    {
+        rv = serviceRv;
+    }
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    publicKey.ownerSessionHandle = hSession;
+    privateKey.ownerSessionHandle = hSession;
+
+    rv = p11mock_createObject(&publicKey,
+                              phPublicKey);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    rv = p11mock_createObject(&privateKey,
+                              phPrivateKey);
+
+    if (rv != CKR_OK)
+    {
+        p11mock_destroyObject(*phPublicKey); // Ignore result value
+
+        *phPublicKey = CK_INVALID_HANDLE;
+    }
+
+EXIT:
+    memset(&privateKey,
+           0,
+           sizeof(privateKey));
+
+    return rv;
+}
+
+CK_RV C_GetAttributeValue(CK_SESSION_HANDLE hSession,
+                          CK_OBJECT_HANDLE hObject,
+                          CK_ATTRIBUTE_PTR pTemplate,
+                          CK_ULONG usCount)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if ((pTemplate == NULL) && (usCount != 0))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    return p11mock_getAttributeValues(hObject,
+                                      pTemplate,
+                                      usCount);
+}
+
+CK_RV C_GetFunctionList(CK_FUNCTION_LIST_PTR_PTR ppFunctionList)
+{
+    if (ppFunctionList == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *ppFunctionList = &p11mockFunctionList;
+
+    return CKR_OK;
+}
+
+CK_RV C_GetInfo(CK_INFO_PTR pInfo)
+{
+    if (!p11mock_isInitialized())
+    {
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    if (pInfo == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    memset(pInfo,
+           0,
+           sizeof(CK_INFO));
+
+    pInfo->cryptokiVersion.major = 2;
+    pInfo->cryptokiVersion.minor = 20;
+    pInfo->libraryVersion.major = 1;
+    pInfo->libraryVersion.minor = 0;
+
+    p11mock_copyPaddedString(pInfo->manufacturerID,
+                             sizeof(pInfo->manufacturerID),
+                             "Luna HA-Bench");
+    p11mock_copyPaddedString(pInfo->libraryDescription,
+                             sizeof(pInfo->libraryDescription),
+                             "Mock PKCS#11 provider");
+
+    return CKR_OK;
+}
+
+CK_RV C_GetSlotInfo(CK_SLOT_ID slotID,
+                    CK_SLOT_INFO_PTR pInfo)
+{
+    CK_RV rv = p11mock_checkSlotId(slotID);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pInfo == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    memset(pInfo,
+           0,
+           sizeof(CK_SLOT_INFO));
+
+    p11mock_copyPaddedString(pInfo->slotDescription,
+                             sizeof(pInfo->slotDescription),
+                             "HA Virtual Card Slot (mock)");
+    p11mock_copyPaddedString(pInfo->manufacturerID,
+                             sizeof(pInfo->manufacturerID),
+                             "Luna HA-Bench");
+
+    pInfo->flags = CKF_TOKEN_PRESENT;
+    pInfo->firmwareVersion.major = P11MOCK_FIRMWARE_MAJOR_VERSION;
+    pInfo->firmwareVersion.minor = P11MOCK_FIRMWARE_MINOR_VERSION;
+
+    return CKR_OK;
+}
+
+CK_RV C_GetSlotList(CK_BBOOL tokenPresent,
+                    CK_SLOT_ID_PTR pSlotList,
+                    CK_ULONG_PTR pulCount)
+{
+    if (!p11mock_isInitialized())
+    {
+        return CKR_CRYPTOKI_NOT_INITIALIZED;
+    }
+
+    if (pulCount == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    // The slot always holds a token.
+    (void)tokenPresent;
+
+    if (pSlotList != NULL)
+    {
+        if (*pulCount < 1)
+        {
+            *pulCount = 1;
+
+            return CKR_BUFFER_TOO_SMALL;
+        }
+
+        pSlotList[0] = p11mockConfiguration.slotId;
+    }
+
+    *pulCount = 1;
+
+    return CKR_OK;
+}
+
+CK_RV C_GetTokenInfo(CK_SLOT_ID slotID,
+                     CK_TOKEN_INFO_PTR pInfo)
+{
+    CK_RV rv = p11mock_checkSlotId(slotID);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pInfo == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    memset(pInfo,
+           0,
+           sizeof(CK_TOKEN_INFO));
+
+    // The model identifies the HA virtual slots.
+    p11mock_copyPaddedString(pInfo->label,
+                             sizeof(pInfo->label),
+                             "ha-bench-mock");
+    p11mock_copyPaddedString(pInfo->manufacturerID,
+                             sizeof(pInfo->manufacturerID),
+                             "Luna HA-Bench");
+    p11mock_copyPaddedString(pInfo->model,
+                             sizeof(pInfo->model),
+                             "LunaVirtual");
+    p11mock_copyPaddedString(pInfo->serialNumber,
+                             sizeof(pInfo->serialNumber),
+                             "1000000");
+    p11mock_copyPaddedString(pInfo->utcTime,
+                             sizeof(pInfo->utcTime),
+                             "");
+
+    pInfo->flags = CKF_RNG | CKF_LOGIN_REQUIRED | CKF_USER_PIN_INITIALIZED | CKF_TOKEN_INITIALIZED;
+    pInfo->usMaxSessionCount = P11MOCK_MAXIMUM_SESSIONS_COUNT;
+    pInfo->usSessionCount = __atomic_load_n(&p11mockSessionsCount, __ATOMIC_RELAXED);
+    pInfo->usMaxRwSessionCount = P11MOCK_MAXIMUM_SESSIONS_COUNT;
+    pInfo->usRwSessionCount = pInfo->usSessionCount;
+    pInfo->usMaxPinLen = 255;
+    pInfo->usMinPinLen = 1;
+    pInfo->ulTotalPublicMemory = CK_UNAVAILABLE_INFORMATION;
+    pInfo->ulFreePublicMemory = CK_UNAVAILABLE_INFORMATION;
+    pInfo->ulTotalPrivateMemory = CK_UNAVAILABLE_INFORMATION;
+    pInfo->ulFreePrivateMemory = CK_UNAVAILABLE_INFORMATION;
+    pInfo->firmwareVersion.major = P11MOCK_FIRMWARE_MAJOR_VERSION;
+    pInfo->firmwareVersion.minor = P11MOCK_FIRMWARE_MINOR_VERSION;
+
+    return CKR_OK;
+}
+
+CK_RV C_Initialize(CK_VOID_PTR pInitArgs)
+{
+    CK_RV rv = CKR_OK;
+
+    pthread_mutex_lock(&p11mockMutex);
+
+    if (p11mockIsInitialized)
+    {
+        rv = CKR_CRYPTOKI_ALREADY_INITIALIZED;
+
+        goto EXIT;
+    }
+
+    // The mock always relies on the native locking primitives.
+    if ((pInitArgs != NULL) &&
+        (((CK_C_INITIALIZE_ARGS *)pInitArgs)->pReserved != NULL))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    rv = p11mock_loadConfiguration();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    __atomic_store_n(&p11mockIsInitialized, true, __ATOMIC_RELEASE);
+
+EXIT:
+    pthread_mutex_unlock(&p11mockMutex);
+
+    return rv;
+}
+
+CK_RV C_Login(CK_SESSION_HANDLE hSession,
+              CK_USER_TYPE userType,
+              CK_CHAR_PTR pPin,
+              CK_ULONG usPinLen)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (userType != CKU_USER)
+    {
+        return CKR_USER_TYPE_INVALID;
+    }
+
+    // Any password is accepted.
+    if ((pPin == NULL) || (usPinLen == 0))
+    {
+        return CKR_PIN_INCORRECT;
+    }
+
+    pthread_mutex_lock(&p11mockMutex);
+
+    p11mockIsLoggedIn = true;
+
+    pthread_mutex_unlock(&p11mockMutex);
+
+    return CKR_OK;
+}
+
+CK_RV C_Logout(CK_SESSION_HANDLE hSession)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    pthread_mutex_lock(&p11mockMutex);
+
+    rv = p11mockIsLoggedIn ? CKR_OK : CKR_USER_NOT_AUTHORIZED;
+
+    p11mockIsLoggedIn = false;
+
+    pthread_mutex_unlock(&p11mockMutex);
+
+    return rv;
+}
+
+CK_RV C_OpenSession(CK_SLOT_ID slotID,
+                    CK_FLAGS flags,
+                    CK_VOID_PTR pApplication,
+                    CK_NOTIFY Notify,
+                    CK_SESSION_HANDLE_PTR phSession)
+{
+    CK_RV rv = p11mock_checkSlotId(slotID);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (phSession == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if ((flags & CKF_SERIAL_SESSION) == 0)
+    {
+        return CKR_SESSION_PARALLEL_NOT_SUPPORTED;
+    }
+
+    // Notifications are not supported.
+    (void)pApplication;
+    (void)Notify;
+
+    pthread_mutex_lock(&p11mockMutex);
+
+    if (p11mockSessionsCount == P11MOCK_MAXIMUM_SESSIONS_COUNT)
+    {
+        rv = CKR_SESSION_COUNT;
+
+        goto EXIT;
+    }
+
+    size_t sessionIndex = p11mockNextSessionIndex;
+
+    while (p11mockSessions[sessionIndex].isOpen)
+    {
+        sessionIndex = (sessionIndex + 1) % P11MOCK_MAXIMUM_SESSIONS_COUNT;
+    }
+
+    P11MOCK_SESSION *const pSession = &p11mockSessions[sessionIndex];
+
+    memset(pSession,
+           0,
+           sizeof(P11MOCK_SESSION));
+
+    pSession->flags = flags;
+
+    __atomic_store_n(&pSession->isOpen, true, __ATOMIC_RELEASE);
+
+    p11mockSessionsCount++;
+    p11mockNextSessionIndex = (sessionIndex + 1) % P11MOCK_MAXIMUM_SESSIONS_COUNT;
+
+    *phSession = (CK_SESSION_HANDLE)(sessionIndex + 1);
+
+EXIT:
+    pthread_mutex_unlock(&p11mockMutex);
+
+    return rv;
+}
+
+CK_RV C_Sign(CK_SESSION_HANDLE hSession,
+             CK_BYTE_PTR pData,
+             CK_ULONG usDataLen,
+             CK_BYTE_PTR pSignature,
+             CK_ULONG_PTR pusSignatureLen)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    bool isDone = true;
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->operation != P11MOCK_OPERATION_SIGN)
+    {
+        return CKR_OPERATION_NOT_INITIALIZED;
+    }
+
+    if ((pData == NULL) && (usDataLen != 0))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    // The resynchronization mechanisms expect RAND || AUTS.
+    if ((pSession->inputLength != 0) &&
+        (usDataLen != pSession->inputLength))
+    {
+        rv = CKR_DATA_LEN_RANGE;
+
+        goto EXIT;
+    }
+
+    rv = p11mock_checkOutput(pSignature,
+                             pusSignatureLen,
+                             pSession->outputLength,
+                             &isDone);
+
+    if (isDone)
+    {
+        goto EXIT;
+    }
+
+    p11mock_beginService(P11MOCK_FUNCTION_SIGN,
+                         pSession->mechanismType);
+
+    if (pSession->mechanismType == CKM_SHA256_HMAC)
+    {
+        shatk_hmacSha256(pSession->key.value,
+                         pSession->key.valueLength,
+                         pData,
+                         usDataLen,
+                         pSignature);
+    }
+    else if (pSession->mechanismType == CKM_MILENAGE)
+    {
+        const P11MOCK_MILENAGE_INPUTS *const pInputs = &pSession->milenageInputs;
+
+        // RAND is the first field of the authentication vector.
+        p11mock_generateRandom(pSignature,
+                               MLNTK_RAND_LENGTH);
+
+        mlntk_generateAuthenticationVector(pInputs->ki,
+                                           pInputs->opc,
+                                           (pInputs->isUsingDefaultRc ? NULL : pInputs->rc),
+                                           pSignature,
+                                           pInputs->sqn,
+                                           pInputs->amf,
+                                           pSignature);
+    }
+    else if (pSession->mechanismType == CKM_TUAK)
+    {
+        const P11MOCK_TUAK_INPUTS *const pInputs = &pSession->tuakInputs;
+
+        // RAND is the first field of the authentication vector. Note: the
+        // lengths are checked at initialization time.
+        p11mock_generateRandom(pSignature,
+                               TUAKTK_RAND_LENGTH);
+
+        tuaktk_generateAuthenticationVector(pInputs->topc,
+                                            pInputs->k,
+                                            pInputs->kLength,
+                                            pSignature,
+                                            pInputs->sqn,
+                                            pInputs->amf,
+                                            (unsigned int)pInputs->iterations,
+                                            pInputs->resLength,
+                                            pInputs->macLength,
+                                            pInputs->ckLength,
+                                            pInputs->ikLength,
+                                            pSignature);
+    }
+    else if (pSession->mechanismType == CKM_COMP128)
+    {
+        const P11MOCK_COMP128_INPUTS *const pInputs = &pSession->comp128Inputs;
+
+        // RAND is the first field of the triplet.
+        p11mock_generateRandom(pSignature,
+                               COMP128TK_RAND_LENGTH);
+
+        comp128tk_generateTriplet(pInputs->version,
+                                  pInputs->ki,
+                                  pSignature,
+                                  pSignature);
+    }
+    else
+    {
+        p11mock_generateRandom(pSignature,
+                               pSession->outputLength);
+    }
+
+    rv = p11mock_endService();
+
+    isDone = true;
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    *pusSignatureLen = pSession->outputLength;
+
+EXIT:
+    if (isDone)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_SignInit(CK_SESSION_HANDLE hSession,
+                 CK_MECHANISM_PTR pMechanism,
+                 CK_OBJECT_HANDLE hKey)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+
+    rv = p11mock_beginOperation(hSession,
+                                P11MOCK_OPERATION_SIGN,
+                                pMechanism,
+                                hKey,
+                                &pSession);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pSession->key.objectClass != CKO_SECRET_KEY)
+    {
+        rv = CKR_KEY_TYPE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    switch (pMechanism->mechanism)
+    {
+    case CKM_MILENAGE:
+        rv = p11mock_checkMilenageParameters(pSession,
+                                             pMechanism);
+
+        pSession->outputLength = P11MOCK_MILENAGE_AV_LENGTH;
+
+        break;
+
+    case CKM_MILENAGE_RESYNC:
+        if ((pMechanism->pParameter == NULL) ||
+            (pMechanism->ulParameterLen != sizeof(CK_MILENAGE_SIGN_PARAMS)))
+        {
+            rv = CKR_MECHANISM_PARAM_INVALID;
+        }
+
+        pSession->outputLength = P11MOCK_MILENAGE_AV_LENGTH;
+        pSession->inputLength = P11MOCK_MILENAGE_RESYNC_INPUT_LENGTH;
+
+        break;
+
+    case CKM_TUAK:
+    case CKM_TUAK_RESYNC:
+    {
+        CK_ULONG inputLength = 0;
+
+        rv = p11mock_checkTuakParameters(pSession,
+                                         pMechanism,
+                                         &pSession->outputLength,
+                                         &inputLength);
+
+        if (pMechanism->mechanism == CKM_TUAK_RESYNC)
+        {
+            pSession->inputLength = inputLength;
+        }
+
+        break;
+    }
+
+    case CKM_COMP128:
+        rv = p11mock_checkComp128Parameters(pSession,
+                                            pMechanism);
+
+        pSession->outputLength = P11MOCK_COMP128_OUTPUT_LENGTH;
+
+        break;
+
+    case CKM_SHA256_HMAC:
+        if (pSession->key.valueLength == 0)
+        {
+            rv = CKR_KEY_TYPE_INCONSISTENT;
+        }
+
+        pSession->outputLength = SHATK_SHA256_DIGEST_LENGTH;
+
+        break;
+
+    default:
+        rv = CKR_MECHANISM_INVALID;
+
+        break;
+    }
+
+EXIT:
+    if (rv != CKR_OK)
+    {
+        p11mock_endOperation(pSession);
+    }
+
+    return rv;
+}
+
+CK_RV C_UnwrapKey(CK_SESSION_HANDLE hSession,
+                  CK_MECHANISM_PTR pMechanism,
+                  CK_OBJECT_HANDLE hUnwrappingKey,
+                  CK_BYTE_PTR pWrappedKey,
+                  CK_ULONG usWrappedKeyLen,
+                  CK_ATTRIBUTE_PTR pTemplate,
+                  CK_ULONG usAttributeCount,
+                  CK_OBJECT_HANDLE_PTR phKey)
+{
+    CK_RV rv = CKR_OK;
+    P11MOCK_SESSION *pSession = NULL;
+    P11MOCK_OBJECT unwrappingKey;
+    P11MOCK_OBJECT key;
+    CK_BYTE unwrappedData[P11MOCK_MAXIMUM_VALUE_LENGTH];
+    CK_ULONG unwrappedDataLength = 0;
+    CK_ULONG keyLength = 0;
+
+    memset(&unwrappingKey,
+           0,
+           sizeof(unwrappingKey));
+    memset(&key,
+           0,
+           sizeof(key));
+    memset(unwrappedData,
+           0,
+           sizeof(unwrappedData));
+
+    rv = p11mock_getSession(hSession,
+                            &pSession);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((pMechanism == NULL) ||
+        (pWrappedKey == NULL) ||
+        ((pTemplate == NULL) && (usAttributeCount != 0)) ||
+        (phKey == NULL))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        goto EXIT;
+    }
+
+    if (pMechanism->mechanism != CKM_AES_KWP)
+    {
+        rv = CKR_MECHANISM_INVALID;
+
+        goto EXIT;
+    }
+
+    rv = p11mock_getObject(hUnwrappingKey,
+                           &unwrappingKey);
+
+    if (rv != CKR_OK)
+    {
+        rv = CKR_UNWRAPPING_KEY_HANDLE_INVALID;
+
+        goto EXIT;
+    }
+
+    if ((unwrappingKey.objectClass != CKO_SECRET_KEY) ||
+        (unwrappingKey.keyType != CKK_AES))
+    {
+        rv = CKR_UNWRAPPING_KEY_TYPE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    if ((usWrappedKeyLen < (P11MOCK_KWP_HEADER_LENGTH + P11MOCK_KWP_BLOCK_LENGTH)) ||
+        (usWrappedKeyLen > (P11MOCK_KWP_HEADER_LENGTH + P11MOCK_MAXIMUM_VALUE_LENGTH)) ||
+        ((usWrappedKeyLen % P11MOCK_KWP_BLOCK_LENGTH) != 0))
+    {
+        rv = CKR_WRAPPED_KEY_LEN_RANGE;
+
+        goto EXIT;
+    }
+
+    key.objectClass = CKO_SECRET_KEY;
+    key.keyType = CKK_GENERIC_SECRET;
+
+    rv = p11mock_parseTemplate(pTemplate,
+                               usAttributeCount,
+                               &key,
+                               &keyLength);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((key.objectClass != CKO_SECRET_KEY) ||
+        (key.valueLength != 0))
+    {
+        rv = CKR_TEMPLATE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    p11mock_beginService(P11MOCK_FUNCTION_UNWRAP_KEY,
+                         pMechanism->mechanism);
+
+    rv = p11mock_unwrapData(&unwrappingKey,
+                            pWrappedKey,
+                            usWrappedKeyLen,
+                            unwrappedData,
+                            &unwrappedDataLength);
+
+    if (rv == CKR_OK)
+    {
+        rv = p11mock_endService();
+    }
+    else
+    {
+        p11mock_endService(); // Ignore the result code.
+    }
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if ((keyLength != 0) &&
+        (keyLength != unwrappedDataLength))
+    {
+        rv = CKR_TEMPLATE_INCONSISTENT;
+
+        goto EXIT;
+    }
+
+    memcpy(key.value,
+           unwrappedData,
+           unwrappedDataLength);
+
+    key.valueLength = unwrappedDataLength;
+    key.ownerSessionHandle = hSession;
+
+    rv = p11mock_createObject(&key,
+                              phKey);
+
+EXIT:
+    memset(&unwrappingKey,
+           0,
+           sizeof(unwrappingKey));
+    memset(&key,
+           0,
+           sizeof(key));
+    memset(unwrappedData,
+           0,
+           sizeof(unwrappedData));
+
+    return rv;
+}
+
+CK_RV CA_GetFirmwareVersion(CK_SLOT_ID slotId,
+                            CK_ULONG_PTR pulMajor,
+                            CK_ULONG_PTR pulMinor,
+                            CK_ULONG_PTR pulSubminor)
+{
+    CK_RV rv = p11mock_checkSlotId(slotId);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if ((pulMajor == NULL) || (pulMinor == NULL) || (pulSubminor == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *pulMajor = P11MOCK_FIRMWARE_MAJOR_VERSION;
+    *pulMinor = P11MOCK_FIRMWARE_MINOR_VERSION;
+    *pulSubminor = P11MOCK_FIRMWARE_SUBMINOR_VERSION;
+
+    return CKR_OK;
+}
+
+CK_RV CA_GetFunctionList(CK_SFNT_CA_FUNCTION_LIST_PTR_PTR ppSfntFunctionList)
+{
+    if (ppSfntFunctionList == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *ppSfntFunctionList = &p11mockCaFunctionList;
+
+    return CKR_OK;
+}
+
+CK_RV CA_GetHAState(CK_SLOT_ID slotId,
+                    CK_HA_STATE_PTR pState)
+{
+    CK_RV rv = p11mock_checkSlotId(slotId);
+
+    if (rv != CKR_OK)
+    {
+        return rv;
+    }
+
+    if (pState == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    memset(pState,
+           0,
+           sizeof(CK_HA_STATUS));
+
+    snprintf((char *)pState->groupSerial,
+             sizeof(pState->groupSerial),
+             "1%06lu",
+             (unsigned long)slotId);
+
+    CK_RV memberStatuses[P11MOCK_MAXIMUM_HA_MEMBERS_COUNT];
+
+    for (unsigned long memberIndex = 0; memberIndex < p11mockConfiguration.membersCount; memberIndex++)
+    {
+        memberStatuses[memberIndex] = p11mock_isMemberDown(memberIndex) ? CKR_TOKEN_NOT_PRESENT : CKR_OK;
+    }
+
+    p11mock_drawHaStateFaults(memberStatuses);
+
+    for (unsigned long memberIndex = 0; memberIndex < p11mockConfiguration.membersCount; memberIndex++)
+    {
+        snprintf((char *)pState->memberList[memberIndex].memberSerial,
+                 sizeof(pState->memberList[memberIndex].memberSerial),
+                 "%lu",
+                 1000001 + memberIndex);
+
+        pState->memberList[memberIndex].memberStatus = memberStatuses[memberIndex];
+    }
+
+    pState->listSize = p11mockConfiguration.membersCount;
+
+    return CKR_OK;
+}
@@ -0,0 +1,304 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __P11_MOCK_H__
+#define __P11_MOCK_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cryptoki_v2.h>
+
+#include <toolkits/ec-toolkit.h>
+
+/*
+ * Definitions
+ *
+ * Mock of the Luna PKCS#11 provider, limited to the functions and
+ * mechanisms used by ha-bench. It exposes a single HA slot and keeps its
+ * objects in memory, so that the tool can be exercised without any HSM.
+ *
+ * The HA slot is backed by emulated members, each one with its own queue:
+ * every operation is dispatched to a member that is up, and replayed on
+ * another one if its member goes down while serving it (as done by the
+ * Luna HA client). The objects are shared by all the members.
+ *
+ * Its behavior is configured through the following environment variables,
+ * read by C_Initialize():
+ *   - HA_BENCH_MOCK_SLOT_ID     : identifier of the slot (default: 0).
+ *   - HA_BENCH_MOCK_SERVICE_TIME: service time of the cryptographic
+ *                                 operations, in micro-seconds:
+ *                                   - constant:<duration>
+ *                                   - uniform:<minimum>:<maximum>
+ *                                   - exponential:<mean>
+ *                                   - normal:<mean>:<standard deviation>
+ *                                 (default: constant:0). Distributions
+ *                                 specific to some mechanisms can follow,
+ *                                 separated by ';', each one being
+ *                                 '<mechanism>=<distribution>' with the
+ *                                 mechanism given by its name (e.g.
+ *                                 CKM_MILENAGE) or its value, e.g.
+ *                                 'constant:50;CKM_TUAK=normal:900:60'.
+ *   - HA_BENCH_MOCK_MEMBERS     : number of HA members (default: 2).
+ *   - HA_BENCH_MOCK_DISPATCH    : dispatch policy of the operations to the
+ *                                 members, 'round-robin' or 'least-busy'
+ *                                 (i.e. fewest operations in flight or
+ *                                 queued) (default: round-robin).
+ *   - HA_BENCH_MOCK_CONCURRENCY : maximum number of operations being
+ *                                 served at the same time by each member,
+ *                                 the other ones being queued (default: 0,
+ *                                 i.e. no limit).
+ *   - HA_BENCH_MOCK_FAULTS      : faults to inject, separated by ';', each
+ *                                 one being '[<function>=]<effect>@<trigger>'
+ *                                 (default: none). The effects are:
+ *                                   - error:<code>: the call fails with the
+ *                                     code (a number, CKR_DEVICE_ERROR,
+ *                                     CKR_SESSION_HANDLE_INVALID,
+ *                                     CKR_TOKEN_NOT_PRESENT, or 'random'
+ *                                     for one of these three);
+ *                                   - spike:<duration>: the call lasts that
+ *                                     many more micro-seconds;
+ *                                   - stall:<duration>: all the operations
+ *                                     are frozen for that many
+ *                                     micro-seconds;
+ *                                   - member:<position>:<code>: the HA
+ *                                     member (from 1) is reported with the
+ *                                     code by CA_GetHAState();
+ *                                   - down:<position>: the HA member is
+ *                                     down (window trigger only): it is
+ *                                     not dispatched any operation, and
+ *                                     reported with CKR_TOKEN_NOT_PRESENT.
+ *                                 The triggers are:
+ *                                   - probability:<p>: each call, with the
+ *                                     probability p;
+ *                                   - every:<n>: each n-th call;
+ *                                   - window:<begin>:<end>: each call made
+ *                                     from 'begin' to 'end' seconds after
+ *                                     C_Initialize().
+ *                                 The function (e.g. C_Sign) limits an
+ *                                 error, spike or stall to the calls of
+ *                                 this function; otherwise they apply to
+ *                                 all the cryptographic operations. When
+ *                                 all the members are down, the
+ *                                 operations fail with
+ *                                 CKR_TOKEN_NOT_PRESENT.
+ *   - HA_BENCH_MOCK_SEED        : seed of the faults and of the service
+ *                                 times (default: random, printed when
+ *                                 faults are injected).
+ */
+#define P11MOCK_SLOT_ID_VARIABLE "HA_BENCH_MOCK_SLOT_ID"
+#define P11MOCK_SERVICE_TIME_VARIABLE "HA_BENCH_MOCK_SERVICE_TIME"
+#define P11MOCK_CONCURRENCY_VARIABLE "HA_BENCH_MOCK_CONCURRENCY"
+#define P11MOCK_MEMBERS_VARIABLE "HA_BENCH_MOCK_MEMBERS"
+#define P11MOCK_DISPATCH_VARIABLE "HA_BENCH_MOCK_DISPATCH"
+#define P11MOCK_FAULTS_VARIABLE "HA_BENCH_MOCK_FAULTS"
+#define P11MOCK_SEED_VARIABLE "HA_BENCH_MOCK_SEED"
+
+#define P11MOCK_MAXIMUM_FAULTS_COUNT 16
+#define P11MOCK_MAXIMUM_SERVICE_TIMES_COUNT 16
+
+#define P11MOCK_MAXIMUM_OBJECTS_COUNT 65536
+#define P11MOCK_MAXIMUM_SESSIONS_COUNT 16384
+
+#define P11MOCK_OUID_LENGTH 12
+#define P11MOCK_MAXIMUM_LABEL_LENGTH 256
+#define P11MOCK_MAXIMUM_VALUE_LENGTH 128
+
+#define P11MOCK_FIRMWARE_MAJOR_VERSION 7
+#define P11MOCK_FIRMWARE_MINOR_VERSION 8
+#define P11MOCK_FIRMWARE_SUBMINOR_VERSION 4
+
+#define P11MOCK_DEFAULT_HA_MEMBERS_COUNT 2
+#define P11MOCK_MAXIMUM_HA_MEMBERS_COUNT 32
+#define P11MOCK_NO_MEMBER ((unsigned long)-1)
+
+typedef enum _P11MOCK_CURVE
+{
+    P11MOCK_CURVE_NONE = 0,
+    P11MOCK_CURVE_P256,
+    P11MOCK_CURVE_X25519
+} P11MOCK_CURVE;
+
+// Object. The value is the secret key, the private scalar or the public
+// point (raw, without any DER header), depending on the class.
+typedef struct _P11MOCK_OBJECT
+{
+    CK_OBJECT_CLASS objectClass;
+    CK_KEY_TYPE keyType;
+    CK_BBOOL isTokenObject;
+    CK_SESSION_HANDLE ownerSessionHandle;
+    P11MOCK_CURVE curve;
+    CK_BYTE ouid[P11MOCK_OUID_LENGTH];
+    CK_BYTE label[P11MOCK_MAXIMUM_LABEL_LENGTH];
+    CK_ULONG labelLength;
+    CK_BYTE value[P11MOCK_MAXIMUM_VALUE_LENGTH];
+    CK_ULONG valueLength;
+} P11MOCK_OBJECT;
+
+typedef enum _P11MOCK_DISTRIBUTION
+{
+    P11MOCK_DISTRIBUTION_CONSTANT = 0,
+    P11MOCK_DISTRIBUTION_UNIFORM,
+    P11MOCK_DISTRIBUTION_EXPONENTIAL,
+    P11MOCK_DISTRIBUTION_NORMAL
+} P11MOCK_DISTRIBUTION;
+
+// Service time distribution of the operations of a mechanism; the first
+// one of the configuration (CK_UNAVAILABLE_INFORMATION) applies to the
+// other mechanisms.
+typedef struct _P11MOCK_SERVICE_TIME
+{
+    CK_MECHANISM_TYPE mechanismType;
+    P11MOCK_DISTRIBUTION distribution;
+    double parameters[2];
+} P11MOCK_SERVICE_TIME;
+
+// Functions going through the service (i.e. the cryptographic operations).
+typedef enum _P11MOCK_FUNCTION
+{
+    P11MOCK_FUNCTION_ANY = 0,
+    P11MOCK_FUNCTION_DECRYPT,
+    P11MOCK_FUNCTION_DIGEST,
+    P11MOCK_FUNCTION_ENCRYPT,
+    P11MOCK_FUNCTION_GENERATE_KEY,
+    P11MOCK_FUNCTION_GENERATE_KEY_PAIR,
+    P11MOCK_FUNCTION_SIGN,
+    P11MOCK_FUNCTION_UNWRAP_KEY
+} P11MOCK_FUNCTION;
+
+typedef enum _P11MOCK_DISPATCH
+{
+    P11MOCK_DISPATCH_ROUND_ROBIN = 0,
+    P11MOCK_DISPATCH_LEAST_BUSY
+} P11MOCK_DISPATCH;
+
+typedef enum _P11MOCK_FAULT_EFFECT
+{
+    P11MOCK_FAULT_EFFECT_ERROR = 0,
+    P11MOCK_FAULT_EFFECT_SPIKE,
+    P11MOCK_FAULT_EFFECT_STALL,
+    P11MOCK_FAULT_EFFECT_MEMBER_STATUS,
+    P11MOCK_FAULT_EFFECT_MEMBER_DOWN
+} P11MOCK_FAULT_EFFECT;
+
+typedef enum _P11MOCK_FAULT_TRIGGER
+{
+    P11MOCK_FAULT_TRIGGER_PROBABILITY = 0,
+    P11MOCK_FAULT_TRIGGER_PERIOD,
+    P11MOCK_FAULT_TRIGGER_WINDOW
+} P11MOCK_FAULT_TRIGGER;
+
+// Fault. The code is the error or the member status, CKR_OK standing for a
+// random error; the duration (spike or stall) is in micro-seconds; the
+// trigger parameters are the probability or the window bounds (seconds).
+typedef struct _P11MOCK_FAULT
+{
+    P11MOCK_FUNCTION function;
+    P11MOCK_FAULT_EFFECT effect;
+    CK_RV rv;
+    double duration;
+    unsigned long memberIndex;
+    P11MOCK_FAULT_TRIGGER trigger;
+    unsigned long period;
+    double triggerParameters[2];
+} P11MOCK_FAULT;
+
+// Service configuration.
+typedef struct _P11MOCK_CONFIGURATION
+{
+    CK_SLOT_ID slotId;
+    P11MOCK_SERVICE_TIME serviceTimes[P11MOCK_MAXIMUM_SERVICE_TIMES_COUNT];
+    unsigned long serviceTimesCount;
+    unsigned long concurrency;
+    unsigned long membersCount;
+    P11MOCK_DISPATCH dispatchPolicy;
+    bool isMembersReportEnabled;
+    uint64_t seed;
+    P11MOCK_FAULT faults[P11MOCK_MAXIMUM_FAULTS_COUNT];
+    unsigned long faultsCount;
+} P11MOCK_CONFIGURATION;
+
+extern P11MOCK_CONFIGURATION p11mockConfiguration;
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - The object functions are thread-safe; the object handles are the
+ *     object indexes plus one.
+ *   - 'p11mock_beginService' dispatches the operation to a member, and
+ *     blocks while the concurrency limit of the member is reached or the
+ *     operations are stalled; 'p11mock_endService' waits for the service
+ *     time to elapse before releasing the slot taken on the member, and
+ *     returns the error to inject, if any.
+ */
+
+// Objects.
+CK_RV p11mock_createObject(P11MOCK_OBJECT *const pObject,
+                           CK_OBJECT_HANDLE *const pObjectHandle);
+
+CK_RV p11mock_destroyObject(const CK_OBJECT_HANDLE objectHandle);
+
+void p11mock_destroyAllObjects(void);
+
+void p11mock_destroySessionObjects(const CK_SESSION_HANDLE sessionHandle);
+
+CK_RV p11mock_findObjects(const CK_ATTRIBUTE *const objectTemplate,
+                          const CK_ULONG objectTemplateSize,
+                          CK_OBJECT_HANDLE **const pObjectHandles,
+                          CK_ULONG *const pObjectHandlesCount);
+
+CK_RV p11mock_getAttributeValues(const CK_OBJECT_HANDLE objectHandle,
+                                 CK_ATTRIBUTE *const objectTemplate,
+                                 const CK_ULONG objectTemplateSize);
+
+CK_RV p11mock_getObject(const CK_OBJECT_HANDLE objectHandle,
+                        P11MOCK_OBJECT *const pObject);
+
+CK_RV p11mock_parseTemplate(const CK_ATTRIBUTE *const objectTemplate,
+                            const CK_ULONG objectTemplateSize,
+                            P11MOCK_OBJECT *const pObject,
+                            CK_ULONG *const pValueLength);
+
+// Faults.
+void p11mock_drawHaStateFaults(CK_RV *const memberStatuses);
+
+// Returns the error to inject (CKR_OK if none), and the spike and stall
+// durations (0 if none).
+CK_RV p11mock_drawServiceFaults(const P11MOCK_FUNCTION function,
+                                double *const pSpikeTime,
+                                double *const pStallTime);
+
+bool p11mock_isMemberDown(const unsigned long memberIndex);
+
+CK_RV p11mock_parseFaults(const char *const value);
+
+// Restarts the calls counts and the time windows.
+void p11mock_resetFaults(void);
+
+// Service.
+void p11mock_beginService(const P11MOCK_FUNCTION function,
+                          const CK_MECHANISM_TYPE mechanismType);
+
+CK_RV p11mock_endService(void);
+
+void p11mock_generateRandom(unsigned char *const output,
+                            const size_t length);
+
+CK_RV p11mock_loadConfiguration(void);
+
+CK_RV p11mock_parseUnsignedLong(const char *const value,
+                                unsigned long *const pResult);
+
+// Prints the operations served by each member, if HA_BENCH_MOCK_MEMBERS is
+// set.
+void p11mock_writeMembersReport(void);
+
+#endif /* __P11_MOCK_H__ */
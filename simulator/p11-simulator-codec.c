@@ -0,0 +1,592 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "p11-simulator.h"
+
+/*
+ * Notes:
+ *   - The message header is written in front of the payload of the buffer,
+ *     so that a message is sent with a single system call.
+ *   - The mechanism parameters holding pointers are encoded as the
+ *     structure itself, followed by the pointed byte strings; the decoder
+ *     makes the pointers refer to the decoded byte strings.
+ */
+#define P11SIM_HEADER_LENGTH 8
+#define P11SIM_MINIMUM_BUFFER_CAPACITY 4096
+
+// Mechanism parameters holding pointers to byte strings, along with the
+// lengths of these byte strings.
+typedef struct _P11SIM_MECHANISM_PARAMETER
+{
+    CK_MECHANISM_TYPE mechanismType;
+    size_t parameterLength;
+    size_t pointersCount;
+    size_t pointerOffsets[2];
+    size_t lengthOffsets[2];
+} P11SIM_MECHANISM_PARAMETER;
+
+static const P11SIM_MECHANISM_PARAMETER P11SIM_MECHANISM_PARAMETERS[] = {
+    {CKM_ECIES,
+     sizeof(CK_ECIES_PARAMS),
+     2,
+     {offsetof(CK_ECIES_PARAMS, pSharedData1), offsetof(CK_ECIES_PARAMS, pSharedData2)},
+     {offsetof(CK_ECIES_PARAMS, ulSharedDataLen1), offsetof(CK_ECIES_PARAMS, ulSharedDataLen2)}},
+    {CKM_MILENAGE,
+     sizeof(CK_MILENAGE_SIGN_PARAMS),
+     2,
+     {offsetof(CK_MILENAGE_SIGN_PARAMS, pEncKi), offsetof(CK_MILENAGE_SIGN_PARAMS, pEncOPc)},
+     {offsetof(CK_MILENAGE_SIGN_PARAMS, ulEncKiLen), offsetof(CK_MILENAGE_SIGN_PARAMS, ulEncOPcLen)}},
+    {CKM_MILENAGE_RESYNC,
+     sizeof(CK_MILENAGE_SIGN_PARAMS),
+     2,
+     {offsetof(CK_MILENAGE_SIGN_PARAMS, pEncKi), offsetof(CK_MILENAGE_SIGN_PARAMS, pEncOPc)},
+     {offsetof(CK_MILENAGE_SIGN_PARAMS, ulEncKiLen), offsetof(CK_MILENAGE_SIGN_PARAMS, ulEncOPcLen)}},
+    {CKM_TUAK,
+     sizeof(CK_TUAK_SIGN_PARAMS),
+     2,
+     {offsetof(CK_TUAK_SIGN_PARAMS, pEncKi), offsetof(CK_TUAK_SIGN_PARAMS, pEncTOPc)},
+     {offsetof(CK_TUAK_SIGN_PARAMS, ulEncKiLen), offsetof(CK_TUAK_SIGN_PARAMS, ulEncTOPcLen)}},
+    {CKM_TUAK_RESYNC,
+     sizeof(CK_TUAK_SIGN_PARAMS),
+     2,
+     {offsetof(CK_TUAK_SIGN_PARAMS, pEncKi), offsetof(CK_TUAK_SIGN_PARAMS, pEncTOPc)},
+     {offsetof(CK_TUAK_SIGN_PARAMS, ulEncKiLen), offsetof(CK_TUAK_SIGN_PARAMS, ulEncTOPcLen)}},
+    {CKM_COMP128,
+     sizeof(CK_COMP128_SIGN_PARAMS),
+     1,
+     {offsetof(CK_COMP128_SIGN_PARAMS, pEncKi), 0},
+     {offsetof(CK_COMP128_SIGN_PARAMS, ulEncKiLen), 0}}};
+
+static const P11SIM_MECHANISM_PARAMETER *p11sim_findMechanismParameter(const CK_MECHANISM_TYPE mechanismType,
+                                                                       const CK_ULONG parameterLength)
+{
+    for (size_t index = 0;
+         index < (sizeof(P11SIM_MECHANISM_PARAMETERS) / sizeof(P11SIM_MECHANISM_PARAMETERS[0]));
+         index++)
+    {
+        if ((P11SIM_MECHANISM_PARAMETERS[index].mechanismType == mechanismType) &&
+            (P11SIM_MECHANISM_PARAMETERS[index].parameterLength == parameterLength))
+        {
+            return &P11SIM_MECHANISM_PARAMETERS[index];
+        }
+    }
+
+    return NULL;
+}
+
+static void p11sim_reserve(P11SIM_BUFFER *const pBuffer,
+                           const size_t length)
+{
+    assert(pBuffer != NULL);
+
+    if (!pBuffer->isValid)
+    {
+        return;
+    }
+
+    if (length > (P11SIM_HEADER_LENGTH + P11SIM_MAXIMUM_PAYLOAD_LENGTH))
+    {
+        pBuffer->isValid = false;
+
+        return;
+    }
+
+    if (length <= pBuffer->capacity)
+    {
+        return;
+    }
+
+    size_t capacity = (pBuffer->capacity == 0) ? P11SIM_MINIMUM_BUFFER_CAPACITY : pBuffer->capacity;
+
+    while (capacity < length)
+    {
+        capacity *= 2;
+    }
+
+    unsigned char *const data = (unsigned char *)realloc(pBuffer->data,
+                                                         capacity);
+
+    if (data == NULL)
+    {
+        pBuffer->isValid = false;
+
+        return;
+    }
+
+    pBuffer->data = data;
+    pBuffer->capacity = capacity;
+}
+
+static void p11sim_put(P11SIM_BUFFER *const pBuffer,
+                       const void *const bytes,
+                       const size_t length)
+{
+    assert(pBuffer != NULL);
+    assert((bytes != NULL) || (length == 0));
+
+    p11sim_reserve(pBuffer,
+                   pBuffer->length + length);
+
+    if ((!pBuffer->isValid) || (length == 0))
+    {
+        return;
+    }
+
+    memcpy(&pBuffer->data[pBuffer->length],
+           bytes,
+           length);
+
+    pBuffer->length += length;
+}
+
+static const void *p11sim_get(P11SIM_BUFFER *const pBuffer,
+                              const size_t length)
+{
+    assert(pBuffer != NULL);
+
+    if ((!pBuffer->isValid) ||
+        (length > (pBuffer->length - pBuffer->offset)))
+    {
+        pBuffer->isValid = false;
+
+        return NULL;
+    }
+
+    const void *const bytes = &pBuffer->data[pBuffer->offset];
+
+    pBuffer->offset += length;
+
+    return bytes;
+}
+
+// The values are not aligned in the payload.
+static uint64_t p11sim_getUint64(P11SIM_BUFFER *const pBuffer)
+{
+    uint64_t value = 0;
+    const void *const bytes = p11sim_get(pBuffer,
+                                         sizeof(value));
+
+    if (bytes != NULL)
+    {
+        memcpy(&value,
+               bytes,
+               sizeof(value));
+    }
+
+    return value;
+}
+
+static bool p11sim_transfer(const int socketDescriptor,
+                            unsigned char *const data,
+                            const size_t length,
+                            const bool isSending)
+{
+    size_t offset = 0;
+
+    while (offset < length)
+    {
+        const ssize_t result = isSending ? send(socketDescriptor,
+                                                &data[offset],
+                                                length - offset,
+                                                MSG_NOSIGNAL)
+                                         : recv(socketDescriptor,
+                                                &data[offset],
+                                                length - offset,
+                                                0);
+
+        if (result > 0)
+        {
+            offset += (size_t)result;
+        }
+        else if ((result == 0) || (errno != EINTR))
+        {
+            // Connection closed or broken.
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void p11sim_freeBuffer(P11SIM_BUFFER *const pBuffer)
+{
+    assert(pBuffer != NULL);
+
+    free(pBuffer->data);
+
+    memset(pBuffer,
+           0,
+           sizeof(*pBuffer));
+}
+
+void p11sim_freeMechanism(CK_MECHANISM *const pMechanism)
+{
+    free(pMechanism);
+}
+
+void p11sim_freeTemplate(CK_ATTRIBUTE *const objectTemplate)
+{
+    free(objectTemplate);
+}
+
+const void *p11sim_getBytes(P11SIM_BUFFER *const pBuffer,
+                            CK_ULONG *const pLength)
+{
+    assert(pBuffer != NULL);
+    assert(pLength != NULL);
+
+    const uint64_t encodedLength = p11sim_getUint64(pBuffer);
+
+    *pLength = 0;
+
+    if ((!pBuffer->isValid) ||
+        (encodedLength == P11SIM_NULL_LENGTH))
+    {
+        return NULL;
+    }
+
+    const void *const bytes = p11sim_get(pBuffer,
+                                         (size_t)encodedLength);
+
+    if (bytes != NULL)
+    {
+        *pLength = (CK_ULONG)encodedLength;
+    }
+
+    return bytes;
+}
+
+CK_MECHANISM *p11sim_getMechanism(P11SIM_BUFFER *const pBuffer)
+{
+    assert(pBuffer != NULL);
+
+    const CK_MECHANISM_TYPE mechanismType = p11sim_getUlong(pBuffer);
+    CK_ULONG parameterLength = 0;
+    const void *const parameter = p11sim_getBytes(pBuffer,
+                                                  &parameterLength);
+
+    if (!pBuffer->isValid)
+    {
+        return NULL;
+    }
+
+    // The parameter is copied after the mechanism, suitably aligned.
+    const size_t parameterOffset = (sizeof(CK_MECHANISM) + 15) & ~(size_t)15;
+    CK_MECHANISM *const pMechanism = (CK_MECHANISM *)calloc(1,
+                                                            parameterOffset + parameterLength);
+
+    if (pMechanism == NULL)
+    {
+        pBuffer->isValid = false;
+
+        return NULL;
+    }
+
+    pMechanism->mechanism = mechanismType;
+
+    if (parameter != NULL)
+    {
+        pMechanism->pParameter = (unsigned char *)pMechanism + parameterOffset;
+        pMechanism->ulParameterLen = parameterLength;
+
+        memcpy(pMechanism->pParameter,
+               parameter,
+               parameterLength);
+
+        const P11SIM_MECHANISM_PARAMETER *const pDescriptor = p11sim_findMechanismParameter(mechanismType,
+                                                                                            parameterLength);
+
+        for (size_t pointerIndex = 0; (pDescriptor != NULL) && (pointerIndex < pDescriptor->pointersCount); pointerIndex++)
+        {
+            CK_ULONG length = 0;
+            const void *const bytes = p11sim_getBytes(pBuffer,
+                                                      &length);
+
+            memcpy((unsigned char *)pMechanism->pParameter + pDescriptor->pointerOffsets[pointerIndex],
+                   &bytes,
+                   sizeof(bytes));
+            memcpy((unsigned char *)pMechanism->pParameter + pDescriptor->lengthOffsets[pointerIndex],
+                   &length,
+                   sizeof(length));
+        }
+    }
+
+    if (!pBuffer->isValid)
+    {
+        free(pMechanism);
+
+        return NULL;
+    }
+
+    return pMechanism;
+}
+
+CK_ATTRIBUTE *p11sim_getTemplate(P11SIM_BUFFER *const pBuffer,
+                                 CK_ULONG *const pObjectTemplateSize)
+{
+    assert(pBuffer != NULL);
+    assert(pObjectTemplateSize != NULL);
+
+    const CK_ULONG objectTemplateSize = p11sim_getUlong(pBuffer);
+    const size_t templateOffset = pBuffer->offset;
+
+    *pObjectTemplateSize = 0;
+
+    if ((!pBuffer->isValid) ||
+        (objectTemplateSize > P11SIM_MAXIMUM_TEMPLATE_SIZE))
+    {
+        pBuffer->isValid = false;
+
+        return NULL;
+    }
+
+    // The values are copied after the attributes, each one being aligned
+    // (e.g. for the CK_ULONG values): the lengths are collected first. One
+    // more attribute is allocated, so that an empty template is not NULL.
+    size_t valuesOffset = (objectTemplateSize + 1) * sizeof(CK_ATTRIBUTE);
+    size_t valuesLength = 0;
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        CK_ULONG valueLength = 0;
+
+        p11sim_getUlong(pBuffer);
+        p11sim_getBytes(pBuffer,
+                        &valueLength);
+
+        valuesLength += (valueLength + 15) & ~(size_t)15;
+    }
+
+    if (!pBuffer->isValid)
+    {
+        return NULL;
+    }
+
+    CK_ATTRIBUTE *const objectTemplate = (CK_ATTRIBUTE *)calloc(1,
+                                                                valuesOffset + valuesLength);
+
+    if (objectTemplate == NULL)
+    {
+        pBuffer->isValid = false;
+
+        return NULL;
+    }
+
+    pBuffer->offset = templateOffset;
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        CK_ATTRIBUTE *const pAttribute = &objectTemplate[attributeIndex];
+
+        pAttribute->type = p11sim_getUlong(pBuffer);
+
+        const void *const value = p11sim_getBytes(pBuffer,
+                                                  &pAttribute->usValueLen);
+
+        if (value != NULL)
+        {
+            pAttribute->pValue = (unsigned char *)objectTemplate + valuesOffset;
+
+            memcpy(pAttribute->pValue,
+                   value,
+                   pAttribute->usValueLen);
+
+            valuesOffset += (pAttribute->usValueLen + 15) & ~(size_t)15;
+        }
+    }
+
+    *pObjectTemplateSize = objectTemplateSize;
+
+    return objectTemplate;
+}
+
+CK_ULONG p11sim_getUlong(P11SIM_BUFFER *const pBuffer)
+{
+    assert(pBuffer != NULL);
+
+    return (CK_ULONG)p11sim_getUint64(pBuffer);
+}
+
+void p11sim_putBytes(P11SIM_BUFFER *const pBuffer,
+                     const void *const bytes,
+                     const CK_ULONG length)
+{
+    assert(pBuffer != NULL);
+
+    const uint64_t encodedLength = (bytes != NULL) ? (uint64_t)length : P11SIM_NULL_LENGTH;
+
+    p11sim_put(pBuffer,
+               &encodedLength,
+               sizeof(encodedLength));
+
+    if (bytes != NULL)
+    {
+        p11sim_put(pBuffer,
+                   bytes,
+                   length);
+    }
+}
+
+void p11sim_putMechanism(P11SIM_BUFFER *const pBuffer,
+                         const CK_MECHANISM *const pMechanism)
+{
+    assert(pBuffer != NULL);
+    assert(pMechanism != NULL);
+
+    p11sim_putUlong(pBuffer,
+                    pMechanism->mechanism);
+    p11sim_putBytes(pBuffer,
+                    pMechanism->pParameter,
+                    pMechanism->ulParameterLen);
+
+    if (pMechanism->pParameter == NULL)
+    {
+        return;
+    }
+
+    const P11SIM_MECHANISM_PARAMETER *const pDescriptor = p11sim_findMechanismParameter(pMechanism->mechanism,
+                                                                                        pMechanism->ulParameterLen);
+
+    for (size_t pointerIndex = 0; (pDescriptor != NULL) && (pointerIndex < pDescriptor->pointersCount); pointerIndex++)
+    {
+        const void *bytes = NULL;
+        CK_ULONG length = 0;
+
+        memcpy(&bytes,
+               (const unsigned char *)pMechanism->pParameter + pDescriptor->pointerOffsets[pointerIndex],
+               sizeof(bytes));
+        memcpy(&length,
+               (const unsigned char *)pMechanism->pParameter + pDescriptor->lengthOffsets[pointerIndex],
+               sizeof(length));
+
+        p11sim_putBytes(pBuffer,
+                        bytes,
+                        length);
+    }
+}
+
+void p11sim_putTemplate(P11SIM_BUFFER *const pBuffer,
+                        const CK_ATTRIBUTE *const objectTemplate,
+                        const CK_ULONG objectTemplateSize)
+{
+    assert(pBuffer != NULL);
+    assert((objectTemplate != NULL) || (objectTemplateSize == 0));
+
+    if (objectTemplateSize > P11SIM_MAXIMUM_TEMPLATE_SIZE)
+    {
+        pBuffer->isValid = false;
+
+        return;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    objectTemplateSize);
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < objectTemplateSize; attributeIndex++)
+    {
+        p11sim_putUlong(pBuffer,
+                        objectTemplate[attributeIndex].type);
+        p11sim_putBytes(pBuffer,
+                        objectTemplate[attributeIndex].pValue,
+                        objectTemplate[attributeIndex].usValueLen);
+    }
+}
+
+void p11sim_putUlong(P11SIM_BUFFER *const pBuffer,
+                     const CK_ULONG value)
+{
+    assert(pBuffer != NULL);
+
+    const uint64_t encodedValue = (uint64_t)value;
+
+    p11sim_put(pBuffer,
+               &encodedValue,
+               sizeof(encodedValue));
+}
+
+bool p11sim_receiveMessage(const int socketDescriptor,
+                           uint32_t *const pCode,
+                           P11SIM_BUFFER *const pBuffer)
+{
+    assert(pCode != NULL);
+    assert(pBuffer != NULL);
+
+    uint32_t header[2];
+
+    p11sim_resetBuffer(pBuffer);
+
+    if (!p11sim_transfer(socketDescriptor,
+                         (unsigned char *)header,
+                         sizeof(header),
+                         false))
+    {
+        return false;
+    }
+
+    p11sim_reserve(pBuffer,
+                   P11SIM_HEADER_LENGTH + header[0]);
+
+    if ((!pBuffer->isValid) ||
+        (!p11sim_transfer(socketDescriptor,
+                          &pBuffer->data[P11SIM_HEADER_LENGTH],
+                          header[0],
+                          false)))
+    {
+        return false;
+    }
+
+    pBuffer->length = P11SIM_HEADER_LENGTH + header[0];
+    *pCode = header[1];
+
+    return true;
+}
+
+void p11sim_resetBuffer(P11SIM_BUFFER *const pBuffer)
+{
+    assert(pBuffer != NULL);
+
+    pBuffer->isValid = true;
+
+    p11sim_reserve(pBuffer,
+                   P11SIM_HEADER_LENGTH);
+
+    pBuffer->length = P11SIM_HEADER_LENGTH;
+    pBuffer->offset = P11SIM_HEADER_LENGTH;
+}
+
+bool p11sim_sendMessage(const int socketDescriptor,
+                        const uint32_t code,
+                        P11SIM_BUFFER *const pBuffer)
+{
+    assert(pBuffer != NULL);
+
+    if ((!pBuffer->isValid) ||
+        (pBuffer->length < P11SIM_HEADER_LENGTH))
+    {
+        return false;
+    }
+
+    const uint32_t header[2] = {(uint32_t)(pBuffer->length - P11SIM_HEADER_LENGTH), code};
+
+    memcpy(pBuffer->data,
+           header,
+           sizeof(header));
+
+    return p11sim_transfer(socketDescriptor,
+                           pBuffer->data,
+                           pBuffer->length,
+                           true);
+}
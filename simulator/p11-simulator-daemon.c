@@ -0,0 +1,1128 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "p11-mock.h"
+#include "p11-simulator.h"
+
+/*
+ * Notes:
+ *   - The daemon embeds the mock (see 'mock/p11-mock.h'), initialized once
+ *     for all the clients: its environment variables are the ones of the
+ *     daemon.
+ *   - Each connection is served by its own thread. The round trip delay
+ *     ('--round-trip') is added before each response.
+ *   - The sessions and the login state are tracked per client process: the
+ *     C_Finalize() of a process closes its sessions only, and the mock is
+ *     logged out when no process is logged in anymore.
+ */
+#define P11SIM_MAXIMUM_PROCESSES_COUNT 1024
+
+typedef CK_RV (*P11SIM_OUTPUT_FUNCTION)(CK_SESSION_HANDLE,
+                                        CK_BYTE_PTR,
+                                        CK_ULONG,
+                                        CK_BYTE_PTR,
+                                        CK_ULONG_PTR);
+
+typedef CK_RV (*P11SIM_MECHANISM_FUNCTION)(CK_SESSION_HANDLE,
+                                           CK_MECHANISM_PTR,
+                                           CK_OBJECT_HANDLE);
+
+static pthread_mutex_t p11simMutex = PTHREAD_MUTEX_INITIALIZER;
+static CK_ULONG p11simSessionOwners[P11MOCK_MAXIMUM_SESSIONS_COUNT + 1];
+static CK_ULONG p11simLoggedInProcesses[P11SIM_MAXIMUM_PROCESSES_COUNT];
+static size_t p11simLoggedInProcessesCount = 0;
+static unsigned long p11simRoundTrip = 0;
+
+static void p11sim_writeUsage(const char *const name)
+{
+    fprintf(stdout,
+            "%s [<option>]*\n\
+\n\
+Options:\n\
+  --port <port>         : TCP port to listen to on 127.0.0.1 (default: %d, or\n\
+                          the %s environment variable).\n\
+  --round-trip <micros> : network round trip time added to each PKCS#11\n\
+                          call, in micro-seconds (default: 0).\n\
+\n\
+The emulated appliance is configured through the environment variables of\n\
+the mock (e.g. HA_BENCH_MOCK_SERVICE_TIME), the provider library of the\n\
+clients being 'libCryptoki2_64.so' built with the simulator.\n",
+            name,
+            P11SIM_DEFAULT_PORT,
+            P11SIM_PORT_VARIABLE);
+}
+
+static bool p11sim_parsePort(const char *const value,
+                             unsigned long *const pPort)
+{
+    char *pEnd = NULL;
+
+    *pPort = strtoul(value, &pEnd, 10);
+
+    return (pEnd != value) && (*pEnd == '\0') && (*pPort != 0) && (*pPort <= 65535);
+}
+
+static bool p11sim_isSessionOwnedBy(const CK_SESSION_HANDLE sessionHandle,
+                                    const CK_ULONG processId)
+{
+    return (sessionHandle <= P11MOCK_MAXIMUM_SESSIONS_COUNT) &&
+           (p11simSessionOwners[sessionHandle] == processId);
+}
+
+static void p11sim_closeProcessSessions(const CK_ULONG processId)
+{
+    pthread_mutex_lock(&p11simMutex);
+
+    for (CK_SESSION_HANDLE sessionHandle = 1; sessionHandle <= P11MOCK_MAXIMUM_SESSIONS_COUNT; sessionHandle++)
+    {
+        if (p11sim_isSessionOwnedBy(sessionHandle,
+                                    processId))
+        {
+            p11simSessionOwners[sessionHandle] = 0;
+
+            C_CloseSession(sessionHandle);
+        }
+    }
+
+    pthread_mutex_unlock(&p11simMutex);
+}
+
+// Returns the process owning the session (0 if none).
+static CK_ULONG p11sim_getSessionOwner(const CK_SESSION_HANDLE sessionHandle)
+{
+    CK_ULONG processId = 0;
+
+    pthread_mutex_lock(&p11simMutex);
+
+    if (sessionHandle <= P11MOCK_MAXIMUM_SESSIONS_COUNT)
+    {
+        processId = p11simSessionOwners[sessionHandle];
+    }
+
+    pthread_mutex_unlock(&p11simMutex);
+
+    return processId;
+}
+
+// Updates the login state of a process, and returns the number of processes
+// still logged in.
+static size_t p11sim_setLoggedIn(const CK_ULONG processId,
+                                 const bool isLoggedIn)
+{
+    size_t processIndex = 0;
+
+    pthread_mutex_lock(&p11simMutex);
+
+    while ((processIndex < p11simLoggedInProcessesCount) &&
+           (p11simLoggedInProcesses[processIndex] != processId))
+    {
+        processIndex++;
+    }
+
+    if (isLoggedIn &&
+        (processIndex == p11simLoggedInProcessesCount) &&
+        (p11simLoggedInProcessesCount < P11SIM_MAXIMUM_PROCESSES_COUNT))
+    {
+        p11simLoggedInProcesses[p11simLoggedInProcessesCount++] = processId;
+    }
+    else if ((!isLoggedIn) &&
+             (processIndex < p11simLoggedInProcessesCount))
+    {
+        p11simLoggedInProcesses[processIndex] = p11simLoggedInProcesses[--p11simLoggedInProcessesCount];
+    }
+
+    const size_t loggedInProcessesCount = p11simLoggedInProcessesCount;
+
+    pthread_mutex_unlock(&p11simMutex);
+
+    return loggedInProcessesCount;
+}
+
+// Output buffer of a request: NULL when the client only asks for the length.
+static void *p11sim_getOutput(P11SIM_BUFFER *const pRequest,
+                              CK_ULONG *const pOutputLength)
+{
+    *pOutputLength = p11sim_getUlong(pRequest);
+
+    if ((!pRequest->isValid) ||
+        (*pOutputLength == (CK_ULONG)P11SIM_NULL_LENGTH))
+    {
+        *pOutputLength = 0;
+
+        return NULL;
+    }
+
+    if (*pOutputLength > P11SIM_MAXIMUM_PAYLOAD_LENGTH)
+    {
+        pRequest->isValid = false;
+
+        return NULL;
+    }
+
+    // Zeroed, so that no stale data is returned when the provider keeps the
+    // length unchanged on error.
+    void *const output = calloc(1,
+                                (*pOutputLength != 0) ? *pOutputLength : 1);
+
+    if (output == NULL)
+    {
+        pRequest->isValid = false;
+    }
+
+    return output;
+}
+
+static void p11sim_putOutput(P11SIM_BUFFER *const pResponse,
+                             const void *const output,
+                             const CK_ULONG outputCapacity,
+                             const CK_ULONG outputLength)
+{
+    p11sim_putUlong(pResponse,
+                    outputLength);
+    p11sim_putBytes(pResponse,
+                    ((output != NULL) && (outputLength <= outputCapacity)) ? output : NULL,
+                    outputLength);
+}
+
+static CK_RV p11sim_serveWithOutput(const P11SIM_OUTPUT_FUNCTION function,
+                                    P11SIM_BUFFER *const pRequest,
+                                    P11SIM_BUFFER *const pResponse)
+{
+    const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+    CK_ULONG inputLength = 0;
+    const void *const input = p11sim_getBytes(pRequest,
+                                              &inputLength);
+    CK_ULONG outputCapacity = 0;
+    void *const output = p11sim_getOutput(pRequest,
+                                          &outputCapacity);
+
+    if (!pRequest->isValid)
+    {
+        free(output);
+
+        return CKR_DEVICE_ERROR;
+    }
+
+    CK_ULONG outputLength = outputCapacity;
+    const CK_RV rv = function(sessionHandle,
+                              (CK_BYTE_PTR)input,
+                              inputLength,
+                              (CK_BYTE_PTR)output,
+                              &outputLength);
+
+    p11sim_putOutput(pResponse,
+                     output,
+                     outputCapacity,
+                     outputLength);
+
+    free(output);
+
+    return rv;
+}
+
+static CK_RV p11sim_serveWithMechanism(const P11SIM_MECHANISM_FUNCTION function,
+                                       P11SIM_BUFFER *const pRequest)
+{
+    const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+    CK_MECHANISM *const pMechanism = p11sim_getMechanism(pRequest);
+    const CK_OBJECT_HANDLE keyHandle = p11sim_getUlong(pRequest);
+    CK_RV rv = CKR_DEVICE_ERROR;
+
+    if (pRequest->isValid)
+    {
+        rv = function(sessionHandle,
+                      pMechanism,
+                      keyHandle);
+    }
+
+    p11sim_freeMechanism(pMechanism);
+
+    return rv;
+}
+
+static CK_RV p11sim_serveWithStructure(const P11SIM_FUNCTION function,
+                                       P11SIM_BUFFER *const pRequest,
+                                       P11SIM_BUFFER *const pResponse)
+{
+    const CK_SLOT_ID slotId = p11sim_getUlong(pRequest);
+    CK_RV rv = CKR_OK;
+
+    if (!pRequest->isValid)
+    {
+        return CKR_DEVICE_ERROR;
+    }
+
+    switch (function)
+    {
+    case P11SIM_FUNCTION_C_GET_INFO:
+    {
+        CK_INFO info;
+
+        rv = C_GetInfo(&info);
+
+        p11sim_putBytes(pResponse,
+                        &info,
+                        sizeof(info));
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_GET_SLOT_INFO:
+    {
+        CK_SLOT_INFO slotInfo;
+
+        rv = C_GetSlotInfo(slotId,
+                           &slotInfo);
+
+        p11sim_putBytes(pResponse,
+                        &slotInfo,
+                        sizeof(slotInfo));
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_GET_TOKEN_INFO:
+    {
+        CK_TOKEN_INFO tokenInfo;
+
+        rv = C_GetTokenInfo(slotId,
+                            &tokenInfo);
+
+        p11sim_putBytes(pResponse,
+                        &tokenInfo,
+                        sizeof(tokenInfo));
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_CA_GET_HA_STATE:
+    {
+        CK_HA_STATUS haStatus;
+
+        rv = CA_GetHAState(slotId,
+                           &haStatus);
+
+        p11sim_putBytes(pResponse,
+                        &haStatus,
+                        sizeof(haStatus));
+
+        break;
+    }
+
+    default:
+        rv = CKR_FUNCTION_NOT_SUPPORTED;
+    }
+
+    return rv;
+}
+
+static CK_RV p11sim_serveGetAttributeValue(P11SIM_BUFFER *const pRequest,
+                                           P11SIM_BUFFER *const pResponse)
+{
+    const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+    const CK_OBJECT_HANDLE objectHandle = p11sim_getUlong(pRequest);
+    const CK_ULONG objectTemplateSize = p11sim_getUlong(pRequest);
+    CK_ATTRIBUTE objectTemplate[P11SIM_MAXIMUM_TEMPLATE_SIZE];
+    CK_ULONG valueCapacities[P11SIM_MAXIMUM_TEMPLATE_SIZE];
+    CK_ULONG attributeIndex = 0;
+    CK_RV rv = CKR_DEVICE_ERROR;
+
+    if (objectTemplateSize > P11SIM_MAXIMUM_TEMPLATE_SIZE)
+    {
+        pRequest->isValid = false;
+    }
+
+    for (attributeIndex = 0; pRequest->isValid && (attributeIndex < objectTemplateSize); attributeIndex++)
+    {
+        objectTemplate[attributeIndex].type = p11sim_getUlong(pRequest);
+        objectTemplate[attributeIndex].pValue = p11sim_getOutput(pRequest,
+                                                                 &valueCapacities[attributeIndex]);
+        objectTemplate[attributeIndex].usValueLen = valueCapacities[attributeIndex];
+    }
+
+    if (pRequest->isValid)
+    {
+        rv = C_GetAttributeValue(sessionHandle,
+                                 objectHandle,
+                                 objectTemplate,
+                                 objectTemplateSize);
+
+        for (CK_ULONG outputIndex = 0; outputIndex < objectTemplateSize; outputIndex++)
+        {
+            p11sim_putOutput(pResponse,
+                             objectTemplate[outputIndex].pValue,
+                             valueCapacities[outputIndex],
+                             objectTemplate[outputIndex].usValueLen);
+        }
+    }
+
+    // Only the values decoded so far are allocated.
+    for (CK_ULONG outputIndex = 0; outputIndex < attributeIndex; outputIndex++)
+    {
+        free(objectTemplate[outputIndex].pValue);
+    }
+
+    return rv;
+}
+
+static CK_RV p11sim_serveRequest(const P11SIM_FUNCTION function,
+                                 P11SIM_BUFFER *const pRequest,
+                                 P11SIM_BUFFER *const pResponse)
+{
+    CK_RV rv = CKR_DEVICE_ERROR;
+    CK_MECHANISM *pMechanism = NULL;
+    CK_ATTRIBUTE *objectTemplates[2] = {NULL, NULL};
+    CK_ULONG objectTemplateSizes[2] = {0, 0};
+
+    switch (function)
+    {
+    case P11SIM_FUNCTION_C_CLOSE_SESSION:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_CloseSession(sessionHandle);
+
+        if (rv == CKR_OK)
+        {
+            pthread_mutex_lock(&p11simMutex);
+
+            p11simSessionOwners[sessionHandle] = 0;
+
+            pthread_mutex_unlock(&p11simMutex);
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_CREATE_OBJECT:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        CK_OBJECT_HANDLE objectHandle = CK_INVALID_HANDLE;
+
+        objectTemplates[0] = p11sim_getTemplate(pRequest,
+                                                &objectTemplateSizes[0]);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_CreateObject(sessionHandle,
+                            objectTemplates[0],
+                            objectTemplateSizes[0],
+                            &objectHandle);
+
+        p11sim_putUlong(pResponse,
+                        objectHandle);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_DECRYPT:
+        rv = p11sim_serveWithOutput(C_Decrypt,
+                                    pRequest,
+                                    pResponse);
+
+        break;
+
+    case P11SIM_FUNCTION_C_DECRYPT_INIT:
+        rv = p11sim_serveWithMechanism(C_DecryptInit,
+                                       pRequest);
+
+        break;
+
+    case P11SIM_FUNCTION_C_DESTROY_OBJECT:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        const CK_OBJECT_HANDLE objectHandle = p11sim_getUlong(pRequest);
+
+        if (pRequest->isValid)
+        {
+            rv = C_DestroyObject(sessionHandle,
+                                 objectHandle);
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_DIGEST:
+        rv = p11sim_serveWithOutput(C_Digest,
+                                    pRequest,
+                                    pResponse);
+
+        break;
+
+    case P11SIM_FUNCTION_C_DIGEST_INIT:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+
+        pMechanism = p11sim_getMechanism(pRequest);
+
+        // The key handle is not used.
+        p11sim_getUlong(pRequest);
+
+        if (pRequest->isValid)
+        {
+            rv = C_DigestInit(sessionHandle,
+                              pMechanism);
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_ENCRYPT:
+        rv = p11sim_serveWithOutput(C_Encrypt,
+                                    pRequest,
+                                    pResponse);
+
+        break;
+
+    case P11SIM_FUNCTION_C_ENCRYPT_INIT:
+        rv = p11sim_serveWithMechanism(C_EncryptInit,
+                                       pRequest);
+
+        break;
+
+    case P11SIM_FUNCTION_C_FINALIZE:
+    {
+        const CK_ULONG processId = p11sim_getUlong(pRequest);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        // The mock itself remains initialized for the other clients.
+        p11sim_setLoggedIn(processId,
+                           false);
+        p11sim_closeProcessSessions(processId);
+
+        rv = CKR_OK;
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_FIND_OBJECTS:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        const CK_ULONG maximumObjectsCount = p11sim_getUlong(pRequest);
+
+        if ((!pRequest->isValid) ||
+            (maximumObjectsCount > (P11SIM_MAXIMUM_PAYLOAD_LENGTH / sizeof(CK_OBJECT_HANDLE))))
+        {
+            pRequest->isValid = false;
+
+            break;
+        }
+
+        CK_OBJECT_HANDLE *const objectHandles = (CK_OBJECT_HANDLE *)calloc(maximumObjectsCount + 1,
+                                                                           sizeof(CK_OBJECT_HANDLE));
+        CK_ULONG objectsCount = 0;
+
+        if (objectHandles == NULL)
+        {
+            rv = CKR_HOST_MEMORY;
+
+            break;
+        }
+
+        rv = C_FindObjects(sessionHandle,
+                           objectHandles,
+                           maximumObjectsCount,
+                           &objectsCount);
+
+        p11sim_putBytes(pResponse,
+                        objectHandles,
+                        objectsCount * sizeof(CK_OBJECT_HANDLE));
+
+        free(objectHandles);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_FIND_OBJECTS_FINAL:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+
+        if (pRequest->isValid)
+        {
+            rv = C_FindObjectsFinal(sessionHandle);
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_FIND_OBJECTS_INIT:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+
+        objectTemplates[0] = p11sim_getTemplate(pRequest,
+                                                &objectTemplateSizes[0]);
+
+        if (pRequest->isValid)
+        {
+            rv = C_FindObjectsInit(sessionHandle,
+                                   objectTemplates[0],
+                                   objectTemplateSizes[0]);
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_GENERATE_KEY:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        CK_OBJECT_HANDLE keyHandle = CK_INVALID_HANDLE;
+
+        pMechanism = p11sim_getMechanism(pRequest);
+        objectTemplates[0] = p11sim_getTemplate(pRequest,
+                                                &objectTemplateSizes[0]);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_GenerateKey(sessionHandle,
+                           pMechanism,
+                           objectTemplates[0],
+                           objectTemplateSizes[0],
+                           &keyHandle);
+
+        p11sim_putUlong(pResponse,
+                        keyHandle);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_GENERATE_KEY_PAIR:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        CK_OBJECT_HANDLE publicKeyHandle = CK_INVALID_HANDLE;
+        CK_OBJECT_HANDLE privateKeyHandle = CK_INVALID_HANDLE;
+
+        pMechanism = p11sim_getMechanism(pRequest);
+        objectTemplates[0] = p11sim_getTemplate(pRequest,
+                                                &objectTemplateSizes[0]);
+        objectTemplates[1] = p11sim_getTemplate(pRequest,
+                                                &objectTemplateSizes[1]);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_GenerateKeyPair(sessionHandle,
+                               pMechanism,
+                               objectTemplates[0],
+                               objectTemplateSizes[0],
+                               objectTemplates[1],
+                               objectTemplateSizes[1],
+                               &publicKeyHandle,
+                               &privateKeyHandle);
+
+        p11sim_putUlong(pResponse,
+                        publicKeyHandle);
+        p11sim_putUlong(pResponse,
+                        privateKeyHandle);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_GET_ATTRIBUTE_VALUE:
+        rv = p11sim_serveGetAttributeValue(pRequest,
+                                           pResponse);
+
+        break;
+
+    case P11SIM_FUNCTION_C_GET_INFO:
+    case P11SIM_FUNCTION_C_GET_SLOT_INFO:
+    case P11SIM_FUNCTION_C_GET_TOKEN_INFO:
+    case P11SIM_FUNCTION_CA_GET_HA_STATE:
+        rv = p11sim_serveWithStructure(function,
+                                       pRequest,
+                                       pResponse);
+
+        break;
+
+    case P11SIM_FUNCTION_C_GET_SLOT_LIST:
+    {
+        const CK_BBOOL isTokenPresent = (CK_BBOOL)p11sim_getUlong(pRequest);
+        CK_ULONG slotListCapacity = 0;
+        CK_SLOT_ID *const slotList = (CK_SLOT_ID *)p11sim_getOutput(pRequest,
+                                                                    &slotListCapacity);
+
+        if (pRequest->isValid)
+        {
+            CK_ULONG slotsCount = slotListCapacity / sizeof(CK_SLOT_ID);
+
+            rv = C_GetSlotList(isTokenPresent,
+                               slotList,
+                               &slotsCount);
+
+            p11sim_putOutput(pResponse,
+                             slotList,
+                             slotListCapacity,
+                             slotsCount * sizeof(CK_SLOT_ID));
+        }
+
+        free(slotList);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_INITIALIZE:
+        // The mock is initialized by the daemon.
+        rv = CKR_OK;
+
+        break;
+
+    case P11SIM_FUNCTION_C_LOGIN:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        const CK_USER_TYPE userType = p11sim_getUlong(pRequest);
+        CK_ULONG pinLength = 0;
+        const void *const pin = p11sim_getBytes(pRequest,
+                                                &pinLength);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_Login(sessionHandle,
+                     userType,
+                     (CK_CHAR_PTR)pin,
+                     pinLength);
+
+        if (rv == CKR_OK)
+        {
+            p11sim_setLoggedIn(p11sim_getSessionOwner(sessionHandle),
+                               true);
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_LOGOUT:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        const CK_ULONG processId = p11sim_getSessionOwner(sessionHandle);
+
+        // The mock is logged out with the last process, the other ones
+        // remaining logged in.
+        if ((processId == 0) ||
+            (p11sim_setLoggedIn(processId,
+                                false) == 0))
+        {
+            rv = C_Logout(sessionHandle);
+        }
+        else
+        {
+            rv = CKR_OK;
+        }
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_OPEN_SESSION:
+    {
+        const CK_SLOT_ID slotId = p11sim_getUlong(pRequest);
+        const CK_FLAGS flags = p11sim_getUlong(pRequest);
+        const CK_ULONG processId = p11sim_getUlong(pRequest);
+        CK_SESSION_HANDLE sessionHandle = CK_INVALID_HANDLE;
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_OpenSession(slotId,
+                           flags,
+                           NULL,
+                           NULL,
+                           &sessionHandle);
+
+        if ((rv == CKR_OK) &&
+            (sessionHandle <= P11MOCK_MAXIMUM_SESSIONS_COUNT))
+        {
+            pthread_mutex_lock(&p11simMutex);
+
+            p11simSessionOwners[sessionHandle] = processId;
+
+            pthread_mutex_unlock(&p11simMutex);
+        }
+
+        p11sim_putUlong(pResponse,
+                        sessionHandle);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_C_SIGN:
+        rv = p11sim_serveWithOutput(C_Sign,
+                                    pRequest,
+                                    pResponse);
+
+        break;
+
+    case P11SIM_FUNCTION_C_SIGN_INIT:
+        rv = p11sim_serveWithMechanism(C_SignInit,
+                                       pRequest);
+
+        break;
+
+    case P11SIM_FUNCTION_C_UNWRAP_KEY:
+    {
+        const CK_SESSION_HANDLE sessionHandle = p11sim_getUlong(pRequest);
+        CK_OBJECT_HANDLE keyHandle = CK_INVALID_HANDLE;
+
+        pMechanism = p11sim_getMechanism(pRequest);
+
+        const CK_OBJECT_HANDLE unwrappingKeyHandle = p11sim_getUlong(pRequest);
+        CK_ULONG wrappedKeyLength = 0;
+        const void *const wrappedKey = p11sim_getBytes(pRequest,
+                                                       &wrappedKeyLength);
+
+        objectTemplates[0] = p11sim_getTemplate(pRequest,
+                                                &objectTemplateSizes[0]);
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = C_UnwrapKey(sessionHandle,
+                         pMechanism,
+                         unwrappingKeyHandle,
+                         (CK_BYTE_PTR)wrappedKey,
+                         wrappedKeyLength,
+                         objectTemplates[0],
+                         objectTemplateSizes[0],
+                         &keyHandle);
+
+        p11sim_putUlong(pResponse,
+                        keyHandle);
+
+        break;
+    }
+
+    case P11SIM_FUNCTION_CA_GET_FIRMWARE_VERSION:
+    {
+        const CK_SLOT_ID slotId = p11sim_getUlong(pRequest);
+        CK_ULONG major = 0;
+        CK_ULONG minor = 0;
+        CK_ULONG subminor = 0;
+
+        if (!pRequest->isValid)
+        {
+            break;
+        }
+
+        rv = CA_GetFirmwareVersion(slotId,
+                                   &major,
+                                   &minor,
+                                   &subminor);
+
+        p11sim_putUlong(pResponse,
+                        major);
+        p11sim_putUlong(pResponse,
+                        minor);
+        p11sim_putUlong(pResponse,
+                        subminor);
+
+        break;
+    }
+
+    default:
+        rv = CKR_FUNCTION_NOT_SUPPORTED;
+    }
+
+    p11sim_freeMechanism(pMechanism);
+    p11sim_freeTemplate(objectTemplates[0]);
+    p11sim_freeTemplate(objectTemplates[1]);
+
+    return rv;
+}
+
+static void p11sim_waitRoundTrip(void)
+{
+    if (p11simRoundTrip == 0)
+    {
+        return;
+    }
+
+    const struct timespec duration = {.tv_sec = (time_t)(p11simRoundTrip / 1000000),
+                                      .tv_nsec = (long)((p11simRoundTrip % 1000000) * 1000)};
+
+    nanosleep(&duration,
+              NULL);
+}
+
+static void *p11sim_serveConnection(void *const pArgument)
+{
+    const int socketDescriptor = (int)(intptr_t)pArgument;
+    P11SIM_BUFFER request;
+    P11SIM_BUFFER response;
+    uint32_t function = 0;
+
+    memset(&request,
+           0,
+           sizeof(request));
+    memset(&response,
+           0,
+           sizeof(response));
+
+    // The request is decoded in place: the response has its own buffer.
+    while (p11sim_receiveMessage(socketDescriptor,
+                                 &function,
+                                 &request))
+    {
+        p11sim_resetBuffer(&response);
+
+        const CK_RV rv = p11sim_serveRequest((P11SIM_FUNCTION)function,
+                                             &request,
+                                             &response);
+
+        if (!request.isValid)
+        {
+            fprintf(stderr,
+                    "p11sim: malformed request (function %u), connection closed.\n",
+                    function);
+
+            break;
+        }
+
+        p11sim_waitRoundTrip();
+
+        if (!p11sim_sendMessage(socketDescriptor,
+                                (uint32_t)rv,
+                                &response))
+        {
+            break;
+        }
+    }
+
+    close(socketDescriptor);
+
+    p11sim_freeBuffer(&request);
+    p11sim_freeBuffer(&response);
+
+    return NULL;
+}
+
+static void *p11sim_acceptConnections(void *const pArgument)
+{
+    const int listeningSocketDescriptor = (int)(intptr_t)pArgument;
+
+    for (;;)
+    {
+        const int socketDescriptor = accept(listeningSocketDescriptor,
+                                            NULL,
+                                            NULL);
+
+        if (socketDescriptor < 0)
+        {
+            continue;
+        }
+
+        const int isNoDelay = 1;
+        pthread_t thread;
+
+        setsockopt(socketDescriptor,
+                   IPPROTO_TCP,
+                   TCP_NODELAY,
+                   &isNoDelay,
+                   sizeof(isNoDelay));
+
+        if (pthread_create(&thread,
+                           NULL,
+                           p11sim_serveConnection,
+                           (void *)(intptr_t)socketDescriptor) != 0)
+        {
+            fprintf(stderr,
+                    "p11sim: cannot create a connection thread.\n");
+
+            close(socketDescriptor);
+
+            continue;
+        }
+
+        pthread_detach(thread);
+    }
+
+    return NULL;
+}
+
+int main(const int argc,
+         const char *const *const argv)
+{
+    int result = EXIT_FAILURE;
+    unsigned long port = P11SIM_DEFAULT_PORT;
+    int listeningSocketDescriptor = -1;
+    sigset_t signals;
+    int signal = 0;
+    pthread_t thread;
+
+    if ((getenv(P11SIM_PORT_VARIABLE) != NULL) &&
+        (!p11sim_parsePort(getenv(P11SIM_PORT_VARIABLE),
+                           &port)))
+    {
+        fprintf(stderr,
+                "Invalid %s value: '%s'.\n",
+                P11SIM_PORT_VARIABLE,
+                getenv(P11SIM_PORT_VARIABLE));
+
+        goto EXIT;
+    }
+
+    for (int argi = 1; argi < argc; argi += 2)
+    {
+        bool isValid = (argi + 1) < argc;
+
+        if (isValid &&
+            (strcmp(argv[argi],
+                    "--port") == 0))
+        {
+            isValid = p11sim_parsePort(argv[argi + 1],
+                                       &port);
+        }
+        else if (isValid &&
+                 (strcmp(argv[argi],
+                         "--round-trip") == 0))
+        {
+            isValid = p11mock_parseUnsignedLong(argv[argi + 1],
+                                                &p11simRoundTrip) == CKR_OK;
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if (!isValid)
+        {
+            fprintf(stderr,
+                    "Invalid option: '%s'.\n",
+                    argv[argi]);
+
+            p11sim_writeUsage(argv[0]);
+
+            goto EXIT;
+        }
+    }
+
+    // The mock reads its configuration from the environment.
+    if (C_Initialize(NULL) != CKR_OK)
+    {
+        fprintf(stderr,
+                "Cannot initialize the emulated appliance.\n");
+
+        goto EXIT;
+    }
+
+    struct sockaddr_in address;
+    const int isReusingAddress = 1;
+
+    memset(&address,
+           0,
+           sizeof(address));
+
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    listeningSocketDescriptor = socket(AF_INET,
+                                       SOCK_STREAM | SOCK_CLOEXEC,
+                                       0);
+
+    if ((listeningSocketDescriptor < 0) ||
+        (setsockopt(listeningSocketDescriptor,
+                    SOL_SOCKET,
+                    SO_REUSEADDR,
+                    &isReusingAddress,
+                    sizeof(isReusingAddress)) != 0) ||
+        (bind(listeningSocketDescriptor,
+              (const struct sockaddr *)&address,
+              sizeof(address)) != 0) ||
+        (listen(listeningSocketDescriptor,
+                SOMAXCONN) != 0))
+    {
+        fprintf(stderr,
+                "Cannot listen to 127.0.0.1:%lu.\n",
+                port);
+
+        goto FINALIZE;
+    }
+
+    // The signals are handled by the main thread only (the other ones
+    // inherit the mask).
+    sigemptyset(&signals);
+    sigaddset(&signals,
+              SIGINT);
+    sigaddset(&signals,
+              SIGTERM);
+
+    pthread_sigmask(SIG_BLOCK,
+                    &signals,
+                    NULL);
+
+    if (pthread_create(&thread,
+                       NULL,
+                       p11sim_acceptConnections,
+                       (void *)(intptr_t)listeningSocketDescriptor) != 0)
+    {
+        fprintf(stderr,
+                "Cannot create the listening thread.\n");
+
+        goto FINALIZE;
+    }
+
+    fprintf(stdout,
+            "Simulator listening to 127.0.0.1:%lu (round trip: %lu us).\n",
+            port,
+            p11simRoundTrip);
+    fflush(stdout);
+
+    sigwait(&signals,
+            &signal);
+
+    result = EXIT_SUCCESS;
+
+FINALIZE:
+    // Prints the reports of the mock (e.g. HA members).
+    C_Finalize(NULL);
+
+EXIT:
+    return result;
+}
@@ -0,0 +1,1097 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "p11-simulator.h"
+
+/*
+ * Notes:
+ *   - The connection of a thread is opened by its first call, and closed
+ *     when the thread exits or when the connection breaks (the call then
+ *     fails with CKR_DEVICE_ERROR, the next one reconnecting).
+ *   - The notification callbacks of C_OpenSession() are not supported.
+ */
+typedef struct _P11SIM_CONNECTION
+{
+    int socketDescriptor;
+    P11SIM_BUFFER buffer;
+} P11SIM_CONNECTION;
+
+static pthread_once_t p11simConnectionKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t p11simConnectionKey;
+static bool p11simIsInitialized = false;
+static struct sockaddr_in p11simDaemonAddress;
+
+static CK_FUNCTION_LIST p11simFunctionList = {.version = {2, 20},
+                                              .C_Initialize = C_Initialize,
+                                              .C_Finalize = C_Finalize,
+                                              .C_GetInfo = C_GetInfo,
+                                              .C_GetFunctionList = C_GetFunctionList,
+                                              .C_GetSlotList = C_GetSlotList,
+                                              .C_GetSlotInfo = C_GetSlotInfo,
+                                              .C_GetTokenInfo = C_GetTokenInfo,
+                                              .C_OpenSession = C_OpenSession,
+                                              .C_CloseSession = C_CloseSession,
+                                              .C_Login = C_Login,
+                                              .C_Logout = C_Logout,
+                                              .C_CreateObject = C_CreateObject,
+                                              .C_DestroyObject = C_DestroyObject,
+                                              .C_GetAttributeValue = C_GetAttributeValue,
+                                              .C_FindObjectsInit = C_FindObjectsInit,
+                                              .C_FindObjects = C_FindObjects,
+                                              .C_FindObjectsFinal = C_FindObjectsFinal,
+                                              .C_EncryptInit = C_EncryptInit,
+                                              .C_Encrypt = C_Encrypt,
+                                              .C_DecryptInit = C_DecryptInit,
+                                              .C_Decrypt = C_Decrypt,
+                                              .C_DigestInit = C_DigestInit,
+                                              .C_Digest = C_Digest,
+                                              .C_SignInit = C_SignInit,
+                                              .C_Sign = C_Sign,
+                                              .C_GenerateKey = C_GenerateKey,
+                                              .C_GenerateKeyPair = C_GenerateKeyPair,
+                                              .C_UnwrapKey = C_UnwrapKey};
+
+static CK_SFNT_CA_FUNCTION_LIST p11simCaFunctionList = {.version = {2, 20},
+                                                        .CA_GetFirmwareVersion = CA_GetFirmwareVersion,
+                                                        .CA_GetHAState = CA_GetHAState};
+
+static void p11sim_closeConnection(void *const pConnection)
+{
+    P11SIM_CONNECTION *const pSimulatorConnection = (P11SIM_CONNECTION *)pConnection;
+
+    if (pSimulatorConnection == NULL)
+    {
+        return;
+    }
+
+    close(pSimulatorConnection->socketDescriptor);
+
+    p11sim_freeBuffer(&pSimulatorConnection->buffer);
+
+    free(pSimulatorConnection);
+}
+
+static void p11sim_createConnectionKey(void)
+{
+    if (pthread_key_create(&p11simConnectionKey,
+                           p11sim_closeConnection) != 0)
+    {
+        // Cannot happen unless the keys are exhausted.
+        abort();
+    }
+}
+
+static P11SIM_CONNECTION *p11sim_getConnection(void)
+{
+    pthread_once(&p11simConnectionKeyOnce,
+                 p11sim_createConnectionKey);
+
+    P11SIM_CONNECTION *pConnection = (P11SIM_CONNECTION *)pthread_getspecific(p11simConnectionKey);
+
+    if (pConnection != NULL)
+    {
+        return pConnection;
+    }
+
+    pConnection = (P11SIM_CONNECTION *)calloc(1,
+                                              sizeof(P11SIM_CONNECTION));
+
+    if (pConnection == NULL)
+    {
+        return NULL;
+    }
+
+    const int isNoDelay = 1;
+
+    pConnection->socketDescriptor = socket(AF_INET,
+                                           SOCK_STREAM | SOCK_CLOEXEC,
+                                           0);
+
+    if ((pConnection->socketDescriptor < 0) ||
+        (setsockopt(pConnection->socketDescriptor,
+                    IPPROTO_TCP,
+                    TCP_NODELAY,
+                    &isNoDelay,
+                    sizeof(isNoDelay)) != 0) ||
+        (connect(pConnection->socketDescriptor,
+                 (const struct sockaddr *)&p11simDaemonAddress,
+                 sizeof(p11simDaemonAddress)) != 0))
+    {
+        if (pConnection->socketDescriptor >= 0)
+        {
+            close(pConnection->socketDescriptor);
+        }
+
+        free(pConnection);
+
+        return NULL;
+    }
+
+    pthread_setspecific(p11simConnectionKey,
+                        pConnection);
+
+    return pConnection;
+}
+
+// Returns the buffer of the request to write, or NULL if the library is not
+// initialized or the daemon is not reachable ('*pRv' then tells why).
+static P11SIM_BUFFER *p11sim_beginCall(CK_RV *const pRv)
+{
+    assert(pRv != NULL);
+
+    if (!__atomic_load_n(&p11simIsInitialized, __ATOMIC_ACQUIRE))
+    {
+        *pRv = CKR_CRYPTOKI_NOT_INITIALIZED;
+
+        return NULL;
+    }
+
+    P11SIM_CONNECTION *const pConnection = p11sim_getConnection();
+
+    if (pConnection == NULL)
+    {
+        *pRv = CKR_DEVICE_ERROR;
+
+        return NULL;
+    }
+
+    p11sim_resetBuffer(&pConnection->buffer);
+
+    *pRv = CKR_OK;
+
+    return &pConnection->buffer;
+}
+
+// Sends the request and receives the response in the same buffer.
+static CK_RV p11sim_endCall(const P11SIM_FUNCTION function)
+{
+    P11SIM_CONNECTION *const pConnection = (P11SIM_CONNECTION *)pthread_getspecific(p11simConnectionKey);
+    uint32_t rv = CKR_OK;
+
+    assert(pConnection != NULL);
+
+    if ((!p11sim_sendMessage(pConnection->socketDescriptor,
+                             (uint32_t)function,
+                             &pConnection->buffer)) ||
+        (!p11sim_receiveMessage(pConnection->socketDescriptor,
+                                &rv,
+                                &pConnection->buffer)))
+    {
+        pthread_setspecific(p11simConnectionKey,
+                            NULL);
+
+        p11sim_closeConnection(pConnection);
+
+        return CKR_DEVICE_ERROR;
+    }
+
+    return (CK_RV)rv;
+}
+
+// Output buffer: its capacity in the request, its length and its bytes (if
+// any) in the response.
+static void p11sim_putOutput(P11SIM_BUFFER *const pBuffer,
+                             const void *const output,
+                             const CK_ULONG *const pOutputLength)
+{
+    p11sim_putUlong(pBuffer,
+                    (output != NULL) ? *pOutputLength : (CK_ULONG)P11SIM_NULL_LENGTH);
+}
+
+static void p11sim_getOutput(P11SIM_BUFFER *const pBuffer,
+                             void *const output,
+                             CK_ULONG *const pOutputLength)
+{
+    const CK_ULONG outputCapacity = *pOutputLength;
+    CK_ULONG length = 0;
+
+    *pOutputLength = p11sim_getUlong(pBuffer);
+
+    const void *const bytes = p11sim_getBytes(pBuffer,
+                                              &length);
+
+    if ((bytes != NULL) &&
+        (output != NULL) &&
+        (length <= outputCapacity))
+    {
+        memcpy(output,
+               bytes,
+               length);
+    }
+}
+
+// A response that cannot be decoded means a broken daemon.
+static CK_RV p11sim_checkResponse(const P11SIM_BUFFER *const pBuffer,
+                                  const CK_RV rv)
+{
+    return pBuffer->isValid ? rv : CKR_DEVICE_ERROR;
+}
+
+// Shared by the functions with a session, a byte string input and an output
+// buffer (e.g. C_Sign()).
+static CK_RV p11sim_callWithOutput(const P11SIM_FUNCTION function,
+                                   const CK_SESSION_HANDLE sessionHandle,
+                                   const CK_BYTE *const input,
+                                   const CK_ULONG inputLength,
+                                   CK_BYTE *const output,
+                                   CK_ULONG *const pOutputLength)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (pOutputLength == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    sessionHandle);
+    p11sim_putBytes(pBuffer,
+                    input,
+                    inputLength);
+    p11sim_putOutput(pBuffer,
+                     output,
+                     pOutputLength);
+
+    rv = p11sim_endCall(function);
+
+    if (rv != CKR_DEVICE_ERROR)
+    {
+        p11sim_getOutput(pBuffer,
+                         output,
+                         pOutputLength);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+// Shared by the functions with a session, a mechanism and a key (e.g.
+// C_SignInit()).
+static CK_RV p11sim_callWithMechanism(const P11SIM_FUNCTION function,
+                                      const CK_SESSION_HANDLE sessionHandle,
+                                      const CK_MECHANISM *const pMechanism,
+                                      const CK_OBJECT_HANDLE keyHandle)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (pMechanism == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    sessionHandle);
+    p11sim_putMechanism(pBuffer,
+                        pMechanism);
+    p11sim_putUlong(pBuffer,
+                    keyHandle);
+
+    return p11sim_checkResponse(pBuffer,
+                                p11sim_endCall(function));
+}
+
+// Shared by the functions with a session and, possibly, an object handle
+// (e.g. C_DestroyObject()).
+static CK_RV p11sim_callWithHandles(const P11SIM_FUNCTION function,
+                                    const CK_SESSION_HANDLE sessionHandle,
+                                    const CK_OBJECT_HANDLE objectHandle)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    sessionHandle);
+    p11sim_putUlong(pBuffer,
+                    objectHandle);
+
+    return p11sim_checkResponse(pBuffer,
+                                p11sim_endCall(function));
+}
+
+// Shared by the functions returning a fixed-size structure for a slot (e.g.
+// C_GetTokenInfo()).
+static CK_RV p11sim_callWithStructure(const P11SIM_FUNCTION function,
+                                      const CK_SLOT_ID slotId,
+                                      void *const structure,
+                                      const CK_ULONG structureLength)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (structure == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    slotId);
+
+    rv = p11sim_endCall(function);
+
+    if (rv == CKR_OK)
+    {
+        CK_ULONG length = 0;
+        const void *const bytes = p11sim_getBytes(pBuffer,
+                                                  &length);
+
+        if ((bytes == NULL) || (length != structureLength))
+        {
+            return CKR_DEVICE_ERROR;
+        }
+
+        memcpy(structure,
+               bytes,
+               length);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_CloseSession(CK_SESSION_HANDLE hSession)
+{
+    return p11sim_callWithHandles(P11SIM_FUNCTION_C_CLOSE_SESSION,
+                                  hSession,
+                                  CK_INVALID_HANDLE);
+}
+
+CK_RV C_CreateObject(CK_SESSION_HANDLE hSession,
+                     CK_ATTRIBUTE_PTR pTemplate,
+                     CK_ULONG usCount,
+                     CK_OBJECT_HANDLE_PTR phObject)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (((pTemplate == NULL) && (usCount != 0)) || (phObject == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putTemplate(pBuffer,
+                       pTemplate,
+                       usCount);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_CREATE_OBJECT);
+
+    if (rv == CKR_OK)
+    {
+        *phObject = p11sim_getUlong(pBuffer);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_Decrypt(CK_SESSION_HANDLE hSession,
+                CK_BYTE_PTR pEncryptedData,
+                CK_ULONG usEncryptedDataLen,
+                CK_BYTE_PTR pData,
+                CK_ULONG_PTR pusDataLen)
+{
+    return p11sim_callWithOutput(P11SIM_FUNCTION_C_DECRYPT,
+                                 hSession,
+                                 pEncryptedData,
+                                 usEncryptedDataLen,
+                                 pData,
+                                 pusDataLen);
+}
+
+CK_RV C_DecryptInit(CK_SESSION_HANDLE hSession,
+                    CK_MECHANISM_PTR pMechanism,
+                    CK_OBJECT_HANDLE hKey)
+{
+    return p11sim_callWithMechanism(P11SIM_FUNCTION_C_DECRYPT_INIT,
+                                    hSession,
+                                    pMechanism,
+                                    hKey);
+}
+
+CK_RV C_DestroyObject(CK_SESSION_HANDLE hSession,
+                      CK_OBJECT_HANDLE hObject)
+{
+    return p11sim_callWithHandles(P11SIM_FUNCTION_C_DESTROY_OBJECT,
+                                  hSession,
+                                  hObject);
+}
+
+CK_RV C_Digest(CK_SESSION_HANDLE hSession,
+               CK_BYTE_PTR pData,
+               CK_ULONG usDataLen,
+               CK_BYTE_PTR pDigest,
+               CK_ULONG_PTR pusDigestLen)
+{
+    return p11sim_callWithOutput(P11SIM_FUNCTION_C_DIGEST,
+                                 hSession,
+                                 pData,
+                                 usDataLen,
+                                 pDigest,
+                                 pusDigestLen);
+}
+
+CK_RV C_DigestInit(CK_SESSION_HANDLE hSession,
+                   CK_MECHANISM_PTR pMechanism)
+{
+    return p11sim_callWithMechanism(P11SIM_FUNCTION_C_DIGEST_INIT,
+                                    hSession,
+                                    pMechanism,
+                                    CK_INVALID_HANDLE);
+}
+
+CK_RV C_Encrypt(CK_SESSION_HANDLE hSession,
+                CK_BYTE_PTR pData,
+                CK_ULONG usDataLen,
+                CK_BYTE_PTR pEncryptedData,
+                CK_ULONG_PTR pusEncryptedDataLen)
+{
+    return p11sim_callWithOutput(P11SIM_FUNCTION_C_ENCRYPT,
+                                 hSession,
+                                 pData,
+                                 usDataLen,
+                                 pEncryptedData,
+                                 pusEncryptedDataLen);
+}
+
+CK_RV C_EncryptInit(CK_SESSION_HANDLE hSession,
+                    CK_MECHANISM_PTR pMechanism,
+                    CK_OBJECT_HANDLE hKey)
+{
+    return p11sim_callWithMechanism(P11SIM_FUNCTION_C_ENCRYPT_INIT,
+                                    hSession,
+                                    pMechanism,
+                                    hKey);
+}
+
+CK_RV C_Finalize(CK_VOID_PTR pReserved)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (pReserved != NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    // The daemon closes the sessions of the process.
+    p11sim_putUlong(pBuffer,
+                    (CK_ULONG)getpid());
+
+    rv = p11sim_checkResponse(pBuffer,
+                              p11sim_endCall(P11SIM_FUNCTION_C_FINALIZE));
+
+    __atomic_store_n(&p11simIsInitialized, false, __ATOMIC_RELEASE);
+
+    return rv;
+}
+
+CK_RV C_FindObjects(CK_SESSION_HANDLE hSession,
+                    CK_OBJECT_HANDLE_PTR phObject,
+                    CK_ULONG usMaxObjectCount,
+                    CK_ULONG_PTR pusObjectCount)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if ((phObject == NULL) || (pusObjectCount == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putUlong(pBuffer,
+                    usMaxObjectCount);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_FIND_OBJECTS);
+
+    if (rv == CKR_OK)
+    {
+        CK_ULONG length = 0;
+        const void *const bytes = p11sim_getBytes(pBuffer,
+                                                  &length);
+
+        if ((bytes == NULL) ||
+            ((length % sizeof(CK_OBJECT_HANDLE)) != 0) ||
+            ((length / sizeof(CK_OBJECT_HANDLE)) > usMaxObjectCount))
+        {
+            return CKR_DEVICE_ERROR;
+        }
+
+        memcpy(phObject,
+               bytes,
+               length);
+
+        *pusObjectCount = length / sizeof(CK_OBJECT_HANDLE);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_FindObjectsFinal(CK_SESSION_HANDLE hSession)
+{
+    return p11sim_callWithHandles(P11SIM_FUNCTION_C_FIND_OBJECTS_FINAL,
+                                  hSession,
+                                  CK_INVALID_HANDLE);
+}
+
+CK_RV C_FindObjectsInit(CK_SESSION_HANDLE hSession,
+                        CK_ATTRIBUTE_PTR pTemplate,
+                        CK_ULONG usCount)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if ((pTemplate == NULL) && (usCount != 0))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putTemplate(pBuffer,
+                       pTemplate,
+                       usCount);
+
+    return p11sim_checkResponse(pBuffer,
+                                p11sim_endCall(P11SIM_FUNCTION_C_FIND_OBJECTS_INIT));
+}
+
+CK_RV C_GenerateKey(CK_SESSION_HANDLE hSession,
+                    CK_MECHANISM_PTR pMechanism,
+                    CK_ATTRIBUTE_PTR pTemplate,
+                    CK_ULONG usCount,
+                    CK_OBJECT_HANDLE_PTR phKey)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if ((pMechanism == NULL) || ((pTemplate == NULL) && (usCount != 0)) || (phKey == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putMechanism(pBuffer,
+                        pMechanism);
+    p11sim_putTemplate(pBuffer,
+                       pTemplate,
+                       usCount);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_GENERATE_KEY);
+
+    if (rv == CKR_OK)
+    {
+        *phKey = p11sim_getUlong(pBuffer);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_GenerateKeyPair(CK_SESSION_HANDLE hSession,
+                        CK_MECHANISM_PTR pMechanism,
+                        CK_ATTRIBUTE_PTR pPublicKeyTemplate,
+                        CK_ULONG usPublicKeyAttributeCount,
+                        CK_ATTRIBUTE_PTR pPrivateKeyTemplate,
+                        CK_ULONG usPrivateKeyAttributeCount,
+                        CK_OBJECT_HANDLE_PTR phPublicKey,
+                        CK_OBJECT_HANDLE_PTR phPrivateKey)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if ((pMechanism == NULL) ||
+        ((pPublicKeyTemplate == NULL) && (usPublicKeyAttributeCount != 0)) ||
+        ((pPrivateKeyTemplate == NULL) && (usPrivateKeyAttributeCount != 0)) ||
+        (phPublicKey == NULL) ||
+        (phPrivateKey == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putMechanism(pBuffer,
+                        pMechanism);
+    p11sim_putTemplate(pBuffer,
+                       pPublicKeyTemplate,
+                       usPublicKeyAttributeCount);
+    p11sim_putTemplate(pBuffer,
+                       pPrivateKeyTemplate,
+                       usPrivateKeyAttributeCount);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_GENERATE_KEY_PAIR);
+
+    if (rv == CKR_OK)
+    {
+        *phPublicKey = p11sim_getUlong(pBuffer);
+        *phPrivateKey = p11sim_getUlong(pBuffer);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_GetAttributeValue(CK_SESSION_HANDLE hSession,
+                          CK_OBJECT_HANDLE hObject,
+                          CK_ATTRIBUTE_PTR pTemplate,
+                          CK_ULONG usCount)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (((pTemplate == NULL) && (usCount != 0)) ||
+        (usCount > P11SIM_MAXIMUM_TEMPLATE_SIZE))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putUlong(pBuffer,
+                    hObject);
+    p11sim_putUlong(pBuffer,
+                    usCount);
+
+    for (CK_ULONG attributeIndex = 0; attributeIndex < usCount; attributeIndex++)
+    {
+        p11sim_putUlong(pBuffer,
+                        pTemplate[attributeIndex].type);
+        p11sim_putOutput(pBuffer,
+                         pTemplate[attributeIndex].pValue,
+                         &pTemplate[attributeIndex].usValueLen);
+    }
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_GET_ATTRIBUTE_VALUE);
+
+    // The lengths are returned whatever the result (e.g. with
+    // CKR_ATTRIBUTE_TYPE_INVALID).
+    for (CK_ULONG attributeIndex = 0; (rv != CKR_DEVICE_ERROR) && (attributeIndex < usCount); attributeIndex++)
+    {
+        p11sim_getOutput(pBuffer,
+                         pTemplate[attributeIndex].pValue,
+                         &pTemplate[attributeIndex].usValueLen);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_GetFunctionList(CK_FUNCTION_LIST_PTR_PTR ppFunctionList)
+{
+    if (ppFunctionList == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *ppFunctionList = &p11simFunctionList;
+
+    return CKR_OK;
+}
+
+CK_RV C_GetInfo(CK_INFO_PTR pInfo)
+{
+    return p11sim_callWithStructure(P11SIM_FUNCTION_C_GET_INFO,
+                                    0,
+                                    pInfo,
+                                    sizeof(CK_INFO));
+}
+
+CK_RV C_GetSlotInfo(CK_SLOT_ID slotID,
+                    CK_SLOT_INFO_PTR pInfo)
+{
+    return p11sim_callWithStructure(P11SIM_FUNCTION_C_GET_SLOT_INFO,
+                                    slotID,
+                                    pInfo,
+                                    sizeof(CK_SLOT_INFO));
+}
+
+CK_RV C_GetSlotList(CK_BBOOL tokenPresent,
+                    CK_SLOT_ID_PTR pSlotList,
+                    CK_ULONG_PTR pulCount)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (pulCount == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    CK_ULONG slotListLength = *pulCount * sizeof(CK_SLOT_ID);
+
+    p11sim_putUlong(pBuffer,
+                    tokenPresent);
+    p11sim_putOutput(pBuffer,
+                     pSlotList,
+                     &slotListLength);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_GET_SLOT_LIST);
+
+    if (rv != CKR_DEVICE_ERROR)
+    {
+        p11sim_getOutput(pBuffer,
+                         pSlotList,
+                         &slotListLength);
+
+        *pulCount = slotListLength / sizeof(CK_SLOT_ID);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_GetTokenInfo(CK_SLOT_ID slotID,
+                     CK_TOKEN_INFO_PTR pInfo)
+{
+    return p11sim_callWithStructure(P11SIM_FUNCTION_C_GET_TOKEN_INFO,
+                                    slotID,
+                                    pInfo,
+                                    sizeof(CK_TOKEN_INFO));
+}
+
+CK_RV C_Initialize(CK_VOID_PTR pInitArgs)
+{
+    // As the mock, the shim always relies on the native locking primitives.
+    if ((pInitArgs != NULL) &&
+        (((CK_C_INITIALIZE_ARGS *)pInitArgs)->pReserved != NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    if (__atomic_load_n(&p11simIsInitialized, __ATOMIC_ACQUIRE))
+    {
+        return CKR_CRYPTOKI_ALREADY_INITIALIZED;
+    }
+
+    const char *const value = getenv(P11SIM_PORT_VARIABLE);
+    unsigned long port = P11SIM_DEFAULT_PORT;
+
+    if (value != NULL)
+    {
+        char *pEnd = NULL;
+
+        port = strtoul(value, &pEnd, 10);
+
+        if ((pEnd == value) || (*pEnd != '\0') || (port == 0) || (port > 65535))
+        {
+            fprintf(stderr,
+                    "C_Initialize(): invalid %s value '%s'.\n",
+                    P11SIM_PORT_VARIABLE,
+                    value);
+
+            return CKR_ARGUMENTS_BAD;
+        }
+    }
+
+    memset(&p11simDaemonAddress,
+           0,
+           sizeof(p11simDaemonAddress));
+
+    p11simDaemonAddress.sin_family = AF_INET;
+    p11simDaemonAddress.sin_port = htons((uint16_t)port);
+    p11simDaemonAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    __atomic_store_n(&p11simIsInitialized, true, __ATOMIC_RELEASE);
+
+    // Checks that the daemon is reachable.
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer != NULL)
+    {
+        rv = p11sim_checkResponse(pBuffer,
+                                  p11sim_endCall(P11SIM_FUNCTION_C_INITIALIZE));
+    }
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "C_Initialize(): cannot reach the simulator daemon on port %lu.\n",
+                port);
+
+        __atomic_store_n(&p11simIsInitialized, false, __ATOMIC_RELEASE);
+    }
+
+    return rv;
+}
+
+CK_RV C_Login(CK_SESSION_HANDLE hSession,
+              CK_USER_TYPE userType,
+              CK_CHAR_PTR pPin,
+              CK_ULONG usPinLen)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putUlong(pBuffer,
+                    userType);
+    p11sim_putBytes(pBuffer,
+                    pPin,
+                    usPinLen);
+
+    return p11sim_checkResponse(pBuffer,
+                                p11sim_endCall(P11SIM_FUNCTION_C_LOGIN));
+}
+
+CK_RV C_Logout(CK_SESSION_HANDLE hSession)
+{
+    return p11sim_callWithHandles(P11SIM_FUNCTION_C_LOGOUT,
+                                  hSession,
+                                  CK_INVALID_HANDLE);
+}
+
+CK_RV C_OpenSession(CK_SLOT_ID slotID,
+                    CK_FLAGS flags,
+                    CK_VOID_PTR pApplication,
+                    CK_NOTIFY Notify,
+                    CK_SESSION_HANDLE_PTR phSession)
+{
+    (void)pApplication;
+    (void)Notify;
+
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if (phSession == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    slotID);
+    p11sim_putUlong(pBuffer,
+                    flags);
+    p11sim_putUlong(pBuffer,
+                    (CK_ULONG)getpid());
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_OPEN_SESSION);
+
+    if (rv == CKR_OK)
+    {
+        *phSession = p11sim_getUlong(pBuffer);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV C_Sign(CK_SESSION_HANDLE hSession,
+             CK_BYTE_PTR pData,
+             CK_ULONG usDataLen,
+             CK_BYTE_PTR pSignature,
+             CK_ULONG_PTR pusSignatureLen)
+{
+    return p11sim_callWithOutput(P11SIM_FUNCTION_C_SIGN,
+                                 hSession,
+                                 pData,
+                                 usDataLen,
+                                 pSignature,
+                                 pusSignatureLen);
+}
+
+CK_RV C_SignInit(CK_SESSION_HANDLE hSession,
+                 CK_MECHANISM_PTR pMechanism,
+                 CK_OBJECT_HANDLE hKey)
+{
+    return p11sim_callWithMechanism(P11SIM_FUNCTION_C_SIGN_INIT,
+                                    hSession,
+                                    pMechanism,
+                                    hKey);
+}
+
+CK_RV C_UnwrapKey(CK_SESSION_HANDLE hSession,
+                  CK_MECHANISM_PTR pMechanism,
+                  CK_OBJECT_HANDLE hUnwrappingKey,
+                  CK_BYTE_PTR pWrappedKey,
+                  CK_ULONG usWrappedKeyLen,
+                  CK_ATTRIBUTE_PTR pTemplate,
+                  CK_ULONG usAttributeCount,
+                  CK_OBJECT_HANDLE_PTR phKey)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if ((pMechanism == NULL) || ((pTemplate == NULL) && (usAttributeCount != 0)) || (phKey == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    hSession);
+    p11sim_putMechanism(pBuffer,
+                        pMechanism);
+    p11sim_putUlong(pBuffer,
+                    hUnwrappingKey);
+    p11sim_putBytes(pBuffer,
+                    pWrappedKey,
+                    usWrappedKeyLen);
+    p11sim_putTemplate(pBuffer,
+                       pTemplate,
+                       usAttributeCount);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_C_UNWRAP_KEY);
+
+    if (rv == CKR_OK)
+    {
+        *phKey = p11sim_getUlong(pBuffer);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV CA_GetFirmwareVersion(CK_SLOT_ID slotId,
+                            CK_ULONG_PTR pulMajor,
+                            CK_ULONG_PTR pulMinor,
+                            CK_ULONG_PTR pulSubminor)
+{
+    CK_RV rv = CKR_OK;
+    P11SIM_BUFFER *const pBuffer = p11sim_beginCall(&rv);
+
+    if (pBuffer == NULL)
+    {
+        return rv;
+    }
+
+    if ((pulMajor == NULL) || (pulMinor == NULL) || (pulSubminor == NULL))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    p11sim_putUlong(pBuffer,
+                    slotId);
+
+    rv = p11sim_endCall(P11SIM_FUNCTION_CA_GET_FIRMWARE_VERSION);
+
+    if (rv == CKR_OK)
+    {
+        *pulMajor = p11sim_getUlong(pBuffer);
+        *pulMinor = p11sim_getUlong(pBuffer);
+        *pulSubminor = p11sim_getUlong(pBuffer);
+    }
+
+    return p11sim_checkResponse(pBuffer,
+                                rv);
+}
+
+CK_RV CA_GetFunctionList(CK_SFNT_CA_FUNCTION_LIST_PTR_PTR ppSfntFunctionList)
+{
+    if (ppSfntFunctionList == NULL)
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    *ppSfntFunctionList = &p11simCaFunctionList;
+
+    return CKR_OK;
+}
+
+CK_RV CA_GetHAState(CK_SLOT_ID slotId,
+                    CK_HA_STATE_PTR pState)
+{
+    return p11sim_callWithStructure(P11SIM_FUNCTION_CA_GET_HA_STATE,
+                                    slotId,
+                                    pState,
+                                    sizeof(CK_HA_STATUS));
+}
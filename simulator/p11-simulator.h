@@ -0,0 +1,152 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __P11_SIMULATOR_H__
+#define __P11_SIMULATOR_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cryptoki_v2.h>
+
+/*
+ * Definitions
+ *
+ * Out-of-process simulator of a Luna appliance: a daemon serving the
+ * PKCS#11 functions of the mock (see 'mock/p11-mock.h') on the loopback
+ * interface, and a provider library (the shim) forwarding the calls of
+ * ha-bench to it. Several ha-bench processes can share the same daemon,
+ * hence the same objects, HA members and service queues.
+ *
+ * Each thread of the shim opens its own connection. The protocol is a
+ * sequence of request/response messages, each one made of a header (the
+ * payload length, then the function code for a request or the CK_RV for a
+ * response, both as 32-bit values) followed by the payload:
+ *   - the CK_ULONG values are encoded as 64-bit values;
+ *   - the byte strings as their length followed by their bytes, the
+ *     P11SIM_NULL_LENGTH length standing for a NULL pointer;
+ *   - the output buffers as their capacity (or P11SIM_NULL_LENGTH) in the
+ *     request, and as a byte string in the response;
+ *   - the fixed-size structures (e.g. CK_TOKEN_INFO) as byte strings.
+ * Both ends run on the same host: the host byte order is used.
+ *
+ * The shim is configured through the following environment variable:
+ *   - HA_BENCH_SIMULATOR_PORT: TCP port of the daemon on 127.0.0.1
+ *                              (default: 1792, as the Luna NTLS service).
+ */
+#define P11SIM_PORT_VARIABLE "HA_BENCH_SIMULATOR_PORT"
+#define P11SIM_DEFAULT_PORT 1792
+
+#define P11SIM_NULL_LENGTH UINT64_MAX
+#define P11SIM_MAXIMUM_PAYLOAD_LENGTH (16 * 1024 * 1024)
+#define P11SIM_MAXIMUM_TEMPLATE_SIZE 64
+
+typedef enum _P11SIM_FUNCTION
+{
+    P11SIM_FUNCTION_C_CLOSE_SESSION = 1,
+    P11SIM_FUNCTION_C_CREATE_OBJECT,
+    P11SIM_FUNCTION_C_DECRYPT,
+    P11SIM_FUNCTION_C_DECRYPT_INIT,
+    P11SIM_FUNCTION_C_DESTROY_OBJECT,
+    P11SIM_FUNCTION_C_DIGEST,
+    P11SIM_FUNCTION_C_DIGEST_INIT,
+    P11SIM_FUNCTION_C_ENCRYPT,
+    P11SIM_FUNCTION_C_ENCRYPT_INIT,
+    P11SIM_FUNCTION_C_FINALIZE,
+    P11SIM_FUNCTION_C_FIND_OBJECTS,
+    P11SIM_FUNCTION_C_FIND_OBJECTS_FINAL,
+    P11SIM_FUNCTION_C_FIND_OBJECTS_INIT,
+    P11SIM_FUNCTION_C_GENERATE_KEY,
+    P11SIM_FUNCTION_C_GENERATE_KEY_PAIR,
+    P11SIM_FUNCTION_C_GET_ATTRIBUTE_VALUE,
+    P11SIM_FUNCTION_C_GET_INFO,
+    P11SIM_FUNCTION_C_GET_SLOT_INFO,
+    P11SIM_FUNCTION_C_GET_SLOT_LIST,
+    P11SIM_FUNCTION_C_GET_TOKEN_INFO,
+    P11SIM_FUNCTION_C_INITIALIZE,
+    P11SIM_FUNCTION_C_LOGIN,
+    P11SIM_FUNCTION_C_LOGOUT,
+    P11SIM_FUNCTION_C_OPEN_SESSION,
+    P11SIM_FUNCTION_C_SIGN,
+    P11SIM_FUNCTION_C_SIGN_INIT,
+    P11SIM_FUNCTION_C_UNWRAP_KEY,
+    P11SIM_FUNCTION_CA_GET_FIRMWARE_VERSION,
+    P11SIM_FUNCTION_CA_GET_HA_STATE
+} P11SIM_FUNCTION;
+
+// Message payload, being written or read. Once an encoding or decoding
+// error occurred, 'isValid' is false and the next operations are ignored.
+typedef struct _P11SIM_BUFFER
+{
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+    size_t offset;
+    bool isValid;
+} P11SIM_BUFFER;
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - 'p11sim_getBytes' returns a pointer to the buffer data, which remains
+ *     valid until the buffer is reset or freed.
+ *   - The decoded templates and mechanisms are copies (their values being
+ *     aligned), to be released with 'p11sim_freeTemplate' and
+ *     'p11sim_freeMechanism'.
+ */
+
+// Buffers.
+void p11sim_freeBuffer(P11SIM_BUFFER *const pBuffer);
+
+void p11sim_resetBuffer(P11SIM_BUFFER *const pBuffer);
+
+// Encoding.
+void p11sim_putBytes(P11SIM_BUFFER *const pBuffer,
+                     const void *const bytes,
+                     const CK_ULONG length);
+
+void p11sim_putMechanism(P11SIM_BUFFER *const pBuffer,
+                         const CK_MECHANISM *const pMechanism);
+
+// Input template: the types and values.
+void p11sim_putTemplate(P11SIM_BUFFER *const pBuffer,
+                        const CK_ATTRIBUTE *const objectTemplate,
+                        const CK_ULONG objectTemplateSize);
+
+void p11sim_putUlong(P11SIM_BUFFER *const pBuffer,
+                     const CK_ULONG value);
+
+// Decoding.
+const void *p11sim_getBytes(P11SIM_BUFFER *const pBuffer,
+                            CK_ULONG *const pLength);
+
+CK_MECHANISM *p11sim_getMechanism(P11SIM_BUFFER *const pBuffer);
+
+CK_ATTRIBUTE *p11sim_getTemplate(P11SIM_BUFFER *const pBuffer,
+                                 CK_ULONG *const pObjectTemplateSize);
+
+CK_ULONG p11sim_getUlong(P11SIM_BUFFER *const pBuffer);
+
+void p11sim_freeMechanism(CK_MECHANISM *const pMechanism);
+
+void p11sim_freeTemplate(CK_ATTRIBUTE *const objectTemplate);
+
+// Messages: the code is the function of a request or the CK_RV of a
+// response; the buffer is reset before receiving.
+bool p11sim_receiveMessage(const int socketDescriptor,
+                           uint32_t *const pCode,
+                           P11SIM_BUFFER *const pBuffer);
+
+bool p11sim_sendMessage(const int socketDescriptor,
+                        const uint32_t code,
+                        P11SIM_BUFFER *const pBuffer);
+
+#endif /* __P11_SIMULATOR_H__ */
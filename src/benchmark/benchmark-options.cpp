@@ -0,0 +1,736 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <strings.h>
+
+#include "benchmark-options.hpp"
+#include "workers/workers-board.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+bool isNumber(const std::string &value);
+
+bool isNumber(const std::string &value)
+{
+    try
+    {
+        stoi(value);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        return false;
+    }
+    catch (const std::out_of_range &e)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+BenchmarkOptions::BenchmarkOptions()
+{
+    // Nothing else to do here.
+}
+
+BenchmarkOptions::~BenchmarkOptions()
+{
+    // Nothing else to do here.
+}
+
+CK_RV BenchmarkOptions::parse(const int argc,
+                              const char *const *const argv,
+                              const bool isAgent)
+{
+    assert(argv != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    int argi = 1;
+
+    // Options (if any) are preceding the mandatory arguments.
+    while ((argi < argc) &&
+           (strncmp(argv[argi],
+                    "--",
+                    2) == 0))
+    {
+        // Options without value.
+        if (strcmp(argv[argi],
+                   "--profile") == 0)
+        {
+            isProfiling = true;
+
+            argi++;
+
+            continue;
+        }
+
+        if (strcmp(argv[argi],
+                   "--many-sessions") == 0)
+        {
+            isManySessions = true;
+
+            argi++;
+
+            continue;
+        }
+
+        if ((strcmp(argv[argi],
+                    "--serving-network-name") == 0) &&
+            ((argi + 1) < argc))
+        {
+            servingNetworkName = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--access-network-name") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            accessNetworkName = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--provider") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            providerPath = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--json") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            jsonPath = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--verify") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            verificationRatio = atof(argv[argi + 1]);
+
+            if ((verificationRatio <= 0.0) ||
+                (verificationRatio > 1.0))
+            {
+                fprintf(stderr,
+                        "Invalid verification ratio: '%s'.\n",
+                        argv[argi + 1]);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+        else if ((strcmp(argv[argi],
+                         "--start-at") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            startMilliSeconds = strtoull(argv[argi + 1],
+                                         nullptr,
+                                         10);
+
+            if (startMilliSeconds == 0LL)
+            {
+                fprintf(stderr,
+                        "Invalid start time: '%s'.\n",
+                        argv[argi + 1]);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+        else if ((strcmp(argv[argi],
+                         "--affinity") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            affinityDescription = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--housekeeping") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            housekeepingCpusDescription = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--scheduling") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            schedulingDescription = argv[argi + 1];
+        }
+        else if ((strcmp(argv[argi],
+                         "--stack-size") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            stackSize = (size_t)strtoul(argv[argi + 1],
+                                        nullptr,
+                                        10) *
+                        1024;
+
+            if (stackSize < (size_t)PTHREAD_STACK_MIN)
+            {
+                fprintf(stderr,
+                        "Invalid stack size: '%s'.\n",
+                        argv[argi + 1]);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+        else if ((strcmp(argv[argi],
+                         "--watchdog") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            stallMilliSeconds = strtoul(argv[argi + 1],
+                                        nullptr,
+                                        10);
+
+            if (stallMilliSeconds == 0L)
+            {
+                fprintf(stderr,
+                        "Invalid stall threshold: '%s'.\n",
+                        argv[argi + 1]);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+        else if ((strcmp(argv[argi],
+                         "--slowest") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            slowestRequestsCount = (size_t)strtoul(argv[argi + 1],
+                                                   nullptr,
+                                                   10);
+
+            if (slowestRequestsCount == 0)
+            {
+                fprintf(stderr,
+                        "Invalid slowest requests count: '%s'.\n",
+                        argv[argi + 1]);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+        else if ((strcmp(argv[argi],
+                         "--processes") == 0) &&
+                 ((argi + 1) < argc))
+        {
+            processesCount = (size_t)atol(argv[argi + 1]);
+
+            if ((processesCount == 0) ||
+                (processesCount > WORKERS_BOARD__MAXIMUM_WORKERS_COUNT))
+            {
+                fprintf(stderr,
+                        "Invalid processes count: '%s'.\n",
+                        argv[argi + 1]);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Invalid option: '%s'.\n",
+                    argv[argi]);
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        argi += 2;
+    }
+
+    // The agents are publishing the results of their own process only.
+    if (isAgent &&
+        (processesCount > 1))
+    {
+        fprintf(stderr,
+                "The '--processes' option is not supported by the agents.\n");
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    if (isManySessions &&
+        (stackSize == 0))
+    {
+        stackSize = BENCHMARK_OPTIONS__MANY_SESSIONS_STACK_SIZE;
+    }
+
+    // The profile is kept by each process.
+    if (isProfiling &&
+        (processesCount > 1))
+    {
+        fprintf(stderr,
+                "The '--profile' and '--processes' options cannot be combined.\n");
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    if ((argc - argi) < 6)
+    {
+        writeUsage(argv[0]);
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    slotId = (CK_SLOT_ID)atoi(argv[argi++]);
+    coPassword = (CK_CHAR *)argv[argi++];
+    coPasswordLength = (CK_ULONG)strlen((char *)coPassword);
+
+    if (coPasswordLength == 0)
+    {
+        fprintf(stderr,
+                "Invalid password length: '%ld'.\n",
+                coPasswordLength);
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    if (strcasecmp(argv[argi],
+                   "time-limited") == 0)
+    {
+        isTimeLimited = true;
+    }
+    else if (strcasecmp(argv[argi],
+                        "request-limited") == 0)
+    {
+        isTimeLimited = false;
+    }
+    else
+    {
+        fprintf(stderr,
+                "Invalid mesure type: '%s'.\n",
+                argv[argi]);
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    argi++;
+
+    if (isTimeLimited)
+    {
+        testsDuration = atoi(argv[argi]);
+
+        if ((testsDuration <= 0) ||
+            (testsDuration > 3600))
+        {
+            fprintf(stderr,
+                    "Invalid tests duration: '%d'.\n",
+                    testsDuration);
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+    }
+    else
+    {
+        requestsCountPerTest = atol(argv[argi]);
+
+        if (requestsCountPerTest <= 0)
+        {
+            fprintf(stderr,
+                    "Invalid requests count per test: '%ld'.\n",
+                    requestsCountPerTest);
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+    }
+
+    argi++;
+
+    if (strcasecmp(argv[argi],
+                   "share") == 0)
+    {
+        isSharingObjects = true;
+    }
+    else if (strcasecmp(argv[argi],
+                        "no-share") == 0)
+    {
+        isSharingObjects = false;
+    }
+    else
+    {
+        fprintf(stderr,
+                "Invalid argument: '%s'.\n",
+                argv[argi]);
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    argi++;
+
+    while (argi < argc)
+    {
+        const char *const scenarioDefinitionItemSeparator = "x";
+        const char *scenarioDefinitionFirstItem = nullptr;
+        const char *scenarioDefinitionSecondItem = nullptr;
+        const char *scenarioDefinitionThirdItem = nullptr;
+        SCENARIO_CLASS scenarioClass = -1;
+        char *tokenizerContext = nullptr;
+        ScenarioResults scenarioResults = {};
+
+        scenarioDefinitionFirstItem = strtok_r((char *)argv[argi],
+                                               scenarioDefinitionItemSeparator,
+                                               &tokenizerContext);
+
+        if (scenarioDefinitionFirstItem == nullptr)
+        {
+            goto INVALID_SCENARIO_DESCRIPTION;
+        }
+
+        scenarioDefinitionSecondItem = strtok_r(nullptr,
+                                                scenarioDefinitionItemSeparator,
+                                                &tokenizerContext);
+
+        if ((scenarioDefinitionSecondItem == nullptr) ||
+            !isNumber(scenarioDefinitionSecondItem))
+        {
+            goto INVALID_SCENARIO_DESCRIPTION;
+        }
+
+        scenarioDefinitionThirdItem = strtok_r(nullptr,
+                                               scenarioDefinitionItemSeparator,
+                                               &tokenizerContext);
+
+        if ((scenarioDefinitionThirdItem == nullptr) ||
+            !isNumber(scenarioDefinitionThirdItem) ||
+            (strtok_r(nullptr,
+                      scenarioDefinitionItemSeparator,
+                      &tokenizerContext) != nullptr))
+        {
+            goto INVALID_SCENARIO_DESCRIPTION;
+        }
+
+        if (strcasecmp(scenarioDefinitionFirstItem,
+                       "comp-128") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__COMP_128_AUTHENTICATION;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "milenage") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__MILENAGE_AUTHENTICATION;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "TUAK") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__TUAK_AUTHENTICATION;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "SUCI") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__SUCI_DECONCEALMENT;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "milenage-resync") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__MILENAGE_RESYNCHRONIZATION;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "TUAK-resync") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__TUAK_RESYNCHRONIZATION;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "milenage-5g-aka") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__MILENAGE_5G_AKA;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "TUAK-5g-aka") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__TUAK_5G_AKA;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "milenage-eap-aka-prime") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__MILENAGE_EAP_AKA_PRIME;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "TUAK-eap-aka-prime") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__TUAK_EAP_AKA_PRIME;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "milenage-software") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__MILENAGE_SOFTWARE;
+        }
+        else if (strcasecmp(scenarioDefinitionFirstItem,
+                            "TUAK-software") == 0)
+        {
+            scenarioClass = SCENARIO_CLASS__TUAK_SOFTWARE;
+        }
+        else
+        {
+            fprintf(stderr,
+                    "Invalid scenario: '%s'.\n",
+                    scenarioDefinitionFirstItem);
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        scenariiClasses.push_back(scenarioClass);
+        scenariiFlags.push_back((SCENARIO_FLAGS)atoi(scenarioDefinitionSecondItem));
+        scenariiTestsCounts.push_back((size_t)atol(scenarioDefinitionThirdItem));
+        scenariiArgumentsIndexes.push_back(argi);
+        totalTestsCount += scenariiTestsCounts.back();
+
+        scenarioResults.scenario = scenarioDefinitionFirstItem;
+        scenarioResults.flags = scenarioDefinitionSecondItem;
+        scenarioResults.testsCount = scenariiTestsCounts.back();
+        scenarioResults.mechanism = ScenarioResults::getMechanism(scenarioResults.scenario);
+
+        scenariiResults.push_back(scenarioResults);
+
+        argi++;
+    }
+
+    goto EXIT;
+
+INVALID_SCENARIO_DESCRIPTION:
+    writeError("Invalid scenario description.\n");
+
+    rv = CKR_GENERAL_ERROR;
+
+EXIT:
+    return rv;
+}
+
+void BenchmarkOptions::writeUsage(const char *const command) const
+{
+    fprintf(stdout,
+            "%s [<option>]*\n\
+           <slot-id>\n\
+           <co-password>\n\
+           <measure-type>\n\
+           <measure-objective>\n\
+           <share>\n\
+           {<scenario>x<flags>x<tests-count>}+\n\
+\n\
+Runs spread over several hosts: see '%s coordinator' and '%s agent'.\n\
+Instances of this host: see '%s top' and '%s merge'.\n\
+\n\
+SIGINT (Ctrl-C) or SIGTERM stops the tests, then writes the report of the\n\
+requests made so far and cleans the objects; SIGUSR1 writes a snapshot of\n\
+the counters and latencies of the running tests.\n\
+\n\
+Options:\n\
+  --serving-network-name <name>\n\
+                   : serving network name used by the 5G-AKA key\n\
+                     derivations (default: '" THREE_GPP__DEFAULT_SERVING_NETWORK_NAME "').\n\
+  --access-network-name <name>\n\
+                   : access network name used by the EAP-AKA' CK'/IK'\n\
+                     derivation (default: '" THREE_GPP__DEFAULT_ACCESS_NETWORK_NAME "').\n\
+  --provider <path>: PKCS#11 provider library to load (default:\n\
+                     '" P11TK_DEFAULT_PROVIDER_PATH "', looked up by the\n\
+                     dynamic linker).\n\
+  --profile        : record the count, the latencies and the results of the\n\
+                     PKCS#11 calls, per scenario, and print them at exit.\n\
+  --json <path>    : write the results of the run to a JSON file, e.g. to\n\
+                     fit a performance model (see '%s model').\n\
+  --verify <ratio> : recompute in software a ratio (0<.<=1) of the outputs\n\
+                     of the COMP-128, Milenage and TUAK authentication\n\
+                     scenarii (including 5G-AKA and EAP-AKA'), on a separate\n\
+                     thread, and report the mismatches apart from the\n\
+                     errors, in total per algorithm.\n\
+  --start-at <epoch-ms>\n\
+                   : once the scenarii are initialized, release their tests\n\
+                     at this time (CLOCK_REALTIME, milli-seconds since the\n\
+                     Epoch), e.g. for the instances started on several\n\
+                     hosts; if time-limited, the test period ends at this\n\
+                     time plus its duration (a late instance starts at\n\
+                     once and runs until then, or fails if this end time\n\
+                     is passed). The agents start at the time chosen by\n\
+                     their coordinator instead.\n\
+  --affinity <layout>\n\
+                   : pin each test thread on a CPU, the n-th test started\n\
+                     (in the order of the scenarii) on the n-th CPU of the\n\
+                     layout, modulo its CPUs count. Can be:\n\
+                       'compact'     : fill the hardware threads of a core,\n\
+                                       then the cores of a package.\n\
+                       'scatter'     : one test per core and package first.\n\
+                       'numa:<nodes>': CPUs of NUMA nodes (e.g. 'numa:0'),\n\
+                                       as 'compact'.\n\
+                       <cpus>        : CPUs list, in its order (e.g. '2-7').\n\
+  --housekeeping <cpus>\n\
+                   : run the main thread, the verifiers and the threads of\n\
+                     the client library on these CPUs (e.g. '0-1'), not\n\
+                     given to the tests.\n\
+  --scheduling <policy>\n\
+                   : scheduling of the test threads, 'fifo:<priority>'\n\
+                     (SCHED_FIFO, 1<=.<=99) or 'nice:<level>' (-20<=.<=19),\n\
+                     usually requiring CAP_SYS_NICE.\n\
+  --stack-size <KiB>\n\
+                   : stack size of the test threads (default: the one of\n\
+                     the system, usually 8 MiB of virtual memory each).\n\
+  --many-sessions  : for thousands of tests (i.e. of sessions and threads),\n\
+                     use 256 KiB stacks (unless '--stack-size' is given),\n\
+                     check the client limits (threads, memory mappings and\n\
+                     sessions of the token) before the preparation, and\n\
+                     report the memory of the process per step, per test\n\
+                     session and per test thread (not with '--processes').\n\
+  --processes <count>\n\
+                   : run the scenarii in as many worker processes (1<=.<=" WORKERS_BOARD__MAXIMUM_WORKERS_TEXT "),\n\
+                     started together once all of them are initialized,\n\
+                     and report their results merged (latency histograms\n\
+                     included), then per worker. Not with '--profile'. The\n\
+                     workers are given the next CPUs of the '--affinity'\n\
+                     layout in turn.\n\
+  --watchdog <ms>  : record the PKCS#11 calls of the tests lasting at least\n\
+                     this threshold (e.g. during a failover of the HA\n\
+                     group), with their thread, function, begin time,\n\
+                     duration and result, write them on stderr as soon as\n\
+                     detected (even while still in progress), and report\n\
+                     them at exit.\n\
+  --slowest <count>: report the given count of slowest requests (failed\n\
+                     ones included), with their scenario, test and begin\n\
+                     time.\n\
+                     With '--processes', these reports are not merged from\n\
+                     the workers: only the stalls written on stderr remain.\n\
+\n\
+Arguments:\n\
+  slot-id          : slot identifier to use.\n\
+  co-password      : password of the Crypto Officer.\n\
+  measure-type     : 'time-limited' or 'request-limited'.\n\
+  measure-objective: if 'time-limited':\n\
+                       <tests-duration> (seconds; 0<.<=3600)\n\
+                     If 'request-limited':\n\
+                       <requests-count-per-test>\n\
+  share            : allow each scenario class running in this process to\n\
+                     share its objects with other instances of the same\n\
+                     scenario class running on the same host or elsewhere.\n\
+                     Can be:\n\
+                       'share'   : all the instances of a scenario class are\n\
+                                   sharing the objects handled by the scenario\n\
+                                   class.\n\
+                       'no-share': specific objects are created for each\n\
+                                   instance of scenario class (within the\n\
+                                   process, on the same host or elsewhere).\n\
+                     Note:\n\
+                       -  Objects are created during the preparation phase if\n\
+                          needed; they are retrieved just before to run the\n\
+                          test.\n\
+  scenario         : scenario (epic).\n\
+                     Can be:\n\
+                       'comp-128'\n\
+                       'milenage'\n\
+                       'TUAK'\n\
+                       'SUCI'\n\
+                       'milenage-resync'\n\
+                       'TUAK-resync'\n\
+                       'milenage-5g-aka'\n\
+                       'TUAK-5g-aka'\n\
+                       'milenage-eap-aka-prime'\n\
+                       'TUAK-eap-aka-prime'\n\
+                       'milenage-software'\n\
+                       'TUAK-software'\n\
+  flags            : scenario flags/parameters (story).\n\
+                     For COMP-128 authentication\n\
+                       yz:\n\
+                         y=\n\
+                           1: version 1.\n\
+                           2: version 2.\n\
+                           3: version 3.\n\
+                         z=\n\
+                           1: use token objects only.\n\
+                           0: use session objects only.\n\
+                     For Milenage authentication, resynchronization, 5G-AKA,\n\
+                     EAP-AKA' and software\n\
+                       vwxyz:\n\
+                         v=\n\
+                           1: use default RC values.\n\
+                           0: use specific RC values.\n\
+                         w=\n\
+                           1: (e)OP or (e)OPc is pre-loaded in the HSM.\n\
+                           0: (e)OP or (e)OPc is provided with the request.\n\
+                         x=\n\
+                           1: OP or OPc is encrypted.\n\
+                           0: OP or OPc is in clear text.\n\
+                         y=\n\
+                           1: OP is used.\n\
+                           0: OPc is used.\n\
+                         z=\n\
+                           1: use token objects only.\n\
+                           0: use session objects only.\n\
+                     For TUAK authentication, resynchronization, 5G-AKA,\n\
+                     EAP-AKA' and software\n\
+                       wxyz:\n\
+                         w=\n\
+                           1: (e)OP or (e)OPc is pre-loaded in the HSM.\n\
+                           0: (e)OP or (e)OPc is provided with the request.\n\
+                         x=\n\
+                           1: OP or OPc is encrypted.\n\
+                           0: OP or OPc is in clear text.\n\
+                         y=\n\
+                           1: OP is used.\n\
+                           0: OPc is used.\n\
+                         z=\n\
+                           1: use token objects only.\n\
+                           0: use session objects only.\n\
+                     For SUPI deconcealment\n\
+                       uvwxyz:\n\
+                         u= (not with v=1)\n\
+                           1: deconceal a pool of distinct SUCIs generated\n\
+                              in software at initialization.\n\
+                           0: deconceal the same SUCI for each key pair.\n\
+                         v=\n\
+                           1: rotate a home network key pair every second.\n\
+                           0: do not rotate the home network key pairs.\n\
+                         w=\n\
+                           number of home network key pairs (1 to 9, 0\n\
+                           meaning 1).\n\
+                         x= (for profile A only)\n\
+                           1: curve points are compressed.\n\
+                           0: curve points are not compressed.\n\
+                         y= (the profiles being named in reverse of TS 33.501)\n\
+                           1: profile B (X25519) is used.\n\
+                           0: profile A (P-256) is used.\n\
+                         z=\n\
+                           1: use token objects only.\n\
+                           0: use session objects only.\n\
+  tests-count       : number of tests/threads to run in parallel.\n",
+            command,
+            command,
+            command,
+            command,
+            command,
+            command);
+}
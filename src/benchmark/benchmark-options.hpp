@@ -0,0 +1,95 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef BENCHMARK_OPTIONS_HPP
+#define BENCHMARK_OPTIONS_HPP
+
+#include <string>
+#include <vector>
+
+#include "model/results.hpp"
+#include "scenarii/3gpp/authentication/5g-scenario.hpp"
+#include "scenarii/scenario.hpp"
+
+extern "C"
+{
+#include <toolkits/p11-toolkit.h>
+}
+
+// Stack size of the test threads with '--many-sessions', unless given.
+#define BENCHMARK_OPTIONS__MANY_SESSIONS_STACK_SIZE (256 * 1024)
+
+/*
+ * Options and arguments of a run (see 'ha-bench' without argument).
+ *
+ * Notes:
+ *   - The scenarii are only described here, their instances being built by
+ *     each process running them (see Benchmark).
+ *   - The arguments are tokenized in place, as the password is kept.
+ */
+class BenchmarkOptions
+{
+protected:
+    virtual void writeUsage(const char *const command) const;
+
+public:
+    bool isVerbose = false;
+    CK_SLOT_ID slotId = -1;
+    CK_CHAR *coPassword = nullptr;
+    CK_ULONG coPasswordLength = 0;
+    bool isTimeLimited = true;
+    unsigned int testsDuration = 0;
+    unsigned long requestsCountPerTest = 0L;
+    bool isSharingObjects = true;
+    std::string servingNetworkName = THREE_GPP__DEFAULT_SERVING_NETWORK_NAME;
+    std::string accessNetworkName = THREE_GPP__DEFAULT_ACCESS_NETWORK_NAME;
+    std::string providerPath = P11TK_DEFAULT_PROVIDER_PATH;
+    bool isProfiling = false;
+    std::string jsonPath = {};
+    double verificationRatio = 0.0;
+    size_t processesCount = 1;
+
+    // Time given by '--start-at', 0 if none.
+    unsigned long long startMilliSeconds = 0LL;
+
+    std::string affinityDescription = {};
+    std::string housekeepingCpusDescription = {};
+    std::string schedulingDescription = {};
+    size_t stackSize = 0;
+    bool isManySessions = false;
+    unsigned long stallMilliSeconds = 0L;
+    size_t slowestRequestsCount = 0;
+
+    // Per scenario, its class, flags and tests count, the index of its
+    // argument (for the error messages) and its results as named on the
+    // command line.
+    std::vector<SCENARIO_CLASS> scenariiClasses = {};
+    std::vector<SCENARIO_FLAGS> scenariiFlags = {};
+    std::vector<size_t> scenariiTestsCounts = {};
+    std::vector<int> scenariiArgumentsIndexes = {};
+    std::vector<ScenarioResults> scenariiResults = {};
+
+    // Tests of all the scenarii, in each process.
+    size_t totalTestsCount = 0;
+
+    BenchmarkOptions();
+    virtual ~BenchmarkOptions();
+
+    BenchmarkOptions(const BenchmarkOptions &) = delete;
+    BenchmarkOptions &operator=(const BenchmarkOptions &) = delete;
+
+    // Writes the usage if the mandatory arguments are missing. The agents
+    // (i.e. 'isAgent') cannot run several processes.
+    virtual CK_RV parse(const int argc,
+                        const char *const *const argv,
+                        const bool isAgent);
+};
+
+#endif /* BENCHMARK_OPTIONS_HPP */
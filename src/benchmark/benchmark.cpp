@@ -0,0 +1,815 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <sys/types.h>
+
+#include "benchmark.hpp"
+#include "signals.hpp"
+#include "workers.hpp"
+#include "workers/worker-publisher.hpp"
+
+extern "C"
+{
+#include <toolkits/profiling-toolkit.h>
+}
+
+Benchmark::Benchmark(const BenchmarkOptions &_options,
+                     const std::shared_ptr<Publisher> &_pPublisher) : Top("Benchmark"),
+                                                                      options(_options),
+                                                                      pPublisher(_pPublisher),
+                                                                      pThreadPool(std::make_shared<ThreadPool>(_options.stackSize)),
+                                                                      pWatchdog((_options.stallMilliSeconds != 0L) ? std::make_shared<Watchdog>(_options.stallMilliSeconds * 1000ULL) : nullptr),
+                                                                      scenarioContext(_options.slotId,
+                                                                                      _options.coPassword,
+                                                                                      _options.coPasswordLength,
+                                                                                      _options.isSharingObjects,
+                                                                                      _options.isVerbose,
+                                                                                      _options.servingNetworkName,
+                                                                                      _options.accessNetworkName,
+                                                                                      _options.verificationRatio,
+                                                                                      pStartGate,
+                                                                                      pThreadLayout,
+                                                                                      pThreadPool,
+                                                                                      pWatchdog,
+                                                                                      _options.slowestRequestsCount),
+                                                                      scenariiResults(_options.scenariiResults),
+                                                                      startMilliSeconds(_options.startMilliSeconds)
+{
+    // Nothing else to do here.
+}
+
+Benchmark::~Benchmark()
+{
+    // Nothing else to do here.
+}
+
+CK_RV Benchmark::applyThreadLayout()
+{
+    CK_RV rv = CKR_OK;
+
+    blockSignals();
+
+    rv = pThreadLayout->applyToHousekeepingThread();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    {
+        const std::string testsCpusDescription = pThreadLayout->getTestsCpusDescription(0,
+                                                                                        options.totalTestsCount * options.processesCount);
+
+        if (!testsCpusDescription.empty())
+        {
+            fprintf(stdout,
+                    "Tests CPUs (%s): %s\n",
+                    pThreadLayout->getAffinityDescription().c_str(),
+                    testsCpusDescription.c_str());
+        }
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV Benchmark::configure()
+{
+    // Note: the threads are only created once the workers (if any) are
+    // forked.
+    return pThreadLayout->configure(options.affinityDescription,
+                                    options.housekeepingCpusDescription,
+                                    options.schedulingDescription);
+}
+
+CK_RV Benchmark::createScenarii()
+{
+    CK_RV rv = CKR_OK;
+
+    scenarii.clear();
+
+    for (size_t scenarioIndex = 0; scenarioIndex < options.scenariiClasses.size(); scenarioIndex++)
+    {
+        const int argi = options.scenariiArgumentsIndexes[scenarioIndex];
+        std::shared_ptr<Scenario> pScenario = nullptr;
+        const int errorCode = Scenario::getInstance(options.scenariiClasses[scenarioIndex],
+                                                    scenarioContext,
+                                                    options.scenariiFlags[scenarioIndex],
+                                                    (SCENARIO_IDENTIFIER)scenarioIndex,
+                                                    options.scenariiTestsCounts[scenarioIndex],
+                                                    options.requestsCountPerTest,
+                                                    pScenario);
+
+        switch (errorCode)
+        {
+        case SCENARIO__ERROR_CODE__NO_ERROR:
+            break;
+
+        case SCENARIO__ERROR_CODE__UNKNOWN_SCENARIO_CLASS:
+            fprintf(stderr,
+                    "Argument %d: unknown scenario identifier.\n",
+                    argi);
+
+            break;
+
+        case SCENARIO__ERROR_CODE__INCONSISTENT_SCENARIO_FLAGS:
+            fprintf(stderr,
+                    "Argument %d: invalid scenario flags.\n",
+                    argi);
+
+            break;
+
+        case SCENARIO__ERROR_CODE__INVALID_TESTS_COUNT:
+            fprintf(stderr,
+                    "Argument %d: invalid tests count.\n",
+                    argi);
+
+            break;
+
+        default:
+            fprintf(stderr,
+                    "Argument %d: unknown error ('%d').\n",
+                    argi,
+                    errorCode);
+
+            break;
+        }
+
+        if (errorCode != SCENARIO__ERROR_CODE__NO_ERROR)
+        {
+            rv = CKR_GENERAL_ERROR;
+
+            break;
+        }
+
+        scenarii.push_back(pScenario);
+    }
+
+    return rv;
+}
+
+unsigned long Benchmark::getMembersCount() const
+{
+    GET_HA_STATE_ARGUMENTS haStateArguments = {};
+
+    haStateArguments.slotId = options.slotId;
+
+    return (p11tk_getHaState(&haStateArguments) == CKR_OK) ? haStateArguments.haState.listSize : 0L;
+}
+
+CK_RV Benchmark::initialize()
+{
+    CK_RV rv = CKR_OK;
+
+    writeTitle("Initialize the scenarii");
+
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        proftk_setContext(pScenario->getProfilingContext());
+
+        rv = pScenario->initialize();
+
+        proftk_setContext(PROFTK_DEFAULT_CONTEXT);
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+
+        stopSignal = waitForStopSignal(0LL,
+                                       scenarii,
+                                       0LL);
+
+        if (stopSignal != 0)
+        {
+            goto EXIT;
+        }
+    }
+
+    if (options.isManySessions)
+    {
+        getProcessMemory(&processMemories[REPORT__MEMORY_STEP__SESSIONS_OPENED]);
+    }
+
+    if (pPublisher != nullptr)
+    {
+        writeTitle("Wait for the start");
+
+        rv = pPublisher->waitForStart(scenarii,
+                                      startMilliSeconds);
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    {
+        std::vector<std::string> scenariiDefinitions = {};
+
+        for (const ScenarioResults &scenarioResults : scenariiResults)
+        {
+            scenariiDefinitions.push_back(scenarioResults.getDefinition());
+        }
+
+        pScoreboard = std::make_shared<Scoreboard>();
+
+        if (pScoreboard->create(scenariiDefinitions) != CKR_OK)
+        {
+            pScoreboard = nullptr;
+        }
+        else
+        {
+            pScoreboard->setState(WORKERS_BOARD__STATE__READY,
+                                  startMilliSeconds);
+        }
+    }
+
+EXIT:
+    return rv;
+}
+
+bool Benchmark::isStopRequested() const
+{
+    return (stopSignal != 0);
+}
+
+CK_RV Benchmark::load()
+{
+    CK_RV rv = CKR_OK;
+
+    writeMessage("Load the PKCS#11 provider...\n");
+
+    // Note: the calls watched for stalls are tracked by the profiling
+    // layer.
+    rv = p11tk_loadProvider(options.providerPath.c_str(),
+                            options.isProfiling ||
+                                (pWatchdog != nullptr));
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "Cannot load the PKCS#11 provider '%s'. ['0x%08lx']\n",
+                options.providerPath.c_str(),
+                rv);
+
+        goto EXIT;
+    }
+
+    proftk_setContextName(PROFTK_DEFAULT_CONTEXT,
+                          "Outside of any scenario");
+
+    writeMessage("Initialize the PKCS#11 client library and check the CO password...\n");
+
+    rv = p11tk_prepare(nullptr,
+                       options.slotId,
+                       options.coPassword,
+                       options.coPasswordLength,
+                       &sessionHandle);
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "Cannot open a PKCS#11 connexion. ['0x%08lx']\n",
+                rv);
+
+        goto EXIT;
+    }
+
+    if (options.isManySessions)
+    {
+        checkClientLimits(options.slotId,
+                          options.totalTestsCount,
+                          options.stackSize);
+
+        getProcessMemory(&processMemories[REPORT__MEMORY_STEP__PROVIDER_LOADED]);
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV Benchmark::prepare()
+{
+    CK_RV rv = CKR_OK;
+
+    writeTitle("Prepare the scenarii");
+
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        fprintf(stdout,
+                "%s:\n",
+                pScenario->getUniqueString().c_str());
+
+        pScenario->displayFlags();
+
+        proftk_setContextName(pScenario->getProfilingContext(),
+                              pScenario->getUniqueString().c_str());
+        proftk_setContext(pScenario->getProfilingContext());
+
+        rv = pScenario->prepare();
+
+        proftk_setContext(PROFTK_DEFAULT_CONTEXT);
+
+        if (rv != CKR_OK)
+        {
+            break;
+        }
+
+        // E.g. if many objects are created, in 'no-share' mode.
+        stopSignal = waitForStopSignal(0LL,
+                                       scenarii,
+                                       0LL);
+
+        if (stopSignal != 0)
+        {
+            break;
+        }
+    }
+
+    return rv;
+}
+
+CK_RV Benchmark::report()
+{
+    CK_RV rv = CKR_OK;
+
+    writeTitle("Report");
+
+    writeScenariiReport(scenarii,
+                        options.verificationRatio);
+
+    if (options.isManySessions)
+    {
+        writeMemoryReport(processMemories,
+                          scenarii,
+                          options.totalTestsCount);
+    }
+
+    if (pWatchdog != nullptr)
+    {
+        writeStalls(*pWatchdog);
+    }
+
+    if (options.slowestRequestsCount > 0)
+    {
+        writeSlowestRequests(scenarii,
+                             options.slowestRequestsCount);
+    }
+
+    if (pScoreboard != nullptr)
+    {
+        pScoreboard->publishStatistics(scenarii);
+    }
+
+    if (pPublisher != nullptr)
+    {
+        rv = pPublisher->publishStatistics(scenarii,
+                                           getMembersCount());
+    }
+    else if (!options.jsonPath.empty())
+    {
+        getScenariiResults(scenarii,
+                           scenariiResults);
+
+        writeRunResults(options,
+                        *pThreadLayout,
+                        getMembersCount(),
+                        scenariiResults);
+    }
+
+    return rv;
+}
+
+CK_RV Benchmark::runWorkers(bool &isWorker)
+{
+    CK_RV rv = CKR_OK;
+    std::vector<pid_t> processesIdentifiers = {};
+    size_t workerIndex = 0;
+    std::shared_ptr<WorkersBoard> pWorkersBoard = std::make_shared<WorkersBoard>(options.processesCount,
+                                                                                 scenarii.size());
+
+    isWorker = false;
+
+    rv = pWorkersBoard->create();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    writeTitle("Start the workers");
+
+    rv = forkWorkers(options.processesCount,
+                     processesIdentifiers,
+                     isWorker,
+                     workerIndex);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (!isWorker)
+    {
+        std::vector<bool> areWorkersFailed = {};
+        std::vector<std::string> workersNames = {};
+        std::vector<std::string> scenariiNames = {};
+        std::vector<std::string> verifiedAlgorithms = {};
+        unsigned long membersCount = 0L;
+
+        for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+        {
+            scenariiNames.push_back(pScenario->getUniqueString());
+            verifiedAlgorithms.push_back(pScenario->getVerifiedAlgorithm());
+        }
+
+        rv = waitForWorkers(*pWorkersBoard,
+                            processesIdentifiers,
+                            scenariiNames,
+                            areWorkersFailed);
+
+        writeTitle("Report");
+
+        for (workerIndex = 0; workerIndex < processesIdentifiers.size(); workerIndex++)
+        {
+            workersNames.push_back(std::string("Worker ") +
+                                   std::to_string(workerIndex) +
+                                   " (process " +
+                                   std::to_string(processesIdentifiers[workerIndex]) +
+                                   ")");
+        }
+
+        writeWorkersReport(*pWorkersBoard,
+                           workersNames,
+                           areWorkersFailed,
+                           scenariiNames,
+                           verifiedAlgorithms,
+                           options.verificationRatio,
+                           scenariiResults,
+                           membersCount);
+
+        if (!options.jsonPath.empty())
+        {
+            writeRunResults(options,
+                            *pThreadLayout,
+                            membersCount,
+                            scenariiResults);
+        }
+
+        goto EXIT;
+    }
+
+    // Worker: its outputs are merged by the parent process.
+    pPublisher = std::make_shared<WorkerPublisher>(pWorkersBoard,
+                                                   workerIndex);
+
+    pThreadLayout->setNextTestIndex(workerIndex * options.totalTestsCount);
+
+    if (freopen("/dev/null",
+                "w",
+                stdout) == nullptr)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    rv = createScenarii();
+
+EXIT:
+    return rv;
+}
+
+CK_RV Benchmark::setTestPeriod()
+{
+    CK_RV rv = CKR_OK;
+
+    if (startMilliSeconds == 0LL)
+    {
+        startMilliSeconds = getEpochMilliSeconds();
+        endMilliSeconds = startMilliSeconds + (options.testsDuration * 1000LL);
+    }
+    else if (getEpochMilliSeconds() > startMilliSeconds)
+    {
+        // The test period still ends at the time shared with the other
+        // instances, i.e. it is shortened.
+        endMilliSeconds = startMilliSeconds + (options.testsDuration * 1000LL);
+
+        if (options.isTimeLimited &&
+            (getEpochMilliSeconds() >= endMilliSeconds))
+        {
+            fprintf(stderr,
+                    "The end time is passed by %llu ms.\n",
+                    getEpochMilliSeconds() - endMilliSeconds);
+
+            // The tests are released, then stopped at once.
+            pStartGate->open();
+
+            for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+            {
+                pScenario->stop(); // Ignore the result code.
+            }
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        fprintf(stderr,
+                "The start time is passed by %llu ms, start now.\n",
+                getEpochMilliSeconds() - startMilliSeconds);
+
+        startMilliSeconds = getEpochMilliSeconds();
+
+        if (options.isTimeLimited)
+        {
+            fprintf(stderr,
+                    "The test period is shortened to %.3f s.\n",
+                    ((double)(endMilliSeconds - startMilliSeconds)) / 1000.);
+        }
+    }
+    else
+    {
+        endMilliSeconds = startMilliSeconds + (options.testsDuration * 1000LL);
+
+        writeMessage("Wait for the start time...\n");
+
+        // Note: the tests stopped before the start time are still
+        // started, then stopped at once.
+        stopSignal = waitForStopSignal(startMilliSeconds,
+                                       scenarii,
+                                       0LL);
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV Benchmark::start()
+{
+    CK_RV rv = CKR_OK;
+
+    writeTitle("Start the scenarii");
+
+    // The threads of the tests are created once, before their start.
+    rv = pThreadPool->reserve(options.totalTestsCount);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    // The threads of the tests are parked until the start gate is opened.
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        proftk_setContext(pScenario->getProfilingContext());
+
+        rv = pScenario->start();
+
+        proftk_setContext(PROFTK_DEFAULT_CONTEXT);
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    rv = setTestPeriod();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (options.isManySessions)
+    {
+        getProcessMemory(&processMemories[REPORT__MEMORY_STEP__TESTS_STARTED]);
+    }
+
+    if (pWatchdog != nullptr)
+    {
+        rv = pWatchdog->start();
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    pStartGate->open();
+
+    if (pScoreboard != nullptr)
+    {
+        pScoreboard->setState(WORKERS_BOARD__STATE__RUNNING,
+                              startMilliSeconds);
+    }
+
+    printCurrentTime("Begin time: ");
+
+EXIT:
+    return rv;
+}
+
+CK_RV Benchmark::stop()
+{
+    CK_RV rv = CKR_OK;
+
+    // The tests stopped by a signal are reported as well, up to their
+    // stop.
+    if (options.isTimeLimited ||
+        (stopSignal != 0))
+    {
+        writeTitle("Stop the scenarii");
+
+        for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+        {
+            rv = pScenario->stop();
+
+            if (rv != CKR_OK)
+            {
+                goto EXIT;
+            }
+        }
+    }
+
+    // Note: the stalls of the requests still in progress (if any) are
+    // not reported.
+    if (pWatchdog != nullptr)
+    {
+        pWatchdog->stop(); // Ignore the result code.
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV Benchmark::terminate(const CK_RV _rv)
+{
+    CK_RV rv = _rv;
+
+    writeTitle("Terminate");
+
+    // Release the tests still parked (e.g. if a scenario cannot start).
+    pStartGate->open();
+
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        if (pScenario->getState() != SCENARIO_STATE::Created)
+        {
+            CK_RV rv2 = CKR_OK;
+
+            proftk_setContext(pScenario->getProfilingContext());
+
+            rv2 = pScenario->terminate();
+
+            proftk_setContext(PROFTK_DEFAULT_CONTEXT);
+
+            if (rv2 != CKR_OK)
+            {
+                fprintf(stderr,
+                        "Cannot termine a scenario properly. ['0x%08lx']\n",
+                        rv2);
+
+                rv = CKR_GENERAL_ERROR;
+            }
+        }
+    }
+
+    writeMessage("Close the client library...\n");
+
+    {
+        // The first error (e.g. the one leading here) is kept.
+        const CK_RV rv2 = p11tk_terminate(sessionHandle);
+
+        if (rv2 != CKR_OK)
+        {
+            fprintf(stderr,
+                    "Cannot close the client library properly. ['0x%08lx']\n",
+                    rv2);
+
+            if (rv == CKR_OK)
+            {
+                rv = rv2;
+            }
+        }
+    }
+
+    if ((rv == CKR_OK) &&
+        (stopSignal != 0) &&
+        (pPublisher == nullptr))
+    {
+        // Note: the partial results merged by another process (e.g. the
+        // one of the workers) are not failures of this one.
+        rv = CKR_FUNCTION_CANCELED;
+    }
+
+    if (options.isProfiling)
+    {
+        writeTitle("PKCS#11 profile");
+
+        proftk_writeReport();
+    }
+
+    return rv;
+}
+
+CK_RV Benchmark::waitForStop()
+{
+    CK_RV rv = CKR_OK;
+
+    if (options.isTimeLimited)
+    {
+        // The test period ends at an absolute time, e.g. the same one for
+        // all the instances given the same start time, even the late ones.
+        writeMessage("Wait for the end of the test period...\n");
+
+        // Publish the statistics every second, e.g. for 'ha-bench top',
+        // for the progress written by the coordinator, or in case the
+        // process would not reach the end of the test period.
+        for (unsigned long long publicationMilliSeconds = startMilliSeconds + 1000LL;
+             (stopSignal == 0) && (publicationMilliSeconds < (endMilliSeconds + 1000LL));
+             publicationMilliSeconds += 1000LL)
+        {
+            // The last period is shorter if the test period is (e.g. for
+            // a late instance).
+            stopSignal = waitForStopSignal(std::min(publicationMilliSeconds,
+                                                    endMilliSeconds),
+                                           scenarii,
+                                           startMilliSeconds);
+
+            if (stopSignal != 0)
+            {
+                break;
+            }
+
+            const unsigned long elapsedMicroSeconds = (unsigned long)((getEpochMilliSeconds() - startMilliSeconds) * 1000LL);
+
+            if (pScoreboard != nullptr)
+            {
+                pScoreboard->publishLiveStatistics(scenarii,
+                                                   elapsedMicroSeconds);
+            }
+
+            if (pPublisher != nullptr)
+            {
+                pPublisher->publishLiveStatistics(scenarii,
+                                                  elapsedMicroSeconds);
+            }
+        }
+
+        if (stopSignal == 0)
+        {
+            writeMessage("");
+            writeMessage("End of test the period is reached.\n");
+        }
+    }
+    else
+    {
+        // The end of the tests is polled, so that they can be stopped
+        // by a signal before to reach their requests count.
+        while ((stopSignal == 0) &&
+               (!pThreadPool->waitForCompletion(getEpochMilliSeconds() + SIGNALS__POLLING_PERIOD)))
+        {
+            stopSignal = waitForStopSignal(0LL,
+                                           scenarii,
+                                           startMilliSeconds);
+        }
+
+        for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+        {
+            if (stopSignal != 0)
+            {
+                break;
+            }
+
+            rv = pScenario->waitForStop();
+
+            if (rv != CKR_OK)
+            {
+                goto EXIT;
+            }
+        }
+    }
+
+    printCurrentTime("End time: ");
+
+    if (options.isManySessions)
+    {
+        getProcessMemory(&processMemories[REPORT__MEMORY_STEP__TESTS_ENDED]);
+    }
+
+EXIT:
+    return rv;
+}
@@ -0,0 +1,131 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <memory>
+#include <vector>
+
+#include "benchmark-options.hpp"
+#include "model/results.hpp"
+#include "report.hpp"
+#include "scenarii/scenario-context.hpp"
+#include "scenarii/scenario.hpp"
+#include "scenarii/start-gate.hpp"
+#include "scenarii/thread-layout.hpp"
+#include "scenarii/thread-pool.hpp"
+#include "scenarii/top.hpp"
+#include "scenarii/watchdog.hpp"
+#include "workers/publisher.hpp"
+#include "workers/scoreboard.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+#include <toolkits/p11-toolkit.h>
+}
+
+/*
+ * Run of the scenarii given on the command line (see BenchmarkOptions), in
+ * this process or in worker processes (see '--processes').
+ *
+ * Notes:
+ *   - The steps are called in the order of their declaration; once the
+ *     client library is loaded, terminate() is always called last.
+ *   - A stop signal (see SIGINT and SIGTERM) received while the scenarii
+ *     are prepared or initialized ends the run (see isStopRequested()); once
+ *     they are started, their requests made so far are reported.
+ */
+class Benchmark : public Top
+{
+protected:
+    const BenchmarkOptions &options;
+
+    // Publisher of the results of the run, if merged by another process.
+    std::shared_ptr<Publisher> pPublisher = nullptr;
+
+    std::shared_ptr<StartGate> pStartGate = std::make_shared<StartGate>();
+    std::shared_ptr<ThreadLayout> pThreadLayout = std::make_shared<ThreadLayout>();
+    std::shared_ptr<ThreadPool> pThreadPool = nullptr;
+    std::shared_ptr<Watchdog> pWatchdog = nullptr;
+
+    // Note: the run goes on without scoreboard (e.g. no '/dev/shm').
+    std::shared_ptr<Scoreboard> pScoreboard = nullptr;
+
+    // Referred to by the scenarii, hence declared before them.
+    ScenarioContext scenarioContext;
+
+    std::vector<std::shared_ptr<Scenario>> scenarii = {};
+    std::vector<ScenarioResults> scenariiResults = {};
+
+    CK_SESSION_HANDLE sessionHandle = CK_INVALID_HANDLE;
+
+    // Test period, set once the tests are started.
+    unsigned long long startMilliSeconds = 0LL;
+    unsigned long long endMilliSeconds = 0LL;
+
+    PROCESS_MEMORY processMemories[REPORT__MEMORY_STEPS_COUNT] = {};
+
+    int stopSignal = 0;
+
+    // Members count of the HA group, 0 if unknown.
+    virtual unsigned long getMembersCount() const;
+
+    // Sets the test period from the start time given by '--start-at' or
+    // by the publisher, if any, a late instance starting at once and
+    // ending at the time shared with the other ones.
+    virtual CK_RV setTestPeriod();
+
+public:
+    // The options are kept until the benchmark is destroyed.
+    Benchmark(const BenchmarkOptions &options,
+              const std::shared_ptr<Publisher> &pPublisher);
+    ~Benchmark() override;
+
+    Benchmark(const Benchmark &) = delete;
+    Benchmark &operator=(const Benchmark &) = delete;
+
+    // Configures the placement of the threads.
+    virtual CK_RV configure();
+
+    // Builds the scenarii again, e.g. in a worker so that their UUIDs are
+    // its own.
+    virtual CK_RV createScenarii();
+
+    // Applies the thread layout to this thread and blocks the signals, both
+    // being inherited by the threads created from now on (e.g. by the
+    // client library).
+    virtual CK_RV applyThreadLayout();
+
+    // Forks the workers: the parent process only reports their merged
+    // results, then returns, while the workers go on with the next steps.
+    virtual CK_RV runWorkers(bool &isWorker);
+
+    // Loads the provider and checks the password.
+    virtual CK_RV load();
+
+    virtual CK_RV prepare();
+    virtual CK_RV initialize();
+    virtual CK_RV start();
+    virtual CK_RV waitForStop();
+    virtual CK_RV stop();
+
+    // Writes the report, and publishes the results.
+    virtual CK_RV report();
+
+    // Terminates the scenarii and closes the client library, returning the
+    // result of the run given the one of the previous steps ('rv').
+    virtual CK_RV terminate(const CK_RV rv);
+
+    virtual bool isStopRequested() const;
+};
+
+#endif /* BENCHMARK_HPP */
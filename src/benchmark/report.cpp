@@ -0,0 +1,596 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sys/resource.h>
+
+#include "report.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+void checkClientLimits(const CK_SLOT_ID slotId,
+                       const size_t testsCount,
+                       const size_t stackSize)
+{
+    CK_TOKEN_INFO tokenInfo = {};
+    struct rlimit processesLimit = {};
+    PROCESS_MEMORY processMemory = {};
+    unsigned long threadsMaximum = 0L;
+    unsigned long mapsMaximum = 0L;
+
+    writeMessage("Client limits:\n");
+
+    // Each test opens a session of its own.
+    if (p11tk_getTokenInfo(slotId,
+                           &tokenInfo) == CKR_OK)
+    {
+        fprintf(stdout,
+                "  Sessions: %ld for the tests, %ld opened of %ld on the token\n",
+                testsCount,
+                tokenInfo.usSessionCount,
+                tokenInfo.usMaxSessionCount);
+
+        // Note: 0 stands for an effectively infinite maximum.
+        if ((tokenInfo.usMaxSessionCount != 0) &&
+            (tokenInfo.usMaxSessionCount != CK_UNAVAILABLE_INFORMATION) &&
+            ((tokenInfo.usSessionCount + testsCount) > tokenInfo.usMaxSessionCount))
+        {
+            fprintf(stderr,
+                    "The sessions of the tests exceed the maximum sessions count of the token (%ld).\n",
+                    tokenInfo.usMaxSessionCount);
+        }
+    }
+
+    getProcessMemory(&processMemory);
+
+    {
+        std::ifstream threadsMaximumFile("/proc/sys/kernel/threads-max");
+        std::ifstream mapsMaximumFile("/proc/sys/vm/max_map_count");
+
+        threadsMaximumFile >> threadsMaximum;
+        mapsMaximumFile >> mapsMaximum;
+    }
+
+    getrlimit(RLIMIT_NPROC,
+              &processesLimit);
+
+    fprintf(stdout,
+            "  Threads : %ld for the tests, %ld running, %ld per user (RLIMIT_NPROC), %ld on the host\n",
+            testsCount,
+            processMemory.threadsCount,
+            (processesLimit.rlim_cur == RLIM_INFINITY) ? 0L : (unsigned long)processesLimit.rlim_cur,
+            threadsMaximum);
+    fprintf(stdout,
+            "  Stacks  : %ld KiB each, %ld MiB of virtual memory in total\n",
+            stackSize / 1024,
+            (testsCount * stackSize) / (1024 * 1024));
+
+    // Note: the threads of the other processes of the user are counted too.
+    if ((processesLimit.rlim_cur != RLIM_INFINITY) &&
+        ((processMemory.threadsCount + testsCount) > processesLimit.rlim_cur))
+    {
+        fprintf(stderr,
+                "The threads of the tests exceed the RLIMIT_NPROC limit (%ld, see 'ulimit -u').\n",
+                (unsigned long)processesLimit.rlim_cur);
+    }
+
+    if ((threadsMaximum != 0L) &&
+        ((processMemory.threadsCount + testsCount) > threadsMaximum))
+    {
+        fprintf(stderr,
+                "The threads of the tests exceed the threads maximum of the host (%ld, see 'kernel.threads-max').\n",
+                threadsMaximum);
+    }
+
+    // Each thread maps its stack and a guard page.
+    if ((mapsMaximum != 0L) &&
+        ((2 * testsCount) > mapsMaximum))
+    {
+        fprintf(stderr,
+                "The stacks of the tests exceed the memory mappings maximum (%ld, see 'vm.max_map_count').\n",
+                mapsMaximum);
+    }
+}
+
+void getScenariiResults(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                        std::vector<ScenarioResults> &scenariiResults)
+{
+    assert(scenarii.size() == scenariiResults.size());
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        const std::shared_ptr<Scenario> &pScenario = scenarii[scenarioIndex];
+        const LatencyStatistics &requestsStatistics = pScenario->getRequestsStatistics();
+        ScenarioResults &scenarioResults = scenariiResults[scenarioIndex];
+
+        scenarioResults.duration = (((double)pScenario->getElapsedMicroSeconds()) / 1000000.);
+        scenarioResults.requestsCount = pScenario->getRequestsCount();
+        scenarioResults.errorsCount = pScenario->getErrorsCount();
+        scenarioResults.tps = pScenario->getTps();
+        scenarioResults.meanLatency = requestsStatistics.getMeanMicroSeconds();
+        scenarioResults.minLatency = requestsStatistics.getMinMicroSeconds();
+        scenarioResults.p50Latency = requestsStatistics.getPercentileMicroSeconds(50.0);
+        scenarioResults.p90Latency = requestsStatistics.getPercentileMicroSeconds(90.0);
+        scenarioResults.p99Latency = requestsStatistics.getPercentileMicroSeconds(99.0);
+        scenarioResults.maxLatency = requestsStatistics.getMaxMicroSeconds();
+        scenarioResults.verifiedCount = pScenario->getVerifiedOutputsCount();
+        scenarioResults.mismatchesCount = pScenario->getMismatchingOutputsCount();
+        scenarioResults.hasRequestsStatistics = true;
+        scenarioResults.requestsStatistics = requestsStatistics;
+    }
+}
+
+void writeGlobalCounters(const double totalDuration,
+                         const unsigned long totalRequestsCount,
+                         const unsigned long totalErrorsCount,
+                         const unsigned long totalMismatchesCount,
+                         const std::map<std::string, unsigned long> &mismatchesCounts,
+                         const double verificationRatio)
+{
+    writeMessage("Globally:\n");
+
+    fprintf(stdout,
+            "  Total   Duration       = %.2f seconds\n",
+            totalDuration);
+    fprintf(stdout,
+            "  Total   Requests Count = %ld\n",
+            totalRequestsCount);
+    fprintf(stdout,
+            "  Total   Errors   Count = %ld\n",
+            totalErrorsCount);
+
+    if (verificationRatio > 0.0)
+    {
+        fprintf(stdout,
+                "  Total   Mismatches     = %ld\n",
+                totalMismatchesCount);
+
+        for (const auto &algorithmMismatchesCount : mismatchesCounts)
+        {
+            if (!algorithmMismatchesCount.first.empty())
+            {
+                fprintf(stdout,
+                        "    %-20s = %ld\n",
+                        algorithmMismatchesCount.first.c_str(),
+                        algorithmMismatchesCount.second);
+            }
+        }
+    }
+    fprintf(stdout,
+            "  Overall TpS            = %ld\n",
+            (unsigned long)((double)(totalRequestsCount - totalErrorsCount) / totalDuration));
+}
+
+void writeMemoryReport(const PROCESS_MEMORY processMemories[REPORT__MEMORY_STEPS_COUNT],
+                       const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                       const size_t testsCount)
+{
+    static const char *const STEPS_NAMES[REPORT__MEMORY_STEPS_COUNT] = {"Provider loaded",
+                                                                         "Sessions opened",
+                                                                         "Tests started",
+                                                                         "Tests ended"};
+
+    writeMessage("Client memory (KiB):\n");
+
+    for (size_t stepIndex = 0; stepIndex < REPORT__MEMORY_STEPS_COUNT; stepIndex++)
+    {
+        fprintf(stdout,
+                "  %-16s: RSS = %ld, Virtual = %ld, Threads = %ld\n",
+                STEPS_NAMES[stepIndex],
+                processMemories[stepIndex].residentKiB,
+                processMemories[stepIndex].virtualKiB,
+                processMemories[stepIndex].threadsCount);
+    }
+
+    // The sessions are opened by the preparation of the tests, and their
+    // threads created by their start.
+    const long sessionsResidentKiB = (long)processMemories[REPORT__MEMORY_STEP__SESSIONS_OPENED].residentKiB -
+                                     (long)processMemories[REPORT__MEMORY_STEP__PROVIDER_LOADED].residentKiB;
+    const long threadsResidentKiB = (long)processMemories[REPORT__MEMORY_STEP__TESTS_STARTED].residentKiB -
+                                    (long)processMemories[REPORT__MEMORY_STEP__SESSIONS_OPENED].residentKiB;
+    const long threadsVirtualKiB = (long)processMemories[REPORT__MEMORY_STEP__TESTS_STARTED].virtualKiB -
+                                   (long)processMemories[REPORT__MEMORY_STEP__SESSIONS_OPENED].virtualKiB;
+
+    fprintf(stdout,
+            "  Per test session: RSS = %.1f (client library and scenario objects)\n",
+            (double)sessionsResidentKiB / (double)testsCount);
+    fprintf(stdout,
+            "  Per test thread : RSS = %.1f, Virtual = %.1f\n",
+            (double)threadsResidentKiB / (double)testsCount,
+            (double)threadsVirtualKiB / (double)testsCount);
+
+    size_t testsStateBytes = 0;
+
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        testsStateBytes += pScenario->getTestsStateBytes();
+    }
+
+    fprintf(stdout,
+            "  Per test state  : %.1f (ha-bench counters and latencies)\n",
+            ((double)testsStateBytes / 1024.) / (double)testsCount);
+    fprintf(stdout,
+            "  Peak RSS        : %ld\n",
+            processMemories[REPORT__MEMORY_STEP__TESTS_ENDED].peakResidentKiB);
+}
+
+void writeRunResults(const BenchmarkOptions &options,
+                     const ThreadLayout &threadLayout,
+                     const unsigned long membersCount,
+                     const std::vector<ScenarioResults> &scenariiResults)
+{
+    RunResults runResults = {};
+
+    runResults.provider = options.providerPath;
+    runResults.slotId = options.slotId;
+    runResults.membersCount = membersCount;
+    runResults.measureType = options.isTimeLimited ? "time-limited" : "request-limited";
+    runResults.measureObjective = options.isTimeLimited ? options.testsDuration : options.requestsCountPerTest;
+    runResults.isSharingObjects = options.isSharingObjects;
+    runResults.affinity = threadLayout.getAffinityDescription();
+    runResults.housekeepingCpus = threadLayout.getHousekeepingCpusDescription();
+    runResults.scheduling = threadLayout.getSchedulingDescription();
+    runResults.testsCpus = threadLayout.getTestsCpusDescription(0,
+                                                                options.totalTestsCount * options.processesCount);
+    runResults.scenarii = scenariiResults;
+
+    if (!runResults.write(options.jsonPath.c_str()))
+    {
+        fprintf(stderr,
+                "Cannot write the results to '%s'.\n",
+                options.jsonPath.c_str());
+    }
+}
+
+void writeScenariiReport(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                         const double verificationRatio)
+{
+    double totalDuration = 0.0;
+    unsigned long totalRequestsCount = 0L;
+    unsigned long totalErrorsCount = 0L;
+    unsigned long totalMismatchesCount = 0L;
+
+    // Per verified algorithm (e.g. 'COMP-128 v2').
+    std::map<std::string, unsigned long> mismatchesCounts = {};
+
+    writeMessage("Per scenario:\n");
+
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        const double duration = (((double)pScenario->getElapsedMicroSeconds()) / 1000000.);
+        const unsigned long requestsCount = pScenario->getRequestsCount();
+        const unsigned long errorsCount = pScenario->getErrorsCount();
+
+        fprintf(stdout,
+                "  %s:\n",
+                pScenario->getUniqueString().c_str());
+
+        writeScenarioCounters(duration,
+                              requestsCount,
+                              errorsCount,
+                              pScenario->getTps(),
+                              pScenario->getMinTestTps(),
+                              pScenario->getMaxTestTps(),
+                              pScenario->getMeanTestTps());
+
+        pScenario->writeStatistics();
+
+        if (totalDuration < duration)
+        {
+            totalDuration = duration;
+        }
+
+        totalRequestsCount += requestsCount;
+        totalErrorsCount += errorsCount;
+        totalMismatchesCount += pScenario->getMismatchingOutputsCount();
+
+        if (pScenario->getVerifiedOutputsCount() > 0)
+        {
+            mismatchesCounts[pScenario->getVerifiedAlgorithm()] += pScenario->getMismatchingOutputsCount();
+        }
+    }
+
+    writeGlobalCounters(totalDuration,
+                        totalRequestsCount,
+                        totalErrorsCount,
+                        totalMismatchesCount,
+                        mismatchesCounts,
+                        verificationRatio);
+}
+
+void writeScenarioCounters(const double duration,
+                           const unsigned long requestsCount,
+                           const unsigned long errorsCount,
+                           const unsigned long tps,
+                           const unsigned long minTestTps,
+                           const unsigned long maxTestTps,
+                           const unsigned long meanTestTps)
+{
+    fprintf(stdout,
+            "    Duration              = %.3f seconds\n",
+            duration);
+    fprintf(stdout,
+            "    Requests Count        = %ld\n",
+            requestsCount);
+    fprintf(stdout,
+            "    Errors   Count        = %ld\n",
+            errorsCount);
+    fprintf(stdout,
+            "    TpS                   = %ld\n",
+            tps);
+    fprintf(stdout,
+            "    Mininum  TpS per Test = %ld\n",
+            minTestTps);
+    fprintf(stdout,
+            "    Maxinum  Tps per Test = %ld\n",
+            maxTestTps);
+    fprintf(stdout,
+            "    Mean     TpS per Test = %ld\n",
+            meanTestTps);
+}
+
+void writeSlowestRequests(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                          const size_t slowestRequestsCount)
+{
+    // Slowest requests of all the scenarii, with the one of each.
+    std::vector<std::pair<SLOW_REQUEST, std::string>> slowestRequests = {};
+
+    for (const std::shared_ptr<Scenario> &pScenario : scenarii)
+    {
+        for (const SLOW_REQUEST &slowRequest : pScenario->getSlowestRequests())
+        {
+            slowestRequests.push_back(std::make_pair(slowRequest,
+                                                     pScenario->getUniqueString()));
+        }
+    }
+
+    std::sort(slowestRequests.begin(),
+              slowestRequests.end(),
+              [](const std::pair<SLOW_REQUEST, std::string> &left,
+                 const std::pair<SLOW_REQUEST, std::string> &right)
+              {
+                  return isSlowerRequest(left.first,
+                                         right.first);
+              });
+
+    if (slowestRequests.size() > slowestRequestsCount)
+    {
+        slowestRequests.resize(slowestRequestsCount);
+    }
+
+    writeMessage("Slowest requests:\n");
+
+    for (const std::pair<SLOW_REQUEST, std::string> &slowestRequest : slowestRequests)
+    {
+        char beginTime[EPOCH_MILLI_SECONDS_STRING_LENGTH] = {0};
+
+        formatEpochMilliSeconds(slowestRequest.first.beginEpochMilliSeconds,
+                                beginTime);
+
+        fprintf(stdout,
+                "  %s: %10ld us, %s, test %ld%s\n",
+                beginTime,
+                slowestRequest.first.microSeconds,
+                slowestRequest.second.c_str(),
+                slowestRequest.first.testIdentifier,
+                slowestRequest.first.isFailed ? " (failed)" : "");
+    }
+}
+
+void writeStalls(Watchdog &watchdog)
+{
+    std::vector<WATCHDOG_STALL> stalls = {};
+    unsigned long stallsCount = 0L;
+
+    watchdog.getStalls(stalls,
+                       stallsCount);
+
+    fprintf(stdout,
+            "Stalls (calls of at least %llu ms): %ld\n",
+            watchdog.stallMicroSeconds / 1000ULL,
+            stallsCount);
+
+    for (const WATCHDOG_STALL &stall : stalls)
+    {
+        char beginTime[EPOCH_MILLI_SECONDS_STRING_LENGTH] = {0};
+
+        formatEpochMilliSeconds(stall.beginEpochMilliSeconds,
+                                beginTime);
+
+        fprintf(stdout,
+                "  %s: %10llu us, %s, thread %d (%s), '0x%08lx'\n",
+                beginTime,
+                stall.microSeconds,
+                stall.functionName,
+                (int)stall.threadIdentifier,
+                stall.threadName,
+                stall.rv);
+    }
+
+    if (stalls.size() < stallsCount)
+    {
+        fprintf(stdout,
+                "  ... %ld more (not kept)\n",
+                stallsCount - (unsigned long)stalls.size());
+    }
+}
+
+void writeWorkersReport(const WorkersBoard &workersBoard,
+                        const std::vector<std::string> &workersNames,
+                        const std::vector<bool> &areWorkersFailed,
+                        const std::vector<std::string> &scenariiNames,
+                        const std::vector<std::string> &verifiedAlgorithms,
+                        const double verificationRatio,
+                        std::vector<ScenarioResults> &scenariiResults,
+                        unsigned long &membersCount)
+{
+    double totalDuration = 0.0;
+    unsigned long totalRequestsCount = 0L;
+    unsigned long totalErrorsCount = 0L;
+    unsigned long totalMismatchesCount = 0L;
+
+    // Per verified algorithm (e.g. 'COMP-128 v2').
+    std::map<std::string, unsigned long> mismatchesCounts = {};
+
+    membersCount = 0L;
+
+    for (size_t workerIndex = 0; workerIndex < workersBoard.workersCount; workerIndex++)
+    {
+        if (membersCount < workersBoard.getWorkerRecord(workerIndex).membersCount)
+        {
+            membersCount = workersBoard.getWorkerRecord(workerIndex).membersCount;
+        }
+    }
+
+    writeMessage("Per scenario (merged over the processes):\n");
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenariiNames.size(); scenarioIndex++)
+    {
+        ScenarioResults &scenarioResults = scenariiResults[scenarioIndex];
+        LatencyStatistics requestsStatistics;
+        unsigned long elapsedMicroSeconds = 0L;
+        unsigned long minTestTps = 0L;
+        unsigned long maxTestTps = 0L;
+        unsigned long meanTestTpsSum = 0L;
+        size_t reportedCount = 0;
+
+        scenarioResults.requestsCount = 0L;
+        scenarioResults.errorsCount = 0L;
+        scenarioResults.tps = 0L;
+        scenarioResults.verifiedCount = 0L;
+        scenarioResults.mismatchesCount = 0L;
+
+        // The workers that failed are accounted for their last published
+        // (i.e. live) statistics.
+        for (size_t workerIndex = 0; workerIndex < workersBoard.workersCount; workerIndex++)
+        {
+            const WORKERS_BOARD_SCENARIO_RECORD &record = workersBoard.getScenarioRecord(workerIndex,
+                                                                                         scenarioIndex);
+
+            if (elapsedMicroSeconds < record.elapsedMicroSeconds)
+            {
+                elapsedMicroSeconds = record.elapsedMicroSeconds;
+            }
+
+            scenarioResults.requestsCount += record.requestsCount;
+            scenarioResults.errorsCount += record.errorsCount;
+            scenarioResults.tps += record.tps;
+            scenarioResults.verifiedCount += record.verifiedCount;
+            scenarioResults.mismatchesCount += record.mismatchesCount;
+
+            requestsStatistics.mergeSnapshot(record.requestsStatistics);
+
+            if (areWorkersFailed[workerIndex])
+            {
+                continue;
+            }
+
+            if ((reportedCount == 0) ||
+                (minTestTps > record.minTestTps))
+            {
+                minTestTps = record.minTestTps;
+            }
+
+            if (maxTestTps < record.maxTestTps)
+            {
+                maxTestTps = record.maxTestTps;
+            }
+
+            meanTestTpsSum += record.meanTestTps;
+            reportedCount++;
+        }
+
+        scenarioResults.duration = (((double)elapsedMicroSeconds) / 1000000.);
+        scenarioResults.meanLatency = requestsStatistics.getMeanMicroSeconds();
+        scenarioResults.minLatency = requestsStatistics.getMinMicroSeconds();
+        scenarioResults.p50Latency = requestsStatistics.getPercentileMicroSeconds(50.0);
+        scenarioResults.p90Latency = requestsStatistics.getPercentileMicroSeconds(90.0);
+        scenarioResults.p99Latency = requestsStatistics.getPercentileMicroSeconds(99.0);
+        scenarioResults.maxLatency = requestsStatistics.getMaxMicroSeconds();
+        scenarioResults.hasRequestsStatistics = true;
+        scenarioResults.requestsStatistics = requestsStatistics;
+
+        fprintf(stdout,
+                "  %s:\n",
+                scenariiNames[scenarioIndex].c_str());
+
+        writeScenarioCounters(scenarioResults.duration,
+                              scenarioResults.requestsCount,
+                              scenarioResults.errorsCount,
+                              scenarioResults.tps,
+                              minTestTps,
+                              maxTestTps,
+                              (reportedCount > 0) ? (meanTestTpsSum / reportedCount) : 0L);
+
+        fprintf(stdout,
+                "    Latencies (micro-seconds, per successful request): Mean = %ld, P50 = %ld, P90 = %ld, P99 = %ld, Max = %ld\n",
+                scenarioResults.meanLatency,
+                scenarioResults.p50Latency,
+                scenarioResults.p90Latency,
+                scenarioResults.p99Latency,
+                scenarioResults.maxLatency);
+
+        if (verificationRatio > 0.0)
+        {
+            fprintf(stdout,
+                    "    Verified outputs: Verified = %ld, Mismatches = %ld\n",
+                    scenarioResults.verifiedCount,
+                    scenarioResults.mismatchesCount);
+        }
+
+        fprintf(stdout,
+                "    Per process:\n");
+
+        for (size_t workerIndex = 0; workerIndex < workersBoard.workersCount; workerIndex++)
+        {
+            const WORKERS_BOARD_SCENARIO_RECORD &record = workersBoard.getScenarioRecord(workerIndex,
+                                                                                         scenarioIndex);
+            LatencyStatistics workerRequestsStatistics;
+
+            workerRequestsStatistics.mergeSnapshot(record.requestsStatistics);
+
+            fprintf(stdout,
+                    "      %s: Requests = %ld, Errors = %ld, TpS = %ld, P99 = %ld%s\n",
+                    workersNames[workerIndex].c_str(),
+                    record.requestsCount,
+                    record.errorsCount,
+                    record.tps,
+                    workerRequestsStatistics.getPercentileMicroSeconds(99.0),
+                    areWorkersFailed[workerIndex] ? " (failed, partial)" : "");
+        }
+
+        if (totalDuration < scenarioResults.duration)
+        {
+            totalDuration = scenarioResults.duration;
+        }
+
+        totalRequestsCount += scenarioResults.requestsCount;
+        totalErrorsCount += scenarioResults.errorsCount;
+        totalMismatchesCount += scenarioResults.mismatchesCount;
+
+        if (scenarioResults.verifiedCount > 0)
+        {
+            mismatchesCounts[verifiedAlgorithms[scenarioIndex]] += scenarioResults.mismatchesCount;
+        }
+    }
+
+    writeGlobalCounters(totalDuration,
+                        totalRequestsCount,
+                        totalErrorsCount,
+                        totalMismatchesCount,
+                        mismatchesCounts,
+                        verificationRatio);
+}
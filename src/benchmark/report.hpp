@@ -0,0 +1,102 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef REPORT_HPP
+#define REPORT_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark-options.hpp"
+#include "model/results.hpp"
+#include "scenarii/scenario.hpp"
+#include "scenarii/thread-layout.hpp"
+#include "scenarii/watchdog.hpp"
+#include "workers/workers-board.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+#include <toolkits/p11-toolkit.h>
+}
+
+// Steps of a run at which the memory of the process is read (see
+// '--many-sessions').
+#define REPORT__MEMORY_STEP__PROVIDER_LOADED 0
+#define REPORT__MEMORY_STEP__SESSIONS_OPENED 1
+#define REPORT__MEMORY_STEP__TESTS_STARTED 2
+#define REPORT__MEMORY_STEP__TESTS_ENDED 3
+#define REPORT__MEMORY_STEPS_COUNT 4
+
+/*
+ * Report of a run, written on stdout (and in JSON with '--json'), of the
+ * scenarii of this process or merged from the ones of the workers or
+ * agents (see WorkersBoard).
+ */
+
+// Writes the client limits that the tests could exceed (see
+// '--many-sessions').
+void checkClientLimits(const CK_SLOT_ID slotId,
+                       const size_t testsCount,
+                       const size_t stackSize);
+
+// Fills the results of the scenarii, once stopped.
+void getScenariiResults(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                        std::vector<ScenarioResults> &scenariiResults);
+
+void writeGlobalCounters(const double totalDuration,
+                         const unsigned long totalRequestsCount,
+                         const unsigned long totalErrorsCount,
+                         const unsigned long totalMismatchesCount,
+                         const std::map<std::string, unsigned long> &mismatchesCounts,
+                         const double verificationRatio);
+
+void writeMemoryReport(const PROCESS_MEMORY processMemories[REPORT__MEMORY_STEPS_COUNT],
+                       const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                       const size_t testsCount);
+
+// Writes the results of the run to the file given by '--json'.
+void writeRunResults(const BenchmarkOptions &options,
+                     const ThreadLayout &threadLayout,
+                     const unsigned long membersCount,
+                     const std::vector<ScenarioResults> &scenariiResults);
+
+void writeScenariiReport(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                         const double verificationRatio);
+
+void writeScenarioCounters(const double duration,
+                           const unsigned long requestsCount,
+                           const unsigned long errorsCount,
+                           const unsigned long tps,
+                           const unsigned long minTestTps,
+                           const unsigned long maxTestTps,
+                           const unsigned long meanTestTps);
+
+// See '--slowest'.
+void writeSlowestRequests(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                          const size_t slowestRequestsCount);
+
+// See '--watchdog'.
+void writeStalls(Watchdog &watchdog);
+
+// Merges the results published on the board by the workers (or agents),
+// the failed ones being accounted for their last published statistics.
+void writeWorkersReport(const WorkersBoard &workersBoard,
+                        const std::vector<std::string> &workersNames,
+                        const std::vector<bool> &areWorkersFailed,
+                        const std::vector<std::string> &scenariiNames,
+                        const std::vector<std::string> &verifiedAlgorithms,
+                        const double verificationRatio,
+                        std::vector<ScenarioResults> &scenariiResults,
+                        unsigned long &membersCount);
+
+#endif /* REPORT_HPP */
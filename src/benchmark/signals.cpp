@@ -0,0 +1,155 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "signals.hpp"
+#include "workers/publisher.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+void blockSignals()
+{
+    sigset_t signals;
+
+    getHandledSignals(signals);
+
+    // Note: the threads created from now on are inheriting the mask, the
+    // signals being only received by the main thread (see pollSignal()).
+    pthread_sigmask(SIG_BLOCK,
+                    &signals,
+                    nullptr);
+}
+
+void getHandledSignals(sigset_t &signals)
+{
+    assert(&signals != nullptr);
+
+    sigemptyset(&signals);
+    sigaddset(&signals,
+              SIGINT);
+    sigaddset(&signals,
+              SIGTERM);
+    sigaddset(&signals,
+              SIGUSR1);
+}
+
+int pollSignal(const unsigned long long epochMilliSeconds)
+{
+    sigset_t signals;
+    struct timespec timeout = {};
+    const unsigned long long currentMilliSeconds = getEpochMilliSeconds();
+    int signalNumber = 0;
+
+    getHandledSignals(signals);
+
+    // Only checks the pending signals once the given time is passed.
+    if (epochMilliSeconds > currentMilliSeconds)
+    {
+        timeout.tv_sec = (time_t)((epochMilliSeconds - currentMilliSeconds) / 1000ULL);
+        timeout.tv_nsec = (long)(((epochMilliSeconds - currentMilliSeconds) % 1000ULL) * 1000000ULL);
+    }
+
+    do
+    {
+        signalNumber = sigtimedwait(&signals,
+                                    nullptr,
+                                    &timeout);
+    } while ((signalNumber == -1) &&
+             (errno == EINTR));
+
+    // EAGAIN once the given time is reached.
+    return (signalNumber == -1) ? 0 : signalNumber;
+}
+
+int waitForStopSignal(const unsigned long long epochMilliSeconds,
+                      const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                      const unsigned long long startMilliSeconds)
+{
+    while (true)
+    {
+        const int signalNumber = pollSignal(epochMilliSeconds);
+
+        if (signalNumber != SIGUSR1)
+        {
+            if (signalNumber != 0)
+            {
+                fprintf(stdout,
+                        "\n%s received: stop the tests.\n",
+                        strsignal(signalNumber));
+            }
+
+            return signalNumber;
+        }
+
+        if (startMilliSeconds == 0LL)
+        {
+            writeMessage("\nSnapshot: the tests are not started.\n");
+
+            fflush(stdout);
+
+            continue;
+        }
+
+        std::vector<std::string> scenariiNames = {};
+        std::vector<WORKERS_BOARD_SCENARIO_RECORD> records(scenarii.size());
+
+        for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+        {
+            scenariiNames.push_back(scenarii[scenarioIndex]->getUniqueString());
+
+            Publisher::getLiveRecord(*scenarii[scenarioIndex],
+                                     (unsigned long)((getEpochMilliSeconds() - startMilliSeconds) * 1000LL),
+                                     records[scenarioIndex]);
+        }
+
+        writeSnapshot(scenariiNames,
+                      records);
+    }
+}
+
+void writeSnapshot(const std::vector<std::string> &scenariiNames,
+                   const std::vector<WORKERS_BOARD_SCENARIO_RECORD> &records)
+{
+    assert(scenariiNames.size() == records.size());
+
+    fprintf(stdout,
+            "\nSnapshot (%lu s):\n",
+            records.empty() ? 0L : (records[0].elapsedMicroSeconds / 1000000L));
+
+    for (size_t scenarioIndex = 0; scenarioIndex < records.size(); scenarioIndex++)
+    {
+        const WORKERS_BOARD_SCENARIO_RECORD &record = records[scenarioIndex];
+        LatencyStatistics requestsStatistics;
+
+        requestsStatistics.mergeSnapshot(record.requestsStatistics);
+
+        fprintf(stdout,
+                "  %s: Requests = %ld, Errors = %ld, TpS = %ld, Latencies (micro-seconds): Mean = %ld, P50 = %ld, P90 = %ld, P99 = %ld, Max = %ld\n",
+                scenariiNames[scenarioIndex].c_str(),
+                record.requestsCount,
+                record.errorsCount,
+                record.tps,
+                requestsStatistics.getMeanMicroSeconds(),
+                requestsStatistics.getPercentileMicroSeconds(50.0),
+                requestsStatistics.getPercentileMicroSeconds(90.0),
+                requestsStatistics.getPercentileMicroSeconds(99.0),
+                requestsStatistics.getMaxMicroSeconds());
+    }
+
+    fflush(stdout);
+}
@@ -0,0 +1,53 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef SIGNALS_HPP
+#define SIGNALS_HPP
+
+#include <csignal>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "scenarii/scenario.hpp"
+#include "workers/workers-board.hpp"
+
+// Period at which the end of the request-limited tests is checked while
+// waiting for a signal.
+#define SIGNALS__POLLING_PERIOD 100
+
+/*
+ * Signals of a run: SIGINT and SIGTERM stop the tests, SIGUSR1 writes a
+ * snapshot of the running ones.
+ *
+ * Notes:
+ *   - The signals are blocked, then only received by the main thread when
+ *     it polls them.
+ */
+
+void blockSignals();
+
+void getHandledSignals(sigset_t &signals);
+
+// Returns the first signal received until the given time (once the pending
+// ones are checked if passed), 0 if none.
+int pollSignal(const unsigned long long epochMilliSeconds);
+
+// Writes the snapshots requested until the given time (if the tests are
+// started, i.e. 'startMilliSeconds' is not 0), and returns the stop signal
+// received meanwhile, 0 if none.
+int waitForStopSignal(const unsigned long long epochMilliSeconds,
+                      const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                      const unsigned long long startMilliSeconds);
+
+void writeSnapshot(const std::vector<std::string> &scenariiNames,
+                   const std::vector<WORKERS_BOARD_SCENARIO_RECORD> &records);
+
+#endif /* SIGNALS_HPP */
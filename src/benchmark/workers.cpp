@@ -0,0 +1,292 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "scenarii/latency-statistics.hpp"
+#include "signals.hpp"
+#include "workers.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+CK_RV forkWorkers(const size_t processesCount,
+                  std::vector<pid_t> &processesIdentifiers,
+                  bool &isWorker,
+                  size_t &workerIndex)
+{
+    assert(&processesIdentifiers != nullptr);
+    assert(&isWorker != nullptr);
+    assert(&workerIndex != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    isWorker = false;
+
+    for (workerIndex = 0; workerIndex < processesCount; workerIndex++)
+    {
+        // Before each fork (i.e. including the lines of the previous
+        // workers), otherwise the worker would write the buffered outputs
+        // again.
+        fflush(stdout);
+        fflush(stderr);
+
+        const pid_t processIdentifier = fork();
+
+        if (processIdentifier == 0)
+        {
+            isWorker = true;
+
+            break;
+        }
+
+        if (processIdentifier == -1)
+        {
+            fprintf(stderr,
+                    "Cannot fork the worker %ld.\n",
+                    workerIndex);
+
+            rv = CKR_GENERAL_ERROR;
+
+            break;
+        }
+
+        fprintf(stdout,
+                "Worker %ld: process %d\n",
+                workerIndex,
+                (int)processIdentifier);
+
+        processesIdentifiers.push_back(processIdentifier);
+    }
+
+    if ((!isWorker) &&
+        (rv != CKR_OK))
+    {
+        // The workers already forked are waiting to be started.
+        for (const pid_t processIdentifier : processesIdentifiers)
+        {
+            kill(processIdentifier,
+                 SIGKILL);
+            waitpid(processIdentifier,
+                    nullptr,
+                    0);
+        }
+    }
+
+    return rv;
+}
+
+int forwardSignals(const WorkersBoard &workersBoard,
+                   const std::vector<pid_t> &processesIdentifiers,
+                   const std::vector<std::string> &scenariiNames)
+{
+    int stopSignal = 0;
+
+    for (int signalNumber = pollSignal(0LL); signalNumber != 0; signalNumber = pollSignal(0LL))
+    {
+        if (signalNumber != SIGUSR1)
+        {
+            fprintf(stdout,
+                    "\n%s received: stop the workers.\n",
+                    strsignal(signalNumber));
+
+            for (const pid_t processIdentifier : processesIdentifiers)
+            {
+                kill(processIdentifier,
+                     signalNumber);
+            }
+
+            stopSignal = signalNumber;
+
+            continue;
+        }
+
+        // The outputs of the workers being discarded, the snapshot is made of
+        // the statistics they publish every second.
+        std::vector<WORKERS_BOARD_SCENARIO_RECORD> records(scenariiNames.size());
+
+        for (size_t scenarioIndex = 0; scenarioIndex < scenariiNames.size(); scenarioIndex++)
+        {
+            LatencyStatistics requestsStatistics;
+
+            for (size_t workerIndex = 0; workerIndex < processesIdentifiers.size(); workerIndex++)
+            {
+                const WORKERS_BOARD_SCENARIO_RECORD &record = workersBoard.getScenarioRecord(workerIndex,
+                                                                                             scenarioIndex);
+
+                if (records[scenarioIndex].elapsedMicroSeconds < record.elapsedMicroSeconds)
+                {
+                    records[scenarioIndex].elapsedMicroSeconds = record.elapsedMicroSeconds;
+                }
+
+                records[scenarioIndex].requestsCount += record.requestsCount;
+                records[scenarioIndex].errorsCount += record.errorsCount;
+                records[scenarioIndex].tps += record.tps;
+
+                requestsStatistics.mergeSnapshot(record.requestsStatistics);
+            }
+
+            requestsStatistics.getSnapshot(records[scenarioIndex].requestsStatistics);
+        }
+
+        writeSnapshot(scenariiNames,
+                      records);
+    }
+
+    return stopSignal;
+}
+
+CK_RV waitForWorkers(WorkersBoard &workersBoard,
+                     const std::vector<pid_t> &processesIdentifiers,
+                     const std::vector<std::string> &scenariiNames,
+                     std::vector<bool> &areWorkersFailed)
+{
+    CK_RV rv = CKR_OK;
+    std::vector<bool> areWorkersExited(processesIdentifiers.size(),
+                                       false);
+    int status = 0;
+    bool isStopRequested = false;
+
+    areWorkersFailed.assign(processesIdentifiers.size(),
+                            false);
+
+    // Start the tests once all the workers are ready, or exited (e.g. if
+    // they cannot prepare their scenarii).
+    while (true)
+    {
+        size_t readyCount = 0;
+
+        for (size_t workerIndex = 0; workerIndex < processesIdentifiers.size(); workerIndex++)
+        {
+            if (!areWorkersExited[workerIndex] &&
+                (waitpid(processesIdentifiers[workerIndex],
+                         &status,
+                         WNOHANG) == processesIdentifiers[workerIndex]))
+            {
+                areWorkersExited[workerIndex] = true;
+                areWorkersFailed[workerIndex] = !WIFEXITED(status) ||
+                                                (WEXITSTATUS(status) != 0);
+            }
+
+            if (areWorkersExited[workerIndex] ||
+                (workersBoard.getWorkerState(workerIndex) >= WORKERS_BOARD__STATE__READY))
+            {
+                readyCount++;
+            }
+        }
+
+        if (readyCount == processesIdentifiers.size())
+        {
+            break;
+        }
+
+        // Note: the workers stopped before the start are still started,
+        // their pending stop signal being then handled.
+        if (forwardSignals(workersBoard,
+                           processesIdentifiers,
+                           scenariiNames) != 0)
+        {
+            isStopRequested = true;
+        }
+
+        usleep(10000);
+    }
+
+    printCurrentTime("Begin time: ");
+
+    workersBoard.requestStart();
+
+    writeMessage("Wait for the end of the workers...\n");
+
+    // The signals received meanwhile (e.g. SIGTERM) are forwarded to the
+    // workers, so that they stop and publish their results.
+    while (true)
+    {
+        size_t exitedCount = 0;
+
+        for (size_t workerIndex = 0; workerIndex < processesIdentifiers.size(); workerIndex++)
+        {
+            if (!areWorkersExited[workerIndex])
+            {
+                const pid_t processIdentifier = waitpid(processesIdentifiers[workerIndex],
+                                                        &status,
+                                                        WNOHANG);
+
+                if (processIdentifier == processesIdentifiers[workerIndex])
+                {
+                    areWorkersExited[workerIndex] = true;
+                    areWorkersFailed[workerIndex] = !WIFEXITED(status) ||
+                                                    (WEXITSTATUS(status) != 0);
+                }
+                else if (processIdentifier == -1)
+                {
+                    areWorkersExited[workerIndex] = true;
+                    areWorkersFailed[workerIndex] = true;
+                }
+            }
+
+            if (areWorkersExited[workerIndex])
+            {
+                exitedCount++;
+            }
+        }
+
+        if (exitedCount == processesIdentifiers.size())
+        {
+            break;
+        }
+
+        if (forwardSignals(workersBoard,
+                           processesIdentifiers,
+                           scenariiNames) != 0)
+        {
+            isStopRequested = true;
+        }
+
+        usleep(10000);
+    }
+
+    for (size_t workerIndex = 0; workerIndex < processesIdentifiers.size(); workerIndex++)
+    {
+        // A worker may also exit before to publish its results.
+        if (workersBoard.getWorkerState(workerIndex) != WORKERS_BOARD__STATE__REPORTED)
+        {
+            areWorkersFailed[workerIndex] = true;
+        }
+
+        if (areWorkersFailed[workerIndex])
+        {
+            fprintf(stderr,
+                    "Worker %ld (process %d) failed.\n",
+                    workerIndex,
+                    (int)processesIdentifiers[workerIndex]);
+
+            rv = CKR_GENERAL_ERROR;
+        }
+    }
+
+    printCurrentTime("End time: ");
+
+    // The partial results of the workers are still reported.
+    if ((rv == CKR_OK) &&
+        isStopRequested)
+    {
+        rv = CKR_FUNCTION_CANCELED;
+    }
+
+    return rv;
+}
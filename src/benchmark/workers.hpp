@@ -0,0 +1,51 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef WORKERS_HPP
+#define WORKERS_HPP
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include "workers/workers-board.hpp"
+
+extern "C"
+{
+#include <toolkits/p11-toolkit.h>
+}
+
+/*
+ * Worker processes of a run (see '--processes'), sharing a board with the
+ * parent process (see WorkersBoard).
+ */
+
+// Forks the workers, the calling process going on as one of them if
+// 'isWorker', as their parent otherwise. The workers already forked are
+// killed if one cannot be.
+CK_RV forkWorkers(const size_t processesCount,
+                  std::vector<pid_t> &processesIdentifiers,
+                  bool &isWorker,
+                  size_t &workerIndex);
+
+// Forwards the stop signals received by the parent process to the workers,
+// and writes the snapshots requested; returns the last stop signal, 0 if
+// none.
+int forwardSignals(const WorkersBoard &workersBoard,
+                   const std::vector<pid_t> &processesIdentifiers,
+                   const std::vector<std::string> &scenariiNames);
+
+// Starts the workers once all of them are ready, then waits for their end.
+CK_RV waitForWorkers(WorkersBoard &workersBoard,
+                     const std::vector<pid_t> &processesIdentifiers,
+                     const std::vector<std::string> &scenariiNames,
+                     std::vector<bool> &areWorkersFailed);
+
+#endif /* WORKERS_HPP */
@@ -0,0 +1,51 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef COMMANDS_HPP
+#define COMMANDS_HPP
+
+#include <memory>
+
+#include "workers/publisher.hpp"
+
+/*
+ * Commands of 'ha-bench', each one writing its usage if its arguments are
+ * missing, and returning the exit code of the process.
+ */
+
+// Runs the agent of a coordinated run (see Coordinator).
+int runAgent(const int argc,
+             const char *const *const argv);
+
+// Runs the scenarii given on the command line, its results being published
+// (e.g. to a coordinator) if 'pAgentPublisher' is given.
+int runBenchmark(const int argc,
+                 const char *const *const argv,
+                 const std::shared_ptr<Publisher> &pAgentPublisher);
+
+// Runs the coordinator of the agents of a coordinated run.
+int runCoordinator(const int argc,
+                   const char *const *const argv);
+
+// Merges the results of several runs (see '--json').
+int runMerge(const int argc,
+             const char *const *const argv);
+
+// Fits a performance model of the appliances on the results of runs (see
+// '--json'), then predicts runs with the mock provider.
+int runModel(const int argc,
+             const char *const *const argv);
+
+// Writes the statistics of the instances running on this host (see
+// Scoreboard).
+int runTop(const int argc,
+           const char *const *const argv);
+
+#endif /* COMMANDS_HPP */
@@ -0,0 +1,326 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <strings.h>
+#include <unistd.h>
+#include <vector>
+
+#include "benchmark/report.hpp"
+#include "commands.hpp"
+#include "model/results.hpp"
+#include "workers/agent-publisher.hpp"
+#include "workers/control-channel.hpp"
+#include "workers/coordinator.hpp"
+#include "workers/workers-board.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+int runAgent(const int argc,
+             const char *const *const argv)
+{
+    std::shared_ptr<ControlChannel> pControlChannel = nullptr;
+    std::vector<std::string> items = {};
+    std::vector<std::vector<char>> benchmarkArguments = {};
+    std::vector<const char *> benchmarkArgv = {};
+    std::string line = {};
+    std::string keyword = {};
+    size_t optionsCount = 0;
+    size_t argumentsCount = 0;
+    char host[256] = {0};
+
+    if ((argc < 5) ||
+        (strncmp(argv[argc - 2],
+                 "--",
+                 2) == 0))
+    {
+        fprintf(stdout,
+                "%s agent <coordinator-host>\n\
+                 <coordinator-port>\n\
+                 [<option>]*\n\
+                 <slot-id>\n\
+                 <co-password>\n\
+\n\
+Registers to a coordinator (see '%s coordinator'), then runs the scenarii\n\
+it sends, with the options it sends (e.g. '--verify') after the ones given\n\
+here (e.g. '--provider'), starting the tests at the time it chooses and\n\
+sending it the results. '--processes' is not supported.\n",
+                "ha-bench",
+                "ha-bench");
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    pControlChannel = ControlChannel::connect(argv[1],
+                                              argv[2]);
+
+    if (pControlChannel == nullptr)
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    gethostname(host,
+                sizeof(host) - 1);
+
+    if ((pControlChannel->send(std::string(CONTROL_CHANNEL__HELLO " ") +
+                               host +
+                               " " +
+                               std::to_string(getpid())) != CKR_OK) ||
+        (pControlChannel->receive(line) != CKR_OK))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    std::istringstream stream(line);
+
+    stream >> keyword >> optionsCount >> argumentsCount;
+
+    if (!stream ||
+        (keyword != CONTROL_CHANNEL__SPEC))
+    {
+        fprintf(stderr,
+                "Unexpected command of the coordinator ('%s').\n",
+                line.c_str());
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    // The command line of the run: the options of the agent, then the ones
+    // of the coordinator, the slot and password of the agent, and the
+    // arguments of the coordinator.
+    items.push_back(argv[0]);
+    items.insert(items.end(),
+                 argv + 3,
+                 argv + argc - 2);
+
+    for (size_t itemIndex = 0; itemIndex < (optionsCount + argumentsCount); itemIndex++)
+    {
+        if (pControlChannel->receive(line) != CKR_OK)
+        {
+            return CKR_GENERAL_ERROR;
+        }
+
+        if (itemIndex == optionsCount)
+        {
+            items.push_back(argv[argc - 2]);
+            items.push_back(argv[argc - 1]);
+        }
+
+        items.push_back(line);
+    }
+
+    // The arguments are modified by the run (e.g. tokenized).
+    for (const std::string &item : items)
+    {
+        benchmarkArguments.push_back(std::vector<char>(item.begin(),
+                                                       item.end()));
+        benchmarkArguments.back().push_back('\0');
+    }
+
+    for (std::vector<char> &benchmarkArgument : benchmarkArguments)
+    {
+        benchmarkArgv.push_back(benchmarkArgument.data());
+    }
+
+    return runBenchmark((int)benchmarkArgv.size(),
+                        benchmarkArgv.data(),
+                        std::make_shared<AgentPublisher>(pControlChannel));
+}
+
+int runCoordinator(const int argc,
+                   const char *const *const argv)
+{
+    std::string jsonPath = {};
+    std::vector<std::string> options = {};
+    std::vector<std::string> arguments = {};
+    std::vector<ScenarioResults> scenariiResults = {};
+    RunResults runResults = {};
+    const char *port = nullptr;
+    double verificationRatio = 0.0;
+    size_t agentsCount = 0;
+    CK_RV rv = CKR_OK;
+
+    int argi = 1;
+
+    if (((argi + 1) < argc) &&
+        (strcmp(argv[argi],
+                "--json") == 0))
+    {
+        jsonPath = argv[argi + 1];
+
+        argi += 2;
+    }
+
+    if ((argc - argi) < 2)
+    {
+        goto USAGE;
+    }
+
+    port = argv[argi];
+    agentsCount = (size_t)atol(argv[argi + 1]);
+
+    if ((agentsCount == 0) ||
+        (agentsCount > WORKERS_BOARD__MAXIMUM_WORKERS_COUNT))
+    {
+        fprintf(stderr,
+                "Invalid agents count: '%s'.\n",
+                argv[argi + 1]);
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    // The options of the run, sent to the agents with its arguments.
+    for (argi += 2; (argi < argc) && (strncmp(argv[argi], "--", 2) == 0); argi++)
+    {
+        options.push_back(argv[argi]);
+
+        if ((strcmp(argv[argi],
+                    "--profile") == 0) ||
+            ((argi + 1) >= argc))
+        {
+            continue;
+        }
+
+        if (strcmp(argv[argi],
+                   "--verify") == 0)
+        {
+            verificationRatio = atof(argv[argi + 1]);
+        }
+
+        options.push_back(argv[++argi]);
+    }
+
+    arguments.assign(argv + argi,
+                     argv + argc);
+
+    if (arguments.size() < 4)
+    {
+        goto USAGE;
+    }
+
+    for (size_t argumentIndex = 3; argumentIndex < arguments.size(); argumentIndex++)
+    {
+        const std::string &definition = arguments[argumentIndex];
+        const size_t firstSeparatorOffset = definition.find('x');
+        const size_t secondSeparatorOffset = definition.find('x',
+                                                             firstSeparatorOffset + 1);
+        ScenarioResults scenarioResults = {};
+
+        if ((firstSeparatorOffset == std::string::npos) ||
+            (secondSeparatorOffset == std::string::npos))
+        {
+            fprintf(stderr,
+                    "Invalid scenario description: '%s'.\n",
+                    definition.c_str());
+
+            return CKR_GENERAL_ERROR;
+        }
+
+        scenarioResults.scenario = definition.substr(0,
+                                                     firstSeparatorOffset);
+        scenarioResults.flags = definition.substr(firstSeparatorOffset + 1,
+                                                  secondSeparatorOffset - firstSeparatorOffset - 1);
+        scenarioResults.testsCount = strtoul(definition.c_str() + secondSeparatorOffset + 1,
+                                             nullptr,
+                                             10);
+        scenarioResults.mechanism = ScenarioResults::getMechanism(scenarioResults.scenario);
+
+        scenariiResults.push_back(scenarioResults);
+    }
+
+    {
+        Coordinator coordinator(port,
+                                agentsCount,
+                                options,
+                                arguments);
+
+        writeTitle("Register the agents");
+
+        rv = coordinator.listen();
+
+        if (rv == CKR_OK)
+        {
+            rv = coordinator.acceptAgents();
+        }
+
+        if (rv != CKR_OK)
+        {
+            return (int)rv;
+        }
+
+        writeTitle("Run the agents");
+
+        rv = coordinator.runAgents();
+
+        writeTitle("Report");
+
+        writeWorkersReport(coordinator.getWorkersBoard(),
+                           coordinator.getAgentsNames(),
+                           coordinator.getAreAgentsFailed(),
+                           coordinator.getScenariiNames(),
+                           coordinator.getVerifiedAlgorithms(),
+                           verificationRatio,
+                           scenariiResults,
+                           runResults.membersCount);
+    }
+
+    if (!jsonPath.empty())
+    {
+        runResults.measureType = arguments[0];
+        runResults.measureObjective = strtoul(arguments[1].c_str(),
+                                              nullptr,
+                                              10);
+        runResults.isSharingObjects = (strcasecmp(arguments[2].c_str(),
+                                                  "share") == 0);
+        runResults.scenarii = scenariiResults;
+
+        if (!runResults.write(jsonPath.c_str()))
+        {
+            fprintf(stderr,
+                    "Cannot write the results to '%s'.\n",
+                    jsonPath.c_str());
+        }
+    }
+
+    return (int)rv;
+
+USAGE:
+    fprintf(stdout,
+            "%s coordinator [--json <path>]\n\
+                       <port>\n\
+                       <agents-count>\n\
+                       [<option>]*\n\
+                       <measure-type>\n\
+                       <measure-objective>\n\
+                       <share>\n\
+                       {<scenario>x<flags>x<tests-count>}+\n\
+\n\
+Waits for the agents (see '%s agent'), sends them the options and the\n\
+arguments of the run (see '%s'), starts them together once they are all\n\
+initialized, writes their progress every second, then the report of their\n\
+merged results (and per agent). The clocks of the agents are expected to\n\
+be synchronized (e.g. NTP).\n\
+\n\
+Options:\n\
+  --json <path>    : write the merged results of the run to a JSON file.\n",
+            "ha-bench",
+            "ha-bench",
+            "ha-bench");
+
+    return CKR_GENERAL_ERROR;
+}
@@ -0,0 +1,258 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "commands.hpp"
+#include "model/results.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+int runMerge(const int argc,
+             const char *const *const argv)
+{
+    std::string jsonPath = {};
+    std::vector<std::string> paths = {};
+    std::vector<RunResults> runs = {};
+    RunResults mergedRun = {};
+
+    // Per merged scenario, the indexes of the run and of the scenario in
+    // the run of each merged one.
+    std::vector<std::vector<std::pair<size_t, size_t>>> mergedScenarii = {};
+
+    int argi = 1;
+
+    if (((argi + 1) < argc) &&
+        (strcmp(argv[argi],
+                "--json") == 0))
+    {
+        jsonPath = argv[argi + 1];
+
+        argi += 2;
+    }
+
+    if ((argi >= argc) ||
+        (strncmp(argv[argi],
+                 "--",
+                 2) == 0))
+    {
+        fprintf(stdout,
+                "%s merge [--json <path>]\n\
+                 {<results>}+\n\
+\n\
+Merges the results of runs made at the same time (e.g. by several instances\n\
+on the same host), written with '--json': the counters and the TpS of the\n\
+same scenario (and flags) are added, and its latencies are computed from\n\
+the merged histograms.\n\
+\n\
+Options:\n\
+  --json <path>    : write the merged results to a JSON file.\n\
+\n\
+Arguments:\n\
+  results          : results of a run.\n",
+                "ha-bench");
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    for (; argi < argc; argi++)
+    {
+        RunResults run = {};
+
+        if (!RunResults::read(argv[argi],
+                              run))
+        {
+            fprintf(stderr,
+                    "Cannot read the results '%s'.\n",
+                    argv[argi]);
+
+            return CKR_GENERAL_ERROR;
+        }
+
+        for (const ScenarioResults &scenarioResults : run.scenarii)
+        {
+            // Otherwise, only the averages could be added.
+            if (!scenarioResults.hasRequestsStatistics)
+            {
+                fprintf(stderr,
+                        "The results '%s' have no latencies histogram.\n",
+                        argv[argi]);
+
+                return CKR_GENERAL_ERROR;
+            }
+        }
+
+        if ((!runs.empty()) &&
+            (run.measureType != runs[0].measureType))
+        {
+            fprintf(stderr,
+                    "The results '%s' are not %s.\n",
+                    argv[argi],
+                    runs[0].measureType.c_str());
+
+            return CKR_GENERAL_ERROR;
+        }
+
+        paths.push_back(argv[argi]);
+        runs.push_back(run);
+    }
+
+    mergedRun.provider = runs[0].provider;
+    mergedRun.slotId = runs[0].slotId;
+    mergedRun.measureType = runs[0].measureType;
+    mergedRun.measureObjective = runs[0].measureObjective;
+    mergedRun.isSharingObjects = runs[0].isSharingObjects;
+    mergedRun.affinity = runs[0].affinity;
+    mergedRun.housekeepingCpus = runs[0].housekeepingCpus;
+    mergedRun.scheduling = runs[0].scheduling;
+
+    for (size_t runIndex = 0; runIndex < runs.size(); runIndex++)
+    {
+        if (mergedRun.membersCount < runs[runIndex].membersCount)
+        {
+            mergedRun.membersCount = runs[runIndex].membersCount;
+        }
+
+        for (size_t scenarioIndex = 0; scenarioIndex < runs[runIndex].scenarii.size(); scenarioIndex++)
+        {
+            const ScenarioResults &scenarioResults = runs[runIndex].scenarii[scenarioIndex];
+            size_t mergedIndex = 0;
+
+            while ((mergedIndex < mergedRun.scenarii.size()) &&
+                   ((mergedRun.scenarii[mergedIndex].scenario != scenarioResults.scenario) ||
+                    (mergedRun.scenarii[mergedIndex].flags != scenarioResults.flags)))
+            {
+                mergedIndex++;
+            }
+
+            if (mergedIndex == mergedRun.scenarii.size())
+            {
+                ScenarioResults mergedScenarioResults = {};
+
+                mergedScenarioResults.scenario = scenarioResults.scenario;
+                mergedScenarioResults.flags = scenarioResults.flags;
+                mergedScenarioResults.mechanism = scenarioResults.mechanism;
+                mergedScenarioResults.hasRequestsStatistics = true;
+
+                mergedRun.scenarii.push_back(mergedScenarioResults);
+                mergedScenarii.push_back({});
+            }
+
+            ScenarioResults &mergedScenarioResults = mergedRun.scenarii[mergedIndex];
+
+            if (mergedScenarioResults.duration < scenarioResults.duration)
+            {
+                mergedScenarioResults.duration = scenarioResults.duration;
+            }
+
+            mergedScenarioResults.testsCount += scenarioResults.testsCount;
+            mergedScenarioResults.requestsCount += scenarioResults.requestsCount;
+            mergedScenarioResults.errorsCount += scenarioResults.errorsCount;
+            mergedScenarioResults.tps += scenarioResults.tps;
+            mergedScenarioResults.verifiedCount += scenarioResults.verifiedCount;
+            mergedScenarioResults.mismatchesCount += scenarioResults.mismatchesCount;
+            mergedScenarioResults.requestsStatistics.merge(scenarioResults.requestsStatistics);
+
+            mergedScenarii[mergedIndex].push_back(std::make_pair(runIndex,
+                                                                 scenarioIndex));
+        }
+    }
+
+    writeMessage("Per scenario (merged over the runs):\n");
+
+    for (size_t mergedIndex = 0; mergedIndex < mergedRun.scenarii.size(); mergedIndex++)
+    {
+        ScenarioResults &mergedScenarioResults = mergedRun.scenarii[mergedIndex];
+        const LatencyStatistics &requestsStatistics = mergedScenarioResults.requestsStatistics;
+
+        mergedScenarioResults.meanLatency = requestsStatistics.getMeanMicroSeconds();
+        mergedScenarioResults.minLatency = requestsStatistics.getMinMicroSeconds();
+        mergedScenarioResults.p50Latency = requestsStatistics.getPercentileMicroSeconds(50.0);
+        mergedScenarioResults.p90Latency = requestsStatistics.getPercentileMicroSeconds(90.0);
+        mergedScenarioResults.p99Latency = requestsStatistics.getPercentileMicroSeconds(99.0);
+        mergedScenarioResults.maxLatency = requestsStatistics.getMaxMicroSeconds();
+
+        fprintf(stdout,
+                "  %s:\n",
+                mergedScenarioResults.getDefinition().c_str());
+        fprintf(stdout,
+                "    Duration              = %.3f seconds\n",
+                mergedScenarioResults.duration);
+        fprintf(stdout,
+                "    Requests Count        = %ld\n",
+                mergedScenarioResults.requestsCount);
+        fprintf(stdout,
+                "    Errors   Count        = %ld\n",
+                mergedScenarioResults.errorsCount);
+        fprintf(stdout,
+                "    TpS                   = %ld\n",
+                mergedScenarioResults.tps);
+        fprintf(stdout,
+                "    Latencies (micro-seconds, per successful request): Mean = %ld, P50 = %ld, P90 = %ld, P99 = %ld, Max = %ld\n",
+                mergedScenarioResults.meanLatency,
+                mergedScenarioResults.p50Latency,
+                mergedScenarioResults.p90Latency,
+                mergedScenarioResults.p99Latency,
+                mergedScenarioResults.maxLatency);
+
+        if (mergedScenarioResults.verifiedCount > 0)
+        {
+            fprintf(stdout,
+                    "    Verified outputs: Verified = %ld, Mismatches = %ld\n",
+                    mergedScenarioResults.verifiedCount,
+                    mergedScenarioResults.mismatchesCount);
+        }
+
+        fprintf(stdout,
+                "    Per run:\n");
+
+        for (const auto &runScenarioIndexes : mergedScenarii[mergedIndex])
+        {
+            const ScenarioResults &scenarioResults = runs[runScenarioIndexes.first].scenarii[runScenarioIndexes.second];
+
+            fprintf(stdout,
+                    "      %s (%s): Requests = %ld, Errors = %ld, TpS = %ld, P99 = %ld\n",
+                    paths[runScenarioIndexes.first].c_str(),
+                    scenarioResults.getDefinition().c_str(),
+                    scenarioResults.requestsCount,
+                    scenarioResults.errorsCount,
+                    scenarioResults.tps,
+                    scenarioResults.p99Latency);
+        }
+    }
+
+    writeMessage("Globally:\n");
+
+    fprintf(stdout,
+            "  Total   Duration       = %.2f seconds\n",
+            mergedRun.getDuration());
+    fprintf(stdout,
+            "  Overall TpS            = %ld\n",
+            mergedRun.getTps());
+
+    if ((!jsonPath.empty()) &&
+        (!mergedRun.write(jsonPath.c_str())))
+    {
+        fprintf(stderr,
+                "Cannot write the results to '%s'.\n",
+                jsonPath.c_str());
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    return CKR_OK;
+}
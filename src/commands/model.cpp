@@ -0,0 +1,265 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "commands.hpp"
+#include "model/performance-model.hpp"
+#include "model/results.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+int runModel(const int argc,
+             const char *const *const argv)
+{
+    std::string mockPath = {};
+    unsigned long membersCount = 0L;
+    std::vector<std::string> mix = {};
+    unsigned int duration = 10;
+    std::vector<std::string> heldOutPaths = {};
+    std::vector<RunResults> runs = {};
+    std::vector<RunResults> heldOutRuns = {};
+    PerformanceModel performanceModel = {};
+
+    int argi = 1;
+
+    while (((argi + 1) < argc) &&
+           (strncmp(argv[argi],
+                    "--",
+                    2) == 0))
+    {
+        if (strcmp(argv[argi],
+                   "--mock") == 0)
+        {
+            mockPath = argv[argi + 1];
+        }
+        else if (strcmp(argv[argi],
+                        "--members") == 0)
+        {
+            membersCount = strtoul(argv[argi + 1],
+                                   nullptr,
+                                   10);
+        }
+        else if (strcmp(argv[argi],
+                        "--mix") == 0)
+        {
+            std::string definitions = argv[argi + 1];
+            size_t separatorOffset = 0;
+
+            while ((separatorOffset = definitions.find(',')) != std::string::npos)
+            {
+                mix.push_back(definitions.substr(0, separatorOffset));
+                definitions.erase(0, separatorOffset + 1);
+            }
+
+            mix.push_back(definitions);
+        }
+        else if (strcmp(argv[argi],
+                        "--duration") == 0)
+        {
+            duration = (unsigned int)atoi(argv[argi + 1]);
+        }
+        else if (strcmp(argv[argi],
+                        "--held-out") == 0)
+        {
+            heldOutPaths.push_back(argv[argi + 1]);
+        }
+        else
+        {
+            break;
+        }
+
+        argi += 2;
+    }
+
+    if ((argi >= argc) ||
+        (strncmp(argv[argi],
+                 "--",
+                 2) == 0))
+    {
+        fprintf(stdout,
+                "%s model [<option>]*\n\
+                 {<results>}+\n\
+\n\
+Fits a performance model of the appliances (per mechanism service time,\n\
+concurrency per appliance) on results written with '--json', then predicts\n\
+runs by playing the model with the mock provider.\n\
+\n\
+Options:\n\
+  --mock <path>    : mock provider library, required for the predictions;\n\
+                     also measures the client overhead, subtracted from the\n\
+                     service times, and checks that the model reproduces\n\
+                     the calibration runs (TpS within 10%%, P99 within\n\
+                     25%%).\n\
+  --members <n>    : members count of the predicted run (default: the one of\n\
+                     the first results).\n\
+  --mix <scenario>x<flags>x<tests-count>[,<scenario>x<flags>x<tests-count>]*\n\
+                   : scenarii of the predicted run.\n\
+  --duration <s>   : duration of each predicted run (default: 10).\n\
+  --held-out <results>\n\
+                   : results, not used to fit the model, to compare with\n\
+                     their prediction (can be repeated).\n\
+\n\
+Arguments:\n\
+  results          : results of isolated runs (a single scenario among\n\
+                     'comp-128', 'milenage', 'TUAK', 'SUCI', 'milenage-resync'\n\
+                     and 'TUAK-resync', without error), the least loaded one\n\
+                     of each mechanism giving its service time and the most\n\
+                     loaded ones the concurrency.\n",
+                "ha-bench");
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    if (((!mix.empty()) || (!heldOutPaths.empty())) &&
+        mockPath.empty())
+    {
+        writeError("The predictions require the mock provider ('--mock').\n");
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    if ((duration == 0) ||
+        (duration > 3600))
+    {
+        fprintf(stderr,
+                "Invalid duration: '%u'.\n",
+                duration);
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    for (; argi < argc; argi++)
+    {
+        RunResults run = {};
+
+        if (!RunResults::read(argv[argi],
+                              run))
+        {
+            fprintf(stderr,
+                    "Cannot read the results '%s'.\n",
+                    argv[argi]);
+
+            return CKR_GENERAL_ERROR;
+        }
+
+        runs.push_back(run);
+    }
+
+    for (const std::string &heldOutPath : heldOutPaths)
+    {
+        RunResults run = {};
+
+        if (!RunResults::read(heldOutPath.c_str(),
+                              run))
+        {
+            fprintf(stderr,
+                    "Cannot read the results '%s'.\n",
+                    heldOutPath.c_str());
+
+            return CKR_GENERAL_ERROR;
+        }
+
+        heldOutRuns.push_back(run);
+    }
+
+    writeTitle("Model");
+
+    if (!performanceModel.fit(runs,
+                              mockPath.empty() ? nullptr : mockPath.c_str(),
+                              duration))
+    {
+        writeError("No mechanism can be fitted: isolated runs without error, with a known members count, are required.\n");
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    performanceModel.write();
+
+    // The model must at least reproduce the runs it is fitted on.
+    if (!mockPath.empty())
+    {
+        writeTitle("Check on the calibration runs");
+
+        if (!performanceModel.checkCalibrationRuns(mockPath.c_str(),
+                                                   duration))
+        {
+            return CKR_GENERAL_ERROR;
+        }
+    }
+
+    if (!mix.empty())
+    {
+        RunResults prediction = {};
+
+        if (membersCount == 0)
+        {
+            membersCount = runs[0].membersCount;
+        }
+
+        writeTitle("Prediction");
+
+        fprintf(stdout,
+                "Predict %lu members for %u seconds...\n",
+                membersCount,
+                duration);
+
+        if (!performanceModel.predict(mockPath.c_str(),
+                                      membersCount,
+                                      mix,
+                                      duration,
+                                      prediction))
+        {
+            return CKR_GENERAL_ERROR;
+        }
+
+        for (const ScenarioResults &scenarioResults : prediction.scenarii)
+        {
+            fprintf(stdout,
+                    "  %s:\n",
+                    scenarioResults.getDefinition().c_str());
+            fprintf(stdout,
+                    "    TpS                   = %ld\n",
+                    scenarioResults.tps);
+            fprintf(stdout,
+                    "    Latencies (micro-seconds): Mean = %ld, P50 = %ld, P90 = %ld, P99 = %ld\n",
+                    scenarioResults.meanLatency,
+                    scenarioResults.p50Latency,
+                    scenarioResults.p90Latency,
+                    scenarioResults.p99Latency);
+        }
+
+        fprintf(stdout,
+                "  Overall TpS             = %ld\n",
+                prediction.getTps());
+    }
+
+    if (!heldOutRuns.empty())
+    {
+        writeTitle("Validation on the held-out runs");
+
+        if (!performanceModel.validate(mockPath.c_str(),
+                                       heldOutRuns,
+                                       heldOutPaths,
+                                       duration))
+        {
+            return CKR_GENERAL_ERROR;
+        }
+    }
+
+    return CKR_OK;
+}
@@ -0,0 +1,197 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "commands.hpp"
+#include "workers/scoreboard.hpp"
+#include "workers/workers-board.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+int runTop(const int argc,
+           const char *const *const argv)
+{
+    static const char *const STATES_NAMES[] = {"preparing",
+                                               "waiting for the start",
+                                               "running",
+                                               "finished"};
+
+    unsigned int interval = 1;
+    unsigned long refreshesCount = 0L;
+
+    // Records of the previous refresh, per scoreboard, for the TpS of the
+    // last interval.
+    std::map<std::string, std::vector<SCOREBOARD_SCENARIO_RECORD>> previousRecords = {};
+
+    int argi = 1;
+
+    while (((argi + 1) < argc) &&
+           (strncmp(argv[argi],
+                    "--",
+                    2) == 0))
+    {
+        if (strcmp(argv[argi],
+                   "--interval") == 0)
+        {
+            interval = (unsigned int)atoi(argv[argi + 1]);
+        }
+        else if (strcmp(argv[argi],
+                        "--count") == 0)
+        {
+            refreshesCount = strtoul(argv[argi + 1],
+                                     nullptr,
+                                     10);
+        }
+        else
+        {
+            break;
+        }
+
+        argi += 2;
+    }
+
+    if ((argi != argc) ||
+        (interval == 0))
+    {
+        fprintf(stdout,
+                "%s top [<option>]*\n\
+\n\
+Writes, at each interval, the statistics published by the instances running\n\
+on this host (see '" SCOREBOARD__DIRECTORY "/" SCOREBOARD__FILE_PREFIX "<process>'), per instance and\n\
+scenario, then in total (the latencies histograms being merged). The TpS\n\
+are the ones of the last interval (or the mean ones once an instance is\n\
+finished); the statistics of the instances running request-limited tests\n\
+are only published once they are finished.\n\
+\n\
+Options:\n\
+  --interval <s>   : refresh interval (default: 1).\n\
+  --count <n>      : number of refreshes (default: 0, i.e. until\n\
+                     interrupted).\n",
+                "ha-bench");
+
+        return CKR_GENERAL_ERROR;
+    }
+
+    for (unsigned long refreshIndex = 0; (refreshesCount == 0L) || (refreshIndex < refreshesCount); refreshIndex++)
+    {
+        std::map<std::string, std::vector<SCOREBOARD_SCENARIO_RECORD>> currentRecords = {};
+        LatencyStatistics totalRequestsStatistics;
+        unsigned long totalRequestsCount = 0L;
+        unsigned long totalErrorsCount = 0L;
+        unsigned long totalTps = 0L;
+        size_t instancesCount = 0;
+
+        if (refreshIndex > 0)
+        {
+            sleep(interval);
+        }
+
+        writeMessage("");
+        printCurrentTime("Time: ");
+
+        for (const std::string &path : Scoreboard::getPaths())
+        {
+            Scoreboard scoreboard;
+            SCOREBOARD_HEADER header = {};
+            std::vector<SCOREBOARD_SCENARIO_RECORD> records = {};
+
+            if ((scoreboard.open(path) != CKR_OK) ||
+                (!scoreboard.read(header,
+                                  records)))
+            {
+                continue;
+            }
+
+            // Left by a killed instance.
+            if ((kill(header.processIdentifier,
+                      0) == -1) &&
+                (errno == ESRCH))
+            {
+                unlink(path.c_str());
+
+                continue;
+            }
+
+            const auto previousRecordsIterator = previousRecords.find(path);
+            const bool isPreviousKnown = (previousRecordsIterator != previousRecords.end()) &&
+                                         (previousRecordsIterator->second.size() == records.size());
+
+            fprintf(stdout,
+                    "  Process %d (%s, %lu s):\n",
+                    (int)header.processIdentifier,
+                    ((header.state >= 0) && (header.state <= WORKERS_BOARD__STATE__REPORTED)) ? STATES_NAMES[header.state] : "unknown",
+                    records.empty() ? 0L : (records[0].record.elapsedMicroSeconds / 1000000L));
+
+            for (size_t scenarioIndex = 0; scenarioIndex < records.size(); scenarioIndex++)
+            {
+                const WORKERS_BOARD_SCENARIO_RECORD &record = records[scenarioIndex].record;
+                LatencyStatistics requestsStatistics;
+                unsigned long tps = record.tps;
+
+                if (isPreviousKnown &&
+                    (header.state == WORKERS_BOARD__STATE__RUNNING))
+                {
+                    const WORKERS_BOARD_SCENARIO_RECORD &previousRecord = previousRecordsIterator->second[scenarioIndex].record;
+
+                    if ((record.elapsedMicroSeconds > previousRecord.elapsedMicroSeconds) &&
+                        ((record.requestsCount - record.errorsCount) >= (previousRecord.requestsCount - previousRecord.errorsCount)))
+                    {
+                        tps = (unsigned long)((double)((record.requestsCount - record.errorsCount) - (previousRecord.requestsCount - previousRecord.errorsCount)) /
+                                              ((double)(record.elapsedMicroSeconds - previousRecord.elapsedMicroSeconds) / 1000000.));
+                    }
+                }
+
+                requestsStatistics.mergeSnapshot(record.requestsStatistics);
+                totalRequestsStatistics.mergeSnapshot(record.requestsStatistics);
+
+                fprintf(stdout,
+                        "    %s: Requests = %ld, Errors = %ld, TpS = %ld, P99 = %ld\n",
+                        records[scenarioIndex].definition,
+                        record.requestsCount,
+                        record.errorsCount,
+                        tps,
+                        requestsStatistics.getPercentileMicroSeconds(99.0));
+
+                totalRequestsCount += record.requestsCount;
+                totalErrorsCount += record.errorsCount;
+                totalTps += tps;
+            }
+
+            currentRecords[path] = records;
+            instancesCount++;
+        }
+
+        fprintf(stdout,
+                "  Total (%ld instance(s)): Requests = %ld, Errors = %ld, TpS = %ld, P99 = %ld\n",
+                instancesCount,
+                totalRequestsCount,
+                totalErrorsCount,
+                totalTps,
+                totalRequestsStatistics.getPercentileMicroSeconds(99.0));
+
+        fflush(stdout);
+
+        previousRecords = currentRecords;
+    }
+
+    return CKR_OK;
+}
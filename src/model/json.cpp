@@ -0,0 +1,407 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "json.hpp"
+
+JsonValue::JsonValue() = default;
+
+JsonValue::JsonValue(const JsonValue &) = default;
+
+JsonValue &JsonValue::operator=(const JsonValue &) = default;
+
+JsonValue::~JsonValue() = default;
+
+const JsonValue *JsonValue::getMember(const char *const name) const
+{
+    if (type != JSON_TYPE::Object)
+    {
+        return nullptr;
+    }
+
+    for (const std::pair<std::string, JsonValue> &member : members)
+    {
+        if (member.first == name)
+        {
+            return &member.second;
+        }
+    }
+
+    return nullptr;
+}
+
+double JsonValue::getNumber(const char *const name,
+                            const double defaultValue) const
+{
+    const JsonValue *const pMember = getMember(name);
+
+    return ((pMember != nullptr) && (pMember->type == JSON_TYPE::Number)) ? pMember->number : defaultValue;
+}
+
+std::string JsonValue::getString(const char *const name,
+                                 const std::string &defaultValue) const
+{
+    const JsonValue *const pMember = getMember(name);
+
+    return ((pMember != nullptr) && (pMember->type == JSON_TYPE::String)) ? pMember->string : defaultValue;
+}
+
+bool JsonValue::parse(const std::string &text,
+                      JsonValue &value)
+{
+    size_t offset = 0;
+
+    if (!parseValue(text,
+                    offset,
+                    value))
+    {
+        return false;
+    }
+
+    skipSpaces(text,
+               offset);
+
+    return offset == text.size();
+}
+
+bool JsonValue::parseFile(const char *const path,
+                          JsonValue &value)
+{
+    std::ifstream file(path);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    std::stringstream text;
+
+    text << file.rdbuf();
+
+    return parse(text.str(),
+                 value);
+}
+
+bool JsonValue::parseString(const std::string &text,
+                            size_t &offset,
+                            std::string &value)
+{
+    if ((offset >= text.size()) || (text[offset] != '"'))
+    {
+        return false;
+    }
+
+    offset++;
+
+    value.clear();
+
+    while (offset < text.size())
+    {
+        const char character = text[offset++];
+
+        if (character == '"')
+        {
+            return true;
+        }
+
+        if (character != '\\')
+        {
+            value += character;
+
+            continue;
+        }
+
+        if (offset >= text.size())
+        {
+            return false;
+        }
+
+        const char escapedCharacter = text[offset++];
+
+        switch (escapedCharacter)
+        {
+        case 'b':
+            value += '\b';
+
+            break;
+
+        case 'f':
+            value += '\f';
+
+            break;
+
+        case 'n':
+            value += '\n';
+
+            break;
+
+        case 'r':
+            value += '\r';
+
+            break;
+
+        case 't':
+            value += '\t';
+
+            break;
+
+        case 'u':
+        {
+            if ((offset + 4) > text.size())
+            {
+                return false;
+            }
+
+            const unsigned long codePoint = strtoul(text.substr(offset, 4).c_str(),
+                                                    nullptr,
+                                                    16);
+
+            value += (codePoint < 0x80) ? (char)codePoint : '?';
+            offset += 4;
+
+            break;
+        }
+
+        default:
+            value += escapedCharacter;
+
+            break;
+        }
+    }
+
+    return false;
+}
+
+bool JsonValue::parseValue(const std::string &text,
+                           size_t &offset,
+                           JsonValue &value)
+{
+    skipSpaces(text,
+               offset);
+
+    if (offset >= text.size())
+    {
+        return false;
+    }
+
+    value = JsonValue();
+
+    switch (text[offset])
+    {
+    case '{':
+        value.type = JSON_TYPE::Object;
+        offset++;
+
+        skipSpaces(text,
+                   offset);
+
+        if ((offset < text.size()) && (text[offset] == '}'))
+        {
+            offset++;
+
+            return true;
+        }
+
+        while (true)
+        {
+            std::pair<std::string, JsonValue> member = {};
+
+            skipSpaces(text,
+                       offset);
+
+            if (!parseString(text,
+                             offset,
+                             member.first))
+            {
+                return false;
+            }
+
+            skipSpaces(text,
+                       offset);
+
+            if ((offset >= text.size()) || (text[offset] != ':'))
+            {
+                return false;
+            }
+
+            offset++;
+
+            if (!parseValue(text,
+                            offset,
+                            member.second))
+            {
+                return false;
+            }
+
+            value.members.push_back(member);
+
+            skipSpaces(text,
+                       offset);
+
+            if ((offset < text.size()) && (text[offset] == ','))
+            {
+                offset++;
+
+                continue;
+            }
+
+            if ((offset < text.size()) && (text[offset] == '}'))
+            {
+                offset++;
+
+                return true;
+            }
+
+            return false;
+        }
+
+    case '[':
+        value.type = JSON_TYPE::Array;
+        offset++;
+
+        skipSpaces(text,
+                   offset);
+
+        if ((offset < text.size()) && (text[offset] == ']'))
+        {
+            offset++;
+
+            return true;
+        }
+
+        while (true)
+        {
+            JsonValue element = {};
+
+            if (!parseValue(text,
+                            offset,
+                            element))
+            {
+                return false;
+            }
+
+            value.elements.push_back(element);
+
+            skipSpaces(text,
+                       offset);
+
+            if ((offset < text.size()) && (text[offset] == ','))
+            {
+                offset++;
+
+                continue;
+            }
+
+            if ((offset < text.size()) && (text[offset] == ']'))
+            {
+                offset++;
+
+                return true;
+            }
+
+            return false;
+        }
+
+    case '"':
+        value.type = JSON_TYPE::String;
+
+        return parseString(text,
+                           offset,
+                           value.string);
+
+    default:
+        break;
+    }
+
+    static const struct
+    {
+        const char *literal;
+        JSON_TYPE type;
+        bool boolean;
+    } JSON_LITERALS[] = {{"true", JSON_TYPE::Boolean, true},
+                         {"false", JSON_TYPE::Boolean, false},
+                         {"null", JSON_TYPE::Null, false}};
+
+    for (const auto &literal : JSON_LITERALS)
+    {
+        if (text.compare(offset,
+                         strlen(literal.literal),
+                         literal.literal) == 0)
+        {
+            value.type = literal.type;
+            value.boolean = literal.boolean;
+            offset += strlen(literal.literal);
+
+            return true;
+        }
+    }
+
+    const char *const begin = text.c_str() + offset;
+    char *end = nullptr;
+
+    value.type = JSON_TYPE::Number;
+    value.number = strtod(begin,
+                          &end);
+
+    if (end == begin)
+    {
+        return false;
+    }
+
+    offset += (size_t)(end - begin);
+
+    return true;
+}
+
+void JsonValue::skipSpaces(const std::string &text,
+                           size_t &offset)
+{
+    while ((offset < text.size()) &&
+           ((text[offset] == ' ') || (text[offset] == '\t') || (text[offset] == '\n') || (text[offset] == '\r')))
+    {
+        offset++;
+    }
+}
+
+void JsonValue::writeString(FILE *const file,
+                            const std::string &value)
+{
+    fputc('"',
+          file);
+
+    for (const char character : value)
+    {
+        if ((character == '"') || (character == '\\'))
+        {
+            fprintf(file,
+                    "\\%c",
+                    character);
+        }
+        else if ((unsigned char)character < 0x20)
+        {
+            fprintf(file,
+                    "\\u%04x",
+                    (unsigned int)character);
+        }
+        else
+        {
+            fputc(character,
+                  file);
+        }
+    }
+
+    fputc('"',
+          file);
+}
@@ -0,0 +1,85 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class JSON_TYPE
+{
+    Null = 0,
+    Boolean = 1,
+    Number = 2,
+    String = 3,
+    Array = 4,
+    Object = 5
+};
+
+/*
+ * Minimal JSON value, enough to read back the results written by HA-Bench.
+ *
+ * Notes:
+ *   - The '\u' escapes are only decoded for ASCII characters.
+ *   - The members of an object are kept in their order of appearance.
+ */
+class JsonValue
+{
+protected:
+    static bool parseValue(const std::string &text,
+                           size_t &offset,
+                           JsonValue &value);
+    static bool parseString(const std::string &text,
+                            size_t &offset,
+                            std::string &value);
+    static void skipSpaces(const std::string &text,
+                           size_t &offset);
+
+public:
+    JSON_TYPE type = JSON_TYPE::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string = {};
+    std::vector<JsonValue> elements = {};
+    std::vector<std::pair<std::string, JsonValue>> members = {};
+
+    // Note: the special members are not inlined (too large).
+    JsonValue();
+    JsonValue(const JsonValue &);
+    JsonValue &operator=(const JsonValue &);
+    ~JsonValue();
+
+    // Returns false if the text is not a single valid JSON value.
+    static bool parse(const std::string &text,
+                      JsonValue &value);
+
+    // Returns false if the file cannot be read or is not valid.
+    static bool parseFile(const char *const path,
+                          JsonValue &value);
+
+    // Writes a string with its quotes and escapes.
+    static void writeString(FILE *const file,
+                            const std::string &value);
+
+    // Returns nullptr if the value is not an object or has no such member.
+    const JsonValue *getMember(const char *const name) const;
+
+    // Return the default value if the member is missing or of another type.
+    double getNumber(const char *const name,
+                     const double defaultValue) const;
+    std::string getString(const char *const name,
+                          const std::string &defaultValue) const;
+};
+
+#endif /* JSON_HPP */
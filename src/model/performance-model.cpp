@@ -0,0 +1,564 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "performance-model.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+// Variables of the mock provider (see 'mock/p11-mock.h').
+#define PERFORMANCE_MODEL__SERVICE_TIME_VARIABLE "HA_BENCH_MOCK_SERVICE_TIME"
+#define PERFORMANCE_MODEL__CONCURRENCY_VARIABLE "HA_BENCH_MOCK_CONCURRENCY"
+#define PERFORMANCE_MODEL__MEMBERS_VARIABLE "HA_BENCH_MOCK_MEMBERS"
+#define PERFORMANCE_MODEL__SEED_VARIABLE "HA_BENCH_MOCK_SEED"
+#define PERFORMANCE_MODEL__SLOT_ID_VARIABLE "HA_BENCH_MOCK_SLOT_ID"
+#define PERFORMANCE_MODEL__FAULTS_VARIABLE "HA_BENCH_MOCK_FAULTS"
+
+// The predictions are replayed with the same service times.
+#define PERFORMANCE_MODEL__SEED "1"
+
+// Below this coefficient of variation, the service time is constant; above
+// this P99/P50 ratio, it is exponential (whose ratio is about 6.6).
+#define PERFORMANCE_MODEL__CONSTANT_VARIATION 0.05
+#define PERFORMANCE_MODEL__EXPONENTIAL_RATIO 3.0
+
+// P99 of the standard normal distribution.
+#define PERFORMANCE_MODEL__NORMAL_P99 2.326
+
+// Relative errors of the TpS and of the P99 of the calibration runs, as
+// predicted by the model, beyond which the model is rejected (the tail of
+// the latencies being noisier).
+#define PERFORMANCE_MODEL__CALIBRATION_TPS_TOLERANCE 0.10
+#define PERFORMANCE_MODEL__CALIBRATION_P99_TOLERANCE 0.25
+
+static double getRelativeError(const double predicted,
+                               const double measured)
+{
+    return (measured > 0.0) ? ((predicted - measured) / measured) : 0.0;
+}
+
+MechanismModel::MechanismModel() = default;
+
+MechanismModel::MechanismModel(const MechanismModel &) = default;
+
+MechanismModel &MechanismModel::operator=(const MechanismModel &) = default;
+
+MechanismModel::~MechanismModel() = default;
+
+bool PerformanceModel::checkCalibrationRuns(const char *const mockPath,
+                                            const unsigned int duration) const
+{
+    bool isWithinTolerance = true;
+
+    for (const MechanismModel &mechanismModel : mechanismModels)
+    {
+        const ScenarioResults &measured = mechanismModel.calibrationRun.scenarii[0];
+        RunResults predictedRun = {};
+
+        if (!predict(mockPath,
+                     mechanismModel.calibrationRun.membersCount,
+                     {measured.getDefinition()},
+                     duration,
+                     predictedRun) ||
+            (predictedRun.scenarii.size() != 1))
+        {
+            return false;
+        }
+
+        const ScenarioResults &predicted = predictedRun.scenarii[0];
+        const double tpsError = getRelativeError((double)predicted.tps, (double)measured.tps);
+        const double p99Error = getRelativeError((double)predicted.p99Latency, (double)measured.p99Latency);
+
+        fprintf(stdout,
+                "  %s (%lu members):\n",
+                measured.getDefinition().c_str(),
+                mechanismModel.calibrationRun.membersCount);
+        fprintf(stdout,
+                "    TpS                 : predicted = %ld, measured = %ld, error = %+.1f%%\n",
+                predicted.tps,
+                measured.tps,
+                100.0 * tpsError);
+        fprintf(stdout,
+                "    P99 (micro-seconds) : predicted = %ld, measured = %ld, error = %+.1f%%\n",
+                predicted.p99Latency,
+                measured.p99Latency,
+                100.0 * p99Error);
+
+        if ((std::fabs(tpsError) > PERFORMANCE_MODEL__CALIBRATION_TPS_TOLERANCE) ||
+            (std::fabs(p99Error) > PERFORMANCE_MODEL__CALIBRATION_P99_TOLERANCE))
+        {
+            fprintf(stderr,
+                    "The model does not reproduce the calibration run of '%s' (tolerances: %.0f%% on the TpS, %.0f%% on the P99).\n",
+                    mechanismModel.mechanism.c_str(),
+                    100.0 * PERFORMANCE_MODEL__CALIBRATION_TPS_TOLERANCE,
+                    100.0 * PERFORMANCE_MODEL__CALIBRATION_P99_TOLERANCE);
+
+            isWithinTolerance = false;
+        }
+    }
+
+    return isWithinTolerance;
+}
+
+bool PerformanceModel::fit(const std::vector<RunResults> &runs,
+                           const char *const mockPath,
+                           const unsigned int duration)
+{
+    mechanismModels.clear();
+    concurrency = 0L;
+
+    std::vector<std::string> mechanisms = {};
+
+    for (const RunResults &run : runs)
+    {
+        if ((run.scenarii.size() == 1) &&
+            (!run.scenarii[0].mechanism.empty()) &&
+            (std::find(mechanisms.begin(),
+                       mechanisms.end(),
+                       run.scenarii[0].mechanism) == mechanisms.end()))
+        {
+            mechanisms.push_back(run.scenarii[0].mechanism);
+        }
+    }
+
+    for (const std::string &mechanism : mechanisms)
+    {
+        std::vector<const RunResults *> mechanismRuns = {};
+
+        for (const RunResults &run : runs)
+        {
+            if ((run.scenarii.size() == 1) &&
+                (run.scenarii[0].mechanism == mechanism) &&
+                (run.scenarii[0].errorsCount == 0) &&
+                (run.scenarii[0].requestsCount != 0) &&
+                (run.membersCount != 0))
+            {
+                mechanismRuns.push_back(&run);
+            }
+        }
+
+        if (mechanismRuns.empty())
+        {
+            fprintf(stderr,
+                    "No run without error and with a known members count for '%s': not fitted.\n",
+                    mechanism.c_str());
+
+            continue;
+        }
+
+        const RunResults *pLeastLoadedRun = mechanismRuns[0];
+
+        for (const RunResults *const pRun : mechanismRuns)
+        {
+            if ((pRun->scenarii[0].testsCount * pLeastLoadedRun->membersCount) <
+                (pLeastLoadedRun->scenarii[0].testsCount * pRun->membersCount))
+            {
+                pLeastLoadedRun = pRun;
+            }
+        }
+
+        const ScenarioResults &leastLoadedResults = pLeastLoadedRun->scenarii[0];
+        MechanismModel mechanismModel = {};
+        char distribution[64] = {0};
+        double p50Overhead = 0.0;
+        double overheadSpread = 0.0;
+
+        mechanismModel.mechanism = mechanism;
+        mechanismModel.runsCount = mechanismRuns.size();
+        mechanismModel.calibrationRun = *pLeastLoadedRun;
+
+        if (mockPath != nullptr)
+        {
+            const double meanLatency = (double)leastLoadedResults.meanLatency;
+            char overheadServiceTime[64] = {0};
+            RunResults overheadRun = {};
+
+            // The mock plays the mean latency as a constant service time,
+            // without concurrency limit (i.e. without queueing): what it
+            // adds is the overhead of the client (including the mock).
+            snprintf(overheadServiceTime,
+                     sizeof(overheadServiceTime),
+                     "constant:0;%s=constant:%.1f",
+                     mechanism.c_str(),
+                     meanLatency);
+
+            if (!play(mockPath,
+                      overheadServiceTime,
+                      0L,
+                      pLeastLoadedRun->membersCount,
+                      {leastLoadedResults.getDefinition()},
+                      duration,
+                      overheadRun) ||
+                (overheadRun.scenarii.size() != 1))
+            {
+                fprintf(stderr,
+                        "Cannot measure the client overhead for '%s': not fitted.\n",
+                        mechanism.c_str());
+
+                continue;
+            }
+
+            const ScenarioResults &overheadResults = overheadRun.scenarii[0];
+
+            mechanismModel.clientOverhead = std::max(0.0, (double)overheadResults.meanLatency - meanLatency);
+            p50Overhead = std::max(0.0, (double)overheadResults.p50Latency - meanLatency);
+            overheadSpread = (double)(overheadResults.p99Latency - std::min(overheadResults.p50Latency, overheadResults.p99Latency));
+        }
+
+        mechanismModel.meanServiceTime = std::max(1.0, (double)leastLoadedResults.meanLatency - mechanismModel.clientOverhead);
+
+        // The overhead of the client shifts the latencies, and widens their
+        // distribution as an independent variable.
+        const double p50ServiceTime = std::max(1.0, (double)leastLoadedResults.p50Latency - p50Overhead);
+        const double latencySpread = (double)(leastLoadedResults.p99Latency - std::min(leastLoadedResults.p50Latency, leastLoadedResults.p99Latency));
+        const double p99ServiceTime = p50ServiceTime + std::sqrt(std::max(0.0, (latencySpread * latencySpread) - (overheadSpread * overheadSpread)));
+        const double standardDeviation = (p99ServiceTime - p50ServiceTime) /
+                                         PERFORMANCE_MODEL__NORMAL_P99;
+
+        if (p99ServiceTime > (PERFORMANCE_MODEL__EXPONENTIAL_RATIO * p50ServiceTime))
+        {
+            snprintf(distribution,
+                     sizeof(distribution),
+                     "exponential:%.1f",
+                     mechanismModel.meanServiceTime);
+        }
+        else if (standardDeviation < (PERFORMANCE_MODEL__CONSTANT_VARIATION * mechanismModel.meanServiceTime))
+        {
+            snprintf(distribution,
+                     sizeof(distribution),
+                     "constant:%.1f",
+                     mechanismModel.meanServiceTime);
+        }
+        else
+        {
+            snprintf(distribution,
+                     sizeof(distribution),
+                     "normal:%.1f:%.1f",
+                     mechanismModel.meanServiceTime,
+                     standardDeviation);
+        }
+
+        mechanismModel.distribution = distribution;
+
+        for (const RunResults *const pRun : mechanismRuns)
+        {
+            // Little's law: operations in flight per member.
+            const double inFlightOperationsCount = ((double)pRun->scenarii[0].tps * mechanismModel.meanServiceTime) /
+                                                   (1000000.0 * (double)pRun->membersCount);
+
+            mechanismModel.concurrency = std::max(mechanismModel.concurrency,
+                                                  (unsigned long)std::max(1.0, std::round(inFlightOperationsCount)));
+        }
+
+        mechanismModels.push_back(mechanismModel);
+    }
+
+    if (mechanismModels.empty())
+    {
+        return false;
+    }
+
+    std::vector<unsigned long> concurrencies = {};
+
+    for (const MechanismModel &mechanismModel : mechanismModels)
+    {
+        concurrencies.push_back(mechanismModel.concurrency);
+    }
+
+    std::sort(concurrencies.begin(),
+              concurrencies.end());
+
+    concurrency = concurrencies[(concurrencies.size() - 1) / 2];
+
+    return true;
+}
+
+unsigned long PerformanceModel::getConcurrency() const
+{
+    return concurrency;
+}
+
+std::string PerformanceModel::getServiceTime() const
+{
+    // The operations of the other mechanisms (e.g. key generations) are
+    // immediate.
+    std::string serviceTime = "constant:0";
+
+    for (const MechanismModel &mechanismModel : mechanismModels)
+    {
+        serviceTime += ";" + mechanismModel.mechanism + "=" + mechanismModel.distribution;
+    }
+
+    return serviceTime;
+}
+
+bool PerformanceModel::play(const char *const mockPath,
+                            const std::string &serviceTime,
+                            const unsigned long concurrencyValue,
+                            const unsigned long membersCount,
+                            const std::vector<std::string> &mix,
+                            const unsigned int duration,
+                            RunResults &results) const
+{
+    char resultsPath[] = "/tmp/ha-bench-model-XXXXXX";
+    const int resultsDescriptor = mkstemp(resultsPath);
+
+    if (resultsDescriptor < 0)
+    {
+        perror("Cannot create the results file of the mock run");
+
+        return false;
+    }
+
+    close(resultsDescriptor);
+
+    const std::string concurrencyText = std::to_string(concurrencyValue);
+    const std::string membersCountValue = std::to_string(membersCount);
+    const std::string durationValue = std::to_string(duration);
+
+    std::vector<const char *> arguments = {"ha-bench",
+                                           "--provider",
+                                           mockPath,
+                                           "--json",
+                                           resultsPath,
+                                           "0",
+                                           "model",
+                                           "time-limited",
+                                           durationValue.c_str(),
+                                           "share"};
+
+    for (const std::string &scenarioDefinition : mix)
+    {
+        arguments.push_back(scenarioDefinition.c_str());
+    }
+
+    arguments.push_back(nullptr);
+
+    fflush(stdout);
+    fflush(stderr);
+
+    const pid_t childPid = fork();
+
+    if (childPid == 0)
+    {
+        // The report of the run is not printed.
+        const int nullDescriptor = open("/dev/null",
+                                        O_WRONLY);
+
+        if (nullDescriptor >= 0)
+        {
+            dup2(nullDescriptor,
+                 STDOUT_FILENO);
+            dup2(nullDescriptor,
+                 STDERR_FILENO);
+        }
+
+        setenv(PERFORMANCE_MODEL__SERVICE_TIME_VARIABLE,
+               serviceTime.c_str(),
+               1);
+        setenv(PERFORMANCE_MODEL__CONCURRENCY_VARIABLE,
+               concurrencyText.c_str(),
+               1);
+        setenv(PERFORMANCE_MODEL__MEMBERS_VARIABLE,
+               membersCountValue.c_str(),
+               1);
+        setenv(PERFORMANCE_MODEL__SEED_VARIABLE,
+               PERFORMANCE_MODEL__SEED,
+               1);
+        unsetenv(PERFORMANCE_MODEL__SLOT_ID_VARIABLE);
+        unsetenv(PERFORMANCE_MODEL__FAULTS_VARIABLE);
+
+        execv("/proc/self/exe",
+              (char *const *)arguments.data());
+
+        _exit(127);
+    }
+
+    int status = -1;
+    bool isPredicted = false;
+
+    if (childPid < 0)
+    {
+        perror("Cannot run the mock");
+    }
+    else if ((waitpid(childPid,
+                      &status,
+                      0) != childPid) ||
+             (!WIFEXITED(status)) ||
+             (WEXITSTATUS(status) != 0))
+    {
+        fprintf(stderr,
+                "The mock run failed (status: '%d').\n",
+                status);
+    }
+    else if (!RunResults::read(resultsPath,
+                               results))
+    {
+        fprintf(stderr,
+                "Cannot read the results of the mock run.\n");
+    }
+    else
+    {
+        isPredicted = true;
+    }
+
+    unlink(resultsPath);
+
+    return isPredicted;
+}
+
+bool PerformanceModel::predict(const char *const mockPath,
+                               const unsigned long membersCount,
+                               const std::vector<std::string> &mix,
+                               const unsigned int duration,
+                               RunResults &prediction) const
+{
+    return play(mockPath,
+                getServiceTime(),
+                concurrency,
+                membersCount,
+                mix,
+                duration,
+                prediction);
+}
+
+bool PerformanceModel::validate(const char *const mockPath,
+                                const std::vector<RunResults> &heldOutRuns,
+                                const std::vector<std::string> &heldOutPaths,
+                                const unsigned int duration) const
+{
+    double tpsErrorsSum = 0.0;
+    double p50ErrorsSum = 0.0;
+    double p99ErrorsSum = 0.0;
+    unsigned long comparisonsCount = 0L;
+
+    for (size_t runIndex = 0; runIndex < heldOutRuns.size(); runIndex++)
+    {
+        const RunResults &measuredRun = heldOutRuns[runIndex];
+        std::vector<std::string> mix = {};
+        RunResults predictedRun = {};
+
+        for (const ScenarioResults &scenarioResults : measuredRun.scenarii)
+        {
+            mix.push_back(scenarioResults.getDefinition());
+        }
+
+        fprintf(stdout,
+                "  %s (%lu members):\n",
+                heldOutPaths[runIndex].c_str(),
+                measuredRun.membersCount);
+
+        if (measuredRun.membersCount == 0)
+        {
+            fprintf(stdout,
+                    "    Skipped: unknown members count.\n");
+
+            continue;
+        }
+
+        if (!predict(mockPath,
+                     measuredRun.membersCount,
+                     mix,
+                     duration,
+                     predictedRun))
+        {
+            return false;
+        }
+
+        if (predictedRun.scenarii.size() != measuredRun.scenarii.size())
+        {
+            fprintf(stderr,
+                    "Inconsistent prediction results.\n");
+
+            return false;
+        }
+
+        for (size_t scenarioIndex = 0; scenarioIndex < measuredRun.scenarii.size(); scenarioIndex++)
+        {
+            const ScenarioResults &measured = measuredRun.scenarii[scenarioIndex];
+            const ScenarioResults &predicted = predictedRun.scenarii[scenarioIndex];
+            const double tpsError = getRelativeError((double)predicted.tps, (double)measured.tps);
+            const double p50Error = getRelativeError((double)predicted.p50Latency, (double)measured.p50Latency);
+            const double p99Error = getRelativeError((double)predicted.p99Latency, (double)measured.p99Latency);
+
+            fprintf(stdout,
+                    "    %s:\n",
+                    measured.getDefinition().c_str());
+            fprintf(stdout,
+                    "      TpS                 : predicted = %ld, measured = %ld, error = %+.1f%%\n",
+                    predicted.tps,
+                    measured.tps,
+                    100.0 * tpsError);
+            fprintf(stdout,
+                    "      P50 (micro-seconds) : predicted = %ld, measured = %ld, error = %+.1f%%\n",
+                    predicted.p50Latency,
+                    measured.p50Latency,
+                    100.0 * p50Error);
+            fprintf(stdout,
+                    "      P99 (micro-seconds) : predicted = %ld, measured = %ld, error = %+.1f%%\n",
+                    predicted.p99Latency,
+                    measured.p99Latency,
+                    100.0 * p99Error);
+
+            tpsErrorsSum += std::fabs(tpsError);
+            p50ErrorsSum += std::fabs(p50Error);
+            p99ErrorsSum += std::fabs(p99Error);
+            comparisonsCount++;
+        }
+    }
+
+    if (comparisonsCount != 0)
+    {
+        fprintf(stdout,
+                "  Mean absolute errors over %ld scenarii: TpS = %.1f%%, P50 = %.1f%%, P99 = %.1f%%\n",
+                comparisonsCount,
+                100.0 * tpsErrorsSum / (double)comparisonsCount,
+                100.0 * p50ErrorsSum / (double)comparisonsCount,
+                100.0 * p99ErrorsSum / (double)comparisonsCount);
+    }
+
+    return true;
+}
+
+void PerformanceModel::write() const
+{
+    writeMessage("Per mechanism (micro-seconds):\n");
+
+    for (const MechanismModel &mechanismModel : mechanismModels)
+    {
+        fprintf(stdout,
+                "  %-20s: service time = %s, client overhead = %.1f, concurrency = %ld, runs = %ld\n",
+                mechanismModel.mechanism.c_str(),
+                mechanismModel.distribution.c_str(),
+                mechanismModel.clientOverhead,
+                mechanismModel.concurrency,
+                mechanismModel.runsCount);
+    }
+
+    writeMessage("Mock configuration:\n");
+
+    fprintf(stdout,
+            "  %s='%s'\n  %s=%ld\n",
+            PERFORMANCE_MODEL__SERVICE_TIME_VARIABLE,
+            getServiceTime().c_str(),
+            PERFORMANCE_MODEL__CONCURRENCY_VARIABLE,
+            concurrency);
+}
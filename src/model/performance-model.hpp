@@ -0,0 +1,128 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef PERFORMANCE_MODEL_HPP
+#define PERFORMANCE_MODEL_HPP
+
+#include <string>
+#include <vector>
+
+#include "results.hpp"
+
+// Service of a mechanism by an appliance (times in micro-seconds).
+class MechanismModel
+{
+public:
+    std::string mechanism = {};
+
+    // Distribution in the syntax of the mock, e.g. 'normal:950.0:40.0'.
+    std::string distribution = {};
+
+    double meanServiceTime = 0.0;
+
+    // Mean latency of the calibration run replayed by the mock without
+    // service time, i.e. the overhead of the client, subtracted from its
+    // latencies (0 if not measured).
+    double clientOverhead = 0.0;
+
+    // Operations served at the same time by an appliance, as observed on
+    // the busiest run.
+    unsigned long concurrency = 0L;
+
+    unsigned long runsCount = 0L;
+
+    // Least loaded run, on which the service time is fitted.
+    RunResults calibrationRun = {};
+
+    // Note: the special members are not inlined (too large).
+    MechanismModel();
+    MechanismModel(const MechanismModel &);
+    MechanismModel &operator=(const MechanismModel &);
+    ~MechanismModel();
+};
+
+/*
+ * Performance model of the appliances of an HA group, fitted on the results
+ * of isolated runs (a single scenario running a single mechanism, without
+ * error), then played by the mock provider to predict the TpS and the
+ * latencies of other members counts and traffic mixes.
+ *
+ * Notes:
+ *   - The service time of a mechanism is fitted on its least loaded run
+ *     (i.e. the one with the fewest tests per member), that should not
+ *     queue: its calibration run. Its latencies include the overhead of the
+ *     client, that the mock adds again when playing the model: given the
+ *     mock, this overhead is measured by replaying the calibration run
+ *     without service time, and subtracted.
+ *   - The concurrency of the appliances is fitted on the busiest runs,
+ *     that should saturate them: a mechanism is given the largest
+ *     'TpS x service time / members' product of its runs, the model using
+ *     the median over the mechanisms (the mock serving all the mechanisms
+ *     with the same concurrency).
+ *   - The scenarii running requests made of several stages cannot be
+ *     fitted, but can be predicted once their mechanisms are.
+ */
+class PerformanceModel
+{
+protected:
+    std::vector<MechanismModel> mechanismModels = {};
+    unsigned long concurrency = 0L;
+
+    // Runs the mix on the mock with the given configuration.
+    virtual bool play(const char *const mockPath,
+                      const std::string &serviceTime,
+                      const unsigned long concurrencyValue,
+                      const unsigned long membersCount,
+                      const std::vector<std::string> &mix,
+                      const unsigned int duration,
+                      RunResults &results) const;
+
+public:
+    // Predicts the calibration run of each mechanism, and writes the
+    // predicted and measured values with their errors. Returns false if a
+    // prediction fails, or if its TpS or P99 is off by more than their
+    // tolerances.
+    virtual bool checkCalibrationRuns(const char *const mockPath,
+                                      const unsigned int duration) const;
+
+    // Returns false if no mechanism can be fitted. Without the mock (i.e. a
+    // null path), the service times include the overhead of the client.
+    virtual bool fit(const std::vector<RunResults> &runs,
+                     const char *const mockPath,
+                     const unsigned int duration);
+
+    virtual unsigned long getConcurrency() const;
+
+    // Value of the mock HA_BENCH_MOCK_SERVICE_TIME variable.
+    virtual std::string getServiceTime() const;
+
+    // Runs the mix (scenarii definitions) on the mock with the model for
+    // the given duration (in seconds). Returns false if the run fails.
+    virtual bool predict(const char *const mockPath,
+                         const unsigned long membersCount,
+                         const std::vector<std::string> &mix,
+                         const unsigned int duration,
+                         RunResults &prediction) const;
+
+    // Predicts each held-out run with its members count and mix, and writes
+    // the predicted and measured values with their errors. Returns false if
+    // a prediction fails.
+    virtual bool validate(const char *const mockPath,
+                          const std::vector<RunResults> &heldOutRuns,
+                          const std::vector<std::string> &heldOutPaths,
+                          const unsigned int duration) const;
+
+    virtual void write() const;
+
+    virtual ~PerformanceModel() = default;
+};
+
+#endif /* PERFORMANCE_MODEL_HPP */
@@ -0,0 +1,318 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cstdio>
+#include <strings.h>
+
+#include "results.hpp"
+
+ScenarioResults::ScenarioResults() = default;
+
+ScenarioResults::ScenarioResults(const ScenarioResults &) = default;
+
+ScenarioResults &ScenarioResults::operator=(const ScenarioResults &) = default;
+
+ScenarioResults::~ScenarioResults() = default;
+
+RunResults::RunResults() = default;
+
+RunResults::RunResults(const RunResults &) = default;
+
+RunResults &RunResults::operator=(const RunResults &) = default;
+
+RunResults::~RunResults() = default;
+
+std::string ScenarioResults::getDefinition() const
+{
+    return scenario + "x" + flags + "x" + std::to_string(testsCount);
+}
+
+std::string ScenarioResults::getMechanism(const std::string &scenario)
+{
+    // Scenarii running a single operation per request.
+    static const struct
+    {
+        const char *scenario;
+        const char *mechanism;
+    } SCENARIO_MECHANISMS[] = {{"comp-128", "CKM_COMP128"},
+                               {"milenage", "CKM_MILENAGE"},
+                               {"TUAK", "CKM_TUAK"},
+                               {"SUCI", "CKM_ECIES"},
+                               {"milenage-resync", "CKM_MILENAGE_RESYNC"},
+                               {"TUAK-resync", "CKM_TUAK_RESYNC"}};
+
+    for (const auto &scenarioMechanism : SCENARIO_MECHANISMS)
+    {
+        if (strcasecmp(scenario.c_str(),
+                       scenarioMechanism.scenario) == 0)
+        {
+            return scenarioMechanism.mechanism;
+        }
+    }
+
+    return "";
+}
+
+double RunResults::getDuration() const
+{
+    double duration = 0.0;
+
+    for (const ScenarioResults &scenarioResults : scenarii)
+    {
+        if (duration < scenarioResults.duration)
+        {
+            duration = scenarioResults.duration;
+        }
+    }
+
+    return duration;
+}
+
+unsigned long RunResults::getTps() const
+{
+    unsigned long tps = 0L;
+
+    for (const ScenarioResults &scenarioResults : scenarii)
+    {
+        tps += scenarioResults.tps;
+    }
+
+    return tps;
+}
+
+bool RunResults::read(const char *const path,
+                      RunResults &results)
+{
+    JsonValue value = {};
+
+    if (!JsonValue::parseFile(path,
+                              value))
+    {
+        return false;
+    }
+
+    const JsonValue *const pScenarii = value.getMember("scenarii");
+
+    if ((pScenarii == nullptr) ||
+        (pScenarii->type != JSON_TYPE::Array))
+    {
+        return false;
+    }
+
+    results = RunResults();
+
+    results.provider = value.getString("provider", "");
+    results.slotId = (unsigned long)value.getNumber("slotId", 0.0);
+    results.membersCount = (unsigned long)value.getNumber("membersCount", 0.0);
+    results.measureType = value.getString("measureType", "");
+    results.measureObjective = (unsigned long)value.getNumber("measureObjective", 0.0);
+    results.isSharingObjects = (value.getString("share", "share") == "share");
+
+    const JsonValue *const pThreadLayout = value.getMember("threadLayout");
+
+    if (pThreadLayout != nullptr)
+    {
+        results.affinity = pThreadLayout->getString("affinity", "none");
+        results.housekeepingCpus = pThreadLayout->getString("housekeepingCpus", "");
+        results.scheduling = pThreadLayout->getString("scheduling", "");
+        results.testsCpus = pThreadLayout->getString("testsCpus", "");
+    }
+
+    for (const JsonValue &scenarioValue : pScenarii->elements)
+    {
+        ScenarioResults scenarioResults = {};
+        const JsonValue *const pLatency = scenarioValue.getMember("latency");
+
+        if (pLatency == nullptr)
+        {
+            return false;
+        }
+
+        scenarioResults.scenario = scenarioValue.getString("scenario", "");
+        scenarioResults.flags = scenarioValue.getString("flags", "");
+        scenarioResults.testsCount = (unsigned long)scenarioValue.getNumber("testsCount", 0.0);
+        scenarioResults.mechanism = scenarioValue.getString("mechanism", "");
+        scenarioResults.duration = scenarioValue.getNumber("duration", 0.0);
+        scenarioResults.requestsCount = (unsigned long)scenarioValue.getNumber("requestsCount", 0.0);
+        scenarioResults.errorsCount = (unsigned long)scenarioValue.getNumber("errorsCount", 0.0);
+        scenarioResults.tps = (unsigned long)scenarioValue.getNumber("tps", 0.0);
+        scenarioResults.meanLatency = (unsigned long)pLatency->getNumber("mean", 0.0);
+        scenarioResults.minLatency = (unsigned long)pLatency->getNumber("min", 0.0);
+        scenarioResults.p50Latency = (unsigned long)pLatency->getNumber("p50", 0.0);
+        scenarioResults.p90Latency = (unsigned long)pLatency->getNumber("p90", 0.0);
+        scenarioResults.p99Latency = (unsigned long)pLatency->getNumber("p99", 0.0);
+        scenarioResults.maxLatency = (unsigned long)pLatency->getNumber("max", 0.0);
+        scenarioResults.verifiedCount = (unsigned long)scenarioValue.getNumber("verifiedCount", 0.0);
+        scenarioResults.mismatchesCount = (unsigned long)scenarioValue.getNumber("mismatchesCount", 0.0);
+
+        const JsonValue *const pHistogram = scenarioValue.getMember("histogram");
+
+        if (pHistogram != nullptr)
+        {
+            const JsonValue *const pBuckets = pHistogram->getMember("buckets");
+            LATENCY_STATISTICS_SNAPSHOT snapshot = {};
+
+            if ((pBuckets == nullptr) ||
+                (pBuckets->type != JSON_TYPE::Array))
+            {
+                return false;
+            }
+
+            snapshot.count = (unsigned long)pHistogram->getNumber("count", 0.0);
+            snapshot.totalMicroSeconds = (unsigned long long)pHistogram->getNumber("total", 0.0);
+            snapshot.minMicroSeconds = scenarioResults.minLatency;
+            snapshot.maxMicroSeconds = scenarioResults.maxLatency;
+
+            // Pairs of bucket index and count, for the buckets not empty.
+            for (const JsonValue &bucketValue : pBuckets->elements)
+            {
+                if ((bucketValue.type != JSON_TYPE::Array) ||
+                    (bucketValue.elements.size() != 2) ||
+                    (bucketValue.elements[0].number < 0.0) ||
+                    (bucketValue.elements[0].number >= LATENCY_STATISTICS__BUCKETS_COUNT))
+                {
+                    return false;
+                }
+
+                snapshot.buckets[(size_t)bucketValue.elements[0].number] = (unsigned long)bucketValue.elements[1].number;
+            }
+
+            scenarioResults.hasRequestsStatistics = true;
+            scenarioResults.requestsStatistics.mergeSnapshot(snapshot);
+        }
+
+        if (scenarioResults.scenario.empty() ||
+            scenarioResults.flags.empty() ||
+            (scenarioResults.testsCount == 0))
+        {
+            return false;
+        }
+
+        results.scenarii.push_back(scenarioResults);
+    }
+
+    return true;
+}
+
+bool RunResults::write(const char *const path) const
+{
+    FILE *const file = fopen(path,
+                             "w");
+
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    fprintf(file,
+            "{\n  \"provider\": ");
+    JsonValue::writeString(file,
+                           provider);
+    fprintf(file,
+            ",\n  \"slotId\": %lu,\n  \"membersCount\": %lu,\n  \"measureType\": ",
+            slotId,
+            membersCount);
+    JsonValue::writeString(file,
+                           measureType);
+    fprintf(file,
+            ",\n  \"measureObjective\": %lu,\n  \"share\": \"%s\",\n  \"threadLayout\": {\"affinity\": ",
+            measureObjective,
+            isSharingObjects ? "share" : "no-share");
+    JsonValue::writeString(file,
+                           affinity);
+    fprintf(file,
+            ", \"housekeepingCpus\": ");
+    JsonValue::writeString(file,
+                           housekeepingCpus);
+    fprintf(file,
+            ", \"scheduling\": ");
+    JsonValue::writeString(file,
+                           scheduling);
+    fprintf(file,
+            ", \"testsCpus\": ");
+    JsonValue::writeString(file,
+                           testsCpus);
+    fprintf(file,
+            "},\n  \"scenarii\": [");
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        const ScenarioResults &scenarioResults = scenarii[scenarioIndex];
+
+        fprintf(file,
+                "%s\n    {\n      \"scenario\": ",
+                (scenarioIndex == 0) ? "" : ",");
+        JsonValue::writeString(file,
+                               scenarioResults.scenario);
+        fprintf(file,
+                ",\n      \"flags\": ");
+        JsonValue::writeString(file,
+                               scenarioResults.flags);
+        fprintf(file,
+                ",\n      \"testsCount\": %lu,\n      \"mechanism\": ",
+                scenarioResults.testsCount);
+        JsonValue::writeString(file,
+                               scenarioResults.mechanism);
+        fprintf(file,
+                ",\n      \"duration\": %.6f,\n      \"requestsCount\": %lu,\n      \"errorsCount\": %lu,\n      \"tps\": %lu,\n",
+                scenarioResults.duration,
+                scenarioResults.requestsCount,
+                scenarioResults.errorsCount,
+                scenarioResults.tps);
+        fprintf(file,
+                "      \"verifiedCount\": %lu,\n      \"mismatchesCount\": %lu,\n",
+                scenarioResults.verifiedCount,
+                scenarioResults.mismatchesCount);
+        if (scenarioResults.hasRequestsStatistics)
+        {
+            LATENCY_STATISTICS_SNAPSHOT snapshot = {};
+            bool isFirstBucket = true;
+
+            scenarioResults.requestsStatistics.getSnapshot(snapshot);
+
+            fprintf(file,
+                    "      \"histogram\": {\"count\": %lu, \"total\": %llu, \"buckets\": [",
+                    snapshot.count,
+                    snapshot.totalMicroSeconds);
+
+            for (size_t bucketIndex = 0; bucketIndex < LATENCY_STATISTICS__BUCKETS_COUNT; bucketIndex++)
+            {
+                if (snapshot.buckets[bucketIndex] != 0L)
+                {
+                    fprintf(file,
+                            "%s[%lu, %lu]",
+                            isFirstBucket ? "" : ", ",
+                            bucketIndex,
+                            snapshot.buckets[bucketIndex]);
+
+                    isFirstBucket = false;
+                }
+            }
+
+            fprintf(file,
+                    "]},\n");
+        }
+
+        fprintf(file,
+                "      \"latency\": {\"mean\": %lu, \"min\": %lu, \"p50\": %lu, \"p90\": %lu, \"p99\": %lu, \"max\": %lu}\n    }",
+                scenarioResults.meanLatency,
+                scenarioResults.minLatency,
+                scenarioResults.p50Latency,
+                scenarioResults.p90Latency,
+                scenarioResults.p99Latency,
+                scenarioResults.maxLatency);
+    }
+
+    fprintf(file,
+            "\n  ]\n}\n");
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,114 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef RESULTS_HPP
+#define RESULTS_HPP
+
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "scenarii/latency-statistics.hpp"
+
+// Results of a scenario (latencies in micro-seconds, of the successful
+// requests).
+class ScenarioResults
+{
+public:
+    // As given on the command line, e.g. 'milenage', '00000' and 10.
+    std::string scenario = {};
+    std::string flags = {};
+    unsigned long testsCount = 0L;
+
+    // Mechanism of the requests, empty for the scenarii running requests
+    // made of several stages (e.g. 5G-AKA).
+    std::string mechanism = {};
+
+    double duration = 0.0;
+    unsigned long requestsCount = 0L;
+    unsigned long errorsCount = 0L;
+    unsigned long tps = 0L;
+
+    unsigned long meanLatency = 0L;
+    unsigned long minLatency = 0L;
+    unsigned long p50Latency = 0L;
+    unsigned long p90Latency = 0L;
+    unsigned long p99Latency = 0L;
+    unsigned long maxLatency = 0L;
+
+    // Sampled outputs recomputed in software (see '--verify'), and the
+    // mismatching ones.
+    unsigned long verifiedCount = 0L;
+    unsigned long mismatchesCount = 0L;
+
+    // Latencies histogram, so that the results of several runs can be merged
+    // (see 'ha-bench merge'); missing from the files written before.
+    bool hasRequestsStatistics = false;
+    LatencyStatistics requestsStatistics = {};
+
+    // Note: the special members are not inlined (too large).
+    ScenarioResults();
+    ScenarioResults(const ScenarioResults &);
+    ScenarioResults &operator=(const ScenarioResults &);
+    ~ScenarioResults();
+
+    // Returns the name of the mechanism of a single stage scenario, or an
+    // empty string.
+    static std::string getMechanism(const std::string &scenario);
+
+    // E.g. 'milenagex00000x10'.
+    std::string getDefinition() const;
+};
+
+/*
+ * Results of a run of HA-Bench, written with the '--json' option and read
+ * back by the performance model.
+ */
+class RunResults
+{
+public:
+    std::string provider = {};
+    unsigned long slotId = 0L;
+
+    // Number of members of the HA group, 0 if unknown.
+    unsigned long membersCount = 0L;
+
+    std::string measureType = {};
+    unsigned long measureObjective = 0L;
+    bool isSharingObjects = true;
+
+    // Placement of the threads of the tests (see '--affinity'), e.g.
+    // 'compact', '0', 'fifo:10' and '1,2,3' (CPU of each test).
+    std::string affinity = "none";
+    std::string housekeepingCpus = {};
+    std::string scheduling = {};
+    std::string testsCpus = {};
+
+    std::vector<ScenarioResults> scenarii = {};
+
+    // Note: the special members are not inlined (too large).
+    RunResults();
+    RunResults(const RunResults &);
+    RunResults &operator=(const RunResults &);
+    ~RunResults();
+
+    // Returns false if the file cannot be read, or is not made of results.
+    static bool read(const char *const path,
+                     RunResults &results);
+
+    // Returns false if the file cannot be written.
+    bool write(const char *const path) const;
+
+    double getDuration() const;
+    unsigned long getTps() const;
+};
+
+#endif /* RESULTS_HPP */
@@ -0,0 +1,431 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#include "5g-aka-test.hpp"
+#include "5g-scenario.hpp"
+
+extern "C"
+{
+#include <toolkits/kdf-toolkit.h>
+#include <toolkits/misc-toolkit.h>
+#include <toolkits/p11-toolkit.h>
+}
+
+#define FIVEG_AKA__KDF_INPUT_LENGTH 256
+#define FIVEG_AKA__SHA_256_LENGTH 32
+#define FIVEG_AKA__XRES_STAR_LENGTH 16
+#define FIVEG_AKA__HXRES_STAR_LENGTH 16
+
+const char *const FIVEG_AKA__STAGES_NAMES[FIVEG_AKA__STAGES_COUNT] = {"AV",
+                                                                      "KAUSF",
+                                                                      "XRES*",
+                                                                      "HXRES*",
+                                                                      "KSEAF",
+                                                                      "End-to-end"};
+
+FivegAkaTest::FivegAkaTest(const Scenario &_scenario,
+                           const TEST_IDENTIFIER _identifier,
+                           const unsigned long _requestsCountObjective) : Test(_scenario,
+                                                                               _identifier,
+                                                                               _requestsCountObjective)
+{
+    assert(&_scenario != nullptr);
+
+    stagesStatistics.resize(FIVEG_AKA__STAGES_COUNT);
+}
+
+CK_RV FivegAkaTest::run()
+{
+    assert(state == TEST_STATE::Started);
+    assert(sessionHandle != CK_INVALID_HANDLE);
+    assert(pMechanism != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    while ((!terminationRequested) &&
+           ((requestsCountObjective == 0) ||
+            (requestsCount < requestsCountObjective)))
+    {
+        beginRequest();
+
+        rv = runTransaction();
+
+        if (rv != CKR_OK)
+        {
+            errorsCount++;
+        }
+
+        endRequest();
+    }
+
+    return CKR_OK;
+}
+
+CK_RV FivegAkaTest::deriveKey(const CK_OBJECT_HANDLE keyHandle,
+                              const unsigned char fc,
+                              const unsigned char *const *const parameters,
+                              const size_t *const parametersLengths,
+                              const size_t parametersCount,
+                              CK_BYTE *const derivedKey,
+                              CK_ULONG &derivedKeyLength)
+{
+    assert(keyHandle != CK_INVALID_HANDLE);
+    assert(parameters != nullptr);
+    assert(parametersLengths != nullptr);
+    assert(derivedKey != nullptr);
+    assert(&derivedKeyLength != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    CK_BYTE kdfInput[FIVEG_AKA__KDF_INPUT_LENGTH] = {0};
+    size_t kdfInputLength = 0;
+
+    kdfInputLength = kdftk_buildInput(fc,
+                                      parameters,
+                                      parametersLengths,
+                                      parametersCount,
+                                      kdfInput,
+                                      GET_ARRAY_SIZE(kdfInput));
+
+    if (kdfInputLength == 0)
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        writeError("Key derivation parameters are too long.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    rv = p11tk_signWithHmacSha256(sessionHandle,
+                                  keyHandle,
+                                  kdfInput,
+                                  (CK_ULONG)kdfInputLength,
+                                  derivedKey,
+                                  &derivedKeyLength);
+
+EXIT:
+    return rv;
+}
+
+CK_RV FivegAkaTest::generateAuthenticationVector(CK_BYTE *const authenticationVector,
+                                                 CK_ULONG &authenticationVectorLength)
+{
+    assert(authenticationVector != nullptr);
+    assert(&authenticationVectorLength != nullptr);
+
+    const FivegScenario &fivegScenario = (const FivegScenario &)scenario;
+
+    const CK_ULONG expectedAuthenticationVectorLength = THREE_GPP__RAND_LENGTH +
+                                                        fivegScenario.getResLength() +
+                                                        fivegScenario.getCkLength() +
+                                                        fivegScenario.getIkLength() +
+                                                        THREE_GPP__SQN_LENGTH +
+                                                        THREE_GPP__AMF_LENGTH +
+                                                        fivegScenario.getMacLength();
+
+    CK_RV rv = CKR_OK;
+
+    rv = p11tk_getFunctionList()->C_SignInit(sessionHandle,
+                                             pMechanism,
+                                             fivegScenario.getSkHandle());
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot initialize authentication.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    rv = p11tk_getFunctionList()->C_Sign(sessionHandle,
+                                         (CK_BYTE_PTR) nullptr,
+                                         (CK_ULONG)0,
+                                         (CK_BYTE_PTR)authenticationVector,
+                                         &authenticationVectorLength);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot finalize authentication.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    if (authenticationVectorLength != expectedAuthenticationVectorLength)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Unexpected authentication vector length.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    sampleOutput(authenticationVector,
+                 authenticationVectorLength);
+
+EXIT:
+    return rv;
+}
+
+unsigned long FivegAkaTest::getStageMicroSeconds(const std::chrono::high_resolution_clock::time_point &stageBeginTime)
+{
+    return (unsigned long)(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - stageBeginTime).count());
+}
+
+CK_RV FivegAkaTest::runTransaction()
+{
+    const FivegScenario &fivegScenario = (const FivegScenario &)scenario;
+
+    CK_RV rv = CKR_OK;
+
+    const auto transactionBeginTime = std::chrono::high_resolution_clock::now();
+    auto stageBeginTime = transactionBeginTime;
+
+    const std::string &servingNetworkName = scenario.scenarioContext.servingNetworkName;
+
+    const CK_ULONG resLength = fivegScenario.getResLength();
+    const CK_ULONG ckLength = fivegScenario.getCkLength();
+    const CK_ULONG ikLength = fivegScenario.getIkLength();
+
+    CK_BYTE authenticationVector[FIVEG_AKA__MAXIMUM_AUTHENTICATION_VECTOR_LENGTH] = {0};
+    CK_ULONG authenticationVectorLength = GET_ARRAY_SIZE(authenticationVector);
+
+    const CK_BYTE *const rand = &authenticationVector[0];
+    const CK_BYTE *const xres = &rand[THREE_GPP__RAND_LENGTH];
+    const CK_BYTE *const ckIk = &xres[resLength];
+    const CK_BYTE *const sqnXorAk = &ckIk[ckLength + ikLength];
+
+    CK_OBJECT_HANDLE ckIkHandle = CK_INVALID_HANDLE;
+    CK_OBJECT_HANDLE kausfHandle = CK_INVALID_HANDLE;
+
+    CK_BYTE kausf[KDFTK_OUTPUT_LENGTH] = {0};
+    CK_ULONG kausfLength = GET_ARRAY_SIZE(kausf);
+
+    CK_BYTE kdfOutput[KDFTK_OUTPUT_LENGTH] = {0};
+    CK_ULONG kdfOutputLength = GET_ARRAY_SIZE(kdfOutput);
+
+    CK_BYTE hxresStarInput[THREE_GPP__RAND_LENGTH + FIVEG_AKA__XRES_STAR_LENGTH] = {0};
+
+    CK_BYTE digest[FIVEG_AKA__SHA_256_LENGTH] = {0};
+    CK_ULONG digestLength = GET_ARRAY_SIZE(digest);
+
+    //
+    // Authentication vector.
+    //
+    rv = generateAuthenticationVector(authenticationVector,
+                                      authenticationVectorLength);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    stagesStatistics[FIVEG_AKA__STAGE__AUTHENTICATION_VECTOR].add(getStageMicroSeconds(stageBeginTime));
+
+    //
+    // KAUSF.
+    //
+    stageBeginTime = std::chrono::high_resolution_clock::now();
+
+    rv = p11tk_createHmacKey(sessionHandle,
+                             ckIk,
+                             ckLength + ikLength,
+                             &ckIkHandle);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot import CK || IK.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    {
+        const unsigned char *const parameters[] = {(const unsigned char *)servingNetworkName.data(),
+                                                   sqnXorAk};
+        const size_t parametersLengths[] = {servingNetworkName.size(),
+                                            THREE_GPP__SQN_LENGTH};
+
+        rv = deriveKey(ckIkHandle,
+                       KDFTK_FC__KAUSF,
+                       parameters,
+                       parametersLengths,
+                       GET_ARRAY_SIZE(parameters),
+                       kausf,
+                       kausfLength);
+    }
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot derive KAUSF.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    stagesStatistics[FIVEG_AKA__STAGE__KAUSF].add(getStageMicroSeconds(stageBeginTime));
+
+    //
+    // XRES*.
+    //
+    stageBeginTime = std::chrono::high_resolution_clock::now();
+
+    {
+        const unsigned char *const parameters[] = {(const unsigned char *)servingNetworkName.data(),
+                                                   rand,
+                                                   xres};
+        const size_t parametersLengths[] = {servingNetworkName.size(),
+                                            THREE_GPP__RAND_LENGTH,
+                                            resLength};
+
+        rv = deriveKey(ckIkHandle,
+                       KDFTK_FC__XRES_STAR,
+                       parameters,
+                       parametersLengths,
+                       GET_ARRAY_SIZE(parameters),
+                       kdfOutput,
+                       kdfOutputLength);
+    }
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot derive XRES*.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    stagesStatistics[FIVEG_AKA__STAGE__XRES_STAR].add(getStageMicroSeconds(stageBeginTime));
+
+    //
+    // HXRES*.
+    //
+    stageBeginTime = std::chrono::high_resolution_clock::now();
+
+    memcpy(&hxresStarInput[0],
+           rand,
+           THREE_GPP__RAND_LENGTH);
+    memcpy(&hxresStarInput[THREE_GPP__RAND_LENGTH],
+           &kdfOutput[KDFTK_OUTPUT_LENGTH - FIVEG_AKA__XRES_STAR_LENGTH],
+           FIVEG_AKA__XRES_STAR_LENGTH);
+
+    rv = p11tk_digestWithSha256(sessionHandle,
+                                hxresStarInput,
+                                GET_ARRAY_SIZE(hxresStarInput),
+                                digest,
+                                &digestLength);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot compute HXRES*.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    // HXRES* (the 128 least significant bits of the digest) is only forwarded
+    // to the SEAF: the stage measures its cost and checks the digest length.
+    if (digestLength != FIVEG_AKA__SHA_256_LENGTH)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Unexpected HXRES* digest length.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    stagesStatistics[FIVEG_AKA__STAGE__HXRES_STAR].add(getStageMicroSeconds(stageBeginTime));
+
+    //
+    // KSEAF.
+    //
+    stageBeginTime = std::chrono::high_resolution_clock::now();
+
+    rv = p11tk_createHmacKey(sessionHandle,
+                             kausf,
+                             kausfLength,
+                             &kausfHandle);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot import KAUSF.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    {
+        const unsigned char *const parameters[] = {(const unsigned char *)servingNetworkName.data()};
+        const size_t parametersLengths[] = {servingNetworkName.size()};
+
+        kdfOutputLength = GET_ARRAY_SIZE(kdfOutput);
+
+        rv = deriveKey(kausfHandle,
+                       KDFTK_FC__KSEAF,
+                       parameters,
+                       parametersLengths,
+                       GET_ARRAY_SIZE(parameters),
+                       kdfOutput,
+                       kdfOutputLength);
+    }
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot derive KSEAF.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    stagesStatistics[FIVEG_AKA__STAGE__KSEAF].add(getStageMicroSeconds(stageBeginTime));
+
+EXIT:
+    // The short-lived keys are part of the transaction cost.
+    if (ckIkHandle != CK_INVALID_HANDLE)
+    {
+        CK_RV rv2 = p11tk_destroyObject(sessionHandle,
+                                        ckIkHandle);
+
+        if (rv == CKR_OK)
+        {
+            rv = rv2;
+        }
+    }
+
+    if (kausfHandle != CK_INVALID_HANDLE)
+    {
+        CK_RV rv2 = p11tk_destroyObject(sessionHandle,
+                                        kausfHandle);
+
+        if (rv == CKR_OK)
+        {
+            rv = rv2;
+        }
+    }
+
+    if (rv == CKR_OK)
+    {
+        stagesStatistics[FIVEG_AKA__STAGE__TRANSACTION].add(getStageMicroSeconds(transactionBeginTime));
+    }
+
+    return rv;
+}
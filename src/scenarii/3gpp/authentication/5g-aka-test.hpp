@@ -0,0 +1,81 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef AUTHENTICATION_FIVEG_AKA_TEST_HPP
+#define AUTHENTICATION_FIVEG_AKA_TEST_HPP
+
+#include <chrono>
+
+#include "scenarii/scenario.hpp"
+#include "scenarii/test.hpp"
+
+// Maximum of Milenage and TUAK sizes (RAND || XRES || CK || IK || AUTN).
+#define FIVEG_AKA__MAXIMUM_AUTHENTICATION_VECTOR_LENGTH (16 + 32 + 32 + 32 + (6 + 2 + 32))
+
+// Stages of a 5G-AKA transaction (TS 33.501, 6.1.3.2).
+#define FIVEG_AKA__STAGE__AUTHENTICATION_VECTOR 0
+#define FIVEG_AKA__STAGE__KAUSF 1
+#define FIVEG_AKA__STAGE__XRES_STAR 2
+#define FIVEG_AKA__STAGE__HXRES_STAR 3
+#define FIVEG_AKA__STAGE__KSEAF 4
+#define FIVEG_AKA__STAGE__TRANSACTION 5
+#define FIVEG_AKA__STAGES_COUNT 6
+
+extern const char *const FIVEG_AKA__STAGES_NAMES[FIVEG_AKA__STAGES_COUNT];
+
+/*
+ * Each request runs a full 5G-AKA home network transaction in the same
+ * session:
+ *   - Authentication vector generation (Milenage or TUAK, as set by the
+ *     scenario), that provides RAND, XRES, CK, IK and AUTN.
+ *   - KAUSF = KDF(CK || IK, 0x6A, SN name, SQN xor AK).
+ *   - XRES* = KDF(CK || IK, 0x6B, SN name, RAND, XRES) (128 LSB).
+ *   - HXRES* = SHA-256(RAND || XRES*) (128 LSB).
+ *   - KSEAF = KDF(KAUSF, 0x6C, SN name).
+ *
+ * Each KDF runs as an HMAC-SHA-256 on the HSM, with a short-lived session
+ * key object holding CK || IK or KAUSF. The serving network name is taken
+ * from the scenario context.
+ */
+class FivegAkaTest : public Test
+{
+protected:
+    static unsigned long getStageMicroSeconds(const std::chrono::high_resolution_clock::time_point &stageBeginTime);
+
+    // RAND || XRES || CK || IK || AUTN, as generated by the scenario
+    // mechanism (the length is checked against the scenario lengths).
+    virtual CK_RV generateAuthenticationVector(CK_BYTE *const authenticationVector,
+                                               CK_ULONG &authenticationVectorLength);
+
+    // HMAC-SHA-256(Key, FC || P0 || L0 || ... || Pn || Ln).
+    virtual CK_RV deriveKey(const CK_OBJECT_HANDLE keyHandle,
+                            const unsigned char fc,
+                            const unsigned char *const *const parameters,
+                            const size_t *const parametersLengths,
+                            const size_t parametersCount,
+                            CK_BYTE *const derivedKey,
+                            CK_ULONG &derivedKeyLength);
+
+    virtual CK_RV runTransaction();
+
+public:
+    FivegAkaTest(const Scenario &scenario,
+                 const TEST_IDENTIFIER identifier,
+                 const unsigned long requestsCountObjective);
+    ~FivegAkaTest() override = default;
+
+    FivegAkaTest(const FivegAkaTest &) = delete;
+    FivegAkaTest &operator=(const FivegAkaTest &) = delete;
+
+    CK_RV run() override;
+};
+
+#endif /* AUTHENTICATION_FIVEG_AKA_TEST_HPP */
@@ -0,0 +1,141 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <chrono>
+#include <string>
+
+#include "5g-eap-aka-prime-test.hpp"
+#include "5g-scenario.hpp"
+
+extern "C"
+{
+#include <toolkits/kdf-toolkit.h>
+#include <toolkits/misc-toolkit.h>
+#include <toolkits/p11-toolkit.h>
+}
+
+const char *const EAP_AKA_PRIME__STAGES_NAMES[EAP_AKA_PRIME__STAGES_COUNT] = {"AV",
+                                                                              "CK'/IK'",
+                                                                              "End-to-end"};
+
+FivegEapAkaPrimeTest::FivegEapAkaPrimeTest(const Scenario &_scenario,
+                                           const TEST_IDENTIFIER _identifier,
+                                           const unsigned long _requestsCountObjective) : FivegAkaTest(_scenario,
+                                                                                                       _identifier,
+                                                                                                       _requestsCountObjective)
+{
+    assert(&_scenario != nullptr);
+
+    stagesStatistics.resize(EAP_AKA_PRIME__STAGES_COUNT);
+}
+
+CK_RV FivegEapAkaPrimeTest::runTransaction()
+{
+    const FivegScenario &fivegScenario = (const FivegScenario &)scenario;
+
+    CK_RV rv = CKR_OK;
+
+    const auto transactionBeginTime = std::chrono::high_resolution_clock::now();
+    auto stageBeginTime = transactionBeginTime;
+
+    const std::string &accessNetworkName = scenario.scenarioContext.accessNetworkName;
+
+    const CK_ULONG ckLength = fivegScenario.getCkLength();
+    const CK_ULONG ikLength = fivegScenario.getIkLength();
+
+    CK_BYTE authenticationVector[FIVEG_AKA__MAXIMUM_AUTHENTICATION_VECTOR_LENGTH] = {0};
+    CK_ULONG authenticationVectorLength = GET_ARRAY_SIZE(authenticationVector);
+
+    const CK_BYTE *const ckIk = &authenticationVector[THREE_GPP__RAND_LENGTH + fivegScenario.getResLength()];
+    const CK_BYTE *const sqnXorAk = &ckIk[ckLength + ikLength];
+
+    CK_OBJECT_HANDLE ckIkHandle = CK_INVALID_HANDLE;
+
+    CK_BYTE ckIkPrime[KDFTK_OUTPUT_LENGTH] = {0};
+    CK_ULONG ckIkPrimeLength = GET_ARRAY_SIZE(ckIkPrime);
+
+    //
+    // Authentication vector.
+    //
+    rv = generateAuthenticationVector(authenticationVector,
+                                      authenticationVectorLength);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    stagesStatistics[EAP_AKA_PRIME__STAGE__AUTHENTICATION_VECTOR].add(getStageMicroSeconds(stageBeginTime));
+
+    //
+    // CK' || IK'.
+    //
+    stageBeginTime = std::chrono::high_resolution_clock::now();
+
+    rv = p11tk_createHmacKey(sessionHandle,
+                             ckIk,
+                             ckLength + ikLength,
+                             &ckIkHandle);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot import CK || IK.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    {
+        const unsigned char *const parameters[] = {(const unsigned char *)accessNetworkName.data(),
+                                                   sqnXorAk};
+        const size_t parametersLengths[] = {accessNetworkName.size(),
+                                            THREE_GPP__SQN_LENGTH};
+
+        rv = deriveKey(ckIkHandle,
+                       KDFTK_FC__CK_IK_PRIME,
+                       parameters,
+                       parametersLengths,
+                       GET_ARRAY_SIZE(parameters),
+                       ckIkPrime,
+                       ckIkPrimeLength);
+    }
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot derive CK' || IK'.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    stagesStatistics[EAP_AKA_PRIME__STAGE__CK_IK_PRIME].add(getStageMicroSeconds(stageBeginTime));
+
+EXIT:
+    // The short-lived key is part of the transaction cost.
+    if (ckIkHandle != CK_INVALID_HANDLE)
+    {
+        CK_RV rv2 = p11tk_destroyObject(sessionHandle,
+                                        ckIkHandle);
+
+        if (rv == CKR_OK)
+        {
+            rv = rv2;
+        }
+    }
+
+    if (rv == CKR_OK)
+    {
+        stagesStatistics[EAP_AKA_PRIME__STAGE__TRANSACTION].add(getStageMicroSeconds(transactionBeginTime));
+    }
+
+    return rv;
+}
@@ -0,0 +1,54 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef AUTHENTICATION_FIVEG_EAP_AKA_PRIME_TEST_HPP
+#define AUTHENTICATION_FIVEG_EAP_AKA_PRIME_TEST_HPP
+
+#include "5g-aka-test.hpp"
+
+// Stages of an EAP-AKA' authentication vector generation (RFC 5448, 3.3).
+#define EAP_AKA_PRIME__STAGE__AUTHENTICATION_VECTOR 0
+#define EAP_AKA_PRIME__STAGE__CK_IK_PRIME 1
+#define EAP_AKA_PRIME__STAGE__TRANSACTION 2
+#define EAP_AKA_PRIME__STAGES_COUNT 3
+
+extern const char *const EAP_AKA_PRIME__STAGES_NAMES[EAP_AKA_PRIME__STAGES_COUNT];
+
+/*
+ * Each request generates an EAP-AKA' authentication vector in the same
+ * session:
+ *   - Authentication vector generation (Milenage or TUAK, as set by the
+ *     scenario), that provides RAND, XRES, CK, IK and AUTN.
+ *   - CK' || IK' = KDF(CK || IK, 0x20, access network name, SQN xor AK).
+ *
+ * The KDF runs as an HMAC-SHA-256 on the HSM, with a short-lived session
+ * key object holding CK || IK. The access network name is taken from the
+ * scenario context.
+ *
+ * The 'AV' stage is the cost of a plain Milenage/TUAK request, so that the
+ * other stages give the added cost of EAP-AKA'.
+ */
+class FivegEapAkaPrimeTest : public FivegAkaTest
+{
+protected:
+    CK_RV runTransaction() override;
+
+public:
+    FivegEapAkaPrimeTest(const Scenario &scenario,
+                         const TEST_IDENTIFIER identifier,
+                         const unsigned long requestsCountObjective);
+    ~FivegEapAkaPrimeTest() override = default;
+
+    FivegEapAkaPrimeTest(const FivegEapAkaPrimeTest &) = delete;
+    FivegEapAkaPrimeTest &operator=(const FivegEapAkaPrimeTest &) = delete;
+};
+
+#endif /* AUTHENTICATION_FIVEG_EAP_AKA_PRIME_TEST_HPP */
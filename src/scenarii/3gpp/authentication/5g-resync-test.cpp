@@ -0,0 +1,118 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "5g-scenario.hpp"
+#include "5g-resync-test.hpp"
+#include "5g-test.hpp"
+
+FivegResyncTest::FivegResyncTest(const Scenario &_scenario,
+                                 const TEST_IDENTIFIER _identifier,
+                                 const unsigned long _requestsCountObjective) : Test(_scenario,
+                                                                                     _identifier,
+                                                                                     _requestsCountObjective)
+{
+    assert(&_scenario != nullptr);
+
+    // Nothing else to do here.
+}
+
+CK_RV FivegResyncTest::run()
+{
+    assert(state == TEST_STATE::Started);
+    assert(sessionHandle != CK_INVALID_HANDLE);
+    assert(pMechanism != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    CK_BYTE output[THREE_GPP__AUTHENTICATION_VECTOR_LENGTH] = {0};
+    CK_ULONG outputLength = GET_ARRAY_SIZE(output);
+
+    const CK_BYTE *pRequest = nullptr;
+    CK_ULONG requestLength = 0;
+    const CK_BYTE *pSqnMs = nullptr;
+
+    while ((!terminationRequested) &&
+           ((requestsCountObjective == 0) ||
+            (requestsCount < requestsCountObjective)))
+    {
+        // Each test starts at a different position in the requests pool.
+        rv = ((FivegScenario &)scenario).getResynchronizationRequest(identifier + requestsCount,
+                                                                     pRequest,
+                                                                     requestLength,
+                                                                     pSqnMs);
+
+        beginRequest();
+
+        if (rv != CKR_OK)
+        {
+            writeError("Cannot get a resynchronization request.",
+                       rv);
+
+            errorsCount++;
+        }
+        else
+        {
+            rv = p11tk_getFunctionList()->C_SignInit(sessionHandle,
+                                                     pMechanism,
+                                                     ((FivegScenario &)scenario).getSkHandle());
+
+            if (rv != CKR_OK)
+            {
+                writeError("Cannot initialize resynchronization.",
+                           rv);
+
+                errorsCount++;
+            }
+            else
+            {
+                outputLength = GET_ARRAY_SIZE(output);
+
+                rv = p11tk_getFunctionList()->C_Sign(sessionHandle,
+                                                     (CK_BYTE_PTR)pRequest,
+                                                     requestLength,
+                                                     (CK_BYTE_PTR)output,
+                                                     &outputLength);
+
+                if (rv != CKR_OK)
+                {
+                    writeError("Cannot finalize resynchronization.",
+                               rv);
+
+                    errorsCount++;
+                }
+                else
+                {
+                    // The recovered SQN_MS is checked when it is returned alone.
+                    if ((outputLength == THREE_GPP__SQN_LENGTH) &&
+                        (memcmp(output,
+                                pSqnMs,
+                                THREE_GPP__SQN_LENGTH) != 0))
+                    {
+                        writeError("Recovered SQN_MS doesn't match SQN_MS.",
+                                   rv);
+
+                        errorsCount++;
+                    }
+                }
+            }
+        }
+
+        endRequest();
+    }
+
+    return CKR_OK;
+}
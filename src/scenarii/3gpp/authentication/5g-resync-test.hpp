@@ -0,0 +1,37 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef AUTHENTICATION_RESYNCHRONIZATION_TEST_HPP
+#define AUTHENTICATION_RESYNCHRONIZATION_TEST_HPP
+
+#include "scenarii/scenario.hpp"
+#include "scenarii/test.hpp"
+
+/*
+ * Each request provides RAND || AUTS to the resynchronization mechanism of
+ * the scenario; the resynchronization requests prepared by the scenario are
+ * used in turn.
+ */
+class FivegResyncTest : public Test
+{
+public:
+    FivegResyncTest(const Scenario &scenario,
+                    const TEST_IDENTIFIER identifier,
+                    const unsigned long requestsCountObjective);
+    ~FivegResyncTest() override = default;
+
+    FivegResyncTest(const FivegResyncTest &) = delete;
+    FivegResyncTest &operator=(const FivegResyncTest &) = delete;
+
+    CK_RV run() override;
+};
+
+#endif /* AUTHENTICATION_RESYNCHRONIZATION_TEST_HPP */
@@ -11,6 +11,8 @@
 
 #include <cassert>
 #include <cstdio>
+#include <random>
+#include <unistd.h>
 
 extern "C"
 {
@@ -166,11 +168,103 @@ unsigned int FivegScenario::getFlagsCount() const
     return 4;
 }
 
+void FivegScenario::generateResynchronizationChallenge(const unsigned long requestIndex,
+                                                       CK_BYTE rand[THREE_GPP__RAND_LENGTH],
+                                                       CK_BYTE sqnMs[THREE_GPP__SQN_LENGTH]) const
+{
+    assert(rand != nullptr);
+    assert(sqnMs != nullptr);
+
+    // RAND values are pseudo-random but reproducible from one run to another.
+    std::minstd_rand randomGenerator;
+
+    randomGenerator.seed((unsigned int)(requestIndex + 1));
+
+    for (size_t index = 0; index < THREE_GPP__RAND_LENGTH; index++)
+    {
+        rand[index] = (CK_BYTE)(randomGenerator() & 0x0FF);
+    }
+
+    // The USIM is considered as being ahead of the network: SQN_MS = SQN + index + 1.
+    unsigned long carry = requestIndex + 1;
+
+    for (size_t index = THREE_GPP__SQN_LENGTH; index > 0; index--)
+    {
+        carry += sqn[index - 1];
+
+        sqnMs[index - 1] = (CK_BYTE)(carry & 0x0FF);
+
+        carry >>= 8;
+    }
+}
+
+CK_RV FivegScenario::generateSoftwareAuthenticationVectors(const size_t count,
+                                                           CK_BYTE *const authenticationVectors) const
+{
+    assert(count > 0);
+    assert(authenticationVectors != nullptr);
+
+    return CKR_FUNCTION_NOT_SUPPORTED;
+}
+
+CK_ULONG FivegScenario::getCkLength() const
+{
+    return THREE_GPP__CK_LENGTH;
+}
+
+CK_ULONG FivegScenario::getIkLength() const
+{
+    return THREE_GPP__IK_LENGTH;
+}
+
+CK_ULONG FivegScenario::getMacLength() const
+{
+    return THREE_GPP__MAC_LENGTH;
+}
+
+CK_ULONG FivegScenario::getResLength() const
+{
+    return THREE_GPP__RES_LENGTH;
+}
+
+CK_RV FivegScenario::getResynchronizationRequest(const unsigned long requestIndex,
+                                                 const CK_BYTE *&pRequest,
+                                                 CK_ULONG &requestLength,
+                                                 const CK_BYTE *&pSqnMs) const
+{
+    assert(&pRequest != nullptr);
+    assert(&requestLength != nullptr);
+    assert(&pSqnMs != nullptr);
+
+    if (resynchronizationRequestLength == 0)
+    {
+        return CKR_FUNCTION_NOT_SUPPORTED;
+    }
+
+    const unsigned long index = requestIndex % THREE_GPP__RESYNCHRONIZATION_REQUESTS_COUNT;
+
+    pRequest = resynchronizationRequests[index];
+    requestLength = resynchronizationRequestLength;
+    pSqnMs = resynchronizationSqnMs[index];
+
+    return CKR_OK;
+}
+
 CK_OBJECT_HANDLE FivegScenario::getSkHandle() const
 {
     return skHandle;
 }
 
+size_t FivegScenario::getSoftwareBuffersCount() const
+{
+    return 0;
+}
+
+std::string FivegScenario::getSoftwareImplementation() const
+{
+    return "";
+}
+
 CK_RV FivegScenario::initialize()
 {
     assert(state == SCENARIO_STATE::Prepared);
@@ -632,3 +726,29 @@ void FivegScenario::writeDebugInformation() const
                     eki,
                     ekiLength);
 }
+
+void FivegScenario::writeStatistics() const
+{
+    Scenario::writeStatistics();
+
+    if (getSoftwareBuffersCount() == 0)
+    {
+        return;
+    }
+
+    // The tests cannot use more cores than the online ones.
+    const long processorsCount = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t coresCount = tests.size();
+
+    if ((processorsCount > 0) &&
+        ((size_t)processorsCount < coresCount))
+    {
+        coresCount = (size_t)processorsCount;
+    }
+
+    fprintf(stdout,
+            "    Software engine: %s (%ld buffers), AVs per second per core = %ld\n",
+            getSoftwareImplementation().c_str(),
+            (unsigned long)getSoftwareBuffersCount(),
+            getTps() / (unsigned long)coresCount);
+}
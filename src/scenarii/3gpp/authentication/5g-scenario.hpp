@@ -32,6 +32,27 @@
 #define THREE_GPP__SQN_LENGTH 6
 #define THREE_GPP__AMF_LENGTH 2
 
+#define THREE_GPP__RAND_LENGTH 16
+
+// Default (Milenage) sizes.
+#define THREE_GPP__RES_LENGTH 8
+#define THREE_GPP__CK_LENGTH 16
+#define THREE_GPP__IK_LENGTH 16
+#define THREE_GPP__MAC_LENGTH 8
+
+// Default network names of the key derivations (see the ha-bench options).
+#define THREE_GPP__DEFAULT_SERVING_NETWORK_NAME "5G:mnc001.mcc001.3gppnetwork.org"
+#define THREE_GPP__DEFAULT_ACCESS_NETWORK_NAME "WLAN"
+
+// Maximum of Milenage and TUAK sizes (SQN_MS xor AK || MAC-S).
+#define THREE_GPP__AUTS_LENGTH (THREE_GPP__SQN_LENGTH + 32)
+
+// RAND || AUTS, as provided to the resynchronization mechanisms.
+#define THREE_GPP__RESYNCHRONIZATION_REQUEST_LENGTH (THREE_GPP__RAND_LENGTH + THREE_GPP__AUTS_LENGTH)
+
+// Number of distinct resynchronization requests used in turn by the tests.
+#define THREE_GPP__RESYNCHRONIZATION_REQUESTS_COUNT 32
+
 /*
  * 5g authentication scenario flags are defined as follows:
  *   vxyz:
@@ -80,6 +101,12 @@ protected:
     CK_BYTE sqn[THREE_GPP__SQN_LENGTH] = {0};
     CK_BYTE amf[THREE_GPP__AMF_LENGTH] = {0};
 
+    // Only used by the resynchronization scenarios: each request is made of
+    // RAND || AUTS, AUTS being computed for SQN_MS as a USIM would do.
+    CK_BYTE resynchronizationRequests[THREE_GPP__RESYNCHRONIZATION_REQUESTS_COUNT][THREE_GPP__RESYNCHRONIZATION_REQUEST_LENGTH] = {{0}};
+    CK_BYTE resynchronizationSqnMs[THREE_GPP__RESYNCHRONIZATION_REQUESTS_COUNT][THREE_GPP__SQN_LENGTH] = {{0}};
+    CK_ULONG resynchronizationRequestLength = 0;
+
     FivegScenario(const ScenarioContext &scenarioContext,
                   const SCENARIO_FLAGS flags,
                   const SCENARIO_IDENTIFIER scenarioIdentifier,
@@ -93,6 +120,10 @@ protected:
 
     CK_RV prepareScenario() override;
 
+    virtual void generateResynchronizationChallenge(const unsigned long requestIndex,
+                                                    CK_BYTE rand[THREE_GPP__RAND_LENGTH],
+                                                    CK_BYTE sqnMs[THREE_GPP__SQN_LENGTH]) const;
+
 public:
     const bool isUsingOp;
     const bool isUsingCipheredOpOrOpc;
@@ -104,8 +135,30 @@ public:
     FivegScenario(const FivegScenario &) = delete;
     FivegScenario &operator=(const FivegScenario &) = delete;
 
+    // Only used by the software scenarii: generates up to
+    // getSoftwareBuffersCount() authentication vectors together, without
+    // the HSM, the RAND of each vector being read from its beginning.
+    virtual CK_RV generateSoftwareAuthenticationVectors(const size_t count,
+                                                        CK_BYTE *const authenticationVectors) const;
+    virtual size_t getSoftwareBuffersCount() const;
+
+    // E.g. 'AES-NI', written with the statistics of the software scenarii.
+    virtual std::string getSoftwareImplementation() const;
+
     virtual CK_OBJECT_HANDLE getSkHandle() const;
 
+    // Lengths of the fields of the authentication vectors produced by the
+    // authentication mechanism (RAND || XRES || CK || IK || AUTN).
+    virtual CK_ULONG getCkLength() const;
+    virtual CK_ULONG getIkLength() const;
+    virtual CK_ULONG getMacLength() const;
+    virtual CK_ULONG getResLength() const;
+
+    virtual CK_RV getResynchronizationRequest(const unsigned long requestIndex,
+                                              const CK_BYTE *&pRequest,
+                                              CK_ULONG &requestLength,
+                                              const CK_BYTE *&pSqnMs) const;
+
     bool checkFlags(const SCENARIO_FLAGS flags) const override;
     const char *getFlagDescription(const unsigned int position) const override;
     unsigned int getFlagsCount() const override;
@@ -113,6 +166,10 @@ public:
     CK_RV initialize() override;
 
     void writeDebugInformation() const override;
+
+    // The software scenarii also write the vectors generated per second by
+    // each core used.
+    void writeStatistics() const override;
 };
 
 #endif /* AUTHENTICATION_AUTHENTICATION_SCENARIO_HPP */
\ No newline at end of file
@@ -0,0 +1,127 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "5g-scenario.hpp"
+#include "5g-software-test.hpp"
+
+FivegSoftwareTest::FivegSoftwareTest(const Scenario &_scenario,
+                                     const TEST_IDENTIFIER _identifier,
+                                     const unsigned long _requestsCountObjective) : Test(_scenario,
+                                                                                         _identifier,
+                                                                                         _requestsCountObjective),
+                                                                                    randomGenerator(_identifier + 1)
+{
+    assert(&_scenario != nullptr);
+
+    // Nothing else to do here.
+}
+
+CK_RV FivegSoftwareTest::initialize()
+{
+    assert(state == TEST_STATE::Prepared);
+
+    // No mechanism is needed.
+    state = TEST_STATE::Initialized;
+
+    return CKR_OK;
+}
+
+CK_RV FivegSoftwareTest::prepare()
+{
+    assert(state == TEST_STATE::Created);
+
+    // No session is needed.
+    state = TEST_STATE::Prepared;
+
+    return CKR_OK;
+}
+
+CK_RV FivegSoftwareTest::run()
+{
+    assert(state == TEST_STATE::Started);
+
+    CK_RV rv = CKR_OK;
+
+    const auto &fivegScenario = (const FivegScenario &)scenario;
+    const size_t buffersCount = fivegScenario.getSoftwareBuffersCount();
+    const size_t authenticationVectorLength = THREE_GPP__RAND_LENGTH +
+                                              fivegScenario.getResLength() +
+                                              fivegScenario.getCkLength() +
+                                              fivegScenario.getIkLength() +
+                                              THREE_GPP__SQN_LENGTH +
+                                              THREE_GPP__AMF_LENGTH +
+                                              fivegScenario.getMacLength();
+
+    std::vector<CK_BYTE> authenticationVectors(buffersCount * authenticationVectorLength);
+
+    assert(buffersCount > 0);
+
+    while ((!terminationRequested) &&
+           ((requestsCountObjective == 0) ||
+            (requestsCount < requestsCountObjective)))
+    {
+        size_t count = buffersCount;
+
+        // Do not go past the requests count objective.
+        if ((requestsCountObjective != 0) &&
+            ((requestsCountObjective - requestsCount) < count))
+        {
+            count = requestsCountObjective - requestsCount;
+        }
+
+        for (size_t vectorIndex = 0; vectorIndex < count; vectorIndex++)
+        {
+            CK_BYTE *const rand = &authenticationVectors[vectorIndex * authenticationVectorLength];
+
+            for (size_t index = 0; index < THREE_GPP__RAND_LENGTH; index += 8)
+            {
+                const uint64_t value = randomGenerator();
+
+                memcpy(&rand[index],
+                       &value,
+                       8);
+            }
+        }
+
+        // Each vector of the batch is accounted as a request.
+        beginRequest();
+
+        requestsCount += count - 1;
+
+        rv = fivegScenario.generateSoftwareAuthenticationVectors(count,
+                                                                 authenticationVectors.data());
+
+        if (rv != CKR_OK)
+        {
+            writeError("Cannot generate the authentication vectors.",
+                       rv);
+
+            errorsCount += count;
+        }
+        else
+        {
+            for (size_t vectorIndex = 0; vectorIndex < count; vectorIndex++)
+            {
+                sampleOutput(&authenticationVectors[vectorIndex * authenticationVectorLength],
+                             (CK_ULONG)authenticationVectorLength);
+            }
+        }
+
+        endRequest();
+    }
+
+    return CKR_OK;
+}
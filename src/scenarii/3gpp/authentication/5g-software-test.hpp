@@ -0,0 +1,50 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef AUTHENTICATION_SOFTWARE_TEST_HPP
+#define AUTHENTICATION_SOFTWARE_TEST_HPP
+
+#include <random>
+
+#include "scenarii/scenario.hpp"
+#include "scenarii/test.hpp"
+
+/*
+ * Generates the authentication vectors in software, without the HSM (see
+ * FivegScenario::generateSoftwareAuthenticationVectors()), as a baseline of
+ * what a client core can produce.
+ *
+ * Notes:
+ *   - Each authentication vector is accounted as a request, but the vectors
+ *     are generated by batches: the latencies are the ones of the batches.
+ *   - No session is used.
+ */
+class FivegSoftwareTest : public Test
+{
+protected:
+    // RAND values are pseudo-random but reproducible from one run to another.
+    std::mt19937_64 randomGenerator;
+
+public:
+    FivegSoftwareTest(const Scenario &scenario,
+                      const TEST_IDENTIFIER identifier,
+                      const unsigned long requestsCountObjective);
+    ~FivegSoftwareTest() override = default;
+
+    FivegSoftwareTest(const FivegSoftwareTest &) = delete;
+    FivegSoftwareTest &operator=(const FivegSoftwareTest &) = delete;
+
+    CK_RV initialize() override;
+    CK_RV prepare() override;
+    CK_RV run() override;
+};
+
+#endif /* AUTHENTICATION_SOFTWARE_TEST_HPP */
@@ -43,11 +43,11 @@ CK_RV FivegTest::run()
            ((requestsCountObjective == 0) ||
             (requestsCount < requestsCountObjective)))
     {
-        requestsCount++;
+        beginRequest();
 
-        rv = C_SignInit(sessionHandle,
-                        pMechanism,
-                        ((FivegScenario &)scenario).getSkHandle());
+        rv = p11tk_getFunctionList()->C_SignInit(sessionHandle,
+                                                 pMechanism,
+                                                 ((FivegScenario &)scenario).getSkHandle());
 
         if (scenario.scenarioContext.withDebug)
         {
@@ -64,11 +64,11 @@ CK_RV FivegTest::run()
         }
         else
         {
-            rv = C_Sign(sessionHandle,
-                        (CK_BYTE_PTR) nullptr,
-                        (CK_ULONG)0,
-                        (CK_BYTE_PTR)authenticationVector,
-                        &authenticationVectorLength);
+            rv = p11tk_getFunctionList()->C_Sign(sessionHandle,
+                                                 (CK_BYTE_PTR) nullptr,
+                                                 (CK_ULONG)0,
+                                                 (CK_BYTE_PTR)authenticationVector,
+                                                 &authenticationVectorLength);
 
             if (rv != CKR_OK)
             {
@@ -77,7 +77,14 @@ CK_RV FivegTest::run()
 
                 errorsCount++;
             }
+            else
+            {
+                sampleOutput(authenticationVector,
+                             authenticationVectorLength);
+            }
         }
+
+        endRequest();
     }
 
     return CKR_OK;
@@ -15,6 +15,7 @@
 
 extern "C"
 {
+#include <toolkits/comp128-toolkit.h>
 #include <toolkits/misc-toolkit.h>
 }
 
@@ -23,6 +24,17 @@ extern "C"
 
 const char *const COMP_128__TITLE = "COMP-128";
 
+// Ki and RAND of the test set 1 of 3GPP TS 35.208, with the SRES and Kc of
+// the versions 1, 2 and 3.
+static const CK_BYTE COMP_128__KNOWN_ANSWER__KI[COMP128TK_KI_LENGTH] = {0x46, 0x5b, 0x5c, 0xe8, 0xb1, 0x99, 0xb4, 0x9f, 0xaa, 0x5f, 0x0a, 0x2e, 0xe2, 0x38, 0xa6, 0xbc};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__RAND[COMP128TK_RAND_LENGTH] = {0x23, 0x55, 0x3c, 0xbe, 0x96, 0x37, 0xa8, 0x9d, 0x21, 0x8a, 0xe6, 0x4d, 0xae, 0x47, 0xbf, 0x35};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__V1_SRES[COMP128TK_SRES_LENGTH] = {0x27, 0xc4, 0x43, 0xca};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__V1_KC[COMP128TK_KC_LENGTH] = {0xe8, 0xd3, 0x11, 0xd1, 0x50, 0x01, 0x74, 0x00};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__V2_SRES[COMP128TK_SRES_LENGTH] = {0xf7, 0xe9, 0x68, 0x10};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__V2_KC[COMP128TK_KC_LENGTH] = {0x63, 0x76, 0x02, 0x52, 0xcb, 0x4a, 0xc0, 0x00};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__V3_SRES[COMP128TK_SRES_LENGTH] = {0xf7, 0xe9, 0x68, 0x10};
+static const CK_BYTE COMP_128__KNOWN_ANSWER__V3_KC[COMP128TK_KC_LENGTH] = {0x63, 0x76, 0x02, 0x52, 0xcb, 0x4a, 0xc1, 0x40};
+
 Comp128Scenario::Comp128Scenario(const ScenarioContext &_scenarioContext,
                                  const SCENARIO_FLAGS _flags,
                                  const SCENARIO_IDENTIFIER _scenarioIdentifier,
@@ -70,6 +82,41 @@ bool Comp128Scenario::checkFlag(const unsigned int position,
                                value);
 }
 
+CK_RV Comp128Scenario::checkVerificationKnownAnswers() const
+{
+    static_assert(COMP_128__KI_LENGTH == COMP128TK_KI_LENGTH,
+                  "Inconsistent COMP-128 lengths.");
+
+    const CK_BYTE *const knownAnswers[][2] = {{COMP_128__KNOWN_ANSWER__V1_SRES, COMP_128__KNOWN_ANSWER__V1_KC},
+                                              {COMP_128__KNOWN_ANSWER__V2_SRES, COMP_128__KNOWN_ANSWER__V2_KC},
+                                              {COMP_128__KNOWN_ANSWER__V3_SRES, COMP_128__KNOWN_ANSWER__V3_KC}};
+
+    if (!comp128tk_checkTables())
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    // All the versions are checked, whatever the one of the scenario.
+    for (unsigned int knownAnswerVersion = 1; knownAnswerVersion <= 3; knownAnswerVersion++)
+    {
+        CK_BYTE sres[COMP128TK_SRES_LENGTH] = {0};
+        CK_BYTE kc[COMP128TK_KC_LENGTH] = {0};
+
+        if (!comp128tk_compute(knownAnswerVersion,
+                               COMP_128__KNOWN_ANSWER__KI,
+                               COMP_128__KNOWN_ANSWER__RAND,
+                               sres,
+                               kc) ||
+            (memcmp(sres, knownAnswers[knownAnswerVersion - 1][0], COMP128TK_SRES_LENGTH) != 0) ||
+            (memcmp(kc, knownAnswers[knownAnswerVersion - 1][1], COMP128TK_KC_LENGTH) != 0))
+        {
+            return CKR_GENERAL_ERROR;
+        }
+    }
+
+    return CKR_OK;
+}
+
 CK_RV Comp128Scenario::clean()
 {
     assert((state == SCENARIO_STATE::Created) ||
@@ -163,6 +210,11 @@ CK_OBJECT_HANDLE Comp128Scenario::getSkHandle() const
     return skHandle;
 }
 
+std::string Comp128Scenario::getVerifiedAlgorithm() const
+{
+    return std::string(COMP_128__TITLE) + " v" + std::to_string(version);
+}
+
 CK_RV Comp128Scenario::initialize()
 {
     assert(state == SCENARIO_STATE::Prepared);
@@ -286,6 +338,27 @@ END:
     return rv;
 }
 
+bool Comp128Scenario::verifyOutput(const CK_BYTE *const output,
+                                   const CK_ULONG outputLength) const
+{
+    assert(output != nullptr);
+
+    CK_BYTE triplet[COMP128TK_TRIPLET_LENGTH] = {0};
+
+    if (outputLength != COMP128TK_TRIPLET_LENGTH)
+    {
+        return false;
+    }
+
+    return comp128tk_generateTriplet(version,
+                                     ki,
+                                     output,
+                                     triplet) &&
+           (memcmp(triplet,
+                   output,
+                   COMP128TK_TRIPLET_LENGTH) == 0);
+}
+
 void Comp128Scenario::writeDebugInformation() const
 {
     Scenario::writeDebugInformation();
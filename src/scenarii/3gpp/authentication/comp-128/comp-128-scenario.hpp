@@ -43,6 +43,8 @@ protected:
     CK_BYTE eki[COMP_128__EKI_LENGTH] = {0};
     CK_ULONG ekiLength = GET_ARRAY_SIZE(eki);
 
+    CK_RV checkVerificationKnownAnswers() const override;
+
     CK_RV clean() override;
 
     CK_RV prepareScenario() override;
@@ -71,6 +73,13 @@ public:
 
     CK_RV getNewMechanism(CK_MECHANISM *&pMechanism) const override;
 
+    // E.g. 'COMP-128 v1', so that the mismatches are reported per version.
+    std::string getVerifiedAlgorithm() const override;
+
+    // Recomputes SRES and Kc from the RAND of the output.
+    bool verifyOutput(const CK_BYTE *const output,
+                      const CK_ULONG outputLength) const override;
+
     void writeDebugInformation() const override;
 };
 
@@ -44,11 +44,11 @@ CK_RV Comp128Test::run()
            ((requestsCountObjective == 0) ||
             (requestsCount < requestsCountObjective)))
     {
-        requestsCount++;
+        beginRequest();
 
-        rv = C_SignInit(sessionHandle,
-                        pMechanism,
-                        ((Comp128Scenario &)scenario).getSkHandle());
+        rv = p11tk_getFunctionList()->C_SignInit(sessionHandle,
+                                                 pMechanism,
+                                                 ((Comp128Scenario &)scenario).getSkHandle());
 
         if (rv != CKR_OK)
         {
@@ -59,11 +59,11 @@ CK_RV Comp128Test::run()
         }
         else
         {
-            rv = C_Sign(sessionHandle,
-                        (CK_BYTE_PTR) nullptr,
-                        (CK_ULONG)0,
-                        (CK_BYTE_PTR)authenticationVector,
-                        &authenticationVectorLength);
+            rv = p11tk_getFunctionList()->C_Sign(sessionHandle,
+                                                 (CK_BYTE_PTR) nullptr,
+                                                 (CK_ULONG)0,
+                                                 (CK_BYTE_PTR)authenticationVector,
+                                                 &authenticationVectorLength);
 
             if (rv != CKR_OK)
             {
@@ -72,7 +72,14 @@ CK_RV Comp128Test::run()
 
                 errorsCount++;
             }
+            else
+            {
+                sampleOutput(authenticationVector,
+                             authenticationVectorLength);
+            }
         }
+
+        endRequest();
     }
 
     return CKR_OK;
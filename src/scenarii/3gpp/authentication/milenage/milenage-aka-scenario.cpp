@@ -0,0 +1,46 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <string>
+
+#include "milenage-aka-scenario.hpp"
+#include "scenarii/3gpp/authentication/5g-aka-test.hpp"
+
+const char *const MILENAGE_AKA__TITLE = "Milenage 5G-AKA";
+
+MilenageAkaScenario::MilenageAkaScenario(const ScenarioContext &_scenarioContext,
+                                         const SCENARIO_FLAGS _flags,
+                                         const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                         const size_t testsCount,
+                                         const unsigned long _requestsCountPerTest) : MilenageScenario(_scenarioContext,
+                                                                                                       _flags,
+                                                                                                       _scenarioIdentifier,
+                                                                                                       testsCount,
+                                                                                                       _requestsCountPerTest,
+                                                                                                       MILENAGE_AKA__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Replace the authentication tests by 5G-AKA transaction tests.
+    for (size_t testIndex = 0;
+         testIndex < tests.size();
+         testIndex++)
+    {
+        tests[testIndex] = std::make_shared<FivegAkaTest>(*this,
+                                                          (TEST_IDENTIFIER)testIndex,
+                                                          _requestsCountPerTest);
+    }
+
+    stagesNames.assign(&FIVEG_AKA__STAGES_NAMES[0],
+                       &FIVEG_AKA__STAGES_NAMES[FIVEG_AKA__STAGES_COUNT]);
+}
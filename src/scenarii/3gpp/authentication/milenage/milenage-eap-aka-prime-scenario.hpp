@@ -0,0 +1,41 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef MILENAGE_EAP_AKA_PRIME_SCENARIO_HPP
+#define MILENAGE_EAP_AKA_PRIME_SCENARIO_HPP
+
+#include "milenage-scenario.hpp"
+
+extern const char *const MILENAGE_EAP_AKA_PRIME__TITLE;
+
+/*
+ * Milenage EAP-AKA' scenario: each request generates an EAP-AKA' authentication
+ * vector (authentication vector, then CK' and IK'), and the latency of each
+ * stage is reported at the end of the run, the 'AV' stage being the cost of
+ * the plain Milenage request.
+ *
+ * The flags are the same as for the Milenage authentication scenario.
+ */
+class MilenageEapAkaPrimeScenario : public MilenageScenario
+{
+public:
+    MilenageEapAkaPrimeScenario(const ScenarioContext &scenarioContext,
+                                const SCENARIO_FLAGS flags,
+                                const SCENARIO_IDENTIFIER identifier,
+                                const size_t testsCount,
+                                const unsigned long _requestsCountPerTest);
+    ~MilenageEapAkaPrimeScenario() override = default;
+
+    MilenageEapAkaPrimeScenario(const MilenageEapAkaPrimeScenario &) = delete;
+    MilenageEapAkaPrimeScenario &operator=(const MilenageEapAkaPrimeScenario &) = delete;
+};
+
+#endif /* MILENAGE_EAP_AKA_PRIME_SCENARIO_HPP */
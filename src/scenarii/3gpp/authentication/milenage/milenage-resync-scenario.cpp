@@ -0,0 +1,118 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "milenage-resync-scenario.hpp"
+#include "scenarii/3gpp/authentication/5g-resync-test.hpp"
+
+extern "C"
+{
+#include <toolkits/milenage-toolkit.h>
+#include <toolkits/misc-toolkit.h>
+}
+
+const char *const MILENAGE_RESYNC__TITLE = "Milenage Resync";
+
+MilenageResyncScenario::MilenageResyncScenario(const ScenarioContext &_scenarioContext,
+                                               const SCENARIO_FLAGS _flags,
+                                               const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                               const size_t testsCount,
+                                               const unsigned long _requestsCountPerTest) : MilenageScenario(_scenarioContext,
+                                                                                                             _flags,
+                                                                                                             _scenarioIdentifier,
+                                                                                                             testsCount,
+                                                                                                             _requestsCountPerTest,
+                                                                                                             MILENAGE_RESYNC__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Replace the authentication tests by resynchronization tests.
+    for (size_t testIndex = 0;
+         testIndex < tests.size();
+         testIndex++)
+    {
+        tests[testIndex] = std::make_shared<FivegResyncTest>(*this,
+                                                             (TEST_IDENTIFIER)testIndex,
+                                                             _requestsCountPerTest);
+    }
+}
+
+CK_RV MilenageResyncScenario::checkVerificationKnownAnswers() const
+{
+    // The outputs of the resynchronizations are not verified.
+    return CKR_FUNCTION_NOT_SUPPORTED;
+}
+
+CK_RV MilenageResyncScenario::getNewMechanism(CK_MECHANISM *&pMechanism) const
+{
+    assert(state == SCENARIO_STATE::Initialized);
+    assert(&pMechanism != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    // The resynchronization mechanism is using the same parameters as the
+    // authentication one.
+    rv = MilenageScenario::getNewMechanism(pMechanism);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    pMechanism->mechanism = CKM_MILENAGE_RESYNC;
+
+EXIT:
+    return rv;
+}
+
+CK_RV MilenageResyncScenario::setScenarioData()
+{
+    CK_RV rv = CKR_OK;
+
+    rv = MilenageScenario::setScenarioData();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    static_assert(MILENAGE__RC_LENGTH == MLNTK_RC_LENGTH,
+                  "Inconsistent RC lengths.");
+    static_assert((THREE_GPP__RAND_LENGTH + MLNTK_AUTS_LENGTH) <= THREE_GPP__RESYNCHRONIZATION_REQUEST_LENGTH,
+                  "Inconsistent resynchronization request lengths.");
+
+    for (unsigned long requestIndex = 0;
+         requestIndex < THREE_GPP__RESYNCHRONIZATION_REQUESTS_COUNT;
+         requestIndex++)
+    {
+        CK_BYTE *const request = resynchronizationRequests[requestIndex];
+
+        generateResynchronizationChallenge(requestIndex,
+                                           request,
+                                           resynchronizationSqnMs[requestIndex]);
+
+        mlntk_generateAuts(ki,
+                           subscriberOpc,
+                           (isUsingDefaultRc ? nullptr : rc),
+                           request,
+                           resynchronizationSqnMs[requestIndex],
+                           &request[THREE_GPP__RAND_LENGTH]);
+    }
+
+    resynchronizationRequestLength = THREE_GPP__RAND_LENGTH + MLNTK_AUTS_LENGTH;
+
+EXIT:
+    return rv;
+}
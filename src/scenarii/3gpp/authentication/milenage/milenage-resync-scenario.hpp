@@ -0,0 +1,50 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef MILENAGE_RESYNCHRONIZATION_SCENARIO_HPP
+#define MILENAGE_RESYNCHRONIZATION_SCENARIO_HPP
+
+#include "milenage-scenario.hpp"
+
+extern const char *const MILENAGE_RESYNC__TITLE;
+
+/*
+ * Milenage resynchronization scenario: the HSM verifies AUTS (MAC-S) and
+ * recovers SQN_MS, as requested by the network when a UE rejects AUTN
+ * because of a synchronization failure.
+ *
+ * The AUTS values are computed in software for the test set subscriber
+ * (i.e. as the USIM would), for several RAND and SQN_MS values.
+ *
+ * The flags are the same as for the Milenage authentication scenario.
+ */
+class MilenageResyncScenario : public MilenageScenario
+{
+protected:
+    CK_RV checkVerificationKnownAnswers() const override;
+
+    CK_RV setScenarioData() override;
+
+public:
+    MilenageResyncScenario(const ScenarioContext &scenarioContext,
+                           const SCENARIO_FLAGS flags,
+                           const SCENARIO_IDENTIFIER scenarioIdentifier,
+                           const size_t testsCount,
+                           const unsigned long _requestsCountPerTest);
+    ~MilenageResyncScenario() override = default;
+
+    MilenageResyncScenario(const MilenageResyncScenario &) = delete;
+    MilenageResyncScenario &operator=(const MilenageResyncScenario &) = delete;
+
+    CK_RV getNewMechanism(CK_MECHANISM *&pMechanism) const override;
+};
+
+#endif /* MILENAGE_RESYNCHRONIZATION_SCENARIO_HPP */
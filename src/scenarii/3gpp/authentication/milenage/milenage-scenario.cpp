@@ -17,6 +17,7 @@
 
 extern "C"
 {
+#include <toolkits/milenage-toolkit.h>
 #include <toolkits/misc-toolkit.h>
 }
 
@@ -38,18 +39,51 @@ const CK_BYTE MilenageScenario::MILENAGE__TEST_SET_1__KI[THREE_GPP__KI_LENGTH] =
 const CK_BYTE MilenageScenario::MILENAGE__TEST_SET_1__SQN[THREE_GPP__SQN_LENGTH] = {0};
 const CK_BYTE MilenageScenario::MILENAGE__TEST_SET_1__AMF[THREE_GPP__AMF_LENGTH] = {0};
 
+// Inputs and outputs of the test set 1 of TS 35.208 (same Ki, OP and OPc as
+// above), used as known answers by the verification of the outputs.
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__RAND[MLNTK_RAND_LENGTH] = {0x23, 0x55, 0x3c, 0xbe, 0x96, 0x37, 0xa8, 0x9d, 0x21, 0x8a, 0xe6, 0x4d, 0xae, 0x47, 0xbf, 0x35};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__SQN[MLNTK_SQN_LENGTH] = {0xff, 0x9b, 0xb4, 0xd0, 0xb6, 0x07};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__AMF[MLNTK_AMF_LENGTH] = {0xb9, 0xb9};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F1[MLNTK_MAC_LENGTH] = {0x4a, 0x9f, 0xfa, 0xc3, 0x54, 0xdf, 0xaf, 0xb3};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F1_STAR[MLNTK_MAC_LENGTH] = {0x01, 0xcf, 0xaf, 0x9e, 0xc4, 0xe8, 0x71, 0xe9};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F2[MLNTK_RES_LENGTH] = {0xa5, 0x42, 0x11, 0xd5, 0xe3, 0xba, 0x50, 0xbf};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F3[MLNTK_CK_LENGTH] = {0xb4, 0x0b, 0xa9, 0xa3, 0xc5, 0x8b, 0x2a, 0x05, 0xbb, 0xf0, 0xd9, 0x87, 0xb2, 0x1b, 0xf8, 0xcb};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F4[MLNTK_IK_LENGTH] = {0xf7, 0x69, 0xbc, 0xd7, 0x51, 0x04, 0x46, 0x04, 0x12, 0x76, 0x72, 0x71, 0x1c, 0x6d, 0x34, 0x41};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F5[MLNTK_AK_LENGTH] = {0xaa, 0x68, 0x9c, 0x64, 0x83, 0x70};
+static const CK_BYTE MILENAGE__KNOWN_ANSWER__F5_STAR[MLNTK_AK_LENGTH] = {0x45, 0x1e, 0x8b, 0xec, 0xa4, 0x3b};
+
+MilenageScenario::MilenageScenario(const ScenarioContext &_scenarioContext,
+                                   const SCENARIO_FLAGS _flags,
+                                   const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                   const size_t testsCount,
+                                   const unsigned long _requestsCountPerTest) : MilenageScenario(_scenarioContext,
+                                                                                                 _flags,
+                                                                                                 _scenarioIdentifier,
+                                                                                                 testsCount,
+                                                                                                 _requestsCountPerTest,
+                                                                                                 MILENAGE__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Nothing else to do here.
+}
+
+// Note: the objects labels are always based on the Milenage title, so that
+// Milenage-based scenarii can share their objects.
 MilenageScenario::MilenageScenario(const ScenarioContext &_scenarioContext,
                                    const SCENARIO_FLAGS _flags,
                                    const SCENARIO_IDENTIFIER _scenarioIdentifier,
                                    const size_t testsCount,
-                                   const unsigned long _requestsCountPerTest) : FivegScenario(_scenarioContext,
-                                                                                              _flags,
-                                                                                              _scenarioIdentifier,
-                                                                                              testsCount,
-                                                                                              _requestsCountPerTest,
-                                                                                              MILENAGE__TITLE),
-                                                                                isUsingDefaultRc(getFlagValueAsBoolean(flags,
-                                                                                                                       5))
+                                   const unsigned long _requestsCountPerTest,
+                                   const std::string title) : FivegScenario(_scenarioContext,
+                                                                            _flags,
+                                                                            _scenarioIdentifier,
+                                                                            testsCount,
+                                                                            _requestsCountPerTest,
+                                                                            title),
+                                                              isUsingDefaultRc(getFlagValueAsBoolean(_flags,
+                                                                                                     5))
 {
     assert(&_scenarioContext != nullptr);
     assert(testsCount > 0);
@@ -72,6 +106,87 @@ MilenageScenario::MilenageScenario(const ScenarioContext &_scenarioContext,
                                   "RC");
 }
 
+CK_RV MilenageScenario::checkVerificationKnownAnswers() const
+{
+    static_assert((MILENAGE__RC_LENGTH == MLNTK_RC_LENGTH) &&
+                      (THREE_GPP__KI_LENGTH == MLNTK_KI_LENGTH) &&
+                      (THREE_GPP__SQN_LENGTH == MLNTK_SQN_LENGTH) &&
+                      (THREE_GPP__AMF_LENGTH == MLNTK_AMF_LENGTH),
+                  "Inconsistent Milenage lengths.");
+
+    CK_BYTE computedOpc[MLNTK_OPC_LENGTH] = {0};
+    CK_BYTE authenticationVector[MLNTK_AV_LENGTH] = {0};
+    CK_BYTE macS[MLNTK_MAC_LENGTH] = {0};
+    CK_BYTE akStar[MLNTK_AK_LENGTH] = {0};
+
+    mlntk_computeOpc(MILENAGE__TEST_SET_1__KI,
+                     MILENAGE__TEST_SET_1__OP,
+                     computedOpc);
+
+    if (memcmp(computedOpc,
+               MILENAGE__TEST_SET_1__OPC,
+               MLNTK_OPC_LENGTH) != 0)
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    // With the default RC, then with the same RC given explicitly.
+    for (const CK_BYTE *const knownAnswerRc : {(const CK_BYTE *)nullptr, MILENAGE__TEST_SET_1__RC})
+    {
+        mlntk_generateAuthenticationVector(MILENAGE__TEST_SET_1__KI,
+                                           MILENAGE__TEST_SET_1__OPC,
+                                           knownAnswerRc,
+                                           MILENAGE__KNOWN_ANSWER__RAND,
+                                           MILENAGE__KNOWN_ANSWER__SQN,
+                                           MILENAGE__KNOWN_ANSWER__AMF,
+                                           authenticationVector);
+
+        const CK_BYTE *const xres = &authenticationVector[MLNTK_RAND_LENGTH];
+        const CK_BYTE *const ck = &xres[MLNTK_RES_LENGTH];
+        const CK_BYTE *const ik = &ck[MLNTK_CK_LENGTH];
+        const CK_BYTE *const autn = &ik[MLNTK_IK_LENGTH];
+        CK_BYTE ak[MLNTK_AK_LENGTH] = {0};
+
+        for (size_t index = 0; index < MLNTK_AK_LENGTH; index++)
+        {
+            ak[index] = autn[index] ^ MILENAGE__KNOWN_ANSWER__SQN[index];
+        }
+
+        if ((memcmp(authenticationVector, MILENAGE__KNOWN_ANSWER__RAND, MLNTK_RAND_LENGTH) != 0) ||
+            (memcmp(xres, MILENAGE__KNOWN_ANSWER__F2, MLNTK_RES_LENGTH) != 0) ||
+            (memcmp(ck, MILENAGE__KNOWN_ANSWER__F3, MLNTK_CK_LENGTH) != 0) ||
+            (memcmp(ik, MILENAGE__KNOWN_ANSWER__F4, MLNTK_IK_LENGTH) != 0) ||
+            (memcmp(ak, MILENAGE__KNOWN_ANSWER__F5, MLNTK_AK_LENGTH) != 0) ||
+            (memcmp(&autn[MLNTK_SQN_LENGTH], MILENAGE__KNOWN_ANSWER__AMF, MLNTK_AMF_LENGTH) != 0) ||
+            (memcmp(&autn[MLNTK_SQN_LENGTH + MLNTK_AMF_LENGTH], MILENAGE__KNOWN_ANSWER__F1, MLNTK_MAC_LENGTH) != 0))
+        {
+            return CKR_GENERAL_ERROR;
+        }
+
+        mlntk_f1Star(MILENAGE__TEST_SET_1__KI,
+                     MILENAGE__TEST_SET_1__OPC,
+                     knownAnswerRc,
+                     MILENAGE__KNOWN_ANSWER__RAND,
+                     MILENAGE__KNOWN_ANSWER__SQN,
+                     MILENAGE__KNOWN_ANSWER__AMF,
+                     macS);
+
+        mlntk_f5Star(MILENAGE__TEST_SET_1__KI,
+                     MILENAGE__TEST_SET_1__OPC,
+                     knownAnswerRc,
+                     MILENAGE__KNOWN_ANSWER__RAND,
+                     akStar);
+
+        if ((memcmp(macS, MILENAGE__KNOWN_ANSWER__F1_STAR, MLNTK_MAC_LENGTH) != 0) ||
+            (memcmp(akStar, MILENAGE__KNOWN_ANSWER__F5_STAR, MLNTK_AK_LENGTH) != 0))
+        {
+            return CKR_GENERAL_ERROR;
+        }
+    }
+
+    return CKR_OK;
+}
+
 CK_RV MilenageScenario::clean()
 {
     CK_RV rv = CKR_OK;
@@ -216,6 +331,11 @@ EXIT:
     return rv;
 }
 
+std::string MilenageScenario::getVerifiedAlgorithm() const
+{
+    return MILENAGE__TITLE;
+}
+
 CK_RV MilenageScenario::initialize()
 {
     assert(state == SCENARIO_STATE::Prepared);
@@ -398,10 +518,48 @@ CK_RV MilenageScenario::setScenarioData()
     COPY_ARRAY_SAFELY(MILENAGE__TEST_SET_1__AMF,
                       amf);
 
+    if (isUsingOp)
+    {
+        mlntk_computeOpc(ki,
+                         op,
+                         subscriberOpc);
+    }
+    else
+    {
+        memcpy(subscriberOpc,
+               opc,
+               MLNTK_OPC_LENGTH);
+    }
+
 EXIT:
     return rv;
 }
 
+bool MilenageScenario::verifyOutput(const CK_BYTE *const output,
+                                    const CK_ULONG outputLength) const
+{
+    assert(output != nullptr);
+
+    CK_BYTE authenticationVector[MLNTK_AV_LENGTH] = {0};
+
+    if (outputLength != MLNTK_AV_LENGTH)
+    {
+        return false;
+    }
+
+    mlntk_generateAuthenticationVector(ki,
+                                       subscriberOpc,
+                                       (isUsingDefaultRc ? nullptr : rc),
+                                       output,
+                                       sqn,
+                                       amf,
+                                       authenticationVector);
+
+    return memcmp(authenticationVector,
+                  output,
+                  MLNTK_AV_LENGTH) == 0;
+}
+
 void MilenageScenario::writeDebugInformation() const
 {
     FivegScenario::writeDebugInformation();
@@ -54,12 +54,24 @@ protected:
     CK_BYTE rc[MILENAGE__RC_LENGTH] = {0};
     CK_BYTE erc[MILENAGE__ERC_LENGTH] = {0};
 
+    // OPc of the subscriber, either given or computed from OP.
+    CK_BYTE subscriberOpc[MILENAGE__OPC_LENGTH] = {0};
+
+    CK_RV checkVerificationKnownAnswers() const override;
+
     CK_RV clean() override;
 
     CK_RV setScenarioData() override;
 
     CK_RV prepareScenario() override;
 
+    MilenageScenario(const ScenarioContext &scenarioContext,
+                     const SCENARIO_FLAGS flags,
+                     const SCENARIO_IDENTIFIER scenarioIdentifier,
+                     const size_t testsCount,
+                     const unsigned long _requestsCountPerTest,
+                     const std::string title);
+
 public:
     //
     // Test set 1 from https://itecspec.com/spec/3gpp-55-205-6-test-data-for-gsm-milenage-informative/.
@@ -87,9 +99,14 @@ public:
     unsigned int getFlagsCount() const override;
 
     CK_RV getNewMechanism(CK_MECHANISM *&pMechanism) const override;
+    std::string getVerifiedAlgorithm() const override;
 
     CK_RV initialize() override;
 
+    // Recomputes the authentication vector from its RAND.
+    bool verifyOutput(const CK_BYTE *const output,
+                      const CK_ULONG outputLength) const override;
+
     void writeDebugInformation() const override;
 };
 
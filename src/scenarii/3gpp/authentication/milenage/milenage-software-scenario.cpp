@@ -0,0 +1,131 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "milenage-software-scenario.hpp"
+#include "scenarii/3gpp/authentication/5g-software-test.hpp"
+
+extern "C"
+{
+#include <toolkits/aes-toolkit.h>
+}
+
+const char *const MILENAGE_SOFTWARE__TITLE = "Milenage software";
+
+MilenageSoftwareScenario::MilenageSoftwareScenario(const ScenarioContext &_scenarioContext,
+                                                   const SCENARIO_FLAGS _flags,
+                                                   const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                                   const size_t testsCount,
+                                                   const unsigned long _requestsCountPerTest) : MilenageScenario(_scenarioContext,
+                                                                                                                 _flags,
+                                                                                                                 _scenarioIdentifier,
+                                                                                                                 testsCount,
+                                                                                                                 _requestsCountPerTest,
+                                                                                                                 MILENAGE_SOFTWARE__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Replace the authentication tests by software tests.
+    for (size_t testIndex = 0;
+         testIndex < tests.size();
+         testIndex++)
+    {
+        tests[testIndex] = std::make_shared<FivegSoftwareTest>(*this,
+                                                               (TEST_IDENTIFIER)testIndex,
+                                                               _requestsCountPerTest);
+    }
+}
+
+CK_RV MilenageSoftwareScenario::clean()
+{
+    return Scenario::clean();
+}
+
+CK_RV MilenageSoftwareScenario::generateSoftwareAuthenticationVectors(const size_t count,
+                                                                      CK_BYTE *const authenticationVectors) const
+{
+    assert(count <= MLNTK_MAXIMUM_BUFFERS_COUNT);
+    assert(authenticationVectors != nullptr);
+
+    // Note: the OPc are computed into a copy, the scenario being shared by
+    // the tests.
+    CK_BYTE opcs[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_OPC_LENGTH] = {0};
+
+    if (!isUsingOp)
+    {
+        memcpy(opcs,
+               buffersOpcs,
+               count * MLNTK_OPC_LENGTH);
+    }
+
+    mlntk_generateAuthenticationVectors(count,
+                                        buffersKis,
+                                        (isUsingOp ? buffersOps : nullptr),
+                                        opcs,
+                                        (isUsingDefaultRc ? nullptr : rc),
+                                        sqn,
+                                        amf,
+                                        authenticationVectors);
+
+    return CKR_OK;
+}
+
+size_t MilenageSoftwareScenario::getSoftwareBuffersCount() const
+{
+    return MLNTK_MAXIMUM_BUFFERS_COUNT;
+}
+
+std::string MilenageSoftwareScenario::getSoftwareImplementation() const
+{
+    return aestk_getBuffersImplementation();
+}
+
+CK_RV MilenageSoftwareScenario::initialize()
+{
+    return Scenario::initialize();
+}
+
+CK_RV MilenageSoftwareScenario::prepareScenario()
+{
+    return Scenario::prepareScenario();
+}
+
+CK_RV MilenageSoftwareScenario::setScenarioData()
+{
+    CK_RV rv = CKR_OK;
+
+    rv = MilenageScenario::setScenarioData();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    for (size_t buffer = 0; buffer < MLNTK_MAXIMUM_BUFFERS_COUNT; buffer++)
+    {
+        memcpy(&buffersKis[buffer * MLNTK_KI_LENGTH],
+               ki,
+               MLNTK_KI_LENGTH);
+        memcpy(&buffersOps[buffer * MLNTK_OP_LENGTH],
+               op,
+               MLNTK_OP_LENGTH);
+        memcpy(&buffersOpcs[buffer * MLNTK_OPC_LENGTH],
+               subscriberOpc,
+               MLNTK_OPC_LENGTH);
+    }
+
+EXIT:
+    return rv;
+}
@@ -0,0 +1,68 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef MILENAGE_SOFTWARE_SCENARIO_HPP
+#define MILENAGE_SOFTWARE_SCENARIO_HPP
+
+#include "milenage-scenario.hpp"
+
+extern "C"
+{
+#include <toolkits/milenage-toolkit.h>
+}
+
+extern const char *const MILENAGE_SOFTWARE__TITLE;
+
+/*
+ * Milenage software scenario: the authentication vectors are generated on
+ * the client cores, without the HSM, the AES blocks of several subscribers
+ * being encrypted together (see mlntk_generateAuthenticationVectors()). It
+ * gives the software baseline to compare the Milenage scenario with.
+ *
+ * The flags are the same as for the Milenage authentication scenario, but
+ * only the RC and the OP/OPc flags change the work done (OPc being derived
+ * from OP for each vector, as done by the HSM); the other ones are accepted
+ * so that the same flags can be given to both scenarii.
+ */
+class MilenageSoftwareScenario : public MilenageScenario
+{
+protected:
+    // The test set subscriber, replicated for each buffer.
+    CK_BYTE buffersKis[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_KI_LENGTH] = {0};
+    CK_BYTE buffersOps[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_OP_LENGTH] = {0};
+    CK_BYTE buffersOpcs[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_OPC_LENGTH] = {0};
+
+    // No object is used in the HSM.
+    CK_RV clean() override;
+    CK_RV prepareScenario() override;
+
+    CK_RV setScenarioData() override;
+
+public:
+    MilenageSoftwareScenario(const ScenarioContext &scenarioContext,
+                             const SCENARIO_FLAGS flags,
+                             const SCENARIO_IDENTIFIER scenarioIdentifier,
+                             const size_t testsCount,
+                             const unsigned long _requestsCountPerTest);
+    ~MilenageSoftwareScenario() override = default;
+
+    MilenageSoftwareScenario(const MilenageSoftwareScenario &) = delete;
+    MilenageSoftwareScenario &operator=(const MilenageSoftwareScenario &) = delete;
+
+    CK_RV generateSoftwareAuthenticationVectors(const size_t count,
+                                                CK_BYTE *const authenticationVectors) const override;
+    size_t getSoftwareBuffersCount() const override;
+    std::string getSoftwareImplementation() const override;
+
+    CK_RV initialize() override;
+};
+
+#endif /* MILENAGE_SOFTWARE_SCENARIO_HPP */
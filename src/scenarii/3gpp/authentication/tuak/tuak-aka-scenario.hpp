@@ -0,0 +1,40 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef TUAK_FIVEG_AKA_SCENARIO_HPP
+#define TUAK_FIVEG_AKA_SCENARIO_HPP
+
+#include "tuak-scenario.hpp"
+
+extern const char *const TUAK_AKA__TITLE;
+
+/*
+ * TUAK 5G-AKA scenario: each request is a full home network 5G-AKA
+ * transaction (authentication vector, KAUSF, XRES*, HXRES* and KSEAF), and
+ * the latency of each stage is reported at the end of the run.
+ *
+ * The flags are the same as for the TUAK authentication scenario.
+ */
+class TuakAkaScenario : public TuakScenario
+{
+public:
+    TuakAkaScenario(const ScenarioContext &scenarioContext,
+                    const SCENARIO_FLAGS flags,
+                    const SCENARIO_IDENTIFIER identifier,
+                    const size_t testsCount,
+                    const unsigned long _requestsCountPerTest);
+    ~TuakAkaScenario() override = default;
+
+    TuakAkaScenario(const TuakAkaScenario &) = delete;
+    TuakAkaScenario &operator=(const TuakAkaScenario &) = delete;
+};
+
+#endif /* TUAK_FIVEG_AKA_SCENARIO_HPP */
@@ -0,0 +1,46 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <string>
+
+#include "tuak-eap-aka-prime-scenario.hpp"
+#include "scenarii/3gpp/authentication/5g-eap-aka-prime-test.hpp"
+
+const char *const TUAK_EAP_AKA_PRIME__TITLE = "TUAK EAP-AKA'";
+
+TuakEapAkaPrimeScenario::TuakEapAkaPrimeScenario(const ScenarioContext &_scenarioContext,
+                                                 const SCENARIO_FLAGS _flags,
+                                                 const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                                 const size_t testsCount,
+                                                 const unsigned long _requestsCountPerTest) : TuakScenario(_scenarioContext,
+                                                                                                           _flags,
+                                                                                                           _scenarioIdentifier,
+                                                                                                           testsCount,
+                                                                                                           _requestsCountPerTest,
+                                                                                                           TUAK_EAP_AKA_PRIME__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Replace the authentication tests by EAP-AKA' tests.
+    for (size_t testIndex = 0;
+         testIndex < tests.size();
+         testIndex++)
+    {
+        tests[testIndex] = std::make_shared<FivegEapAkaPrimeTest>(*this,
+                                                                  (TEST_IDENTIFIER)testIndex,
+                                                                  _requestsCountPerTest);
+    }
+
+    stagesNames.assign(&EAP_AKA_PRIME__STAGES_NAMES[0],
+                       &EAP_AKA_PRIME__STAGES_NAMES[EAP_AKA_PRIME__STAGES_COUNT]);
+}
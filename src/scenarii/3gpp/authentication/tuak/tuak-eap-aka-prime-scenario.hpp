@@ -0,0 +1,41 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef TUAK_EAP_AKA_PRIME_SCENARIO_HPP
+#define TUAK_EAP_AKA_PRIME_SCENARIO_HPP
+
+#include "tuak-scenario.hpp"
+
+extern const char *const TUAK_EAP_AKA_PRIME__TITLE;
+
+/*
+ * TUAK EAP-AKA' scenario: each request generates an EAP-AKA' authentication
+ * vector (authentication vector, then CK' and IK'), and the latency of each
+ * stage is reported at the end of the run, the 'AV' stage being the cost of
+ * the plain TUAK request.
+ *
+ * The flags are the same as for the TUAK authentication scenario.
+ */
+class TuakEapAkaPrimeScenario : public TuakScenario
+{
+public:
+    TuakEapAkaPrimeScenario(const ScenarioContext &scenarioContext,
+                            const SCENARIO_FLAGS flags,
+                            const SCENARIO_IDENTIFIER identifier,
+                            const size_t testsCount,
+                            const unsigned long _requestsCountPerTest);
+    ~TuakEapAkaPrimeScenario() override = default;
+
+    TuakEapAkaPrimeScenario(const TuakEapAkaPrimeScenario &) = delete;
+    TuakEapAkaPrimeScenario &operator=(const TuakEapAkaPrimeScenario &) = delete;
+};
+
+#endif /* TUAK_EAP_AKA_PRIME_SCENARIO_HPP */
@@ -0,0 +1,126 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "tuak-resync-scenario.hpp"
+#include "scenarii/3gpp/authentication/5g-resync-test.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+#include <toolkits/tuak-toolkit.h>
+}
+
+const char *const TUAK_RESYNC__TITLE = "TUAK Resync";
+
+TuakResyncScenario::TuakResyncScenario(const ScenarioContext &_scenarioContext,
+                                       const SCENARIO_FLAGS _flags,
+                                       const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                       const size_t testsCount,
+                                       const unsigned long _requestsCountPerTest) : TuakScenario(_scenarioContext,
+                                                                                                 _flags,
+                                                                                                 _scenarioIdentifier,
+                                                                                                 testsCount,
+                                                                                                 _requestsCountPerTest,
+                                                                                                 TUAK_RESYNC__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Replace the authentication tests by resynchronization tests.
+    for (size_t testIndex = 0;
+         testIndex < tests.size();
+         testIndex++)
+    {
+        tests[testIndex] = std::make_shared<FivegResyncTest>(*this,
+                                                             (TEST_IDENTIFIER)testIndex,
+                                                             _requestsCountPerTest);
+    }
+}
+
+CK_RV TuakResyncScenario::checkVerificationKnownAnswers() const
+{
+    // The outputs of the resynchronizations are not verified.
+    return CKR_FUNCTION_NOT_SUPPORTED;
+}
+
+CK_RV TuakResyncScenario::getNewMechanism(CK_MECHANISM *&pMechanism) const
+{
+    assert(state == SCENARIO_STATE::Initialized);
+    assert(&pMechanism != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    // The resynchronization mechanism is using the same parameters as the
+    // authentication one.
+    rv = TuakScenario::getNewMechanism(pMechanism);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    pMechanism->mechanism = CKM_TUAK_RESYNC;
+
+EXIT:
+    return rv;
+}
+
+CK_RV TuakResyncScenario::setScenarioData()
+{
+    CK_RV rv = CKR_OK;
+
+    rv = TuakScenario::setScenarioData();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    static_assert(TUAKTK_MAXIMUM_AUTS_LENGTH <= THREE_GPP__AUTS_LENGTH,
+                  "Inconsistent AUTS lengths.");
+
+    for (unsigned long requestIndex = 0;
+         requestIndex < THREE_GPP__RESYNCHRONIZATION_REQUESTS_COUNT;
+         requestIndex++)
+    {
+        CK_BYTE *const request = resynchronizationRequests[requestIndex];
+
+        generateResynchronizationChallenge(requestIndex,
+                                           request,
+                                           resynchronizationSqnMs[requestIndex]);
+
+        if (!tuaktk_generateAuts(subscriberTopc,
+                                 ki,
+                                 kiLength,
+                                 request,
+                                 resynchronizationSqnMs[requestIndex],
+                                 (unsigned int)iterations,
+                                 &request[THREE_GPP__RAND_LENGTH],
+                                 (size_t)macLength))
+        {
+            rv = CKR_ARGUMENTS_BAD;
+
+            writeError("Cannot compute AUTS.",
+                       rv);
+
+            goto EXIT;
+        }
+    }
+
+    resynchronizationRequestLength = (CK_ULONG)(THREE_GPP__RAND_LENGTH + THREE_GPP__SQN_LENGTH + macLength);
+
+EXIT:
+    return rv;
+}
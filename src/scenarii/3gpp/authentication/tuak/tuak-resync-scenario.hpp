@@ -0,0 +1,50 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef TUAK_RESYNCHRONIZATION_SCENARIO_HPP
+#define TUAK_RESYNCHRONIZATION_SCENARIO_HPP
+
+#include "tuak-scenario.hpp"
+
+extern const char *const TUAK_RESYNC__TITLE;
+
+/*
+ * TUAK resynchronization scenario: the HSM verifies AUTS (MAC-S) and
+ * recovers SQN_MS, as requested by the network when a UE rejects AUTN
+ * because of a synchronization failure.
+ *
+ * The AUTS values are computed in software for the test set subscriber
+ * (i.e. as the USIM would), for several RAND and SQN_MS values.
+ *
+ * The flags are the same as for the TUAK authentication scenario.
+ */
+class TuakResyncScenario : public TuakScenario
+{
+protected:
+    CK_RV checkVerificationKnownAnswers() const override;
+
+    CK_RV setScenarioData() override;
+
+public:
+    TuakResyncScenario(const ScenarioContext &scenarioContext,
+                       const SCENARIO_FLAGS flags,
+                       const SCENARIO_IDENTIFIER identifier,
+                       const size_t testsCount,
+                       const unsigned long _requestsCountPerTest);
+    ~TuakResyncScenario() override = default;
+
+    TuakResyncScenario(const TuakResyncScenario &) = delete;
+    TuakResyncScenario &operator=(const TuakResyncScenario &) = delete;
+
+    CK_RV getNewMechanism(CK_MECHANISM *&pMechanism) const override;
+};
+
+#endif /* TUAK_RESYNCHRONIZATION_SCENARIO_HPP */
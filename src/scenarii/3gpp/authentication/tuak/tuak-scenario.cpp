@@ -16,6 +16,7 @@
 extern "C"
 {
 #include <toolkits/misc-toolkit.h>
+#include <toolkits/tuak-toolkit.h>
 }
 
 #include "tuak-scenario.hpp"
@@ -33,17 +34,48 @@ const CK_LONG TuakScenario::TUAK__TEST_SET_1__MAC_LENGTH = (CK_LONG)8;
 const CK_LONG TuakScenario::TUAK__TEST_SET_1__CK_LENGTH = (CK_LONG)16;
 const CK_LONG TuakScenario::TUAK__TEST_SET_1__IK_LENGTH = (CK_LONG)16;
 
+// Inputs and outputs of the test set 1 of TS 35.233 (same K, TOP, TOPc, SQN,
+// AMF, iterations and lengths as above), used as known answers by the
+// verification of the outputs.
+static const CK_BYTE TUAK__KNOWN_ANSWER__RAND[TUAKTK_RAND_LENGTH] = {0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F1[8] = {0xf9, 0xa5, 0x4e, 0x6a, 0xea, 0xa8, 0x61, 0x8d};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F1_STAR[8] = {0xe9, 0x4b, 0x4d, 0xc6, 0xc7, 0x29, 0x7d, 0xf3};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F2[4] = {0x65, 0x7a, 0xcd, 0x64};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F3[16] = {0xd7, 0x1a, 0x1e, 0x5c, 0x6c, 0xaf, 0xfe, 0x98, 0x6a, 0x26, 0xf7, 0x83, 0xe5, 0xc7, 0x8b, 0xe1};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F4[16] = {0xbe, 0x84, 0x9f, 0xa2, 0x56, 0x4f, 0x86, 0x9a, 0xec, 0xee, 0x6f, 0x62, 0xd4, 0x33, 0x7e, 0x72};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F5[TUAKTK_AK_LENGTH] = {0x71, 0x9f, 0x1e, 0x9b, 0x90, 0x54};
+static const CK_BYTE TUAK__KNOWN_ANSWER__F5_STAR[TUAKTK_AK_LENGTH] = {0xe7, 0xaf, 0x6b, 0x3d, 0x0e, 0x38};
+
 TuakScenario::TuakScenario(const ScenarioContext &_scenarioContext,
                            const SCENARIO_FLAGS _flags,
                            const SCENARIO_IDENTIFIER _scenarioIdentifier,
                            const size_t testsCount,
-                           const unsigned long _requestsCountPerTest) : FivegScenario(_scenarioContext,
-                                                                                      _flags,
-                                                                                      _scenarioIdentifier,
-                                                                                      testsCount,
-                                                                                      _requestsCountPerTest,
-                                                                                      TUAK__TITLE)
+                           const unsigned long _requestsCountPerTest) : TuakScenario(_scenarioContext,
+                                                                                     _flags,
+                                                                                     _scenarioIdentifier,
+                                                                                     testsCount,
+                                                                                     _requestsCountPerTest,
+                                                                                     TUAK__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
 
+    // Nothing else to do here.
+}
+
+// Note: the objects labels are always based on the TUAK title, so that
+// TUAK-based scenarii can share their objects.
+TuakScenario::TuakScenario(const ScenarioContext &_scenarioContext,
+                           const SCENARIO_FLAGS _flags,
+                           const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                           const size_t testsCount,
+                           const unsigned long _requestsCountPerTest,
+                           const std::string title) : FivegScenario(_scenarioContext,
+                                                                    _flags,
+                                                                    _scenarioIdentifier,
+                                                                    testsCount,
+                                                                    _requestsCountPerTest,
+                                                                    title)
 {
     assert(&_scenarioContext != nullptr);
     assert(testsCount > 0);
@@ -62,11 +94,119 @@ TuakScenario::TuakScenario(const ScenarioContext &_scenarioContext,
                                    "OPc");
 }
 
+CK_RV TuakScenario::checkVerificationKnownAnswers() const
+{
+    static_assert((TUAK__OP_LENGTH == TUAKTK_TOP_LENGTH) &&
+                      (TUAK__OPC_LENGTH == TUAKTK_TOPC_LENGTH) &&
+                      (THREE_GPP__SQN_LENGTH == TUAKTK_SQN_LENGTH) &&
+                      (THREE_GPP__AMF_LENGTH == TUAKTK_AMF_LENGTH),
+                  "Inconsistent TUAK lengths.");
+
+    const size_t knownAnswerResLength = sizeof(TUAK__KNOWN_ANSWER__F2);
+    const size_t knownAnswerMacLength = sizeof(TUAK__KNOWN_ANSWER__F1);
+    const size_t knownAnswerCkLength = sizeof(TUAK__KNOWN_ANSWER__F3);
+    const size_t knownAnswerIkLength = sizeof(TUAK__KNOWN_ANSWER__F4);
+    const unsigned int knownAnswerIterations = (unsigned int)TUAK__TEST_SET_1__ITERATIONS;
+
+    CK_BYTE computedTopc[TUAKTK_TOPC_LENGTH] = {0};
+    CK_BYTE authenticationVector[TUAKTK_MAXIMUM_AV_LENGTH] = {0};
+    CK_BYTE macS[TUAKTK_MAXIMUM_MAC_LENGTH] = {0};
+    CK_BYTE akStar[TUAKTK_AK_LENGTH] = {0};
+    CK_BYTE ak[TUAKTK_AK_LENGTH] = {0};
+
+    const CK_BYTE *const xres = &authenticationVector[TUAKTK_RAND_LENGTH];
+    const CK_BYTE *const ck = &xres[knownAnswerResLength];
+    const CK_BYTE *const ik = &ck[knownAnswerCkLength];
+    const CK_BYTE *const autn = &ik[knownAnswerIkLength];
+
+    if (!tuaktk_computeTopc(TUAK__TEST_SET_1__KI,
+                            sizeof(TUAK__TEST_SET_1__KI),
+                            TUAK__TEST_SET_1__OP,
+                            knownAnswerIterations,
+                            computedTopc) ||
+        (memcmp(computedTopc,
+                TUAK__TEST_SET_1__OPC,
+                TUAKTK_TOPC_LENGTH) != 0))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    if (!tuaktk_generateAuthenticationVector(TUAK__TEST_SET_1__OPC,
+                                             TUAK__TEST_SET_1__KI,
+                                             sizeof(TUAK__TEST_SET_1__KI),
+                                             TUAK__KNOWN_ANSWER__RAND,
+                                             TUAK__TEST_SET_1__SQN,
+                                             TUAK__TEST_SET_1__AMF,
+                                             knownAnswerIterations,
+                                             knownAnswerResLength,
+                                             knownAnswerMacLength,
+                                             knownAnswerCkLength,
+                                             knownAnswerIkLength,
+                                             authenticationVector))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    for (size_t index = 0; index < TUAKTK_AK_LENGTH; index++)
+    {
+        ak[index] = autn[index] ^ TUAK__TEST_SET_1__SQN[index];
+    }
+
+    if ((memcmp(authenticationVector, TUAK__KNOWN_ANSWER__RAND, TUAKTK_RAND_LENGTH) != 0) ||
+        (memcmp(xres, TUAK__KNOWN_ANSWER__F2, knownAnswerResLength) != 0) ||
+        (memcmp(ck, TUAK__KNOWN_ANSWER__F3, knownAnswerCkLength) != 0) ||
+        (memcmp(ik, TUAK__KNOWN_ANSWER__F4, knownAnswerIkLength) != 0) ||
+        (memcmp(ak, TUAK__KNOWN_ANSWER__F5, TUAKTK_AK_LENGTH) != 0) ||
+        (memcmp(&autn[TUAKTK_SQN_LENGTH], TUAK__TEST_SET_1__AMF, TUAKTK_AMF_LENGTH) != 0) ||
+        (memcmp(&autn[TUAKTK_SQN_LENGTH + TUAKTK_AMF_LENGTH], TUAK__KNOWN_ANSWER__F1, knownAnswerMacLength) != 0))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    if (!tuaktk_f1Star(TUAK__TEST_SET_1__OPC,
+                       TUAK__TEST_SET_1__KI,
+                       sizeof(TUAK__TEST_SET_1__KI),
+                       TUAK__KNOWN_ANSWER__RAND,
+                       TUAK__TEST_SET_1__SQN,
+                       TUAK__TEST_SET_1__AMF,
+                       knownAnswerIterations,
+                       macS,
+                       knownAnswerMacLength) ||
+        !tuaktk_f5Star(TUAK__TEST_SET_1__OPC,
+                       TUAK__TEST_SET_1__KI,
+                       sizeof(TUAK__TEST_SET_1__KI),
+                       TUAK__KNOWN_ANSWER__RAND,
+                       knownAnswerIterations,
+                       akStar) ||
+        (memcmp(macS, TUAK__KNOWN_ANSWER__F1_STAR, knownAnswerMacLength) != 0) ||
+        (memcmp(akStar, TUAK__KNOWN_ANSWER__F5_STAR, TUAKTK_AK_LENGTH) != 0))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    return CKR_OK;
+}
+
+CK_ULONG TuakScenario::getCkLength() const
+{
+    return (CK_ULONG)ckLength;
+}
+
 unsigned int TuakScenario::getFlagsCount() const
 {
     return 4;
 }
 
+CK_ULONG TuakScenario::getIkLength() const
+{
+    return (CK_ULONG)ikLength;
+}
+
+CK_ULONG TuakScenario::getMacLength() const
+{
+    return (CK_ULONG)macLength;
+}
+
 CK_RV TuakScenario::getNewMechanism(CK_MECHANISM *&pMechanism) const
 {
     assert(state == SCENARIO_STATE::Initialized);
@@ -165,6 +305,16 @@ EXIT:
     return rv;
 }
 
+CK_ULONG TuakScenario::getResLength() const
+{
+    return (CK_ULONG)resLength;
+}
+
+std::string TuakScenario::getVerifiedAlgorithm() const
+{
+    return TUAK__TITLE;
+}
+
 CK_RV TuakScenario::setScenarioData()
 {
     CK_RV rv = CKR_OK;
@@ -214,6 +364,61 @@ CK_RV TuakScenario::setScenarioData()
     ikLength = TUAK__TEST_SET_1__IK_LENGTH;
     ckLength = TUAK__TEST_SET_1__CK_LENGTH;
 
+    if (isUsingOp)
+    {
+        if (!tuaktk_computeTopc(ki,
+                                kiLength,
+                                op,
+                                (unsigned int)iterations,
+                                subscriberTopc))
+        {
+            rv = CKR_ARGUMENTS_BAD;
+
+            writeError("Cannot compute TOPc.",
+                       rv);
+
+            goto EXIT;
+        }
+    }
+    else
+    {
+        memcpy(subscriberTopc,
+               opc,
+               TUAKTK_TOPC_LENGTH);
+    }
+
 EXIT:
     return rv;
 }
+
+bool TuakScenario::verifyOutput(const CK_BYTE *const output,
+                                const CK_ULONG outputLength) const
+{
+    assert(output != nullptr);
+
+    CK_BYTE authenticationVector[TUAKTK_MAXIMUM_AV_LENGTH] = {0};
+
+    if (outputLength != TUAKTK_AV_LENGTH((CK_ULONG)resLength,
+                                         (CK_ULONG)macLength,
+                                         (CK_ULONG)ckLength,
+                                         (CK_ULONG)ikLength))
+    {
+        return false;
+    }
+
+    return tuaktk_generateAuthenticationVector(subscriberTopc,
+                                               ki,
+                                               kiLength,
+                                               output,
+                                               sqn,
+                                               amf,
+                                               (unsigned int)iterations,
+                                               (size_t)resLength,
+                                               (size_t)macLength,
+                                               (size_t)ckLength,
+                                               (size_t)ikLength,
+                                               authenticationVector) &&
+           (memcmp(authenticationVector,
+                   output,
+                   outputLength) == 0);
+}
@@ -41,8 +41,20 @@ extern const char *const TUAK__TITLE;
 class TuakScenario : public FivegScenario
 {
 protected:
+    // TOPc of the subscriber, either given or computed from TOP.
+    CK_BYTE subscriberTopc[TUAK__OPC_LENGTH] = {0};
+
+    CK_RV checkVerificationKnownAnswers() const override;
+
     CK_RV setScenarioData() override;
 
+    TuakScenario(const ScenarioContext &scenarioContext,
+                 const SCENARIO_FLAGS flags,
+                 const SCENARIO_IDENTIFIER identifier,
+                 const size_t testsCount,
+                 const unsigned long _requestsCountPerTest,
+                 const std::string title);
+
 public:
     //
     // Test set 1 from https://itecspec.com/spec/3gpp-35-233-6-conformance-test-data-for-tuak/
@@ -74,9 +86,18 @@ public:
     TuakScenario(const TuakScenario &) = delete;
     TuakScenario &operator=(const TuakScenario &) = delete;
 
+    CK_ULONG getCkLength() const override;
     unsigned int getFlagsCount() const override;
+    CK_ULONG getIkLength() const override;
+    CK_ULONG getMacLength() const override;
+    CK_ULONG getResLength() const override;
 
     CK_RV getNewMechanism(CK_MECHANISM *&pMechanism) const override;
+    std::string getVerifiedAlgorithm() const override;
+
+    // Recomputes the authentication vector from its RAND.
+    bool verifyOutput(const CK_BYTE *const output,
+                      const CK_ULONG outputLength) const override;
 };
 
 #endif /* TUAK_AUTHENTICATION_SCENARIO_HPP */
\ No newline at end of file
@@ -0,0 +1,134 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "tuak-software-scenario.hpp"
+#include "scenarii/3gpp/authentication/5g-software-test.hpp"
+
+const char *const TUAK_SOFTWARE__TITLE = "TUAK software";
+
+TuakSoftwareScenario::TuakSoftwareScenario(const ScenarioContext &_scenarioContext,
+                                           const SCENARIO_FLAGS _flags,
+                                           const SCENARIO_IDENTIFIER _scenarioIdentifier,
+                                           const size_t testsCount,
+                                           const unsigned long _requestsCountPerTest) : TuakScenario(_scenarioContext,
+                                                                                                     _flags,
+                                                                                                     _scenarioIdentifier,
+                                                                                                     testsCount,
+                                                                                                     _requestsCountPerTest,
+                                                                                                     TUAK_SOFTWARE__TITLE)
+{
+    assert(&_scenarioContext != nullptr);
+    assert(testsCount > 0);
+
+    // Replace the authentication tests by software tests.
+    for (size_t testIndex = 0;
+         testIndex < tests.size();
+         testIndex++)
+    {
+        tests[testIndex] = std::make_shared<FivegSoftwareTest>(*this,
+                                                               (TEST_IDENTIFIER)testIndex,
+                                                               _requestsCountPerTest);
+    }
+}
+
+CK_RV TuakSoftwareScenario::clean()
+{
+    return Scenario::clean();
+}
+
+CK_RV TuakSoftwareScenario::generateSoftwareAuthenticationVectors(const size_t count,
+                                                                  CK_BYTE *const authenticationVectors) const
+{
+    assert(count <= TUAKTK_MAXIMUM_BUFFERS_COUNT);
+    assert(authenticationVectors != nullptr);
+
+    // Note: the TOPc are computed into a copy, the scenario being shared by
+    // the tests.
+    CK_BYTE topcs[TUAKTK_MAXIMUM_BUFFERS_COUNT * TUAKTK_TOPC_LENGTH] = {0};
+
+    if (!isUsingOp)
+    {
+        memcpy(topcs,
+               buffersTopcs,
+               count * TUAKTK_TOPC_LENGTH);
+    }
+
+    if (!tuaktk_generateAuthenticationVectors(count,
+                                              (isUsingOp ? buffersTops : nullptr),
+                                              topcs,
+                                              buffersKis,
+                                              THREE_GPP__KI_LENGTH,
+                                              sqn,
+                                              amf,
+                                              (unsigned int)iterations,
+                                              (size_t)resLength,
+                                              (size_t)macLength,
+                                              (size_t)ckLength,
+                                              (size_t)ikLength,
+                                              authenticationVectors))
+    {
+        return CKR_ARGUMENTS_BAD;
+    }
+
+    return CKR_OK;
+}
+
+size_t TuakSoftwareScenario::getSoftwareBuffersCount() const
+{
+    return TUAKTK_MAXIMUM_BUFFERS_COUNT;
+}
+
+std::string TuakSoftwareScenario::getSoftwareImplementation() const
+{
+    return tuaktk_getBuffersImplementation();
+}
+
+CK_RV TuakSoftwareScenario::initialize()
+{
+    return Scenario::initialize();
+}
+
+CK_RV TuakSoftwareScenario::prepareScenario()
+{
+    return Scenario::prepareScenario();
+}
+
+CK_RV TuakSoftwareScenario::setScenarioData()
+{
+    CK_RV rv = CKR_OK;
+
+    rv = TuakScenario::setScenarioData();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    for (size_t buffer = 0; buffer < TUAKTK_MAXIMUM_BUFFERS_COUNT; buffer++)
+    {
+        memcpy(&buffersKis[buffer * THREE_GPP__KI_LENGTH],
+               ki,
+               THREE_GPP__KI_LENGTH);
+        memcpy(&buffersTops[buffer * TUAKTK_TOP_LENGTH],
+               op,
+               TUAKTK_TOP_LENGTH);
+        memcpy(&buffersTopcs[buffer * TUAKTK_TOPC_LENGTH],
+               subscriberTopc,
+               TUAKTK_TOPC_LENGTH);
+    }
+
+EXIT:
+    return rv;
+}
@@ -0,0 +1,68 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef TUAK_SOFTWARE_SCENARIO_HPP
+#define TUAK_SOFTWARE_SCENARIO_HPP
+
+#include "tuak-scenario.hpp"
+
+extern "C"
+{
+#include <toolkits/tuak-toolkit.h>
+}
+
+extern const char *const TUAK_SOFTWARE__TITLE;
+
+/*
+ * TUAK software scenario: the authentication vectors are generated on the
+ * client cores, without the HSM, the Keccak states of several subscribers
+ * being permuted together (see tuaktk_generateAuthenticationVectors()). It
+ * gives the software baseline to compare the TUAK scenario with.
+ *
+ * The flags are the same as for the TUAK authentication scenario, but only
+ * the OP/OPc flag changes the work done (TOPc being derived from TOP for
+ * each vector, as done by the HSM); the other ones are accepted so that the
+ * same flags can be given to both scenarii.
+ */
+class TuakSoftwareScenario : public TuakScenario
+{
+protected:
+    // The test set subscriber, replicated for each buffer.
+    CK_BYTE buffersKis[TUAKTK_MAXIMUM_BUFFERS_COUNT * THREE_GPP__KI_LENGTH] = {0};
+    CK_BYTE buffersTops[TUAKTK_MAXIMUM_BUFFERS_COUNT * TUAKTK_TOP_LENGTH] = {0};
+    CK_BYTE buffersTopcs[TUAKTK_MAXIMUM_BUFFERS_COUNT * TUAKTK_TOPC_LENGTH] = {0};
+
+    // No object is used in the HSM.
+    CK_RV clean() override;
+    CK_RV prepareScenario() override;
+
+    CK_RV setScenarioData() override;
+
+public:
+    TuakSoftwareScenario(const ScenarioContext &scenarioContext,
+                         const SCENARIO_FLAGS flags,
+                         const SCENARIO_IDENTIFIER identifier,
+                         const size_t testsCount,
+                         const unsigned long _requestsCountPerTest);
+    ~TuakSoftwareScenario() override = default;
+
+    TuakSoftwareScenario(const TuakSoftwareScenario &) = delete;
+    TuakSoftwareScenario &operator=(const TuakSoftwareScenario &) = delete;
+
+    CK_RV generateSoftwareAuthenticationVectors(const size_t count,
+                                                CK_BYTE *const authenticationVectors) const override;
+    size_t getSoftwareBuffersCount() const override;
+    std::string getSoftwareImplementation() const override;
+
+    CK_RV initialize() override;
+};
+
+#endif /* TUAK_SOFTWARE_SCENARIO_HPP */
@@ -9,20 +9,128 @@
 *
 \****************************************************************************/
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <string>
+#include <sys/random.h>
+#include <unistd.h>
 
 extern "C"
 {
+#include <toolkits/aes-toolkit.h>
+#include <toolkits/ecies-toolkit.h>
+#include <toolkits/kdf-toolkit.h>
 #include <toolkits/misc-toolkit.h>
+#include <toolkits/sha-toolkit.h>
 }
 
 #include "suci-scenario.hpp"
 #include "suci-test.hpp"
 
+extern "C"
+{
+#include <toolkits/profiling-toolkit.h>
+}
+
 const CK_BYTE SuciScenario::SUCI__TEST_SET_1__SUPI[SUCI__SUPI_LENGTH] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
 
+// Lengths of the test data of TS 33.501, whose MAC tags are truncated.
+#define SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH 5
+#define SUCI__KNOWN_ANSWER__MAC_LENGTH 8
+
+// Test data of TS 33.501 (C.4.3 for X25519 and C.4.4 for P-256), used as
+// known answers by the software computations of the scenario (see
+// checkKnownAnswers()). The scheme input is the same for both.
+static const CK_BYTE SUCI__KNOWN_ANSWER__SCHEME_INPUT[SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH] = {0x00, 0x01, 0x20, 0x80, 0xf6};
+static const CK_BYTE SUCI__KNOWN_ANSWER__X25519_PRIVATE_KEY[ECTK_X25519_KEY_LENGTH] = {0xc5, 0x3c, 0x22, 0x20, 0x8b, 0x61, 0x86, 0x0b, 0x06, 0xc6, 0x2e, 0x54, 0x06, 0xa7, 0xb3, 0x30, 0xc2, 0xb5, 0x77, 0xaa, 0x55, 0x58, 0x98, 0x15, 0x10, 0xd1, 0x28, 0x24, 0x7d, 0x38, 0xbd, 0x1d};
+static const CK_BYTE SUCI__KNOWN_ANSWER__X25519_PUBLIC_KEY[ECTK_X25519_KEY_LENGTH] = {0x5a, 0x8d, 0x38, 0x86, 0x48, 0x20, 0x19, 0x7c, 0x33, 0x94, 0xb9, 0x26, 0x13, 0xb2, 0x0b, 0x91, 0x63, 0x3c, 0xbd, 0x89, 0x71, 0x19, 0x27, 0x3b, 0xf8, 0xe4, 0xa6, 0xf4, 0xee, 0xc0, 0xa6, 0x50};
+static const CK_BYTE SUCI__KNOWN_ANSWER__X25519_EPHEMERAL_PUBLIC_KEY[ECTK_X25519_KEY_LENGTH] = {0xb2, 0xe9, 0x2f, 0x83, 0x60, 0x55, 0xa2, 0x55, 0x83, 0x7d, 0xeb, 0xf8, 0x50, 0xb5, 0x28, 0x99, 0x7c, 0xe0, 0x20, 0x1c, 0xb8, 0x2a, 0xdf, 0xe4, 0xbe, 0x1f, 0x58, 0x7d, 0x07, 0xd8, 0x45, 0x7d};
+static const CK_BYTE SUCI__KNOWN_ANSWER__X25519_SHARED_SECRET[ECTK_X25519_KEY_LENGTH] = {0x02, 0x8d, 0xdf, 0x89, 0x0e, 0xc8, 0x3c, 0xdf, 0x16, 0x39, 0x47, 0xce, 0x45, 0xf6, 0xec, 0x1a, 0x0e, 0x30, 0x70, 0xea, 0x5f, 0xe5, 0x7e, 0x2b, 0x1f, 0x05, 0x13, 0x9f, 0x3e, 0x82, 0x42, 0x2a};
+static const CK_BYTE SUCI__KNOWN_ANSWER__X25519_CIPHERTEXT[SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH] = {0xcb, 0x02, 0x35, 0x24, 0x10};
+static const CK_BYTE SUCI__KNOWN_ANSWER__X25519_MAC[SUCI__KNOWN_ANSWER__MAC_LENGTH] = {0xcd, 0xdd, 0x9e, 0x73, 0x0e, 0xf3, 0xfa, 0x87};
+static const CK_BYTE SUCI__KNOWN_ANSWER__P256_PRIVATE_KEY[ECTK_P256_SCALAR_LENGTH] = {0xf1, 0xab, 0x10, 0x74, 0x47, 0x7e, 0xbc, 0xc7, 0xf5, 0x54, 0xea, 0x1c, 0x5f, 0xc3, 0x68, 0xb1, 0x61, 0x67, 0x30, 0x15, 0x5e, 0x00, 0x41, 0xac, 0x44, 0x7d, 0x63, 0x01, 0x97, 0x5f, 0xec, 0xda};
+static const CK_BYTE SUCI__KNOWN_ANSWER__P256_PUBLIC_KEY[ECTK_P256_PUBLIC_KEY_LENGTH] = {0x04, 0x72, 0xda, 0x71, 0x97, 0x62, 0x34, 0xce, 0x83, 0x3a, 0x69, 0x07, 0x42, 0x58, 0x67, 0xb8, 0x2e, 0x07, 0x4d, 0x44, 0xef, 0x90, 0x7d, 0xfb, 0x4b, 0x3e, 0x21, 0xc1, 0xc2, 0x25, 0x6e, 0xbc, 0xd1, 0x5a, 0x7d, 0xed, 0x52, 0xfc, 0xbb, 0x09, 0x7a, 0x4e, 0xd2, 0x50, 0xe0, 0x36, 0xc7, 0xb9, 0xc8, 0xc7, 0x00, 0x4c, 0x4e, 0xed, 0xc4, 0xf0, 0x68, 0xcd, 0x7b, 0xf8, 0xd3, 0xf9, 0x00, 0xe3, 0xb4};
+static const CK_BYTE SUCI__KNOWN_ANSWER__P256_EPHEMERAL_PUBLIC_KEY[ECTK_P256_COMPRESSED_POINT_LENGTH] = {0x03, 0x9a, 0xab, 0x83, 0x76, 0x59, 0x70, 0x21, 0xe8, 0x55, 0x67, 0x9a, 0x97, 0x78, 0xea, 0x0b, 0x67, 0x39, 0x6e, 0x68, 0xc6, 0x6d, 0xf3, 0x2c, 0x0f, 0x41, 0xe9, 0xac, 0xca, 0x2d, 0xa9, 0xb9, 0xd1};
+static const CK_BYTE SUCI__KNOWN_ANSWER__P256_SHARED_SECRET[ECTK_P256_FIELD_LENGTH] = {0x6c, 0x7e, 0x65, 0x18, 0x98, 0x00, 0x25, 0xb9, 0x82, 0xfb, 0xb2, 0xff, 0x74, 0x6e, 0x3c, 0x2e, 0x85, 0xa1, 0x96, 0xd2, 0x52, 0x09, 0x9a, 0x7a, 0xd2, 0x3e, 0xa7, 0xb4, 0xc0, 0x95, 0x9c, 0xae};
+static const CK_BYTE SUCI__KNOWN_ANSWER__P256_CIPHERTEXT[SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH] = {0x46, 0xa3, 0x3f, 0xc2, 0x71};
+static const CK_BYTE SUCI__KNOWN_ANSWER__P256_MAC[SUCI__KNOWN_ANSWER__MAC_LENGTH] = {0x6a, 0xc7, 0xda, 0xe9, 0x6a, 0xa3, 0x0a, 0x4d};
+
+/*
+ * Range of SUCI pool records generated by a thread.
+ */
+typedef struct
+{
+    SuciScenario *pSuciScenario;
+    size_t firstIndex;
+    size_t endIndex;
+    bool isGenerated;
+} SUCI_POOL_GENERATION_ARGUMENTS;
+
+static void *generateSuciPoolRecordsInThread(void *arg)
+{
+    assert(arg != nullptr);
+
+    auto pArguments = (SUCI_POOL_GENERATION_ARGUMENTS *)arg;
+
+    pArguments->isGenerated = pArguments->pSuciScenario->generateSuciPoolRecords(pArguments->firstIndex,
+                                                                                 pArguments->endIndex);
+
+    pthread_exit(nullptr);
+}
+
+// Checks the decryption of the scheme output of TS 33.501 (C.3.4): the keys
+// derived with the ephemeral public key as shared information are the
+// encryption key, the initial counter block and the MAC key.
+static bool checkKnownAnswerSchemeOutput(const CK_BYTE *const sharedSecret,
+                                         const size_t sharedSecretLength,
+                                         const CK_BYTE *const ephemeralPublicKey,
+                                         const size_t ephemeralPublicKeyLength,
+                                         const CK_BYTE ciphertext[SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH],
+                                         const CK_BYTE mac[SUCI__KNOWN_ANSWER__MAC_LENGTH])
+{
+    CK_BYTE keys[AESTK_128_KEY_LENGTH + AESTK_BLOCK_LENGTH + SHATK_SHA256_DIGEST_LENGTH] = {0};
+    CK_BYTE computedMac[SHATK_SHA256_DIGEST_LENGTH] = {0};
+    CK_BYTE schemeInput[SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH] = {0};
+    AESTK_128_KEY_SCHEDULE keySchedule;
+
+    kdftk_deriveWithX963Sha256(sharedSecret,
+                               sharedSecretLength,
+                               ephemeralPublicKey,
+                               ephemeralPublicKeyLength,
+                               keys,
+                               sizeof(keys));
+
+    shatk_hmacSha256(&keys[AESTK_128_KEY_LENGTH + AESTK_BLOCK_LENGTH],
+                     SHATK_SHA256_DIGEST_LENGTH,
+                     ciphertext,
+                     SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH,
+                     computedMac);
+
+    aestk_expandKey128(keys,
+                       &keySchedule);
+    aestk_encryptCtr128(&keySchedule,
+                        &keys[AESTK_128_KEY_LENGTH],
+                        ciphertext,
+                        SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH,
+                        schemeInput);
+
+    return (memcmp(computedMac, mac, SUCI__KNOWN_ANSWER__MAC_LENGTH) == 0) &&
+           (memcmp(schemeInput, SUCI__KNOWN_ANSWER__SCHEME_INPUT, SUCI__KNOWN_ANSWER__SCHEME_INPUT_LENGTH) == 0);
+}
+
+static void *runHomeNetworkKeysRotationInThread(void *arg)
+{
+    assert(arg != nullptr);
+
+    proftk_setContext(((SuciScenario *)arg)->getProfilingContext());
+
+    ((SuciScenario *)arg)->runHomeNetworkKeysRotation();
+
+    pthread_exit(nullptr);
+}
+
 SuciScenario::SuciScenario(const ScenarioContext &_scenarioContext,
                            const SCENARIO_FLAGS _flags,
                            const SCENARIO_IDENTIFIER _scenarioIdentifier,
@@ -36,19 +144,57 @@ SuciScenario::SuciScenario(const ScenarioContext &_scenarioContext,
                                                                         isUsingProfileB(getFlagValueAsBoolean(_flags,
                                                                                                               2)),
                                                                         isUsingCompressedCurvedPoints(getFlagValueAsBoolean(_flags,
-                                                                                                                            3))
+                                                                                                                            3)),
+                                                                        homeNetworkKeysCount((getFlagValue(_flags,
+                                                                                                           4) > 1)
+                                                                                                 ? getFlagValue(_flags,
+                                                                                                                4)
+                                                                                                 : 1),
+                                                                        isRotatingHomeNetworkKeys(getFlagValueAsBoolean(_flags,
+                                                                                                                        5)),
+                                                                        isUsingSuciPool(getFlagValueAsBoolean(_flags,
+                                                                                                              6))
 {
     assert(&_scenarioContext != nullptr);
     assert(testsCount > 0);
 
-    publicKeyLabel = generateObjectLabel(SUCI__TITLE,
-                                         _scenarioIdentifier,
-                                         uuid,
-                                         "Public Key");
-    privateKeyLabel = generateObjectLabel(SUCI__TITLE,
-                                          _scenarioIdentifier,
-                                          uuid,
-                                          "Private Key");
+    // The labels of the first key pair are the ones used when a single key
+    // pair was supported, so that shared objects are still found.
+    for (size_t keyIndex = 0;
+         keyIndex < homeNetworkKeysCount;
+         keyIndex++)
+    {
+        const std::string suffix = ((keyIndex == 0) ? "" : (std::string(" ") + std::to_string(keyIndex)));
+
+        publicKeysLabels.push_back(generateObjectLabel(SUCI__TITLE,
+                                                       _scenarioIdentifier,
+                                                       uuid,
+                                                       ("Public Key" + suffix).c_str()));
+        privateKeysLabels.push_back(generateObjectLabel(SUCI__TITLE,
+                                                        _scenarioIdentifier,
+                                                        uuid,
+                                                        ("Private Key" + suffix).c_str()));
+    }
+
+    homeNetworkKeys.resize(homeNetworkKeysCount);
+
+    for (size_t keyIndex = 0;
+         keyIndex < homeNetworkKeysCount;
+         keyIndex++)
+    {
+        SUCI_HOME_NETWORK_KEY &homeNetworkKey = homeNetworkKeys[keyIndex];
+
+        memset(&homeNetworkKey,
+               0,
+               sizeof(homeNetworkKey));
+
+        homeNetworkKey.identifier = (CK_BYTE)(keyIndex + 1);
+        homeNetworkKey.publicKeyHandle = CK_INVALID_HANDLE;
+        homeNetworkKey.privateKeyHandle = CK_INVALID_HANDLE;
+        homeNetworkKey.isRotated = false;
+    }
+
+    nextHomeNetworkKeyIdentifier = (CK_BYTE)(homeNetworkKeysCount + 1);
 
     ellipticCurveIdentifier = (isUsingProfileB ? SUCI__PROFILE_B_CURVE : SUCI__PROFILE_A_CURVE);
 
@@ -81,40 +227,45 @@ CK_RV SuciScenario::clean()
 
     if (sessionHandle != CK_INVALID_HANDLE)
     {
-        CK_RV rv2 = CKR_OK;
-
-        if (publicKeyHandle != CK_INVALID_HANDLE)
+        for (auto &homeNetworkKey : homeNetworkKeys)
         {
-            rv2 = p11tk_destroyObject(sessionHandle,
-                                      publicKeyHandle);
+            destroyHomeNetworkKey(homeNetworkKey); // Ignore the result code.
 
-            if (rv2 != CKR_OK)
-            {
-                writeError("Cannot remove the public key object.",
-                           rv2);
-            }
+            homeNetworkKey.publicKeyHandle = CK_INVALID_HANDLE;
+            homeNetworkKey.privateKeyHandle = CK_INVALID_HANDLE;
         }
 
-        if (privateKeyHandle != CK_INVALID_HANDLE)
+        for (const auto &retiredHomeNetworkKey : retiredHomeNetworkKeys)
         {
-            rv2 = p11tk_destroyObject(sessionHandle,
-                                      privateKeyHandle);
-
-            if (rv2 != CKR_OK)
-            {
-                writeError("Cannot remove the private key object.",
-                           rv2);
-            }
+            destroyHomeNetworkKey(retiredHomeNetworkKey); // Ignore the result code.
         }
+
+        retiredHomeNetworkKeys.clear();
     }
 
 EXIT:
     return rv;
 }
 
+bool SuciScenario::checkFlag(const unsigned int position,
+                             const unsigned int value) const
+{
+    // Number of home network key pairs.
+    if (position == 4)
+    {
+        return (value <= SUCI__MAXIMUM_HOME_NETWORK_KEYS_COUNT);
+    }
+
+    return Scenario::checkFlag(position,
+                               value);
+}
+
 bool SuciScenario::checkFlags(const SCENARIO_FLAGS _flags) const
 {
-    // Profile B does not support compressed points.
+    // Profile B (X25519) does not support compressed points.
+    //
+    // Note: the flags name the profiles in reverse of TS 33.501, where X25519
+    // is the profile A and P-256 the profile B.
     const bool _isUsingProfileB = getFlagValueAsBoolean(_flags,
                                                         2);
     const bool _isUsingCompressedCurvedPoints = getFlagValueAsBoolean(_flags,
@@ -126,9 +277,378 @@ bool SuciScenario::checkFlags(const SCENARIO_FLAGS _flags) const
         return false;
     }
 
+    // The SUCI pool is generated with the initial keys only.
+    const bool _isRotatingHomeNetworkKeys = getFlagValueAsBoolean(_flags,
+                                                                  5);
+    const bool _isUsingSuciPool = getFlagValueAsBoolean(_flags,
+                                                        6);
+
+    if (_isRotatingHomeNetworkKeys &&
+        _isUsingSuciPool)
+    {
+        return false;
+    }
+
     return Scenario::checkFlags(_flags);
 }
 
+CK_RV SuciScenario::checkKnownAnswers() const
+{
+    CK_BYTE x25519PublicKey[ECTK_X25519_KEY_LENGTH] = {0};
+    CK_BYTE x25519SharedSecret[ECTK_X25519_KEY_LENGTH] = {0};
+    CK_BYTE p256PublicKey[ECTK_P256_PUBLIC_KEY_LENGTH] = {0};
+    CK_BYTE p256EphemeralPublicKey[ECTK_P256_PUBLIC_KEY_LENGTH] = {0};
+    CK_BYTE p256SharedSecret[ECTK_P256_FIELD_LENGTH] = {0};
+
+    ectk_x25519ComputePublicKey(SUCI__KNOWN_ANSWER__X25519_PRIVATE_KEY,
+                                x25519PublicKey);
+    ectk_x25519(SUCI__KNOWN_ANSWER__X25519_PRIVATE_KEY,
+                SUCI__KNOWN_ANSWER__X25519_EPHEMERAL_PUBLIC_KEY,
+                x25519SharedSecret);
+
+    if ((memcmp(x25519PublicKey, SUCI__KNOWN_ANSWER__X25519_PUBLIC_KEY, ECTK_X25519_KEY_LENGTH) != 0) ||
+        (memcmp(x25519SharedSecret, SUCI__KNOWN_ANSWER__X25519_SHARED_SECRET, ECTK_X25519_KEY_LENGTH) != 0) ||
+        !checkKnownAnswerSchemeOutput(x25519SharedSecret,
+                                      sizeof(x25519SharedSecret),
+                                      SUCI__KNOWN_ANSWER__X25519_EPHEMERAL_PUBLIC_KEY,
+                                      sizeof(SUCI__KNOWN_ANSWER__X25519_EPHEMERAL_PUBLIC_KEY),
+                                      SUCI__KNOWN_ANSWER__X25519_CIPHERTEXT,
+                                      SUCI__KNOWN_ANSWER__X25519_MAC))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    // The ephemeral public key is compressed.
+    if (!ectk_p256ComputePublicKey(SUCI__KNOWN_ANSWER__P256_PRIVATE_KEY,
+                                   p256PublicKey) ||
+        !ectk_p256DecompressPoint(SUCI__KNOWN_ANSWER__P256_EPHEMERAL_PUBLIC_KEY,
+                                  p256EphemeralPublicKey) ||
+        !ectk_p256ComputeSharedSecret(SUCI__KNOWN_ANSWER__P256_PRIVATE_KEY,
+                                      p256EphemeralPublicKey,
+                                      p256SharedSecret))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    if ((memcmp(p256PublicKey, SUCI__KNOWN_ANSWER__P256_PUBLIC_KEY, ECTK_P256_PUBLIC_KEY_LENGTH) != 0) ||
+        (memcmp(p256SharedSecret, SUCI__KNOWN_ANSWER__P256_SHARED_SECRET, ECTK_P256_FIELD_LENGTH) != 0) ||
+        !checkKnownAnswerSchemeOutput(p256SharedSecret,
+                                      sizeof(p256SharedSecret),
+                                      SUCI__KNOWN_ANSWER__P256_EPHEMERAL_PUBLIC_KEY,
+                                      sizeof(SUCI__KNOWN_ANSWER__P256_EPHEMERAL_PUBLIC_KEY),
+                                      SUCI__KNOWN_ANSWER__P256_CIPHERTEXT,
+                                      SUCI__KNOWN_ANSWER__P256_MAC))
+    {
+        return CKR_GENERAL_ERROR;
+    }
+
+    return CKR_OK;
+}
+
+CK_RV SuciScenario::checkSuciPool(const CK_MECHANISM *const pMechanism) const
+{
+    assert(pMechanism != nullptr);
+    assert(!suciPool.empty());
+
+    CK_RV rv = CKR_OK;
+
+    CK_BYTE homeNetworkKeyIdentifier = 0;
+    const CK_BYTE *pEncryptedData = nullptr;
+    CK_ULONG encryptedDataLength = 0;
+    CK_BYTE expectedData[SUCI__DATA_LENGTH] = {0};
+
+    CK_BYTE decryptedData[SUCI__DATA_LENGTH] = {0};
+    CK_ULONG decryptedDataLength = GET_ARRAY_SIZE(decryptedData);
+
+    getPooledSuci(0,
+                  homeNetworkKeyIdentifier,
+                  pEncryptedData,
+                  encryptedDataLength,
+                  expectedData);
+
+    rv = p11tk_getFunctionList()->C_DecryptInit(sessionHandle,
+                                                (CK_MECHANISM *)pMechanism,
+                                                getPrivateKeyHandle(homeNetworkKeyIdentifier));
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot initialize the deconcealment of the SUCI pool.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    rv = p11tk_getFunctionList()->C_Decrypt(sessionHandle,
+                                            (CK_BYTE_PTR)pEncryptedData,
+                                            encryptedDataLength,
+                                            decryptedData,
+                                            &decryptedDataLength);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot deconceal a SUCI of the pool: the HSM does not accept the SUCIs generated in software.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    if ((decryptedDataLength != GET_ARRAY_SIZE(expectedData)) ||
+        (memcmp(decryptedData,
+                expectedData,
+                GET_ARRAY_SIZE(expectedData)) != 0))
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("A SUCI of the pool is not deconcealed as expected by the HSM.",
+                   rv);
+
+        goto EXIT;
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV SuciScenario::destroyHomeNetworkKey(const SUCI_HOME_NETWORK_KEY &homeNetworkKey) const
+{
+    CK_RV rv = CKR_OK;
+
+    if (homeNetworkKey.publicKeyHandle != CK_INVALID_HANDLE)
+    {
+        CK_RV rv2 = p11tk_destroyObject(sessionHandle,
+                                        homeNetworkKey.publicKeyHandle);
+
+        if (rv2 != CKR_OK)
+        {
+            writeError("Cannot remove the public key object.",
+                       rv2);
+
+            rv = rv2;
+        }
+    }
+
+    if (homeNetworkKey.privateKeyHandle != CK_INVALID_HANDLE)
+    {
+        CK_RV rv2 = p11tk_destroyObject(sessionHandle,
+                                        homeNetworkKey.privateKeyHandle);
+
+        if (rv2 != CKR_OK)
+        {
+            writeError("Cannot remove the private key object.",
+                       rv2);
+
+            rv = rv2;
+        }
+    }
+
+    return rv;
+}
+
+CK_RV SuciScenario::encryptData(const CK_MECHANISM *const pMechanism,
+                                SUCI_HOME_NETWORK_KEY &homeNetworkKey) const
+{
+    assert(pMechanism != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    rv = p11tk_getFunctionList()->C_EncryptInit(sessionHandle,
+                                                (CK_MECHANISM *)pMechanism,
+                                                homeNetworkKey.publicKeyHandle);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot initialize data encryption for the test data.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    homeNetworkKey.encryptedDataLength = GET_ARRAY_SIZE(homeNetworkKey.encryptedData);
+
+    rv = p11tk_getFunctionList()->C_Encrypt(sessionHandle,
+                                            (CK_BYTE_PTR)data,
+                                            dataLength,
+                                            homeNetworkKey.encryptedData,
+                                            &homeNetworkKey.encryptedDataLength);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot encrypt data.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    // If compressed points are requested, compress it.
+    // Set the leading byte to 0x02 to indicate a compress point with an even
+    // Y value or 0x03 to indicate a compressed point with an odd Y value.
+    // And then move the encrypted data to the left to overwrite the Y value.
+    if (isUsingCompressedCurvedPoints)
+    {
+        const P11_ELLIPTIC_CURVES_LIST_ELEMENT *pEllipticCurveData = nullptr;
+
+        rv = p11tk_getEllipticCurveDataForCurveIdentifier(ellipticCurveIdentifier,
+                                                          &pEllipticCurveData);
+
+        if (rv != CKR_OK)
+        {
+            writeError("Cannot retrieve elliptic curve data.",
+                       rv);
+
+            goto EXIT;
+        }
+
+        unsigned int curveFieldLength = pEllipticCurveData->fieldLength;
+        CK_BYTE *const encryptedData = homeNetworkKey.encryptedData;
+
+        encryptedData[0] = (CK_BYTE)((encryptedData[curveFieldLength * 2] & 0x01) ? 0x03 : 0x02);
+
+        memmove(&encryptedData[curveFieldLength + 1],
+                &encryptedData[curveFieldLength * 2 + 1],
+                homeNetworkKey.encryptedDataLength - (curveFieldLength * 2 + 1));
+
+        homeNetworkKey.encryptedDataLength -= curveFieldLength;
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV SuciScenario::generateSuciPool()
+{
+    assert(suciPool.empty());
+
+    CK_RV rv = CKR_OK;
+
+    const long processorsCount = sysconf(_SC_NPROCESSORS_ONLN);
+    const size_t threadsCount = (processorsCount > 1) ? (size_t)processorsCount : 1;
+
+    std::vector<pthread_t> threadIdentifiers(threadsCount,
+                                             (pthread_t)0);
+    std::vector<SUCI_POOL_GENERATION_ARGUMENTS> threadsArguments(threadsCount);
+    size_t startedThreadsCount = 0;
+
+    // All the records have the same length.
+    if (isUsingProfileB)
+    {
+        suciPoolRecordLength = 1 + ECIESTK_X25519_OUTPUT_LENGTH(SUCI__DATA_LENGTH);
+    }
+    else
+    {
+        suciPoolRecordLength = 1 + ECIESTK_P256_OUTPUT_LENGTH(SUCI__DATA_LENGTH,
+                                                              isUsingCompressedCurvedPoints);
+    }
+
+    suciPool.resize(SUCI__SUCI_POOL_SIZE * suciPoolRecordLength);
+
+    // Use all the cores: the generation of each SUCI requires two scalar
+    // multiplications.
+    for (size_t threadIndex = 0;
+         threadIndex < threadsCount;
+         threadIndex++)
+    {
+        SUCI_POOL_GENERATION_ARGUMENTS &arguments = threadsArguments[threadIndex];
+
+        arguments.pSuciScenario = this;
+        arguments.firstIndex = (threadIndex * SUCI__SUCI_POOL_SIZE) / threadsCount;
+        arguments.endIndex = ((threadIndex + 1) * SUCI__SUCI_POOL_SIZE) / threadsCount;
+        arguments.isGenerated = false;
+
+        if (pthread_create(&threadIdentifiers[threadIndex],
+                           nullptr,
+                           &generateSuciPoolRecordsInThread,
+                           &arguments) != 0)
+        {
+            rv = CKR_GENERAL_ERROR;
+
+            writeError("Cannot generate the SUCI pool in a separate thread.",
+                       rv);
+
+            break;
+        }
+
+        startedThreadsCount++;
+    }
+
+    for (size_t threadIndex = 0;
+         threadIndex < startedThreadsCount;
+         threadIndex++)
+    {
+        if ((pthread_join(threadIdentifiers[threadIndex],
+                          nullptr) != 0) ||
+            !threadsArguments[threadIndex].isGenerated)
+        {
+            if (rv == CKR_OK)
+            {
+                rv = CKR_GENERAL_ERROR;
+
+                writeError("Cannot generate the SUCI pool.",
+                           rv);
+            }
+        }
+    }
+
+    if (rv != CKR_OK)
+    {
+        suciPool.clear();
+    }
+
+    return rv;
+}
+
+bool SuciScenario::generateSuciPoolRecords(const size_t firstIndex,
+                                           const size_t endIndex)
+{
+    assert(firstIndex <= endIndex);
+    assert(endIndex <= SUCI__SUCI_POOL_SIZE);
+
+    CK_BYTE ephemeralPrivateKey[ECTK_P256_SCALAR_LENGTH] = {0};
+    CK_BYTE suciData[SUCI__DATA_LENGTH] = {0};
+
+    for (size_t index = firstIndex;
+         index < endIndex;
+         index++)
+    {
+        const SUCI_HOME_NETWORK_KEY &homeNetworkKey = homeNetworkKeys[index % homeNetworkKeys.size()];
+        CK_BYTE *const pRecord = &suciPool[index * suciPoolRecordLength];
+
+        getSuciPoolData(index,
+                        suciData);
+
+        pRecord[0] = homeNetworkKey.identifier;
+
+        // A P-256 ephemeral private key is drawn again in the unlikely event it
+        // is out of range.
+        do
+        {
+            if (getrandom(ephemeralPrivateKey,
+                          sizeof(ephemeralPrivateKey),
+                          0) != (ssize_t)sizeof(ephemeralPrivateKey))
+            {
+                return false;
+            }
+
+            if (isUsingProfileB)
+            {
+                eciestk_encryptWithX25519(homeNetworkKey.publicKey,
+                                          ephemeralPrivateKey,
+                                          suciData,
+                                          sizeof(suciData),
+                                          &pRecord[1]);
+
+                break;
+            }
+        } while (!eciestk_encryptWithP256(homeNetworkKey.publicKey,
+                                          ephemeralPrivateKey,
+                                          isUsingCompressedCurvedPoints,
+                                          suciData,
+                                          sizeof(suciData),
+                                          &pRecord[1]));
+    }
+
+    return true;
+}
+
 const char *SuciScenario::getFlagDescription(const unsigned int position) const
 {
     switch (position)
@@ -139,6 +659,15 @@ const char *SuciScenario::getFlagDescription(const unsigned int position) const
     case 3:
         return "Use compressed curved points";
 
+    case 4:
+        return "Home network key pairs count";
+
+    case 5:
+        return "Rotate home network key pairs";
+
+    case 6:
+        return "Use a pool of distinct SUCIs";
+
     default:
         return Scenario::getFlagDescription(position);
     }
@@ -146,7 +675,7 @@ const char *SuciScenario::getFlagDescription(const unsigned int position) const
 
 unsigned int SuciScenario::getFlagsCount() const
 {
-    return 3;
+    return 6;
 }
 
 CK_RV SuciScenario::getNewMechanism(CK_MECHANISM *&pMechanism) const
@@ -192,11 +721,103 @@ EXIT:
     return rv;
 }
 
-CK_OBJECT_HANDLE SuciScenario::getPrivateKeyHandle() const
+void SuciScenario::getPooledSuci(const unsigned long index,
+                                 CK_BYTE &homeNetworkKeyIdentifier,
+                                 const CK_BYTE *&pEncryptedData,
+                                 CK_ULONG &encryptedDataLength,
+                                 CK_BYTE expectedData[SUCI__DATA_LENGTH]) const
+{
+    assert(&homeNetworkKeyIdentifier != nullptr);
+    assert(&pEncryptedData != nullptr);
+    assert(&encryptedDataLength != nullptr);
+    assert(expectedData != nullptr);
+
+    const unsigned long recordIndex = index % SUCI__SUCI_POOL_SIZE;
+    const CK_BYTE *const pRecord = &suciPool[recordIndex * suciPoolRecordLength];
+
+    homeNetworkKeyIdentifier = pRecord[0];
+    pEncryptedData = &pRecord[1];
+    encryptedDataLength = (CK_ULONG)(suciPoolRecordLength - 1);
+
+    getSuciPoolData(recordIndex,
+                    expectedData);
+}
+
+CK_OBJECT_HANDLE SuciScenario::getPrivateKeyHandle(const CK_BYTE homeNetworkKeyIdentifier) const
 {
+    CK_OBJECT_HANDLE privateKeyHandle = CK_INVALID_HANDLE;
+
+    pthread_rwlock_rdlock(&homeNetworkKeysLock);
+
+    for (const auto &homeNetworkKey : homeNetworkKeys)
+    {
+        if (homeNetworkKey.identifier == homeNetworkKeyIdentifier)
+        {
+            privateKeyHandle = homeNetworkKey.privateKeyHandle;
+
+            goto EXIT;
+        }
+    }
+
+    // The SUCI may have been concealed with a key that was just retired.
+    for (const auto &retiredHomeNetworkKey : retiredHomeNetworkKeys)
+    {
+        if (retiredHomeNetworkKey.identifier == homeNetworkKeyIdentifier)
+        {
+            privateKeyHandle = retiredHomeNetworkKey.privateKeyHandle;
+        }
+    }
+
+EXIT:
+    pthread_rwlock_unlock(&homeNetworkKeysLock);
+
     return privateKeyHandle;
 }
 
+void SuciScenario::getSuciPoolData(const size_t recordIndex,
+                                   CK_BYTE suciData[SUCI__DATA_LENGTH]) const
+{
+    assert(suciData != nullptr);
+    assert(dataLength == SUCI__DATA_LENGTH);
+
+    memcpy(suciData,
+           data,
+           SUCI__DATA_LENGTH);
+
+    for (size_t byteIndex = 0; byteIndex < 4; byteIndex++)
+    {
+        suciData[SUCI__SUPI_LENGTH - 1 - byteIndex] ^= (CK_BYTE)(recordIndex >> (8 * byteIndex));
+    }
+}
+
+unsigned long SuciScenario::getSuciPoolOffset(const TEST_IDENTIFIER testIdentifier) const
+{
+    return (unsigned long)((testIdentifier * SUCI__SUCI_POOL_SIZE) / tests.size());
+}
+
+void SuciScenario::getSuci(const unsigned long index,
+                           CK_BYTE &homeNetworkKeyIdentifier,
+                           CK_BYTE encryptedData[SUCI__ENCRYPTED_DATA_LENGTH],
+                           CK_ULONG &encryptedDataLength) const
+{
+    assert(&homeNetworkKeyIdentifier != nullptr);
+    assert(encryptedData != nullptr);
+    assert(&encryptedDataLength != nullptr);
+
+    pthread_rwlock_rdlock(&homeNetworkKeysLock);
+
+    const SUCI_HOME_NETWORK_KEY &homeNetworkKey = homeNetworkKeys[index % homeNetworkKeys.size()];
+
+    homeNetworkKeyIdentifier = homeNetworkKey.identifier;
+    encryptedDataLength = homeNetworkKey.encryptedDataLength;
+
+    memcpy(encryptedData,
+           homeNetworkKey.encryptedData,
+           encryptedDataLength);
+
+    pthread_rwlock_unlock(&homeNetworkKeysLock);
+}
+
 CK_RV SuciScenario::initialize()
 {
     assert(state == SCENARIO_STATE::Prepared);
@@ -211,118 +832,126 @@ CK_RV SuciScenario::initialize()
         goto EXIT;
     }
 
-    // Retrieve the public key.
-    rv = p11tk_findObjectForLabel(sessionHandle,
-                                  CKO_PUBLIC_KEY,
-                                  (CK_CHAR *)(publicKeyLabel.c_str()),
-                                  &publicKeyHandle);
-
-    if (rv != CKR_OK)
+    for (size_t keyIndex = 0;
+         keyIndex < homeNetworkKeys.size();
+         keyIndex++)
     {
-        writeError("Cannot retrieve the public key.",
-                   rv);
+        SUCI_HOME_NETWORK_KEY &homeNetworkKey = homeNetworkKeys[keyIndex];
 
-        goto EXIT;
-    }
+        // Retrieve the public key.
+        rv = p11tk_findObjectForLabel(sessionHandle,
+                                      CKO_PUBLIC_KEY,
+                                      (CK_CHAR *)(publicKeysLabels[keyIndex].c_str()),
+                                      &homeNetworkKey.publicKeyHandle);
 
-    if (publicKeyHandle == CK_INVALID_HANDLE)
-    {
-        writeError("The public key is missing.",
-                   rv);
+        if (rv != CKR_OK)
+        {
+            writeError("Cannot retrieve the public key.",
+                       rv);
 
-        goto EXIT;
-    }
+            goto EXIT;
+        }
 
-    // Retrieve the private key.
-    rv = p11tk_findObjectForLabel(sessionHandle,
-                                  CKO_PRIVATE_KEY,
-                                  (CK_CHAR *)(privateKeyLabel.c_str()),
-                                  &privateKeyHandle);
+        if (homeNetworkKey.publicKeyHandle == CK_INVALID_HANDLE)
+        {
+            writeError("The public key is missing.",
+                       rv);
 
-    if (rv != CKR_OK)
-    {
-        writeError("Cannot retrieve the private key.",
-                   rv);
+            goto EXIT;
+        }
 
-        goto EXIT;
-    }
+        // Retrieve the private key.
+        rv = p11tk_findObjectForLabel(sessionHandle,
+                                      CKO_PRIVATE_KEY,
+                                      (CK_CHAR *)(privateKeysLabels[keyIndex].c_str()),
+                                      &homeNetworkKey.privateKeyHandle);
 
-    if (privateKeyHandle == CK_INVALID_HANDLE)
-    {
-        writeError("The private key is missing.",
-                   rv);
+        if (rv != CKR_OK)
+        {
+            writeError("Cannot retrieve the private key.",
+                       rv);
 
-        goto EXIT;
-    }
+            goto EXIT;
+        }
 
-    // Get a new mechanism for the encryption purposes.
-    rv = getNewMechanism(pMechanism);
+        if (homeNetworkKey.privateKeyHandle == CK_INVALID_HANDLE)
+        {
+            writeError("The private key is missing.",
+                       rv);
 
-    if (rv != CKR_OK)
-    {
-        writeError("Cannot prepare the scenario: cannot get a new mechanism to encrypt the test data.",
-                   rv);
+            goto EXIT;
+        }
 
-        goto EXIT;
-    }
+        if (isUsingSuciPool)
+        {
+            homeNetworkKey.publicKeyLength = (isUsingProfileB ? ECTK_X25519_KEY_LENGTH : ECTK_P256_PUBLIC_KEY_LENGTH);
 
-    // Encrypt the test data.
-    rv = C_EncryptInit(sessionHandle,
-                       pMechanism,
-                       publicKeyHandle);
+            rv = p11tk_getEllipticCurvePoint(sessionHandle,
+                                             homeNetworkKey.publicKeyHandle,
+                                             homeNetworkKey.publicKey,
+                                             homeNetworkKey.publicKeyLength);
 
-    if (rv != CKR_OK)
-    {
-        writeError("Cannot prepare the scenario: cannot initialize data encryption for the test data.",
-                   rv);
+            if (rv != CKR_OK)
+            {
+                writeError("Cannot retrieve the public key value.",
+                           rv);
 
-        goto EXIT;
+                goto EXIT;
+            }
+        }
     }
 
-    encryptedDataLength = GET_ARRAY_SIZE(encryptedData);
-
-    rv = C_Encrypt(sessionHandle,
-                   data,
-                   dataLength,
-                   encryptedData,
-                   &encryptedDataLength);
+    // Get a new mechanism for the encryption purposes.
+    rv = getNewMechanism(pMechanism);
 
     if (rv != CKR_OK)
     {
-        writeError("Cannot encrypt data.",
+        writeError("Cannot prepare the scenario: cannot get a new mechanism to encrypt the test data.",
                    rv);
 
         goto EXIT;
     }
 
-    // If compressed points are requested, compress it.
-    // Set the leading byte to 0x02 to indicate a compress point with an even
-    // Y value or 0x03 to indicate a compressed point with an odd Y value.
-    // And then move the encrypted data to the left to overwrite the Y value.
-    if (isUsingCompressedCurvedPoints)
+    // Encrypt the test data with each public key.
+    for (auto &homeNetworkKey : homeNetworkKeys)
     {
-        const P11_ELLIPTIC_CURVES_LIST_ELEMENT *pEllipticCurveData = nullptr;
-
-        rv = p11tk_getEllipticCurveDataForCurveIdentifier(ellipticCurveIdentifier,
-                                                          &pEllipticCurveData);
+        rv = encryptData(pMechanism,
+                         homeNetworkKey);
 
         if (rv != CKR_OK)
         {
-            writeError("Cannot retrieve elliptic curve data.",
+            writeError("Cannot prepare the scenario: cannot encrypt the test data.",
                        rv);
 
             goto EXIT;
         }
+    }
 
-        unsigned int curveFieldLength = pEllipticCurveData->fieldLength;
+    // Generate the SUCI pool, and make sure that the HSM deconceals it.
+    if (isUsingSuciPool)
+    {
+        writeInformation("Generate the SUCI pool...\n");
 
-        encryptedData[0] = (CK_BYTE)((encryptedData[curveFieldLength * 2] & 0x01) ? 0x03 : 0x02);
+        rv = generateSuciPool();
 
-        memmove(&encryptedData[curveFieldLength + 1],
-                &encryptedData[curveFieldLength * 2 + 1],
-                encryptedDataLength - (curveFieldLength * 2 + 1));
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+
+        rv = checkSuciPool(pMechanism);
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
 
-        encryptedDataLength -= curveFieldLength;
+    // The rotation thread encrypts the test data with each new public key.
+    if (isRotatingHomeNetworkKeys)
+    {
+        pRotationMechanism = pMechanism;
+        pMechanism = nullptr;
     }
 
     goto END;
@@ -354,60 +983,223 @@ CK_RV SuciScenario::prepareScenario()
         goto EXIT;
     }
 
-    if (scenarioContext.isSharingObjects)
+    // Note: the SUCI pool, and the SUCIs deconcealed by the mock, are
+    // computed by the same software.
+    rv = checkKnownAnswers();
+
+    if (rv != CKR_OK)
     {
-        writeInformation("Look for an existing public key...\n");
+        writeError("The software computation of the SUCIs does not match the known answers.",
+                   rv);
 
-        rv = p11tk_findObjectForLabel(sessionHandle,
-                                      CKO_PUBLIC_KEY,
-                                      (CK_CHAR *)(publicKeyLabel.c_str()),
-                                      &publicKeyHandle);
+        goto EXIT;
+    }
 
-        if (rv != CKR_OK)
+    for (size_t keyIndex = 0;
+         keyIndex < homeNetworkKeys.size();
+         keyIndex++)
+    {
+        SUCI_HOME_NETWORK_KEY &homeNetworkKey = homeNetworkKeys[keyIndex];
+
+        if (scenarioContext.isSharingObjects)
         {
-            writeError("Cannot look for an existing public key.",
-                       rv);
+            writeInformation("Look for an existing public key...\n");
 
-            goto EXIT;
+            rv = p11tk_findObjectForLabel(sessionHandle,
+                                          CKO_PUBLIC_KEY,
+                                          (CK_CHAR *)(publicKeysLabels[keyIndex].c_str()),
+                                          &homeNetworkKey.publicKeyHandle);
+
+            if (rv != CKR_OK)
+            {
+                writeError("Cannot look for an existing public key.",
+                           rv);
+
+                goto EXIT;
+            }
+        }
+
+        if (homeNetworkKey.publicKeyHandle == CK_INVALID_HANDLE)
+        {
+            writeInformation("Generate needed HSM objects...\n");
+
+            // Generate key pair.
+            rv = p11tk_generateEllipticKeyPair(sessionHandle,
+                                               (isUsingTokenObjectsOnly ? TRUE : FALSE),
+                                               ellipticCurveIdentifier,
+                                               (CK_CHAR *)(publicKeysLabels[keyIndex].c_str()),
+                                               (CK_CHAR *)(privateKeysLabels[keyIndex].c_str()),
+                                               &homeNetworkKey.publicKeyHandle,
+                                               &homeNetworkKey.privateKeyHandle);
+
+            if (rv != CKR_OK)
+            {
+                writeError("Cannot generate an elliptic key pair.",
+                           rv);
+
+                goto EXIT;
+            }
+        }
+        else
+        {
+            writeInformation("A public key already exists.");
         }
     }
 
-    if (publicKeyHandle == CK_INVALID_HANDLE)
+    goto END;
+
+EXIT:
+    // Update the scenario state.
+    state = SCENARIO_STATE::Created;
+
+END:
+    return rv;
+}
+
+CK_RV SuciScenario::releaseUsedResources()
+{
+    // Release the memory (a SUCI pool takes about 10 MB).
+    std::vector<CK_BYTE>().swap(suciPool);
+
+    if (pRotationMechanism != nullptr)
     {
-        writeInformation("Generate needed HSM objects...\n");
+        free(pRotationMechanism->pParameter);
+        free(pRotationMechanism);
 
-        // Generate key pair.
-        rv = p11tk_generateEllipticKeyPair(sessionHandle,
-                                           (isUsingTokenObjectsOnly ? TRUE : FALSE),
-                                           ellipticCurveIdentifier,
-                                           (CK_CHAR *)(publicKeyLabel.c_str()),
-                                           (CK_CHAR *)(privateKeyLabel.c_str()),
-                                           &publicKeyHandle,
-                                           &privateKeyHandle);
+        pRotationMechanism = nullptr;
+    }
 
-        if (rv != CKR_OK)
-        {
-            writeError("Cannot generate an elliptic key pair.",
-                       rv);
+    return Scenario::releaseUsedResources();
+}
 
-            goto EXIT;
+CK_RV SuciScenario::rotateHomeNetworkKey()
+{
+    assert(pRotationMechanism != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    const auto rotationBeginTime = std::chrono::high_resolution_clock::now();
+
+    const std::string publicKeyLabel = generateObjectLabel(SUCI__TITLE,
+                                                           identifier,
+                                                           uuid,
+                                                           "Rotated Public Key");
+    const std::string privateKeyLabel = generateObjectLabel(SUCI__TITLE,
+                                                            identifier,
+                                                            uuid,
+                                                            "Rotated Private Key");
+
+    SUCI_HOME_NETWORK_KEY newHomeNetworkKey;
+    std::vector<SUCI_HOME_NETWORK_KEY> expiredHomeNetworkKeys = {};
+
+    memset(&newHomeNetworkKey,
+           0,
+           sizeof(newHomeNetworkKey));
+
+    newHomeNetworkKey.identifier = nextHomeNetworkKeyIdentifier;
+    newHomeNetworkKey.publicKeyHandle = CK_INVALID_HANDLE;
+    newHomeNetworkKey.privateKeyHandle = CK_INVALID_HANDLE;
+    newHomeNetworkKey.isRotated = true;
+
+    // Generate the new key pair (out of the lock: the tests keep running
+    // with the current keys in the meantime).
+    rv = p11tk_generateEllipticKeyPair(sessionHandle,
+                                       FALSE,
+                                       ellipticCurveIdentifier,
+                                       (CK_CHAR *)(publicKeyLabel.c_str()),
+                                       (CK_CHAR *)(privateKeyLabel.c_str()),
+                                       &newHomeNetworkKey.publicKeyHandle,
+                                       &newHomeNetworkKey.privateKeyHandle);
+
+    if (rv != CKR_OK)
+    {
+        writeError("Cannot generate a new home network key pair.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    rv = encryptData(pRotationMechanism,
+                     newHomeNetworkKey);
+
+    if (rv != CKR_OK)
+    {
+        destroyHomeNetworkKey(newHomeNetworkKey); // Ignore the result code.
+
+        goto EXIT;
+    }
+
+    // Replace the oldest key. The replaced key is retired but kept for one
+    // more period, so that the requests in progress can complete; the keys
+    // retired by the previous rotation are destroyed (unless they are the
+    // initial keys, which may be shared).
+    pthread_rwlock_wrlock(&homeNetworkKeysLock);
+
+    for (const auto &retiredHomeNetworkKey : retiredHomeNetworkKeys)
+    {
+        if (retiredHomeNetworkKey.isRotated)
+        {
+            expiredHomeNetworkKeys.push_back(retiredHomeNetworkKey);
         }
     }
-    else
+
+    retiredHomeNetworkKeys.erase(std::remove_if(retiredHomeNetworkKeys.begin(),
+                                                retiredHomeNetworkKeys.end(),
+                                                [](const SUCI_HOME_NETWORK_KEY &homeNetworkKey)
+                                                { return homeNetworkKey.isRotated; }),
+                                 retiredHomeNetworkKeys.end());
+
     {
-        writeInformation("A public key already exists.");
+        SUCI_HOME_NETWORK_KEY &oldestHomeNetworkKey = homeNetworkKeys[rotationsCount % homeNetworkKeys.size()];
+
+        retiredHomeNetworkKeys.push_back(oldestHomeNetworkKey);
+        oldestHomeNetworkKey = newHomeNetworkKey;
     }
 
-    goto END;
+    pthread_rwlock_unlock(&homeNetworkKeysLock);
+
+    for (const auto &expiredHomeNetworkKey : expiredHomeNetworkKeys)
+    {
+        destroyHomeNetworkKey(expiredHomeNetworkKey); // Ignore the result code.
+    }
+
+    // The identifier is coded on 8 bits; 0 is skipped as it is used by the
+    // null-scheme.
+    nextHomeNetworkKeyIdentifier = (CK_BYTE)((nextHomeNetworkKeyIdentifier == 0xFF) ? 1 : (nextHomeNetworkKeyIdentifier + 1));
+    rotationsCount++;
+
+    rotationStatistics.add((unsigned long)(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - rotationBeginTime).count()));
 
 EXIT:
-    // Update the scenario state
-    state = SCENARIO_STATE::Created;
+    if (rv != CKR_OK)
+    {
+        rotationErrorsCount++;
+    }
 
-END:
     return rv;
 }
 
+void SuciScenario::runHomeNetworkKeysRotation()
+{
+    auto periodBeginTime = std::chrono::high_resolution_clock::now();
+
+    while (!rotationTerminationRequested)
+    {
+        // Check the termination request often enough not to delay the end
+        // of the scenario.
+        usleep(10000);
+
+        if (std::chrono::high_resolution_clock::now() - periodBeginTime < std::chrono::seconds(SUCI__KEY_ROTATION_PERIOD))
+        {
+            continue;
+        }
+
+        periodBeginTime = std::chrono::high_resolution_clock::now();
+
+        rotateHomeNetworkKey(); // Errors are counted.
+    }
+}
+
 CK_RV SuciScenario::setScenarioData()
 {
     CK_RV rv = CKR_OK;
@@ -428,6 +1220,76 @@ EXIT:
     return rv;
 }
 
+CK_RV SuciScenario::start()
+{
+    assert(state == SCENARIO_STATE::Initialized);
+
+    CK_RV rv = CKR_OK;
+
+    rv = Scenario::start();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (isRotatingHomeNetworkKeys)
+    {
+        rotationTerminationRequested = false;
+
+        if (pthread_create(&rotationThreadIdentifier,
+                           nullptr,
+                           &runHomeNetworkKeysRotationInThread,
+                           this) != 0)
+        {
+            rv = CKR_GENERAL_ERROR;
+
+            writeError("Cannot run the keys rotation in a separate thread.",
+                       rv);
+
+            goto EXIT;
+        }
+
+        isRotationStarted = true;
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV SuciScenario::waitForStop()
+{
+    assert(state == SCENARIO_STATE::Started);
+
+    CK_RV rv = CKR_OK;
+
+    rv = Scenario::waitForStop();
+
+    // The keys are rotated as long as the tests are running.
+    if (isRotationStarted)
+    {
+        rotationTerminationRequested = true;
+
+        if (pthread_join(rotationThreadIdentifier,
+                         nullptr) != 0)
+        {
+            CK_RV rv2 = CKR_GENERAL_ERROR;
+
+            writeError("Cannot wait for the keys rotation termination.",
+                       rv2);
+
+            if (rv == CKR_OK)
+            {
+                rv = rv2;
+            }
+        }
+
+        isRotationStarted = false;
+    }
+
+    return rv;
+}
+
 void SuciScenario::writeDebugInformation() const
 {
     Scenario::writeDebugInformation();
@@ -435,38 +1297,72 @@ void SuciScenario::writeDebugInformation() const
     CK_BYTE ouid[P11TK_OUID_LENGTH] = {0};
     size_t ouidLength = GET_ARRAY_SIZE(ouid);
 
-    p11tk_getObjectUniqueIdentifier(sessionHandle,
-                                    publicKeyHandle,
-                                    ouid,
-                                    &ouidLength);
-    fprintf(stdout,
-            "  Public Key Label  : %s\n",
-            publicKeyLabel.c_str());
-    fprintf(stdout,
-            "  Public Key Handle : %ld\n",
-            publicKeyHandle);
-    writeBinaryData("  Public Key OUID   : ",
-                    ouid,
-                    ouidLength);
-
-    p11tk_getObjectUniqueIdentifier(sessionHandle,
-                                    privateKeyHandle,
-                                    ouid,
-                                    &ouidLength);
-    fprintf(stdout,
-            "  Private Key Label  : %s\n",
-            privateKeyLabel.c_str());
-    fprintf(stdout,
-            "  Private Key Handle : %ld\n",
-            privateKeyHandle);
-    writeBinaryData("  Private Key OUID   : ",
-                    ouid,
-                    ouidLength);
+    for (size_t keyIndex = 0;
+         keyIndex < homeNetworkKeys.size();
+         keyIndex++)
+    {
+        const SUCI_HOME_NETWORK_KEY &homeNetworkKey = homeNetworkKeys[keyIndex];
+
+        fprintf(stdout,
+                "  HN Key Identifier : %d\n",
+                homeNetworkKey.identifier);
+
+        ouidLength = GET_ARRAY_SIZE(ouid);
+
+        p11tk_getObjectUniqueIdentifier(sessionHandle,
+                                        homeNetworkKey.publicKeyHandle,
+                                        ouid,
+                                        &ouidLength);
+        fprintf(stdout,
+                "  Public Key Label  : %s\n",
+                publicKeysLabels[keyIndex].c_str());
+        fprintf(stdout,
+                "  Public Key Handle : %ld\n",
+                homeNetworkKey.publicKeyHandle);
+        writeBinaryData("  Public Key OUID   : ",
+                        ouid,
+                        ouidLength);
+
+        ouidLength = GET_ARRAY_SIZE(ouid);
+
+        p11tk_getObjectUniqueIdentifier(sessionHandle,
+                                        homeNetworkKey.privateKeyHandle,
+                                        ouid,
+                                        &ouidLength);
+        fprintf(stdout,
+                "  Private Key Label  : %s\n",
+                privateKeysLabels[keyIndex].c_str());
+        fprintf(stdout,
+                "  Private Key Handle : %ld\n",
+                homeNetworkKey.privateKeyHandle);
+        writeBinaryData("  Private Key OUID   : ",
+                        ouid,
+                        ouidLength);
+
+        writeBinaryData("  Encrypted Data: ",
+                        homeNetworkKey.encryptedData,
+                        homeNetworkKey.encryptedDataLength);
+    }
 
     writeBinaryData("  Data: ",
                     data,
                     dataLength);
-    writeBinaryData("  Encrypted Data: ",
-                    encryptedData,
-                    encryptedDataLength);
-}
\ No newline at end of file
+}
+
+void SuciScenario::writeStatistics() const
+{
+    Scenario::writeStatistics();
+
+    if (isRotatingHomeNetworkKeys)
+    {
+        fprintf(stdout,
+                "    Keys Rotations Count  = %ld (errors = %ld)\n",
+                rotationsCount,
+                rotationErrorsCount);
+        fprintf(stdout,
+                "    Keys Rotation Latency = Min = %ld, Mean = %ld, Max = %ld (micro-seconds)\n",
+                rotationStatistics.getMinMicroSeconds(),
+                rotationStatistics.getMeanMicroSeconds(),
+                rotationStatistics.getMaxMicroSeconds());
+    }
+}
@@ -12,7 +12,12 @@
 #ifndef SUCI_AUTHENTICATION_SCENARIO_HPP
 #define SUCI_AUTHENTICATION_SCENARIO_HPP
 
+#include <pthread.h>
+#include <vector>
+
+#include "scenarii/latency-statistics.hpp"
 #include "scenarii/scenario.hpp"
+#include "scenarii/test.hpp"
 
 #define SUCI__TITLE "SUCI"
 
@@ -27,9 +32,51 @@
 #define SUCI__PROFILE_A_CURVE 19
 #define SUCI__PROFILE_B_CURVE 69
 
+#define SUCI__MAXIMUM_HOME_NETWORK_KEYS_COUNT 9
+
+// Period of the home network keys rotation (seconds).
+#define SUCI__KEY_ROTATION_PERIOD 1
+
+// Number of SUCIs of the pool generated in software.
+#define SUCI__SUCI_POOL_SIZE 65536
+
+// Uncompressed P-256 point.
+#define SUCI__MAXIMUM_PUBLIC_KEY_LENGTH 65
+
+/*
+ * Home network key pair, as identified by the Home Network Public Key
+ * Identifier of the SUCIs (TS 23.003, 2.2B), along with a SUCI concealed
+ * with its public key.
+ */
+typedef struct
+{
+    CK_BYTE identifier;
+    CK_OBJECT_HANDLE publicKeyHandle;
+    CK_OBJECT_HANDLE privateKeyHandle;
+    CK_BYTE encryptedData[SUCI__ENCRYPTED_DATA_LENGTH];
+    CK_ULONG encryptedDataLength;
+
+    // Only retrieved to generate the SUCI pool.
+    CK_BYTE publicKey[SUCI__MAXIMUM_PUBLIC_KEY_LENGTH];
+    CK_ULONG publicKeyLength;
+
+    // Key pairs generated by the rotation are always session objects.
+    bool isRotated;
+} SUCI_HOME_NETWORK_KEY;
+
 /*
  * SUCI scenario flags are defined as follows:
- *   xyz:
+ *   uvwxyz:
+ *      u=
+ *          1: the requests deconceal a pool of SUCI__SUCI_POOL_SIZE distinct
+ *             SUCIs (one per SUPI), generated in software at initialization.
+ *          0: the requests deconceal the same SUCI for each home network key.
+ *      v=
+ *          1: a home network key pair is rotated in the background every
+ *             SUCI__KEY_ROTATION_PERIOD second(s).
+ *          0: the home network key pairs are not rotated.
+ *      w=
+ *          Number of home network key pairs (1 to 9, 0 meaning 1).
  *      x= (for profile A only)
  *          1: curve points are compressed.
  *          0: curve points are not compressed.
@@ -39,6 +86,11 @@
  *      z=
  *          1: use token objects only.
  *          0: use session objects only.
+ *
+ * Each request deconceals a SUCI with the private key matching its home
+ * network key identifier, the requests of a test using the keys in turn.
+ *
+ * The SUCI pool cannot be used along with the keys rotation.
  */
 class SuciScenario : public Scenario
 {
@@ -48,29 +100,67 @@ protected:
     //
     static const CK_BYTE SUCI__TEST_SET_1__SUPI[SUCI__SUPI_LENGTH];
 
-    std::string publicKeyLabel = "";
-    std::string privateKeyLabel = "";
+    std::vector<std::string> publicKeysLabels = {};
+    std::vector<std::string> privateKeysLabels = {};
+
+    // The home network keys are shared with the tests: they are protected
+    // by a lock as soon as the keys rotation is started.
+    std::vector<SUCI_HOME_NETWORK_KEY> homeNetworkKeys = {};
+    std::vector<SUCI_HOME_NETWORK_KEY> retiredHomeNetworkKeys = {};
+    mutable pthread_rwlock_t homeNetworkKeysLock = PTHREAD_RWLOCK_INITIALIZER;
+
+    //
+    // Keys rotation.
+    //
+    CK_MECHANISM *pRotationMechanism = nullptr;
+    pthread_t rotationThreadIdentifier = (pthread_t)0;
+    bool isRotationStarted = false;
+    bool rotationTerminationRequested = false;
+    CK_BYTE nextHomeNetworkKeyIdentifier = 0;
+    unsigned long rotationsCount = 0L;
+    unsigned long rotationErrorsCount = 0L;
+    LatencyStatistics rotationStatistics = {};
 
-    CK_OBJECT_HANDLE publicKeyHandle = CK_INVALID_HANDLE;
-    CK_OBJECT_HANDLE privateKeyHandle = CK_INVALID_HANDLE;
+    //
+    // SUCI pool.
+    //
+    // The pool is a flat buffer of fixed length records, each made of the
+    // home network key identifier followed by the encrypted data. The SUPI
+    // of record N is the test SUPI with its last 4 bytes XORed with N.
+    std::vector<CK_BYTE> suciPool = {};
+    size_t suciPoolRecordLength = 0;
 
     CK_RV clean() override;
+    CK_RV releaseUsedResources() override;
 
     CK_RV setScenarioData() override;
 
     CK_RV prepareScenario() override;
 
+    virtual CK_RV destroyHomeNetworkKey(const SUCI_HOME_NETWORK_KEY &homeNetworkKey) const;
+    // Checks the software ECIES primitives (X25519, P-256, KDF, AES-CTR and
+    // HMAC-SHA-256) against the test data of TS 33.501.
+    virtual CK_RV checkKnownAnswers() const;
+    virtual CK_RV checkSuciPool(const CK_MECHANISM *const pMechanism) const;
+    virtual CK_RV encryptData(const CK_MECHANISM *const pMechanism,
+                              SUCI_HOME_NETWORK_KEY &homeNetworkKey) const;
+    virtual CK_RV generateSuciPool();
+    virtual void getSuciPoolData(const size_t recordIndex,
+                                 CK_BYTE suciData[SUCI__DATA_LENGTH]) const;
+    virtual CK_RV rotateHomeNetworkKey();
+
 public:
     const bool isUsingProfileB;
     const bool isUsingCompressedCurvedPoints;
+    const size_t homeNetworkKeysCount;
+    const bool isRotatingHomeNetworkKeys;
+    const bool isUsingSuciPool;
 
     unsigned int ellipticCurveIdentifier = SUCI__PROFILE_A_CURVE;
 
     // These value are exposed publicly for the sake of simplicity, without risk.
     CK_BYTE data[SUCI__DATA_LENGTH] = {0};
     CK_ULONG dataLength = GET_ARRAY_SIZE(data);
-    CK_BYTE encryptedData[SUCI__ENCRYPTED_DATA_LENGTH] = {0};
-    CK_ULONG encryptedDataLength = GET_ARRAY_SIZE(encryptedData);
 
     SuciScenario(const ScenarioContext &scenarioContext,
                  const SCENARIO_FLAGS flags,
@@ -82,17 +172,50 @@ public:
     SuciScenario(const SuciScenario &) = delete;
     SuciScenario &operator=(const SuciScenario &) = delete;
 
+    bool checkFlag(const unsigned int position,
+                   const unsigned int value) const override;
     bool checkFlags(const SCENARIO_FLAGS flags) const override;
     const char *getFlagDescription(const unsigned int position) const override;
     unsigned int getFlagsCount() const override;
 
-    virtual CK_OBJECT_HANDLE getPrivateKeyHandle() const;
+    // Returns the private key matching a home network key identifier (including
+    // recently retired keys), or CK_INVALID_HANDLE if there is none.
+    virtual CK_OBJECT_HANDLE getPrivateKeyHandle(const CK_BYTE homeNetworkKeyIdentifier) const;
+
+    // Copies the SUCI of the home network key at 'index' (modulo the number
+    // of keys).
+    virtual void getSuci(const unsigned long index,
+                         CK_BYTE &homeNetworkKeyIdentifier,
+                         CK_BYTE encryptedData[SUCI__ENCRYPTED_DATA_LENGTH],
+                         CK_ULONG &encryptedDataLength) const;
+
+    // Points to the SUCI of the pool at 'index' (modulo the pool size) and
+    // sets the matching data (i.e. padded SUPI).
+    virtual void getPooledSuci(const unsigned long index,
+                               CK_BYTE &homeNetworkKeyIdentifier,
+                               const CK_BYTE *&pEncryptedData,
+                               CK_ULONG &encryptedDataLength,
+                               CK_BYTE expectedData[SUCI__DATA_LENGTH]) const;
+
+    // Index of the first SUCI of the pool used by a test, so that the tests
+    // do not deconceal the same SUCIs at the same time.
+    virtual unsigned long getSuciPoolOffset(const TEST_IDENTIFIER testIdentifier) const;
 
     CK_RV initialize() override;
+    CK_RV start() override;
+    CK_RV waitForStop() override;
 
     CK_RV getNewMechanism(CK_MECHANISM *&pMechanism) const override;
 
+    // Only used by the SUCI pool generation threads.
+    virtual bool generateSuciPoolRecords(const size_t firstIndex,
+                                         const size_t endIndex);
+
+    // Only used by the keys rotation thread.
+    virtual void runHomeNetworkKeysRotation();
+
     void writeDebugInformation() const override;
+    void writeStatistics() const override;
 };
 
 #endif /* SUCI_AUTHENTICATION_SCENARIO_HPP */
\ No newline at end of file
@@ -35,8 +35,22 @@ CK_RV SuciTest::run()
     assert(sessionHandle != CK_INVALID_HANDLE);
     assert(pMechanism != nullptr);
 
+    const SuciScenario &suciScenario = (const SuciScenario &)scenario;
+
     CK_RV rv = CKR_OK;
 
+    CK_BYTE homeNetworkKeyIdentifier = 0;
+    CK_OBJECT_HANDLE privateKeyHandle = CK_INVALID_HANDLE;
+
+    CK_BYTE encryptedData[SUCI__ENCRYPTED_DATA_LENGTH] = {0};
+    CK_ULONG encryptedDataLength = GET_ARRAY_SIZE(encryptedData);
+    const CK_BYTE *pEncryptedData = encryptedData;
+
+    // With the SUCI pool, each SUCI conceals a distinct SUPI.
+    CK_BYTE expectedData[SUCI__DATA_LENGTH] = {0};
+    const CK_BYTE *pExpectedData = suciScenario.data;
+    const unsigned long suciPoolOffset = (suciScenario.isUsingSuciPool ? suciScenario.getSuciPoolOffset(identifier) : 0);
+
     CK_BYTE decryptedData[SUCI__DATA_LENGTH] = {0};
     CK_ULONG decryptedDataLength = GET_ARRAY_SIZE(decryptedData);
 
@@ -44,60 +58,94 @@ CK_RV SuciTest::run()
            ((requestsCountObjective == 0) ||
             (requestsCount < requestsCountObjective)))
     {
-        requestsCount++;
+        if (suciScenario.isUsingSuciPool)
+        {
+            suciScenario.getPooledSuci(suciPoolOffset + requestsCount,
+                                       homeNetworkKeyIdentifier,
+                                       pEncryptedData,
+                                       encryptedDataLength,
+                                       expectedData);
+
+            pExpectedData = expectedData;
+        }
+        else
+        {
+            // The tests are not starting with the same home network key.
+            suciScenario.getSuci(identifier + requestsCount,
+                                 homeNetworkKeyIdentifier,
+                                 encryptedData,
+                                 encryptedDataLength);
+        }
+
+        beginRequest();
 
-        rv = C_DecryptInit(sessionHandle,
-                           pMechanism,
-                           ((SuciScenario &)scenario).getPrivateKeyHandle());
+        // Select the private key from the home network key identifier.
+        privateKeyHandle = suciScenario.getPrivateKeyHandle(homeNetworkKeyIdentifier);
 
-        if (rv != CKR_OK)
+        if (privateKeyHandle == CK_INVALID_HANDLE)
         {
-            writeError("Cannot initialize deconcealment.",
-                       rv);
+            writeError("Unknown home network key identifier.",
+                       CKR_KEY_HANDLE_INVALID);
 
             errorsCount++;
         }
         else
         {
-            decryptedDataLength = GET_ARRAY_SIZE(decryptedData);
-
-            rv = C_Decrypt(sessionHandle,
-                           ((SuciScenario &)scenario).encryptedData,
-                           ((SuciScenario &)scenario).encryptedDataLength,
-                           decryptedData,
-                           &decryptedDataLength);
+            rv = p11tk_getFunctionList()->C_DecryptInit(sessionHandle,
+                                                        pMechanism,
+                                                        privateKeyHandle);
 
             if (rv != CKR_OK)
             {
-                writeError("Cannot deconceal data.",
+                writeError("Cannot initialize deconcealment.",
                            rv);
 
                 errorsCount++;
             }
             else
             {
-                if (decryptedDataLength != ((SuciScenario &)scenario).dataLength)
+                decryptedDataLength = GET_ARRAY_SIZE(decryptedData);
+
+                rv = p11tk_getFunctionList()->C_Decrypt(sessionHandle,
+                                                        (CK_BYTE_PTR)pEncryptedData,
+                                                        encryptedDataLength,
+                                                        decryptedData,
+                                                        &decryptedDataLength);
+
+                if (rv != CKR_OK)
                 {
-                    writeError("Decrypted data length doesn't match data length.",
+                    writeError("Cannot deconceal data.",
                                rv);
 
                     errorsCount++;
                 }
                 else
                 {
-                    if (memcmp(decryptedData,
-                               ((SuciScenario &)scenario).data,
-                               ((SuciScenario &)scenario).dataLength) != 0)
+                    if (decryptedDataLength != suciScenario.dataLength)
                     {
-                        writeError("Decrypted data doesn't match data.",
+                        writeError("Decrypted data length doesn't match data length.",
                                    rv);
 
                         errorsCount++;
                     }
+                    else
+                    {
+                        if (memcmp(decryptedData,
+                                   pExpectedData,
+                                   suciScenario.dataLength) != 0)
+                        {
+                            writeError("Decrypted data doesn't match data.",
+                                       rv);
+
+                            errorsCount++;
+                        }
+                    }
                 }
             }
         }
+
+        endRequest();
     }
 
     return CKR_OK;
-}
\ No newline at end of file
+}
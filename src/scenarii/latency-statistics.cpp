@@ -0,0 +1,207 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+
+#include "latency-statistics.hpp"
+
+size_t LatencyStatistics::getBucketIndex(const unsigned long microSeconds)
+{
+    if (microSeconds < LATENCY_STATISTICS__SUB_BUCKETS_COUNT)
+    {
+        return (size_t)microSeconds;
+    }
+
+    // The power of two (at least 3), then the 3 bits following the leading
+    // one.
+    const unsigned int exponent = (unsigned int)(63 - __builtin_clzl(microSeconds));
+
+    return ((exponent - 2) * LATENCY_STATISTICS__SUB_BUCKETS_COUNT) +
+           (size_t)((microSeconds >> (exponent - 3)) & (LATENCY_STATISTICS__SUB_BUCKETS_COUNT - 1));
+}
+
+unsigned long LatencyStatistics::getBucketLowerBound(const size_t bucketIndex)
+{
+    if (bucketIndex < LATENCY_STATISTICS__SUB_BUCKETS_COUNT)
+    {
+        return (unsigned long)bucketIndex;
+    }
+
+    const unsigned int exponent = (unsigned int)(bucketIndex / LATENCY_STATISTICS__SUB_BUCKETS_COUNT) + 2;
+
+    return (unsigned long)(LATENCY_STATISTICS__SUB_BUCKETS_COUNT + (bucketIndex % LATENCY_STATISTICS__SUB_BUCKETS_COUNT)) << (exponent - 3);
+}
+
+void LatencyStatistics::add(const unsigned long microSeconds)
+{
+    if ((count == 0L) ||
+        (microSeconds < minMicroSeconds))
+    {
+        minMicroSeconds = microSeconds;
+    }
+
+    if (microSeconds > maxMicroSeconds)
+    {
+        maxMicroSeconds = microSeconds;
+    }
+
+    totalMicroSeconds += microSeconds;
+    count++;
+
+    buckets[getBucketIndex(microSeconds)]++;
+}
+
+unsigned long LatencyStatistics::getCount() const
+{
+    return count;
+}
+
+unsigned long LatencyStatistics::getMaxMicroSeconds() const
+{
+    return maxMicroSeconds;
+}
+
+unsigned long LatencyStatistics::getMeanMicroSeconds() const
+{
+    if (count == 0L)
+    {
+        return 0L;
+    }
+
+    return (unsigned long)(totalMicroSeconds / count);
+}
+
+unsigned long LatencyStatistics::getMinMicroSeconds() const
+{
+    return minMicroSeconds;
+}
+
+unsigned long LatencyStatistics::getPercentileMicroSeconds(const double percentile) const
+{
+    assert((percentile >= 0.0) && (percentile <= 100.0));
+
+    if (count == 0L)
+    {
+        return 0L;
+    }
+
+    const double rank = (percentile / 100.0) * (double)count;
+    unsigned long cumulatedCount = 0L;
+
+    for (size_t bucketIndex = 0; bucketIndex < buckets.size(); bucketIndex++)
+    {
+        if ((buckets[bucketIndex] == 0L) ||
+            ((double)(cumulatedCount + buckets[bucketIndex]) < rank))
+        {
+            cumulatedCount += buckets[bucketIndex];
+
+            continue;
+        }
+
+        const unsigned long lowerBound = getBucketLowerBound(bucketIndex);
+        const unsigned long upperBound = (bucketIndex + 1 < buckets.size()) ? getBucketLowerBound(bucketIndex + 1) : maxMicroSeconds;
+        const double ratio = (rank - (double)cumulatedCount) / (double)buckets[bucketIndex];
+        const unsigned long percentileMicroSeconds = lowerBound + (unsigned long)(ratio * (double)(upperBound - lowerBound));
+
+        // The bounds of the bucket are wider than the observed latencies.
+        if (percentileMicroSeconds < minMicroSeconds)
+        {
+            return minMicroSeconds;
+        }
+
+        return (percentileMicroSeconds > maxMicroSeconds) ? maxMicroSeconds : percentileMicroSeconds;
+    }
+
+    return maxMicroSeconds;
+}
+
+void LatencyStatistics::getSnapshot(LATENCY_STATISTICS_SNAPSHOT &snapshot) const
+{
+    assert(&snapshot != nullptr);
+
+    snapshot.count = count;
+    snapshot.totalMicroSeconds = totalMicroSeconds;
+    snapshot.minMicroSeconds = minMicroSeconds;
+    snapshot.maxMicroSeconds = maxMicroSeconds;
+
+    for (size_t bucketIndex = 0; bucketIndex < buckets.size(); bucketIndex++)
+    {
+        snapshot.buckets[bucketIndex] = buckets[bucketIndex];
+    }
+}
+
+void LatencyStatistics::merge(const LatencyStatistics &statistics)
+{
+    assert(&statistics != nullptr);
+
+    if (statistics.count == 0L)
+    {
+        return;
+    }
+
+    if ((count == 0L) ||
+        (statistics.minMicroSeconds < minMicroSeconds))
+    {
+        minMicroSeconds = statistics.minMicroSeconds;
+    }
+
+    if (statistics.maxMicroSeconds > maxMicroSeconds)
+    {
+        maxMicroSeconds = statistics.maxMicroSeconds;
+    }
+
+    totalMicroSeconds += statistics.totalMicroSeconds;
+    count += statistics.count;
+
+    for (size_t bucketIndex = 0; bucketIndex < buckets.size(); bucketIndex++)
+    {
+        buckets[bucketIndex] += statistics.buckets[bucketIndex];
+    }
+}
+
+void LatencyStatistics::mergeSnapshot(const LATENCY_STATISTICS_SNAPSHOT &snapshot)
+{
+    assert(&snapshot != nullptr);
+
+    if (snapshot.count == 0L)
+    {
+        return;
+    }
+
+    if ((count == 0L) ||
+        (snapshot.minMicroSeconds < minMicroSeconds))
+    {
+        minMicroSeconds = snapshot.minMicroSeconds;
+    }
+
+    if (snapshot.maxMicroSeconds > maxMicroSeconds)
+    {
+        maxMicroSeconds = snapshot.maxMicroSeconds;
+    }
+
+    totalMicroSeconds += snapshot.totalMicroSeconds;
+    count += snapshot.count;
+
+    for (size_t bucketIndex = 0; bucketIndex < buckets.size(); bucketIndex++)
+    {
+        buckets[bucketIndex] += snapshot.buckets[bucketIndex];
+    }
+}
+
+void LatencyStatistics::reset()
+{
+    count = 0L;
+    totalMicroSeconds = 0LL;
+    minMicroSeconds = 0L;
+    maxMicroSeconds = 0L;
+
+    buckets.fill(0L);
+}
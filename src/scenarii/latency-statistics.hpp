@@ -0,0 +1,78 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef LATENCY_STATISTICS_HPP
+#define LATENCY_STATISTICS_HPP
+
+#include <array>
+#include <cstddef>
+
+// Latencies histogram: exact buckets below 8 micro-seconds, then 8 buckets
+// per power of two, so that the percentiles are within 12.5%.
+#define LATENCY_STATISTICS__SUB_BUCKETS_COUNT 8
+#define LATENCY_STATISTICS__BUCKETS_COUNT (LATENCY_STATISTICS__SUB_BUCKETS_COUNT * 62)
+
+// Plain copy of latency statistics, e.g. to share them with other processes.
+typedef struct
+{
+    unsigned long count;
+    unsigned long long totalMicroSeconds;
+    unsigned long minMicroSeconds;
+    unsigned long maxMicroSeconds;
+    unsigned long buckets[LATENCY_STATISTICS__BUCKETS_COUNT];
+} LATENCY_STATISTICS_SNAPSHOT;
+
+/*
+ * Latency statistics of requests or of a stage of requests (in
+ * micro-seconds).
+ *
+ * Notes:
+ *   - Statistics are not thread-safe: each test updates its own statistics,
+ *     that are merged by the scenario once the tests are stopped; while they
+ *     run, only the snapshots published by the tests are read (see
+ *     Test::getLiveStatistics()).
+ */
+class LatencyStatistics
+{
+protected:
+    unsigned long count = 0L;
+    unsigned long long totalMicroSeconds = 0LL;
+    unsigned long minMicroSeconds = 0L;
+    unsigned long maxMicroSeconds = 0L;
+    std::array<unsigned long, LATENCY_STATISTICS__BUCKETS_COUNT> buckets = {};
+
+    static size_t getBucketIndex(const unsigned long microSeconds);
+    static unsigned long getBucketLowerBound(const size_t bucketIndex);
+
+public:
+    LatencyStatistics() = default;
+    virtual ~LatencyStatistics() = default;
+
+    LatencyStatistics(const LatencyStatistics &) = default;
+    LatencyStatistics &operator=(const LatencyStatistics &) = default;
+
+    virtual void add(const unsigned long microSeconds);
+    virtual void merge(const LatencyStatistics &statistics);
+    virtual void mergeSnapshot(const LATENCY_STATISTICS_SNAPSHOT &snapshot);
+    virtual void reset();
+
+    virtual void getSnapshot(LATENCY_STATISTICS_SNAPSHOT &snapshot) const;
+
+    virtual unsigned long getCount() const;
+    virtual unsigned long getMaxMicroSeconds() const;
+    virtual unsigned long getMeanMicroSeconds() const;
+    virtual unsigned long getMinMicroSeconds() const;
+
+    // Percentile in [0, 100], interpolated within its bucket.
+    virtual unsigned long getPercentileMicroSeconds(const double percentile) const;
+};
+
+#endif /* LATENCY_STATISTICS_HPP */
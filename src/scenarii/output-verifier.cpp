@@ -0,0 +1,211 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "output-verifier.hpp"
+#include "scenario.hpp"
+
+void *runOutputVerifierInThread(void *arg)
+{
+    assert(arg != nullptr);
+
+    ((OutputVerifier *)arg)->run();
+
+    return nullptr;
+}
+
+OutputVerifier::OutputVerifier(const Scenario &_scenario) : Top(_scenario.getUniqueString() +
+                                                                std::string(": Verifier")),
+                                                            slots(OUTPUT_VERIFIER__SLOTS_COUNT * OUTPUT_VERIFIER__MAXIMUM_OUTPUT_LENGTH),
+                                                            slotsLengths(OUTPUT_VERIFIER__SLOTS_COUNT),
+                                                            scenario(_scenario)
+{
+    assert(&_scenario != nullptr);
+
+    // Nothing else to do here.
+}
+
+OutputVerifier::~OutputVerifier()
+{
+    stop(); // Ignore the result code.
+
+    pthread_cond_destroy(&condition);
+    pthread_mutex_destroy(&mutex);
+}
+
+unsigned long OutputVerifier::getDroppedCount() const
+{
+    return droppedCount;
+}
+
+unsigned long OutputVerifier::getMismatchesCount() const
+{
+    return mismatchesCount;
+}
+
+unsigned long OutputVerifier::getSampledCount() const
+{
+    return sampledCount;
+}
+
+unsigned long OutputVerifier::getVerifiedCount() const
+{
+    return verifiedCount;
+}
+
+void OutputVerifier::run()
+{
+    CK_BYTE output[OUTPUT_VERIFIER__MAXIMUM_OUTPUT_LENGTH] = {0};
+    CK_ULONG outputLength = 0;
+
+    pthread_mutex_lock(&mutex);
+
+    while (true)
+    {
+        while ((count == 0) &&
+               (!terminationRequested))
+        {
+            pthread_cond_wait(&condition,
+                              &mutex);
+        }
+
+        // Terminate once the queued outputs are verified.
+        if (count == 0)
+        {
+            break;
+        }
+
+        outputLength = slotsLengths[head];
+
+        memcpy(output,
+               &slots[head * OUTPUT_VERIFIER__MAXIMUM_OUTPUT_LENGTH],
+               outputLength);
+
+        head = (head + 1) % OUTPUT_VERIFIER__SLOTS_COUNT;
+        count--;
+
+        pthread_mutex_unlock(&mutex);
+
+        const bool isMatching = scenario.verifyOutput(output,
+                                                      outputLength);
+
+        pthread_mutex_lock(&mutex);
+
+        verifiedCount++;
+
+        if (!isMatching)
+        {
+            // Only the first mismatch is written, the other ones are counted.
+            if (mismatchesCount == 0)
+            {
+                fprintf(stderr,
+                        "%s: the output does not match its software computation.\n",
+                        getUniqueString().c_str());
+            }
+
+            mismatchesCount++;
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+CK_RV OutputVerifier::start()
+{
+    assert(!isStarted);
+
+    CK_RV rv = CKR_OK;
+
+    terminationRequested = false;
+
+    if (pthread_create(&threadIdentifier,
+                       nullptr,
+                       &runOutputVerifierInThread,
+                       this) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot run the verifier in a separate thread.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    isStarted = true;
+
+EXIT:
+    return rv;
+}
+
+CK_RV OutputVerifier::stop()
+{
+    CK_RV rv = CKR_OK;
+
+    if (!isStarted)
+    {
+        goto EXIT;
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    terminationRequested = true;
+
+    pthread_cond_signal(&condition);
+    pthread_mutex_unlock(&mutex);
+
+    isStarted = false;
+
+    if (pthread_join(threadIdentifier,
+                     nullptr) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot wait for the verifier termination.",
+                   rv);
+    }
+
+EXIT:
+    return rv;
+}
+
+void OutputVerifier::submit(const CK_BYTE *const output,
+                            const CK_ULONG outputLength)
+{
+    assert(output != nullptr);
+
+    pthread_mutex_lock(&mutex);
+
+    sampledCount++;
+
+    if ((count == OUTPUT_VERIFIER__SLOTS_COUNT) ||
+        (outputLength > OUTPUT_VERIFIER__MAXIMUM_OUTPUT_LENGTH))
+    {
+        droppedCount++;
+    }
+    else
+    {
+        const size_t slotIndex = (head + count) % OUTPUT_VERIFIER__SLOTS_COUNT;
+
+        memcpy(&slots[slotIndex * OUTPUT_VERIFIER__MAXIMUM_OUTPUT_LENGTH],
+               output,
+               outputLength);
+
+        slotsLengths[slotIndex] = outputLength;
+        count++;
+
+        pthread_cond_signal(&condition);
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
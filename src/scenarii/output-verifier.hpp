@@ -0,0 +1,88 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef OUTPUT_VERIFIER_HPP
+#define OUTPUT_VERIFIER_HPP
+
+#include <pthread.h>
+#include <vector>
+
+#include "top.hpp"
+
+// Outputs waiting to be verified; the outputs submitted when all the slots
+// are used are dropped (i.e. counted but not verified).
+#define OUTPUT_VERIFIER__SLOTS_COUNT 1024
+#define OUTPUT_VERIFIER__MAXIMUM_OUTPUT_LENGTH 256
+
+class Scenario;
+
+void *runOutputVerifierInThread(void *arg);
+
+/*
+ * Verifier of a sample of the outputs returned to the tests of a scenario,
+ * recomputed in software by the scenario (see Scenario::verifyOutput()).
+ *
+ * Notes:
+ *   - The outputs are verified on a thread of their own, so that the
+ *     tests only pay for a copy of their sampled outputs.
+ *   - A mismatch is not a PKCS#11 error: it is only counted by the
+ *     verifier, the request being accounted as successful by its test.
+ */
+class OutputVerifier : public Top
+{
+protected:
+    pthread_t threadIdentifier = (pthread_t)0;
+    bool isStarted = false;
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t condition = PTHREAD_COND_INITIALIZER;
+    bool terminationRequested = false;
+
+    // Ring of slots, 'count' outputs being queued from 'head'.
+    std::vector<CK_BYTE> slots = {};
+    std::vector<CK_ULONG> slotsLengths = {};
+    size_t head = 0;
+    size_t count = 0;
+
+    unsigned long sampledCount = 0L;
+    unsigned long verifiedCount = 0L;
+    unsigned long mismatchesCount = 0L;
+    unsigned long droppedCount = 0L;
+
+public:
+    const Scenario &scenario;
+
+    explicit OutputVerifier(const Scenario &scenario);
+    ~OutputVerifier() override;
+
+    OutputVerifier(const OutputVerifier &) = delete;
+    OutputVerifier &operator=(const OutputVerifier &) = delete;
+
+    // Verifies the queued outputs until stopped.
+    virtual void run();
+
+    virtual CK_RV start();
+
+    // Verifies the outputs still queued before to return.
+    virtual CK_RV stop();
+
+    // Queues a copy of an output, or drops it if no slot is available.
+    virtual void submit(const CK_BYTE *const output,
+                        const CK_ULONG outputLength);
+
+    // Note: the counters are only consistent once the verifier is stopped.
+    virtual unsigned long getSampledCount() const;
+    virtual unsigned long getVerifiedCount() const;
+    virtual unsigned long getMismatchesCount() const;
+    virtual unsigned long getDroppedCount() const;
+};
+
+#endif /* OUTPUT_VERIFIER_HPP */
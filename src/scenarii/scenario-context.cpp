@@ -18,11 +18,36 @@ ScenarioContext::ScenarioContext(const CK_SLOT_ID _slotId,
                                  const CK_CHAR *const _coPassword,
                                  const CK_ULONG _coPasswordLength,
                                  const bool _isSharingObjects,
-                                 const bool _isVerbose) : slotId(_slotId),
-                                                          coPassword(_coPassword),
-                                                          coPasswordLength(_coPasswordLength),
-                                                          isSharingObjects(_isSharingObjects),
-                                                          isVerbose(_isVerbose)
+                                 const bool _isVerbose,
+                                 const std::string &_servingNetworkName,
+                                 const std::string &_accessNetworkName,
+                                 const double _verificationRatio,
+                                 const std::shared_ptr<StartGate> &_pStartGate,
+                                 const std::shared_ptr<ThreadLayout> &_pThreadLayout,
+                                 const std::shared_ptr<ThreadPool> &_pThreadPool,
+                                 const std::shared_ptr<Watchdog> &_pWatchdog,
+                                 const size_t _slowestRequestsCount) : slotId(_slotId),
+                                                                       coPassword(_coPassword),
+                                                                       coPasswordLength(_coPasswordLength),
+                                                                       isSharingObjects(_isSharingObjects),
+                                                                       isVerbose(_isVerbose),
+                                                                       servingNetworkName(_servingNetworkName),
+                                                                       accessNetworkName(_accessNetworkName),
+                                                                       verificationRatio(_verificationRatio),
+                                                                       pStartGate(_pStartGate),
+                                                                       pThreadLayout(_pThreadLayout),
+                                                                       pThreadPool(_pThreadPool),
+                                                                       pWatchdog(_pWatchdog),
+                                                                       slowestRequestsCount(_slowestRequestsCount)
+{
+    assert(_pStartGate != nullptr);
+    assert(_pThreadLayout != nullptr);
+    assert(_pThreadPool != nullptr);
+
+    // Nothing else to do here.
+}
+
+ScenarioContext::~ScenarioContext()
 {
     // Nothing else to do here.
 }
@@ -12,7 +12,14 @@
 #ifndef SCENARIO_CONTEXT_HPP
 #define SCENARIO_CONTEXT_HPP
 
+#include <memory>
+#include <string>
+
+#include "start-gate.hpp"
+#include "thread-layout.hpp"
+#include "thread-pool.hpp"
 #include "top.hpp"
+#include "watchdog.hpp"
 
 extern "C"
 {
@@ -32,12 +39,44 @@ public:
     const bool isSharingObjects;
     const bool isVerbose;
 
+    // Network names used by the key derivations (5G-AKA and EAP-AKA').
+    const std::string servingNetworkName;
+    const std::string accessNetworkName;
+
+    // Ratio (in [0, 1]) of the outputs verified in software, 0 if none.
+    const double verificationRatio;
+
+    // Gate releasing the tests of all the scenarii at once.
+    const std::shared_ptr<StartGate> pStartGate;
+
+    // Placement of the threads of the tests of all the scenarii.
+    const std::shared_ptr<ThreadLayout> pThreadLayout;
+
+    // Threads running the tests of all the scenarii.
+    const std::shared_ptr<ThreadPool> pThreadPool;
+
+    // Watchdog of the calls of the tests, nullptr if none.
+    const std::shared_ptr<Watchdog> pWatchdog;
+
+    // Slowest requests kept per test and per scenario, 0 if none.
+    const size_t slowestRequestsCount;
+
     ScenarioContext(const CK_SLOT_ID slotId,
                     const CK_CHAR *const coPassword,
                     const CK_ULONG coPasswordLength,
                     const bool isSharingObjects,
-                    const bool isVerbose);
-    virtual ~ScenarioContext() = default;
+                    const bool isVerbose,
+                    const std::string &servingNetworkName,
+                    const std::string &accessNetworkName,
+                    const double verificationRatio,
+                    const std::shared_ptr<StartGate> &pStartGate,
+                    const std::shared_ptr<ThreadLayout> &pThreadLayout,
+                    const std::shared_ptr<ThreadPool> &pThreadPool,
+                    const std::shared_ptr<Watchdog> &pWatchdog,
+                    const size_t slowestRequestsCount);
+
+    // Note: cannot use default destructor (cannot be inlined because it is too large).
+    virtual ~ScenarioContext();
 
     ScenarioContext(const ScenarioContext &) = default;
     ScenarioContext &operator=(const ScenarioContext &) = delete;
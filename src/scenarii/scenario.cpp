@@ -9,17 +9,34 @@
 *
 \****************************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <memory>
 #include <random>
+#include <unistd.h>
 
 #include "3gpp/authentication/comp-128/comp-128-scenario.hpp"
+#include "3gpp/authentication/milenage/milenage-aka-scenario.hpp"
+#include "3gpp/authentication/milenage/milenage-eap-aka-prime-scenario.hpp"
+#include "3gpp/authentication/milenage/milenage-resync-scenario.hpp"
 #include "3gpp/authentication/milenage/milenage-scenario.hpp"
+#include "3gpp/authentication/milenage/milenage-software-scenario.hpp"
+#include "3gpp/authentication/tuak/tuak-aka-scenario.hpp"
+#include "3gpp/authentication/tuak/tuak-eap-aka-prime-scenario.hpp"
+#include "3gpp/authentication/tuak/tuak-resync-scenario.hpp"
 #include "3gpp/authentication/tuak/tuak-scenario.hpp"
+#include "3gpp/authentication/tuak/tuak-software-scenario.hpp"
 #include "3gpp/suci/suci-scenario.hpp"
+#include "output-verifier.hpp"
 #include "test.hpp"
 
+bool isSlowerRequest(const SLOW_REQUEST &left,
+                     const SLOW_REQUEST &right)
+{
+    return left.microSeconds > right.microSeconds;
+}
+
 Scenario::Scenario(const ScenarioContext &_scenarioContext,
                    const SCENARIO_FLAGS _flags,
                    const SCENARIO_IDENTIFIER _identifier,
@@ -96,6 +113,11 @@ bool Scenario::checkFlags(const SCENARIO_FLAGS _flags) const
     return true;
 }
 
+CK_RV Scenario::checkVerificationKnownAnswers() const
+{
+    return CKR_FUNCTION_NOT_SUPPORTED;
+}
+
 CK_RV Scenario::clean()
 {
     writeInformation("Clean the scenario...\n");
@@ -178,7 +200,9 @@ unsigned long long Scenario::generateUuid() const
 {
     std::minstd_rand randomGenerator;
 
-    randomGenerator.seed((unsigned int)(time(nullptr) & 0x0FFFF));
+    // The process identifier tells apart the instances started in the same
+    // second (e.g. the workers of '--processes').
+    randomGenerator.seed((unsigned int)(((time(nullptr) & 0x0FFFF) << 16) ^ getpid()));
 
     return (((unsigned long long)randomGenerator() & 0x0FFFF) << 48) +
            (((unsigned long long)randomGenerator() & 0x0FFFF) << 32) +
@@ -289,6 +313,78 @@ int Scenario::getInstance(const SCENARIO_CLASS scenarioClass,
 
         break;
 
+    case SCENARIO_CLASS__MILENAGE_RESYNCHRONIZATION:
+        pScenario = std::make_shared<MilenageResyncScenario>(_scenarioContext,
+                                                             _flags,
+                                                             _identifier,
+                                                             testsCount,
+                                                             _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__TUAK_RESYNCHRONIZATION:
+        pScenario = std::make_shared<TuakResyncScenario>(_scenarioContext,
+                                                         _flags,
+                                                         _identifier,
+                                                         testsCount,
+                                                         _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__MILENAGE_5G_AKA:
+        pScenario = std::make_shared<MilenageAkaScenario>(_scenarioContext,
+                                                          _flags,
+                                                          _identifier,
+                                                          testsCount,
+                                                          _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__TUAK_5G_AKA:
+        pScenario = std::make_shared<TuakAkaScenario>(_scenarioContext,
+                                                      _flags,
+                                                      _identifier,
+                                                      testsCount,
+                                                      _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__MILENAGE_EAP_AKA_PRIME:
+        pScenario = std::make_shared<MilenageEapAkaPrimeScenario>(_scenarioContext,
+                                                                  _flags,
+                                                                  _identifier,
+                                                                  testsCount,
+                                                                  _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__TUAK_EAP_AKA_PRIME:
+        pScenario = std::make_shared<TuakEapAkaPrimeScenario>(_scenarioContext,
+                                                              _flags,
+                                                              _identifier,
+                                                              testsCount,
+                                                              _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__MILENAGE_SOFTWARE:
+        pScenario = std::make_shared<MilenageSoftwareScenario>(_scenarioContext,
+                                                               _flags,
+                                                               _identifier,
+                                                               testsCount,
+                                                               _requestsCountPerTest);
+
+        break;
+
+    case SCENARIO_CLASS__TUAK_SOFTWARE:
+        pScenario = std::make_shared<TuakSoftwareScenario>(_scenarioContext,
+                                                           _flags,
+                                                           _identifier,
+                                                           testsCount,
+                                                           _requestsCountPerTest);
+
+        break;
+
     default:
         return SCENARIO__ERROR_CODE__UNKNOWN_SCENARIO_CLASS;
     }
@@ -303,6 +399,36 @@ int Scenario::getInstance(const SCENARIO_CLASS scenarioClass,
     return SCENARIO__ERROR_CODE__NO_ERROR;
 }
 
+void Scenario::getLiveStatistics(unsigned long &liveRequestsCount,
+                                 unsigned long &liveErrorsCount,
+                                 LatencyStatistics &liveRequestsStatistics) const
+{
+    assert(&liveRequestsCount != nullptr);
+    assert(&liveErrorsCount != nullptr);
+    assert(&liveRequestsStatistics != nullptr);
+
+    liveRequestsCount = 0L;
+    liveErrorsCount = 0L;
+
+    liveRequestsStatistics.reset();
+
+    for (const auto &pTest : tests)
+    {
+        unsigned long testRequestsCount = 0L;
+        unsigned long testErrorsCount = 0L;
+        LATENCY_STATISTICS_SNAPSHOT testRequestsStatistics = {};
+
+        pTest->getLiveStatistics(testRequestsCount,
+                                 testErrorsCount,
+                                 testRequestsStatistics);
+
+        liveRequestsCount += testRequestsCount;
+        liveErrorsCount += testErrorsCount;
+
+        liveRequestsStatistics.mergeSnapshot(testRequestsStatistics);
+    }
+}
+
 unsigned long Scenario::getMaxTestTps() const
 {
     return maxTestTps;
@@ -318,6 +444,11 @@ unsigned long Scenario::getMinTestTps() const
     return minTestTps;
 }
 
+unsigned long Scenario::getMismatchingOutputsCount() const
+{
+    return (pOutputVerifier != nullptr) ? pOutputVerifier->getMismatchesCount() : 0L;
+}
+
 CK_RV Scenario::getNewMechanism(CK_MECHANISM *&pMechanism) const
 {
     assert(state == SCENARIO_STATE::Initialized);
@@ -326,16 +457,44 @@ CK_RV Scenario::getNewMechanism(CK_MECHANISM *&pMechanism) const
     return CKR_GENERAL_ERROR;
 }
 
+unsigned long Scenario::getProfilingContext() const
+{
+    // The default context is kept for the calls made outside of any scenario.
+    return identifier + 1;
+}
+
 unsigned long Scenario::getRequestsCount() const
 {
     return requestsCount;
 }
 
+const LatencyStatistics &Scenario::getRequestsStatistics() const
+{
+    return requestsStatistics;
+}
+
+const std::vector<SLOW_REQUEST> &Scenario::getSlowestRequests() const
+{
+    return slowestRequests;
+}
+
 SCENARIO_STATE Scenario::getState() const
 {
     return state;
 }
 
+size_t Scenario::getTestsStateBytes() const
+{
+    size_t testsStateBytes = 0;
+
+    for (const auto &pTest : tests)
+    {
+        testsStateBytes += pTest->getStateBytes();
+    }
+
+    return testsStateBytes;
+}
+
 unsigned long Scenario::getTps() const
 {
     auto elapsedMicroSeconds = getElapsedMicroSeconds();
@@ -350,6 +509,16 @@ unsigned long Scenario::getTps() const
     return (unsigned long)((double)(requestsCount - errorsCount) / ((double)elapsedMicroSeconds / 1000000.));
 }
 
+std::string Scenario::getVerifiedAlgorithm() const
+{
+    return std::string();
+}
+
+unsigned long Scenario::getVerifiedOutputsCount() const
+{
+    return (pOutputVerifier != nullptr) ? pOutputVerifier->getVerifiedCount() : 0L;
+}
+
 CK_RV Scenario::initialize()
 {
     assert(state == SCENARIO_STATE::Prepared);
@@ -422,6 +591,8 @@ CK_RV Scenario::prepareScenario()
     maxTestTps = 0L;
     meanTestTps = 0L;
 
+    requestsStatistics.reset();
+
     // Set the scenario data.
     rv = setScenarioData();
 
@@ -500,6 +671,39 @@ CK_RV Scenario::start()
         }
     }
 
+    // Start the verifier (before the tests, that submit their outputs).
+    pOutputVerifier = nullptr;
+
+    if (scenarioContext.verificationRatio > 0.0)
+    {
+        rv = checkVerificationKnownAnswers();
+
+        if (rv == CKR_FUNCTION_NOT_SUPPORTED)
+        {
+            rv = CKR_OK;
+        }
+        else if (rv != CKR_OK)
+        {
+            writeError("The software computation of the outputs does not match the known answers.",
+                       rv);
+
+            goto EXIT;
+        }
+        else
+        {
+            pOutputVerifier = std::make_shared<OutputVerifier>(*this);
+
+            rv = pOutputVerifier->start();
+
+            if (rv != CKR_OK)
+            {
+                pOutputVerifier = nullptr;
+
+                goto EXIT;
+            }
+        }
+    }
+
     // Start the tests.
     beginTime = std::chrono::high_resolution_clock::now();
 
@@ -536,6 +740,16 @@ CK_RV Scenario::stop()
     return waitForStop();
 }
 
+void Scenario::submitOutput(const CK_BYTE *const output,
+                            const CK_ULONG outputLength) const
+{
+    if (pOutputVerifier != nullptr)
+    {
+        pOutputVerifier->submit(output,
+                                outputLength);
+    }
+}
+
 CK_RV Scenario::terminate()
 {
     assert((state == SCENARIO_STATE::Prepared) ||
@@ -574,6 +788,9 @@ CK_RV Scenario::terminate()
         }
     }
 
+    // Stop the verifier (if the tests could not be started).
+    pOutputVerifier = nullptr;
+
     // Release used resources.
     rv = releaseUsedResources();
 
@@ -592,6 +809,15 @@ EXIT:
     return rv;
 }
 
+bool Scenario::verifyOutput(const CK_BYTE *const output,
+                            const CK_ULONG outputLength) const
+{
+    assert(output != nullptr);
+    assert(outputLength > 0);
+
+    return true;
+}
+
 CK_RV Scenario::waitForStop()
 {
     assert(state == SCENARIO_STATE::Started);
@@ -610,6 +836,20 @@ CK_RV Scenario::waitForStop()
 
     endTime = std::chrono::high_resolution_clock::now();
 
+    // The tests are run from the opening of the start gate.
+    beginTime = scenarioContext.pStartGate->getOpeningTime();
+
+    // Verify the outputs still queued.
+    if (pOutputVerifier != nullptr)
+    {
+        rv = pOutputVerifier->stop();
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
     // Update the statistics.
     {
         for (auto &pTest : tests)
@@ -632,9 +872,45 @@ CK_RV Scenario::waitForStop()
             requestsCount += pTest->getRequestsCount();
             errorsCount += pTest->getErrorsCount();
             meanTestTps += tps;
+
+            requestsStatistics.merge(pTest->getRequestsStatistics());
         }
 
         meanTestTps /= tests.size();
+
+        stagesStatistics.assign(stagesNames.size(),
+                                LatencyStatistics());
+
+        for (auto &pTest : tests)
+        {
+            const std::vector<LatencyStatistics> &testStagesStatistics = pTest->getStagesStatistics();
+
+            for (size_t stageIndex = 0;
+                 (stageIndex < stagesStatistics.size()) &&
+                 (stageIndex < testStagesStatistics.size());
+                 stageIndex++)
+            {
+                stagesStatistics[stageIndex].merge(testStagesStatistics[stageIndex]);
+            }
+        }
+
+        slowestRequests.clear();
+
+        for (auto &pTest : tests)
+        {
+            slowestRequests.insert(slowestRequests.end(),
+                                   pTest->getSlowestRequests().begin(),
+                                   pTest->getSlowestRequests().end());
+        }
+
+        std::sort(slowestRequests.begin(),
+                  slowestRequests.end(),
+                  &isSlowerRequest);
+
+        if (slowestRequests.size() > scenarioContext.slowestRequestsCount)
+        {
+            slowestRequests.resize(scenarioContext.slowestRequestsCount);
+        }
     }
 
     // Update the scenario state.
@@ -663,3 +939,66 @@ void Scenario::writeInformation(const char *const message) const
         Top::writeInformation(message);
     }
 }
+
+void Scenario::writeStatistics() const
+{
+    fprintf(stdout,
+            "    Latencies (micro-seconds, per successful request): Mean = %ld, P50 = %ld, P90 = %ld, P99 = %ld, Max = %ld\n",
+            requestsStatistics.getMeanMicroSeconds(),
+            requestsStatistics.getPercentileMicroSeconds(50.0),
+            requestsStatistics.getPercentileMicroSeconds(90.0),
+            requestsStatistics.getPercentileMicroSeconds(99.0),
+            requestsStatistics.getMaxMicroSeconds());
+
+    if (pOutputVerifier != nullptr)
+    {
+        fprintf(stdout,
+                "    Verified outputs: Sampled = %ld, Verified = %ld, Mismatches = %ld, Dropped = %ld\n",
+                pOutputVerifier->getSampledCount(),
+                pOutputVerifier->getVerifiedCount(),
+                pOutputVerifier->getMismatchesCount(),
+                pOutputVerifier->getDroppedCount());
+    }
+    else if (scenarioContext.verificationRatio > 0.0)
+    {
+        fprintf(stdout,
+                "    Verified outputs: not supported by the scenario\n");
+    }
+
+    if (stagesStatistics.empty())
+    {
+        return;
+    }
+
+    fprintf(stdout,
+            "    Latencies (micro-seconds, per successful stage):\n");
+
+    for (size_t stageIndex = 0;
+         stageIndex < stagesStatistics.size();
+         stageIndex++)
+    {
+        const LatencyStatistics &stageStatistics = stagesStatistics[stageIndex];
+
+        fprintf(stdout,
+                "      %-16s: Count = %ld, Min = %ld, Mean = %ld, Max = %ld",
+                stagesNames[stageIndex].c_str(),
+                stageStatistics.getCount(),
+                stageStatistics.getMinMicroSeconds(),
+                stageStatistics.getMeanMicroSeconds(),
+                stageStatistics.getMaxMicroSeconds());
+
+        // The first stage is the reference one (e.g. the plain authentication
+        // request), the cost of the other stages being given relatively to it.
+        if ((stageIndex > 0) &&
+            (stagesStatistics[0].getMeanMicroSeconds() != 0))
+        {
+            fprintf(stdout,
+                    " (%ld%% of %s)",
+                    (stageStatistics.getMeanMicroSeconds() * 100) / stagesStatistics[0].getMeanMicroSeconds(),
+                    stagesNames[0].c_str());
+        }
+
+        fprintf(stdout,
+                "\n");
+    }
+}
@@ -17,6 +17,7 @@
 #include <memory>
 #include <vector>
 
+#include "latency-statistics.hpp"
 #include "top.hpp"
 #include "scenario-context.hpp"
 
@@ -27,14 +28,37 @@ typedef int SCENARIO_CLASS;
 #define SCENARIO_CLASS__MILENAGE_AUTHENTICATION 1
 #define SCENARIO_CLASS__TUAK_AUTHENTICATION 2
 #define SCENARIO_CLASS__SUCI_DECONCEALMENT 3
+#define SCENARIO_CLASS__MILENAGE_RESYNCHRONIZATION 4
+#define SCENARIO_CLASS__TUAK_RESYNCHRONIZATION 5
+#define SCENARIO_CLASS__MILENAGE_5G_AKA 6
+#define SCENARIO_CLASS__TUAK_5G_AKA 7
+#define SCENARIO_CLASS__MILENAGE_EAP_AKA_PRIME 8
+#define SCENARIO_CLASS__TUAK_EAP_AKA_PRIME 9
+#define SCENARIO_CLASS__MILENAGE_SOFTWARE 10
+#define SCENARIO_CLASS__TUAK_SOFTWARE 11
 
 #define SCENARIO__ERROR_CODE__NO_ERROR 0
 #define SCENARIO__ERROR_CODE__UNKNOWN_SCENARIO_CLASS -1
 #define SCENARIO__ERROR_CODE__INCONSISTENT_SCENARIO_FLAGS -2
 #define SCENARIO__ERROR_CODE__INVALID_TESTS_COUNT -3
 
+class OutputVerifier;
 class Test;
 
+// Request among the slowest ones (see ScenarioContext::slowestRequestsCount).
+typedef struct
+{
+    unsigned long testIdentifier;
+    unsigned long long beginEpochMilliSeconds;
+    unsigned long microSeconds;
+    bool isFailed;
+} SLOW_REQUEST;
+
+// Orders the slow requests from the slowest one, e.g. for std::sort(), or
+// for std::push_heap() so that the fastest one is first.
+bool isSlowerRequest(const SLOW_REQUEST &left,
+                     const SLOW_REQUEST &right);
+
 /*
  * A scenario must be instanciated before to be used. A scenario can be instanciated several times.
  *
@@ -107,8 +131,24 @@ protected:
     unsigned long maxTestTps = 0L;
     unsigned long meanTestTps = 0L;
 
+    // Latencies of the successful requests, merged once the tests are
+    // stopped.
+    LatencyStatistics requestsStatistics = {};
+
+    // Only used by scenarii running requests made of several stages: the
+    // stages latencies of the tests are merged once the tests are stopped.
+    std::vector<std::string> stagesNames = {};
+    std::vector<LatencyStatistics> stagesStatistics = {};
+
+    // Slowest requests of the tests, merged once the tests are stopped.
+    std::vector<SLOW_REQUEST> slowestRequests = {};
+
     CK_SESSION_HANDLE sessionHandle = CK_INVALID_HANDLE;
 
+    // Only used when a ratio of the outputs is verified, and supported by
+    // the scenario.
+    std::shared_ptr<OutputVerifier> pOutputVerifier = nullptr;
+
     Scenario(const ScenarioContext &scenarioContext,
              const SCENARIO_FLAGS flags,
              const SCENARIO_IDENTIFIER identifier,
@@ -129,6 +169,11 @@ protected:
 
     virtual CK_RV setScenarioData();
 
+    // Checks the software computation of the outputs against known answers
+    // before to verify any output. Returns CKR_FUNCTION_NOT_SUPPORTED if the
+    // outputs of the scenario cannot be verified.
+    virtual CK_RV checkVerificationKnownAnswers() const;
+
     virtual CK_RV prepareScenario();
     virtual CK_RV prepareTests();
 
@@ -190,15 +235,50 @@ public:
 
     virtual unsigned long getRequestsCount() const;
     virtual unsigned long getErrorsCount() const;
+    virtual const LatencyStatistics &getRequestsStatistics() const;
+
+    // Slowest first, the tests being stopped.
+    virtual const std::vector<SLOW_REQUEST> &getSlowestRequests() const;
+
+    // Sums the counters and merges the latencies of the tests while they
+    // run, from the copies they publish (i.e. lagging by up to 100 ms).
+    virtual void getLiveStatistics(unsigned long &liveRequestsCount,
+                                   unsigned long &liveErrorsCount,
+                                   LatencyStatistics &liveRequestsStatistics) const;
 
     virtual unsigned long getMinTestTps() const;
     virtual unsigned long getMaxTestTps() const;
     virtual unsigned long getMeanTestTps() const;
 
+    // Context of the PKCS#11 calls made for the scenario, when profiled.
+    virtual unsigned long getProfilingContext() const;
+
+    // Bytes of the state of the tests (see Test::getStateBytes()).
+    virtual size_t getTestsStateBytes() const;
+
     virtual unsigned long getTps() const;
 
+    // Counts of the sampled outputs verified, and of the mismatching ones.
+    virtual unsigned long getVerifiedOutputsCount() const;
+    virtual unsigned long getMismatchingOutputsCount() const;
+
+    // Name of the algorithm recomputed by verifyOutput(), under which the
+    // mismatches are totaled (empty by default).
+    virtual std::string getVerifiedAlgorithm() const;
+
+    // Called by the tests with their successful outputs, a ratio of them
+    // (see ScenarioContext::verificationRatio) being sampled.
+    virtual void submitOutput(const CK_BYTE *const output,
+                              const CK_ULONG outputLength) const;
+
+    // Recomputes an output in software. Called by the verifier thread,
+    // hence must not update the scenario.
+    virtual bool verifyOutput(const CK_BYTE *const output,
+                              const CK_ULONG outputLength) const;
+
     void writeDebugInformation() const override;
     void writeInformation(const char *const message) const override;
+    virtual void writeStatistics() const;
 };
 
 #endif /* SCENARIO_HPP */
\ No newline at end of file
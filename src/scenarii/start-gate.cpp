@@ -0,0 +1,59 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include "start-gate.hpp"
+
+StartGate::StartGate() : Top("Start Gate")
+{
+    // Nothing else to do here.
+}
+
+StartGate::~StartGate()
+{
+    pthread_cond_destroy(&condition);
+    pthread_mutex_destroy(&mutex);
+}
+
+std::chrono::high_resolution_clock::time_point StartGate::getOpeningTime() const
+{
+    return openingTime;
+}
+
+void StartGate::open()
+{
+    pthread_mutex_lock(&mutex);
+
+    if (!isOpened)
+    {
+        openingTime = std::chrono::high_resolution_clock::now();
+        isOpened = true;
+
+        pthread_cond_broadcast(&condition);
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+std::chrono::high_resolution_clock::time_point StartGate::wait()
+{
+    pthread_mutex_lock(&mutex);
+
+    while (!isOpened)
+    {
+        pthread_cond_wait(&condition,
+                          &mutex);
+    }
+
+    const auto time = openingTime;
+
+    pthread_mutex_unlock(&mutex);
+
+    return time;
+}
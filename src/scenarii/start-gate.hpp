@@ -0,0 +1,52 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef START_GATE_HPP
+#define START_GATE_HPP
+
+#include <chrono>
+#include <pthread.h>
+
+#include "top.hpp"
+
+/*
+ * Gate on which the threads of the tests are parked once started, until
+ * opened for all of them at once (e.g. at the time given by '--start-at').
+ *
+ * Notes:
+ *   - The tests are accounted from the opening time, rather than from the
+ *     start of their own thread.
+ */
+class StartGate : public Top
+{
+protected:
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t condition = PTHREAD_COND_INITIALIZER;
+    bool isOpened = false;
+
+    std::chrono::high_resolution_clock::time_point openingTime = std::chrono::high_resolution_clock::now();
+
+public:
+    StartGate();
+    ~StartGate() override;
+
+    StartGate(const StartGate &) = delete;
+    StartGate &operator=(const StartGate &) = delete;
+
+    // Note: only meaningful once opened.
+    virtual std::chrono::high_resolution_clock::time_point getOpeningTime() const;
+
+    virtual void open();
+
+    // Returns the opening time.
+    virtual std::chrono::high_resolution_clock::time_point wait();
+};
+
+#endif /* START_GATE_HPP */
@@ -9,17 +9,50 @@
 *
 \****************************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <sched.h>
 #include <unistd.h>
 
 #include "test.hpp"
 
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+#include <toolkits/profiling-toolkit.h>
+}
+
+// Period of the publication of the live statistics by a test (i.e. their
+// maximum lag, the publications of the scenarii being every second).
+#define TEST__LIVE_STATISTICS_PUBLICATION_PERIOD_MS 100
+
 void *runTestInThread(void *arg)
 {
     assert(arg != nullptr);
 
-    pthread_exit((void *)(((Test *)arg)->run()));
+    proftk_setContext(((Test *)arg)->scenario.getProfilingContext());
+
+    const CK_RV rv = ((Test *)arg)->applyThreadLayout();
+
+    ((Test *)arg)->waitForStartGate();
+
+    if (rv != CKR_OK)
+    {
+        return (void *)rv;
+    }
+
+    ((Test *)arg)->setCallsTracking(true);
+
+    const CK_RV runRv = ((Test *)arg)->run();
+
+    // The live statistics end up equal to the final ones.
+    ((Test *)arg)->publishLiveStatistics();
+
+    // Note: the thread belongs to the pool of the tests (see ThreadPool).
+    ((Test *)arg)->setCallsTracking(false);
+
+    return (void *)runRv;
 }
 
 Test::Test(const Scenario &_scenario,
@@ -50,16 +83,120 @@ Test::~Test()
     }
 }
 
+CK_RV Test::applyThreadLayout()
+{
+    assert(state == TEST_STATE::Started);
+
+    return scenario.scenarioContext.pThreadLayout->applyToTestThread(layoutIndex);
+}
+
+void Test::beginRequest()
+{
+    requestsCount++;
+
+    requestBeginErrorsCount = errorsCount;
+    requestBeginTime = std::chrono::high_resolution_clock::now();
+
+    if ((requestBeginTime - publicationTime) >= std::chrono::milliseconds(TEST__LIVE_STATISTICS_PUBLICATION_PERIOD_MS))
+    {
+        publishLiveStatistics();
+    }
+}
+
+void Test::endRequest()
+{
+    const bool isFailed = (errorsCount != requestBeginErrorsCount);
+
+    if (isFailed &&
+        (scenario.scenarioContext.slowestRequestsCount == 0))
+    {
+        return;
+    }
+
+    const unsigned long microSeconds = (unsigned long)(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - requestBeginTime).count());
+
+    if (!isFailed)
+    {
+        requestsStatistics.add(microSeconds);
+    }
+
+    // Note: the failed requests are kept as well, e.g. the ones timed out
+    // during a failover.
+    if (scenario.scenarioContext.slowestRequestsCount > 0)
+    {
+        recordSlowRequest(microSeconds,
+                          isFailed);
+    }
+}
+
 unsigned long Test::getErrorsCount() const
 {
     return errorsCount;
 }
 
+void Test::getLiveStatistics(unsigned long &liveRequestsCount,
+                             unsigned long &liveErrorsCount,
+                             LATENCY_STATISTICS_SNAPSHOT &liveRequestsStatistics) const
+{
+    assert(&liveRequestsCount != nullptr);
+    assert(&liveErrorsCount != nullptr);
+    assert(&liveRequestsStatistics != nullptr);
+
+    // Note: the publisher is a thread of this process, that completes its
+    // publication once scheduled.
+    for (;;)
+    {
+        const unsigned long sequence = __atomic_load_n(&publicationSequence,
+                                                       __ATOMIC_ACQUIRE);
+
+        if ((sequence % 2) != 0)
+        {
+            sched_yield();
+
+            continue;
+        }
+
+        liveRequestsCount = publishedRequestsCount;
+        liveErrorsCount = publishedErrorsCount;
+        liveRequestsStatistics = publishedRequestsStatistics;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&publicationSequence,
+                            __ATOMIC_RELAXED) == sequence)
+        {
+            return;
+        }
+    }
+}
+
 unsigned long Test::getRequestsCount() const
 {
     return requestsCount;
 }
 
+const LatencyStatistics &Test::getRequestsStatistics() const
+{
+    return requestsStatistics;
+}
+
+const std::vector<SLOW_REQUEST> &Test::getSlowestRequests() const
+{
+    return slowestRequests;
+}
+
+const std::vector<LatencyStatistics> &Test::getStagesStatistics() const
+{
+    return stagesStatistics;
+}
+
+size_t Test::getStateBytes() const
+{
+    return sizeof(Test) +
+           (stagesStatistics.capacity() * sizeof(LatencyStatistics)) +
+           (slowestRequests.capacity() * sizeof(SLOW_REQUEST));
+}
+
 TEST_STATE Test::getState() const
 {
     return state;
@@ -76,7 +213,7 @@ unsigned long Test::getTransactionsPerSecond() const
 
     assert(requestsCount >= errorsCount);
 
-    return (unsigned long)((requestsCount - errorsCount) / (elapsedMicroSeconds / 1000000L));
+    return (unsigned long)((double)(requestsCount - errorsCount) / ((double)elapsedMicroSeconds / 1000000.));
 }
 
 CK_RV Test::initialize()
@@ -129,6 +266,56 @@ EXIT:
     return rv;
 }
 
+void Test::publishLiveStatistics()
+{
+    __atomic_store_n(&publicationSequence,
+                     publicationSequence + 1,
+                     __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    publishedRequestsCount = requestsCount;
+    publishedErrorsCount = errorsCount;
+
+    requestsStatistics.getSnapshot(publishedRequestsStatistics);
+
+    __atomic_store_n(&publicationSequence,
+                     publicationSequence + 1,
+                     __ATOMIC_RELEASE);
+
+    publicationTime = std::chrono::high_resolution_clock::now();
+}
+
+void Test::recordSlowRequest(const unsigned long microSeconds,
+                             const bool isFailed)
+{
+    if ((slowestRequests.size() == scenario.scenarioContext.slowestRequestsCount) &&
+        (microSeconds <= slowestRequests.front().microSeconds))
+    {
+        return;
+    }
+
+    SLOW_REQUEST slowRequest = {};
+
+    slowRequest.testIdentifier = identifier;
+    slowRequest.beginEpochMilliSeconds = getEpochMilliSeconds() - (microSeconds / 1000L);
+    slowRequest.microSeconds = microSeconds;
+    slowRequest.isFailed = isFailed;
+
+    if (slowestRequests.size() == scenario.scenarioContext.slowestRequestsCount)
+    {
+        std::pop_heap(slowestRequests.begin(),
+                      slowestRequests.end(),
+                      &isSlowerRequest);
+        slowestRequests.pop_back();
+    }
+
+    slowestRequests.push_back(slowRequest);
+
+    std::push_heap(slowestRequests.begin(),
+                   slowestRequests.end(),
+                   &isSlowerRequest);
+}
+
 CK_RV Test::releaseUsedResources()
 {
     CK_RV rv = CKR_OK;
@@ -165,6 +352,35 @@ CK_RV Test::run()
     return CKR_OK;
 }
 
+void Test::sampleOutput(const CK_BYTE *const output,
+                        const CK_ULONG outputLength)
+{
+    if (scenario.scenarioContext.verificationRatio <= 0.0)
+    {
+        return;
+    }
+
+    verificationCredit += scenario.scenarioContext.verificationRatio;
+
+    if (verificationCredit < 1.0)
+    {
+        return;
+    }
+
+    verificationCredit -= 1.0;
+
+    scenario.submitOutput(output,
+                          outputLength);
+}
+
+void Test::setCallsTracking(const bool isTracking)
+{
+    if (pCallTracker != nullptr)
+    {
+        scenario.scenarioContext.pWatchdog->trackCurrentThread(isTracking ? pCallTracker : nullptr);
+    }
+}
+
 CK_RV Test::start()
 {
     assert(state == TEST_STATE::Initialized);
@@ -176,25 +392,42 @@ CK_RV Test::start()
     requestsCount = 0L;
     errorsCount = 0L;
 
+    requestsStatistics.reset();
+
+    for (auto &stageStatistics : stagesStatistics)
+    {
+        stageStatistics.reset();
+    }
+
+    slowestRequests.clear();
+    slowestRequests.reserve(scenario.scenarioContext.slowestRequestsCount);
+
+    // The thread of the test is not running yet.
+    publishLiveStatistics();
+
+    // Note: the tracker of the test is kept when it is started again.
+    if ((scenario.scenarioContext.pWatchdog != nullptr) &&
+        (pCallTracker == nullptr))
+    {
+        pCallTracker = scenario.scenarioContext.pWatchdog->createTracker(getUniqueString());
+    }
+
     terminationRequested = false;
 
     beginTime = std::chrono::high_resolution_clock::now();
 
+    layoutIndex = scenario.scenarioContext.pThreadLayout->reserveTestIndex();
+
     // Update the test state.
     // Note: the state must be updated before the thread starts.
     state = TEST_STATE::Started;
 
-    int threadCreationResult = -1;
+    rv = scenario.scenarioContext.pThreadPool->submit(&runTestInThread,
+                                                      this,
+                                                      workerIndex);
 
-    threadCreationResult = pthread_create(&threadIdentifier,
-                                          nullptr,
-                                          &runTestInThread,
-                                          this);
-
-    if (threadCreationResult != 0)
+    if (rv != CKR_OK)
     {
-        rv = CKR_GENERAL_ERROR;
-
         writeError("Cannot run the test in a separate thread.",
                    rv);
 
@@ -248,27 +481,21 @@ EXIT:
     return rv;
 }
 
-CK_RV Test::waitForStop()
+void Test::waitForStartGate()
 {
     assert(state == TEST_STATE::Started);
 
-    CK_RV rv = CKR_OK;
-
-    writeInformation("Wait for test termination...\n");
-
-    // Wait for the thread to stop.
-    int threadJoinResult = pthread_join(threadIdentifier,
-                                        nullptr);
+    beginTime = scenario.scenarioContext.pStartGate->wait();
+}
 
-    if (threadJoinResult != 0)
-    {
-        rv = CKR_GENERAL_ERROR;
+CK_RV Test::waitForStop()
+{
+    assert(state == TEST_STATE::Started);
 
-        writeError("Cannot wait for test termination.",
-                   rv);
+    writeInformation("Wait for test termination...\n");
 
-        goto EXIT;
-    }
+    // Wait for the thread to stop (its result being ignored).
+    scenario.scenarioContext.pThreadPool->wait(workerIndex);
 
     endTime = std::chrono::high_resolution_clock::now();
 
@@ -277,8 +504,7 @@ CK_RV Test::waitForStop()
     // Update the test state.
     state = TEST_STATE::Stopped;
 
-EXIT:
-    return rv;
+    return CKR_OK;
 }
 
 void Test::writeInformation(const char *const message) const
@@ -14,7 +14,9 @@
 
 #include <chrono>
 #include <pthread.h>
+#include <vector>
 
+#include "latency-statistics.hpp"
 #include "top.hpp"
 #include "scenario.hpp"
 
@@ -60,7 +62,14 @@ protected:
     CK_SESSION_HANDLE sessionHandle = CK_INVALID_HANDLE;
     CK_MECHANISM *pMechanism = nullptr;
 
-    pthread_t threadIdentifier = (pthread_t)0;
+    // Worker of the pool running the test (see ThreadPool).
+    size_t workerIndex = 0;
+
+    // Index of the test among all the ones started (see ThreadLayout).
+    size_t layoutIndex = 0;
+
+    // Calls of the thread of the test, if watched (see Watchdog).
+    PROFTK_CALL_TRACKER *pCallTracker = nullptr;
 
     std::chrono::high_resolution_clock::time_point beginTime = std::chrono::high_resolution_clock::now();
     std::chrono::high_resolution_clock::time_point endTime = beginTime;
@@ -68,6 +77,33 @@ protected:
     unsigned long requestsCount = 0L;
     unsigned long errorsCount = 0L;
 
+    // Latencies of the successful requests.
+    LatencyStatistics requestsStatistics = {};
+    std::chrono::high_resolution_clock::time_point requestBeginTime = beginTime;
+    unsigned long requestBeginErrorsCount = 0L;
+
+    // Live copy of the counters and latencies, published by the thread of
+    // the test for the other threads (see getLiveStatistics()) without lock:
+    // the sequence is odd while it is written, the readers trying again if
+    // it is odd or changed during their copy.
+    unsigned long publicationSequence = 0L;
+    unsigned long publishedRequestsCount = 0L;
+    unsigned long publishedErrorsCount = 0L;
+    LATENCY_STATISTICS_SNAPSHOT publishedRequestsStatistics = {};
+    std::chrono::high_resolution_clock::time_point publicationTime = beginTime;
+
+    // Only used by tests running requests made of several stages (one entry
+    // per stage, as named by the scenario).
+    std::vector<LatencyStatistics> stagesStatistics = {};
+
+    // Heap of the slowest requests, the fastest of them first (see
+    // isSlowerRequest()).
+    std::vector<SLOW_REQUEST> slowestRequests = {};
+
+    // Accumulates the verification ratio: an output is sampled each time it
+    // reaches 1.
+    double verificationCredit = 0.0;
+
     bool terminationRequested = false;
 
     Test(const Scenario &scenario,
@@ -77,6 +113,21 @@ protected:
     // Resources release operations can occur in any state.
     virtual CK_RV releaseUsedResources();
 
+    // Accounts for a new request; its latency is recorded by 'endRequest'
+    // unless an error was counted in between. The live copy of the
+    // statistics is published periodically here.
+    virtual void beginRequest();
+    virtual void endRequest();
+
+    // Keeps a request if among the slowest ones of the test.
+    virtual void recordSlowRequest(const unsigned long microSeconds,
+                                   const bool isFailed);
+
+    // Submits a successful output to the verifier of the scenario, if
+    // sampled.
+    virtual void sampleOutput(const CK_BYTE *const output,
+                              const CK_ULONG outputLength);
+
 public:
     const Scenario &scenario;
     const TEST_IDENTIFIER identifier;
@@ -89,6 +140,22 @@ public:
 
     virtual CK_RV run();
 
+    // Places the thread of the test on its CPU, with its scheduling policy
+    // (see ThreadLayout).
+    virtual CK_RV applyThreadLayout();
+
+    // Parks the thread of the test until the start gate of the scenarii is
+    // opened (see StartGate).
+    virtual void waitForStartGate();
+
+    // Starts or stops the tracking of the calls of the thread of the test by
+    // the watchdog, if any.
+    virtual void setCallsTracking(const bool isTracking);
+
+    // Publishes the live copy of the statistics; only called by the thread
+    // running the test, or before it is started.
+    virtual void publishLiveStatistics();
+
     virtual TEST_STATE getState() const;
 
     virtual CK_RV prepare();
@@ -99,7 +166,22 @@ public:
     virtual CK_RV terminate();
 
     virtual unsigned long getErrorsCount() const;
+
+    // Consistent copy of the last published statistics, that can be read by
+    // any thread while the test runs.
+    virtual void getLiveStatistics(unsigned long &liveRequestsCount,
+                                   unsigned long &liveErrorsCount,
+                                   LATENCY_STATISTICS_SNAPSHOT &liveRequestsStatistics) const;
+
     virtual unsigned long getRequestsCount() const;
+    virtual const LatencyStatistics &getRequestsStatistics() const;
+    virtual const std::vector<SLOW_REQUEST> &getSlowestRequests() const;
+    virtual const std::vector<LatencyStatistics> &getStagesStatistics() const;
+
+    // Bytes of the state kept by the test object: its counters, latency
+    // histogram and live copy, plus the stages and slowest requests, if any.
+    virtual size_t getStateBytes() const;
+
     virtual unsigned long getTransactionsPerSecond() const;
 
     void writeInformation(const char *const message) const override;
@@ -0,0 +1,582 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <tuple>
+#include <unistd.h>
+
+#include "thread-layout.hpp"
+
+#define THREAD_LAYOUT__CPU_DIRECTORY "/sys/devices/system/cpu/cpu"
+#define THREAD_LAYOUT__NODE_DIRECTORY "/sys/devices/system/node/node"
+
+// Returns -1 if the file cannot be read (e.g. no topology exposed).
+static long readNumber(const std::string &path)
+{
+    std::ifstream file(path);
+    long number = -1L;
+
+    if (!(file >> number))
+    {
+        return -1L;
+    }
+
+    return number;
+}
+
+ThreadLayout::ThreadLayout() : Top("Thread Layout")
+{
+    // Nothing else to do here.
+}
+
+ThreadLayout::~ThreadLayout()
+{
+    // Nothing else to do here.
+}
+
+CK_RV ThreadLayout::applyToHousekeepingThread() const
+{
+    if (housekeepingCpus.empty())
+    {
+        return CKR_OK;
+    }
+
+    return setAffinity(housekeepingCpus);
+}
+
+CK_RV ThreadLayout::applyToTestThread(const size_t testIndex) const
+{
+    CK_RV rv = CKR_OK;
+
+    // The tests are inheriting the affinity of the main thread otherwise.
+    if (isPinning)
+    {
+        rv = setAffinity({getTestCpu(testIndex)});
+    }
+    else if (!housekeepingCpus.empty())
+    {
+        rv = setAffinity(testsCpus);
+    }
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (isFifo)
+    {
+        struct sched_param schedulingParameters = {};
+
+        schedulingParameters.sched_priority = fifoPriority;
+
+        if (pthread_setschedparam(pthread_self(),
+                                  SCHED_FIFO,
+                                  &schedulingParameters) != 0)
+        {
+            rv = CKR_GENERAL_ERROR;
+
+            writeError("Cannot use the SCHED_FIFO policy (e.g. missing CAP_SYS_NICE).",
+                       rv);
+
+            goto EXIT;
+        }
+    }
+
+    // Note: the nice level is the one of the thread on Linux.
+    if (isNice &&
+        (setpriority(PRIO_PROCESS,
+                     (id_t)syscall(SYS_gettid),
+                     niceLevel) != 0))
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot set the nice level (e.g. missing CAP_SYS_NICE).",
+                   rv);
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV ThreadLayout::configure(const std::string &_affinityDescription,
+                              const std::string &_housekeepingCpusDescription,
+                              const std::string &_schedulingDescription)
+{
+    CK_RV rv = CKR_OK;
+    std::vector<int> allowedCpus = {};
+
+    if (!getAllowedCpus(allowedCpus))
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot get the CPUs allowed to the process.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    if (!_housekeepingCpusDescription.empty())
+    {
+        if (!parseCpuList(_housekeepingCpusDescription,
+                          housekeepingCpus))
+        {
+            fprintf(stderr,
+                    "Invalid housekeeping CPUs: '%s'.\n",
+                    _housekeepingCpusDescription.c_str());
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        housekeepingCpusDescription = _housekeepingCpusDescription;
+    }
+
+    for (const int cpu : housekeepingCpus)
+    {
+        if (std::find(allowedCpus.begin(),
+                      allowedCpus.end(),
+                      cpu) == allowedCpus.end())
+        {
+            fprintf(stderr,
+                    "The housekeeping CPU %d is not allowed to the process.\n",
+                    cpu);
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        allowedCpus.erase(std::find(allowedCpus.begin(),
+                                    allowedCpus.end(),
+                                    cpu));
+    }
+
+    if (allowedCpus.empty())
+    {
+        fprintf(stderr,
+                "No CPU is left to the tests besides the housekeeping ones.\n");
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    testsCpus = allowedCpus;
+
+    if (_affinityDescription.empty())
+    {
+        // Not pinned, but kept off the housekeeping CPUs (if any).
+    }
+    else if ((_affinityDescription == "compact") ||
+             (_affinityDescription == "scatter"))
+    {
+        sortCpus(_affinityDescription == "scatter",
+                 testsCpus);
+
+        isPinning = true;
+    }
+    else if (_affinityDescription.compare(0,
+                                          5,
+                                          "numa:") == 0)
+    {
+        std::vector<int> nodes = {};
+
+        testsCpus.clear();
+
+        if (!parseCpuList(_affinityDescription.substr(5),
+                          nodes))
+        {
+            fprintf(stderr,
+                    "Invalid NUMA nodes: '%s'.\n",
+                    _affinityDescription.c_str());
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        for (const int node : nodes)
+        {
+            std::ifstream file(std::string(THREAD_LAYOUT__NODE_DIRECTORY) + std::to_string(node) + "/cpulist");
+            std::string nodeCpusDescription = {};
+            std::vector<int> nodeCpus = {};
+
+            if ((!std::getline(file,
+                               nodeCpusDescription)) ||
+                (!parseCpuList(nodeCpusDescription,
+                               nodeCpus)))
+            {
+                fprintf(stderr,
+                        "Cannot get the CPUs of the NUMA node %d.\n",
+                        node);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+
+            for (const int cpu : nodeCpus)
+            {
+                if (std::find(allowedCpus.begin(),
+                              allowedCpus.end(),
+                              cpu) != allowedCpus.end())
+                {
+                    testsCpus.push_back(cpu);
+                }
+            }
+        }
+
+        if (testsCpus.empty())
+        {
+            fprintf(stderr,
+                    "No CPU of the NUMA nodes '%s' is left to the tests.\n",
+                    _affinityDescription.substr(5).c_str());
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        sortCpus(false,
+                 testsCpus);
+
+        isPinning = true;
+    }
+    else
+    {
+        // Explicit list, used in its order.
+        if (!parseCpuList(_affinityDescription,
+                          testsCpus))
+        {
+            fprintf(stderr,
+                    "Invalid affinity: '%s'.\n",
+                    _affinityDescription.c_str());
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        for (const int cpu : testsCpus)
+        {
+            if (std::find(allowedCpus.begin(),
+                          allowedCpus.end(),
+                          cpu) == allowedCpus.end())
+            {
+                fprintf(stderr,
+                        "The CPU %d is not left to the tests.\n",
+                        cpu);
+
+                rv = CKR_GENERAL_ERROR;
+
+                goto EXIT;
+            }
+        }
+
+        isPinning = true;
+    }
+
+    if (!_affinityDescription.empty())
+    {
+        affinityDescription = _affinityDescription;
+    }
+
+    if (_schedulingDescription.empty())
+    {
+        // Keep the default policy.
+    }
+    else if (_schedulingDescription.compare(0,
+                                            5,
+                                            "fifo:") == 0)
+    {
+        fifoPriority = atoi(_schedulingDescription.c_str() + 5);
+
+        if ((fifoPriority < sched_get_priority_min(SCHED_FIFO)) ||
+            (fifoPriority > sched_get_priority_max(SCHED_FIFO)))
+        {
+            fprintf(stderr,
+                    "Invalid SCHED_FIFO priority: '%s'.\n",
+                    _schedulingDescription.c_str());
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        isFifo = true;
+    }
+    else if (_schedulingDescription.compare(0,
+                                            5,
+                                            "nice:") == 0)
+    {
+        niceLevel = atoi(_schedulingDescription.c_str() + 5);
+
+        if ((niceLevel < -20) ||
+            (niceLevel > 19))
+        {
+            fprintf(stderr,
+                    "Invalid nice level: '%s'.\n",
+                    _schedulingDescription.c_str());
+
+            rv = CKR_GENERAL_ERROR;
+
+            goto EXIT;
+        }
+
+        isNice = true;
+    }
+    else
+    {
+        fprintf(stderr,
+                "Invalid scheduling: '%s'.\n",
+                _schedulingDescription.c_str());
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    schedulingDescription = _schedulingDescription;
+
+EXIT:
+    return rv;
+}
+
+const std::string &ThreadLayout::getAffinityDescription() const
+{
+    return affinityDescription;
+}
+
+bool ThreadLayout::getAllowedCpus(std::vector<int> &cpus)
+{
+    cpu_set_t cpuSet;
+
+    CPU_ZERO(&cpuSet);
+
+    if (sched_getaffinity(0,
+                          sizeof(cpuSet),
+                          &cpuSet) != 0)
+    {
+        return false;
+    }
+
+    cpus.clear();
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu,
+                      &cpuSet))
+        {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return !cpus.empty();
+}
+
+const std::string &ThreadLayout::getHousekeepingCpusDescription() const
+{
+    return housekeepingCpusDescription;
+}
+
+const std::string &ThreadLayout::getSchedulingDescription() const
+{
+    return schedulingDescription;
+}
+
+int ThreadLayout::getTestCpu(const size_t testIndex) const
+{
+    if (!isPinning)
+    {
+        return -1;
+    }
+
+    return testsCpus[testIndex % testsCpus.size()];
+}
+
+std::string ThreadLayout::getTestsCpusDescription(const size_t firstTestIndex,
+                                                  const size_t testsCount) const
+{
+    std::string description = {};
+
+    if (!isPinning)
+    {
+        return description;
+    }
+
+    for (size_t testIndex = firstTestIndex; testIndex < (firstTestIndex + testsCount); testIndex++)
+    {
+        if (!description.empty())
+        {
+            description += ",";
+        }
+
+        description += std::to_string(getTestCpu(testIndex));
+    }
+
+    return description;
+}
+
+bool ThreadLayout::parseCpuList(const std::string &description,
+                                std::vector<int> &cpus)
+{
+    size_t offset = 0;
+
+    cpus.clear();
+
+    while (offset < description.size())
+    {
+        const size_t separatorOffset = std::min(description.find(',', offset),
+                                                description.size());
+        const std::string range = description.substr(offset,
+                                                     separatorOffset - offset);
+        char *pEnd = nullptr;
+        const long first = strtol(range.c_str(),
+                                  &pEnd,
+                                  10);
+        long last = first;
+
+        if (pEnd == range.c_str())
+        {
+            return false;
+        }
+
+        if (*pEnd == '-')
+        {
+            const char *const pLast = pEnd + 1;
+
+            last = strtol(pLast,
+                          &pEnd,
+                          10);
+
+            if (pEnd == pLast)
+            {
+                return false;
+            }
+        }
+
+        if ((*pEnd != '\0') ||
+            (first < 0) ||
+            (last < first) ||
+            (last >= CPU_SETSIZE))
+        {
+            return false;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++)
+        {
+            cpus.push_back((int)cpu);
+        }
+
+        offset = separatorOffset + 1;
+    }
+
+    return !cpus.empty();
+}
+
+size_t ThreadLayout::reserveTestIndex()
+{
+    return nextTestIndex++;
+}
+
+CK_RV ThreadLayout::setAffinity(const std::vector<int> &cpus)
+{
+    CK_RV rv = CKR_OK;
+    cpu_set_t cpuSet;
+
+    CPU_ZERO(&cpuSet);
+
+    for (const int cpu : cpus)
+    {
+        CPU_SET(cpu,
+                &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(pthread_self(),
+                               sizeof(cpuSet),
+                               &cpuSet) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        fprintf(stderr,
+                "Cannot set the CPU affinity of a thread.\n");
+    }
+
+    return rv;
+}
+
+void ThreadLayout::setNextTestIndex(const size_t testIndex)
+{
+    nextTestIndex = testIndex;
+}
+
+void ThreadLayout::sortCpus(const bool isScattering,
+                            std::vector<int> &cpus)
+{
+    // Package, core and hardware thread ranks of each CPU.
+    std::map<int, std::tuple<long, size_t, size_t>> cpusRanks = {};
+    std::map<long, std::vector<long>> packagesCores = {};
+    std::map<std::pair<long, long>, size_t> coresThreadsCounts = {};
+
+    for (const int cpu : cpus)
+    {
+        const std::string topologyPath = std::string(THREAD_LAYOUT__CPU_DIRECTORY) + std::to_string(cpu) + "/topology/";
+        const long package = readNumber(topologyPath + "physical_package_id");
+        const long core = readNumber(topologyPath + "core_id");
+        std::vector<long> &packageCores = packagesCores[package];
+
+        // Without topology, each CPU is taken as a core of its own.
+        const long coreKey = (core == -1L) ? (long)cpu : core;
+
+        if (std::find(packageCores.begin(),
+                      packageCores.end(),
+                      coreKey) == packageCores.end())
+        {
+            packageCores.push_back(coreKey);
+        }
+
+        const size_t coreRank = (size_t)(std::find(packageCores.begin(),
+                                                   packageCores.end(),
+                                                   coreKey) -
+                                         packageCores.begin());
+        const size_t threadRank = coresThreadsCounts[std::make_pair(package, coreKey)]++;
+
+        cpusRanks[cpu] = std::make_tuple(package,
+                                         coreRank,
+                                         threadRank);
+    }
+
+    std::stable_sort(cpus.begin(),
+                     cpus.end(),
+                     [&cpusRanks, isScattering](const int cpu1, const int cpu2)
+                     {
+                         const auto &ranks1 = cpusRanks[cpu1];
+                         const auto &ranks2 = cpusRanks[cpu2];
+
+                         if (isScattering)
+                         {
+                             return std::make_tuple(std::get<2>(ranks1), std::get<1>(ranks1), std::get<0>(ranks1)) <
+                                    std::make_tuple(std::get<2>(ranks2), std::get<1>(ranks2), std::get<0>(ranks2));
+                         }
+
+                         return ranks1 < ranks2;
+                     });
+}
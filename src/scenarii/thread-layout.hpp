@@ -0,0 +1,109 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef THREAD_LAYOUT_HPP
+#define THREAD_LAYOUT_HPP
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+#include "top.hpp"
+
+/*
+ * Placement of the threads of the tests on the CPUs of the host (see
+ * '--affinity', '--housekeeping' and '--scheduling').
+ *
+ * Notes:
+ *   - The tests are given their index when started, i.e. in the order of
+ *     the scenarii then of their tests, the n-th one running on the n-th
+ *     CPU of the layout (modulo its CPUs count).
+ *   - The housekeeping CPUs run the main thread, the verifiers and the
+ *     threads of the client library (all inheriting the affinity of the
+ *     main thread), and are not given to the tests.
+ *   - The scheduling policy (SCHED_FIFO or a nice level) only applies to
+ *     the threads of the tests.
+ */
+class ThreadLayout : public Top
+{
+protected:
+    // As given on the command line, e.g. 'compact' or 'fifo:10'.
+    std::string affinityDescription = "none";
+    std::string housekeepingCpusDescription = {};
+    std::string schedulingDescription = {};
+
+    // CPUs of the tests, in their order of use (all the allowed ones but
+    // the housekeeping ones if not pinned).
+    bool isPinning = false;
+    std::vector<int> testsCpus = {};
+    std::vector<int> housekeepingCpus = {};
+
+    bool isFifo = false;
+    int fifoPriority = 0;
+    bool isNice = false;
+    int niceLevel = 0;
+
+    size_t nextTestIndex = 0;
+
+    static bool getAllowedCpus(std::vector<int> &cpus);
+
+    // Sorts the CPUs by package, then core, then hardware thread ('compact'),
+    // or by hardware thread, then core, then package ('scatter').
+    static void sortCpus(const bool isScattering,
+                         std::vector<int> &cpus);
+
+    static CK_RV setAffinity(const std::vector<int> &cpus);
+
+public:
+    ThreadLayout();
+    ~ThreadLayout() override;
+
+    ThreadLayout(const ThreadLayout &) = delete;
+    ThreadLayout &operator=(const ThreadLayout &) = delete;
+
+    // Returns the CPUs of a list such as '0-3,8', or false if invalid.
+    static bool parseCpuList(const std::string &description,
+                             std::vector<int> &cpus);
+
+    // Pins the calling (i.e. main) thread on the housekeeping CPUs, if any.
+    virtual CK_RV applyToHousekeepingThread() const;
+
+    // Places the calling thread, the one of the test given the index.
+    virtual CK_RV applyToTestThread(const size_t testIndex) const;
+
+    // The affinity is 'compact', 'scatter', 'numa:<nodes>' or a list of
+    // CPUs, and the scheduling 'fifo:<priority>' or 'nice:<level>'; the
+    // empty descriptions are keeping the defaults.
+    virtual CK_RV configure(const std::string &affinityDescription,
+                            const std::string &housekeepingCpusDescription,
+                            const std::string &schedulingDescription);
+
+    virtual const std::string &getAffinityDescription() const;
+    virtual const std::string &getHousekeepingCpusDescription() const;
+    virtual const std::string &getSchedulingDescription() const;
+
+    // Returns the CPU of a test, -1 if not pinned.
+    virtual int getTestCpu(const size_t testIndex) const;
+
+    // Returns the CPUs of the tests given the indexes from the first one
+    // (e.g. '1,2,3'), empty if not pinned.
+    virtual std::string getTestsCpusDescription(const size_t firstTestIndex,
+                                                const size_t testsCount) const;
+
+    // Returns the index of the next test started.
+    virtual size_t reserveTestIndex();
+
+    // E.g. for the workers of '--processes', so that they are not given the
+    // same CPUs.
+    virtual void setNextTestIndex(const size_t testIndex);
+};
+
+#endif /* THREAD_LAYOUT_HPP */
@@ -0,0 +1,276 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cerrno>
+
+#include "thread-pool.hpp"
+
+void *runThreadPoolWorkerInThread(void *arg)
+{
+    assert(arg != nullptr);
+
+    THREAD_POOL_WORKER *const pWorker = (THREAD_POOL_WORKER *)arg;
+
+    pWorker->pThreadPool->run(*pWorker);
+
+    return nullptr;
+}
+
+ThreadPool::ThreadPool(const size_t _stackSize) : Top("Thread Pool"),
+                                                  stackSize(_stackSize)
+{
+    // Nothing else to do here.
+}
+
+ThreadPool::~ThreadPool()
+{
+    pthread_mutex_lock(&mutex);
+
+    terminationRequested = true;
+
+    for (THREAD_POOL_WORKER &worker : workers)
+    {
+        pthread_cond_signal(&worker.condition);
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    // Note: the workers still busy are waited for.
+    for (THREAD_POOL_WORKER &worker : workers)
+    {
+        pthread_join(worker.threadIdentifier,
+                     nullptr);
+        pthread_cond_destroy(&worker.condition);
+    }
+
+    pthread_cond_destroy(&doneCondition);
+    pthread_mutex_destroy(&mutex);
+}
+
+CK_RV ThreadPool::createWorker()
+{
+    CK_RV rv = CKR_OK;
+    pthread_attr_t threadAttributes;
+
+    pthread_attr_init(&threadAttributes);
+
+    if ((stackSize != 0) &&
+        (pthread_attr_setstacksize(&threadAttributes,
+                                   stackSize) != 0))
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        writeError("Invalid stack size for the threads of the tests.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    workers.push_back(THREAD_POOL_WORKER());
+
+    workers.back().pThreadPool = this;
+    workers.back().state = THREAD_POOL__STATE__IDLE;
+
+    pthread_cond_init(&workers.back().condition,
+                      nullptr);
+
+    if (pthread_create(&workers.back().threadIdentifier,
+                       &threadAttributes,
+                       &runThreadPoolWorkerInThread,
+                       &workers.back()) != 0)
+    {
+        pthread_cond_destroy(&workers.back().condition);
+        workers.pop_back();
+
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot create a thread for the tests.",
+                   rv);
+    }
+
+EXIT:
+    pthread_attr_destroy(&threadAttributes);
+
+    return rv;
+}
+
+size_t ThreadPool::getWorkersCount()
+{
+    pthread_mutex_lock(&mutex);
+
+    const size_t workersCount = workers.size();
+
+    pthread_mutex_unlock(&mutex);
+
+    return workersCount;
+}
+
+CK_RV ThreadPool::reserve(const size_t idleWorkersCount)
+{
+    CK_RV rv = CKR_OK;
+    size_t currentIdleWorkersCount = 0;
+
+    pthread_mutex_lock(&mutex);
+
+    for (const THREAD_POOL_WORKER &worker : workers)
+    {
+        if (worker.state == THREAD_POOL__STATE__IDLE)
+        {
+            currentIdleWorkersCount++;
+        }
+    }
+
+    for (; (rv == CKR_OK) && (currentIdleWorkersCount < idleWorkersCount); currentIdleWorkersCount++)
+    {
+        rv = createWorker();
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    return rv;
+}
+
+void ThreadPool::run(THREAD_POOL_WORKER &worker)
+{
+    pthread_mutex_lock(&mutex);
+
+    while (true)
+    {
+        while ((worker.state != THREAD_POOL__STATE__ASSIGNED) &&
+               (!terminationRequested))
+        {
+            pthread_cond_wait(&worker.condition,
+                              &mutex);
+        }
+
+        if (worker.state != THREAD_POOL__STATE__ASSIGNED)
+        {
+            break;
+        }
+
+        pthread_mutex_unlock(&mutex);
+
+        void *const result = worker.function(worker.argument);
+
+        pthread_mutex_lock(&mutex);
+
+        worker.result = result;
+        worker.state = THREAD_POOL__STATE__DONE;
+
+        pthread_cond_broadcast(&doneCondition);
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+CK_RV ThreadPool::submit(const THREAD_POOL_FUNCTION function,
+                         void *const argument,
+                         size_t &workerIndex)
+{
+    assert(function != nullptr);
+    assert(&workerIndex != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    pthread_mutex_lock(&mutex);
+
+    for (workerIndex = 0; workerIndex < workers.size(); workerIndex++)
+    {
+        if (workers[workerIndex].state == THREAD_POOL__STATE__IDLE)
+        {
+            break;
+        }
+    }
+
+    if (workerIndex == workers.size())
+    {
+        rv = createWorker();
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    workers[workerIndex].function = function;
+    workers[workerIndex].argument = argument;
+    workers[workerIndex].result = nullptr;
+    workers[workerIndex].state = THREAD_POOL__STATE__ASSIGNED;
+
+    pthread_cond_signal(&workers[workerIndex].condition);
+
+EXIT:
+    pthread_mutex_unlock(&mutex);
+
+    return rv;
+}
+
+void *ThreadPool::wait(const size_t workerIndex)
+{
+    pthread_mutex_lock(&mutex);
+
+    assert(workerIndex < workers.size());
+    assert(workers[workerIndex].state != THREAD_POOL__STATE__IDLE);
+
+    while (workers[workerIndex].state != THREAD_POOL__STATE__DONE)
+    {
+        pthread_cond_wait(&doneCondition,
+                          &mutex);
+    }
+
+    void *const result = workers[workerIndex].result;
+
+    workers[workerIndex].state = THREAD_POOL__STATE__IDLE;
+
+    pthread_mutex_unlock(&mutex);
+
+    return result;
+}
+
+bool ThreadPool::waitForCompletion(const unsigned long long epochMilliSeconds)
+{
+    struct timespec instant = {};
+    bool isCompleted = false;
+
+    instant.tv_sec = (time_t)(epochMilliSeconds / 1000ULL);
+    instant.tv_nsec = (long)((epochMilliSeconds % 1000ULL) * 1000000ULL);
+
+    pthread_mutex_lock(&mutex);
+
+    while (true)
+    {
+        isCompleted = true;
+
+        for (const THREAD_POOL_WORKER &worker : workers)
+        {
+            if (worker.state == THREAD_POOL__STATE__ASSIGNED)
+            {
+                isCompleted = false;
+
+                break;
+            }
+        }
+
+        // Note: the condition uses the realtime clock, as the given time.
+        if (isCompleted ||
+            (pthread_cond_timedwait(&doneCondition,
+                                    &mutex,
+                                    &instant) == ETIMEDOUT))
+        {
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+
+    return isCompleted;
+}
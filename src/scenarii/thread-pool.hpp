@@ -0,0 +1,105 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <deque>
+#include <pthread.h>
+#include <time.h>
+
+#include "top.hpp"
+
+// States of a worker of the pool.
+#define THREAD_POOL__STATE__IDLE 0
+#define THREAD_POOL__STATE__ASSIGNED 1
+#define THREAD_POOL__STATE__DONE 2
+
+class ThreadPool;
+
+typedef void *(*THREAD_POOL_FUNCTION)(void *);
+
+typedef struct
+{
+    ThreadPool *pThreadPool;
+    pthread_t threadIdentifier;
+
+    // Signaled when a function is assigned to the worker.
+    pthread_cond_t condition;
+
+    int state;
+    THREAD_POOL_FUNCTION function;
+    void *argument;
+    void *result;
+} THREAD_POOL_WORKER;
+
+void *runThreadPoolWorkerInThread(void *arg);
+
+/*
+ * Pool of threads running the loops of the tests (see Test::start()), so
+ * that they are created once per process, with the given stack size, and
+ * parked between the runs of the tests rather than created and joined
+ * again.
+ *
+ * Notes:
+ *   - A worker is created when a function is submitted while all the other
+ *     ones are busy, or in advance (see reserve()).
+ *   - The functions must return rather than calling pthread_exit().
+ */
+class ThreadPool : public Top
+{
+protected:
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    // Broadcast when a worker is done with its function.
+    pthread_cond_t doneCondition = PTHREAD_COND_INITIALIZER;
+
+    bool terminationRequested = false;
+
+    // Note: the workers are not moved when the pool grows.
+    std::deque<THREAD_POOL_WORKER> workers = {};
+
+    // Creates an idle worker, the mutex being locked.
+    virtual CK_RV createWorker();
+
+public:
+    // In bytes, 0 for the default stack size of the threads.
+    const size_t stackSize;
+
+    explicit ThreadPool(const size_t stackSize);
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    virtual size_t getWorkersCount();
+
+    // Creates the workers so that at least as many are idle.
+    virtual CK_RV reserve(const size_t idleWorkersCount);
+
+    // Runs the functions assigned to a worker until terminated.
+    virtual void run(THREAD_POOL_WORKER &worker);
+
+    // Assigns a function to an idle worker, whose index is returned.
+    virtual CK_RV submit(const THREAD_POOL_FUNCTION function,
+                         void *const argument,
+                         size_t &workerIndex);
+
+    // Waits for the function assigned to a worker to return, and returns
+    // its result; the worker is idle again.
+    virtual void *wait(const size_t workerIndex);
+
+    // Waits until no worker runs a function any more, or until the given
+    // time (epoch, in milliseconds); returns false if some still run.
+    virtual bool waitForCompletion(const unsigned long long epochMilliSeconds);
+};
+
+#endif /* THREAD_POOL_HPP */
@@ -0,0 +1,302 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "watchdog.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+// Bounds of the period at which the calls in progress are checked (a
+// quarter of the stall threshold), in milli-seconds.
+#define WATCHDOG__MINIMUM_PERIOD 10ULL
+#define WATCHDOG__MAXIMUM_PERIOD 1000ULL
+
+void *runWatchdogInThread(void *arg)
+{
+    assert(arg != nullptr);
+
+    ((Watchdog *)arg)->run();
+
+    return nullptr;
+}
+
+Watchdog::Watchdog(const unsigned long long _stallMicroSeconds) : Top("Watchdog"),
+                                                                  stallMicroSeconds(_stallMicroSeconds)
+{
+    assert(_stallMicroSeconds > 0);
+
+    // Nothing else to do here.
+}
+
+Watchdog::~Watchdog()
+{
+    stop(); // Ignore the result code.
+
+    pthread_cond_destroy(&condition);
+    pthread_mutex_destroy(&mutex);
+}
+
+PROFTK_CALL_TRACKER *Watchdog::createTracker(const std::string &threadName)
+{
+    pthread_mutex_lock(&mutex);
+
+    trackers.push_back(WATCHDOG_TRACKER());
+
+    WATCHDOG_TRACKER &tracker = trackers.back();
+
+    tracker.callTracker.slowCallNanoSeconds = stallMicroSeconds * 1000ULL;
+    tracker.callTracker.slowCallCallback = &Watchdog::onSlowCall;
+    tracker.pWatchdog = this;
+
+    strncpy(tracker.threadName,
+            threadName.c_str(),
+            WATCHDOG__MAXIMUM_THREAD_NAME_LENGTH - 1);
+
+    pthread_mutex_unlock(&mutex);
+
+    return &tracker.callTracker;
+}
+
+WATCHDOG_STALL Watchdog::getStall(const WATCHDOG_TRACKER &tracker,
+                                  const char *const functionName,
+                                  const unsigned long long beginNanoSeconds,
+                                  const unsigned long long nanoSeconds)
+{
+    WATCHDOG_STALL stall = {};
+
+    memcpy(stall.threadName,
+           tracker.threadName,
+           WATCHDOG__MAXIMUM_THREAD_NAME_LENGTH);
+
+    stall.threadIdentifier = tracker.threadIdentifier;
+    stall.functionName = functionName;
+    stall.microSeconds = nanoSeconds / 1000ULL;
+
+    // The calls are timed with the monotonic clock.
+    stall.beginEpochMilliSeconds = getEpochMilliSeconds() -
+                                   ((proftk_getNanoSeconds() - beginNanoSeconds) / 1000000ULL);
+
+    return stall;
+}
+
+void Watchdog::getStalls(std::vector<WATCHDOG_STALL> &_stalls,
+                         unsigned long &_stallsCount)
+{
+    assert(&_stalls != nullptr);
+    assert(&_stallsCount != nullptr);
+
+    pthread_mutex_lock(&mutex);
+
+    _stalls = stalls;
+    _stallsCount = stallsCount;
+
+    pthread_mutex_unlock(&mutex);
+}
+
+void Watchdog::onSlowCall(PROFTK_CALL_TRACKER *const pCallTracker,
+                          const char *const functionName,
+                          const CK_RV rv,
+                          const unsigned long long beginNanoSeconds,
+                          const unsigned long long nanoSeconds)
+{
+    assert(pCallTracker != nullptr);
+
+    // Note: the call tracker is the first member of the tracker.
+    const WATCHDOG_TRACKER &tracker = *(const WATCHDOG_TRACKER *)pCallTracker;
+    Watchdog &watchdog = *tracker.pWatchdog;
+
+    WATCHDOG_STALL stall = getStall(tracker,
+                                    functionName,
+                                    beginNanoSeconds,
+                                    nanoSeconds);
+
+    stall.rv = rv;
+
+    pthread_mutex_lock(&watchdog.mutex);
+
+    if (watchdog.stalls.size() < WATCHDOG__MAXIMUM_STALLS_COUNT)
+    {
+        watchdog.stalls.push_back(stall);
+    }
+
+    watchdog.stallsCount++;
+
+    pthread_mutex_unlock(&watchdog.mutex);
+
+    writeStall(stall,
+               true);
+}
+
+void Watchdog::run()
+{
+    unsigned long long periodMilliSeconds = stallMicroSeconds / 4000ULL;
+
+    if (periodMilliSeconds < WATCHDOG__MINIMUM_PERIOD)
+    {
+        periodMilliSeconds = WATCHDOG__MINIMUM_PERIOD;
+    }
+    else if (periodMilliSeconds > WATCHDOG__MAXIMUM_PERIOD)
+    {
+        periodMilliSeconds = WATCHDOG__MAXIMUM_PERIOD;
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    while (!terminationRequested)
+    {
+        const unsigned long long epochMilliSeconds = getEpochMilliSeconds() + periodMilliSeconds;
+        struct timespec instant = {};
+
+        instant.tv_sec = (time_t)(epochMilliSeconds / 1000ULL);
+        instant.tv_nsec = (long)((epochMilliSeconds % 1000ULL) * 1000000ULL);
+
+        pthread_cond_timedwait(&condition,
+                               &mutex,
+                               &instant);
+
+        const unsigned long long nanoSeconds = proftk_getNanoSeconds();
+
+        for (WATCHDOG_TRACKER &tracker : trackers)
+        {
+            // Note: a call starting meanwhile is given a later begin time,
+            // hence is not mistaken for a stall.
+            const char *const functionName = __atomic_load_n(&tracker.callTracker.functionName,
+                                                             __ATOMIC_ACQUIRE);
+            const unsigned long long beginNanoSeconds = __atomic_load_n(&tracker.callTracker.beginNanoSeconds,
+                                                                        __ATOMIC_RELAXED);
+
+            if ((functionName == nullptr) ||
+                (beginNanoSeconds == tracker.reportedBeginNanoSeconds) ||
+                (nanoSeconds < (beginNanoSeconds + (stallMicroSeconds * 1000ULL))))
+            {
+                continue;
+            }
+
+            tracker.reportedBeginNanoSeconds = beginNanoSeconds;
+
+            writeStall(getStall(tracker,
+                                functionName,
+                                beginNanoSeconds,
+                                nanoSeconds - beginNanoSeconds),
+                       false);
+        }
+    }
+
+    pthread_mutex_unlock(&mutex);
+}
+
+CK_RV Watchdog::start()
+{
+    assert(!isStarted);
+
+    CK_RV rv = CKR_OK;
+
+    terminationRequested = false;
+
+    if (pthread_create(&threadIdentifier,
+                       nullptr,
+                       &runWatchdogInThread,
+                       this) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot run the watchdog in a separate thread.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    isStarted = true;
+
+EXIT:
+    return rv;
+}
+
+CK_RV Watchdog::stop()
+{
+    CK_RV rv = CKR_OK;
+
+    if (!isStarted)
+    {
+        goto EXIT;
+    }
+
+    pthread_mutex_lock(&mutex);
+
+    terminationRequested = true;
+
+    pthread_cond_signal(&condition);
+    pthread_mutex_unlock(&mutex);
+
+    isStarted = false;
+
+    if (pthread_join(threadIdentifier,
+                     nullptr) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot wait for the watchdog termination.",
+                   rv);
+    }
+
+EXIT:
+    return rv;
+}
+
+void Watchdog::trackCurrentThread(PROFTK_CALL_TRACKER *const pCallTracker)
+{
+    if (pCallTracker != nullptr)
+    {
+        ((WATCHDOG_TRACKER *)pCallTracker)->threadIdentifier = (pid_t)syscall(SYS_gettid);
+    }
+
+    proftk_setCallTracker(pCallTracker);
+}
+
+void Watchdog::writeStall(const WATCHDOG_STALL &stall,
+                          const bool isReturned)
+{
+    char beginTime[EPOCH_MILLI_SECONDS_STRING_LENGTH] = {0};
+
+    formatEpochMilliSeconds(stall.beginEpochMilliSeconds,
+                            beginTime);
+
+    if (isReturned)
+    {
+        fprintf(stderr,
+                "Stall: %s (thread %d) in %s from %s for %llu ms, returned '0x%08lx'.\n",
+                stall.threadName,
+                (int)stall.threadIdentifier,
+                stall.functionName,
+                beginTime,
+                stall.microSeconds / 1000ULL,
+                stall.rv);
+    }
+    else
+    {
+        fprintf(stderr,
+                "Stall: %s (thread %d) in %s from %s for %llu ms so far.\n",
+                stall.threadName,
+                (int)stall.threadIdentifier,
+                stall.functionName,
+                beginTime,
+                stall.microSeconds / 1000ULL);
+    }
+}
@@ -0,0 +1,137 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef WATCHDOG_HPP
+#define WATCHDOG_HPP
+
+#include <deque>
+#include <pthread.h>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include "top.hpp"
+
+extern "C"
+{
+#include <toolkits/profiling-toolkit.h>
+}
+
+#define WATCHDOG__MAXIMUM_THREAD_NAME_LENGTH 64
+
+// Stalls kept for the report, the other ones being only counted.
+#define WATCHDOG__MAXIMUM_STALLS_COUNT 1000
+
+class Watchdog;
+
+// Calls of a thread of the tests, as tracked by the profiling layer.
+typedef struct
+{
+    // Note: first member, the callbacks of the profiling layer being given
+    // its address.
+    PROFTK_CALL_TRACKER callTracker;
+
+    Watchdog *pWatchdog;
+    char threadName[WATCHDOG__MAXIMUM_THREAD_NAME_LENGTH];
+    pid_t threadIdentifier;
+
+    // Begin time of the call in progress already reported as stalled.
+    unsigned long long reportedBeginNanoSeconds;
+} WATCHDOG_TRACKER;
+
+// PKCS#11 call lasting at least the stall threshold.
+typedef struct
+{
+    char threadName[WATCHDOG__MAXIMUM_THREAD_NAME_LENGTH];
+    pid_t threadIdentifier;
+    const char *functionName;
+    unsigned long long beginEpochMilliSeconds;
+    unsigned long long microSeconds;
+    CK_RV rv;
+} WATCHDOG_STALL;
+
+void *runWatchdogInThread(void *arg);
+
+/*
+ * Watchdog of the PKCS#11 calls of the tests (see '--watchdog'): the calls
+ * lasting at least the stall threshold (e.g. a C_Sign blocked during a
+ * failover of the HA group, or a reconnection of NTLS) are recorded with
+ * their thread, function, begin time, duration and returned CK_RV.
+ *
+ * Notes:
+ *   - The calls are tracked by the profiling layer (see 'proftk_enable'),
+ *     that must be enabled.
+ *   - The stalls are recorded once their call returns, but the watchdog
+ *     thread checks the calls in progress at a fraction of the threshold,
+ *     so that a stall is also written (on stderr) as soon as detected.
+ */
+class Watchdog : public Top
+{
+protected:
+    pthread_t threadIdentifier = (pthread_t)0;
+    bool isStarted = false;
+
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t condition = PTHREAD_COND_INITIALIZER;
+    bool terminationRequested = false;
+
+    // Note: the trackers are not moved when new ones are created.
+    std::deque<WATCHDOG_TRACKER> trackers = {};
+
+    std::vector<WATCHDOG_STALL> stalls = {};
+    unsigned long stallsCount = 0L;
+
+    static void onSlowCall(PROFTK_CALL_TRACKER *const pCallTracker,
+                           const char *const functionName,
+                           const CK_RV rv,
+                           const unsigned long long beginNanoSeconds,
+                           const unsigned long long nanoSeconds);
+
+    static WATCHDOG_STALL getStall(const WATCHDOG_TRACKER &tracker,
+                                   const char *const functionName,
+                                   const unsigned long long beginNanoSeconds,
+                                   const unsigned long long nanoSeconds);
+
+    // Writes a stall on stderr, the returned CK_RV being only known once
+    // its call returned.
+    static void writeStall(const WATCHDOG_STALL &stall,
+                           const bool isReturned);
+
+public:
+    const unsigned long long stallMicroSeconds;
+
+    explicit Watchdog(const unsigned long long stallMicroSeconds);
+    ~Watchdog() override;
+
+    Watchdog(const Watchdog &) = delete;
+    Watchdog &operator=(const Watchdog &) = delete;
+
+    // Returns the tracker of the calls of a thread of the tests (see
+    // trackCurrentThread()).
+    virtual PROFTK_CALL_TRACKER *createTracker(const std::string &threadName);
+
+    // Returns the stalls recorded (in their order of detection) and their
+    // count, some of them being dropped beyond the maximum stalls count.
+    virtual void getStalls(std::vector<WATCHDOG_STALL> &stalls,
+                           unsigned long &stallsCount);
+
+    // Checks the calls in progress until stopped.
+    virtual void run();
+
+    virtual CK_RV start();
+
+    virtual CK_RV stop();
+
+    // Tracks the calls of the calling thread (nullptr to stop).
+    virtual void trackCurrentThread(PROFTK_CALL_TRACKER *const pCallTracker);
+};
+
+#endif /* WATCHDOG_HPP */
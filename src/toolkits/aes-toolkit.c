@@ -0,0 +1,489 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <wmmintrin.h>
+
+#define AESTK_WITH_AES_NI
+#endif
+
+// Buffers pipelined by AES-NI, i.e. kept in registers along with a round
+// key.
+#define AESTK_AES_NI_BUFFERS_COUNT 8
+
+// Buffers encrypted by a single VAES (AVX-512) instruction.
+#define AESTK_VAES_BUFFERS_COUNT 4
+
+#include "aes-toolkit.h"
+
+static const unsigned char AESTK_SBOX[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16};
+
+static const unsigned char AESTK_ROUND_CONSTANTS[AESTK_128_ROUNDS_COUNT] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+
+static unsigned char aestk_multiplyByTwo(const unsigned char value)
+{
+    return (unsigned char)((value << 1) ^ ((value & 0x80) ? 0x1b : 0x00));
+}
+
+#ifdef AESTK_WITH_AES_NI
+// Note: the round keys are stored in the byte order expected by AES-NI.
+__attribute__((target("aes,sse2"))) static void aestk_encryptBlock128AesNi(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                                                                          const unsigned char input[AESTK_BLOCK_LENGTH],
+                                                                          unsigned char output[AESTK_BLOCK_LENGTH])
+{
+    const __m128i *const roundKeys = (const __m128i *)pKeySchedule->roundKeys;
+    __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *)input),
+                                  _mm_loadu_si128(&roundKeys[0]));
+
+    for (int round = 1; round < AESTK_128_ROUNDS_COUNT; round++)
+    {
+        state = _mm_aesenc_si128(state,
+                                 _mm_loadu_si128(&roundKeys[round]));
+    }
+
+    state = _mm_aesenclast_si128(state,
+                                 _mm_loadu_si128(&roundKeys[AESTK_128_ROUNDS_COUNT]));
+
+    _mm_storeu_si128((__m128i *)output,
+                     state);
+}
+
+__attribute__((target("aes,sse2"))) static void aestk_encryptBuffers128AesNi(const AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule,
+                                                                            const size_t firstBuffer,
+                                                                            const size_t buffersCount,
+                                                                            const unsigned char *const inputs,
+                                                                            unsigned char *const outputs)
+{
+    __m128i states[AESTK_AES_NI_BUFFERS_COUNT];
+
+    for (size_t groupBuffer = firstBuffer; groupBuffer < buffersCount; groupBuffer += AESTK_AES_NI_BUFFERS_COUNT)
+    {
+        const size_t groupBuffersCount = ((buffersCount - groupBuffer) < AESTK_AES_NI_BUFFERS_COUNT) ? (buffersCount - groupBuffer) : AESTK_AES_NI_BUFFERS_COUNT;
+        const size_t offset = groupBuffer * AESTK_BLOCK_LENGTH;
+
+        for (size_t buffer = 0; buffer < groupBuffersCount; buffer++)
+        {
+            states[buffer] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&inputs[offset + (buffer * AESTK_BLOCK_LENGTH)]),
+                                           _mm_loadu_si128((const __m128i *)&pKeySchedule->roundKeys[0][offset + (buffer * AESTK_BLOCK_LENGTH)]));
+        }
+
+        for (int round = 1; round < AESTK_128_ROUNDS_COUNT; round++)
+        {
+            for (size_t buffer = 0; buffer < groupBuffersCount; buffer++)
+            {
+                states[buffer] = _mm_aesenc_si128(states[buffer],
+                                                  _mm_loadu_si128((const __m128i *)&pKeySchedule->roundKeys[round][offset + (buffer * AESTK_BLOCK_LENGTH)]));
+            }
+        }
+
+        for (size_t buffer = 0; buffer < groupBuffersCount; buffer++)
+        {
+            _mm_storeu_si128((__m128i *)&outputs[offset + (buffer * AESTK_BLOCK_LENGTH)],
+                             _mm_aesenclast_si128(states[buffer],
+                                                  _mm_loadu_si128((const __m128i *)&pKeySchedule->roundKeys[AESTK_128_ROUNDS_COUNT][offset + (buffer * AESTK_BLOCK_LENGTH)])));
+        }
+    }
+}
+
+// Expands the keys round by round, so that the expansions of the keys are
+// pipelined. AESKEYGENASSIST being slow, SubWord(RotWord(w3)) xor Rcon is
+// computed by AESENCLAST on w3 rotated and broadcast to all the columns
+// (ShiftRows being then neutral). The round keys of a key are 'roundStride'
+// bytes apart, so that both schedule layouts can be produced.
+__attribute__((target("aes,ssse3"))) static void aestk_expandKeys128AesNi(const size_t keysCount,
+                                                                         const unsigned char *const keys,
+                                                                         unsigned char *const roundKeys,
+                                                                         const size_t roundStride)
+{
+    const __m128i rotateWordMask = _mm_setr_epi8(13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12);
+    __m128i states[AESTK_MAXIMUM_BUFFERS_COUNT];
+
+    for (size_t key = 0; key < keysCount; key++)
+    {
+        states[key] = _mm_loadu_si128((const __m128i *)&keys[key * AESTK_128_KEY_LENGTH]);
+
+        _mm_storeu_si128((__m128i *)&roundKeys[key * AESTK_BLOCK_LENGTH],
+                         states[key]);
+    }
+
+    for (int round = 1; round <= AESTK_128_ROUNDS_COUNT; round++)
+    {
+        const __m128i roundConstant = _mm_set1_epi32(AESTK_ROUND_CONSTANTS[round - 1]);
+
+        for (size_t key = 0; key < keysCount; key++)
+        {
+            __m128i state = states[key];
+            const __m128i word = _mm_aesenclast_si128(_mm_shuffle_epi8(state, rotateWordMask),
+                                                      roundConstant);
+
+            state = _mm_xor_si128(state,
+                                  _mm_slli_si128(state, 4));
+            state = _mm_xor_si128(state,
+                                  _mm_slli_si128(state, 8));
+
+            states[key] = _mm_xor_si128(state,
+                                        word);
+
+            _mm_storeu_si128((__m128i *)&roundKeys[((size_t)round * roundStride) + (key * AESTK_BLOCK_LENGTH)],
+                             states[key]);
+        }
+    }
+}
+
+// Encrypts the buffers by groups of 4 (one per 128-bit lane of a ZMM
+// register), the last ones being left to AES-NI.
+__attribute__((target("aes,sse2,vaes,avx512f"))) static void aestk_encryptBuffers128Vaes(const AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule,
+                                                                                        const size_t buffersCount,
+                                                                                        const unsigned char *const inputs,
+                                                                                        unsigned char *const outputs)
+{
+    __m512i states[AESTK_MAXIMUM_BUFFERS_COUNT / AESTK_VAES_BUFFERS_COUNT];
+    const size_t groupsCount = buffersCount / AESTK_VAES_BUFFERS_COUNT;
+    const size_t groupLength = AESTK_VAES_BUFFERS_COUNT * AESTK_BLOCK_LENGTH;
+
+    for (size_t group = 0; group < groupsCount; group++)
+    {
+        states[group] = _mm512_xor_si512(_mm512_loadu_si512(&inputs[group * groupLength]),
+                                         _mm512_loadu_si512(&pKeySchedule->roundKeys[0][group * groupLength]));
+    }
+
+    for (int round = 1; round < AESTK_128_ROUNDS_COUNT; round++)
+    {
+        for (size_t group = 0; group < groupsCount; group++)
+        {
+            states[group] = _mm512_aesenc_epi128(states[group],
+                                                 _mm512_loadu_si512(&pKeySchedule->roundKeys[round][group * groupLength]));
+        }
+    }
+
+    for (size_t group = 0; group < groupsCount; group++)
+    {
+        _mm512_storeu_si512(&outputs[group * groupLength],
+                            _mm512_aesenclast_epi128(states[group],
+                                                     _mm512_loadu_si512(&pKeySchedule->roundKeys[AESTK_128_ROUNDS_COUNT][group * groupLength])));
+    }
+
+    aestk_encryptBuffers128AesNi(pKeySchedule,
+                                 groupsCount * AESTK_VAES_BUFFERS_COUNT,
+                                 buffersCount,
+                                 inputs,
+                                 outputs);
+}
+#endif
+
+static void aestk_encryptBlock128Software(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                                          const unsigned char input[AESTK_BLOCK_LENGTH],
+                                          unsigned char output[AESTK_BLOCK_LENGTH])
+{
+    unsigned char state[AESTK_BLOCK_LENGTH];
+    unsigned char shifted[AESTK_BLOCK_LENGTH];
+
+    for (int index = 0; index < AESTK_BLOCK_LENGTH; index++)
+    {
+        state[index] = input[index] ^ pKeySchedule->roundKeys[index];
+    }
+
+    for (int round = 1; round <= AESTK_128_ROUNDS_COUNT; round++)
+    {
+        // SubBytes and ShiftRows (the state is stored column by column).
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                shifted[(column * 4) + row] = AESTK_SBOX[state[(((column + row) % 4) * 4) + row]];
+            }
+        }
+
+        // MixColumns (skipped for the last round).
+        if (round != AESTK_128_ROUNDS_COUNT)
+        {
+            for (int column = 0; column < 4; column++)
+            {
+                const unsigned char *const pColumn = &shifted[column * 4];
+                const unsigned char all = pColumn[0] ^ pColumn[1] ^ pColumn[2] ^ pColumn[3];
+
+                state[(column * 4) + 0] = pColumn[0] ^ all ^ aestk_multiplyByTwo(pColumn[0] ^ pColumn[1]);
+                state[(column * 4) + 1] = pColumn[1] ^ all ^ aestk_multiplyByTwo(pColumn[1] ^ pColumn[2]);
+                state[(column * 4) + 2] = pColumn[2] ^ all ^ aestk_multiplyByTwo(pColumn[2] ^ pColumn[3]);
+                state[(column * 4) + 3] = pColumn[3] ^ all ^ aestk_multiplyByTwo(pColumn[3] ^ pColumn[0]);
+            }
+        }
+        else
+        {
+            memcpy(state,
+                   shifted,
+                   AESTK_BLOCK_LENGTH);
+        }
+
+        // AddRoundKey.
+        for (int index = 0; index < AESTK_BLOCK_LENGTH; index++)
+        {
+            state[index] ^= pKeySchedule->roundKeys[(round * AESTK_BLOCK_LENGTH) + index];
+        }
+    }
+
+    memcpy(output,
+           state,
+           AESTK_BLOCK_LENGTH);
+}
+
+void aestk_encryptBlock128(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                           const unsigned char input[AESTK_BLOCK_LENGTH],
+                           unsigned char output[AESTK_BLOCK_LENGTH])
+{
+    assert(pKeySchedule != NULL);
+    assert(input != NULL);
+    assert(output != NULL);
+
+#ifdef AESTK_WITH_AES_NI
+    if (aestk_isUsingAesNi())
+    {
+        aestk_encryptBlock128AesNi(pKeySchedule,
+                                   input,
+                                   output);
+
+        return;
+    }
+#endif
+
+    aestk_encryptBlock128Software(pKeySchedule,
+                                  input,
+                                  output);
+}
+
+void aestk_encryptBuffers128(const AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule,
+                             const size_t buffersCount,
+                             const unsigned char *const inputs,
+                             unsigned char *const outputs)
+{
+    assert(pKeySchedule != NULL);
+    assert(buffersCount <= AESTK_MAXIMUM_BUFFERS_COUNT);
+    assert((inputs != NULL) || (buffersCount == 0));
+    assert((outputs != NULL) || (buffersCount == 0));
+
+#ifdef AESTK_WITH_AES_NI
+    static int isUsingVaes = -1;
+
+    // Note: concurrent first calls compute the same value.
+    if (isUsingVaes < 0)
+    {
+        isUsingVaes = (strcmp(aestk_getBuffersImplementation(), "VAES") == 0) ? 1 : 0;
+    }
+
+    if (isUsingVaes)
+    {
+        aestk_encryptBuffers128Vaes(pKeySchedule,
+                                    buffersCount,
+                                    inputs,
+                                    outputs);
+
+        return;
+    }
+
+    if (aestk_isUsingAesNi())
+    {
+        aestk_encryptBuffers128AesNi(pKeySchedule,
+                                     0,
+                                     buffersCount,
+                                     inputs,
+                                     outputs);
+
+        return;
+    }
+#endif
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        AESTK_128_KEY_SCHEDULE keySchedule;
+
+        for (int round = 0; round <= AESTK_128_ROUNDS_COUNT; round++)
+        {
+            memcpy(&keySchedule.roundKeys[round * AESTK_BLOCK_LENGTH],
+                   &pKeySchedule->roundKeys[round][buffer * AESTK_BLOCK_LENGTH],
+                   AESTK_BLOCK_LENGTH);
+        }
+
+        aestk_encryptBlock128Software(&keySchedule,
+                                      &inputs[buffer * AESTK_BLOCK_LENGTH],
+                                      &outputs[buffer * AESTK_BLOCK_LENGTH]);
+    }
+}
+
+void aestk_encryptCtr128(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                         const unsigned char initialCounterBlock[AESTK_BLOCK_LENGTH],
+                         const unsigned char *const input,
+                         const size_t length,
+                         unsigned char *const output)
+{
+    assert(pKeySchedule != NULL);
+    assert(initialCounterBlock != NULL);
+    assert((input != NULL) || (length == 0));
+    assert((output != NULL) || (length == 0));
+
+    unsigned char counterBlock[AESTK_BLOCK_LENGTH];
+    unsigned char keyStream[AESTK_BLOCK_LENGTH];
+
+    memcpy(counterBlock,
+           initialCounterBlock,
+           AESTK_BLOCK_LENGTH);
+
+    for (size_t offset = 0; offset < length; offset += AESTK_BLOCK_LENGTH)
+    {
+        aestk_encryptBlock128(pKeySchedule,
+                              counterBlock,
+                              keyStream);
+
+        for (size_t index = 0; (index < AESTK_BLOCK_LENGTH) && ((offset + index) < length); index++)
+        {
+            output[offset + index] = input[offset + index] ^ keyStream[index];
+        }
+
+        for (int index = AESTK_BLOCK_LENGTH - 1; index >= 0; index--)
+        {
+            if (++counterBlock[index] != 0)
+            {
+                break;
+            }
+        }
+    }
+}
+
+void aestk_expandBuffersKeys128(const size_t buffersCount,
+                                const unsigned char *const keys,
+                                AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule)
+{
+    assert(buffersCount <= AESTK_MAXIMUM_BUFFERS_COUNT);
+    assert((keys != NULL) || (buffersCount == 0));
+    assert(pKeySchedule != NULL);
+
+#ifdef AESTK_WITH_AES_NI
+    if (aestk_isUsingAesNi())
+    {
+        aestk_expandKeys128AesNi(buffersCount,
+                                 keys,
+                                 &pKeySchedule->roundKeys[0][0],
+                                 sizeof(pKeySchedule->roundKeys[0]));
+
+        return;
+    }
+#endif
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        AESTK_128_KEY_SCHEDULE keySchedule;
+
+        aestk_expandKey128(&keys[buffer * AESTK_128_KEY_LENGTH],
+                           &keySchedule);
+
+        for (int round = 0; round <= AESTK_128_ROUNDS_COUNT; round++)
+        {
+            memcpy(&pKeySchedule->roundKeys[round][buffer * AESTK_BLOCK_LENGTH],
+                   &keySchedule.roundKeys[round * AESTK_BLOCK_LENGTH],
+                   AESTK_BLOCK_LENGTH);
+        }
+    }
+}
+
+void aestk_expandKey128(const unsigned char key[AESTK_128_KEY_LENGTH],
+                        AESTK_128_KEY_SCHEDULE *const pKeySchedule)
+{
+    assert(key != NULL);
+    assert(pKeySchedule != NULL);
+
+#ifdef AESTK_WITH_AES_NI
+    if (aestk_isUsingAesNi())
+    {
+        aestk_expandKeys128AesNi(1,
+                                 key,
+                                 pKeySchedule->roundKeys,
+                                 AESTK_BLOCK_LENGTH);
+
+        return;
+    }
+#endif
+
+    unsigned char *const roundKeys = pKeySchedule->roundKeys;
+
+    memcpy(roundKeys,
+           key,
+           AESTK_128_KEY_LENGTH);
+
+    for (int index = AESTK_128_KEY_LENGTH; index < (int)sizeof(pKeySchedule->roundKeys); index += 4)
+    {
+        unsigned char word[4];
+
+        memcpy(word,
+               &roundKeys[index - 4],
+               4);
+
+        if ((index % AESTK_128_KEY_LENGTH) == 0)
+        {
+            const unsigned char first = word[0];
+
+            word[0] = AESTK_SBOX[word[1]] ^ AESTK_ROUND_CONSTANTS[(index / AESTK_128_KEY_LENGTH) - 1];
+            word[1] = AESTK_SBOX[word[2]];
+            word[2] = AESTK_SBOX[word[3]];
+            word[3] = AESTK_SBOX[first];
+        }
+
+        for (int byteIndex = 0; byteIndex < 4; byteIndex++)
+        {
+            roundKeys[index + byteIndex] = roundKeys[index - AESTK_128_KEY_LENGTH + byteIndex] ^ word[byteIndex];
+        }
+    }
+}
+
+const char *aestk_getBuffersImplementation(void)
+{
+#ifdef AESTK_WITH_AES_NI
+    if (aestk_isUsingAesNi())
+    {
+        return (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx512f")) ? "VAES" : "AES-NI";
+    }
+#endif
+
+    return "software";
+}
+
+int aestk_isUsingAesNi(void)
+{
+#ifdef AESTK_WITH_AES_NI
+    static int isUsingAesNi = -1;
+
+    // Note: concurrent first calls compute the same value.
+    if (isUsingAesNi < 0)
+    {
+        isUsingAesNi = (__builtin_cpu_supports("aes") && __builtin_cpu_supports("ssse3")) ? 1 : 0;
+    }
+
+    return isUsingAesNi;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,87 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __AES_TOOLKIT_H__
+#define __AES_TOOLKIT_H__
+
+#include <stddef.h>
+
+/*
+ * Definitions
+ */
+#define AESTK_BLOCK_LENGTH 16
+
+#define AESTK_128_KEY_LENGTH 16
+#define AESTK_128_ROUNDS_COUNT 10
+
+// Maximum number of independent blocks (each one with its own key)
+// encrypted together by aestk_encryptBuffers128().
+#define AESTK_MAXIMUM_BUFFERS_COUNT 16
+
+// AES-128 expanded key.
+typedef struct _AESTK_128_KEY_SCHEDULE
+{
+    unsigned char roundKeys[(AESTK_128_ROUNDS_COUNT + 1) * AESTK_BLOCK_LENGTH];
+} AESTK_128_KEY_SCHEDULE;
+
+// AES-128 expanded keys of several buffers, stored round by round so that
+// the round keys of consecutive buffers are contiguous.
+typedef struct _AESTK_128_BUFFERS_KEY_SCHEDULE
+{
+    unsigned char roundKeys[AESTK_128_ROUNDS_COUNT + 1][AESTK_MAXIMUM_BUFFERS_COUNT * AESTK_BLOCK_LENGTH];
+} AESTK_128_BUFFERS_KEY_SCHEDULE;
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - Only the encryption direction is provided as it is the only one
+ *     required by the 3GPP authentication functions and by the CTR mode.
+ *   - The blocks are encrypted (and the keys expanded) with the AES-NI
+ *     instructions when the CPU provides them, in software otherwise.
+ *   - The inputs and outputs of the buffers are stored one after the other
+ *     (AESTK_BLOCK_LENGTH bytes each), and at most
+ *     AESTK_MAXIMUM_BUFFERS_COUNT buffers are processed at once.
+ */
+void aestk_encryptBlock128(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                           const unsigned char input[AESTK_BLOCK_LENGTH],
+                           unsigned char output[AESTK_BLOCK_LENGTH]);
+
+// Encrypts the block of each buffer with its own key, the rounds of the
+// buffers being interleaved (VAES processes 4 buffers per instruction,
+// AES-NI pipelines up to 8 buffers).
+void aestk_encryptBuffers128(const AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule,
+                             const size_t buffersCount,
+                             const unsigned char *const inputs,
+                             unsigned char *const outputs);
+
+// CTR mode (NIST SP 800-38A), the counter block being incremented as a
+// 128-bit big-endian integer.
+void aestk_encryptCtr128(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                         const unsigned char initialCounterBlock[AESTK_BLOCK_LENGTH],
+                         const unsigned char *const input,
+                         const size_t length,
+                         unsigned char *const output);
+
+// 'keys' holds the key of each buffer, one after the other.
+void aestk_expandBuffersKeys128(const size_t buffersCount,
+                                const unsigned char *const keys,
+                                AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule);
+
+void aestk_expandKey128(const unsigned char key[AESTK_128_KEY_LENGTH],
+                        AESTK_128_KEY_SCHEDULE *const pKeySchedule);
+
+// Returns the name of the implementation of aestk_encryptBuffers128(), i.e.
+// 'VAES', 'AES-NI' or 'software'.
+const char *aestk_getBuffersImplementation(void);
+
+// Returns 1 if the blocks are encrypted with the AES-NI instructions.
+int aestk_isUsingAesNi(void);
+
+#endif /* __AES_TOOLKIT_H__ */
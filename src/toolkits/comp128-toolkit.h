@@ -0,0 +1,60 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __COMP128_TOOLKIT_H__
+#define __COMP128_TOOLKIT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Definitions
+ *
+ * Software implementation of the COMP-128 versions 1, 2 and 3 (GSM A3/A8),
+ * as published by their reverse-engineering (i.e. there is no official
+ * specification for them; reference test vectors are the ones of the
+ * open-source implementations, e.g. Osmocom's libosmocore).
+ *
+ * Notes:
+ *   - The last 10 bits of Kc are zero with the versions 1 and 2.
+ */
+#define COMP128TK_KI_LENGTH 16
+#define COMP128TK_RAND_LENGTH 16
+#define COMP128TK_SRES_LENGTH 4
+#define COMP128TK_KC_LENGTH 8
+
+// RAND || SRES || Kc, as returned by the Luna CKM_COMP128 mechanism.
+#define COMP128TK_TRIPLET_LENGTH (COMP128TK_RAND_LENGTH + COMP128TK_SRES_LENGTH + COMP128TK_KC_LENGTH)
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - The functions returning a boolean are returning 'false' if the
+ *     version is not 1, 2 or 3.
+ */
+
+// Checks the invariants of the substitution tables (e.g. the ones of the
+// versions 2 and 3 are permutations), as a self-test complementing the known
+// answers.
+bool comp128tk_checkTables(void);
+
+bool comp128tk_compute(const unsigned int version,
+                       const unsigned char ki[COMP128TK_KI_LENGTH],
+                       const unsigned char rand[COMP128TK_RAND_LENGTH],
+                       unsigned char sres[COMP128TK_SRES_LENGTH],
+                       unsigned char kc[COMP128TK_KC_LENGTH]);
+
+// 'rand' may be the beginning of 'triplet'.
+bool comp128tk_generateTriplet(const unsigned int version,
+                               const unsigned char ki[COMP128TK_KI_LENGTH],
+                               const unsigned char rand[COMP128TK_RAND_LENGTH],
+                               unsigned char triplet[COMP128TK_TRIPLET_LENGTH]);
+
+#endif /* __COMP128_TOOLKIT_H__ */
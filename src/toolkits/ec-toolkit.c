@@ -0,0 +1,1127 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ec-toolkit.h"
+
+__extension__ typedef unsigned __int128 ECTK_UINT128;
+
+//
+// P-256.
+//
+// The field elements are stored as 4 64-bit limbs (little-endian), in the
+// Montgomery domain (R = 2^256).
+//
+typedef uint64_t ECTK_P256_FIELD_ELEMENT[4];
+
+// Jacobian coordinates (X / Z^2, Y / Z^3); Z = 0 for the point at infinity.
+typedef struct _ECTK_P256_POINT
+{
+    ECTK_P256_FIELD_ELEMENT x;
+    ECTK_P256_FIELD_ELEMENT y;
+    ECTK_P256_FIELD_ELEMENT z;
+} ECTK_P256_POINT;
+
+static const ECTK_P256_FIELD_ELEMENT ECTK_P256_P = {0xFFFFFFFFFFFFFFFFULL, 0x00000000FFFFFFFFULL, 0x0000000000000000ULL, 0xFFFFFFFF00000001ULL};
+static const ECTK_P256_FIELD_ELEMENT ECTK_P256_R2 = {0x0000000000000003ULL, 0xFFFFFFFBFFFFFFFFULL, 0xFFFFFFFFFFFFFFFEULL, 0x00000004FFFFFFFDULL};
+
+static const unsigned char ECTK_P256_N[ECTK_P256_SCALAR_LENGTH] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51};
+
+static const unsigned char ECTK_P256_B[ECTK_P256_FIELD_LENGTH] = {
+    0x5A, 0xC6, 0x35, 0xD8, 0xAA, 0x3A, 0x93, 0xE7, 0xB3, 0xEB, 0xBD, 0x55, 0x76, 0x98, 0x86, 0xBC,
+    0x65, 0x1D, 0x06, 0xB0, 0xCC, 0x53, 0xB0, 0xF6, 0x3B, 0xCE, 0x3C, 0x3E, 0x27, 0xD2, 0x60, 0x4B};
+
+static const unsigned char ECTK_P256_G[ECTK_P256_PUBLIC_KEY_LENGTH] = {
+    0x04,
+    0x6B, 0x17, 0xD1, 0xF2, 0xE1, 0x2C, 0x42, 0x47, 0xF8, 0xBC, 0xE6, 0xE5, 0x63, 0xA4, 0x40, 0xF2,
+    0x77, 0x03, 0x7D, 0x81, 0x2D, 0xEB, 0x33, 0xA0, 0xF4, 0xA1, 0x39, 0x45, 0xD8, 0x98, 0xC2, 0x96,
+    0x4F, 0xE3, 0x42, 0xE2, 0xFE, 0x1A, 0x7F, 0x9B, 0x8E, 0xE7, 0xEB, 0x4A, 0x7C, 0x0F, 0x9E, 0x16,
+    0x2B, 0xCE, 0x33, 0x57, 0x6B, 0x31, 0x5E, 0xCE, 0xCB, 0xB6, 0x40, 0x68, 0x37, 0xBF, 0x51, 0xF5};
+
+static bool ectk_p256IsGreaterOrEqualToP(const uint64_t a[4])
+{
+    for (int index = 3; index >= 0; index--)
+    {
+        if (a[index] != ECTK_P256_P[index])
+        {
+            return (a[index] > ECTK_P256_P[index]);
+        }
+    }
+
+    return true;
+}
+
+static void ectk_p256SubtractP(uint64_t a[4])
+{
+    ECTK_UINT128 borrow = 0;
+
+    for (int index = 0; index < 4; index++)
+    {
+        const ECTK_UINT128 difference = (ECTK_UINT128)a[index] - ECTK_P256_P[index] - borrow;
+
+        a[index] = (uint64_t)difference;
+        borrow = (difference >> 64) & 1;
+    }
+}
+
+static void ectk_p256Add(ECTK_P256_FIELD_ELEMENT r,
+                         const ECTK_P256_FIELD_ELEMENT a,
+                         const ECTK_P256_FIELD_ELEMENT b)
+{
+    ECTK_UINT128 carry = 0;
+
+    for (int index = 0; index < 4; index++)
+    {
+        carry += (ECTK_UINT128)a[index] + b[index];
+        r[index] = (uint64_t)carry;
+        carry >>= 64;
+    }
+
+    if ((carry != 0) ||
+        ectk_p256IsGreaterOrEqualToP(r))
+    {
+        ectk_p256SubtractP(r);
+    }
+}
+
+static void ectk_p256Subtract(ECTK_P256_FIELD_ELEMENT r,
+                              const ECTK_P256_FIELD_ELEMENT a,
+                              const ECTK_P256_FIELD_ELEMENT b)
+{
+    ECTK_UINT128 borrow = 0;
+
+    for (int index = 0; index < 4; index++)
+    {
+        const ECTK_UINT128 difference = (ECTK_UINT128)a[index] - b[index] - borrow;
+
+        r[index] = (uint64_t)difference;
+        borrow = (difference >> 64) & 1;
+    }
+
+    // Add p back on underflow.
+    if (borrow != 0)
+    {
+        ECTK_UINT128 carry = 0;
+
+        for (int index = 0; index < 4; index++)
+        {
+            carry += (ECTK_UINT128)r[index] + ECTK_P256_P[index];
+            r[index] = (uint64_t)carry;
+            carry >>= 64;
+        }
+    }
+}
+
+// Montgomery multiplication (CIOS); -p^-1 mod 2^64 = 1 for P-256.
+static void ectk_p256Multiply(ECTK_P256_FIELD_ELEMENT r,
+                              const ECTK_P256_FIELD_ELEMENT a,
+                              const ECTK_P256_FIELD_ELEMENT b)
+{
+    uint64_t t[6] = {0};
+
+    for (int i = 0; i < 4; i++)
+    {
+        ECTK_UINT128 carry = 0;
+
+        for (int j = 0; j < 4; j++)
+        {
+            carry += ((ECTK_UINT128)a[j] * b[i]) + t[j];
+            t[j] = (uint64_t)carry;
+            carry >>= 64;
+        }
+
+        carry += t[4];
+        t[4] = (uint64_t)carry;
+        t[5] = (uint64_t)(carry >> 64);
+
+        const uint64_t m = t[0];
+
+        carry = ((ECTK_UINT128)m * ECTK_P256_P[0]) + t[0];
+        carry >>= 64;
+
+        for (int j = 1; j < 4; j++)
+        {
+            carry += ((ECTK_UINT128)m * ECTK_P256_P[j]) + t[j];
+            t[j - 1] = (uint64_t)carry;
+            carry >>= 64;
+        }
+
+        carry += t[4];
+        t[3] = (uint64_t)carry;
+        t[4] = t[5] + (uint64_t)(carry >> 64);
+        t[5] = 0;
+    }
+
+    if ((t[4] != 0) ||
+        ectk_p256IsGreaterOrEqualToP(t))
+    {
+        ectk_p256SubtractP(t);
+    }
+
+    memcpy(r,
+           t,
+           sizeof(ECTK_P256_FIELD_ELEMENT));
+}
+
+static void ectk_p256Square(ECTK_P256_FIELD_ELEMENT r,
+                            const ECTK_P256_FIELD_ELEMENT a)
+{
+    ectk_p256Multiply(r,
+                      a,
+                      a);
+}
+
+static bool ectk_p256IsZero(const ECTK_P256_FIELD_ELEMENT a)
+{
+    return ((a[0] | a[1] | a[2] | a[3]) == 0);
+}
+
+// Returns false if the value is not lower than p.
+static bool ectk_p256FromBytes(ECTK_P256_FIELD_ELEMENT r,
+                               const unsigned char bytes[ECTK_P256_FIELD_LENGTH])
+{
+    ECTK_P256_FIELD_ELEMENT value;
+
+    for (int index = 0; index < 4; index++)
+    {
+        value[index] = 0;
+
+        for (int byteIndex = 0; byteIndex < 8; byteIndex++)
+        {
+            value[index] = (value[index] << 8) | bytes[((3 - index) * 8) + byteIndex];
+        }
+    }
+
+    if (ectk_p256IsGreaterOrEqualToP(value))
+    {
+        return false;
+    }
+
+    ectk_p256Multiply(r,
+                      value,
+                      ECTK_P256_R2);
+
+    return true;
+}
+
+static void ectk_p256ToBytes(unsigned char bytes[ECTK_P256_FIELD_LENGTH],
+                             const ECTK_P256_FIELD_ELEMENT a)
+{
+    const ECTK_P256_FIELD_ELEMENT one = {1, 0, 0, 0};
+    ECTK_P256_FIELD_ELEMENT value;
+
+    ectk_p256Multiply(value,
+                      a,
+                      one);
+
+    for (int index = 0; index < 4; index++)
+    {
+        for (int byteIndex = 0; byteIndex < 8; byteIndex++)
+        {
+            bytes[((3 - index) * 8) + byteIndex] = (unsigned char)(value[index] >> (56 - (byteIndex * 8)));
+        }
+    }
+}
+
+static void ectk_p256Power(ECTK_P256_FIELD_ELEMENT r,
+                           const ECTK_P256_FIELD_ELEMENT a,
+                           const uint64_t exponent[4])
+{
+    ECTK_P256_FIELD_ELEMENT result;
+    bool isStarted = false;
+
+    for (int bit = 255; bit >= 0; bit--)
+    {
+        if (isStarted)
+        {
+            ectk_p256Square(result,
+                            result);
+        }
+
+        if ((exponent[bit / 64] >> (bit % 64)) & 1)
+        {
+            if (isStarted)
+            {
+                ectk_p256Multiply(result,
+                                  result,
+                                  a);
+            }
+            else
+            {
+                memcpy(result,
+                       a,
+                       sizeof(ECTK_P256_FIELD_ELEMENT));
+
+                isStarted = true;
+            }
+        }
+    }
+
+    memcpy(r,
+           result,
+           sizeof(ECTK_P256_FIELD_ELEMENT));
+}
+
+// a^(p - 2).
+static void ectk_p256Invert(ECTK_P256_FIELD_ELEMENT r,
+                            const ECTK_P256_FIELD_ELEMENT a)
+{
+    const uint64_t exponent[4] = {0xFFFFFFFFFFFFFFFDULL, 0x00000000FFFFFFFFULL, 0x0000000000000000ULL, 0xFFFFFFFF00000001ULL};
+
+    ectk_p256Power(r,
+                   a,
+                   exponent);
+}
+
+// dbl-2001-b (a = -3).
+static void ectk_p256DoublePoint(ECTK_P256_POINT *const pR,
+                                 const ECTK_P256_POINT *const pP)
+{
+    ECTK_P256_FIELD_ELEMENT delta, gamma, beta, alpha, t1, t2;
+
+    if (ectk_p256IsZero(pP->z))
+    {
+        *pR = *pP;
+
+        return;
+    }
+
+    ectk_p256Square(delta,
+                    pP->z);
+    ectk_p256Square(gamma,
+                    pP->y);
+    ectk_p256Multiply(beta,
+                      pP->x,
+                      gamma);
+
+    ectk_p256Subtract(t1,
+                      pP->x,
+                      delta);
+    ectk_p256Add(t2,
+                 pP->x,
+                 delta);
+    ectk_p256Multiply(alpha,
+                      t1,
+                      t2);
+    ectk_p256Add(t1,
+                 alpha,
+                 alpha);
+    ectk_p256Add(alpha,
+                 t1,
+                 alpha);
+
+    // Z3 = (Y1 + Z1)^2 - gamma - delta.
+    ectk_p256Add(t1,
+                 pP->y,
+                 pP->z);
+    ectk_p256Square(t1,
+                    t1);
+    ectk_p256Subtract(t1,
+                      t1,
+                      gamma);
+    ectk_p256Subtract(pR->z,
+                      t1,
+                      delta);
+
+    // X3 = alpha^2 - 8 * beta.
+    ectk_p256Add(beta,
+                 beta,
+                 beta);
+    ectk_p256Add(beta,
+                 beta,
+                 beta);
+    ectk_p256Square(t1,
+                    alpha);
+    ectk_p256Add(t2,
+                 beta,
+                 beta);
+    ectk_p256Subtract(pR->x,
+                      t1,
+                      t2);
+
+    // Y3 = alpha * (4 * beta - X3) - 8 * gamma^2.
+    ectk_p256Subtract(t1,
+                      beta,
+                      pR->x);
+    ectk_p256Multiply(t1,
+                      alpha,
+                      t1);
+    ectk_p256Square(gamma,
+                    gamma);
+    ectk_p256Add(gamma,
+                 gamma,
+                 gamma);
+    ectk_p256Add(gamma,
+                 gamma,
+                 gamma);
+    ectk_p256Add(gamma,
+                 gamma,
+                 gamma);
+    ectk_p256Subtract(pR->y,
+                      t1,
+                      gamma);
+}
+
+// add-2007-bl.
+static void ectk_p256AddPoints(ECTK_P256_POINT *const pR,
+                               const ECTK_P256_POINT *const pP,
+                               const ECTK_P256_POINT *const pQ)
+{
+    ECTK_P256_FIELD_ELEMENT z1z1, z2z2, u1, u2, s1, s2, h, i, j, r, v, t;
+
+    if (ectk_p256IsZero(pP->z))
+    {
+        *pR = *pQ;
+
+        return;
+    }
+
+    if (ectk_p256IsZero(pQ->z))
+    {
+        *pR = *pP;
+
+        return;
+    }
+
+    ectk_p256Square(z1z1,
+                    pP->z);
+    ectk_p256Square(z2z2,
+                    pQ->z);
+    ectk_p256Multiply(u1,
+                      pP->x,
+                      z2z2);
+    ectk_p256Multiply(u2,
+                      pQ->x,
+                      z1z1);
+    ectk_p256Multiply(s1,
+                      pP->y,
+                      pQ->z);
+    ectk_p256Multiply(s1,
+                      s1,
+                      z2z2);
+    ectk_p256Multiply(s2,
+                      pQ->y,
+                      pP->z);
+    ectk_p256Multiply(s2,
+                      s2,
+                      z1z1);
+
+    ectk_p256Subtract(h,
+                      u2,
+                      u1);
+    ectk_p256Subtract(r,
+                      s2,
+                      s1);
+
+    if (ectk_p256IsZero(h))
+    {
+        if (ectk_p256IsZero(r))
+        {
+            ectk_p256DoublePoint(pR,
+                                 pP);
+        }
+        else
+        {
+            memset(pR,
+                   0,
+                   sizeof(*pR));
+        }
+
+        return;
+    }
+
+    ectk_p256Add(r,
+                 r,
+                 r);
+    ectk_p256Add(i,
+                 h,
+                 h);
+    ectk_p256Square(i,
+                    i);
+    ectk_p256Multiply(j,
+                      h,
+                      i);
+    ectk_p256Multiply(v,
+                      u1,
+                      i);
+
+    // Z3 = ((Z1 + Z2)^2 - Z1Z1 - Z2Z2) * H (computed first, as pR may be
+    // pP or pQ).
+    ectk_p256Add(t,
+                 pP->z,
+                 pQ->z);
+    ectk_p256Square(t,
+                    t);
+    ectk_p256Subtract(t,
+                      t,
+                      z1z1);
+    ectk_p256Subtract(t,
+                      t,
+                      z2z2);
+    ectk_p256Multiply(pR->z,
+                      t,
+                      h);
+
+    // X3 = r^2 - J - 2 * V.
+    ectk_p256Square(t,
+                    r);
+    ectk_p256Subtract(t,
+                      t,
+                      j);
+    ectk_p256Subtract(t,
+                      t,
+                      v);
+    ectk_p256Subtract(pR->x,
+                      t,
+                      v);
+
+    // Y3 = r * (V - X3) - 2 * S1 * J.
+    ectk_p256Subtract(t,
+                      v,
+                      pR->x);
+    ectk_p256Multiply(t,
+                      r,
+                      t);
+    ectk_p256Multiply(s1,
+                      s1,
+                      j);
+    ectk_p256Add(s1,
+                 s1,
+                 s1);
+    ectk_p256Subtract(pR->y,
+                      t,
+                      s1);
+}
+
+static bool ectk_p256IsValidScalar(const unsigned char scalar[ECTK_P256_SCALAR_LENGTH])
+{
+    bool isZero = true;
+
+    for (int index = 0; index < ECTK_P256_SCALAR_LENGTH; index++)
+    {
+        if (scalar[index] != 0)
+        {
+            isZero = false;
+        }
+    }
+
+    if (isZero)
+    {
+        return false;
+    }
+
+    return (memcmp(scalar,
+                   ECTK_P256_N,
+                   ECTK_P256_SCALAR_LENGTH) < 0);
+}
+
+// x^3 - 3x + b.
+static void ectk_p256ComputeCurveEquation(ECTK_P256_FIELD_ELEMENT r,
+                                          const ECTK_P256_FIELD_ELEMENT x)
+{
+    ECTK_P256_FIELD_ELEMENT b, t;
+
+    ectk_p256FromBytes(b,
+                       ECTK_P256_B);
+    ectk_p256Square(r,
+                    x);
+    ectk_p256Multiply(r,
+                      r,
+                      x);
+    ectk_p256Add(t,
+                 x,
+                 x);
+    ectk_p256Add(t,
+                 t,
+                 x);
+    ectk_p256Subtract(r,
+                      r,
+                      t);
+    ectk_p256Add(r,
+                 r,
+                 b);
+}
+
+// Decodes and checks an uncompressed point.
+static bool ectk_p256DecodePoint(ECTK_P256_POINT *const pPoint,
+                                 const unsigned char encodedPoint[ECTK_P256_PUBLIC_KEY_LENGTH])
+{
+    ECTK_P256_FIELD_ELEMENT left, right;
+
+    if ((encodedPoint[0] != 0x04) ||
+        !ectk_p256FromBytes(pPoint->x,
+                            &encodedPoint[1]) ||
+        !ectk_p256FromBytes(pPoint->y,
+                            &encodedPoint[1 + ECTK_P256_FIELD_LENGTH]))
+    {
+        return false;
+    }
+
+    // Z = 1 (in the Montgomery domain).
+    {
+        const ECTK_P256_FIELD_ELEMENT one = {1, 0, 0, 0};
+
+        ectk_p256Multiply(pPoint->z,
+                          one,
+                          ECTK_P256_R2);
+    }
+
+    // y^2 = x^3 - 3x + b.
+    ectk_p256Square(left,
+                    pPoint->y);
+    ectk_p256ComputeCurveEquation(right,
+                                  pPoint->x);
+
+    return (memcmp(left,
+                   right,
+                   sizeof(ECTK_P256_FIELD_ELEMENT)) == 0);
+}
+
+// 4-bit fixed window, the scalar being processed from its most significant
+// bits.
+static void ectk_p256MultiplyPoint(ECTK_P256_POINT *const pR,
+                                   const unsigned char scalar[ECTK_P256_SCALAR_LENGTH],
+                                   const ECTK_P256_POINT *const pP)
+{
+    ECTK_P256_POINT table[16];
+    ECTK_P256_POINT result;
+
+    memset(&table[0],
+           0,
+           sizeof(table[0]));
+    table[1] = *pP;
+
+    for (int index = 2; index < 16; index++)
+    {
+        ectk_p256AddPoints(&table[index],
+                           &table[index - 1],
+                           pP);
+    }
+
+    memset(&result,
+           0,
+           sizeof(result));
+
+    for (int index = 0; index < (ECTK_P256_SCALAR_LENGTH * 2); index++)
+    {
+        const unsigned int window = (index % 2 == 0) ? (scalar[index / 2] >> 4) : (scalar[index / 2] & 0x0F);
+
+        for (int doubling = 0; doubling < 4; doubling++)
+        {
+            ectk_p256DoublePoint(&result,
+                                 &result);
+        }
+
+        ectk_p256AddPoints(&result,
+                           &result,
+                           &table[window]);
+    }
+
+    *pR = result;
+}
+
+// Returns false for the point at infinity.
+static bool ectk_p256GetAffineCoordinates(const ECTK_P256_POINT *const pPoint,
+                                          unsigned char x[ECTK_P256_FIELD_LENGTH],
+                                          unsigned char y[ECTK_P256_FIELD_LENGTH])
+{
+    ECTK_P256_FIELD_ELEMENT zInverse, zInverse2, t;
+
+    if (ectk_p256IsZero(pPoint->z))
+    {
+        return false;
+    }
+
+    ectk_p256Invert(zInverse,
+                    pPoint->z);
+    ectk_p256Square(zInverse2,
+                    zInverse);
+
+    ectk_p256Multiply(t,
+                      pPoint->x,
+                      zInverse2);
+    ectk_p256ToBytes(x,
+                     t);
+
+    if (y != NULL)
+    {
+        ectk_p256Multiply(t,
+                          pPoint->y,
+                          zInverse2);
+        ectk_p256Multiply(t,
+                          t,
+                          zInverse);
+        ectk_p256ToBytes(y,
+                         t);
+    }
+
+    return true;
+}
+
+bool ectk_p256ComputePublicKey(const unsigned char privateKey[ECTK_P256_SCALAR_LENGTH],
+                               unsigned char publicKey[ECTK_P256_PUBLIC_KEY_LENGTH])
+{
+    assert(privateKey != NULL);
+    assert(publicKey != NULL);
+
+    ECTK_P256_POINT g;
+    ECTK_P256_POINT point;
+
+    if (!ectk_p256IsValidScalar(privateKey))
+    {
+        return false;
+    }
+
+    ectk_p256DecodePoint(&g,
+                         ECTK_P256_G);
+
+    ectk_p256MultiplyPoint(&point,
+                           privateKey,
+                           &g);
+
+    publicKey[0] = 0x04;
+
+    return ectk_p256GetAffineCoordinates(&point,
+                                         &publicKey[1],
+                                         &publicKey[1 + ECTK_P256_FIELD_LENGTH]);
+}
+
+bool ectk_p256DecompressPoint(const unsigned char compressedPoint[ECTK_P256_COMPRESSED_POINT_LENGTH],
+                              unsigned char point[ECTK_P256_PUBLIC_KEY_LENGTH])
+{
+    assert(compressedPoint != NULL);
+    assert(point != NULL);
+
+    // (p + 1) / 4, as p = 3 mod 4.
+    const uint64_t exponent[4] = {0x0000000000000000ULL, 0x0000000040000000ULL, 0x4000000000000000ULL, 0x3FFFFFFFC0000000ULL};
+    ECTK_P256_FIELD_ELEMENT x, y, ySquare, check;
+
+    if (((compressedPoint[0] != 0x02) &&
+         (compressedPoint[0] != 0x03)) ||
+        !ectk_p256FromBytes(x,
+                            &compressedPoint[1]))
+    {
+        return false;
+    }
+
+    ectk_p256ComputeCurveEquation(ySquare,
+                                  x);
+    ectk_p256Power(y,
+                   ySquare,
+                   exponent);
+
+    // x^3 - 3x + b may not be a square.
+    ectk_p256Square(check,
+                    y);
+
+    if (memcmp(check,
+               ySquare,
+               sizeof(ECTK_P256_FIELD_ELEMENT)) != 0)
+    {
+        return false;
+    }
+
+    point[0] = 0x04;
+    memcpy(&point[1],
+           &compressedPoint[1],
+           ECTK_P256_FIELD_LENGTH);
+    ectk_p256ToBytes(&point[1 + ECTK_P256_FIELD_LENGTH],
+                     y);
+
+    // Select the root with the requested parity.
+    if ((point[ECTK_P256_PUBLIC_KEY_LENGTH - 1] & 0x01) != (compressedPoint[0] & 0x01))
+    {
+        const ECTK_P256_FIELD_ELEMENT zero = {0, 0, 0, 0};
+
+        ectk_p256Subtract(y,
+                          zero,
+                          y);
+        ectk_p256ToBytes(&point[1 + ECTK_P256_FIELD_LENGTH],
+                         y);
+    }
+
+    return true;
+}
+
+bool ectk_p256ComputeSharedSecret(const unsigned char privateKey[ECTK_P256_SCALAR_LENGTH],
+                                  const unsigned char publicKey[ECTK_P256_PUBLIC_KEY_LENGTH],
+                                  unsigned char sharedSecret[ECTK_P256_FIELD_LENGTH])
+{
+    assert(privateKey != NULL);
+    assert(publicKey != NULL);
+    assert(sharedSecret != NULL);
+
+    ECTK_P256_POINT peerPoint;
+    ECTK_P256_POINT point;
+
+    if (!ectk_p256IsValidScalar(privateKey) ||
+        !ectk_p256DecodePoint(&peerPoint,
+                              publicKey))
+    {
+        return false;
+    }
+
+    ectk_p256MultiplyPoint(&point,
+                           privateKey,
+                           &peerPoint);
+
+    return ectk_p256GetAffineCoordinates(&point,
+                                         sharedSecret,
+                                         NULL);
+}
+
+//
+// X25519.
+//
+// The field elements are stored as 5 51-bit limbs (little-endian).
+//
+typedef uint64_t ECTK_X25519_FIELD_ELEMENT[5];
+
+#define ECTK_X25519_LIMB_MASK ((((uint64_t)1) << 51) - 1)
+
+static uint64_t ectk_x25519Load64(const unsigned char *const bytes)
+{
+    uint64_t value = 0;
+
+    for (int index = 7; index >= 0; index--)
+    {
+        value = (value << 8) | bytes[index];
+    }
+
+    return value;
+}
+
+static void ectk_x25519FromBytes(ECTK_X25519_FIELD_ELEMENT r,
+                                 const unsigned char bytes[ECTK_X25519_KEY_LENGTH])
+{
+    // The most significant bit is ignored (RFC 7748, 5).
+    r[0] = ectk_x25519Load64(&bytes[0]) & ECTK_X25519_LIMB_MASK;
+    r[1] = (ectk_x25519Load64(&bytes[6]) >> 3) & ECTK_X25519_LIMB_MASK;
+    r[2] = (ectk_x25519Load64(&bytes[12]) >> 6) & ECTK_X25519_LIMB_MASK;
+    r[3] = (ectk_x25519Load64(&bytes[19]) >> 1) & ECTK_X25519_LIMB_MASK;
+    r[4] = (ectk_x25519Load64(&bytes[24]) >> 12) & ECTK_X25519_LIMB_MASK;
+}
+
+static void ectk_x25519Carry(ECTK_X25519_FIELD_ELEMENT r)
+{
+    for (int index = 0; index < 4; index++)
+    {
+        r[index + 1] += r[index] >> 51;
+        r[index] &= ECTK_X25519_LIMB_MASK;
+    }
+
+    r[0] += 19 * (r[4] >> 51);
+    r[4] &= ECTK_X25519_LIMB_MASK;
+
+    r[1] += r[0] >> 51;
+    r[0] &= ECTK_X25519_LIMB_MASK;
+}
+
+static void ectk_x25519ToBytes(unsigned char bytes[ECTK_X25519_KEY_LENGTH],
+                               const ECTK_X25519_FIELD_ELEMENT a)
+{
+    ECTK_X25519_FIELD_ELEMENT t;
+    uint64_t q = 0;
+
+    memcpy(t,
+           a,
+           sizeof(t));
+
+    ectk_x25519Carry(t);
+    ectk_x25519Carry(t);
+
+    // Subtract p if t >= p, i.e. if t + 19 >= 2^255.
+    q = (t[0] + 19) >> 51;
+    q = (t[1] + q) >> 51;
+    q = (t[2] + q) >> 51;
+    q = (t[3] + q) >> 51;
+    q = (t[4] + q) >> 51;
+
+    t[0] += 19 * q;
+
+    for (int index = 0; index < 4; index++)
+    {
+        t[index + 1] += t[index] >> 51;
+        t[index] &= ECTK_X25519_LIMB_MASK;
+    }
+
+    t[4] &= ECTK_X25519_LIMB_MASK;
+
+    memset(bytes,
+           0,
+           ECTK_X25519_KEY_LENGTH);
+
+    for (int bit = 0; bit < 255; bit++)
+    {
+        if ((t[bit / 51] >> (bit % 51)) & 1)
+        {
+            bytes[bit / 8] |= (unsigned char)(1 << (bit % 8));
+        }
+    }
+}
+
+static void ectk_x25519Add(ECTK_X25519_FIELD_ELEMENT r,
+                           const ECTK_X25519_FIELD_ELEMENT a,
+                           const ECTK_X25519_FIELD_ELEMENT b)
+{
+    for (int index = 0; index < 5; index++)
+    {
+        r[index] = a[index] + b[index];
+    }
+}
+
+// a + 2p - b, to stay positive.
+static void ectk_x25519Subtract(ECTK_X25519_FIELD_ELEMENT r,
+                                const ECTK_X25519_FIELD_ELEMENT a,
+                                const ECTK_X25519_FIELD_ELEMENT b)
+{
+    r[0] = (a[0] + 0xFFFFFFFFFFFDAULL) - b[0];
+    r[1] = (a[1] + 0xFFFFFFFFFFFFEULL) - b[1];
+    r[2] = (a[2] + 0xFFFFFFFFFFFFEULL) - b[2];
+    r[3] = (a[3] + 0xFFFFFFFFFFFFEULL) - b[3];
+    r[4] = (a[4] + 0xFFFFFFFFFFFFEULL) - b[4];
+}
+
+static void ectk_x25519Multiply(ECTK_X25519_FIELD_ELEMENT r,
+                                const ECTK_X25519_FIELD_ELEMENT a,
+                                const ECTK_X25519_FIELD_ELEMENT b)
+{
+    const uint64_t b1_19 = b[1] * 19;
+    const uint64_t b2_19 = b[2] * 19;
+    const uint64_t b3_19 = b[3] * 19;
+    const uint64_t b4_19 = b[4] * 19;
+
+    ECTK_UINT128 t[5];
+
+    t[0] = ((ECTK_UINT128)a[0] * b[0]) + ((ECTK_UINT128)a[1] * b4_19) + ((ECTK_UINT128)a[2] * b3_19) + ((ECTK_UINT128)a[3] * b2_19) + ((ECTK_UINT128)a[4] * b1_19);
+    t[1] = ((ECTK_UINT128)a[0] * b[1]) + ((ECTK_UINT128)a[1] * b[0]) + ((ECTK_UINT128)a[2] * b4_19) + ((ECTK_UINT128)a[3] * b3_19) + ((ECTK_UINT128)a[4] * b2_19);
+    t[2] = ((ECTK_UINT128)a[0] * b[2]) + ((ECTK_UINT128)a[1] * b[1]) + ((ECTK_UINT128)a[2] * b[0]) + ((ECTK_UINT128)a[3] * b4_19) + ((ECTK_UINT128)a[4] * b3_19);
+    t[3] = ((ECTK_UINT128)a[0] * b[3]) + ((ECTK_UINT128)a[1] * b[2]) + ((ECTK_UINT128)a[2] * b[1]) + ((ECTK_UINT128)a[3] * b[0]) + ((ECTK_UINT128)a[4] * b4_19);
+    t[4] = ((ECTK_UINT128)a[0] * b[4]) + ((ECTK_UINT128)a[1] * b[3]) + ((ECTK_UINT128)a[2] * b[2]) + ((ECTK_UINT128)a[3] * b[1]) + ((ECTK_UINT128)a[4] * b[0]);
+
+    t[1] += (uint64_t)(t[0] >> 51);
+    r[0] = (uint64_t)t[0] & ECTK_X25519_LIMB_MASK;
+    t[2] += (uint64_t)(t[1] >> 51);
+    r[1] = (uint64_t)t[1] & ECTK_X25519_LIMB_MASK;
+    t[3] += (uint64_t)(t[2] >> 51);
+    r[2] = (uint64_t)t[2] & ECTK_X25519_LIMB_MASK;
+    t[4] += (uint64_t)(t[3] >> 51);
+    r[3] = (uint64_t)t[3] & ECTK_X25519_LIMB_MASK;
+    r[0] += 19 * (uint64_t)(t[4] >> 51);
+    r[4] = (uint64_t)t[4] & ECTK_X25519_LIMB_MASK;
+
+    r[1] += r[0] >> 51;
+    r[0] &= ECTK_X25519_LIMB_MASK;
+}
+
+static void ectk_x25519MultiplyBySmall(ECTK_X25519_FIELD_ELEMENT r,
+                                       const ECTK_X25519_FIELD_ELEMENT a,
+                                       const uint64_t value)
+{
+    ECTK_UINT128 carry = 0;
+
+    for (int index = 0; index < 5; index++)
+    {
+        carry += (ECTK_UINT128)a[index] * value;
+        r[index] = (uint64_t)carry & ECTK_X25519_LIMB_MASK;
+        carry >>= 51;
+    }
+
+    r[0] += 19 * (uint64_t)carry;
+
+    r[1] += r[0] >> 51;
+    r[0] &= ECTK_X25519_LIMB_MASK;
+}
+
+// a^(p - 2), with p - 2 = 2^255 - 21.
+static void ectk_x25519Invert(ECTK_X25519_FIELD_ELEMENT r,
+                              const ECTK_X25519_FIELD_ELEMENT a)
+{
+    ECTK_X25519_FIELD_ELEMENT result;
+
+    memcpy(result,
+           a,
+           sizeof(result));
+
+    for (int bit = 253; bit >= 0; bit--)
+    {
+        ectk_x25519Multiply(result,
+                            result,
+                            result);
+
+        // All the bits of 2^255 - 21 are set, except bits 2 and 4.
+        if ((bit != 2) &&
+            (bit != 4))
+        {
+            ectk_x25519Multiply(result,
+                                result,
+                                a);
+        }
+    }
+
+    memcpy(r,
+           result,
+           sizeof(result));
+}
+
+static void ectk_x25519ConditionalSwap(ECTK_X25519_FIELD_ELEMENT a,
+                                       ECTK_X25519_FIELD_ELEMENT b,
+                                       const uint64_t swap)
+{
+    const uint64_t mask = (uint64_t)0 - swap;
+
+    for (int index = 0; index < 5; index++)
+    {
+        const uint64_t t = mask & (a[index] ^ b[index]);
+
+        a[index] ^= t;
+        b[index] ^= t;
+    }
+}
+
+void ectk_x25519(const unsigned char scalar[ECTK_X25519_KEY_LENGTH],
+                 const unsigned char u[ECTK_X25519_KEY_LENGTH],
+                 unsigned char output[ECTK_X25519_KEY_LENGTH])
+{
+    assert(scalar != NULL);
+    assert(u != NULL);
+    assert(output != NULL);
+
+    unsigned char k[ECTK_X25519_KEY_LENGTH];
+    ECTK_X25519_FIELD_ELEMENT x1, x2, z2, x3, z3;
+    ECTK_X25519_FIELD_ELEMENT a, aa, b, bb, e, c, d, da, cb, t;
+    uint64_t swap = 0;
+
+    // Clamping (RFC 7748, 5).
+    memcpy(k,
+           scalar,
+           ECTK_X25519_KEY_LENGTH);
+    k[0] &= 248;
+    k[31] &= 127;
+    k[31] |= 64;
+
+    ectk_x25519FromBytes(x1,
+                         u);
+
+    memset(x2,
+           0,
+           sizeof(x2));
+    x2[0] = 1;
+    memset(z2,
+           0,
+           sizeof(z2));
+    memcpy(x3,
+           x1,
+           sizeof(x3));
+    memset(z3,
+           0,
+           sizeof(z3));
+    z3[0] = 1;
+
+    // Montgomery ladder (RFC 7748, 5).
+    for (int bit = 254; bit >= 0; bit--)
+    {
+        const uint64_t kBit = (k[bit / 8] >> (bit % 8)) & 1;
+
+        swap ^= kBit;
+        ectk_x25519ConditionalSwap(x2,
+                                   x3,
+                                   swap);
+        ectk_x25519ConditionalSwap(z2,
+                                   z3,
+                                   swap);
+        swap = kBit;
+
+        ectk_x25519Add(a,
+                       x2,
+                       z2);
+        ectk_x25519Multiply(aa,
+                            a,
+                            a);
+        ectk_x25519Subtract(b,
+                            x2,
+                            z2);
+        ectk_x25519Multiply(bb,
+                            b,
+                            b);
+        ectk_x25519Subtract(e,
+                            aa,
+                            bb);
+        ectk_x25519Add(c,
+                       x3,
+                       z3);
+        ectk_x25519Subtract(d,
+                            x3,
+                            z3);
+        ectk_x25519Multiply(da,
+                            d,
+                            a);
+        ectk_x25519Multiply(cb,
+                            c,
+                            b);
+
+        ectk_x25519Add(t,
+                       da,
+                       cb);
+        ectk_x25519Multiply(x3,
+                            t,
+                            t);
+        ectk_x25519Subtract(t,
+                            da,
+                            cb);
+        ectk_x25519Multiply(t,
+                            t,
+                            t);
+        ectk_x25519Multiply(z3,
+                            x1,
+                            t);
+        ectk_x25519Multiply(x2,
+                            aa,
+                            bb);
+        ectk_x25519MultiplyBySmall(t,
+                                   e,
+                                   121665);
+        ectk_x25519Add(t,
+                       aa,
+                       t);
+        ectk_x25519Multiply(z2,
+                            e,
+                            t);
+    }
+
+    ectk_x25519ConditionalSwap(x2,
+                               x3,
+                               swap);
+    ectk_x25519ConditionalSwap(z2,
+                               z3,
+                               swap);
+
+    ectk_x25519Invert(z2,
+                      z2);
+    ectk_x25519Multiply(x2,
+                        x2,
+                        z2);
+    ectk_x25519ToBytes(output,
+                       x2);
+}
+
+void ectk_x25519ComputePublicKey(const unsigned char privateKey[ECTK_X25519_KEY_LENGTH],
+                                 unsigned char publicKey[ECTK_X25519_KEY_LENGTH])
+{
+    const unsigned char basePoint[ECTK_X25519_KEY_LENGTH] = {9};
+
+    ectk_x25519(privateKey,
+                basePoint,
+                publicKey);
+}
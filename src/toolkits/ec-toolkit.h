@@ -0,0 +1,62 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __EC_TOOLKIT_H__
+#define __EC_TOOLKIT_H__
+
+#include <stdbool.h>
+
+/*
+ * Definitions
+ *
+ * Software implementation of the elliptic curve Diffie-Hellman primitives
+ * used by the SUCI protection schemes (TS 33.501, annex C):
+ *   - P-256 (FIPS 186-4, SEC 1), the public keys being encoded as
+ *     uncompressed points (0x04 || X || Y).
+ *   - X25519 (RFC 7748).
+ *
+ * Notes:
+ *   - These implementations are NOT constant-time: they are only meant to
+ *     produce test data.
+ */
+#define ECTK_P256_SCALAR_LENGTH 32
+#define ECTK_P256_FIELD_LENGTH 32
+#define ECTK_P256_PUBLIC_KEY_LENGTH (1 + (2 * ECTK_P256_FIELD_LENGTH))
+#define ECTK_P256_COMPRESSED_POINT_LENGTH (1 + ECTK_P256_FIELD_LENGTH)
+
+#define ECTK_X25519_KEY_LENGTH 32
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - The P-256 private keys are big-endian integers that must be in the
+ *     [1, n - 1] range; the functions return 'false' otherwise, or if the
+ *     public key is not on the curve.
+ */
+bool ectk_p256ComputePublicKey(const unsigned char privateKey[ECTK_P256_SCALAR_LENGTH],
+                               unsigned char publicKey[ECTK_P256_PUBLIC_KEY_LENGTH]);
+
+// Returns 'false' if the point is not on the curve.
+bool ectk_p256DecompressPoint(const unsigned char compressedPoint[ECTK_P256_COMPRESSED_POINT_LENGTH],
+                              unsigned char point[ECTK_P256_PUBLIC_KEY_LENGTH]);
+
+// Z is the X coordinate of the shared point (SEC 1, 3.3.1).
+bool ectk_p256ComputeSharedSecret(const unsigned char privateKey[ECTK_P256_SCALAR_LENGTH],
+                                  const unsigned char publicKey[ECTK_P256_PUBLIC_KEY_LENGTH],
+                                  unsigned char sharedSecret[ECTK_P256_FIELD_LENGTH]);
+
+void ectk_x25519(const unsigned char scalar[ECTK_X25519_KEY_LENGTH],
+                 const unsigned char u[ECTK_X25519_KEY_LENGTH],
+                 unsigned char output[ECTK_X25519_KEY_LENGTH]);
+
+void ectk_x25519ComputePublicKey(const unsigned char privateKey[ECTK_X25519_KEY_LENGTH],
+                                 unsigned char publicKey[ECTK_X25519_KEY_LENGTH]);
+
+#endif /* __EC_TOOLKIT_H__ */
@@ -0,0 +1,290 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "aes-toolkit.h"
+#include "ecies-toolkit.h"
+#include "kdf-toolkit.h"
+#include "sha-toolkit.h"
+
+// Encrypts the input and appends the tag: 'output' points right after the
+// ephemeral public key.
+static void eciestk_encryptWithSharedSecret(const unsigned char *const sharedSecret,
+                                            const size_t sharedSecretLength,
+                                            const unsigned char *const input,
+                                            const size_t length,
+                                            unsigned char *const output)
+{
+    unsigned char keys[ECIESTK_ENCRYPTION_KEY_LENGTH + ECIESTK_MAC_KEY_LENGTH];
+    const unsigned char initialCounterBlock[AESTK_BLOCK_LENGTH] = {0};
+    AESTK_128_KEY_SCHEDULE keySchedule;
+
+    kdftk_deriveWithX963Sha256(sharedSecret,
+                               sharedSecretLength,
+                               NULL,
+                               0,
+                               keys,
+                               sizeof(keys));
+
+    aestk_expandKey128(keys,
+                       &keySchedule);
+    aestk_encryptCtr128(&keySchedule,
+                        initialCounterBlock,
+                        input,
+                        length,
+                        output);
+
+    shatk_hmacSha256(&keys[ECIESTK_ENCRYPTION_KEY_LENGTH],
+                     ECIESTK_MAC_KEY_LENGTH,
+                     output,
+                     length,
+                     &output[length]);
+
+    memset(keys,
+           0,
+           sizeof(keys));
+}
+
+// Checks the tag and decrypts the ciphertext: 'input' points right after the
+// ephemeral public key.
+static bool eciestk_decryptWithSharedSecret(const unsigned char *const sharedSecret,
+                                            const size_t sharedSecretLength,
+                                            const unsigned char *const input,
+                                            const size_t inputLength,
+                                            unsigned char *const output,
+                                            size_t *const pOutputLength)
+{
+    unsigned char keys[ECIESTK_ENCRYPTION_KEY_LENGTH + ECIESTK_MAC_KEY_LENGTH];
+    unsigned char mac[ECIESTK_MAC_LENGTH];
+    const unsigned char initialCounterBlock[AESTK_BLOCK_LENGTH] = {0};
+    AESTK_128_KEY_SCHEDULE keySchedule;
+    unsigned char difference = 0;
+    bool isDecrypted = false;
+
+    if (inputLength < ECIESTK_MAC_LENGTH)
+    {
+        return false;
+    }
+
+    const size_t length = inputLength - ECIESTK_MAC_LENGTH;
+
+    kdftk_deriveWithX963Sha256(sharedSecret,
+                               sharedSecretLength,
+                               NULL,
+                               0,
+                               keys,
+                               sizeof(keys));
+
+    shatk_hmacSha256(&keys[ECIESTK_ENCRYPTION_KEY_LENGTH],
+                     ECIESTK_MAC_KEY_LENGTH,
+                     input,
+                     length,
+                     mac);
+
+    for (size_t index = 0; index < ECIESTK_MAC_LENGTH; index++)
+    {
+        difference |= (unsigned char)(mac[index] ^ input[length + index]);
+    }
+
+    if (difference == 0)
+    {
+        aestk_expandKey128(keys,
+                           &keySchedule);
+        aestk_encryptCtr128(&keySchedule,
+                            initialCounterBlock,
+                            input,
+                            length,
+                            output);
+
+        *pOutputLength = length;
+        isDecrypted = true;
+    }
+
+    memset(keys,
+           0,
+           sizeof(keys));
+
+    return isDecrypted;
+}
+
+bool eciestk_decryptWithP256(const unsigned char privateKey[ECTK_P256_SCALAR_LENGTH],
+                             const unsigned char *const input,
+                             const size_t inputLength,
+                             unsigned char *const output,
+                             size_t *const pOutputLength)
+{
+    assert(privateKey != NULL);
+    assert(input != NULL);
+    assert(output != NULL);
+    assert(pOutputLength != NULL);
+
+    unsigned char ephemeralPublicKey[ECTK_P256_PUBLIC_KEY_LENGTH];
+    unsigned char sharedSecret[ECTK_P256_FIELD_LENGTH];
+    size_t ephemeralPublicKeyLength = ECTK_P256_PUBLIC_KEY_LENGTH;
+    bool isDecrypted = false;
+
+    if (inputLength < ECTK_P256_COMPRESSED_POINT_LENGTH)
+    {
+        return false;
+    }
+
+    if (input[0] == 0x04)
+    {
+        if (inputLength < ECTK_P256_PUBLIC_KEY_LENGTH)
+        {
+            return false;
+        }
+
+        memcpy(ephemeralPublicKey,
+               input,
+               ECTK_P256_PUBLIC_KEY_LENGTH);
+    }
+    else
+    {
+        if (!ectk_p256DecompressPoint(input,
+                                      ephemeralPublicKey))
+        {
+            return false;
+        }
+
+        ephemeralPublicKeyLength = ECTK_P256_COMPRESSED_POINT_LENGTH;
+    }
+
+    if (ectk_p256ComputeSharedSecret(privateKey,
+                                     ephemeralPublicKey,
+                                     sharedSecret))
+    {
+        isDecrypted = eciestk_decryptWithSharedSecret(sharedSecret,
+                                                      sizeof(sharedSecret),
+                                                      &input[ephemeralPublicKeyLength],
+                                                      inputLength - ephemeralPublicKeyLength,
+                                                      output,
+                                                      pOutputLength);
+    }
+
+    memset(sharedSecret,
+           0,
+           sizeof(sharedSecret));
+
+    return isDecrypted;
+}
+
+bool eciestk_decryptWithX25519(const unsigned char privateKey[ECTK_X25519_KEY_LENGTH],
+                               const unsigned char *const input,
+                               const size_t inputLength,
+                               unsigned char *const output,
+                               size_t *const pOutputLength)
+{
+    assert(privateKey != NULL);
+    assert(input != NULL);
+    assert(output != NULL);
+    assert(pOutputLength != NULL);
+
+    unsigned char sharedSecret[ECTK_X25519_KEY_LENGTH];
+    bool isDecrypted = false;
+
+    if (inputLength < ECTK_X25519_KEY_LENGTH)
+    {
+        return false;
+    }
+
+    ectk_x25519(privateKey,
+                input,
+                sharedSecret);
+
+    isDecrypted = eciestk_decryptWithSharedSecret(sharedSecret,
+                                                  sizeof(sharedSecret),
+                                                  &input[ECTK_X25519_KEY_LENGTH],
+                                                  inputLength - ECTK_X25519_KEY_LENGTH,
+                                                  output,
+                                                  pOutputLength);
+
+    memset(sharedSecret,
+           0,
+           sizeof(sharedSecret));
+
+    return isDecrypted;
+}
+
+bool eciestk_encryptWithP256(const unsigned char publicKey[ECTK_P256_PUBLIC_KEY_LENGTH],
+                             const unsigned char ephemeralPrivateKey[ECTK_P256_SCALAR_LENGTH],
+                             const bool isCompressingPoints,
+                             const unsigned char *const input,
+                             const size_t length,
+                             unsigned char *const output)
+{
+    assert(publicKey != NULL);
+    assert(ephemeralPrivateKey != NULL);
+    assert((input != NULL) || (length == 0));
+    assert(output != NULL);
+
+    unsigned char sharedSecret[ECTK_P256_FIELD_LENGTH];
+    size_t ephemeralPublicKeyLength = ECTK_P256_PUBLIC_KEY_LENGTH;
+
+    if (!ectk_p256ComputePublicKey(ephemeralPrivateKey,
+                                   output) ||
+        !ectk_p256ComputeSharedSecret(ephemeralPrivateKey,
+                                      publicKey,
+                                      sharedSecret))
+    {
+        return false;
+    }
+
+    // The parity of Y selects the compressed point prefix.
+    if (isCompressingPoints)
+    {
+        output[0] = (unsigned char)((output[ECTK_P256_PUBLIC_KEY_LENGTH - 1] & 0x01) ? 0x03 : 0x02);
+
+        ephemeralPublicKeyLength = ECTK_P256_COMPRESSED_POINT_LENGTH;
+    }
+
+    eciestk_encryptWithSharedSecret(sharedSecret,
+                                    sizeof(sharedSecret),
+                                    input,
+                                    length,
+                                    &output[ephemeralPublicKeyLength]);
+
+    memset(sharedSecret,
+           0,
+           sizeof(sharedSecret));
+
+    return true;
+}
+
+void eciestk_encryptWithX25519(const unsigned char publicKey[ECTK_X25519_KEY_LENGTH],
+                               const unsigned char ephemeralPrivateKey[ECTK_X25519_KEY_LENGTH],
+                               const unsigned char *const input,
+                               const size_t length,
+                               unsigned char *const output)
+{
+    assert(publicKey != NULL);
+    assert(ephemeralPrivateKey != NULL);
+    assert((input != NULL) || (length == 0));
+    assert(output != NULL);
+
+    unsigned char sharedSecret[ECTK_X25519_KEY_LENGTH];
+
+    ectk_x25519ComputePublicKey(ephemeralPrivateKey,
+                                output);
+    ectk_x25519(ephemeralPrivateKey,
+                publicKey,
+                sharedSecret);
+
+    eciestk_encryptWithSharedSecret(sharedSecret,
+                                    sizeof(sharedSecret),
+                                    input,
+                                    length,
+                                    &output[ECTK_X25519_KEY_LENGTH]);
+
+    memset(sharedSecret,
+           0,
+           sizeof(sharedSecret));
+}
@@ -0,0 +1,79 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __ECIES_TOOLKIT_H__
+#define __ECIES_TOOLKIT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ec-toolkit.h"
+
+/*
+ * Definitions
+ *
+ * Software implementation of the ECIES encryption used by the SUCI
+ * protection schemes, with the parameters of the HSM mechanism of the SUCI
+ * scenario:
+ *   - KDF : ANSI X9.63 with SHA-256, without shared information.
+ *   - ENC : AES-128 in CTR mode, with a null initial counter block.
+ *   - MAC : HMAC-SHA-256, with a 256-bit key and a 256-bit tag.
+ *
+ * The output is Ephemeral Public Key || Ciphertext || MAC Tag, the
+ * ephemeral public key being:
+ *   - for P-256: a point encoded as per SEC 1 (2.3.3), compressed or not.
+ *   - for X25519: the 32-byte u-coordinate.
+ */
+#define ECIESTK_ENCRYPTION_KEY_LENGTH 16
+#define ECIESTK_MAC_KEY_LENGTH 32
+#define ECIESTK_MAC_LENGTH 32
+
+// Length of the encryption of 'length' bytes.
+#define ECIESTK_P256_OUTPUT_LENGTH(length, isCompressingPoints) ((((isCompressingPoints) ? ECTK_P256_COMPRESSED_POINT_LENGTH : ECTK_P256_PUBLIC_KEY_LENGTH)) + (length) + ECIESTK_MAC_LENGTH)
+#define ECIESTK_X25519_OUTPUT_LENGTH(length) (ECTK_X25519_KEY_LENGTH + (length) + ECIESTK_MAC_LENGTH)
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - The ephemeral private keys are provided by the caller.
+ *   - The output buffers must be large enough for the lengths above.
+ *   - 'eciestk_encryptWithP256' returns 'false' if the ephemeral private key
+ *     is not valid (it must be in the [1, n - 1] range) or if the public key
+ *     is not on the curve.
+ *   - The decryption functions return 'false' if the input is malformed or
+ *     if the MAC tag does not match; the output buffer must be as large as
+ *     the input.
+ */
+bool eciestk_decryptWithP256(const unsigned char privateKey[ECTK_P256_SCALAR_LENGTH],
+                             const unsigned char *const input,
+                             const size_t inputLength,
+                             unsigned char *const output,
+                             size_t *const pOutputLength);
+
+bool eciestk_decryptWithX25519(const unsigned char privateKey[ECTK_X25519_KEY_LENGTH],
+                               const unsigned char *const input,
+                               const size_t inputLength,
+                               unsigned char *const output,
+                               size_t *const pOutputLength);
+
+bool eciestk_encryptWithP256(const unsigned char publicKey[ECTK_P256_PUBLIC_KEY_LENGTH],
+                             const unsigned char ephemeralPrivateKey[ECTK_P256_SCALAR_LENGTH],
+                             const bool isCompressingPoints,
+                             const unsigned char *const input,
+                             const size_t length,
+                             unsigned char *const output);
+
+void eciestk_encryptWithX25519(const unsigned char publicKey[ECTK_X25519_KEY_LENGTH],
+                               const unsigned char ephemeralPrivateKey[ECTK_X25519_KEY_LENGTH],
+                               const unsigned char *const input,
+                               const size_t length,
+                               unsigned char *const output);
+
+#endif /* __ECIES_TOOLKIT_H__ */
@@ -0,0 +1,99 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "kdf-toolkit.h"
+#include "sha-toolkit.h"
+
+size_t kdftk_buildInput(const unsigned char fc,
+                        const unsigned char *const *const parameters,
+                        const size_t *const parametersLengths,
+                        const size_t parametersCount,
+                        unsigned char *const output,
+                        const size_t outputSize)
+{
+    assert((parameters != NULL) || (parametersCount == 0));
+    assert((parametersLengths != NULL) || (parametersCount == 0));
+    assert(output != NULL);
+
+    size_t length = 0;
+
+    if (outputSize < 1)
+    {
+        return 0;
+    }
+
+    output[length++] = fc;
+
+    for (size_t index = 0; index < parametersCount; index++)
+    {
+        const size_t parameterLength = parametersLengths[index];
+
+        if ((parameterLength > 0x0FFFF) ||
+            ((length + parameterLength + 2) > outputSize))
+        {
+            return 0;
+        }
+
+        memcpy(&output[length],
+               parameters[index],
+               parameterLength);
+
+        length += parameterLength;
+
+        // Li is the length of Pi in bytes, over 2 bytes (big-endian).
+        output[length++] = (unsigned char)((parameterLength >> 8) & 0x0FF);
+        output[length++] = (unsigned char)(parameterLength & 0x0FF);
+    }
+
+    return length;
+}
+
+void kdftk_deriveWithX963Sha256(const unsigned char *const z,
+                                const size_t zLength,
+                                const unsigned char *const sharedInfo,
+                                const size_t sharedInfoLength,
+                                unsigned char *const output,
+                                const size_t outputLength)
+{
+    assert(z != NULL);
+    assert((sharedInfo != NULL) || (sharedInfoLength == 0));
+    assert((output != NULL) || (outputLength == 0));
+
+    unsigned char digest[SHATK_SHA256_DIGEST_LENGTH];
+    uint32_t counter = 1;
+
+    for (size_t offset = 0; offset < outputLength; offset += SHATK_SHA256_DIGEST_LENGTH, counter++)
+    {
+        const unsigned char counterBytes[4] = {(unsigned char)(counter >> 24),
+                                               (unsigned char)(counter >> 16),
+                                               (unsigned char)(counter >> 8),
+                                               (unsigned char)(counter)};
+        SHATK_SHA256_CONTEXT context;
+
+        shatk_sha256Initialize(&context);
+        shatk_sha256Update(&context,
+                           z,
+                           zLength);
+        shatk_sha256Update(&context,
+                           counterBytes,
+                           sizeof(counterBytes));
+        shatk_sha256Update(&context,
+                           sharedInfo,
+                           sharedInfoLength);
+        shatk_sha256Final(&context,
+                          digest);
+
+        memcpy(&output[offset],
+               digest,
+               ((outputLength - offset) < SHATK_SHA256_DIGEST_LENGTH) ? (outputLength - offset) : SHATK_SHA256_DIGEST_LENGTH);
+    }
+}
@@ -0,0 +1,55 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __KDF_TOOLKIT_H__
+#define __KDF_TOOLKIT_H__
+
+#include <stddef.h>
+
+/*
+ * Definitions
+ *
+ * Input strings of the generic 3GPP key derivation function (TS 33.220,
+ * annex B.2): S = FC || P0 || L0 || P1 || L1 || ... || Pn || Ln, the key
+ * derivation itself being HMAC-SHA-256(Key, S).
+ */
+#define KDFTK_OUTPUT_LENGTH 32
+
+// TS 33.501, annex A.
+#define KDFTK_FC__KAUSF 0x6A
+#define KDFTK_FC__XRES_STAR 0x6B
+#define KDFTK_FC__KSEAF 0x6C
+
+// TS 33.402, annex A.2 (RFC 5448, 3.3).
+#define KDFTK_FC__CK_IK_PRIME 0x20
+
+/*
+ * Interface
+ */
+
+// Returns the length of S, or 0 if 'output' is too small or if a parameter
+// is longer than 65535 bytes.
+size_t kdftk_buildInput(const unsigned char fc,
+                        const unsigned char *const *const parameters,
+                        const size_t *const parametersLengths,
+                        const size_t parametersCount,
+                        unsigned char *const output,
+                        const size_t outputSize);
+
+// ANSI X9.63 key derivation function with SHA-256 (SEC 1, 3.6.1), as used
+// by ECIES: K = SHA-256(Z || 00000001 || SharedInfo) || SHA-256(Z ||
+// 00000002 || SharedInfo) || ...
+void kdftk_deriveWithX963Sha256(const unsigned char *const z,
+                                const size_t zLength,
+                                const unsigned char *const sharedInfo,
+                                const size_t sharedInfoLength,
+                                unsigned char *const output,
+                                const size_t outputLength);
+
+#endif /* __KDF_TOOLKIT_H__ */
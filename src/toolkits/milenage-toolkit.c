@@ -0,0 +1,628 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "aes-toolkit.h"
+#include "milenage-toolkit.h"
+
+#define MLNTK_BLOCK_LENGTH AESTK_BLOCK_LENGTH
+
+// Default constants (TS 35.206, 4.1).
+static const unsigned char MLNTK_DEFAULT_RC[MLNTK_RC_LENGTH] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // C1
+                                                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, // C2
+                                                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, // C3
+                                                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, // C4
+                                                                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, // C5
+                                                                0x40,                                                                                           // R1
+                                                                0x00,                                                                                           // R2
+                                                                0x20,                                                                                           // R3
+                                                                0x40,                                                                                           // R4
+                                                                0x60};                                                                                          // R5
+
+// Computes the block encrypted for OUTn, i.e. rot(input xor OPc, rn) xor cn,
+// with n in [1..5] ('temp' being added for OUT1 only).
+static void mlntk_computeOutputBlock(const unsigned char opc[MLNTK_OPC_LENGTH],
+                                     const unsigned char *const rc,
+                                     const unsigned char temp[MLNTK_BLOCK_LENGTH],
+                                     const unsigned char input[MLNTK_BLOCK_LENGTH],
+                                     const int n,
+                                     unsigned char block[MLNTK_BLOCK_LENGTH])
+{
+    assert((n >= 1) && (n <= 5));
+
+    const unsigned char *const c = &rc[(n - 1) * MLNTK_BLOCK_LENGTH];
+    const size_t rotation = (size_t)((rc[(5 * MLNTK_BLOCK_LENGTH) + (n - 1)] / 8) % MLNTK_BLOCK_LENGTH);
+    unsigned char values[2 * MLNTK_BLOCK_LENGTH];
+
+    // Note: only byte-aligned rotations (as the default ones) are supported.
+    assert((rc[(5 * MLNTK_BLOCK_LENGTH) + (n - 1)] % 8) == 0);
+
+    // The rotation is read from the value written twice, so that the loops
+    // are free of modulos (hence vectorized).
+    for (int index = 0; index < MLNTK_BLOCK_LENGTH; index++)
+    {
+        values[index] = input[index] ^ opc[index];
+        values[MLNTK_BLOCK_LENGTH + index] = values[index];
+    }
+
+    memcpy(block,
+           &values[rotation],
+           MLNTK_BLOCK_LENGTH);
+
+    for (int index = 0; index < MLNTK_BLOCK_LENGTH; index++)
+    {
+        block[index] ^= c[index];
+    }
+
+    if (temp != NULL)
+    {
+        for (int index = 0; index < MLNTK_BLOCK_LENGTH; index++)
+        {
+            block[index] ^= temp[index];
+        }
+    }
+}
+
+// Computes OUTn = E[rot(input xor OPc, rn) xor cn]K xor OPc, with n in [1..5].
+static void mlntk_computeOutput(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                                const unsigned char opc[MLNTK_OPC_LENGTH],
+                                const unsigned char *const rc,
+                                const unsigned char temp[MLNTK_BLOCK_LENGTH],
+                                const unsigned char input[MLNTK_BLOCK_LENGTH],
+                                const int n,
+                                unsigned char output[MLNTK_BLOCK_LENGTH])
+{
+    unsigned char block[MLNTK_BLOCK_LENGTH];
+
+    mlntk_computeOutputBlock(opc,
+                             rc,
+                             temp,
+                             input,
+                             n,
+                             block);
+
+    aestk_encryptBlock128(pKeySchedule,
+                          block,
+                          output);
+
+    for (int index = 0; index < MLNTK_BLOCK_LENGTH; index++)
+    {
+        output[index] ^= opc[index];
+    }
+}
+
+// Computes OUTn for each buffer, the blocks of the buffers being encrypted
+// together. 'inputs' is NULL to use TEMP as input (n > 1).
+static void mlntk_computeBuffersOutputs(const AESTK_128_BUFFERS_KEY_SCHEDULE *const pKeySchedule,
+                                        const size_t buffersCount,
+                                        const unsigned char *const opcs,
+                                        const unsigned char *const rc,
+                                        const unsigned char *const temps,
+                                        const unsigned char *const inputs,
+                                        const int n,
+                                        unsigned char *const outputs)
+{
+    unsigned char blocks[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_BLOCK_LENGTH];
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        const size_t offset = buffer * MLNTK_BLOCK_LENGTH;
+
+        mlntk_computeOutputBlock(&opcs[offset],
+                                 rc,
+                                 (inputs != NULL) ? &temps[offset] : NULL,
+                                 (inputs != NULL) ? &inputs[offset] : &temps[offset],
+                                 n,
+                                 &blocks[offset]);
+    }
+
+    aestk_encryptBuffers128(pKeySchedule,
+                            buffersCount,
+                            blocks,
+                            outputs);
+
+    for (size_t index = 0; index < (buffersCount * MLNTK_BLOCK_LENGTH); index++)
+    {
+        outputs[index] ^= opcs[index];
+    }
+}
+
+// Computes TEMP = E[RAND xor OPc]K.
+static void mlntk_computeTemp(const AESTK_128_KEY_SCHEDULE *const pKeySchedule,
+                              const unsigned char opc[MLNTK_OPC_LENGTH],
+                              const unsigned char rand[MLNTK_RAND_LENGTH],
+                              unsigned char temp[MLNTK_BLOCK_LENGTH])
+{
+    unsigned char block[MLNTK_BLOCK_LENGTH];
+
+    for (int index = 0; index < MLNTK_BLOCK_LENGTH; index++)
+    {
+        block[index] = rand[index] ^ opc[index];
+    }
+
+    aestk_encryptBlock128(pKeySchedule,
+                          block,
+                          temp);
+}
+
+// Computes OUT1, that holds MAC-A (first half) and MAC-S (second half).
+static void mlntk_computeOutput1(const unsigned char ki[MLNTK_KI_LENGTH],
+                                 const unsigned char opc[MLNTK_OPC_LENGTH],
+                                 const unsigned char *const rc,
+                                 const unsigned char rand[MLNTK_RAND_LENGTH],
+                                 const unsigned char sqn[MLNTK_SQN_LENGTH],
+                                 const unsigned char amf[MLNTK_AMF_LENGTH],
+                                 unsigned char output[MLNTK_BLOCK_LENGTH])
+{
+    assert(ki != NULL);
+    assert(opc != NULL);
+    assert(rand != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(output != NULL);
+
+    AESTK_128_KEY_SCHEDULE keySchedule;
+    unsigned char temp[MLNTK_BLOCK_LENGTH];
+    unsigned char input[MLNTK_BLOCK_LENGTH];
+
+    aestk_expandKey128(ki,
+                       &keySchedule);
+
+    mlntk_computeTemp(&keySchedule,
+                      opc,
+                      rand,
+                      temp);
+
+    // IN1 = SQN || AMF || SQN || AMF.
+    memcpy(&input[0], sqn, MLNTK_SQN_LENGTH);
+    memcpy(&input[MLNTK_SQN_LENGTH], amf, MLNTK_AMF_LENGTH);
+    memcpy(&input[8], sqn, MLNTK_SQN_LENGTH);
+    memcpy(&input[8 + MLNTK_SQN_LENGTH], amf, MLNTK_AMF_LENGTH);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        (rc != NULL ? rc : MLNTK_DEFAULT_RC),
+                        temp,
+                        input,
+                        1,
+                        output);
+}
+
+void mlntk_computeOpc(const unsigned char ki[MLNTK_KI_LENGTH],
+                      const unsigned char op[MLNTK_OP_LENGTH],
+                      unsigned char opc[MLNTK_OPC_LENGTH])
+{
+    assert(ki != NULL);
+    assert(op != NULL);
+    assert(opc != NULL);
+
+    AESTK_128_KEY_SCHEDULE keySchedule;
+
+    aestk_expandKey128(ki,
+                       &keySchedule);
+
+    aestk_encryptBlock128(&keySchedule,
+                          op,
+                          opc);
+
+    for (int index = 0; index < MLNTK_OPC_LENGTH; index++)
+    {
+        opc[index] ^= op[index];
+    }
+}
+
+void mlntk_f1(const unsigned char ki[MLNTK_KI_LENGTH],
+              const unsigned char opc[MLNTK_OPC_LENGTH],
+              const unsigned char *const rc,
+              const unsigned char rand[MLNTK_RAND_LENGTH],
+              const unsigned char sqn[MLNTK_SQN_LENGTH],
+              const unsigned char amf[MLNTK_AMF_LENGTH],
+              unsigned char macA[MLNTK_MAC_LENGTH])
+{
+    assert(macA != NULL);
+
+    unsigned char output[MLNTK_BLOCK_LENGTH];
+
+    mlntk_computeOutput1(ki,
+                         opc,
+                         rc,
+                         rand,
+                         sqn,
+                         amf,
+                         output);
+
+    memcpy(macA,
+           &output[0],
+           MLNTK_MAC_LENGTH);
+}
+
+void mlntk_f1Star(const unsigned char ki[MLNTK_KI_LENGTH],
+                  const unsigned char opc[MLNTK_OPC_LENGTH],
+                  const unsigned char *const rc,
+                  const unsigned char rand[MLNTK_RAND_LENGTH],
+                  const unsigned char sqn[MLNTK_SQN_LENGTH],
+                  const unsigned char amf[MLNTK_AMF_LENGTH],
+                  unsigned char macS[MLNTK_MAC_LENGTH])
+{
+    assert(macS != NULL);
+
+    unsigned char output[MLNTK_BLOCK_LENGTH];
+
+    mlntk_computeOutput1(ki,
+                         opc,
+                         rc,
+                         rand,
+                         sqn,
+                         amf,
+                         output);
+
+    memcpy(macS,
+           &output[MLNTK_MAC_LENGTH],
+           MLNTK_MAC_LENGTH);
+}
+
+void mlntk_f2345(const unsigned char ki[MLNTK_KI_LENGTH],
+                 const unsigned char opc[MLNTK_OPC_LENGTH],
+                 const unsigned char *const rc,
+                 const unsigned char rand[MLNTK_RAND_LENGTH],
+                 unsigned char res[MLNTK_RES_LENGTH],
+                 unsigned char ck[MLNTK_CK_LENGTH],
+                 unsigned char ik[MLNTK_IK_LENGTH],
+                 unsigned char ak[MLNTK_AK_LENGTH])
+{
+    assert(ki != NULL);
+    assert(opc != NULL);
+    assert(rand != NULL);
+    assert(res != NULL);
+    assert(ck != NULL);
+    assert(ik != NULL);
+    assert(ak != NULL);
+
+    const unsigned char *const constants = (rc != NULL ? rc : MLNTK_DEFAULT_RC);
+    AESTK_128_KEY_SCHEDULE keySchedule;
+    unsigned char temp[MLNTK_BLOCK_LENGTH];
+    unsigned char output[MLNTK_BLOCK_LENGTH];
+
+    aestk_expandKey128(ki,
+                       &keySchedule);
+
+    mlntk_computeTemp(&keySchedule,
+                      opc,
+                      rand,
+                      temp);
+
+    // OUT2 holds AK (first 48 bits) and RES (last 64 bits).
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        NULL,
+                        temp,
+                        2,
+                        output);
+
+    memcpy(ak,
+           &output[0],
+           MLNTK_AK_LENGTH);
+    memcpy(res,
+           &output[8],
+           MLNTK_RES_LENGTH);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        NULL,
+                        temp,
+                        3,
+                        ck);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        NULL,
+                        temp,
+                        4,
+                        ik);
+}
+
+void mlntk_f5Star(const unsigned char ki[MLNTK_KI_LENGTH],
+                  const unsigned char opc[MLNTK_OPC_LENGTH],
+                  const unsigned char *const rc,
+                  const unsigned char rand[MLNTK_RAND_LENGTH],
+                  unsigned char akStar[MLNTK_AK_LENGTH])
+{
+    assert(ki != NULL);
+    assert(opc != NULL);
+    assert(rand != NULL);
+    assert(akStar != NULL);
+
+    AESTK_128_KEY_SCHEDULE keySchedule;
+    unsigned char temp[MLNTK_BLOCK_LENGTH];
+    unsigned char output[MLNTK_BLOCK_LENGTH];
+
+    aestk_expandKey128(ki,
+                       &keySchedule);
+
+    mlntk_computeTemp(&keySchedule,
+                      opc,
+                      rand,
+                      temp);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        (rc != NULL ? rc : MLNTK_DEFAULT_RC),
+                        NULL,
+                        temp,
+                        5,
+                        output);
+
+    memcpy(akStar,
+           &output[0],
+           MLNTK_AK_LENGTH);
+}
+
+void mlntk_generateAuthenticationVector(const unsigned char ki[MLNTK_KI_LENGTH],
+                                        const unsigned char opc[MLNTK_OPC_LENGTH],
+                                        const unsigned char *const rc,
+                                        const unsigned char rand[MLNTK_RAND_LENGTH],
+                                        const unsigned char sqn[MLNTK_SQN_LENGTH],
+                                        const unsigned char amf[MLNTK_AMF_LENGTH],
+                                        unsigned char av[MLNTK_AV_LENGTH])
+{
+    assert(ki != NULL);
+    assert(opc != NULL);
+    assert(rand != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(av != NULL);
+
+    const unsigned char *const constants = (rc != NULL ? rc : MLNTK_DEFAULT_RC);
+    unsigned char *const xres = &av[MLNTK_RAND_LENGTH];
+    unsigned char *const ck = &xres[MLNTK_RES_LENGTH];
+    unsigned char *const ik = &ck[MLNTK_CK_LENGTH];
+    unsigned char *const autn = &ik[MLNTK_IK_LENGTH];
+    AESTK_128_KEY_SCHEDULE keySchedule;
+    unsigned char temp[MLNTK_BLOCK_LENGTH];
+    unsigned char input[MLNTK_BLOCK_LENGTH];
+    unsigned char output[MLNTK_BLOCK_LENGTH];
+
+    aestk_expandKey128(ki,
+                       &keySchedule);
+
+    memmove(av,
+            rand,
+            MLNTK_RAND_LENGTH);
+
+    mlntk_computeTemp(&keySchedule,
+                      opc,
+                      av,
+                      temp);
+
+    // OUT1 holds MAC-A (first half).
+    memcpy(&input[0], sqn, MLNTK_SQN_LENGTH);
+    memcpy(&input[MLNTK_SQN_LENGTH], amf, MLNTK_AMF_LENGTH);
+    memcpy(&input[8], sqn, MLNTK_SQN_LENGTH);
+    memcpy(&input[8 + MLNTK_SQN_LENGTH], amf, MLNTK_AMF_LENGTH);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        temp,
+                        input,
+                        1,
+                        output);
+
+    memcpy(&autn[MLNTK_SQN_LENGTH + MLNTK_AMF_LENGTH],
+           &output[0],
+           MLNTK_MAC_LENGTH);
+
+    // OUT2 holds AK (first 48 bits) and RES (last 64 bits).
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        NULL,
+                        temp,
+                        2,
+                        output);
+
+    memcpy(xres,
+           &output[8],
+           MLNTK_RES_LENGTH);
+
+    for (int index = 0; index < MLNTK_SQN_LENGTH; index++)
+    {
+        autn[index] = sqn[index] ^ output[index];
+    }
+
+    memcpy(&autn[MLNTK_SQN_LENGTH],
+           amf,
+           MLNTK_AMF_LENGTH);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        NULL,
+                        temp,
+                        3,
+                        ck);
+
+    mlntk_computeOutput(&keySchedule,
+                        opc,
+                        constants,
+                        NULL,
+                        temp,
+                        4,
+                        ik);
+}
+
+void mlntk_generateAuthenticationVectors(const size_t buffersCount,
+                                         const unsigned char *const kis,
+                                         const unsigned char *const ops,
+                                         unsigned char *const opcs,
+                                         const unsigned char *const rc,
+                                         const unsigned char sqn[MLNTK_SQN_LENGTH],
+                                         const unsigned char amf[MLNTK_AMF_LENGTH],
+                                         unsigned char *const avs)
+{
+    assert(buffersCount <= MLNTK_MAXIMUM_BUFFERS_COUNT);
+    assert(kis != NULL);
+    assert(opcs != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(avs != NULL);
+
+    const unsigned char *const constants = (rc != NULL ? rc : MLNTK_DEFAULT_RC);
+    AESTK_128_BUFFERS_KEY_SCHEDULE keySchedule;
+    unsigned char blocks[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_BLOCK_LENGTH];
+    unsigned char temps[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_BLOCK_LENGTH];
+    unsigned char inputs[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_BLOCK_LENGTH];
+    unsigned char outputs[MLNTK_MAXIMUM_BUFFERS_COUNT * MLNTK_BLOCK_LENGTH];
+
+    aestk_expandBuffersKeys128(buffersCount,
+                               kis,
+                               &keySchedule);
+
+    // OPc = E[OP]K xor OP.
+    if (ops != NULL)
+    {
+        aestk_encryptBuffers128(&keySchedule,
+                                buffersCount,
+                                ops,
+                                opcs);
+
+        for (size_t index = 0; index < (buffersCount * MLNTK_OPC_LENGTH); index++)
+        {
+            opcs[index] ^= ops[index];
+        }
+    }
+
+    // TEMP = E[RAND xor OPc]K, and IN1 = SQN || AMF || SQN || AMF.
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        const unsigned char *const rand = &avs[buffer * MLNTK_AV_LENGTH];
+        unsigned char *const input = &inputs[buffer * MLNTK_BLOCK_LENGTH];
+
+        for (int index = 0; index < MLNTK_BLOCK_LENGTH; index++)
+        {
+            blocks[(buffer * MLNTK_BLOCK_LENGTH) + (size_t)index] = rand[index] ^ opcs[(buffer * MLNTK_OPC_LENGTH) + (size_t)index];
+        }
+
+        memcpy(&input[0], sqn, MLNTK_SQN_LENGTH);
+        memcpy(&input[MLNTK_SQN_LENGTH], amf, MLNTK_AMF_LENGTH);
+        memcpy(&input[8], sqn, MLNTK_SQN_LENGTH);
+        memcpy(&input[8 + MLNTK_SQN_LENGTH], amf, MLNTK_AMF_LENGTH);
+    }
+
+    aestk_encryptBuffers128(&keySchedule,
+                            buffersCount,
+                            blocks,
+                            temps);
+
+    // OUT1 holds MAC-A (first half).
+    mlntk_computeBuffersOutputs(&keySchedule,
+                                buffersCount,
+                                opcs,
+                                constants,
+                                temps,
+                                inputs,
+                                1,
+                                outputs);
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        memcpy(&avs[(buffer * MLNTK_AV_LENGTH) + MLNTK_AV_LENGTH - MLNTK_MAC_LENGTH],
+               &outputs[buffer * MLNTK_BLOCK_LENGTH],
+               MLNTK_MAC_LENGTH);
+    }
+
+    // OUT2 holds AK (first 48 bits) and RES (last 64 bits).
+    mlntk_computeBuffersOutputs(&keySchedule,
+                                buffersCount,
+                                opcs,
+                                constants,
+                                temps,
+                                NULL,
+                                2,
+                                outputs);
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        unsigned char *const xres = &avs[(buffer * MLNTK_AV_LENGTH) + MLNTK_RAND_LENGTH];
+        unsigned char *const autn = &xres[MLNTK_RES_LENGTH + MLNTK_CK_LENGTH + MLNTK_IK_LENGTH];
+        const unsigned char *const output = &outputs[buffer * MLNTK_BLOCK_LENGTH];
+
+        memcpy(xres,
+               &output[8],
+               MLNTK_RES_LENGTH);
+
+        for (int index = 0; index < MLNTK_SQN_LENGTH; index++)
+        {
+            autn[index] = sqn[index] ^ output[index];
+        }
+
+        memcpy(&autn[MLNTK_SQN_LENGTH],
+               amf,
+               MLNTK_AMF_LENGTH);
+    }
+
+    // OUT3 is CK and OUT4 is IK.
+    for (int n = 3; n <= 4; n++)
+    {
+        mlntk_computeBuffersOutputs(&keySchedule,
+                                    buffersCount,
+                                    opcs,
+                                    constants,
+                                    temps,
+                                    NULL,
+                                    n,
+                                    outputs);
+
+        for (size_t buffer = 0; buffer < buffersCount; buffer++)
+        {
+            memcpy(&avs[(buffer * MLNTK_AV_LENGTH) + MLNTK_RAND_LENGTH + MLNTK_RES_LENGTH + ((n == 3) ? 0 : MLNTK_CK_LENGTH)],
+                   &outputs[buffer * MLNTK_BLOCK_LENGTH],
+                   MLNTK_BLOCK_LENGTH);
+        }
+    }
+}
+
+void mlntk_generateAuts(const unsigned char ki[MLNTK_KI_LENGTH],
+                        const unsigned char opc[MLNTK_OPC_LENGTH],
+                        const unsigned char *const rc,
+                        const unsigned char rand[MLNTK_RAND_LENGTH],
+                        const unsigned char sqnMs[MLNTK_SQN_LENGTH],
+                        unsigned char auts[MLNTK_AUTS_LENGTH])
+{
+    assert(sqnMs != NULL);
+    assert(auts != NULL);
+
+    // The AMF used for MAC-S is a dummy all-zero value (TS 33.102, 6.3.3).
+    const unsigned char dummyAmf[MLNTK_AMF_LENGTH] = {0x00, 0x00};
+    unsigned char akStar[MLNTK_AK_LENGTH];
+
+    mlntk_f5Star(ki,
+                 opc,
+                 rc,
+                 rand,
+                 akStar);
+
+    for (int index = 0; index < MLNTK_SQN_LENGTH; index++)
+    {
+        auts[index] = sqnMs[index] ^ akStar[index];
+    }
+
+    mlntk_f1Star(ki,
+                 opc,
+                 rc,
+                 rand,
+                 sqnMs,
+                 dummyAmf,
+                 &auts[MLNTK_SQN_LENGTH]);
+}
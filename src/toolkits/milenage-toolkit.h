@@ -0,0 +1,122 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __MILENAGE_TOOLKIT_H__
+#define __MILENAGE_TOOLKIT_H__
+
+#include <stddef.h>
+
+#include "aes-toolkit.h"
+
+/*
+ * Definitions
+ *
+ * Software implementation of the Milenage algorithm set (3GPP TS 35.206).
+ */
+#define MLNTK_KI_LENGTH 16
+#define MLNTK_OP_LENGTH 16
+#define MLNTK_OPC_LENGTH 16
+#define MLNTK_RAND_LENGTH 16
+#define MLNTK_SQN_LENGTH 6
+#define MLNTK_AMF_LENGTH 2
+#define MLNTK_MAC_LENGTH 8
+#define MLNTK_RES_LENGTH 8
+#define MLNTK_CK_LENGTH 16
+#define MLNTK_IK_LENGTH 16
+#define MLNTK_AK_LENGTH 6
+#define MLNTK_AUTS_LENGTH (MLNTK_SQN_LENGTH + MLNTK_MAC_LENGTH)
+#define MLNTK_AUTN_LENGTH (MLNTK_SQN_LENGTH + MLNTK_AMF_LENGTH + MLNTK_MAC_LENGTH)
+
+// RAND || XRES || CK || IK || AUTN, as returned by the Luna CKM_MILENAGE
+// mechanism.
+#define MLNTK_AV_LENGTH (MLNTK_RAND_LENGTH + MLNTK_RES_LENGTH + MLNTK_CK_LENGTH + MLNTK_IK_LENGTH + MLNTK_AUTN_LENGTH)
+
+// Maximum number of authentication vectors generated together by
+// mlntk_generateAuthenticationVectors().
+#define MLNTK_MAXIMUM_BUFFERS_COUNT AESTK_MAXIMUM_BUFFERS_COUNT
+
+// C1..C5 (16 bytes each) followed by R1..R5 (1 byte each, in bits).
+#define MLNTK_RC_LENGTH ((5 * 16) + 5)
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - All the functions accept a NULL 'rc' to use the default constants
+ *     of TS 35.206.
+ */
+void mlntk_computeOpc(const unsigned char ki[MLNTK_KI_LENGTH],
+                      const unsigned char op[MLNTK_OP_LENGTH],
+                      unsigned char opc[MLNTK_OPC_LENGTH]);
+
+void mlntk_f1(const unsigned char ki[MLNTK_KI_LENGTH],
+              const unsigned char opc[MLNTK_OPC_LENGTH],
+              const unsigned char *const rc,
+              const unsigned char rand[MLNTK_RAND_LENGTH],
+              const unsigned char sqn[MLNTK_SQN_LENGTH],
+              const unsigned char amf[MLNTK_AMF_LENGTH],
+              unsigned char macA[MLNTK_MAC_LENGTH]);
+
+void mlntk_f1Star(const unsigned char ki[MLNTK_KI_LENGTH],
+                  const unsigned char opc[MLNTK_OPC_LENGTH],
+                  const unsigned char *const rc,
+                  const unsigned char rand[MLNTK_RAND_LENGTH],
+                  const unsigned char sqn[MLNTK_SQN_LENGTH],
+                  const unsigned char amf[MLNTK_AMF_LENGTH],
+                  unsigned char macS[MLNTK_MAC_LENGTH]);
+
+void mlntk_f2345(const unsigned char ki[MLNTK_KI_LENGTH],
+                 const unsigned char opc[MLNTK_OPC_LENGTH],
+                 const unsigned char *const rc,
+                 const unsigned char rand[MLNTK_RAND_LENGTH],
+                 unsigned char res[MLNTK_RES_LENGTH],
+                 unsigned char ck[MLNTK_CK_LENGTH],
+                 unsigned char ik[MLNTK_IK_LENGTH],
+                 unsigned char ak[MLNTK_AK_LENGTH]);
+
+void mlntk_f5Star(const unsigned char ki[MLNTK_KI_LENGTH],
+                  const unsigned char opc[MLNTK_OPC_LENGTH],
+                  const unsigned char *const rc,
+                  const unsigned char rand[MLNTK_RAND_LENGTH],
+                  unsigned char akStar[MLNTK_AK_LENGTH]);
+
+// AUTN = (SQN xor AK) || AMF || MAC-A (TS 33.102, 6.3.2). The key is
+// expanded and TEMP computed once for all the functions.
+void mlntk_generateAuthenticationVector(const unsigned char ki[MLNTK_KI_LENGTH],
+                                        const unsigned char opc[MLNTK_OPC_LENGTH],
+                                        const unsigned char *const rc,
+                                        const unsigned char rand[MLNTK_RAND_LENGTH],
+                                        const unsigned char sqn[MLNTK_SQN_LENGTH],
+                                        const unsigned char amf[MLNTK_AMF_LENGTH],
+                                        unsigned char av[MLNTK_AV_LENGTH]);
+
+// Multi-buffer version of mlntk_generateAuthenticationVector(): the AES
+// blocks of the buffers (one per subscriber, with its own Ki and OPc) are
+// encrypted together (see aestk_encryptBuffers128()). The Ki, OP and OPc of
+// the buffers are stored one after the other, as are their authentication
+// vectors, that hold the RAND of each buffer on input. When 'ops' is not
+// NULL, the OPc of each buffer is first computed into 'opcs'.
+void mlntk_generateAuthenticationVectors(const size_t buffersCount,
+                                         const unsigned char *const kis,
+                                         const unsigned char *const ops,
+                                         unsigned char *const opcs,
+                                         const unsigned char *const rc,
+                                         const unsigned char sqn[MLNTK_SQN_LENGTH],
+                                         const unsigned char amf[MLNTK_AMF_LENGTH],
+                                         unsigned char *const avs);
+
+// AUTS = (SQN_MS xor AK*) || MAC-S, as built by the USIM (TS 33.102, 6.3.3).
+void mlntk_generateAuts(const unsigned char ki[MLNTK_KI_LENGTH],
+                        const unsigned char opc[MLNTK_OPC_LENGTH],
+                        const unsigned char *const rc,
+                        const unsigned char rand[MLNTK_RAND_LENGTH],
+                        const unsigned char sqnMs[MLNTK_SQN_LENGTH],
+                        unsigned char auts[MLNTK_AUTS_LENGTH]);
+
+#endif /* __MILENAGE_TOOLKIT_H__ */
@@ -13,6 +13,7 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -36,6 +37,28 @@ void copyArraySafely(const char *const source,
            sourceLength);
 }
 
+void formatEpochMilliSeconds(const unsigned long long epochMilliSeconds,
+                             char buffer[EPOCH_MILLI_SECONDS_STRING_LENGTH])
+{
+    assert(buffer != NULL);
+
+    const time_t epochSeconds = (time_t)(epochMilliSeconds / 1000ULL);
+    struct tm localTime = {0};
+
+    localtime_r(&epochSeconds,
+                &localTime);
+
+    const size_t length = strftime(buffer,
+                                   EPOCH_MILLI_SECONDS_STRING_LENGTH,
+                                   "%Y-%m-%d %H:%M:%S",
+                                   &localTime);
+
+    snprintf(&buffer[length],
+             EPOCH_MILLI_SECONDS_STRING_LENGTH - length,
+             ".%03u",
+             (unsigned int)(epochMilliSeconds % 1000ULL));
+}
+
 const char *getBooleanString(const int value)
 {
     if (value)
@@ -91,6 +114,88 @@ unsigned long long getElapsedTime(const struct timeval begin,
     }
 }
 
+unsigned long long getEpochMilliSeconds()
+{
+    struct timespec now = {0};
+
+    clock_gettime(CLOCK_REALTIME,
+                  &now);
+
+    return ((unsigned long long)now.tv_sec * 1000ULL) + ((unsigned long long)now.tv_nsec / 1000000ULL);
+}
+
+int getProcessMemory(PROCESS_MEMORY *const pProcessMemory)
+{
+    assert(pProcessMemory != NULL);
+
+    FILE *const file = fopen("/proc/self/status",
+                             "r");
+    char line[256] = {0};
+    int fieldsCount = 0;
+
+    if (file == NULL)
+    {
+        return 0;
+    }
+
+    memset(pProcessMemory,
+           0,
+           sizeof(PROCESS_MEMORY));
+
+    // Lines such as 'VmRSS:     1234 kB'.
+    while (fgets(line,
+                 sizeof(line),
+                 file) != NULL)
+    {
+        unsigned long *pField = NULL;
+        const char *pValue = strchr(line,
+                                    ':');
+
+        if (pValue == NULL)
+        {
+            continue;
+        }
+
+        if (strncmp(line,
+                    "VmRSS:",
+                    6) == 0)
+        {
+            pField = &pProcessMemory->residentKiB;
+        }
+        else if (strncmp(line,
+                         "VmHWM:",
+                         6) == 0)
+        {
+            pField = &pProcessMemory->peakResidentKiB;
+        }
+        else if (strncmp(line,
+                         "VmSize:",
+                         7) == 0)
+        {
+            pField = &pProcessMemory->virtualKiB;
+        }
+        else if (strncmp(line,
+                         "Threads:",
+                         8) == 0)
+        {
+            pField = &pProcessMemory->threadsCount;
+        }
+        else
+        {
+            continue;
+        }
+
+        *pField = strtoul(pValue + 1,
+                          NULL,
+                          10);
+        fieldsCount++;
+    }
+
+    fclose(file);
+
+    return fieldsCount == 4;
+}
+
 void *mallocAndReset(const size_t size)
 {
     void *result = malloc(size);
@@ -127,6 +232,22 @@ void printCurrentTime(const char *const title)
             currentTimeBuffer);
 }
 
+void sleepUntil(const unsigned long long epochMilliSeconds)
+{
+    struct timespec instant = {0};
+
+    instant.tv_sec = (time_t)(epochMilliSeconds / 1000ULL);
+    instant.tv_nsec = (long)((epochMilliSeconds % 1000ULL) * 1000000ULL);
+
+    while (clock_nanosleep(CLOCK_REALTIME,
+                           TIMER_ABSTIME,
+                           &instant,
+                           NULL) == EINTR)
+    {
+        // Nothing else to do here.
+    }
+}
+
 void writeBinaryData(const char *const title,
                      const unsigned char *const binaryData,
                      const size_t binaryDataLength)
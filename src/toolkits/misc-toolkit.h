@@ -23,11 +23,27 @@
 #define CLEAR_ARRAY(array) memset(array, 0, GET_ARRAY_SIZE(array))
 #define CLEAR_BUFFER(buffer, size) memset(buffer, 0, size)
 
+// E.g. '2023-06-01 12:34:56.789' (see 'formatEpochMilliSeconds').
+#define EPOCH_MILLI_SECONDS_STRING_LENGTH 24
+
+// Memory of the process, in KiB (see '/proc/self/status').
+typedef struct
+{
+    unsigned long residentKiB;
+    unsigned long peakResidentKiB;
+    unsigned long virtualKiB;
+    unsigned long threadsCount;
+} PROCESS_MEMORY;
+
 void copyArraySafely(const char *const source,
                      const size_t sourceLength,
                      char *const destination,
                      const size_t destinationLength);
 
+// In local time, with the milli-seconds.
+void formatEpochMilliSeconds(const unsigned long long epochMilliSeconds,
+                             char buffer[EPOCH_MILLI_SECONDS_STRING_LENGTH]);
+
 const char *getBooleanString(const int value);
 
 unsigned long getChecksum(const char *const buffer,
@@ -38,10 +54,19 @@ time_t getCurrentTime(void);
 unsigned long long getElapsedTime(const struct timeval begin,
                                   const struct timeval end);
 
+// CLOCK_REALTIME, in milli-seconds since the Epoch.
+unsigned long long getEpochMilliSeconds(void);
+
+// Returns 0 if the memory of the process cannot be read.
+int getProcessMemory(PROCESS_MEMORY *const pProcessMemory);
+
 void *mallocAndReset(const size_t size);
 
 void printCurrentTime(const char *const title);
 
+// Returns immediately if the instant is already passed.
+void sleepUntil(const unsigned long long epochMilliSeconds);
+
 void writeBinaryData(const char *const title,
                      const unsigned char *const binaryData,
                      const size_t binaryDataLength);
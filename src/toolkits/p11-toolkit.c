@@ -8,6 +8,7 @@
 \****************************************************************************/
 
 #include <assert.h>
+#include <dlfcn.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <stdio.h>
@@ -15,6 +16,7 @@
 #include <string.h>
 
 #include "p11-toolkit.h"
+#include "profiling-toolkit.h"
 
 #define LUNA_MODEL_VIRTUAL "LunaVirtual"
 #define MAXIMUM_SLOT_COUNT 100
@@ -22,6 +24,14 @@
 CK_BBOOL ckTrue = TRUE;
 CK_BBOOL ckFalse = FALSE;
 
+// Provider (see 'p11tk_loadProvider').
+typedef CK_RV (*P11TK_GET_FUNCTION_LIST)(CK_FUNCTION_LIST_PTR_PTR);
+typedef CK_RV (*P11TK_GET_CA_FUNCTION_LIST)(CK_SFNT_CA_FUNCTION_LIST_PTR_PTR);
+
+static void *p11tkProviderHandle = NULL;
+static CK_FUNCTION_LIST_PTR p11tkFunctionList = NULL;
+static CK_SFNT_CA_FUNCTION_LIST_PTR p11tkCaFunctionList = NULL;
+
 unsigned char P11_OIDS[] = {
     0x06, 0x05, 0x2B, 0x81, 0x04, 0x00, 0x06, /* [0] OID_secp112r1 */
     0x06, 0x05, 0x2B, 0x81, 0x04, 0x00, 0x07, /* [7] OID_secp112r2 */
@@ -223,7 +233,55 @@ CK_RV p11tk_closeSession(const CK_SESSION_HANDLE sessionHandle)
 {
     assert(sessionHandle != CK_INVALID_HANDLE);
 
-    return C_CloseSession(sessionHandle);
+    return p11tkFunctionList->C_CloseSession(sessionHandle);
+}
+
+CK_RV p11tk_createHmacKey(const CK_SESSION_HANDLE sessionHandle,
+                          const CK_BYTE *const keyValue,
+                          const CK_ULONG keyValueLength,
+                          CK_OBJECT_HANDLE *const pKeyHandle)
+{
+    assert(sessionHandle != CK_INVALID_HANDLE);
+    assert(keyValue != NULL);
+    assert(keyValueLength > 0);
+    assert(pKeyHandle != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    // Short-lived session object, only usable to produce HMACs.
+    CK_OBJECT_CLASS objectClass = CKO_SECRET_KEY;
+    CK_KEY_TYPE keyType = CKK_GENERIC_SECRET;
+    CK_ATTRIBUTE objectTemplate[] = {{CKA_CLASS, &objectClass, sizeof(objectClass)},
+                                     {CKA_KEY_TYPE, &keyType, sizeof(keyType)},
+                                     {CKA_VALUE, (CK_BYTE_PTR)keyValue, keyValueLength},
+
+                                     {CKA_TOKEN, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_PRIVATE, &ckTrue, sizeof(ckTrue)},
+                                     {CKA_MODIFIABLE, &ckFalse, sizeof(ckFalse)},
+
+                                     {CKA_SENSITIVE, &ckTrue, sizeof(ckTrue)},
+                                     {CKA_ENCRYPT, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_DECRYPT, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_DERIVE, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_SIGN, &ckTrue, sizeof(ckTrue)},
+                                     {CKA_VERIFY, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_WRAP, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_UNWRAP, &ckFalse, sizeof(ckFalse)},
+                                     {CKA_EXTRACTABLE, &ckFalse, sizeof(ckFalse)}};
+
+    rv = p11tkFunctionList->C_CreateObject(sessionHandle,
+                                           objectTemplate,
+                                           GET_ARRAY_SIZE(objectTemplate),
+                                           pKeyHandle);
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "p11tk_createHmacKey()/C_CreateObject() failed with error '0x%08lx'.\n",
+                rv);
+    }
+
+    return rv;
 }
 
 CK_RV p11tk_destroyObject(const CK_SESSION_HANDLE sessionHandle,
@@ -234,8 +292,8 @@ CK_RV p11tk_destroyObject(const CK_SESSION_HANDLE sessionHandle,
 
     CK_RV rv = CKR_OK;
 
-    rv = C_DestroyObject(sessionHandle,
-                         objectHandle);
+    rv = p11tkFunctionList->C_DestroyObject(sessionHandle,
+                                            objectHandle);
 
     if (rv != CKR_OK)
     {
@@ -285,9 +343,9 @@ CK_RV p11tk_destroyObjectsForObjectTemplate(const CK_SESSION_HANDLE sessionHandl
 
     CK_RV rv = CKR_OK;
 
-    rv = C_FindObjectsInit(sessionHandle,
-                           (CK_ATTRIBUTE_PTR)objectTemplate,
-                           objectTemplateSize);
+    rv = p11tkFunctionList->C_FindObjectsInit(sessionHandle,
+                                              (CK_ATTRIBUTE_PTR)objectTemplate,
+                                              objectTemplateSize);
 
     if (rv != CKR_OK)
     {
@@ -303,10 +361,10 @@ CK_RV p11tk_destroyObjectsForObjectTemplate(const CK_SESSION_HANDLE sessionHandl
 
     do
     {
-        rv = C_FindObjects(sessionHandle,
-                           foundObjectHandles,
-                           GET_ARRAY_SIZE(foundObjectHandles),
-                           &numberOfFoundObjects);
+        rv = p11tkFunctionList->C_FindObjects(sessionHandle,
+                                              foundObjectHandles,
+                                              GET_ARRAY_SIZE(foundObjectHandles),
+                                              &numberOfFoundObjects);
 
         if (rv != CKR_OK)
         {
@@ -344,6 +402,55 @@ EXIT:
     return rv;
 }
 
+CK_RV p11tk_digestWithSha256(const CK_SESSION_HANDLE sessionHandle,
+                             const CK_BYTE *const data,
+                             const CK_ULONG dataLength,
+                             CK_BYTE *const pDigest,
+                             CK_ULONG *const pDigestLength)
+{
+    assert(sessionHandle != CK_INVALID_HANDLE);
+    assert(data != NULL);
+    assert(dataLength > 0);
+    assert(pDigest != NULL);
+    assert(pDigestLength != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    CK_MECHANISM mechanism = {0};
+
+    mechanism.mechanism = CKM_SHA256;
+    mechanism.pParameter = NULL;
+    mechanism.ulParameterLen = (CK_ULONG)0;
+
+    rv = p11tkFunctionList->C_DigestInit(sessionHandle,
+                                         &mechanism);
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "p11tk_digestWithSha256()/C_DigestInit() failed with error '0x%08lx'.\n",
+                rv);
+
+        goto EXIT;
+    }
+
+    rv = p11tkFunctionList->C_Digest(sessionHandle,
+                                     (CK_BYTE_PTR)data,
+                                     dataLength,
+                                     (CK_BYTE_PTR)pDigest,
+                                     pDigestLength);
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "p11tk_digestWithSha256()/C_Digest() failed with error '0x%08lx'.\n",
+                rv);
+    }
+
+EXIT:
+    return rv;
+}
+
 CK_RV p11tk_encryptWithAesKwp(const CK_SESSION_HANDLE sessionHandle,
                               const CK_OBJECT_HANDLE encryptionKeyHandle,
                               const CK_BYTE *const data,
@@ -366,9 +473,9 @@ CK_RV p11tk_encryptWithAesKwp(const CK_SESSION_HANDLE sessionHandle,
     mechanism.pParameter = NULL;
     mechanism.ulParameterLen = (CK_ULONG)0;
 
-    rv = C_EncryptInit(sessionHandle,
-                       &mechanism,
-                       encryptionKeyHandle);
+    rv = p11tkFunctionList->C_EncryptInit(sessionHandle,
+                                          &mechanism,
+                                          encryptionKeyHandle);
 
     if (rv != CKR_OK)
     {
@@ -379,11 +486,11 @@ CK_RV p11tk_encryptWithAesKwp(const CK_SESSION_HANDLE sessionHandle,
         goto EXIT;
     }
 
-    rv = C_Encrypt(sessionHandle,
-                   (CK_BYTE_PTR)data,
-                   dataLength,
-                   (CK_BYTE_PTR)pEncryptedData,
-                   pEncryptedDataLength);
+    rv = p11tkFunctionList->C_Encrypt(sessionHandle,
+                                      (CK_BYTE_PTR)data,
+                                      dataLength,
+                                      (CK_BYTE_PTR)pEncryptedData,
+                                      pEncryptedDataLength);
 
     if (rv != CKR_OK)
     {
@@ -398,7 +505,7 @@ EXIT:
 
 CK_RV p11tk_finalizeClientLibrary()
 {
-    return C_Finalize(NULL);
+    return p11tkFunctionList->C_Finalize(NULL);
 }
 
 CK_RV p11tk_findObjectForLabel(const CK_SESSION_HANDLE sessionHandle,
@@ -416,9 +523,9 @@ CK_RV p11tk_findObjectForLabel(const CK_SESSION_HANDLE sessionHandle,
     CK_ATTRIBUTE objectTemplate[] = {{CKA_CLASS, &_objectClass, sizeof(_objectClass)},
                                      {CKA_LABEL, (CK_CHAR_PTR)objectLabel, (CK_ULONG)strlen((char *)objectLabel)}};
 
-    rv = C_FindObjectsInit(sessionHandle,
-                           objectTemplate,
-                           GET_ARRAY_SIZE(objectTemplate));
+    rv = p11tkFunctionList->C_FindObjectsInit(sessionHandle,
+                                              objectTemplate,
+                                              GET_ARRAY_SIZE(objectTemplate));
 
     if (rv != CKR_OK)
     {
@@ -431,10 +538,10 @@ CK_RV p11tk_findObjectForLabel(const CK_SESSION_HANDLE sessionHandle,
 
     CK_ULONG numberOfObjectsFound = 0;
 
-    rv = C_FindObjects(sessionHandle,
-                       pObjectHandle,
-                       1,
-                       &numberOfObjectsFound);
+    rv = p11tkFunctionList->C_FindObjects(sessionHandle,
+                                          pObjectHandle,
+                                          1,
+                                          &numberOfObjectsFound);
 
     if (rv != CKR_OK)
     {
@@ -472,9 +579,9 @@ CK_RV p11tk_findObjectForOuid(const CK_SESSION_HANDLE sessionHandle,
 
     CK_ATTRIBUTE attribute = {CKA_OUID, (CK_CHAR_PTR)ouid, (CK_ULONG)ouidLength};
 
-    rv = C_FindObjectsInit(sessionHandle,
-                           &attribute,
-                           1);
+    rv = p11tkFunctionList->C_FindObjectsInit(sessionHandle,
+                                              &attribute,
+                                              1);
 
     if (rv != CKR_OK)
     {
@@ -489,10 +596,10 @@ CK_RV p11tk_findObjectForOuid(const CK_SESSION_HANDLE sessionHandle,
 
     CK_ULONG numberOfObjectsFound = 0;
 
-    rv = C_FindObjects(sessionHandle,
-                       pObjectHandle,
-                       1,
-                       &numberOfObjectsFound);
+    rv = p11tkFunctionList->C_FindObjects(sessionHandle,
+                                          pObjectHandle,
+                                          1,
+                                          &numberOfObjectsFound);
 
     if (rv != CKR_OK)
     {
@@ -521,7 +628,7 @@ CK_RV p11tk_findObjectsFinal(const CK_SESSION_HANDLE sessionHandle)
 
     CK_RV rv = CKR_OK;
 
-    rv = C_FindObjectsFinal(sessionHandle);
+    rv = p11tkFunctionList->C_FindObjectsFinal(sessionHandle);
 
     if (rv != CKR_OK)
     {
@@ -607,14 +714,14 @@ CK_RV p11tk_generateEllipticKeyPair(const CK_SESSION_HANDLE sessionHandle,
                                                {CKA_SIGN, &ckTrue, sizeof(ckTrue)},
                                                {CKA_UNWRAP, &ckFalse, sizeof(ckFalse)}};
 
-    rv = C_GenerateKeyPair(sessionHandle,
-                           &mechanism,
-                           publicKeyObjectTemplate,
-                           GET_ARRAY_SIZE(publicKeyObjectTemplate),
-                           privateKeyObjectTemplate,
-                           GET_ARRAY_SIZE(privateKeyObjectTemplate),
-                           pPublicKeyHandle,
-                           pPrivateKeyHandle);
+    rv = p11tkFunctionList->C_GenerateKeyPair(sessionHandle,
+                                              &mechanism,
+                                              publicKeyObjectTemplate,
+                                              GET_ARRAY_SIZE(publicKeyObjectTemplate),
+                                              privateKeyObjectTemplate,
+                                              GET_ARRAY_SIZE(privateKeyObjectTemplate),
+                                              pPublicKeyHandle,
+                                              pPrivateKeyHandle);
 
     if (rv != CKR_OK)
     {
@@ -667,11 +774,11 @@ CK_RV p11tk_generateStorageKey(const CK_SESSION_HANDLE sessionHandle,
                                      {CKA_UNWRAP, &ckTrue, sizeof(ckTrue)},
                                      {CKA_EXTRACTABLE, &ckFalse, sizeof(ckFalse)}};
 
-    rv = C_GenerateKey(sessionHandle,
-                       &mechanism,
-                       objectTemplate,
-                       GET_ARRAY_SIZE(objectTemplate),
-                       pKeyHandle);
+    rv = p11tkFunctionList->C_GenerateKey(sessionHandle,
+                                          &mechanism,
+                                          objectTemplate,
+                                          GET_ARRAY_SIZE(objectTemplate),
+                                          pKeyHandle);
 
     if (rv != CKR_OK)
     {
@@ -774,12 +881,73 @@ CK_RV p11tk_getEllipticCurveDataWithOid(const unsigned char *const oid,
     return (*pEllipticCurveData == NULL ? CKR_GENERAL_ERROR : CKR_OK);
 }
 
+CK_RV p11tk_getEllipticCurvePoint(const CK_SESSION_HANDLE sessionHandle,
+                                  const CK_OBJECT_HANDLE publicKeyHandle,
+                                  CK_BYTE *const point,
+                                  const size_t pointLength)
+{
+    assert(sessionHandle != CK_INVALID_HANDLE);
+    assert(publicKeyHandle != CK_INVALID_HANDLE);
+    assert(point != NULL);
+    assert(pointLength < 0x80);
+
+    CK_RV rv = CKR_OK;
+
+    CK_BYTE value[0x80 + 2] = {0};
+    CK_ATTRIBUTE objectAttribute = {CKA_EC_POINT, value, (CK_ULONG)sizeof(value)};
+
+    rv = p11tkFunctionList->C_GetAttributeValue(sessionHandle,
+                                                publicKeyHandle,
+                                                &objectAttribute,
+                                                (CK_ULONG)1);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    // DER OCTET STRING (short form), as specified by PKCS#11.
+    if ((objectAttribute.usValueLen == (pointLength + 2)) &&
+        (value[0] == 0x04) &&
+        (value[1] == pointLength))
+    {
+        memcpy(point,
+               &value[2],
+               pointLength);
+    }
+    else if (objectAttribute.usValueLen == pointLength)
+    {
+        memcpy(point,
+               value,
+               pointLength);
+    }
+    else
+    {
+        rv = CKR_KEY_SIZE_RANGE;
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_FUNCTION_LIST_PTR p11tk_getFunctionList(void)
+{
+    assert(p11tkFunctionList != NULL);
+
+    return p11tkFunctionList;
+}
+
 CK_RV p11tk_getHaState(const GET_HA_STATE_ARGUMENTS *const pHaStateArguments)
 {
     assert(pHaStateArguments != NULL);
 
-    return CA_GetHAState(pHaStateArguments->slotId,
-                         (CK_HA_STATE_PTR) & (pHaStateArguments->haState));
+    if (p11tkCaFunctionList == NULL)
+    {
+        return CKR_FUNCTION_NOT_SUPPORTED;
+    }
+
+    return p11tkCaFunctionList->CA_GetHAState(pHaStateArguments->slotId,
+                                            (CK_HA_STATE_PTR) & (pHaStateArguments->haState));
 }
 
 CK_RV p11tk_getObjectUniqueIdentifier(const CK_SESSION_HANDLE sessionHandle,
@@ -796,10 +964,10 @@ CK_RV p11tk_getObjectUniqueIdentifier(const CK_SESSION_HANDLE sessionHandle,
 
     CK_ATTRIBUTE objectAttribute = {CKA_OUID, ouid, *pOuidLength};
 
-    rv = C_GetAttributeValue(sessionHandle,
-                             objectHandle,
-                             &objectAttribute,
-                             (CK_ULONG)1);
+    rv = p11tkFunctionList->C_GetAttributeValue(sessionHandle,
+                                                objectHandle,
+                                                &objectAttribute,
+                                                (CK_ULONG)1);
 
     *pOuidLength = objectAttribute.usValueLen;
 
@@ -811,8 +979,8 @@ CK_RV p11tk_getSlotInfo(const CK_SLOT_ID slotId,
 {
     assert(pSlotInfo != NULL);
 
-    return C_GetSlotInfo(slotId,
-                         (CK_SLOT_INFO_PTR)pSlotInfo);
+    return p11tkFunctionList->C_GetSlotInfo(slotId,
+                                            (CK_SLOT_INFO_PTR)pSlotInfo);
 }
 
 CK_RV p11tk_getSlotList(const CK_BBOOL isTokenPresent,
@@ -829,9 +997,9 @@ CK_RV p11tk_getSlotList(const CK_BBOOL isTokenPresent,
     // Get slot scenarioIdentifier list.
     CK_RV rv = CKR_OK;
 
-    rv = C_GetSlotList(isTokenPresent,
-                       NULL,
-                       pSlotCount);
+    rv = p11tkFunctionList->C_GetSlotList(isTokenPresent,
+                                          NULL,
+                                          pSlotCount);
 
     if (rv != CKR_OK)
     {
@@ -855,9 +1023,9 @@ CK_RV p11tk_getSlotList(const CK_BBOOL isTokenPresent,
 
     while (1)
     {
-        rv = C_GetSlotList(isTokenPresent,
-                           slotIdList,
-                           pSlotCount);
+        rv = p11tkFunctionList->C_GetSlotList(isTokenPresent,
+                                              slotIdList,
+                                              pSlotCount);
 
         if (rv == CKR_OK)
         {
@@ -945,13 +1113,102 @@ CK_RV p11tk_getTokenInfo(const CK_SLOT_ID slotId,
 {
     assert(pTokenInfo != NULL);
 
-    return C_GetTokenInfo(slotId,
-                          (CK_TOKEN_INFO_PTR)pTokenInfo);
+    return p11tkFunctionList->C_GetTokenInfo(slotId,
+                                             (CK_TOKEN_INFO_PTR)pTokenInfo);
 }
 
 CK_RV p11tk_initializeClientLibrary(const CK_C_INITIALIZE_ARGS *const pInitializeArguments)
 {
-    return C_Initialize((CK_VOID_PTR)pInitializeArguments);
+    assert(p11tkFunctionList != NULL);
+
+    return p11tkFunctionList->C_Initialize((CK_VOID_PTR)pInitializeArguments);
+}
+
+CK_RV p11tk_loadProvider(const char *const providerPath,
+                         const bool isProfiling)
+{
+    assert(providerPath != NULL);
+    assert(p11tkProviderHandle == NULL);
+
+    CK_RV rv = CKR_OK;
+    P11TK_GET_FUNCTION_LIST getFunctionList = NULL;
+    P11TK_GET_CA_FUNCTION_LIST getCaFunctionList = NULL;
+
+    p11tkProviderHandle = dlopen(providerPath,
+                                 RTLD_NOW | RTLD_LOCAL);
+
+    if (p11tkProviderHandle == NULL)
+    {
+        fprintf(stderr,
+                "p11tk_loadProvider()/dlopen() failed: '%s'.\n",
+                dlerror());
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    // Casting through a data pointer is the POSIX way to retrieve functions.
+    *(void **)&getFunctionList = dlsym(p11tkProviderHandle,
+                                       "C_GetFunctionList");
+
+    if (getFunctionList == NULL)
+    {
+        fprintf(stderr,
+                "p11tk_loadProvider()/dlsym() failed: '%s' does not provide 'C_GetFunctionList'.\n",
+                providerPath);
+
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    rv = getFunctionList(&p11tkFunctionList);
+
+    if ((rv == CKR_OK) &&
+        (p11tkFunctionList == NULL))
+    {
+        rv = CKR_GENERAL_ERROR;
+    }
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "p11tk_loadProvider()/C_GetFunctionList() failed with error '0x%08lx'.\n",
+                rv);
+
+        goto EXIT;
+    }
+
+    // The Luna extensions are optional: CA_GetHAState() and
+    // CA_GetFirmwareVersion() report CKR_FUNCTION_NOT_SUPPORTED without them.
+    *(void **)&getCaFunctionList = dlsym(p11tkProviderHandle,
+                                         "CA_GetFunctionList");
+
+    if ((getCaFunctionList != NULL) &&
+        (getCaFunctionList(&p11tkCaFunctionList) != CKR_OK))
+    {
+        p11tkCaFunctionList = NULL;
+    }
+
+    // Without profiling, the calls go straight to the provider.
+    if (isProfiling)
+    {
+        rv = proftk_enable(&p11tkFunctionList,
+                           &p11tkCaFunctionList);
+    }
+
+EXIT:
+    if ((rv != CKR_OK) &&
+        (p11tkProviderHandle != NULL))
+    {
+        dlclose(p11tkProviderHandle);
+
+        p11tkProviderHandle = NULL;
+        p11tkFunctionList = NULL;
+    }
+
+    return rv;
 }
 
 CK_RV p11tk_login(const CK_SESSION_HANDLE sessionHandle,
@@ -962,17 +1219,17 @@ CK_RV p11tk_login(const CK_SESSION_HANDLE sessionHandle,
     assert(password != NULL);
     assert(passwordLength > 0);
 
-    return C_Login(sessionHandle,
-                   CKU_USER,
-                   (CK_BYTE_PTR)password,
-                   passwordLength);
+    return p11tkFunctionList->C_Login(sessionHandle,
+                                      CKU_USER,
+                                      (CK_BYTE_PTR)password,
+                                      passwordLength);
 }
 
 CK_RV p11tk_logout(const CK_SESSION_HANDLE sessionHandle)
 {
     assert(sessionHandle != CK_INVALID_HANDLE);
 
-    return C_Logout(sessionHandle);
+    return p11tkFunctionList->C_Logout(sessionHandle);
 }
 
 CK_RV p11tk_openSession(const CK_SLOT_ID slotId,
@@ -980,11 +1237,11 @@ CK_RV p11tk_openSession(const CK_SLOT_ID slotId,
 {
     assert(pSessionHandle != CK_INVALID_HANDLE);
 
-    return C_OpenSession(slotId,
-                         CKF_SERIAL_SESSION | CKF_RW_SESSION,
-                         NULL,
-                         NULL,
-                         pSessionHandle);
+    return p11tkFunctionList->C_OpenSession(slotId,
+                                            CKF_SERIAL_SESSION | CKF_RW_SESSION,
+                                            NULL,
+                                            NULL,
+                                            pSessionHandle);
 }
 
 CK_RV p11tk_prepare(const CK_C_INITIALIZE_ARGS *const pInitializeArguments,
@@ -1268,10 +1525,15 @@ void p11tk_printSlotList(const SLOT_LIST slotList,
                     CK_ULONG firmwareMinorVersion;
                     CK_ULONG firmwareSubMinorVersion;
 
-                    rv = CA_GetFirmwareVersion(slotId,
-                                               &firmwareMajorVersion,
-                                               &firmwareMinorVersion,
-                                               &firmwareSubMinorVersion);
+                    rv = CKR_FUNCTION_NOT_SUPPORTED;
+
+                    if (p11tkCaFunctionList != NULL)
+                    {
+                        rv = p11tkCaFunctionList->CA_GetFirmwareVersion(slotId,
+                                                                        &firmwareMajorVersion,
+                                                                        &firmwareMinorVersion,
+                                                                        &firmwareSubMinorVersion);
+                    }
 
                     if (rv == CKR_OK)
                     {
@@ -1496,6 +1758,58 @@ void p11tk_printSlotListStateWithSlotList(const SLOT_LIST slotList,
     }
 }
 
+CK_RV p11tk_signWithHmacSha256(const CK_SESSION_HANDLE sessionHandle,
+                               const CK_OBJECT_HANDLE keyHandle,
+                               const CK_BYTE *const data,
+                               const CK_ULONG dataLength,
+                               CK_BYTE *const pSignature,
+                               CK_ULONG *const pSignatureLength)
+{
+    assert(sessionHandle != CK_INVALID_HANDLE);
+    assert(keyHandle != CK_INVALID_HANDLE);
+    assert(data != NULL);
+    assert(dataLength > 0);
+    assert(pSignature != NULL);
+    assert(pSignatureLength != NULL);
+
+    CK_RV rv = CKR_OK;
+
+    CK_MECHANISM mechanism = {0};
+
+    mechanism.mechanism = CKM_SHA256_HMAC;
+    mechanism.pParameter = NULL;
+    mechanism.ulParameterLen = (CK_ULONG)0;
+
+    rv = p11tkFunctionList->C_SignInit(sessionHandle,
+                                       &mechanism,
+                                       keyHandle);
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "p11tk_signWithHmacSha256()/C_SignInit() failed with error '0x%08lx'.\n",
+                rv);
+
+        goto EXIT;
+    }
+
+    rv = p11tkFunctionList->C_Sign(sessionHandle,
+                                   (CK_BYTE_PTR)data,
+                                   dataLength,
+                                   (CK_BYTE_PTR)pSignature,
+                                   pSignatureLength);
+
+    if (rv != CKR_OK)
+    {
+        fprintf(stderr,
+                "p11tk_signWithHmacSha256()/C_Sign() failed with error '0x%08lx'.\n",
+                rv);
+    }
+
+EXIT:
+    return rv;
+}
+
 CK_RV p11tk_terminate(const CK_SESSION_HANDLE sessionHandle)
 {
     assert(sessionHandle != CK_INVALID_HANDLE);
@@ -1571,14 +1885,14 @@ CK_RV p11tk_unwrapSensitiveData(const CK_SESSION_HANDLE sessionHandle,
                                      {CKA_UNWRAP, &ckFalse, sizeof(ckFalse)},
                                      {CKA_EXTRACTABLE, &ckFalse, sizeof(ckFalse)}};
 
-    rv = C_UnwrapKey(sessionHandle,
-                     &mechanism,
-                     encryptionKeyHandle,
-                     (CK_BYTE_PTR)encryptedKey,
-                     encryptedKeyLength,
-                     objectTemplate,
-                     GET_ARRAY_SIZE(objectTemplate),
-                     (CK_OBJECT_HANDLE_PTR)pUnwrappedKeyHandle);
+    rv = p11tkFunctionList->C_UnwrapKey(sessionHandle,
+                                        &mechanism,
+                                        encryptionKeyHandle,
+                                        (CK_BYTE_PTR)encryptedKey,
+                                        encryptedKeyLength,
+                                        objectTemplate,
+                                        GET_ARRAY_SIZE(objectTemplate),
+                                        (CK_OBJECT_HANDLE_PTR)pUnwrappedKeyHandle);
 
     if (rv != CKR_OK)
     {
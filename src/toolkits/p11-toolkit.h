@@ -21,6 +21,9 @@
  */
 #define P11TK_OUID_LENGTH 12
 
+// Default PKCS#11 provider, looked up by the dynamic linker.
+#define P11TK_DEFAULT_PROVIDER_PATH "libCryptoki2_64.so"
+
 // Slot.
 typedef struct _SLOT
 {
@@ -62,6 +65,11 @@ typedef struct _P11_ELLIPTIC_CURVES_LIST_ELEMENT
  */
 CK_RV p11tk_closeSession(const CK_SESSION_HANDLE sessionHandle);
 
+CK_RV p11tk_createHmacKey(const CK_SESSION_HANDLE sessionHandle,
+                          const CK_BYTE *const keyValue,
+                          const CK_ULONG keyValueLength,
+                          CK_OBJECT_HANDLE *const pKeyHandle);
+
 CK_RV p11tk_destroyObject(const CK_SESSION_HANDLE sessionHandle,
                           const CK_OBJECT_HANDLE objectHandle);
 
@@ -76,6 +84,12 @@ CK_RV p11tk_destroyObjectsForObjectTemplate(const CK_SESSION_HANDLE sessionHandl
                                             const CK_ATTRIBUTE *const objectTemplate,
                                             const size_t objectTemplateSize);
 
+CK_RV p11tk_digestWithSha256(const CK_SESSION_HANDLE sessionHandle,
+                             const CK_BYTE *const data,
+                             const CK_ULONG dataLength,
+                             CK_BYTE *const pDigest,
+                             CK_ULONG *const pDigestLength);
+
 CK_RV p11tk_encryptWithAesKwp(const CK_SESSION_HANDLE sessionHandle,
                               const CK_OBJECT_HANDLE encryptionKeyHandle,
                               const CK_BYTE *const data,
@@ -122,6 +136,17 @@ CK_RV p11tk_getEllipticCurveDataWithOid(const unsigned char *const oid,
                                         const size_t oidLength,
                                         const P11_ELLIPTIC_CURVES_LIST_ELEMENT **const pCurveData);
 
+// Retrieves the CKA_EC_POINT value of a public key, without its DER OCTET
+// STRING header if any. Returns CKR_KEY_SIZE_RANGE if the point length does
+// not match the expected one.
+CK_RV p11tk_getEllipticCurvePoint(const CK_SESSION_HANDLE sessionHandle,
+                                  const CK_OBJECT_HANDLE publicKeyHandle,
+                                  CK_BYTE *const point,
+                                  const size_t pointLength);
+
+// Returns the function list of the provider loaded by 'p11tk_loadProvider'.
+CK_FUNCTION_LIST_PTR p11tk_getFunctionList(void);
+
 CK_RV p11tk_getHaState(const GET_HA_STATE_ARGUMENTS *const pHaStateArguments);
 
 CK_RV p11tk_getObjectUniqueIdentifier(const CK_SESSION_HANDLE sessionHandle,
@@ -141,6 +166,13 @@ CK_RV p11tk_getTokenInfo(const CK_SLOT_ID slotId,
 
 CK_RV p11tk_initializeClientLibrary(const CK_C_INITIALIZE_ARGS *const pInitializeArguments);
 
+// Loads the PKCS#11 provider and retrieves its function lists, interposing
+// the profiling ones if requested (see 'profiling-toolkit.h'); must be
+// called once, before any other function of this toolkit. The provider is
+// never unloaded, as objects may still call it after finalization.
+CK_RV p11tk_loadProvider(const char *const providerPath,
+                         const bool isProfiling);
+
 CK_RV p11tk_login(const CK_SESSION_HANDLE sessionHandle,
                   const CK_CHAR *const password,
                   const CK_ULONG passwordLength);
@@ -170,6 +202,13 @@ CK_RV p11tk_printSlotListStateWithoutSlotList(void);
 void p11tk_printSlotListStateWithSlotList(const SLOT_LIST slotList,
                                           const CK_ULONG slotCount);
 
+CK_RV p11tk_signWithHmacSha256(const CK_SESSION_HANDLE sessionHandle,
+                               const CK_OBJECT_HANDLE keyHandle,
+                               const CK_BYTE *const data,
+                               const CK_ULONG dataLength,
+                               CK_BYTE *const pSignature,
+                               CK_ULONG *const pSignatureLength);
+
 CK_RV p11tk_terminate(const CK_SESSION_HANDLE sessionHandle);
 
 CK_RV p11tk_unwrapSensitiveData(const CK_SESSION_HANDLE sessionHandle,
@@ -0,0 +1,915 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "profiling-toolkit.h"
+
+typedef enum _PROFTK_FUNCTION
+{
+    PROFTK_FUNCTION_C_CLOSE_SESSION = 0,
+    PROFTK_FUNCTION_C_CREATE_OBJECT,
+    PROFTK_FUNCTION_C_DECRYPT,
+    PROFTK_FUNCTION_C_DECRYPT_INIT,
+    PROFTK_FUNCTION_C_DESTROY_OBJECT,
+    PROFTK_FUNCTION_C_DIGEST,
+    PROFTK_FUNCTION_C_DIGEST_INIT,
+    PROFTK_FUNCTION_C_ENCRYPT,
+    PROFTK_FUNCTION_C_ENCRYPT_INIT,
+    PROFTK_FUNCTION_C_FINALIZE,
+    PROFTK_FUNCTION_C_FIND_OBJECTS,
+    PROFTK_FUNCTION_C_FIND_OBJECTS_FINAL,
+    PROFTK_FUNCTION_C_FIND_OBJECTS_INIT,
+    PROFTK_FUNCTION_C_GENERATE_KEY,
+    PROFTK_FUNCTION_C_GENERATE_KEY_PAIR,
+    PROFTK_FUNCTION_C_GET_ATTRIBUTE_VALUE,
+    PROFTK_FUNCTION_C_GET_SLOT_INFO,
+    PROFTK_FUNCTION_C_GET_SLOT_LIST,
+    PROFTK_FUNCTION_C_GET_TOKEN_INFO,
+    PROFTK_FUNCTION_C_INITIALIZE,
+    PROFTK_FUNCTION_C_LOGIN,
+    PROFTK_FUNCTION_C_LOGOUT,
+    PROFTK_FUNCTION_C_OPEN_SESSION,
+    PROFTK_FUNCTION_C_SIGN,
+    PROFTK_FUNCTION_C_SIGN_INIT,
+    PROFTK_FUNCTION_C_UNWRAP_KEY,
+    PROFTK_FUNCTION_CA_GET_FIRMWARE_VERSION,
+    PROFTK_FUNCTION_CA_GET_HA_STATE,
+    PROFTK_FUNCTIONS_COUNT
+} PROFTK_FUNCTION;
+
+static const char *const PROFTK_FUNCTION_NAMES[PROFTK_FUNCTIONS_COUNT] = {"C_CloseSession",
+                                                                          "C_CreateObject",
+                                                                          "C_Decrypt",
+                                                                          "C_DecryptInit",
+                                                                          "C_DestroyObject",
+                                                                          "C_Digest",
+                                                                          "C_DigestInit",
+                                                                          "C_Encrypt",
+                                                                          "C_EncryptInit",
+                                                                          "C_Finalize",
+                                                                          "C_FindObjects",
+                                                                          "C_FindObjectsFinal",
+                                                                          "C_FindObjectsInit",
+                                                                          "C_GenerateKey",
+                                                                          "C_GenerateKeyPair",
+                                                                          "C_GetAttributeValue",
+                                                                          "C_GetSlotInfo",
+                                                                          "C_GetSlotList",
+                                                                          "C_GetTokenInfo",
+                                                                          "C_Initialize",
+                                                                          "C_Login",
+                                                                          "C_Logout",
+                                                                          "C_OpenSession",
+                                                                          "C_Sign",
+                                                                          "C_SignInit",
+                                                                          "C_UnwrapKey",
+                                                                          "CA_GetFirmwareVersion",
+                                                                          "CA_GetHAState"};
+
+// Statistics of the calls to a function returning a given CK_RV within a
+// context.
+typedef struct _PROFTK_RECORD
+{
+    unsigned long contextIdentifier;
+    PROFTK_FUNCTION function;
+    CK_RV rv;
+    unsigned long long callsCount;
+    unsigned long long totalNanoSeconds;
+    unsigned long long minNanoSeconds;
+    unsigned long long maxNanoSeconds;
+    unsigned long long histogram[PROFTK_HISTOGRAM_BUCKETS_COUNT];
+} PROFTK_RECORD;
+
+// Records of a thread, chained to the records of the other threads. They
+// are only written by their thread, and outlive it.
+typedef struct _PROFTK_THREAD_RECORDS
+{
+    struct _PROFTK_THREAD_RECORDS *pNext;
+    size_t recordsCount;
+    unsigned long long droppedCallsCount;
+    PROFTK_RECORD records[PROFTK_MAXIMUM_RECORDS_COUNT_PER_THREAD];
+} PROFTK_THREAD_RECORDS;
+
+static bool proftkIsEnabled = false;
+
+static CK_FUNCTION_LIST proftkFunctionList;
+static CK_SFNT_CA_FUNCTION_LIST proftkCaFunctionList;
+
+// Provider function lists.
+static CK_FUNCTION_LIST_PTR pProviderFunctionList = NULL;
+static CK_SFNT_CA_FUNCTION_LIST_PTR pProviderCaFunctionList = NULL;
+
+static pthread_mutex_t proftkMutex = PTHREAD_MUTEX_INITIALIZER;
+static PROFTK_THREAD_RECORDS *pProftkThreadRecordsList = NULL;
+static char *proftkContextNames[PROFTK_MAXIMUM_CONTEXTS_COUNT] = {NULL};
+
+static __thread PROFTK_THREAD_RECORDS *pProftkThreadRecords = NULL;
+static __thread unsigned long proftkContextIdentifier = PROFTK_DEFAULT_CONTEXT;
+static __thread size_t proftkLastRecordIndex = 0;
+static __thread PROFTK_CALL_TRACKER *pProftkCallTracker = NULL;
+
+static int proftk_compareRecords(const void *pLeft,
+                                 const void *pRight)
+{
+    const PROFTK_RECORD *const pLeftRecord = (const PROFTK_RECORD *)pLeft;
+    const PROFTK_RECORD *const pRightRecord = (const PROFTK_RECORD *)pRight;
+
+    if (pLeftRecord->contextIdentifier != pRightRecord->contextIdentifier)
+    {
+        return (pLeftRecord->contextIdentifier < pRightRecord->contextIdentifier) ? -1 : 1;
+    }
+
+    if (pLeftRecord->function != pRightRecord->function)
+    {
+        return (pLeftRecord->function < pRightRecord->function) ? -1 : 1;
+    }
+
+    if (pLeftRecord->rv != pRightRecord->rv)
+    {
+        return (pLeftRecord->rv < pRightRecord->rv) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Upper bound (excluded) of a histogram bucket, in micro-seconds.
+static unsigned long long proftk_getBucketUpperBound(const unsigned int bucketIndex)
+{
+    return 1ULL << bucketIndex;
+}
+
+// Upper bound of the bucket holding the given percentile of the calls (the
+// percentiles are only known to the precision of the histogram).
+static unsigned long long proftk_getPercentile(const PROFTK_RECORD *const pRecord,
+                                               const unsigned int percentile)
+{
+    assert(pRecord != NULL);
+    assert(percentile <= 100);
+
+    const unsigned long long threshold = ((pRecord->callsCount * percentile) + 99) / 100;
+    unsigned long long callsCount = 0;
+
+    for (unsigned int bucketIndex = 0; bucketIndex < PROFTK_HISTOGRAM_BUCKETS_COUNT; bucketIndex++)
+    {
+        callsCount += pRecord->histogram[bucketIndex];
+
+        if (callsCount >= threshold)
+        {
+            return proftk_getBucketUpperBound(bucketIndex);
+        }
+    }
+
+    return proftk_getBucketUpperBound(PROFTK_HISTOGRAM_BUCKETS_COUNT - 1);
+}
+
+static PROFTK_THREAD_RECORDS *proftk_getThreadRecords(void)
+{
+    if (pProftkThreadRecords == NULL)
+    {
+        PROFTK_THREAD_RECORDS *const pThreadRecords = (PROFTK_THREAD_RECORDS *)calloc(1,
+                                                                                      sizeof(PROFTK_THREAD_RECORDS));
+
+        if (pThreadRecords == NULL)
+        {
+            return NULL;
+        }
+
+        pthread_mutex_lock(&proftkMutex);
+
+        pThreadRecords->pNext = pProftkThreadRecordsList;
+        pProftkThreadRecordsList = pThreadRecords;
+
+        pthread_mutex_unlock(&proftkMutex);
+
+        pProftkThreadRecords = pThreadRecords;
+    }
+
+    return pProftkThreadRecords;
+}
+
+static void proftk_beginCall(const PROFTK_FUNCTION function,
+                             const unsigned long long beginNanoSeconds)
+{
+    if (pProftkCallTracker == NULL)
+    {
+        return;
+    }
+
+    // The name is published last, so that its begin time is read with it.
+    __atomic_store_n(&pProftkCallTracker->beginNanoSeconds,
+                     beginNanoSeconds,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&pProftkCallTracker->functionName,
+                     PROFTK_FUNCTION_NAMES[function],
+                     __ATOMIC_RELEASE);
+}
+
+static void proftk_endCall(const PROFTK_FUNCTION function,
+                           const CK_RV rv,
+                           const unsigned long long beginNanoSeconds,
+                           const unsigned long long nanoSeconds)
+{
+    if (pProftkCallTracker == NULL)
+    {
+        return;
+    }
+
+    __atomic_store_n(&pProftkCallTracker->functionName,
+                     NULL,
+                     __ATOMIC_RELEASE);
+
+    if ((pProftkCallTracker->slowCallCallback != NULL) &&
+        (nanoSeconds >= pProftkCallTracker->slowCallNanoSeconds))
+    {
+        pProftkCallTracker->slowCallCallback(pProftkCallTracker,
+                                             PROFTK_FUNCTION_NAMES[function],
+                                             rv,
+                                             beginNanoSeconds,
+                                             nanoSeconds);
+    }
+}
+
+static void proftk_mergeRecord(PROFTK_RECORD *const pTarget,
+                               const PROFTK_RECORD *const pSource)
+{
+    assert(pTarget != NULL);
+    assert(pSource != NULL);
+
+    if ((pTarget->callsCount == 0) ||
+        (pSource->minNanoSeconds < pTarget->minNanoSeconds))
+    {
+        pTarget->minNanoSeconds = pSource->minNanoSeconds;
+    }
+
+    if (pSource->maxNanoSeconds > pTarget->maxNanoSeconds)
+    {
+        pTarget->maxNanoSeconds = pSource->maxNanoSeconds;
+    }
+
+    pTarget->callsCount += pSource->callsCount;
+    pTarget->totalNanoSeconds += pSource->totalNanoSeconds;
+
+    for (unsigned int bucketIndex = 0; bucketIndex < PROFTK_HISTOGRAM_BUCKETS_COUNT; bucketIndex++)
+    {
+        pTarget->histogram[bucketIndex] += pSource->histogram[bucketIndex];
+    }
+}
+
+static void proftk_record(const PROFTK_FUNCTION function,
+                          const CK_RV rv,
+                          const unsigned long long beginNanoSeconds)
+{
+    const unsigned long long nanoSeconds = proftk_getNanoSeconds() - beginNanoSeconds;
+
+    proftk_endCall(function,
+                   rv,
+                   beginNanoSeconds,
+                   nanoSeconds);
+
+    PROFTK_THREAD_RECORDS *const pThreadRecords = proftk_getThreadRecords();
+
+    if (pThreadRecords == NULL)
+    {
+        return;
+    }
+
+    // Most threads keep calling the same function with the same outcome.
+    PROFTK_RECORD *pRecord = NULL;
+
+    if ((proftkLastRecordIndex < pThreadRecords->recordsCount) &&
+        (pThreadRecords->records[proftkLastRecordIndex].function == function) &&
+        (pThreadRecords->records[proftkLastRecordIndex].rv == rv) &&
+        (pThreadRecords->records[proftkLastRecordIndex].contextIdentifier == proftkContextIdentifier))
+    {
+        pRecord = &pThreadRecords->records[proftkLastRecordIndex];
+    }
+    else
+    {
+        size_t recordIndex = 0;
+
+        while ((recordIndex < pThreadRecords->recordsCount) &&
+               ((pThreadRecords->records[recordIndex].function != function) ||
+                (pThreadRecords->records[recordIndex].rv != rv) ||
+                (pThreadRecords->records[recordIndex].contextIdentifier != proftkContextIdentifier)))
+        {
+            recordIndex++;
+        }
+
+        if (recordIndex == pThreadRecords->recordsCount)
+        {
+            if (recordIndex == PROFTK_MAXIMUM_RECORDS_COUNT_PER_THREAD)
+            {
+                pThreadRecords->droppedCallsCount++;
+
+                return;
+            }
+
+            pThreadRecords->records[recordIndex].contextIdentifier = proftkContextIdentifier;
+            pThreadRecords->records[recordIndex].function = function;
+            pThreadRecords->records[recordIndex].rv = rv;
+            pThreadRecords->recordsCount++;
+        }
+
+        proftkLastRecordIndex = recordIndex;
+        pRecord = &pThreadRecords->records[recordIndex];
+    }
+
+    if ((pRecord->callsCount == 0) ||
+        (nanoSeconds < pRecord->minNanoSeconds))
+    {
+        pRecord->minNanoSeconds = nanoSeconds;
+    }
+
+    if (nanoSeconds > pRecord->maxNanoSeconds)
+    {
+        pRecord->maxNanoSeconds = nanoSeconds;
+    }
+
+    pRecord->callsCount++;
+    pRecord->totalNanoSeconds += nanoSeconds;
+
+    const unsigned long long microSeconds = nanoSeconds / 1000ULL;
+    unsigned int bucketIndex = 0;
+
+    if (microSeconds != 0)
+    {
+        bucketIndex = (unsigned int)(64 - __builtin_clzll(microSeconds));
+
+        if (bucketIndex >= PROFTK_HISTOGRAM_BUCKETS_COUNT)
+        {
+            bucketIndex = PROFTK_HISTOGRAM_BUCKETS_COUNT - 1;
+        }
+    }
+
+    pRecord->histogram[bucketIndex]++;
+}
+
+// Forwards a call to the provider and records it.
+#define PROFTK_PROFILE(function, call)                                   \
+    const unsigned long long beginNanoSeconds = proftk_getNanoSeconds(); \
+    proftk_beginCall(function, beginNanoSeconds);                        \
+    const CK_RV rv = (call);                                             \
+    proftk_record(function, rv, beginNanoSeconds);                       \
+    return rv
+
+static CK_RV proftk_C_CloseSession(CK_SESSION_HANDLE hSession)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_CLOSE_SESSION,
+                   pProviderFunctionList->C_CloseSession(hSession));
+}
+
+static CK_RV proftk_C_CreateObject(CK_SESSION_HANDLE hSession,
+                                   CK_ATTRIBUTE_PTR pTemplate,
+                                   CK_ULONG usCount,
+                                   CK_OBJECT_HANDLE_PTR phObject)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_CREATE_OBJECT,
+                   pProviderFunctionList->C_CreateObject(hSession,
+                                                         pTemplate,
+                                                         usCount,
+                                                         phObject));
+}
+
+static CK_RV proftk_C_Decrypt(CK_SESSION_HANDLE hSession,
+                              CK_BYTE_PTR pEncryptedData,
+                              CK_ULONG usEncryptedDataLen,
+                              CK_BYTE_PTR pData,
+                              CK_ULONG_PTR pusDataLen)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_DECRYPT,
+                   pProviderFunctionList->C_Decrypt(hSession,
+                                                    pEncryptedData,
+                                                    usEncryptedDataLen,
+                                                    pData,
+                                                    pusDataLen));
+}
+
+static CK_RV proftk_C_DecryptInit(CK_SESSION_HANDLE hSession,
+                                  CK_MECHANISM_PTR pMechanism,
+                                  CK_OBJECT_HANDLE hKey)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_DECRYPT_INIT,
+                   pProviderFunctionList->C_DecryptInit(hSession,
+                                                        pMechanism,
+                                                        hKey));
+}
+
+static CK_RV proftk_C_DestroyObject(CK_SESSION_HANDLE hSession,
+                                    CK_OBJECT_HANDLE hObject)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_DESTROY_OBJECT,
+                   pProviderFunctionList->C_DestroyObject(hSession,
+                                                          hObject));
+}
+
+static CK_RV proftk_C_Digest(CK_SESSION_HANDLE hSession,
+                             CK_BYTE_PTR pData,
+                             CK_ULONG usDataLen,
+                             CK_BYTE_PTR pDigest,
+                             CK_ULONG_PTR pusDigestLen)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_DIGEST,
+                   pProviderFunctionList->C_Digest(hSession,
+                                                   pData,
+                                                   usDataLen,
+                                                   pDigest,
+                                                   pusDigestLen));
+}
+
+static CK_RV proftk_C_DigestInit(CK_SESSION_HANDLE hSession,
+                                 CK_MECHANISM_PTR pMechanism)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_DIGEST_INIT,
+                   pProviderFunctionList->C_DigestInit(hSession,
+                                                       pMechanism));
+}
+
+static CK_RV proftk_C_Encrypt(CK_SESSION_HANDLE hSession,
+                              CK_BYTE_PTR pData,
+                              CK_ULONG usDataLen,
+                              CK_BYTE_PTR pEncryptedData,
+                              CK_ULONG_PTR pusEncryptedDataLen)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_ENCRYPT,
+                   pProviderFunctionList->C_Encrypt(hSession,
+                                                    pData,
+                                                    usDataLen,
+                                                    pEncryptedData,
+                                                    pusEncryptedDataLen));
+}
+
+static CK_RV proftk_C_EncryptInit(CK_SESSION_HANDLE hSession,
+                                  CK_MECHANISM_PTR pMechanism,
+                                  CK_OBJECT_HANDLE hKey)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_ENCRYPT_INIT,
+                   pProviderFunctionList->C_EncryptInit(hSession,
+                                                        pMechanism,
+                                                        hKey));
+}
+
+static CK_RV proftk_C_Finalize(CK_VOID_PTR pReserved)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_FINALIZE,
+                   pProviderFunctionList->C_Finalize(pReserved));
+}
+
+static CK_RV proftk_C_FindObjects(CK_SESSION_HANDLE hSession,
+                                  CK_OBJECT_HANDLE_PTR phObject,
+                                  CK_ULONG usMaxObjectCount,
+                                  CK_ULONG_PTR pusObjectCount)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_FIND_OBJECTS,
+                   pProviderFunctionList->C_FindObjects(hSession,
+                                                        phObject,
+                                                        usMaxObjectCount,
+                                                        pusObjectCount));
+}
+
+static CK_RV proftk_C_FindObjectsFinal(CK_SESSION_HANDLE hSession)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_FIND_OBJECTS_FINAL,
+                   pProviderFunctionList->C_FindObjectsFinal(hSession));
+}
+
+static CK_RV proftk_C_FindObjectsInit(CK_SESSION_HANDLE hSession,
+                                      CK_ATTRIBUTE_PTR pTemplate,
+                                      CK_ULONG usCount)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_FIND_OBJECTS_INIT,
+                   pProviderFunctionList->C_FindObjectsInit(hSession,
+                                                            pTemplate,
+                                                            usCount));
+}
+
+static CK_RV proftk_C_GenerateKey(CK_SESSION_HANDLE hSession,
+                                  CK_MECHANISM_PTR pMechanism,
+                                  CK_ATTRIBUTE_PTR pTemplate,
+                                  CK_ULONG usCount,
+                                  CK_OBJECT_HANDLE_PTR phKey)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_GENERATE_KEY,
+                   pProviderFunctionList->C_GenerateKey(hSession,
+                                                        pMechanism,
+                                                        pTemplate,
+                                                        usCount,
+                                                        phKey));
+}
+
+static CK_RV proftk_C_GenerateKeyPair(CK_SESSION_HANDLE hSession,
+                                      CK_MECHANISM_PTR pMechanism,
+                                      CK_ATTRIBUTE_PTR pPublicKeyTemplate,
+                                      CK_ULONG usPublicKeyAttributeCount,
+                                      CK_ATTRIBUTE_PTR pPrivateKeyTemplate,
+                                      CK_ULONG usPrivateKeyAttributeCount,
+                                      CK_OBJECT_HANDLE_PTR phPublicKey,
+                                      CK_OBJECT_HANDLE_PTR phPrivateKey)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_GENERATE_KEY_PAIR,
+                   pProviderFunctionList->C_GenerateKeyPair(hSession,
+                                                            pMechanism,
+                                                            pPublicKeyTemplate,
+                                                            usPublicKeyAttributeCount,
+                                                            pPrivateKeyTemplate,
+                                                            usPrivateKeyAttributeCount,
+                                                            phPublicKey,
+                                                            phPrivateKey));
+}
+
+static CK_RV proftk_C_GetAttributeValue(CK_SESSION_HANDLE hSession,
+                                        CK_OBJECT_HANDLE hObject,
+                                        CK_ATTRIBUTE_PTR pTemplate,
+                                        CK_ULONG usCount)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_GET_ATTRIBUTE_VALUE,
+                   pProviderFunctionList->C_GetAttributeValue(hSession,
+                                                              hObject,
+                                                              pTemplate,
+                                                              usCount));
+}
+
+static CK_RV proftk_C_GetSlotInfo(CK_SLOT_ID slotID,
+                                  CK_SLOT_INFO_PTR pInfo)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_GET_SLOT_INFO,
+                   pProviderFunctionList->C_GetSlotInfo(slotID,
+                                                        pInfo));
+}
+
+static CK_RV proftk_C_GetSlotList(CK_BBOOL tokenPresent,
+                                  CK_SLOT_ID_PTR pSlotList,
+                                  CK_ULONG_PTR pulCount)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_GET_SLOT_LIST,
+                   pProviderFunctionList->C_GetSlotList(tokenPresent,
+                                                        pSlotList,
+                                                        pulCount));
+}
+
+static CK_RV proftk_C_GetTokenInfo(CK_SLOT_ID slotID,
+                                   CK_TOKEN_INFO_PTR pInfo)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_GET_TOKEN_INFO,
+                   pProviderFunctionList->C_GetTokenInfo(slotID,
+                                                         pInfo));
+}
+
+static CK_RV proftk_C_Initialize(CK_VOID_PTR pInitArgs)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_INITIALIZE,
+                   pProviderFunctionList->C_Initialize(pInitArgs));
+}
+
+static CK_RV proftk_C_Login(CK_SESSION_HANDLE hSession,
+                            CK_USER_TYPE userType,
+                            CK_CHAR_PTR pPin,
+                            CK_ULONG usPinLen)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_LOGIN,
+                   pProviderFunctionList->C_Login(hSession,
+                                                  userType,
+                                                  pPin,
+                                                  usPinLen));
+}
+
+static CK_RV proftk_C_Logout(CK_SESSION_HANDLE hSession)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_LOGOUT,
+                   pProviderFunctionList->C_Logout(hSession));
+}
+
+static CK_RV proftk_C_OpenSession(CK_SLOT_ID slotID,
+                                  CK_FLAGS flags,
+                                  CK_VOID_PTR pApplication,
+                                  CK_NOTIFY Notify,
+                                  CK_SESSION_HANDLE_PTR phSession)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_OPEN_SESSION,
+                   pProviderFunctionList->C_OpenSession(slotID,
+                                                        flags,
+                                                        pApplication,
+                                                        Notify,
+                                                        phSession));
+}
+
+static CK_RV proftk_C_Sign(CK_SESSION_HANDLE hSession,
+                           CK_BYTE_PTR pData,
+                           CK_ULONG usDataLen,
+                           CK_BYTE_PTR pSignature,
+                           CK_ULONG_PTR pusSignatureLen)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_SIGN,
+                   pProviderFunctionList->C_Sign(hSession,
+                                                 pData,
+                                                 usDataLen,
+                                                 pSignature,
+                                                 pusSignatureLen));
+}
+
+static CK_RV proftk_C_SignInit(CK_SESSION_HANDLE hSession,
+                               CK_MECHANISM_PTR pMechanism,
+                               CK_OBJECT_HANDLE hKey)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_SIGN_INIT,
+                   pProviderFunctionList->C_SignInit(hSession,
+                                                     pMechanism,
+                                                     hKey));
+}
+
+static CK_RV proftk_C_UnwrapKey(CK_SESSION_HANDLE hSession,
+                                CK_MECHANISM_PTR pMechanism,
+                                CK_OBJECT_HANDLE hUnwrappingKey,
+                                CK_BYTE_PTR pWrappedKey,
+                                CK_ULONG usWrappedKeyLen,
+                                CK_ATTRIBUTE_PTR pTemplate,
+                                CK_ULONG usAttributeCount,
+                                CK_OBJECT_HANDLE_PTR phKey)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_C_UNWRAP_KEY,
+                   pProviderFunctionList->C_UnwrapKey(hSession,
+                                                      pMechanism,
+                                                      hUnwrappingKey,
+                                                      pWrappedKey,
+                                                      usWrappedKeyLen,
+                                                      pTemplate,
+                                                      usAttributeCount,
+                                                      phKey));
+}
+
+static CK_RV proftk_CA_GetFirmwareVersion(CK_SLOT_ID slotId,
+                                          CK_ULONG_PTR pulMajor,
+                                          CK_ULONG_PTR pulMinor,
+                                          CK_ULONG_PTR pulSubminor)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_CA_GET_FIRMWARE_VERSION,
+                   pProviderCaFunctionList->CA_GetFirmwareVersion(slotId,
+                                                                  pulMajor,
+                                                                  pulMinor,
+                                                                  pulSubminor));
+}
+
+static CK_RV proftk_CA_GetHAState(CK_SLOT_ID slotId,
+                                  CK_HA_STATE_PTR pState)
+{
+    PROFTK_PROFILE(PROFTK_FUNCTION_CA_GET_HA_STATE,
+                   pProviderCaFunctionList->CA_GetHAState(slotId,
+                                                          pState));
+}
+
+CK_RV proftk_enable(CK_FUNCTION_LIST_PTR *const ppFunctionList,
+                    CK_SFNT_CA_FUNCTION_LIST_PTR *const ppCaFunctionList)
+{
+    assert(ppFunctionList != NULL);
+    assert(*ppFunctionList != NULL);
+    assert(ppCaFunctionList != NULL);
+    assert(!proftkIsEnabled);
+
+    pProviderFunctionList = *ppFunctionList;
+    pProviderCaFunctionList = *ppCaFunctionList;
+
+    // The functions which are not profiled are called directly.
+    proftkFunctionList = *pProviderFunctionList;
+
+    proftkFunctionList.C_CloseSession = proftk_C_CloseSession;
+    proftkFunctionList.C_CreateObject = proftk_C_CreateObject;
+    proftkFunctionList.C_Decrypt = proftk_C_Decrypt;
+    proftkFunctionList.C_DecryptInit = proftk_C_DecryptInit;
+    proftkFunctionList.C_DestroyObject = proftk_C_DestroyObject;
+    proftkFunctionList.C_Digest = proftk_C_Digest;
+    proftkFunctionList.C_DigestInit = proftk_C_DigestInit;
+    proftkFunctionList.C_Encrypt = proftk_C_Encrypt;
+    proftkFunctionList.C_EncryptInit = proftk_C_EncryptInit;
+    proftkFunctionList.C_Finalize = proftk_C_Finalize;
+    proftkFunctionList.C_FindObjects = proftk_C_FindObjects;
+    proftkFunctionList.C_FindObjectsFinal = proftk_C_FindObjectsFinal;
+    proftkFunctionList.C_FindObjectsInit = proftk_C_FindObjectsInit;
+    proftkFunctionList.C_GenerateKey = proftk_C_GenerateKey;
+    proftkFunctionList.C_GenerateKeyPair = proftk_C_GenerateKeyPair;
+    proftkFunctionList.C_GetAttributeValue = proftk_C_GetAttributeValue;
+    proftkFunctionList.C_GetSlotInfo = proftk_C_GetSlotInfo;
+    proftkFunctionList.C_GetSlotList = proftk_C_GetSlotList;
+    proftkFunctionList.C_GetTokenInfo = proftk_C_GetTokenInfo;
+    proftkFunctionList.C_Initialize = proftk_C_Initialize;
+    proftkFunctionList.C_Login = proftk_C_Login;
+    proftkFunctionList.C_Logout = proftk_C_Logout;
+    proftkFunctionList.C_OpenSession = proftk_C_OpenSession;
+    proftkFunctionList.C_Sign = proftk_C_Sign;
+    proftkFunctionList.C_SignInit = proftk_C_SignInit;
+    proftkFunctionList.C_UnwrapKey = proftk_C_UnwrapKey;
+
+    *ppFunctionList = &proftkFunctionList;
+
+    if (pProviderCaFunctionList != NULL)
+    {
+        proftkCaFunctionList = *pProviderCaFunctionList;
+
+        proftkCaFunctionList.CA_GetFirmwareVersion = proftk_CA_GetFirmwareVersion;
+        proftkCaFunctionList.CA_GetHAState = proftk_CA_GetHAState;
+
+        *ppCaFunctionList = &proftkCaFunctionList;
+    }
+
+    proftkIsEnabled = true;
+
+    return CKR_OK;
+}
+
+unsigned long long proftk_getNanoSeconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC,
+                  &now);
+
+    return ((unsigned long long)now.tv_sec * 1000000000ULL) + (unsigned long long)now.tv_nsec;
+}
+
+bool proftk_isEnabled(void)
+{
+    return proftkIsEnabled;
+}
+
+void proftk_setCallTracker(PROFTK_CALL_TRACKER *const pCallTracker)
+{
+    pProftkCallTracker = pCallTracker;
+}
+
+void proftk_setContext(const unsigned long contextIdentifier)
+{
+    proftkContextIdentifier = (contextIdentifier < PROFTK_MAXIMUM_CONTEXTS_COUNT) ? contextIdentifier : PROFTK_DEFAULT_CONTEXT;
+}
+
+void proftk_setContextName(const unsigned long contextIdentifier,
+                           const char *const contextName)
+{
+    assert(contextName != NULL);
+
+    if (contextIdentifier >= PROFTK_MAXIMUM_CONTEXTS_COUNT)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&proftkMutex);
+
+    free(proftkContextNames[contextIdentifier]);
+
+    proftkContextNames[contextIdentifier] = strdup(contextName);
+
+    pthread_mutex_unlock(&proftkMutex);
+}
+
+void proftk_writeReport(void)
+{
+    if (!proftkIsEnabled)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&proftkMutex);
+
+    // Merge the records of all the threads.
+    size_t maximumRecordsCount = 0;
+    unsigned long long droppedCallsCount = 0;
+
+    for (const PROFTK_THREAD_RECORDS *pThreadRecords = pProftkThreadRecordsList;
+         pThreadRecords != NULL;
+         pThreadRecords = pThreadRecords->pNext)
+    {
+        maximumRecordsCount += pThreadRecords->recordsCount;
+        droppedCallsCount += pThreadRecords->droppedCallsCount;
+    }
+
+    PROFTK_RECORD *const records = (PROFTK_RECORD *)calloc((maximumRecordsCount != 0) ? maximumRecordsCount : 1,
+                                                           sizeof(PROFTK_RECORD));
+    size_t recordsCount = 0;
+
+    if (records == NULL)
+    {
+        fprintf(stderr,
+                "proftk_writeReport(): cannot allocate the merged records.\n");
+
+        goto EXIT;
+    }
+
+    for (const PROFTK_THREAD_RECORDS *pThreadRecords = pProftkThreadRecordsList;
+         pThreadRecords != NULL;
+         pThreadRecords = pThreadRecords->pNext)
+    {
+        for (size_t threadRecordIndex = 0; threadRecordIndex < pThreadRecords->recordsCount; threadRecordIndex++)
+        {
+            const PROFTK_RECORD *const pThreadRecord = &pThreadRecords->records[threadRecordIndex];
+            size_t recordIndex = 0;
+
+            while ((recordIndex < recordsCount) &&
+                   (proftk_compareRecords(&records[recordIndex], pThreadRecord) != 0))
+            {
+                recordIndex++;
+            }
+
+            if (recordIndex == recordsCount)
+            {
+                records[recordIndex].contextIdentifier = pThreadRecord->contextIdentifier;
+                records[recordIndex].function = pThreadRecord->function;
+                records[recordIndex].rv = pThreadRecord->rv;
+                recordsCount++;
+            }
+
+            proftk_mergeRecord(&records[recordIndex],
+                               pThreadRecord);
+        }
+    }
+
+    qsort(records,
+          recordsCount,
+          sizeof(PROFTK_RECORD),
+          proftk_compareRecords);
+
+    // Print them, context by context.
+    for (size_t recordIndex = 0; recordIndex < recordsCount; recordIndex++)
+    {
+        const PROFTK_RECORD *const pRecord = &records[recordIndex];
+
+        if ((recordIndex == 0) ||
+            (records[recordIndex - 1].contextIdentifier != pRecord->contextIdentifier))
+        {
+            if (proftkContextNames[pRecord->contextIdentifier] != NULL)
+            {
+                fprintf(stdout,
+                        "  %s:\n",
+                        proftkContextNames[pRecord->contextIdentifier]);
+            }
+            else
+            {
+                fprintf(stdout,
+                        "  Context %lu:\n",
+                        pRecord->contextIdentifier);
+            }
+
+            fprintf(stdout,
+                    "    %-22s %-10s %12s %12s %10s %10s %10s %10s %10s\n",
+                    "Function",
+                    "CK_RV",
+                    "Count",
+                    "Total (ms)",
+                    "Mean (us)",
+                    "Min (us)",
+                    "Max (us)",
+                    "P50 (us)",
+                    "P99 (us)");
+        }
+
+        fprintf(stdout,
+                "    %-22s 0x%08lx %12llu %12.3f %10.1f %10.1f %10.1f %10llu %10llu\n",
+                PROFTK_FUNCTION_NAMES[pRecord->function],
+                pRecord->rv,
+                pRecord->callsCount,
+                (double)pRecord->totalNanoSeconds / 1000000.,
+                ((double)pRecord->totalNanoSeconds / (double)pRecord->callsCount) / 1000.,
+                (double)pRecord->minNanoSeconds / 1000.,
+                (double)pRecord->maxNanoSeconds / 1000.,
+                proftk_getPercentile(pRecord, 50),
+                proftk_getPercentile(pRecord, 99));
+
+        // Non-empty buckets only, as '<upper bound (us)>:<calls count>'.
+        fprintf(stdout,
+                "      Histogram:");
+
+        for (unsigned int bucketIndex = 0; bucketIndex < PROFTK_HISTOGRAM_BUCKETS_COUNT; bucketIndex++)
+        {
+            if (pRecord->histogram[bucketIndex] != 0)
+            {
+                fprintf(stdout,
+                        " <%llu:%llu",
+                        proftk_getBucketUpperBound(bucketIndex),
+                        pRecord->histogram[bucketIndex]);
+            }
+        }
+
+        fprintf(stdout,
+                "\n");
+    }
+
+    if (droppedCallsCount != 0)
+    {
+        fprintf(stdout,
+                "  Calls not recorded (too many distinct records per thread): %llu\n",
+                droppedCallsCount);
+    }
+
+EXIT:
+    free(records);
+
+    pthread_mutex_unlock(&proftkMutex);
+}
@@ -0,0 +1,89 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __PROFILING_TOOLKIT_H__
+#define __PROFILING_TOOLKIT_H__
+
+#include <stdbool.h>
+
+#include <cryptoki_v2.h>
+
+/*
+ * Definitions
+ *
+ * Profiling of the PKCS#11 calls: once enabled, the calls go through
+ * function lists that forward them to the provider and record, per context
+ * (e.g. per scenario), per function and per returned CK_RV, the calls
+ * count, the total, minimum and maximum latencies, and a latency histogram.
+ * When disabled, the provider function lists are used as is.
+ *
+ * The records are kept per thread (no lock on the calls path) and merged
+ * by 'proftk_writeReport'.
+ */
+#define PROFTK_MAXIMUM_CONTEXTS_COUNT 64
+#define PROFTK_MAXIMUM_RECORDS_COUNT_PER_THREAD 64
+
+// Bucket 0 counts the calls shorter than 1 micro-second, bucket i (i > 0)
+// the calls lasting from 2^(i-1) (included) to 2^i (excluded) micro-seconds,
+// the last bucket counting all the longer calls.
+#define PROFTK_HISTOGRAM_BUCKETS_COUNT 32
+
+// Context of the calls made outside of any scenario.
+#define PROFTK_DEFAULT_CONTEXT 0
+
+// Call in progress on a thread, e.g. for a watchdog (see
+// 'proftk_setCallTracker').
+typedef struct _PROFTK_CALL_TRACKER
+{
+    // Name of the function called (NULL between the calls) and begin time
+    // of the call (see 'proftk_getNanoSeconds'), written by the tracked
+    // thread and read by the other ones.
+    const char *functionName;
+    unsigned long long beginNanoSeconds;
+
+    // Called by the tracked thread once a call lasting at least the given
+    // time returns (if set).
+    unsigned long long slowCallNanoSeconds;
+    void (*slowCallCallback)(struct _PROFTK_CALL_TRACKER *const pCallTracker,
+                             const char *const functionName,
+                             const CK_RV rv,
+                             const unsigned long long beginNanoSeconds,
+                             const unsigned long long nanoSeconds);
+} PROFTK_CALL_TRACKER;
+
+/*
+ * Interface
+ */
+
+// Replaces the given function lists by profiling ones, forwarding the calls
+// to the given lists. The CA function list is optional (it can be NULL).
+CK_RV proftk_enable(CK_FUNCTION_LIST_PTR *const ppFunctionList,
+                    CK_SFNT_CA_FUNCTION_LIST_PTR *const ppCaFunctionList);
+
+// Monotonic time of the calls (CLOCK_MONOTONIC).
+unsigned long long proftk_getNanoSeconds(void);
+
+bool proftk_isEnabled(void);
+
+// Tracks the calls made by the current thread (NULL to stop), once
+// enabled.
+void proftk_setCallTracker(PROFTK_CALL_TRACKER *const pCallTracker);
+
+// Sets the context of the calls made by the current thread; identifiers
+// beyond the maximum contexts count are mapped to the default context.
+void proftk_setContext(const unsigned long contextIdentifier);
+
+void proftk_setContextName(const unsigned long contextIdentifier,
+                           const char *const contextName);
+
+// Merges the records of all the threads and prints them; the profiled
+// threads must be stopped.
+void proftk_writeReport(void);
+
+#endif /* __PROFILING_TOOLKIT_H__ */
@@ -0,0 +1,259 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#include "sha-toolkit.h"
+
+static const uint32_t SHATK_SHA256_ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static uint32_t shatk_rotateRight(const uint32_t value,
+                                  const unsigned int count)
+{
+    return (value >> count) | (value << (32 - count));
+}
+
+static void shatk_sha256ProcessBlock(uint32_t state[8],
+                                     const unsigned char block[SHATK_SHA256_BLOCK_LENGTH])
+{
+    uint32_t w[64];
+
+    for (int index = 0; index < 16; index++)
+    {
+        w[index] = ((uint32_t)block[(index * 4) + 0] << 24) |
+                   ((uint32_t)block[(index * 4) + 1] << 16) |
+                   ((uint32_t)block[(index * 4) + 2] << 8) |
+                   ((uint32_t)block[(index * 4) + 3]);
+    }
+
+    for (int index = 16; index < 64; index++)
+    {
+        const uint32_t s0 = shatk_rotateRight(w[index - 15], 7) ^ shatk_rotateRight(w[index - 15], 18) ^ (w[index - 15] >> 3);
+        const uint32_t s1 = shatk_rotateRight(w[index - 2], 17) ^ shatk_rotateRight(w[index - 2], 19) ^ (w[index - 2] >> 10);
+
+        w[index] = w[index - 16] + s0 + w[index - 7] + s1;
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (int index = 0; index < 64; index++)
+    {
+        const uint32_t s1 = shatk_rotateRight(e, 6) ^ shatk_rotateRight(e, 11) ^ shatk_rotateRight(e, 25);
+        const uint32_t ch = (e & f) ^ (~e & g);
+        const uint32_t t1 = h + s1 + ch + SHATK_SHA256_ROUND_CONSTANTS[index] + w[index];
+        const uint32_t s0 = shatk_rotateRight(a, 2) ^ shatk_rotateRight(a, 13) ^ shatk_rotateRight(a, 22);
+        const uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void shatk_hmacSha256(const unsigned char *const key,
+                      const size_t keyLength,
+                      const unsigned char *const data,
+                      const size_t dataLength,
+                      unsigned char mac[SHATK_SHA256_DIGEST_LENGTH])
+{
+    assert((key != NULL) || (keyLength == 0));
+    assert((data != NULL) || (dataLength == 0));
+    assert(mac != NULL);
+
+    unsigned char paddedKey[SHATK_SHA256_BLOCK_LENGTH] = {0};
+    unsigned char innerDigest[SHATK_SHA256_DIGEST_LENGTH];
+    SHATK_SHA256_CONTEXT context;
+
+    // Keys longer than the block size are hashed first.
+    if (keyLength > SHATK_SHA256_BLOCK_LENGTH)
+    {
+        shatk_sha256(key,
+                     keyLength,
+                     paddedKey);
+    }
+    else if (keyLength > 0)
+    {
+        memcpy(paddedKey,
+               key,
+               keyLength);
+    }
+
+    for (int index = 0; index < SHATK_SHA256_BLOCK_LENGTH; index++)
+    {
+        paddedKey[index] ^= 0x36;
+    }
+
+    shatk_sha256Initialize(&context);
+    shatk_sha256Update(&context,
+                       paddedKey,
+                       SHATK_SHA256_BLOCK_LENGTH);
+    shatk_sha256Update(&context,
+                       data,
+                       dataLength);
+    shatk_sha256Final(&context,
+                      innerDigest);
+
+    // 0x36 ^ 0x5C = 0x6A.
+    for (int index = 0; index < SHATK_SHA256_BLOCK_LENGTH; index++)
+    {
+        paddedKey[index] ^= 0x6A;
+    }
+
+    shatk_sha256Initialize(&context);
+    shatk_sha256Update(&context,
+                       paddedKey,
+                       SHATK_SHA256_BLOCK_LENGTH);
+    shatk_sha256Update(&context,
+                       innerDigest,
+                       SHATK_SHA256_DIGEST_LENGTH);
+    shatk_sha256Final(&context,
+                      mac);
+}
+
+void shatk_sha256(const unsigned char *const data,
+                  const size_t dataLength,
+                  unsigned char digest[SHATK_SHA256_DIGEST_LENGTH])
+{
+    SHATK_SHA256_CONTEXT context;
+
+    shatk_sha256Initialize(&context);
+    shatk_sha256Update(&context,
+                       data,
+                       dataLength);
+    shatk_sha256Final(&context,
+                      digest);
+}
+
+void shatk_sha256Final(SHATK_SHA256_CONTEXT *const pContext,
+                       unsigned char digest[SHATK_SHA256_DIGEST_LENGTH])
+{
+    assert(pContext != NULL);
+    assert(digest != NULL);
+
+    const uint64_t lengthInBits = pContext->length * 8;
+
+    pContext->block[pContext->blockLength++] = 0x80;
+
+    if (pContext->blockLength > (SHATK_SHA256_BLOCK_LENGTH - 8))
+    {
+        memset(&pContext->block[pContext->blockLength],
+               0,
+               SHATK_SHA256_BLOCK_LENGTH - pContext->blockLength);
+
+        shatk_sha256ProcessBlock(pContext->state,
+                                 pContext->block);
+
+        pContext->blockLength = 0;
+    }
+
+    memset(&pContext->block[pContext->blockLength],
+           0,
+           SHATK_SHA256_BLOCK_LENGTH - 8 - pContext->blockLength);
+
+    for (int index = 0; index < 8; index++)
+    {
+        pContext->block[SHATK_SHA256_BLOCK_LENGTH - 1 - index] = (unsigned char)(lengthInBits >> (index * 8));
+    }
+
+    shatk_sha256ProcessBlock(pContext->state,
+                             pContext->block);
+
+    for (int index = 0; index < 8; index++)
+    {
+        digest[(index * 4) + 0] = (unsigned char)(pContext->state[index] >> 24);
+        digest[(index * 4) + 1] = (unsigned char)(pContext->state[index] >> 16);
+        digest[(index * 4) + 2] = (unsigned char)(pContext->state[index] >> 8);
+        digest[(index * 4) + 3] = (unsigned char)(pContext->state[index]);
+    }
+}
+
+void shatk_sha256Initialize(SHATK_SHA256_CONTEXT *const pContext)
+{
+    assert(pContext != NULL);
+
+    pContext->state[0] = 0x6a09e667;
+    pContext->state[1] = 0xbb67ae85;
+    pContext->state[2] = 0x3c6ef372;
+    pContext->state[3] = 0xa54ff53a;
+    pContext->state[4] = 0x510e527f;
+    pContext->state[5] = 0x9b05688c;
+    pContext->state[6] = 0x1f83d9ab;
+    pContext->state[7] = 0x5be0cd19;
+
+    pContext->length = 0;
+    pContext->blockLength = 0;
+}
+
+void shatk_sha256Update(SHATK_SHA256_CONTEXT *const pContext,
+                        const unsigned char *const data,
+                        const size_t dataLength)
+{
+    assert(pContext != NULL);
+    assert((data != NULL) || (dataLength == 0));
+
+    size_t offset = 0;
+
+    pContext->length += dataLength;
+
+    while (offset < dataLength)
+    {
+        size_t chunkLength = SHATK_SHA256_BLOCK_LENGTH - pContext->blockLength;
+
+        if (chunkLength > (dataLength - offset))
+        {
+            chunkLength = dataLength - offset;
+        }
+
+        memcpy(&pContext->block[pContext->blockLength],
+               &data[offset],
+               chunkLength);
+
+        pContext->blockLength += chunkLength;
+        offset += chunkLength;
+
+        if (pContext->blockLength == SHATK_SHA256_BLOCK_LENGTH)
+        {
+            shatk_sha256ProcessBlock(pContext->state,
+                                     pContext->block);
+
+            pContext->blockLength = 0;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __SHA_TOOLKIT_H__
+#define __SHA_TOOLKIT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Definitions
+ *
+ * Software implementation of SHA-256 (FIPS 180-4) and HMAC-SHA-256
+ * (RFC 2104).
+ */
+#define SHATK_SHA256_BLOCK_LENGTH 64
+#define SHATK_SHA256_DIGEST_LENGTH 32
+
+typedef struct _SHATK_SHA256_CONTEXT
+{
+    uint32_t state[8];
+    uint64_t length;
+    unsigned char block[SHATK_SHA256_BLOCK_LENGTH];
+    size_t blockLength;
+} SHATK_SHA256_CONTEXT;
+
+/*
+ * Interface
+ */
+void shatk_hmacSha256(const unsigned char *const key,
+                      const size_t keyLength,
+                      const unsigned char *const data,
+                      const size_t dataLength,
+                      unsigned char mac[SHATK_SHA256_DIGEST_LENGTH]);
+
+void shatk_sha256(const unsigned char *const data,
+                  const size_t dataLength,
+                  unsigned char digest[SHATK_SHA256_DIGEST_LENGTH]);
+
+void shatk_sha256Final(SHATK_SHA256_CONTEXT *const pContext,
+                       unsigned char digest[SHATK_SHA256_DIGEST_LENGTH]);
+
+void shatk_sha256Initialize(SHATK_SHA256_CONTEXT *const pContext);
+
+void shatk_sha256Update(SHATK_SHA256_CONTEXT *const pContext,
+                        const unsigned char *const data,
+                        const size_t dataLength);
+
+#endif /* __SHA_TOOLKIT_H__ */
@@ -0,0 +1,1210 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define TUAKTK_WITH_AVX
+#endif
+
+#include "tuak-toolkit.h"
+
+#define TUAKTK_KECCAK_ROUNDS_COUNT 24
+
+// Offsets in the Keccak state (TS 35.231, 6.2).
+#define TUAKTK_OFFSET__TOPC 0
+#define TUAKTK_OFFSET__INSTANCE 32
+#define TUAKTK_OFFSET__ALGONAME 33
+#define TUAKTK_OFFSET__RAND 40
+#define TUAKTK_OFFSET__AMF 56
+#define TUAKTK_OFFSET__SQN 58
+#define TUAKTK_OFFSET__KEY 64
+#define TUAKTK_OFFSET__PADDING 96
+#define TUAKTK_OFFSET__LAST_RATE_BYTE 135
+
+// Offsets of the outputs in the Keccak state.
+#define TUAKTK_OFFSET__MAC 0
+#define TUAKTK_OFFSET__RES 0
+#define TUAKTK_OFFSET__CK 32
+#define TUAKTK_OFFSET__IK 64
+#define TUAKTK_OFFSET__AK 96
+
+// INSTANCE bits.
+#define TUAKTK_INSTANCE__F1 0x00
+#define TUAKTK_INSTANCE__F1_STAR 0x80
+#define TUAKTK_INSTANCE__F2345 0x40
+#define TUAKTK_INSTANCE__F5_STAR 0xC0
+#define TUAKTK_INSTANCE__CK_256 0x04
+#define TUAKTK_INSTANCE__IK_256 0x02
+#define TUAKTK_INSTANCE__KEY_256 0x01
+
+// Implementations of tuaktk_keccakF1600Buffers().
+#define TUAKTK_BUFFERS_IMPLEMENTATION__SCALAR 0
+#define TUAKTK_BUFFERS_IMPLEMENTATION__AVX2 1
+#define TUAKTK_BUFFERS_IMPLEMENTATION__AVX_512 2
+
+// Buffers held by an AVX2 register.
+#define TUAKTK_AVX2_BUFFERS_COUNT 4
+
+static const char TUAKTK_ALGONAME[] = "TUAK1.0";
+
+static const uint64_t TUAKTK_ROUND_CONSTANTS[TUAKTK_KECCAK_ROUNDS_COUNT] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+static uint64_t tuaktk_rotateLeft(const uint64_t value,
+                                  const unsigned int count)
+{
+    return (value << count) | (value >> ((64 - count) & 63));
+}
+
+// One Keccak-f[1600] round from 'input' to 'output', with Rho and Pi
+// unrolled (i.e. without the lanes tables and modulos), and Chi applied to
+// each plane as soon as it is moved.
+static void tuaktk_computeKeccakRound(const uint64_t input[TUAKTK_KECCAK_LANES_COUNT],
+                                      const uint64_t roundConstant,
+                                      uint64_t output[TUAKTK_KECCAK_LANES_COUNT])
+{
+    uint64_t b0, b1, b2, b3, b4;
+
+    // Theta.
+    const uint64_t c0 = input[0] ^ input[5] ^ input[10] ^ input[15] ^ input[20];
+    const uint64_t c1 = input[1] ^ input[6] ^ input[11] ^ input[16] ^ input[21];
+    const uint64_t c2 = input[2] ^ input[7] ^ input[12] ^ input[17] ^ input[22];
+    const uint64_t c3 = input[3] ^ input[8] ^ input[13] ^ input[18] ^ input[23];
+    const uint64_t c4 = input[4] ^ input[9] ^ input[14] ^ input[19] ^ input[24];
+
+    const uint64_t d0 = c4 ^ tuaktk_rotateLeft(c1, 1);
+    const uint64_t d1 = c0 ^ tuaktk_rotateLeft(c2, 1);
+    const uint64_t d2 = c1 ^ tuaktk_rotateLeft(c3, 1);
+    const uint64_t d3 = c2 ^ tuaktk_rotateLeft(c4, 1);
+    const uint64_t d4 = c3 ^ tuaktk_rotateLeft(c0, 1);
+
+    // Rho, Pi, Chi and Iota, plane by plane.
+    b0 = input[0] ^ d0;
+    b1 = tuaktk_rotateLeft(input[6] ^ d1, 44);
+    b2 = tuaktk_rotateLeft(input[12] ^ d2, 43);
+    b3 = tuaktk_rotateLeft(input[18] ^ d3, 21);
+    b4 = tuaktk_rotateLeft(input[24] ^ d4, 14);
+
+    output[0] = b0 ^ (~b1 & b2) ^ roundConstant;
+    output[1] = b1 ^ (~b2 & b3);
+    output[2] = b2 ^ (~b3 & b4);
+    output[3] = b3 ^ (~b4 & b0);
+    output[4] = b4 ^ (~b0 & b1);
+
+    b0 = tuaktk_rotateLeft(input[3] ^ d3, 28);
+    b1 = tuaktk_rotateLeft(input[9] ^ d4, 20);
+    b2 = tuaktk_rotateLeft(input[10] ^ d0, 3);
+    b3 = tuaktk_rotateLeft(input[16] ^ d1, 45);
+    b4 = tuaktk_rotateLeft(input[22] ^ d2, 61);
+
+    output[5] = b0 ^ (~b1 & b2);
+    output[6] = b1 ^ (~b2 & b3);
+    output[7] = b2 ^ (~b3 & b4);
+    output[8] = b3 ^ (~b4 & b0);
+    output[9] = b4 ^ (~b0 & b1);
+
+    b0 = tuaktk_rotateLeft(input[1] ^ d1, 1);
+    b1 = tuaktk_rotateLeft(input[7] ^ d2, 6);
+    b2 = tuaktk_rotateLeft(input[13] ^ d3, 25);
+    b3 = tuaktk_rotateLeft(input[19] ^ d4, 8);
+    b4 = tuaktk_rotateLeft(input[20] ^ d0, 18);
+
+    output[10] = b0 ^ (~b1 & b2);
+    output[11] = b1 ^ (~b2 & b3);
+    output[12] = b2 ^ (~b3 & b4);
+    output[13] = b3 ^ (~b4 & b0);
+    output[14] = b4 ^ (~b0 & b1);
+
+    b0 = tuaktk_rotateLeft(input[4] ^ d4, 27);
+    b1 = tuaktk_rotateLeft(input[5] ^ d0, 36);
+    b2 = tuaktk_rotateLeft(input[11] ^ d1, 10);
+    b3 = tuaktk_rotateLeft(input[17] ^ d2, 15);
+    b4 = tuaktk_rotateLeft(input[23] ^ d3, 56);
+
+    output[15] = b0 ^ (~b1 & b2);
+    output[16] = b1 ^ (~b2 & b3);
+    output[17] = b2 ^ (~b3 & b4);
+    output[18] = b3 ^ (~b4 & b0);
+    output[19] = b4 ^ (~b0 & b1);
+
+    b0 = tuaktk_rotateLeft(input[2] ^ d2, 62);
+    b1 = tuaktk_rotateLeft(input[8] ^ d3, 55);
+    b2 = tuaktk_rotateLeft(input[14] ^ d4, 39);
+    b3 = tuaktk_rotateLeft(input[15] ^ d0, 41);
+    b4 = tuaktk_rotateLeft(input[21] ^ d1, 2);
+
+    output[20] = b0 ^ (~b1 & b2);
+    output[21] = b1 ^ (~b2 & b3);
+    output[22] = b2 ^ (~b3 & b4);
+    output[23] = b3 ^ (~b4 & b0);
+    output[24] = b4 ^ (~b0 & b1);
+}
+
+#ifdef TUAKTK_WITH_AVX
+__attribute__((target("avx2"))) static __m256i tuaktk_rotateLeftAvx2(const __m256i value,
+                                                                    const int count)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(value, count),
+                           _mm256_srli_epi64(value, 64 - count));
+}
+
+// Same as tuaktk_computeKeccakRound(), on 4 buffers (one per 64-bit lane of
+// the registers).
+__attribute__((target("avx2"))) static void tuaktk_computeKeccakRoundAvx2(const __m256i input[TUAKTK_KECCAK_LANES_COUNT],
+                                                                         const uint64_t roundConstant,
+                                                                         __m256i output[TUAKTK_KECCAK_LANES_COUNT])
+{
+    __m256i b0, b1, b2, b3, b4;
+
+    // Theta.
+    const __m256i c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(input[0], input[5]), _mm256_xor_si256(input[10], input[15])), input[20]);
+    const __m256i c1 = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(input[1], input[6]), _mm256_xor_si256(input[11], input[16])), input[21]);
+    const __m256i c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(input[2], input[7]), _mm256_xor_si256(input[12], input[17])), input[22]);
+    const __m256i c3 = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(input[3], input[8]), _mm256_xor_si256(input[13], input[18])), input[23]);
+    const __m256i c4 = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(input[4], input[9]), _mm256_xor_si256(input[14], input[19])), input[24]);
+
+    const __m256i d0 = _mm256_xor_si256(c4, tuaktk_rotateLeftAvx2(c1, 1));
+    const __m256i d1 = _mm256_xor_si256(c0, tuaktk_rotateLeftAvx2(c2, 1));
+    const __m256i d2 = _mm256_xor_si256(c1, tuaktk_rotateLeftAvx2(c3, 1));
+    const __m256i d3 = _mm256_xor_si256(c2, tuaktk_rotateLeftAvx2(c4, 1));
+    const __m256i d4 = _mm256_xor_si256(c3, tuaktk_rotateLeftAvx2(c0, 1));
+
+    // Rho, Pi, Chi and Iota, plane by plane (~b & c being ANDNOT(b, c)).
+    b0 = _mm256_xor_si256(input[0], d0);
+    b1 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[6], d1), 44);
+    b2 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[12], d2), 43);
+    b3 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[18], d3), 21);
+    b4 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[24], d4), 14);
+
+    output[0] = _mm256_xor_si256(_mm256_xor_si256(b0, _mm256_andnot_si256(b1, b2)), _mm256_set1_epi64x((long long)roundConstant));
+    output[1] = _mm256_xor_si256(b1, _mm256_andnot_si256(b2, b3));
+    output[2] = _mm256_xor_si256(b2, _mm256_andnot_si256(b3, b4));
+    output[3] = _mm256_xor_si256(b3, _mm256_andnot_si256(b4, b0));
+    output[4] = _mm256_xor_si256(b4, _mm256_andnot_si256(b0, b1));
+
+    b0 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[3], d3), 28);
+    b1 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[9], d4), 20);
+    b2 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[10], d0), 3);
+    b3 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[16], d1), 45);
+    b4 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[22], d2), 61);
+
+    output[5] = _mm256_xor_si256(b0, _mm256_andnot_si256(b1, b2));
+    output[6] = _mm256_xor_si256(b1, _mm256_andnot_si256(b2, b3));
+    output[7] = _mm256_xor_si256(b2, _mm256_andnot_si256(b3, b4));
+    output[8] = _mm256_xor_si256(b3, _mm256_andnot_si256(b4, b0));
+    output[9] = _mm256_xor_si256(b4, _mm256_andnot_si256(b0, b1));
+
+    b0 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[1], d1), 1);
+    b1 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[7], d2), 6);
+    b2 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[13], d3), 25);
+    b3 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[19], d4), 8);
+    b4 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[20], d0), 18);
+
+    output[10] = _mm256_xor_si256(b0, _mm256_andnot_si256(b1, b2));
+    output[11] = _mm256_xor_si256(b1, _mm256_andnot_si256(b2, b3));
+    output[12] = _mm256_xor_si256(b2, _mm256_andnot_si256(b3, b4));
+    output[13] = _mm256_xor_si256(b3, _mm256_andnot_si256(b4, b0));
+    output[14] = _mm256_xor_si256(b4, _mm256_andnot_si256(b0, b1));
+
+    b0 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[4], d4), 27);
+    b1 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[5], d0), 36);
+    b2 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[11], d1), 10);
+    b3 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[17], d2), 15);
+    b4 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[23], d3), 56);
+
+    output[15] = _mm256_xor_si256(b0, _mm256_andnot_si256(b1, b2));
+    output[16] = _mm256_xor_si256(b1, _mm256_andnot_si256(b2, b3));
+    output[17] = _mm256_xor_si256(b2, _mm256_andnot_si256(b3, b4));
+    output[18] = _mm256_xor_si256(b3, _mm256_andnot_si256(b4, b0));
+    output[19] = _mm256_xor_si256(b4, _mm256_andnot_si256(b0, b1));
+
+    b0 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[2], d2), 62);
+    b1 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[8], d3), 55);
+    b2 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[14], d4), 39);
+    b3 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[15], d0), 41);
+    b4 = tuaktk_rotateLeftAvx2(_mm256_xor_si256(input[21], d1), 2);
+
+    output[20] = _mm256_xor_si256(b0, _mm256_andnot_si256(b1, b2));
+    output[21] = _mm256_xor_si256(b1, _mm256_andnot_si256(b2, b3));
+    output[22] = _mm256_xor_si256(b2, _mm256_andnot_si256(b3, b4));
+    output[23] = _mm256_xor_si256(b3, _mm256_andnot_si256(b4, b0));
+    output[24] = _mm256_xor_si256(b4, _mm256_andnot_si256(b0, b1));
+}
+
+// Note: VPROLQ takes an immediate count, that is only known once inlined.
+__attribute__((target("avx512f"))) static __m512i tuaktk_rotateLeftAvx512(const __m512i value,
+                                                                         const int count)
+{
+    return _mm512_rolv_epi64(value,
+                             _mm512_set1_epi64(count));
+}
+
+// Same as tuaktk_computeKeccakRound(), on 8 buffers. VPTERNLOGQ computes
+// the three-way XORs of Theta (0x96) and a ^ (~b & c) for Chi (0xD2).
+__attribute__((target("avx512f"))) static void tuaktk_computeKeccakRoundAvx512(const __m512i input[TUAKTK_KECCAK_LANES_COUNT],
+                                                                              const uint64_t roundConstant,
+                                                                              __m512i output[TUAKTK_KECCAK_LANES_COUNT])
+{
+    __m512i b0, b1, b2, b3, b4;
+
+    // Theta.
+    const __m512i c0 = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(input[0], input[5], input[10], 0x96), input[15], input[20], 0x96);
+    const __m512i c1 = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(input[1], input[6], input[11], 0x96), input[16], input[21], 0x96);
+    const __m512i c2 = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(input[2], input[7], input[12], 0x96), input[17], input[22], 0x96);
+    const __m512i c3 = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(input[3], input[8], input[13], 0x96), input[18], input[23], 0x96);
+    const __m512i c4 = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(input[4], input[9], input[14], 0x96), input[19], input[24], 0x96);
+
+    const __m512i d0 = _mm512_xor_si512(c4, tuaktk_rotateLeftAvx512(c1, 1));
+    const __m512i d1 = _mm512_xor_si512(c0, tuaktk_rotateLeftAvx512(c2, 1));
+    const __m512i d2 = _mm512_xor_si512(c1, tuaktk_rotateLeftAvx512(c3, 1));
+    const __m512i d3 = _mm512_xor_si512(c2, tuaktk_rotateLeftAvx512(c4, 1));
+    const __m512i d4 = _mm512_xor_si512(c3, tuaktk_rotateLeftAvx512(c0, 1));
+
+    // Rho, Pi, Chi and Iota, plane by plane.
+    b0 = _mm512_xor_si512(input[0], d0);
+    b1 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[6], d1), 44);
+    b2 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[12], d2), 43);
+    b3 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[18], d3), 21);
+    b4 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[24], d4), 14);
+
+    output[0] = _mm512_xor_si512(_mm512_ternarylogic_epi64(b0, b1, b2, 0xD2), _mm512_set1_epi64((long long)roundConstant));
+    output[1] = _mm512_ternarylogic_epi64(b1, b2, b3, 0xD2);
+    output[2] = _mm512_ternarylogic_epi64(b2, b3, b4, 0xD2);
+    output[3] = _mm512_ternarylogic_epi64(b3, b4, b0, 0xD2);
+    output[4] = _mm512_ternarylogic_epi64(b4, b0, b1, 0xD2);
+
+    b0 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[3], d3), 28);
+    b1 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[9], d4), 20);
+    b2 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[10], d0), 3);
+    b3 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[16], d1), 45);
+    b4 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[22], d2), 61);
+
+    output[5] = _mm512_ternarylogic_epi64(b0, b1, b2, 0xD2);
+    output[6] = _mm512_ternarylogic_epi64(b1, b2, b3, 0xD2);
+    output[7] = _mm512_ternarylogic_epi64(b2, b3, b4, 0xD2);
+    output[8] = _mm512_ternarylogic_epi64(b3, b4, b0, 0xD2);
+    output[9] = _mm512_ternarylogic_epi64(b4, b0, b1, 0xD2);
+
+    b0 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[1], d1), 1);
+    b1 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[7], d2), 6);
+    b2 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[13], d3), 25);
+    b3 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[19], d4), 8);
+    b4 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[20], d0), 18);
+
+    output[10] = _mm512_ternarylogic_epi64(b0, b1, b2, 0xD2);
+    output[11] = _mm512_ternarylogic_epi64(b1, b2, b3, 0xD2);
+    output[12] = _mm512_ternarylogic_epi64(b2, b3, b4, 0xD2);
+    output[13] = _mm512_ternarylogic_epi64(b3, b4, b0, 0xD2);
+    output[14] = _mm512_ternarylogic_epi64(b4, b0, b1, 0xD2);
+
+    b0 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[4], d4), 27);
+    b1 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[5], d0), 36);
+    b2 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[11], d1), 10);
+    b3 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[17], d2), 15);
+    b4 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[23], d3), 56);
+
+    output[15] = _mm512_ternarylogic_epi64(b0, b1, b2, 0xD2);
+    output[16] = _mm512_ternarylogic_epi64(b1, b2, b3, 0xD2);
+    output[17] = _mm512_ternarylogic_epi64(b2, b3, b4, 0xD2);
+    output[18] = _mm512_ternarylogic_epi64(b3, b4, b0, 0xD2);
+    output[19] = _mm512_ternarylogic_epi64(b4, b0, b1, 0xD2);
+
+    b0 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[2], d2), 62);
+    b1 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[8], d3), 55);
+    b2 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[14], d4), 39);
+    b3 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[15], d0), 41);
+    b4 = tuaktk_rotateLeftAvx512(_mm512_xor_si512(input[21], d1), 2);
+
+    output[20] = _mm512_ternarylogic_epi64(b0, b1, b2, 0xD2);
+    output[21] = _mm512_ternarylogic_epi64(b1, b2, b3, 0xD2);
+    output[22] = _mm512_ternarylogic_epi64(b2, b3, b4, 0xD2);
+    output[23] = _mm512_ternarylogic_epi64(b3, b4, b0, 0xD2);
+    output[24] = _mm512_ternarylogic_epi64(b4, b0, b1, 0xD2);
+}
+
+__attribute__((target("avx2"))) static void tuaktk_keccakF1600BuffersAvx2(uint64_t states[TUAKTK_KECCAK_LANES_COUNT][TUAKTK_MAXIMUM_BUFFERS_COUNT])
+{
+    __m256i lanes[TUAKTK_KECCAK_LANES_COUNT];
+    __m256i temporaryLanes[TUAKTK_KECCAK_LANES_COUNT];
+
+    for (int firstBuffer = 0; firstBuffer < TUAKTK_MAXIMUM_BUFFERS_COUNT; firstBuffer += TUAKTK_AVX2_BUFFERS_COUNT)
+    {
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            lanes[lane] = _mm256_loadu_si256((const __m256i *)&states[lane][firstBuffer]);
+        }
+
+        for (int round = 0; round < TUAKTK_KECCAK_ROUNDS_COUNT; round += 2)
+        {
+            tuaktk_computeKeccakRoundAvx2(lanes,
+                                          TUAKTK_ROUND_CONSTANTS[round],
+                                          temporaryLanes);
+            tuaktk_computeKeccakRoundAvx2(temporaryLanes,
+                                          TUAKTK_ROUND_CONSTANTS[round + 1],
+                                          lanes);
+        }
+
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            _mm256_storeu_si256((__m256i *)&states[lane][firstBuffer],
+                                lanes[lane]);
+        }
+    }
+}
+
+__attribute__((target("avx512f"))) static void tuaktk_keccakF1600BuffersAvx512(uint64_t states[TUAKTK_KECCAK_LANES_COUNT][TUAKTK_MAXIMUM_BUFFERS_COUNT])
+{
+    __m512i lanes[TUAKTK_KECCAK_LANES_COUNT];
+    __m512i temporaryLanes[TUAKTK_KECCAK_LANES_COUNT];
+
+    for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+    {
+        lanes[lane] = _mm512_loadu_si512(&states[lane][0]);
+    }
+
+    for (int round = 0; round < TUAKTK_KECCAK_ROUNDS_COUNT; round += 2)
+    {
+        tuaktk_computeKeccakRoundAvx512(lanes,
+                                        TUAKTK_ROUND_CONSTANTS[round],
+                                        temporaryLanes);
+        tuaktk_computeKeccakRoundAvx512(temporaryLanes,
+                                        TUAKTK_ROUND_CONSTANTS[round + 1],
+                                        lanes);
+    }
+
+    for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+    {
+        _mm512_storeu_si512(&states[lane][0],
+                            lanes[lane]);
+    }
+}
+#endif
+
+// Pushes a big-endian value into the (little-endian) Keccak state.
+static void tuaktk_pushData(unsigned char state[TUAKTK_KECCAK_STATE_LENGTH],
+                            const size_t offset,
+                            const unsigned char *const data,
+                            const size_t dataLength)
+{
+    for (size_t index = 0; index < dataLength; index++)
+    {
+        state[offset + index] = data[dataLength - 1 - index];
+    }
+}
+
+// Pops a big-endian value from the (little-endian) Keccak state.
+static void tuaktk_popData(const unsigned char state[TUAKTK_KECCAK_STATE_LENGTH],
+                           const size_t offset,
+                           unsigned char *const data,
+                           const size_t dataLength)
+{
+    for (size_t index = 0; index < dataLength; index++)
+    {
+        data[index] = state[offset + dataLength - 1 - index];
+    }
+}
+
+// Builds the initial Keccak state of a TUAK function, as lanes.
+static bool tuaktk_initializeLanes(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                                   unsigned char instance,
+                                   const unsigned char *const rand,
+                                   const unsigned char *const amf,
+                                   const unsigned char *const sqn,
+                                   const unsigned char *const k,
+                                   const size_t kLength,
+                                   uint64_t lanes[TUAKTK_KECCAK_LANES_COUNT])
+{
+    assert(topc != NULL);
+    assert(k != NULL);
+    assert(lanes != NULL);
+
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+
+    if ((kLength != 16) && (kLength != 32))
+    {
+        return false;
+    }
+
+    if (kLength == 32)
+    {
+        instance |= TUAKTK_INSTANCE__KEY_256;
+    }
+
+    memset(state,
+           0,
+           TUAKTK_KECCAK_STATE_LENGTH);
+
+    tuaktk_pushData(state,
+                    TUAKTK_OFFSET__TOPC,
+                    topc,
+                    TUAKTK_TOPC_LENGTH);
+
+    state[TUAKTK_OFFSET__INSTANCE] = instance;
+
+    tuaktk_pushData(state,
+                    TUAKTK_OFFSET__ALGONAME,
+                    (const unsigned char *)TUAKTK_ALGONAME,
+                    sizeof(TUAKTK_ALGONAME) - 1);
+
+    if (rand != NULL)
+    {
+        tuaktk_pushData(state,
+                        TUAKTK_OFFSET__RAND,
+                        rand,
+                        TUAKTK_RAND_LENGTH);
+    }
+
+    if (amf != NULL)
+    {
+        tuaktk_pushData(state,
+                        TUAKTK_OFFSET__AMF,
+                        amf,
+                        TUAKTK_AMF_LENGTH);
+    }
+
+    if (sqn != NULL)
+    {
+        tuaktk_pushData(state,
+                        TUAKTK_OFFSET__SQN,
+                        sqn,
+                        TUAKTK_SQN_LENGTH);
+    }
+
+    tuaktk_pushData(state,
+                    TUAKTK_OFFSET__KEY,
+                    k,
+                    kLength);
+
+    state[TUAKTK_OFFSET__PADDING] = 0x1F;
+    state[TUAKTK_OFFSET__LAST_RATE_BYTE] = 0x80;
+
+    for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+    {
+        lanes[lane] = 0;
+
+        for (int byteIndex = 7; byteIndex >= 0; byteIndex--)
+        {
+            lanes[lane] = (lanes[lane] << 8) | state[(lane * 8) + byteIndex];
+        }
+    }
+
+    return true;
+}
+
+static void tuaktk_storeLanes(const uint64_t lanes[TUAKTK_KECCAK_LANES_COUNT],
+                              unsigned char state[TUAKTK_KECCAK_STATE_LENGTH])
+{
+    for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+    {
+        for (int byteIndex = 0; byteIndex < 8; byteIndex++)
+        {
+            state[(lane * 8) + byteIndex] = (unsigned char)(lanes[lane] >> (8 * byteIndex));
+        }
+    }
+}
+
+static bool tuaktk_computeCore(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                               const unsigned char instance,
+                               const unsigned char *const rand,
+                               const unsigned char *const amf,
+                               const unsigned char *const sqn,
+                               const unsigned char *const k,
+                               const size_t kLength,
+                               const unsigned int iterations,
+                               unsigned char state[TUAKTK_KECCAK_STATE_LENGTH])
+{
+    assert(state != NULL);
+
+    uint64_t lanes[TUAKTK_KECCAK_LANES_COUNT];
+
+    if ((iterations == 0) ||
+        !tuaktk_initializeLanes(topc,
+                                instance,
+                                rand,
+                                amf,
+                                sqn,
+                                k,
+                                kLength,
+                                lanes))
+    {
+        return false;
+    }
+
+    for (unsigned int iteration = 0; iteration < iterations; iteration++)
+    {
+        tuaktk_keccakF1600(lanes);
+    }
+
+    tuaktk_storeLanes(lanes,
+                      state);
+
+    return true;
+}
+
+static bool tuaktk_getF2345Instance(const size_t resLength,
+                                    const size_t ckLength,
+                                    const size_t ikLength,
+                                    unsigned char *const pInstance)
+{
+    switch (resLength)
+    {
+    case 4:
+        break;
+
+    case 8:
+        *pInstance |= 0x08;
+        break;
+
+    case 16:
+        *pInstance |= 0x10;
+        break;
+
+    case 32:
+        *pInstance |= 0x20;
+        break;
+
+    default:
+        return false;
+    }
+
+    if (((ckLength != 16) && (ckLength != 32)) ||
+        ((ikLength != 16) && (ikLength != 32)))
+    {
+        return false;
+    }
+
+    if (ckLength == 32)
+    {
+        *pInstance |= TUAKTK_INSTANCE__CK_256;
+    }
+
+    if (ikLength == 32)
+    {
+        *pInstance |= TUAKTK_INSTANCE__IK_256;
+    }
+
+    return true;
+}
+
+static bool tuaktk_getMacInstance(const size_t macLength,
+                                  unsigned char *const pInstance)
+{
+    switch (macLength)
+    {
+    case 8:
+        *pInstance |= 0x08;
+        return true;
+
+    case 16:
+        *pInstance |= 0x10;
+        return true;
+
+    case 32:
+        *pInstance |= 0x20;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool tuaktk_computeTopc(const unsigned char *const k,
+                        const size_t kLength,
+                        const unsigned char top[TUAKTK_TOP_LENGTH],
+                        const unsigned int iterations,
+                        unsigned char topc[TUAKTK_TOPC_LENGTH])
+{
+    assert(top != NULL);
+    assert(topc != NULL);
+
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+
+    if (!tuaktk_computeCore(top,
+                            0x00,
+                            NULL,
+                            NULL,
+                            NULL,
+                            k,
+                            kLength,
+                            iterations,
+                            state))
+    {
+        return false;
+    }
+
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__TOPC,
+                   topc,
+                   TUAKTK_TOPC_LENGTH);
+
+    return true;
+}
+
+bool tuaktk_f1(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+               const unsigned char *const k,
+               const size_t kLength,
+               const unsigned char rand[TUAKTK_RAND_LENGTH],
+               const unsigned char sqn[TUAKTK_SQN_LENGTH],
+               const unsigned char amf[TUAKTK_AMF_LENGTH],
+               const unsigned int iterations,
+               unsigned char *const macA,
+               const size_t macLength)
+{
+    assert(rand != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(macA != NULL);
+
+    unsigned char instance = TUAKTK_INSTANCE__F1;
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+
+    if (!tuaktk_getMacInstance(macLength,
+                               &instance) ||
+        !tuaktk_computeCore(topc,
+                            instance,
+                            rand,
+                            amf,
+                            sqn,
+                            k,
+                            kLength,
+                            iterations,
+                            state))
+    {
+        return false;
+    }
+
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__MAC,
+                   macA,
+                   macLength);
+
+    return true;
+}
+
+bool tuaktk_f1Star(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                   const unsigned char *const k,
+                   const size_t kLength,
+                   const unsigned char rand[TUAKTK_RAND_LENGTH],
+                   const unsigned char sqn[TUAKTK_SQN_LENGTH],
+                   const unsigned char amf[TUAKTK_AMF_LENGTH],
+                   const unsigned int iterations,
+                   unsigned char *const macS,
+                   const size_t macLength)
+{
+    assert(rand != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(macS != NULL);
+
+    unsigned char instance = TUAKTK_INSTANCE__F1_STAR;
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+
+    if (!tuaktk_getMacInstance(macLength,
+                               &instance) ||
+        !tuaktk_computeCore(topc,
+                            instance,
+                            rand,
+                            amf,
+                            sqn,
+                            k,
+                            kLength,
+                            iterations,
+                            state))
+    {
+        return false;
+    }
+
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__MAC,
+                   macS,
+                   macLength);
+
+    return true;
+}
+
+bool tuaktk_f2345(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                  const unsigned char *const k,
+                  const size_t kLength,
+                  const unsigned char rand[TUAKTK_RAND_LENGTH],
+                  const unsigned int iterations,
+                  unsigned char *const res,
+                  const size_t resLength,
+                  unsigned char *const ck,
+                  const size_t ckLength,
+                  unsigned char *const ik,
+                  const size_t ikLength,
+                  unsigned char ak[TUAKTK_AK_LENGTH])
+{
+    assert(rand != NULL);
+    assert(res != NULL);
+    assert(ck != NULL);
+    assert(ik != NULL);
+    assert(ak != NULL);
+
+    unsigned char instance = TUAKTK_INSTANCE__F2345;
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+
+    if (!tuaktk_getF2345Instance(resLength,
+                                 ckLength,
+                                 ikLength,
+                                 &instance) ||
+        !tuaktk_computeCore(topc,
+                            instance,
+                            rand,
+                            NULL,
+                            NULL,
+                            k,
+                            kLength,
+                            iterations,
+                            state))
+    {
+        return false;
+    }
+
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__RES,
+                   res,
+                   resLength);
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__CK,
+                   ck,
+                   ckLength);
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__IK,
+                   ik,
+                   ikLength);
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__AK,
+                   ak,
+                   TUAKTK_AK_LENGTH);
+
+    return true;
+}
+
+bool tuaktk_f5Star(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                   const unsigned char *const k,
+                   const size_t kLength,
+                   const unsigned char rand[TUAKTK_RAND_LENGTH],
+                   const unsigned int iterations,
+                   unsigned char akStar[TUAKTK_AK_LENGTH])
+{
+    assert(rand != NULL);
+    assert(akStar != NULL);
+
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+
+    if (!tuaktk_computeCore(topc,
+                            TUAKTK_INSTANCE__F5_STAR,
+                            rand,
+                            NULL,
+                            NULL,
+                            k,
+                            kLength,
+                            iterations,
+                            state))
+    {
+        return false;
+    }
+
+    tuaktk_popData(state,
+                   TUAKTK_OFFSET__AK,
+                   akStar,
+                   TUAKTK_AK_LENGTH);
+
+    return true;
+}
+
+bool tuaktk_generateAuthenticationVector(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                                         const unsigned char *const k,
+                                         const size_t kLength,
+                                         const unsigned char rand[TUAKTK_RAND_LENGTH],
+                                         const unsigned char sqn[TUAKTK_SQN_LENGTH],
+                                         const unsigned char amf[TUAKTK_AMF_LENGTH],
+                                         const unsigned int iterations,
+                                         const size_t resLength,
+                                         const size_t macLength,
+                                         const size_t ckLength,
+                                         const size_t ikLength,
+                                         unsigned char *const av)
+{
+    assert(rand != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(av != NULL);
+
+    unsigned char *const xres = &av[TUAKTK_RAND_LENGTH];
+    unsigned char *const ck = &xres[resLength];
+    unsigned char *const ik = &ck[ckLength];
+    unsigned char *const autn = &ik[ikLength];
+
+    if (rand != av)
+    {
+        memmove(av,
+                rand,
+                TUAKTK_RAND_LENGTH);
+    }
+
+    // Note: RAND is read from 'av' from now on.
+    if (!tuaktk_f2345(topc,
+                      k,
+                      kLength,
+                      av,
+                      iterations,
+                      xres,
+                      resLength,
+                      ck,
+                      ckLength,
+                      ik,
+                      ikLength,
+                      autn) ||
+        !tuaktk_f1(topc,
+                   k,
+                   kLength,
+                   av,
+                   sqn,
+                   amf,
+                   iterations,
+                   &autn[TUAKTK_SQN_LENGTH + TUAKTK_AMF_LENGTH],
+                   macLength))
+    {
+        return false;
+    }
+
+    for (int index = 0; index < TUAKTK_SQN_LENGTH; index++)
+    {
+        autn[index] ^= sqn[index];
+    }
+
+    memcpy(&autn[TUAKTK_SQN_LENGTH],
+           amf,
+           TUAKTK_AMF_LENGTH);
+
+    return true;
+}
+
+bool tuaktk_generateAuthenticationVectors(const size_t buffersCount,
+                                          const unsigned char *const tops,
+                                          unsigned char *const topcs,
+                                          const unsigned char *const ks,
+                                          const size_t kLength,
+                                          const unsigned char sqn[TUAKTK_SQN_LENGTH],
+                                          const unsigned char amf[TUAKTK_AMF_LENGTH],
+                                          const unsigned int iterations,
+                                          const size_t resLength,
+                                          const size_t macLength,
+                                          const size_t ckLength,
+                                          const size_t ikLength,
+                                          unsigned char *const avs)
+{
+    assert(buffersCount <= TUAKTK_MAXIMUM_BUFFERS_COUNT);
+    assert(topcs != NULL);
+    assert(ks != NULL);
+    assert(sqn != NULL);
+    assert(amf != NULL);
+    assert(avs != NULL);
+
+    const size_t avLength = TUAKTK_AV_LENGTH(resLength, macLength, ckLength, ikLength);
+    unsigned char f1Instance = TUAKTK_INSTANCE__F1;
+    unsigned char f2345Instance = TUAKTK_INSTANCE__F2345;
+    unsigned char state[TUAKTK_KECCAK_STATE_LENGTH];
+    uint64_t lanes[TUAKTK_KECCAK_LANES_COUNT];
+
+    // The unused buffers are permuted as well, zeroed.
+    uint64_t f1States[TUAKTK_KECCAK_LANES_COUNT][TUAKTK_MAXIMUM_BUFFERS_COUNT] = {{0}};
+    uint64_t f2345States[TUAKTK_KECCAK_LANES_COUNT][TUAKTK_MAXIMUM_BUFFERS_COUNT] = {{0}};
+
+    if ((iterations == 0) ||
+        !tuaktk_getMacInstance(macLength,
+                               &f1Instance) ||
+        !tuaktk_getF2345Instance(resLength,
+                                 ckLength,
+                                 ikLength,
+                                 &f2345Instance))
+    {
+        return false;
+    }
+
+    if (tops != NULL)
+    {
+        for (size_t buffer = 0; buffer < buffersCount; buffer++)
+        {
+            if (!tuaktk_initializeLanes(&tops[buffer * TUAKTK_TOP_LENGTH],
+                                        0x00,
+                                        NULL,
+                                        NULL,
+                                        NULL,
+                                        &ks[buffer * kLength],
+                                        kLength,
+                                        lanes))
+            {
+                return false;
+            }
+
+            for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+            {
+                f1States[lane][buffer] = lanes[lane];
+            }
+        }
+
+        for (unsigned int iteration = 0; iteration < iterations; iteration++)
+        {
+            tuaktk_keccakF1600Buffers(f1States);
+        }
+
+        for (size_t buffer = 0; buffer < buffersCount; buffer++)
+        {
+            for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+            {
+                lanes[lane] = f1States[lane][buffer];
+            }
+
+            tuaktk_storeLanes(lanes,
+                              state);
+            tuaktk_popData(state,
+                           TUAKTK_OFFSET__TOPC,
+                           &topcs[buffer * TUAKTK_TOPC_LENGTH],
+                           TUAKTK_TOPC_LENGTH);
+        }
+    }
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        const unsigned char *const rand = &avs[buffer * avLength];
+
+        if (!tuaktk_initializeLanes(&topcs[buffer * TUAKTK_TOPC_LENGTH],
+                                    f2345Instance,
+                                    rand,
+                                    NULL,
+                                    NULL,
+                                    &ks[buffer * kLength],
+                                    kLength,
+                                    lanes))
+        {
+            return false;
+        }
+
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            f2345States[lane][buffer] = lanes[lane];
+        }
+
+        // Note: the key length is already checked.
+        tuaktk_initializeLanes(&topcs[buffer * TUAKTK_TOPC_LENGTH],
+                               f1Instance,
+                               rand,
+                               amf,
+                               sqn,
+                               &ks[buffer * kLength],
+                               kLength,
+                               lanes);
+
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            f1States[lane][buffer] = lanes[lane];
+        }
+    }
+
+    for (unsigned int iteration = 0; iteration < iterations; iteration++)
+    {
+        tuaktk_keccakF1600Buffers(f2345States);
+        tuaktk_keccakF1600Buffers(f1States);
+    }
+
+    for (size_t buffer = 0; buffer < buffersCount; buffer++)
+    {
+        unsigned char *const xres = &avs[(buffer * avLength) + TUAKTK_RAND_LENGTH];
+        unsigned char *const ck = &xres[resLength];
+        unsigned char *const ik = &ck[ckLength];
+        unsigned char *const autn = &ik[ikLength];
+
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            lanes[lane] = f2345States[lane][buffer];
+        }
+
+        tuaktk_storeLanes(lanes,
+                          state);
+        tuaktk_popData(state,
+                       TUAKTK_OFFSET__RES,
+                       xres,
+                       resLength);
+        tuaktk_popData(state,
+                       TUAKTK_OFFSET__CK,
+                       ck,
+                       ckLength);
+        tuaktk_popData(state,
+                       TUAKTK_OFFSET__IK,
+                       ik,
+                       ikLength);
+        tuaktk_popData(state,
+                       TUAKTK_OFFSET__AK,
+                       autn,
+                       TUAKTK_AK_LENGTH);
+
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            lanes[lane] = f1States[lane][buffer];
+        }
+
+        tuaktk_storeLanes(lanes,
+                          state);
+        tuaktk_popData(state,
+                       TUAKTK_OFFSET__MAC,
+                       &autn[TUAKTK_SQN_LENGTH + TUAKTK_AMF_LENGTH],
+                       macLength);
+
+        for (int index = 0; index < TUAKTK_SQN_LENGTH; index++)
+        {
+            autn[index] ^= sqn[index];
+        }
+
+        memcpy(&autn[TUAKTK_SQN_LENGTH],
+               amf,
+               TUAKTK_AMF_LENGTH);
+    }
+
+    return true;
+}
+
+bool tuaktk_generateAuts(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                         const unsigned char *const k,
+                         const size_t kLength,
+                         const unsigned char rand[TUAKTK_RAND_LENGTH],
+                         const unsigned char sqnMs[TUAKTK_SQN_LENGTH],
+                         const unsigned int iterations,
+                         unsigned char *const auts,
+                         const size_t macLength)
+{
+    assert(sqnMs != NULL);
+    assert(auts != NULL);
+
+    // The AMF used for MAC-S is a dummy all-zero value (TS 33.102, 6.3.3).
+    const unsigned char dummyAmf[TUAKTK_AMF_LENGTH] = {0x00, 0x00};
+    unsigned char akStar[TUAKTK_AK_LENGTH];
+
+    if (!tuaktk_f5Star(topc,
+                       k,
+                       kLength,
+                       rand,
+                       iterations,
+                       akStar))
+    {
+        return false;
+    }
+
+    for (int index = 0; index < TUAKTK_SQN_LENGTH; index++)
+    {
+        auts[index] = sqnMs[index] ^ akStar[index];
+    }
+
+    return tuaktk_f1Star(topc,
+                         k,
+                         kLength,
+                         rand,
+                         sqnMs,
+                         dummyAmf,
+                         iterations,
+                         &auts[TUAKTK_SQN_LENGTH],
+                         macLength);
+}
+
+const char *tuaktk_getBuffersImplementation(void)
+{
+#ifdef TUAKTK_WITH_AVX
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return "AVX-512";
+    }
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return "AVX2";
+    }
+#endif
+
+    return "scalar";
+}
+
+void tuaktk_keccakF1600(uint64_t state[TUAKTK_KECCAK_LANES_COUNT])
+{
+    assert(state != NULL);
+
+    uint64_t temporaryState[TUAKTK_KECCAK_LANES_COUNT];
+
+    // Two rounds per iteration, so that the state ends up in place.
+    for (int round = 0; round < TUAKTK_KECCAK_ROUNDS_COUNT; round += 2)
+    {
+        tuaktk_computeKeccakRound(state,
+                                  TUAKTK_ROUND_CONSTANTS[round],
+                                  temporaryState);
+        tuaktk_computeKeccakRound(temporaryState,
+                                  TUAKTK_ROUND_CONSTANTS[round + 1],
+                                  state);
+    }
+}
+
+void tuaktk_keccakF1600Buffers(uint64_t states[TUAKTK_KECCAK_LANES_COUNT][TUAKTK_MAXIMUM_BUFFERS_COUNT])
+{
+    assert(states != NULL);
+
+    static int implementation = -1;
+    uint64_t lanes[TUAKTK_KECCAK_LANES_COUNT];
+
+    // Note: concurrent threads may only compute the same value.
+    if (implementation < 0)
+    {
+        const char *const name = tuaktk_getBuffersImplementation();
+
+        implementation = (strcmp(name, "AVX-512") == 0)
+                             ? TUAKTK_BUFFERS_IMPLEMENTATION__AVX_512
+                         : (strcmp(name, "AVX2") == 0)
+                             ? TUAKTK_BUFFERS_IMPLEMENTATION__AVX2
+                             : TUAKTK_BUFFERS_IMPLEMENTATION__SCALAR;
+    }
+
+#ifdef TUAKTK_WITH_AVX
+    if (implementation == TUAKTK_BUFFERS_IMPLEMENTATION__AVX_512)
+    {
+        tuaktk_keccakF1600BuffersAvx512(states);
+
+        return;
+    }
+
+    if (implementation == TUAKTK_BUFFERS_IMPLEMENTATION__AVX2)
+    {
+        tuaktk_keccakF1600BuffersAvx2(states);
+
+        return;
+    }
+#endif
+
+    for (int buffer = 0; buffer < TUAKTK_MAXIMUM_BUFFERS_COUNT; buffer++)
+    {
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            lanes[lane] = states[lane][buffer];
+        }
+
+        tuaktk_keccakF1600(lanes);
+
+        for (int lane = 0; lane < TUAKTK_KECCAK_LANES_COUNT; lane++)
+        {
+            states[lane][buffer] = lanes[lane];
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/****************************************************************************\
+*
+* This file is provided under the MIT license (see the following Web site
+* for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef __TUAK_TOOLKIT_H__
+#define __TUAK_TOOLKIT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Definitions
+ *
+ * Software implementation of the TUAK algorithm set (3GPP TS 35.231).
+ *
+ * All the lengths are expressed in bytes:
+ *   - K  : 16 or 32.
+ *   - MAC: 8, 16 or 32.
+ *   - RES: 4, 8, 16 or 32.
+ *   - CK : 16 or 32.
+ *   - IK : 16 or 32.
+ */
+#define TUAKTK_KECCAK_STATE_LENGTH 200
+#define TUAKTK_KECCAK_LANES_COUNT 25
+
+#define TUAKTK_TOP_LENGTH 32
+#define TUAKTK_TOPC_LENGTH 32
+#define TUAKTK_RAND_LENGTH 16
+#define TUAKTK_SQN_LENGTH 6
+#define TUAKTK_AMF_LENGTH 2
+#define TUAKTK_AK_LENGTH 6
+
+#define TUAKTK_MAXIMUM_KEY_LENGTH 32
+#define TUAKTK_MAXIMUM_MAC_LENGTH 32
+#define TUAKTK_MAXIMUM_RES_LENGTH 32
+#define TUAKTK_MAXIMUM_CK_LENGTH 32
+#define TUAKTK_MAXIMUM_IK_LENGTH 32
+#define TUAKTK_MAXIMUM_AUTS_LENGTH (TUAKTK_SQN_LENGTH + TUAKTK_MAXIMUM_MAC_LENGTH)
+
+// RAND || XRES || CK || IK || AUTN, as returned by the Luna CKM_TUAK
+// mechanism.
+#define TUAKTK_AV_LENGTH(resLength, macLength, ckLength, ikLength) \
+    (TUAKTK_RAND_LENGTH + (resLength) + (ckLength) + (ikLength) + TUAKTK_SQN_LENGTH + TUAKTK_AMF_LENGTH + (macLength))
+#define TUAKTK_MAXIMUM_AV_LENGTH TUAKTK_AV_LENGTH(TUAKTK_MAXIMUM_RES_LENGTH, TUAKTK_MAXIMUM_MAC_LENGTH, TUAKTK_MAXIMUM_CK_LENGTH, TUAKTK_MAXIMUM_IK_LENGTH)
+
+// Maximum number of Keccak states permuted together (one per 64-bit lane of
+// an AVX-512 register).
+#define TUAKTK_MAXIMUM_BUFFERS_COUNT 8
+
+/*
+ * Interface
+ *
+ * Notes:
+ *   - The functions returning a boolean are returning 'false' if one of the
+ *     requested lengths is not supported by TS 35.231.
+ */
+bool tuaktk_computeTopc(const unsigned char *const k,
+                        const size_t kLength,
+                        const unsigned char top[TUAKTK_TOP_LENGTH],
+                        const unsigned int iterations,
+                        unsigned char topc[TUAKTK_TOPC_LENGTH]);
+
+bool tuaktk_f1(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+               const unsigned char *const k,
+               const size_t kLength,
+               const unsigned char rand[TUAKTK_RAND_LENGTH],
+               const unsigned char sqn[TUAKTK_SQN_LENGTH],
+               const unsigned char amf[TUAKTK_AMF_LENGTH],
+               const unsigned int iterations,
+               unsigned char *const macA,
+               const size_t macLength);
+
+bool tuaktk_f1Star(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                   const unsigned char *const k,
+                   const size_t kLength,
+                   const unsigned char rand[TUAKTK_RAND_LENGTH],
+                   const unsigned char sqn[TUAKTK_SQN_LENGTH],
+                   const unsigned char amf[TUAKTK_AMF_LENGTH],
+                   const unsigned int iterations,
+                   unsigned char *const macS,
+                   const size_t macLength);
+
+bool tuaktk_f2345(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                  const unsigned char *const k,
+                  const size_t kLength,
+                  const unsigned char rand[TUAKTK_RAND_LENGTH],
+                  const unsigned int iterations,
+                  unsigned char *const res,
+                  const size_t resLength,
+                  unsigned char *const ck,
+                  const size_t ckLength,
+                  unsigned char *const ik,
+                  const size_t ikLength,
+                  unsigned char ak[TUAKTK_AK_LENGTH]);
+
+bool tuaktk_f5Star(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                   const unsigned char *const k,
+                   const size_t kLength,
+                   const unsigned char rand[TUAKTK_RAND_LENGTH],
+                   const unsigned int iterations,
+                   unsigned char akStar[TUAKTK_AK_LENGTH]);
+
+// AUTN = (SQN xor AK) || AMF || MAC-A (TS 33.102, 6.3.2). 'rand' may be
+// the beginning of 'av'.
+bool tuaktk_generateAuthenticationVector(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                                         const unsigned char *const k,
+                                         const size_t kLength,
+                                         const unsigned char rand[TUAKTK_RAND_LENGTH],
+                                         const unsigned char sqn[TUAKTK_SQN_LENGTH],
+                                         const unsigned char amf[TUAKTK_AMF_LENGTH],
+                                         const unsigned int iterations,
+                                         const size_t resLength,
+                                         const size_t macLength,
+                                         const size_t ckLength,
+                                         const size_t ikLength,
+                                         unsigned char *const av);
+
+// Same as tuaktk_generateAuthenticationVector(), for up to
+// TUAKTK_MAXIMUM_BUFFERS_COUNT subscribers at once, their Keccak states being
+// permuted together. The keys, TOPs, TOPcs and AVs are stored one after the
+// other, and the RAND is read from the beginning of each AV. If 'tops' is
+// not NULL, the TOPcs are computed into 'topcs' first.
+bool tuaktk_generateAuthenticationVectors(const size_t buffersCount,
+                                          const unsigned char *const tops,
+                                          unsigned char *const topcs,
+                                          const unsigned char *const ks,
+                                          const size_t kLength,
+                                          const unsigned char sqn[TUAKTK_SQN_LENGTH],
+                                          const unsigned char amf[TUAKTK_AMF_LENGTH],
+                                          const unsigned int iterations,
+                                          const size_t resLength,
+                                          const size_t macLength,
+                                          const size_t ckLength,
+                                          const size_t ikLength,
+                                          unsigned char *const avs);
+
+// AUTS = (SQN_MS xor AK*) || MAC-S, as built by the USIM (TS 33.102, 6.3.3).
+bool tuaktk_generateAuts(const unsigned char topc[TUAKTK_TOPC_LENGTH],
+                         const unsigned char *const k,
+                         const size_t kLength,
+                         const unsigned char rand[TUAKTK_RAND_LENGTH],
+                         const unsigned char sqnMs[TUAKTK_SQN_LENGTH],
+                         const unsigned int iterations,
+                         unsigned char *const auts,
+                         const size_t macLength);
+
+// Returns 'AVX-512', 'AVX2' or 'scalar'.
+const char *tuaktk_getBuffersImplementation(void);
+
+void tuaktk_keccakF1600(uint64_t state[TUAKTK_KECCAK_LANES_COUNT]);
+
+// Permutes TUAKTK_MAXIMUM_BUFFERS_COUNT states together, stored lane by lane
+// (i.e. 'states[lane][buffer]').
+void tuaktk_keccakF1600Buffers(uint64_t states[TUAKTK_KECCAK_LANES_COUNT][TUAKTK_MAXIMUM_BUFFERS_COUNT]);
+
+#endif /* __TUAK_TOOLKIT_H__ */
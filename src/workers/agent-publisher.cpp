@@ -0,0 +1,153 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include "agent-publisher.hpp"
+
+AgentPublisher::AgentPublisher(const std::shared_ptr<ControlChannel> &_pControlChannel) : Publisher("Agent"),
+                                                                                         pControlChannel(_pControlChannel)
+{
+    assert(_pControlChannel != nullptr);
+
+    // Nothing else to do here.
+}
+
+void AgentPublisher::publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                           const unsigned long elapsedMicroSeconds)
+{
+    assert(&scenarii != nullptr);
+
+    WORKERS_BOARD_SCENARIO_RECORD record = {};
+
+    // Only the first error is written.
+    if (isLiveFailing)
+    {
+        return;
+    }
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        record = {};
+
+        getLiveRecord(*scenarii[scenarioIndex],
+                      elapsedMicroSeconds,
+                      record);
+
+        if (pControlChannel->send(ControlChannel::formatRecord(CONTROL_CHANNEL__LIVE,
+                                                               scenarioIndex,
+                                                               record)) != CKR_OK)
+        {
+            isLiveFailing = true;
+
+            return;
+        }
+    }
+}
+
+CK_RV AgentPublisher::publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                        const unsigned long membersCount)
+{
+    assert(&scenarii != nullptr);
+
+    CK_RV rv = CKR_OK;
+    WORKERS_BOARD_SCENARIO_RECORD record = {};
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        getRecord(*scenarii[scenarioIndex],
+                  record);
+
+        rv = pControlChannel->send(ControlChannel::formatRecord(CONTROL_CHANNEL__RESULTS,
+                                                                scenarioIndex,
+                                                                record));
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    rv = pControlChannel->send(std::string(CONTROL_CHANNEL__DONE " ") +
+                               std::to_string(membersCount));
+
+EXIT:
+    return rv;
+}
+
+CK_RV AgentPublisher::waitForStart(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                   unsigned long long &startMilliSeconds)
+{
+    assert(&scenarii != nullptr);
+    assert(&startMilliSeconds != nullptr);
+
+    CK_RV rv = CKR_OK;
+    std::string line = {};
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        rv = pControlChannel->send(std::string(CONTROL_CHANNEL__NAME " ") +
+                                   std::to_string(scenarioIndex) +
+                                   " " +
+                                   scenarii[scenarioIndex]->getUniqueString());
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+
+        rv = pControlChannel->send(std::string(CONTROL_CHANNEL__ALGORITHM " ") +
+                                   std::to_string(scenarioIndex) +
+                                   " " +
+                                   scenarii[scenarioIndex]->getVerifiedAlgorithm());
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+    rv = pControlChannel->send(CONTROL_CHANNEL__READY);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    rv = pControlChannel->receive(line);
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    if (strncmp(line.c_str(),
+                CONTROL_CHANNEL__START " ",
+                strlen(CONTROL_CHANNEL__START " ")) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Unexpected command of the coordinator (start expected).",
+                   rv);
+
+        goto EXIT;
+    }
+
+    // Note: the clocks of the agents are expected to be synchronized (e.g.
+    // NTP).
+    startMilliSeconds = strtoull(line.c_str() + strlen(CONTROL_CHANNEL__START " "),
+                                 nullptr,
+                                 10);
+
+EXIT:
+    return rv;
+}
@@ -0,0 +1,42 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef AGENT_PUBLISHER_HPP
+#define AGENT_PUBLISHER_HPP
+
+#include <memory>
+
+#include "control-channel.hpp"
+#include "publisher.hpp"
+
+// Publisher of an agent, through its connection to the coordinator (see
+// ControlChannel).
+class AgentPublisher : public Publisher
+{
+protected:
+    bool isLiveFailing = false;
+
+public:
+    const std::shared_ptr<ControlChannel> pControlChannel;
+
+    explicit AgentPublisher(const std::shared_ptr<ControlChannel> &pControlChannel);
+
+    void publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                               const unsigned long elapsedMicroSeconds) override;
+    CK_RV publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                            const unsigned long membersCount) override;
+
+    // Tells the coordinator that the scenarii are initialized, then returns
+    // the start time it chose.
+    CK_RV waitForStart(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                       unsigned long long &startMilliSeconds) override;
+};
+
+#endif /* AGENT_PUBLISHER_HPP */
@@ -0,0 +1,315 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "control-channel.hpp"
+
+ControlChannel::ControlChannel(const std::string &_identificationString,
+                               const int _socketDescriptor) : Top(_identificationString),
+                                                              socketDescriptor(_socketDescriptor)
+{
+    assert(_socketDescriptor >= 0);
+
+    // Nothing else to do here.
+}
+
+ControlChannel::~ControlChannel()
+{
+    close(socketDescriptor);
+}
+
+std::shared_ptr<ControlChannel> ControlChannel::connect(const std::string &host,
+                                                        const std::string &port)
+{
+    struct addrinfo hints = {};
+    struct addrinfo *addresses = nullptr;
+    std::shared_ptr<ControlChannel> pControlChannel = nullptr;
+    int errorCode = 0;
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    errorCode = getaddrinfo(host.c_str(),
+                            port.c_str(),
+                            &hints,
+                            &addresses);
+
+    if (errorCode != 0)
+    {
+        fprintf(stderr,
+                "Cannot resolve the coordinator address '%s:%s': %s.\n",
+                host.c_str(),
+                port.c_str(),
+                gai_strerror(errorCode));
+
+        return nullptr;
+    }
+
+    for (const struct addrinfo *address = addresses; address != nullptr; address = address->ai_next)
+    {
+        const int socketDescriptor = socket(address->ai_family,
+                                            address->ai_socktype,
+                                            address->ai_protocol);
+
+        if (socketDescriptor == -1)
+        {
+            continue;
+        }
+
+        if (::connect(socketDescriptor,
+                      address->ai_addr,
+                      address->ai_addrlen) == 0)
+        {
+            pControlChannel = std::make_shared<ControlChannel>("Coordinator",
+                                                               socketDescriptor);
+
+            break;
+        }
+
+        close(socketDescriptor);
+    }
+
+    freeaddrinfo(addresses);
+
+    if (pControlChannel == nullptr)
+    {
+        fprintf(stderr,
+                "Cannot connect to the coordinator '%s:%s'.\n",
+                host.c_str(),
+                port.c_str());
+    }
+
+    return pControlChannel;
+}
+
+std::string ControlChannel::formatRecord(const char *const keyword,
+                                         const size_t scenarioIndex,
+                                         const WORKERS_BOARD_SCENARIO_RECORD &record)
+{
+    assert(keyword != nullptr);
+    assert(&record != nullptr);
+
+    const LATENCY_STATISTICS_SNAPSHOT &statistics = record.requestsStatistics;
+    std::ostringstream stream;
+    size_t bucketsCount = 0;
+
+    stream << keyword << ' ' << scenarioIndex
+           << ' ' << record.elapsedMicroSeconds
+           << ' ' << record.requestsCount
+           << ' ' << record.errorsCount
+           << ' ' << record.tps
+           << ' ' << record.minTestTps
+           << ' ' << record.maxTestTps
+           << ' ' << record.meanTestTps
+           << ' ' << record.verifiedCount
+           << ' ' << record.mismatchesCount
+           << ' ' << statistics.count
+           << ' ' << statistics.totalMicroSeconds
+           << ' ' << statistics.minMicroSeconds
+           << ' ' << statistics.maxMicroSeconds;
+
+    for (size_t bucketIndex = 0; bucketIndex < LATENCY_STATISTICS__BUCKETS_COUNT; bucketIndex++)
+    {
+        if (statistics.buckets[bucketIndex] != 0)
+        {
+            bucketsCount++;
+        }
+    }
+
+    stream << ' ' << bucketsCount;
+
+    for (size_t bucketIndex = 0; bucketIndex < LATENCY_STATISTICS__BUCKETS_COUNT; bucketIndex++)
+    {
+        if (statistics.buckets[bucketIndex] != 0)
+        {
+            stream << ' ' << bucketIndex << ' ' << statistics.buckets[bucketIndex];
+        }
+    }
+
+    return stream.str();
+}
+
+int ControlChannel::getSocketDescriptor() const
+{
+    return socketDescriptor;
+}
+
+bool ControlChannel::isEnded() const
+{
+    return isClosed &&
+           (buffer.find('\n') == std::string::npos);
+}
+
+bool ControlChannel::parseRecord(const std::string &line,
+                                 size_t &scenarioIndex,
+                                 WORKERS_BOARD_SCENARIO_RECORD &record)
+{
+    assert(&record != nullptr);
+
+    LATENCY_STATISTICS_SNAPSHOT &statistics = record.requestsStatistics;
+    std::istringstream stream(line);
+    std::string keyword = {};
+    size_t bucketsCount = 0;
+
+    record = {};
+
+    stream >> keyword >> scenarioIndex >> record.elapsedMicroSeconds >> record.requestsCount >> record.errorsCount >> record.tps >> record.minTestTps >> record.maxTestTps >> record.meanTestTps >> record.verifiedCount >> record.mismatchesCount >> statistics.count >> statistics.totalMicroSeconds >> statistics.minMicroSeconds >> statistics.maxMicroSeconds >> bucketsCount;
+
+    if (!stream ||
+        (bucketsCount > LATENCY_STATISTICS__BUCKETS_COUNT))
+    {
+        return false;
+    }
+
+    for (size_t bucket = 0; bucket < bucketsCount; bucket++)
+    {
+        size_t bucketIndex = 0;
+        unsigned long bucketCount = 0L;
+
+        stream >> bucketIndex >> bucketCount;
+
+        if (!stream ||
+            (bucketIndex >= LATENCY_STATISTICS__BUCKETS_COUNT))
+        {
+            return false;
+        }
+
+        statistics.buckets[bucketIndex] = bucketCount;
+    }
+
+    return true;
+}
+
+bool ControlChannel::popLine(std::string &line)
+{
+    const size_t endIndex = buffer.find('\n');
+
+    if (endIndex == std::string::npos)
+    {
+        return false;
+    }
+
+    line = buffer.substr(0,
+                         endIndex);
+
+    buffer.erase(0,
+                 endIndex + 1);
+
+    return true;
+}
+
+CK_RV ControlChannel::read()
+{
+    CK_RV rv = CKR_OK;
+    char bytes[4096];
+    ssize_t bytesCount = 0;
+
+    do
+    {
+        bytesCount = ::read(socketDescriptor,
+                            bytes,
+                            sizeof(bytes));
+    } while ((bytesCount == -1) &&
+             (errno == EINTR));
+
+    if (bytesCount <= 0)
+    {
+        // Either closed by the peer, or broken.
+        isClosed = true;
+
+        goto EXIT;
+    }
+
+    buffer.append(bytes,
+                  (size_t)bytesCount);
+
+    if (buffer.size() > CONTROL_CHANNEL__MAXIMUM_LINE_LENGTH)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("The received line is too long.",
+                   rv);
+
+        isClosed = true;
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV ControlChannel::receive(std::string &line)
+{
+    CK_RV rv = CKR_OK;
+
+    while (!popLine(line))
+    {
+        if (isClosed)
+        {
+            rv = CKR_DEVICE_ERROR;
+
+            writeError("The connection is closed.",
+                       rv);
+
+            goto EXIT;
+        }
+
+        rv = read();
+
+        if (rv != CKR_OK)
+        {
+            goto EXIT;
+        }
+    }
+
+EXIT:
+    return rv;
+}
+
+CK_RV ControlChannel::send(const std::string &line)
+{
+    CK_RV rv = CKR_OK;
+    const std::string bytes = line + "\n";
+    size_t sentCount = 0;
+
+    while (sentCount < bytes.size())
+    {
+        const ssize_t bytesCount = ::send(socketDescriptor,
+                                          bytes.data() + sentCount,
+                                          bytes.size() - sentCount,
+                                          MSG_NOSIGNAL);
+
+        if (bytesCount == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            rv = CKR_DEVICE_ERROR;
+
+            writeError("Cannot send a line.",
+                       rv);
+
+            goto EXIT;
+        }
+
+        sentCount += (size_t)bytesCount;
+    }
+
+EXIT:
+    return rv;
+}
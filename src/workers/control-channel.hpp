@@ -0,0 +1,99 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef CONTROL_CHANNEL_HPP
+#define CONTROL_CHANNEL_HPP
+
+#include <memory>
+#include <string>
+
+#include "scenarii/top.hpp"
+#include "workers-board.hpp"
+
+// Commands of the coordinator to its agents, then messages of the agents.
+//
+//   Agent                               Coordinator
+//   HELLO <host> <pid>             ->
+//                                  <-   SPEC <options> <arguments>
+//                                  <-   <option or argument> (one per line)
+//   NAME <scenario> <name>         ->
+//   ALGORITHM <scenario> <name>    ->
+//   READY                          ->
+//                                  <-   START <epoch in milli-seconds>
+//   LIVE <scenario> <record>       ->   (every second, if time-limited)
+//   RESULTS <scenario> <record>    ->
+//   DONE <members-count>           ->
+#define CONTROL_CHANNEL__HELLO "HELLO"
+#define CONTROL_CHANNEL__SPEC "SPEC"
+#define CONTROL_CHANNEL__NAME "NAME"
+#define CONTROL_CHANNEL__ALGORITHM "ALGORITHM"
+#define CONTROL_CHANNEL__READY "READY"
+#define CONTROL_CHANNEL__START "START"
+#define CONTROL_CHANNEL__LIVE "LIVE"
+#define CONTROL_CHANNEL__RESULTS "RESULTS"
+#define CONTROL_CHANNEL__DONE "DONE"
+
+#define CONTROL_CHANNEL__MAXIMUM_LINE_LENGTH 65536
+
+/*
+ * Text lines exchanged over a TCP connection between the coordinator and
+ * an agent.
+ *
+ * Notes:
+ *   - The scenario records are made of their counters, then of the count
+ *     of their non-empty latency buckets followed by their indexes and
+ *     values.
+ */
+class ControlChannel : public Top
+{
+protected:
+    int socketDescriptor = -1;
+    std::string buffer = {};
+    bool isClosed = false;
+
+public:
+    ControlChannel(const std::string &identificationString,
+                   const int socketDescriptor);
+    ~ControlChannel() override;
+
+    ControlChannel(const ControlChannel &) = delete;
+    ControlChannel &operator=(const ControlChannel &) = delete;
+
+    // Returns nullptr (the error being written) if the coordinator cannot
+    // be reached.
+    static std::shared_ptr<ControlChannel> connect(const std::string &host,
+                                                   const std::string &port);
+
+    static std::string formatRecord(const char *const keyword,
+                                    const size_t scenarioIndex,
+                                    const WORKERS_BOARD_SCENARIO_RECORD &record);
+
+    // Returns false if the line is not a record.
+    static bool parseRecord(const std::string &line,
+                            size_t &scenarioIndex,
+                            WORKERS_BOARD_SCENARIO_RECORD &record);
+
+    virtual int getSocketDescriptor() const;
+    virtual bool isEnded() const;
+
+    // Returns false if no complete line was received yet.
+    virtual bool popLine(std::string &line);
+
+    // Reads the bytes available (e.g. once polled), then returns.
+    virtual CK_RV read();
+
+    // Returns once a line is received, or in error if the connection is
+    // closed before.
+    virtual CK_RV receive(std::string &line);
+
+    virtual CK_RV send(const std::string &line);
+};
+
+#endif /* CONTROL_CHANNEL_HPP */
@@ -0,0 +1,566 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <netdb.h>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "coordinator.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+Coordinator::Coordinator(const std::string &_port,
+                         const size_t _agentsCount,
+                         const std::vector<std::string> &_options,
+                         const std::vector<std::string> &_arguments) : Top("Coordinator"),
+                                                                      port(_port),
+                                                                      agentsCount(_agentsCount),
+                                                                      options(_options),
+                                                                      arguments(_arguments)
+{
+    assert(_agentsCount > 0);
+    assert(_arguments.size() > 3);
+
+    // Until named by the agents, the scenarii are named after their
+    // definitions.
+    scenariiNames.assign(arguments.begin() + 3,
+                         arguments.end());
+    verifiedAlgorithms.resize(scenariiNames.size());
+}
+
+Coordinator::~Coordinator()
+{
+    if (listeningSocketDescriptor != -1)
+    {
+        close(listeningSocketDescriptor);
+    }
+}
+
+CK_RV Coordinator::acceptAgents()
+{
+    assert(pWorkersBoard != nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    fprintf(stdout,
+            "Wait for %ld agent(s) on port %s...\n",
+            agentsCount,
+            port.c_str());
+
+    while (controlChannels.size() < agentsCount)
+    {
+        const size_t agentIndex = controlChannels.size();
+        std::shared_ptr<ControlChannel> pControlChannel = nullptr;
+        std::string line = {};
+        std::string keyword = {};
+        std::string host = {};
+        pid_t processIdentifier = 0;
+
+        const int socketDescriptor = accept(listeningSocketDescriptor,
+                                            nullptr,
+                                            nullptr);
+
+        if (socketDescriptor == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            rv = CKR_GENERAL_ERROR;
+
+            writeError("Cannot accept an agent.",
+                       rv);
+
+            goto EXIT;
+        }
+
+        pControlChannel = std::make_shared<ControlChannel>(std::string("Agent ") +
+                                                               std::to_string(agentIndex),
+                                                           socketDescriptor);
+
+        if (pControlChannel->receive(line) != CKR_OK)
+        {
+            continue;
+        }
+
+        std::istringstream stream(line);
+
+        stream >> keyword >> host >> processIdentifier;
+
+        if (!stream ||
+            (keyword != CONTROL_CHANNEL__HELLO))
+        {
+            fprintf(stderr,
+                    "%s: unexpected registration ('%s'), ignored.\n",
+                    getUniqueString().c_str(),
+                    line.c_str());
+
+            continue;
+        }
+
+        if ((pControlChannel->send(std::string(CONTROL_CHANNEL__SPEC " ") +
+                                   std::to_string(options.size()) +
+                                   " " +
+                                   std::to_string(arguments.size())) != CKR_OK))
+        {
+            continue;
+        }
+
+        for (const std::string &item : options)
+        {
+            rv = pControlChannel->send(item);
+
+            if (rv != CKR_OK)
+            {
+                break;
+            }
+        }
+
+        for (const std::string &item : arguments)
+        {
+            if (rv == CKR_OK)
+            {
+                rv = pControlChannel->send(item);
+            }
+        }
+
+        if (rv != CKR_OK)
+        {
+            rv = CKR_OK;
+
+            continue;
+        }
+
+        agentsNames.push_back(std::string("Agent ") +
+                              std::to_string(agentIndex) +
+                              " (" +
+                              host +
+                              ", process " +
+                              std::to_string(processIdentifier) +
+                              ")");
+        areAgentsReady.push_back(false);
+        areAgentsFailed.push_back(false);
+        controlChannels.push_back(pControlChannel);
+
+        pWorkersBoard->setWorkerRecord(agentIndex,
+                                       processIdentifier,
+                                       0L);
+
+        fprintf(stdout,
+                "%s registered.\n",
+                agentsNames[agentIndex].c_str());
+    }
+
+EXIT:
+    return rv;
+}
+
+const std::vector<std::string> &Coordinator::getAgentsNames() const
+{
+    return agentsNames;
+}
+
+const std::vector<bool> &Coordinator::getAreAgentsFailed() const
+{
+    return areAgentsFailed;
+}
+
+const std::vector<std::string> &Coordinator::getScenariiNames() const
+{
+    return scenariiNames;
+}
+
+const std::vector<std::string> &Coordinator::getVerifiedAlgorithms() const
+{
+    return verifiedAlgorithms;
+}
+
+const WorkersBoard &Coordinator::getWorkersBoard() const
+{
+    assert(pWorkersBoard != nullptr);
+
+    return *pWorkersBoard;
+}
+
+CK_RV Coordinator::listen()
+{
+    assert(listeningSocketDescriptor == -1);
+
+    CK_RV rv = CKR_OK;
+    struct addrinfo hints = {};
+    struct addrinfo *addresses = nullptr;
+    const int isReusingAddress = 1;
+
+    pWorkersBoard = std::make_shared<WorkersBoard>(agentsCount,
+                                                   scenariiNames.size());
+
+    rv = pWorkersBoard->create();
+
+    if (rv != CKR_OK)
+    {
+        goto EXIT;
+    }
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    if (getaddrinfo(nullptr,
+                    port.c_str(),
+                    &hints,
+                    &addresses) != 0)
+    {
+        rv = CKR_ARGUMENTS_BAD;
+
+        writeError("Invalid port.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    for (const struct addrinfo *address = addresses; address != nullptr; address = address->ai_next)
+    {
+        listeningSocketDescriptor = socket(address->ai_family,
+                                           address->ai_socktype,
+                                           address->ai_protocol);
+
+        if (listeningSocketDescriptor == -1)
+        {
+            continue;
+        }
+
+        setsockopt(listeningSocketDescriptor,
+                   SOL_SOCKET,
+                   SO_REUSEADDR,
+                   &isReusingAddress,
+                   sizeof(isReusingAddress));
+
+        if ((bind(listeningSocketDescriptor,
+                  address->ai_addr,
+                  address->ai_addrlen) == 0) &&
+            (::listen(listeningSocketDescriptor,
+                      (int)agentsCount) == 0))
+        {
+            break;
+        }
+
+        close(listeningSocketDescriptor);
+
+        listeningSocketDescriptor = -1;
+    }
+
+    freeaddrinfo(addresses);
+
+    if (listeningSocketDescriptor == -1)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot listen to the agents.",
+                   rv);
+    }
+
+EXIT:
+    return rv;
+}
+
+bool Coordinator::processLine(const size_t agentIndex,
+                              const std::string &line)
+{
+    assert(agentIndex < controlChannels.size());
+
+    std::istringstream stream(line);
+    std::string keyword = {};
+    std::string value = {};
+    size_t scenarioIndex = 0;
+    unsigned long membersCount = 0L;
+    WORKERS_BOARD_SCENARIO_RECORD record = {};
+
+    stream >> keyword;
+
+    if ((keyword == CONTROL_CHANNEL__NAME) ||
+        (keyword == CONTROL_CHANNEL__ALGORITHM))
+    {
+        stream >> scenarioIndex;
+
+        if (!stream ||
+            (scenarioIndex >= scenariiNames.size()))
+        {
+            return false;
+        }
+
+        stream.get(); // Skip the separator.
+
+        std::getline(stream,
+                     value);
+
+        (keyword == CONTROL_CHANNEL__NAME ? scenariiNames : verifiedAlgorithms)[scenarioIndex] = value;
+    }
+    else if (keyword == CONTROL_CHANNEL__READY)
+    {
+        areAgentsReady[agentIndex] = true;
+
+        pWorkersBoard->setWorkerState(agentIndex,
+                                      WORKERS_BOARD__STATE__READY);
+    }
+    else if ((keyword == CONTROL_CHANNEL__LIVE) ||
+             (keyword == CONTROL_CHANNEL__RESULTS))
+    {
+        if (!ControlChannel::parseRecord(line,
+                                         scenarioIndex,
+                                         record) ||
+            (scenarioIndex >= scenariiNames.size()))
+        {
+            return false;
+        }
+
+        pWorkersBoard->setScenarioRecord(agentIndex,
+                                         scenarioIndex,
+                                         record);
+    }
+    else if (keyword == CONTROL_CHANNEL__DONE)
+    {
+        stream >> membersCount;
+
+        pWorkersBoard->setWorkerRecord(agentIndex,
+                                       pWorkersBoard->getWorkerRecord(agentIndex).processIdentifier,
+                                       membersCount);
+        pWorkersBoard->setWorkerState(agentIndex,
+                                      WORKERS_BOARD__STATE__REPORTED);
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void Coordinator::receiveLines(const bool isStarted)
+{
+    const int awaitedState = isStarted ? WORKERS_BOARD__STATE__REPORTED : WORKERS_BOARD__STATE__READY;
+    // The agents are publishing on each second from the start time: the
+    // progress is written half a second after.
+    auto nextIntervalTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(COORDINATOR__START_DELAY + 1500);
+    unsigned long elapsedSeconds = 0L;
+    unsigned long previousSuccessesCount = 0L;
+    std::vector<struct pollfd> pollDescriptors = {};
+    std::vector<size_t> polledAgentsIndexes = {};
+    std::string line = {};
+
+    while (true)
+    {
+        int timeout = -1;
+
+        pollDescriptors.clear();
+        polledAgentsIndexes.clear();
+
+        for (size_t agentIndex = 0; agentIndex < controlChannels.size(); agentIndex++)
+        {
+            if (!areAgentsFailed[agentIndex] &&
+                (pWorkersBoard->getWorkerState(agentIndex) < awaitedState))
+            {
+                struct pollfd pollDescriptor = {};
+
+                pollDescriptor.fd = controlChannels[agentIndex]->getSocketDescriptor();
+                pollDescriptor.events = POLLIN;
+
+                pollDescriptors.push_back(pollDescriptor);
+                polledAgentsIndexes.push_back(agentIndex);
+            }
+        }
+
+        if (pollDescriptors.empty())
+        {
+            break;
+        }
+
+        if (isStarted)
+        {
+            const auto now = std::chrono::steady_clock::now();
+
+            if (now >= nextIntervalTime)
+            {
+                elapsedSeconds++;
+
+                writeInterval(elapsedSeconds,
+                              previousSuccessesCount);
+
+                nextIntervalTime += std::chrono::seconds(1);
+            }
+
+            timeout = (int)std::chrono::duration_cast<std::chrono::milliseconds>(nextIntervalTime - now).count();
+
+            if (timeout < 0)
+            {
+                timeout = 0;
+            }
+        }
+
+        if (poll(pollDescriptors.data(),
+                 pollDescriptors.size(),
+                 timeout) <= 0)
+        {
+            continue;
+        }
+
+        for (size_t pollIndex = 0; pollIndex < pollDescriptors.size(); pollIndex++)
+        {
+            const size_t agentIndex = polledAgentsIndexes[pollIndex];
+            ControlChannel &controlChannel = *controlChannels[agentIndex];
+
+            if (pollDescriptors[pollIndex].revents == 0)
+            {
+                continue;
+            }
+
+            controlChannel.read(); // Ignore the result code (i.e. ended).
+
+            while (controlChannel.popLine(line))
+            {
+                if (!processLine(agentIndex,
+                                 line))
+                {
+                    fprintf(stderr,
+                            "%s: unexpected line ('%s').\n",
+                            agentsNames[agentIndex].c_str(),
+                            line.c_str());
+
+                    areAgentsFailed[agentIndex] = true;
+
+                    break;
+                }
+            }
+
+            if (!areAgentsFailed[agentIndex] &&
+                controlChannel.isEnded() &&
+                (pWorkersBoard->getWorkerState(agentIndex) < awaitedState))
+            {
+                fprintf(stderr,
+                        "%s: disconnected before to be %s.\n",
+                        agentsNames[agentIndex].c_str(),
+                        isStarted ? "reported" : "ready");
+
+                areAgentsFailed[agentIndex] = true;
+            }
+        }
+    }
+}
+
+CK_RV Coordinator::runAgents()
+{
+    CK_RV rv = CKR_OK;
+    size_t readyCount = 0;
+    unsigned long long startMilliSeconds = 0LL;
+
+    writeMessage("Wait for the agents to be ready...\n");
+
+    receiveLines(false);
+
+    startMilliSeconds = getEpochMilliSeconds() + COORDINATOR__START_DELAY;
+
+    for (size_t agentIndex = 0; agentIndex < controlChannels.size(); agentIndex++)
+    {
+        if (areAgentsFailed[agentIndex])
+        {
+            continue;
+        }
+
+        if (controlChannels[agentIndex]->send(std::string(CONTROL_CHANNEL__START " ") +
+                                              std::to_string(startMilliSeconds)) != CKR_OK)
+        {
+            areAgentsFailed[agentIndex] = true;
+
+            continue;
+        }
+
+        readyCount++;
+    }
+
+    if (readyCount == 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("No agent is ready.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    fprintf(stdout,
+            "Start time: %lld ms (%ld agent(s))\n",
+            startMilliSeconds,
+            readyCount);
+
+    writeMessage("Wait for the results of the agents...\n");
+
+    receiveLines(true);
+
+    printCurrentTime("End time: ");
+
+    for (size_t agentIndex = 0; agentIndex < controlChannels.size(); agentIndex++)
+    {
+        if (areAgentsFailed[agentIndex])
+        {
+            rv = CKR_GENERAL_ERROR;
+        }
+    }
+
+EXIT:
+    return rv;
+}
+
+void Coordinator::writeInterval(const unsigned long elapsedSeconds,
+                                unsigned long &previousSuccessesCount) const
+{
+    unsigned long requestsCount = 0L;
+    unsigned long errorsCount = 0L;
+    size_t runningCount = 0;
+
+    for (size_t agentIndex = 0; agentIndex < controlChannels.size(); agentIndex++)
+    {
+        if (areAgentsFailed[agentIndex])
+        {
+            continue;
+        }
+
+        runningCount++;
+
+        for (size_t scenarioIndex = 0; scenarioIndex < scenariiNames.size(); scenarioIndex++)
+        {
+            const WORKERS_BOARD_SCENARIO_RECORD &record = pWorkersBoard->getScenarioRecord(agentIndex,
+                                                                                           scenarioIndex);
+
+            requestsCount += record.requestsCount;
+            errorsCount += record.errorsCount;
+        }
+    }
+
+    fprintf(stdout,
+            "  %4ld s: Requests = %ld, Errors = %ld, TpS (last second) = %ld, Agents = %ld\n",
+            elapsedSeconds,
+            requestsCount,
+            errorsCount,
+            ((requestsCount - errorsCount) >= previousSuccessesCount) ? ((requestsCount - errorsCount) - previousSuccessesCount) : 0L,
+            runningCount);
+
+    fflush(stdout);
+
+    previousSuccessesCount = requestsCount - errorsCount;
+}
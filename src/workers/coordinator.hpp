@@ -0,0 +1,92 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef COORDINATOR_HPP
+#define COORDINATOR_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "control-channel.hpp"
+#include "scenarii/top.hpp"
+#include "workers-board.hpp"
+
+// Delay between the readiness of the agents and their common start time
+// (milli-seconds), so that the start command reaches all of them before.
+#define COORDINATOR__START_DELAY 1000
+
+/*
+ * Coordinator of a run spread over agents (i.e. 'ha-bench agent'), e.g. on
+ * several client hosts of the same HA group.
+ *
+ * Notes:
+ *   - The agents are sent the options and arguments of the run, to which
+ *     they add their own (e.g. slot and password).
+ *   - Their results are gathered on a board (see WorkersBoard), as for the
+ *     workers of '--processes'.
+ */
+class Coordinator : public Top
+{
+protected:
+    int listeningSocketDescriptor = -1;
+    std::vector<std::shared_ptr<ControlChannel>> controlChannels = {};
+    std::shared_ptr<WorkersBoard> pWorkersBoard = nullptr;
+
+    std::vector<std::string> agentsNames = {};
+    std::vector<bool> areAgentsReady = {};
+    std::vector<bool> areAgentsFailed = {};
+    std::vector<std::string> scenariiNames = {};
+    std::vector<std::string> verifiedAlgorithms = {};
+
+    // Returns false if the line is not expected.
+    virtual bool processLine(const size_t agentIndex,
+                             const std::string &line);
+
+    // Waits for lines until all the agents are ready (if 'isStarted' is
+    // false) or reported, the failing ones excepted.
+    virtual void receiveLines(const bool isStarted);
+
+    virtual void writeInterval(const unsigned long elapsedSeconds,
+                               unsigned long &previousSuccessesCount) const;
+
+public:
+    const std::string port;
+    const size_t agentsCount;
+    const std::vector<std::string> options;
+    const std::vector<std::string> arguments;
+
+    // The arguments are the mandatory arguments of the run, slot and
+    // password excepted.
+    Coordinator(const std::string &port,
+                const size_t agentsCount,
+                const std::vector<std::string> &options,
+                const std::vector<std::string> &arguments);
+    ~Coordinator() override;
+
+    Coordinator(const Coordinator &) = delete;
+    Coordinator &operator=(const Coordinator &) = delete;
+
+    // Waits for the agents to register, then sends them the run.
+    virtual CK_RV acceptAgents();
+
+    virtual CK_RV listen();
+
+    // Starts the agents once ready, then waits for their results.
+    virtual CK_RV runAgents();
+
+    virtual const std::vector<std::string> &getAgentsNames() const;
+    virtual const std::vector<bool> &getAreAgentsFailed() const;
+    virtual const std::vector<std::string> &getScenariiNames() const;
+    virtual const std::vector<std::string> &getVerifiedAlgorithms() const;
+    virtual const WorkersBoard &getWorkersBoard() const;
+};
+
+#endif /* COORDINATOR_HPP */
@@ -0,0 +1,92 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+
+#include "publisher.hpp"
+
+Publisher::Publisher(const std::string &_identificationString) : Top(_identificationString)
+{
+    // Nothing else to do here.
+}
+
+void Publisher::getLiveRecord(const Scenario &scenario,
+                              const unsigned long elapsedMicroSeconds,
+                              WORKERS_BOARD_SCENARIO_RECORD &record)
+{
+    assert(&scenario != nullptr);
+    assert(&record != nullptr);
+
+    LatencyStatistics requestsStatistics;
+    unsigned long requestsCount = 0L;
+    unsigned long errorsCount = 0L;
+
+    scenario.getLiveStatistics(requestsCount,
+                               errorsCount,
+                               requestsStatistics);
+
+    record.elapsedMicroSeconds = elapsedMicroSeconds;
+    record.requestsCount = requestsCount;
+    record.errorsCount = errorsCount;
+
+    if ((elapsedMicroSeconds > 0L) &&
+        (requestsCount >= errorsCount))
+    {
+        record.tps = (unsigned long)((double)(requestsCount - errorsCount) / ((double)elapsedMicroSeconds / 1000000.));
+    }
+
+    requestsStatistics.getSnapshot(record.requestsStatistics);
+}
+
+void Publisher::getRecord(const Scenario &scenario,
+                          WORKERS_BOARD_SCENARIO_RECORD &record)
+{
+    assert(&scenario != nullptr);
+    assert(&record != nullptr);
+
+    record.elapsedMicroSeconds = scenario.getElapsedMicroSeconds();
+    record.requestsCount = scenario.getRequestsCount();
+    record.errorsCount = scenario.getErrorsCount();
+    record.tps = scenario.getTps();
+    record.minTestTps = scenario.getMinTestTps();
+    record.maxTestTps = scenario.getMaxTestTps();
+    record.meanTestTps = scenario.getMeanTestTps();
+    record.verifiedCount = scenario.getVerifiedOutputsCount();
+    record.mismatchesCount = scenario.getMismatchingOutputsCount();
+
+    scenario.getRequestsStatistics().getSnapshot(record.requestsStatistics);
+}
+
+void Publisher::publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                      const unsigned long elapsedMicroSeconds)
+{
+    assert(&scenarii != nullptr);
+
+    (void)elapsedMicroSeconds;
+}
+
+CK_RV Publisher::publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                   const unsigned long membersCount)
+{
+    assert(&scenarii != nullptr);
+
+    (void)membersCount;
+
+    return CKR_OK;
+}
+
+CK_RV Publisher::waitForStart(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                              unsigned long long &startMilliSeconds)
+{
+    assert(&scenarii != nullptr);
+    assert(&startMilliSeconds != nullptr);
+
+    return CKR_OK;
+}
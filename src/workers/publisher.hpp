@@ -0,0 +1,60 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef PUBLISHER_HPP
+#define PUBLISHER_HPP
+
+#include <memory>
+#include <vector>
+
+#include "scenarii/scenario.hpp"
+#include "scenarii/top.hpp"
+#include "workers-board.hpp"
+
+/*
+ * Hooks through which a run publishes its results, merged by another
+ * process: the parent of the workers of '--processes' (see WorkerPublisher)
+ * or the coordinator of an agent (see AgentPublisher).
+ *
+ * Notes:
+ *   - The default hooks start the tests immediately and publish nothing.
+ */
+class Publisher : public Top
+{
+protected:
+    explicit Publisher(const std::string &identificationString);
+
+public:
+    // Fills the record of a running scenario (counters and latencies only).
+    static void getLiveRecord(const Scenario &scenario,
+                              const unsigned long elapsedMicroSeconds,
+                              WORKERS_BOARD_SCENARIO_RECORD &record);
+
+    // Fills the record of a stopped scenario.
+    static void getRecord(const Scenario &scenario,
+                          WORKERS_BOARD_SCENARIO_RECORD &record);
+
+    // Called every second while the tests run (if time-limited); the errors
+    // are only written, the final publication failing as well.
+    virtual void publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                       const unsigned long elapsedMicroSeconds);
+
+    // Called once the tests are stopped.
+    virtual CK_RV publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                    const unsigned long membersCount);
+
+    // Called once the scenarii are initialized, returns once their tests
+    // may be started, and may set the time at which they are released (see
+    // StartGate; in milli-seconds since the Epoch, 0 if immediately).
+    virtual CK_RV waitForStart(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                               unsigned long long &startMilliSeconds);
+};
+
+#endif /* PUBLISHER_HPP */
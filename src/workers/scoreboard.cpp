@@ -0,0 +1,337 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "publisher.hpp"
+#include "scoreboard.hpp"
+
+extern "C"
+{
+#include <toolkits/misc-toolkit.h>
+}
+
+// Attempts to copy the records of a scoreboard while they are updated.
+#define SCOREBOARD__READ_ATTEMPTS_COUNT 1000
+
+Scoreboard::Scoreboard() : Top("Scoreboard")
+{
+    // Nothing else to do here.
+}
+
+Scoreboard::~Scoreboard()
+{
+    if (pSegment != nullptr)
+    {
+        munmap(pSegment,
+               segmentLength);
+    }
+
+    if (isOwner)
+    {
+        unlink(path.c_str());
+    }
+}
+
+void Scoreboard::beginUpdate()
+{
+    assert(isOwner);
+
+    __atomic_store_n(&pHeader->sequence,
+                     pHeader->sequence + 1,
+                     __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+CK_RV Scoreboard::create(const std::vector<std::string> &scenariiDefinitions)
+{
+    assert(pSegment == nullptr);
+    assert(!scenariiDefinitions.empty());
+
+    CK_RV rv = CKR_OK;
+    int fileDescriptor = -1;
+
+    path = std::string(SCOREBOARD__DIRECTORY "/" SCOREBOARD__FILE_PREFIX) + std::to_string(getpid());
+    segmentLength = sizeof(SCOREBOARD_HEADER) +
+                    (scenariiDefinitions.size() * sizeof(SCOREBOARD_SCENARIO_RECORD));
+
+    // Note: the scoreboard left by a killed process with the same identifier
+    // is replaced.
+    fileDescriptor = ::open(path.c_str(),
+                            O_RDWR | O_CREAT | O_TRUNC,
+                            0644);
+
+    if (fileDescriptor == -1)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError((std::string("Cannot create the scoreboard '") + path + "'.").c_str(),
+                   rv);
+
+        goto EXIT;
+    }
+
+    isOwner = true;
+
+    if (ftruncate(fileDescriptor,
+                  (off_t)segmentLength) != 0)
+    {
+        rv = CKR_GENERAL_ERROR;
+
+        writeError("Cannot size the scoreboard.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    pSegment = mmap(nullptr,
+                    segmentLength,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED,
+                    fileDescriptor,
+                    0);
+
+    if (pSegment == MAP_FAILED)
+    {
+        pSegment = nullptr;
+
+        rv = CKR_HOST_MEMORY;
+
+        writeError("Cannot map the scoreboard.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    // The file is zeroed by its truncation, i.e. no record published.
+    pHeader = (SCOREBOARD_HEADER *)pSegment;
+    scenariiRecords = (SCOREBOARD_SCENARIO_RECORD *)(pHeader + 1);
+
+    pHeader->processIdentifier = getpid();
+    pHeader->state = WORKERS_BOARD__STATE__PREPARING;
+    pHeader->scenariiCount = scenariiDefinitions.size();
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenariiDefinitions.size(); scenarioIndex++)
+    {
+        strncpy(scenariiRecords[scenarioIndex].definition,
+                scenariiDefinitions[scenarioIndex].c_str(),
+                SCOREBOARD__MAXIMUM_DEFINITION_LENGTH - 1);
+    }
+
+    // The readers ignore the scoreboard until its magic is set.
+    __atomic_store_n(&pHeader->magic,
+                     SCOREBOARD__MAGIC,
+                     __ATOMIC_RELEASE);
+
+EXIT:
+    if (fileDescriptor != -1)
+    {
+        close(fileDescriptor);
+    }
+
+    return rv;
+}
+
+void Scoreboard::endUpdate()
+{
+    assert(isOwner);
+
+    pHeader->updateMilliSeconds = getEpochMilliSeconds();
+
+    __atomic_store_n(&pHeader->sequence,
+                     pHeader->sequence + 1,
+                     __ATOMIC_RELEASE);
+}
+
+const std::string &Scoreboard::getPath() const
+{
+    return path;
+}
+
+std::vector<std::string> Scoreboard::getPaths()
+{
+    std::vector<std::string> paths = {};
+    DIR *const pDirectory = opendir(SCOREBOARD__DIRECTORY);
+
+    if (pDirectory == nullptr)
+    {
+        return paths;
+    }
+
+    for (struct dirent *pEntry = readdir(pDirectory); pEntry != nullptr; pEntry = readdir(pDirectory))
+    {
+        if (strncmp(pEntry->d_name,
+                    SCOREBOARD__FILE_PREFIX,
+                    strlen(SCOREBOARD__FILE_PREFIX)) == 0)
+        {
+            paths.push_back(std::string(SCOREBOARD__DIRECTORY "/") + pEntry->d_name);
+        }
+    }
+
+    closedir(pDirectory);
+
+    return paths;
+}
+
+CK_RV Scoreboard::open(const std::string &_path)
+{
+    assert(pSegment == nullptr);
+
+    CK_RV rv = CKR_OK;
+    struct stat fileStatus = {};
+    int fileDescriptor = -1;
+
+    path = _path;
+
+    fileDescriptor = ::open(path.c_str(),
+                            O_RDONLY);
+
+    if ((fileDescriptor == -1) ||
+        (fstat(fileDescriptor,
+               &fileStatus) != 0) ||
+        ((size_t)fileStatus.st_size < sizeof(SCOREBOARD_HEADER)))
+    {
+        // E.g. removed since listed, or not sized yet.
+        rv = CKR_GENERAL_ERROR;
+
+        goto EXIT;
+    }
+
+    segmentLength = (size_t)fileStatus.st_size;
+
+    pSegment = mmap(nullptr,
+                    segmentLength,
+                    PROT_READ,
+                    MAP_SHARED,
+                    fileDescriptor,
+                    0);
+
+    if (pSegment == MAP_FAILED)
+    {
+        pSegment = nullptr;
+
+        rv = CKR_HOST_MEMORY;
+
+        goto EXIT;
+    }
+
+    pHeader = (SCOREBOARD_HEADER *)pSegment;
+    scenariiRecords = (SCOREBOARD_SCENARIO_RECORD *)(pHeader + 1);
+
+EXIT:
+    if (fileDescriptor != -1)
+    {
+        close(fileDescriptor);
+    }
+
+    return rv;
+}
+
+void Scoreboard::publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                       const unsigned long elapsedMicroSeconds)
+{
+    assert(scenarii.size() == pHeader->scenariiCount);
+
+    beginUpdate();
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        Publisher::getLiveRecord(*scenarii[scenarioIndex],
+                                 elapsedMicroSeconds,
+                                 scenariiRecords[scenarioIndex].record);
+    }
+
+    endUpdate();
+}
+
+void Scoreboard::publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii)
+{
+    assert(scenarii.size() == pHeader->scenariiCount);
+
+    beginUpdate();
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        Publisher::getRecord(*scenarii[scenarioIndex],
+                             scenariiRecords[scenarioIndex].record);
+    }
+
+    pHeader->state = WORKERS_BOARD__STATE__REPORTED;
+
+    endUpdate();
+}
+
+bool Scoreboard::read(SCOREBOARD_HEADER &header,
+                      std::vector<SCOREBOARD_SCENARIO_RECORD> &_scenariiRecords) const
+{
+    assert(pHeader != nullptr);
+    assert(&header != nullptr);
+    assert(&_scenariiRecords != nullptr);
+
+    if (__atomic_load_n(&pHeader->magic,
+                        __ATOMIC_ACQUIRE) != SCOREBOARD__MAGIC)
+    {
+        return false;
+    }
+
+    for (size_t attemptIndex = 0; attemptIndex < SCOREBOARD__READ_ATTEMPTS_COUNT; attemptIndex++)
+    {
+        const unsigned long sequence = __atomic_load_n(&pHeader->sequence,
+                                                       __ATOMIC_ACQUIRE);
+
+        if ((sequence % 2) != 0)
+        {
+            sched_yield();
+
+            continue;
+        }
+
+        header = *pHeader;
+
+        if (segmentLength < (sizeof(SCOREBOARD_HEADER) +
+                             (header.scenariiCount * sizeof(SCOREBOARD_SCENARIO_RECORD))))
+        {
+            return false;
+        }
+
+        _scenariiRecords.assign(scenariiRecords,
+                                scenariiRecords + header.scenariiCount);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&pHeader->sequence,
+                            __ATOMIC_RELAXED) == sequence)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Scoreboard::setState(const int state,
+                          const unsigned long long startMilliSeconds)
+{
+    beginUpdate();
+
+    pHeader->state = state;
+    pHeader->startMilliSeconds = startMilliSeconds;
+
+    endUpdate();
+}
@@ -0,0 +1,116 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef SCOREBOARD_HPP
+#define SCOREBOARD_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "scenarii/scenario.hpp"
+#include "scenarii/top.hpp"
+#include "workers-board.hpp"
+
+// Scoreboards of the running instances, named after their process.
+#define SCOREBOARD__DIRECTORY "/dev/shm"
+#define SCOREBOARD__FILE_PREFIX "ha-bench."
+
+#define SCOREBOARD__MAGIC 0x3148434e45424148UL // 'HABENCH1'
+#define SCOREBOARD__MAXIMUM_DEFINITION_LENGTH 64
+
+typedef struct
+{
+    unsigned long magic;
+
+    // Even while the records are consistent (see Scoreboard::read()).
+    unsigned long sequence;
+
+    pid_t processIdentifier;
+
+    // See WORKERS_BOARD__STATE__*.
+    int state;
+
+    // In milli-seconds since the Epoch, 0 until the tests are started.
+    unsigned long long startMilliSeconds;
+    unsigned long long updateMilliSeconds;
+
+    unsigned long scenariiCount;
+} SCOREBOARD_HEADER;
+
+typedef struct
+{
+    // E.g. 'milenagex00000x10'.
+    char definition[SCOREBOARD__MAXIMUM_DEFINITION_LENGTH];
+
+    WORKERS_BOARD_SCENARIO_RECORD record;
+} SCOREBOARD_SCENARIO_RECORD;
+
+/*
+ * Host-wide scoreboard of a running instance, i.e. a small file of
+ * '/dev/shm' mapped by the instance, that publishes its statistics into it
+ * every second, and by 'ha-bench top', that reads the scoreboards of all
+ * the instances of the host.
+ *
+ * Notes:
+ *   - The records are published without lock: the sequence of the header
+ *     is odd while they are written, the readers trying again if it is odd
+ *     or changed during their copy.
+ *   - The instance removes its scoreboard at exit; the scoreboards left by
+ *     the instances that were killed are removed by the readers.
+ */
+class Scoreboard : public Top
+{
+protected:
+    std::string path = {};
+    bool isOwner = false;
+
+    void *pSegment = nullptr;
+    size_t segmentLength = 0;
+
+    SCOREBOARD_HEADER *pHeader = nullptr;
+    SCOREBOARD_SCENARIO_RECORD *scenariiRecords = nullptr;
+
+    virtual void beginUpdate();
+    virtual void endUpdate();
+
+public:
+    Scoreboard();
+    ~Scoreboard() override;
+
+    Scoreboard(const Scoreboard &) = delete;
+    Scoreboard &operator=(const Scoreboard &) = delete;
+
+    // Returns the paths of the scoreboards of the host.
+    static std::vector<std::string> getPaths();
+
+    // Creates the scoreboard of this process.
+    virtual CK_RV create(const std::vector<std::string> &scenariiDefinitions);
+
+    // Maps the scoreboard of another process (read only).
+    virtual CK_RV open(const std::string &path);
+
+    virtual const std::string &getPath() const;
+
+    // Returns false if a consistent copy cannot be made (i.e. updated too
+    // often) or if the scoreboard is not filled yet.
+    virtual bool read(SCOREBOARD_HEADER &header,
+                      std::vector<SCOREBOARD_SCENARIO_RECORD> &scenariiRecords) const;
+
+    virtual void publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                       const unsigned long elapsedMicroSeconds);
+    virtual void publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii);
+
+    virtual void setState(const int state,
+                          const unsigned long long startMilliSeconds);
+};
+
+#endif /* SCOREBOARD_HPP */
@@ -0,0 +1,87 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#include <cassert>
+#include <unistd.h>
+
+#include "worker-publisher.hpp"
+
+WorkerPublisher::WorkerPublisher(const std::shared_ptr<WorkersBoard> &_pWorkersBoard,
+                                 const size_t _workerIndex) : Publisher(std::string("Worker ") +
+                                                                        std::to_string(_workerIndex)),
+                                                              pWorkersBoard(_pWorkersBoard),
+                                                              workerIndex(_workerIndex)
+{
+    assert(_pWorkersBoard != nullptr);
+    assert(_workerIndex < _pWorkersBoard->workersCount);
+
+    pWorkersBoard->setWorkerRecord(workerIndex,
+                                   getpid(),
+                                   0L);
+}
+
+void WorkerPublisher::publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                            const unsigned long elapsedMicroSeconds)
+{
+    assert(scenarii.size() == pWorkersBoard->scenariiCount);
+
+    WORKERS_BOARD_SCENARIO_RECORD record = {};
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        record = pWorkersBoard->getScenarioRecord(workerIndex,
+                                                  scenarioIndex);
+
+        getLiveRecord(*scenarii[scenarioIndex],
+                      elapsedMicroSeconds,
+                      record);
+
+        pWorkersBoard->setScenarioRecord(workerIndex,
+                                         scenarioIndex,
+                                         record);
+    }
+}
+
+CK_RV WorkerPublisher::publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                         const unsigned long membersCount)
+{
+    assert(scenarii.size() == pWorkersBoard->scenariiCount);
+
+    WORKERS_BOARD_SCENARIO_RECORD record = {};
+
+    for (size_t scenarioIndex = 0; scenarioIndex < scenarii.size(); scenarioIndex++)
+    {
+        getRecord(*scenarii[scenarioIndex],
+                  record);
+
+        pWorkersBoard->setScenarioRecord(workerIndex,
+                                         scenarioIndex,
+                                         record);
+    }
+
+    pWorkersBoard->setWorkerRecord(workerIndex,
+                                   getpid(),
+                                   membersCount);
+    pWorkersBoard->setWorkerState(workerIndex,
+                                  WORKERS_BOARD__STATE__REPORTED);
+
+    return CKR_OK;
+}
+
+CK_RV WorkerPublisher::waitForStart(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                                    unsigned long long &startMilliSeconds)
+{
+    assert(&scenarii != nullptr);
+    assert(&startMilliSeconds != nullptr);
+
+    pWorkersBoard->waitForStart(workerIndex);
+
+    return CKR_OK;
+}
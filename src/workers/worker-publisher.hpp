@@ -0,0 +1,40 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+#ifndef WORKER_PUBLISHER_HPP
+#define WORKER_PUBLISHER_HPP
+
+#include <memory>
+
+#include "publisher.hpp"
+#include "workers-board.hpp"
+
+// Publisher of a worker of '--processes', through the board shared with
+// its parent process.
+class WorkerPublisher : public Publisher
+{
+public:
+    const std::shared_ptr<WorkersBoard> pWorkersBoard;
+    const size_t workerIndex;
+
+    WorkerPublisher(const std::shared_ptr<WorkersBoard> &pWorkersBoard,
+                    const size_t workerIndex);
+
+    void publishLiveStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                               const unsigned long elapsedMicroSeconds) override;
+    CK_RV publishStatistics(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                            const unsigned long membersCount) override;
+
+    // Waits for the other workers to be ready.
+    CK_RV waitForStart(const std::vector<std::shared_ptr<Scenario>> &scenarii,
+                       unsigned long long &startMilliSeconds) override;
+};
+
+#endif /* WORKER_PUBLISHER_HPP */
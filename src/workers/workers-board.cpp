@@ -0,0 +1,171 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#include <cassert>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "workers-board.hpp"
+
+// Delay between two checks of the start request, in micro-seconds.
+#define WORKERS_BOARD__POLLING_DELAY 1000
+
+WorkersBoard::WorkersBoard(const size_t _workersCount,
+                           const size_t _scenariiCount) : Top("Workers Board"),
+                                                          workersCount(_workersCount),
+                                                          scenariiCount(_scenariiCount)
+{
+    assert(_workersCount > 0);
+    assert(_scenariiCount > 0);
+
+    // Nothing else to do here.
+}
+
+WorkersBoard::~WorkersBoard()
+{
+    if (pSegment != nullptr)
+    {
+        munmap(pSegment,
+               segmentLength);
+    }
+}
+
+CK_RV WorkersBoard::create()
+{
+    assert(pSegment == nullptr);
+
+    CK_RV rv = CKR_OK;
+
+    // The header is 8 bytes long, so that the records remain aligned.
+    segmentLength = sizeof(unsigned long) +
+                    (workersCount * sizeof(WORKERS_BOARD_WORKER_RECORD)) +
+                    (workersCount * scenariiCount * sizeof(WORKERS_BOARD_SCENARIO_RECORD));
+
+    pSegment = mmap(nullptr,
+                    segmentLength,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS,
+                    -1,
+                    0);
+
+    if (pSegment == MAP_FAILED)
+    {
+        pSegment = nullptr;
+
+        rv = CKR_HOST_MEMORY;
+
+        writeError("Cannot map the memory shared with the workers.",
+                   rv);
+
+        goto EXIT;
+    }
+
+    // The anonymous mappings are zeroed, i.e. no start request and all the
+    // workers preparing.
+    pStartRequested = (unsigned long *)pSegment;
+    workersRecords = (WORKERS_BOARD_WORKER_RECORD *)(pStartRequested + 1);
+    scenariiRecords = (WORKERS_BOARD_SCENARIO_RECORD *)(workersRecords + workersCount);
+
+EXIT:
+    return rv;
+}
+
+const WORKERS_BOARD_SCENARIO_RECORD &WorkersBoard::getScenarioRecord(const size_t workerIndex,
+                                                                     const size_t scenarioIndex) const
+{
+    assert(scenariiRecords != nullptr);
+    assert(workerIndex < workersCount);
+    assert(scenarioIndex < scenariiCount);
+
+    return scenariiRecords[(workerIndex * scenariiCount) + scenarioIndex];
+}
+
+const WORKERS_BOARD_WORKER_RECORD &WorkersBoard::getWorkerRecord(const size_t workerIndex) const
+{
+    assert(workersRecords != nullptr);
+    assert(workerIndex < workersCount);
+
+    return workersRecords[workerIndex];
+}
+
+int WorkersBoard::getWorkerState(const size_t workerIndex) const
+{
+    assert(workersRecords != nullptr);
+    assert(workerIndex < workersCount);
+
+    return __atomic_load_n(&workersRecords[workerIndex].state,
+                           __ATOMIC_ACQUIRE);
+}
+
+bool WorkersBoard::isStartRequested() const
+{
+    assert(pStartRequested != nullptr);
+
+    return __atomic_load_n(pStartRequested,
+                           __ATOMIC_ACQUIRE) != 0;
+}
+
+void WorkersBoard::requestStart()
+{
+    assert(pStartRequested != nullptr);
+
+    __atomic_store_n(pStartRequested,
+                     1,
+                     __ATOMIC_RELEASE);
+}
+
+void WorkersBoard::setScenarioRecord(const size_t workerIndex,
+                                     const size_t scenarioIndex,
+                                     const WORKERS_BOARD_SCENARIO_RECORD &record)
+{
+    assert(scenariiRecords != nullptr);
+    assert(workerIndex < workersCount);
+    assert(scenarioIndex < scenariiCount);
+
+    scenariiRecords[(workerIndex * scenariiCount) + scenarioIndex] = record;
+}
+
+void WorkersBoard::setWorkerRecord(const size_t workerIndex,
+                                   const pid_t processIdentifier,
+                                   const unsigned long membersCount)
+{
+    assert(workersRecords != nullptr);
+    assert(workerIndex < workersCount);
+
+    workersRecords[workerIndex].processIdentifier = processIdentifier;
+    workersRecords[workerIndex].membersCount = membersCount;
+}
+
+void WorkersBoard::setWorkerState(const size_t workerIndex,
+                                  const int state)
+{
+    assert(workersRecords != nullptr);
+    assert(workerIndex < workersCount);
+
+    // Release the records written before the state change.
+    __atomic_store_n(&workersRecords[workerIndex].state,
+                     state,
+                     __ATOMIC_RELEASE);
+}
+
+void WorkersBoard::waitForStart(const size_t workerIndex)
+{
+    setWorkerState(workerIndex,
+                   WORKERS_BOARD__STATE__READY);
+
+    while (!isStartRequested())
+    {
+        usleep(WORKERS_BOARD__POLLING_DELAY);
+    }
+
+    setWorkerState(workerIndex,
+                   WORKERS_BOARD__STATE__RUNNING);
+}
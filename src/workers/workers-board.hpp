@@ -0,0 +1,114 @@
+/****************************************************************************\
+*
+* This file is part of the "Luna HA-Bench" tool.
+*
+* The "Luna HA-Bench" tool is provided under the MIT license (see the
+* following Web site for further details: https://mit-license.org/ ).
+*
+* Copyright © 2023 Thales Group
+*
+\****************************************************************************/
+
+#ifndef WORKERS_BOARD_HPP
+#define WORKERS_BOARD_HPP
+
+#include <sys/types.h>
+
+#include "scenarii/latency-statistics.hpp"
+#include "scenarii/top.hpp"
+
+#define WORKERS_BOARD__MAXIMUM_WORKERS_COUNT 256
+#define WORKERS_BOARD__MAXIMUM_WORKERS_TEXT "256"
+
+// States of a worker, as published on the board.
+#define WORKERS_BOARD__STATE__PREPARING 0
+#define WORKERS_BOARD__STATE__READY 1
+#define WORKERS_BOARD__STATE__RUNNING 2
+#define WORKERS_BOARD__STATE__REPORTED 3
+
+// Results of a scenario run by a worker (see Publisher): the counters and
+// latencies are published every second while the tests run, then all the
+// fields once they are stopped.
+typedef struct
+{
+    unsigned long elapsedMicroSeconds;
+    unsigned long requestsCount;
+    unsigned long errorsCount;
+    unsigned long tps;
+    unsigned long minTestTps;
+    unsigned long maxTestTps;
+    unsigned long meanTestTps;
+    unsigned long verifiedCount;
+    unsigned long mismatchesCount;
+    LATENCY_STATISTICS_SNAPSHOT requestsStatistics;
+} WORKERS_BOARD_SCENARIO_RECORD;
+
+typedef struct
+{
+    pid_t processIdentifier;
+    int state;
+
+    // Number of members of the HA group, 0 if unknown.
+    unsigned long membersCount;
+} WORKERS_BOARD_WORKER_RECORD;
+
+/*
+ * Shared memory segment through which the worker processes of
+ * '--processes' publish their results to their parent process (also used
+ * by the coordinator to gather the results of its agents).
+ *
+ * Notes:
+ *   - The segment is mapped before the workers are forked, hence shared by
+ *     all of them at the same address.
+ *   - Each record is only written by its worker; the parent reads the
+ *     states while the workers run, and their results once they exited.
+ *   - The workers wait for each other once initialized, so that their
+ *     tests start together.
+ */
+class WorkersBoard : public Top
+{
+protected:
+    void *pSegment = nullptr;
+    size_t segmentLength = 0;
+
+    unsigned long *pStartRequested = nullptr;
+    WORKERS_BOARD_WORKER_RECORD *workersRecords = nullptr;
+    WORKERS_BOARD_SCENARIO_RECORD *scenariiRecords = nullptr;
+
+public:
+    const size_t workersCount;
+    const size_t scenariiCount;
+
+    WorkersBoard(const size_t workersCount,
+                 const size_t scenariiCount);
+    ~WorkersBoard() override;
+
+    WorkersBoard(const WorkersBoard &) = delete;
+    WorkersBoard &operator=(const WorkersBoard &) = delete;
+
+    // Maps the segment; must be called before to fork the workers.
+    virtual CK_RV create();
+
+    virtual const WORKERS_BOARD_SCENARIO_RECORD &getScenarioRecord(const size_t workerIndex,
+                                                                   const size_t scenarioIndex) const;
+    virtual const WORKERS_BOARD_WORKER_RECORD &getWorkerRecord(const size_t workerIndex) const;
+    virtual int getWorkerState(const size_t workerIndex) const;
+
+    virtual bool isStartRequested() const;
+
+    virtual void requestStart();
+
+    virtual void setScenarioRecord(const size_t workerIndex,
+                                   const size_t scenarioIndex,
+                                   const WORKERS_BOARD_SCENARIO_RECORD &record);
+    virtual void setWorkerRecord(const size_t workerIndex,
+                                 const pid_t processIdentifier,
+                                 const unsigned long membersCount);
+    virtual void setWorkerState(const size_t workerIndex,
+                                const int state);
+
+    // Waits for the parent to start the workers, that are ready.
+    virtual void waitForStart(const size_t workerIndex);
+};
+
+#endif /* WORKERS_BOARD_HPP */
@@ -108,6 +108,30 @@ for SHARE_MODE in share no-share; do
         "SUCIx011x10" \
         "SUCIx100x10" \
         "SUCIx101x10" \
+        "SUCIx03000x10" \
+        "SUCIx03011x10" \
+        "SUCIx13000x10" \
+        "SUCIx14001x10" \
+        "SUCIx100000x10" \
+        "SUCIx103100x10" \
+        "SUCIx102010x10" \
+        "Milenage-resyncx00000x10" \
+        "Milenage-resyncx00011x10" \
+        "Milenage-resyncx01011x10" \
+        "Milenage-resyncx10101x10" \
+        "TUAK-resyncx0000x10" \
+        "TUAK-resyncx0011x10" \
+        "TUAK-resyncx1011x10" \
+        "Milenage-5G-AKAx00010x10" \
+        "Milenage-5G-AKAx10101x10" \
+        "TUAK-5G-AKAx0010x10" \
+        "TUAK-5G-AKAx1011x10" \
+        "Milenage-EAP-AKA-primex00010x10" \
+        "TUAK-EAP-AKA-primex0010x10" \
+        "Milenage-softwarex00010x10" \
+        "TUAK-softwarex0010x10" \
+        "Milenagex00010x10 Milenage-EAP-AKA-primex00010x10" \
+        "Milenagex00010x10 Milenage-resyncx00010x10" \
         "COMP-128x30x10 Milenagex00010x10 TUAKx0010x10 SUCIx000x10"; do
         echo "# ############################################################################" >>"${RESULT_FILE}"
         echo "# Test '${USE_CASE} (${SHARE_MODE})'..." >>"${RESULT_FILE}"